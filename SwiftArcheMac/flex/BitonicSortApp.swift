@@ -10,6 +10,7 @@ import vox_flex
 import vox_render
 import vox_toolkit
 
+/// Sorts (key, index) pairs on the GPU under a capture scope, with the RadixSort used by HashGrid.build.
 class BitonicSortApp: NSViewController {
     var canvas: Canvas!
     var engine: Engine!
@@ -28,22 +29,24 @@ class BitonicSortApp: NSViewController {
         cameraEntity.transform.lookAt(targetPosition: Vector3())
         cameraEntity.addComponent(Camera.self)
 
-        let count: UInt = 10000
-        var sortArray: [SIMD2<Float>] = []
+        let count: UInt32 = 10000
+        let keyBits = CPURadixSort.keyBits(for: 128 * 128 * 128)
+        var sortArray: [SIMD2<UInt32>] = []
         for i in 0 ..< count {
-            sortArray.append(SIMD2<Float>(Float.random(in: 0 ..< 5), Float(i)))
+            sortArray.append(SIMD2<UInt32>(UInt32.random(in: 0 ..< 128 * 128 * 128), i))
         }
 
-        let bitonicSort = BitonicSort()
+        let radixSort = RadixSort()
         let sortBuffer = BufferView(array: sortArray)
         let itemCount = BufferView(array: [count])
-        let scope = Engine.createCaptureScope(name: "bitonic")
+        let scope = Engine.createCaptureScope(name: "radix")
         scope.begin()
         if let commandBuffer = Engine.commandQueue.makeCommandBuffer(),
            let commandEncoder = commandBuffer.makeComputeCommandEncoder()
         {
-            commandEncoder.label = "bitonic sort"
-            bitonicSort.run(commandEncoder: commandEncoder, maxSize: count, sortBuffer: sortBuffer, itemCount: itemCount)
+            commandEncoder.label = "radix sort"
+            radixSort.run(commandEncoder: commandEncoder, maxSize: UInt(count), keyBits: keyBits,
+                          sortBuffer: sortBuffer, itemCount: itemCount)
             commandEncoder.endEncoding()
             commandBuffer.commit()
             commandBuffer.waitUntilCompleted()
@@ -0,0 +1,118 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class AerodynamicsBenchmarkTests: XCTestCase {
+    let spacing: Float = 0.02
+    let side = 100
+    let substeps = 4
+
+    // a side x side flag in the xy plane hanging from a pole along its x = 0 edge, with structural distance
+    // constraints, deformable triangles and aerodynamics on every particle.
+    func makeFlag(wind: SIMD4<Float>) -> CPUParticleSolver {
+        var positions: [SIMD4<Float>] = []
+        var invMasses: [Float] = []
+        var pairs: [SIMD2<Int32>] = []
+        var triangles: [SIMD3<Int32>] = []
+        for y in 0 ..< side {
+            for x in 0 ..< side {
+                let i = Int32(y * side + x), up = i + Int32(side)
+                positions.append(SIMD4<Float>(Float(x) * spacing, 2 - Float(y) * spacing, 0, 0))
+                invMasses.append(x == 0 ? 0 : 1000)
+                if x + 1 < side {
+                    pairs.append(SIMD2<Int32>(i, i + 1))
+                }
+                if y + 1 < side {
+                    pairs.append(SIMD2<Int32>(i, up))
+                }
+                if x + 1 < side, y + 1 < side {
+                    triangles += [SIMD3<Int32>(i, up, i + 1), SIMD3<Int32>(i + 1, up, up + 1)]
+                }
+            }
+        }
+
+        let solver = CPUParticleSolver()
+        solver.sleepThreshold = 0
+        solver.setParticles(positions: positions, invMasses: invMasses)
+        solver.setWind([SIMD4<Float>](repeating: wind, count: positions.count))
+        solver.setDeformableTriangles(triangles)
+        solver.setConstraintParameters(.Distance, order: .sequential, iterations: 10)
+        let (sortedIndices, batches) = CPUConstraintBatcher().batch(pairs: pairs, particleCount: positions.count,
+                                                                     constraintStride: 16)
+        for batch in batches {
+            let batchPairs = sortedIndices[batch.startIndex ..< batch.startIndex + batch.constraintCount].map {
+                pairs[Int($0)]
+            }
+            solver.addDistanceConstraints(pairs: batchPairs, restLengths: [Float](repeating: spacing,
+                                                                                   count: batchPairs.count))
+        }
+        solver.addAerodynamicConstraints(particles: Array(0 ..< Int32(positions.count)), area: spacing * spacing,
+                                         drag: 1.2, lift: 1.2)
+        return solver
+    }
+
+    func simulate(_ solver: CPUParticleSolver, steps: Int) {
+        for _ in 0 ..< steps {
+            solver.step(stepTime: 1 / 60, substeps: substeps)
+        }
+    }
+
+    /// mean x of the flag's free edge.
+    func flyEnd(_ solver: CPUParticleSolver) -> Float {
+        let positions = solver.positions()
+        return (0 ..< side).map { positions[$0 * side + side - 1].x }.reduce(0, +) / Float(side)
+    }
+
+    func testFlagFliesInTheWind() throws {
+        // still air lets the flag hang from its pole, a breeze along +x makes it fly.
+        let calm = makeFlag(wind: SIMD4<Float>(0, 0, 0.5, 0))
+        let breeze = makeFlag(wind: SIMD4<Float>(8, 0, 0.5, 0))
+        simulate(calm, steps: 120)
+        simulate(breeze, steps: 120)
+        XCTAssertEqual(breeze.aerodynamicTriangleCount(batch: 0), 2 * (side - 1) * (side - 1))
+        XCTAssertLessThan(flyEnd(calm), 0.5)
+        XCTAssertGreaterThan(flyEnd(breeze), 0.8)
+
+        // the same breeze from a wind field.
+        let field = makeFlag(wind: SIMD4<Float>(0, 0, 0.5, 0))
+        field.setWindField(samples: [SIMD4<Float>](repeating: SIMD4<Float>(8, 0, 0, 0), count: 8),
+                           resolution: SIMD3<Int32>(2, 2, 2), lower: SIMD3<Float>(-1, -1, -1),
+                           upper: SIMD3<Float>(3, 3, 1))
+        simulate(field, steps: 120)
+        XCTAssertGreaterThan(flyEnd(field), 0.8)
+    }
+
+    func testFlagThroughput() throws {
+        // 100 x 100 flag, 19602 triangles: the cost of the aerodynamics alone, with and without a wind field.
+        let solver = makeFlag(wind: SIMD4<Float>(8, 0, 0.5, 0))
+        simulate(solver, steps: 10)
+        let triangles = solver.aerodynamicTriangleCount(batch: 0)
+        let runs = 200
+        func time() -> Double {
+            let start = CFAbsoluteTimeGetCurrent()
+            for _ in 0 ..< runs {
+                solver.substep(stepTime: 1 / 60, substepTime: 1 / 60 / Float(substeps), substeps: substeps)
+            }
+            return (CFAbsoluteTimeGetCurrent() - start) / Double(runs)
+        }
+        solver.setConstraintParameters(.Distance, order: .sequential, iterations: 10, enabled: false)
+        let withWind = time()
+        solver.setWindField(samples: (0 ..< 64).map { SIMD4<Float>(8, Float($0 % 4) * 0.1, 0, 0) },
+                            resolution: SIMD3<Int32>(4, 4, 4), lower: SIMD3<Float>(-1, -1, -1),
+                            upper: SIMD3<Float>(3, 3, 1))
+        let withField = time()
+        solver.setConstraintParameters(.Aerodynamics, order: .sequential, iterations: 1, enabled: false)
+        let baseline = time()
+        for (name, elapsed) in [("particle wind", withWind), ("wind field", withField)] {
+            let aerodynamics = elapsed - baseline
+            print(String(format: "flag aerodynamics (%@), %d triangles, %d threads: %.3f ms/substep, "
+                             + "%.1f M triangles/s", name, triangles, CPUParticleSolver.threadCount, aerodynamics * 1000,
+                         Double(triangles) / max(aerodynamics, 1e-9) / 1e6))
+        }
+    }
+}
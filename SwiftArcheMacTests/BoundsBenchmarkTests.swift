@@ -0,0 +1,119 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import simd
+import vox_flex
+import XCTest
+
+final class BoundsBenchmarkTests: XCTestCase {
+    let particleCount = 1 << 20
+
+    /// particles scattered in a 100 m cube, every third one moving along x.
+    func makeSolver() -> (solver: CPUParticleSolver, positions: [SIMD4<Float>], radii: [Float]) {
+        let positions = (0 ..< particleCount).map { _ in
+            SIMD4<Float>(Float.random(in: -50 ... 50), Float.random(in: -50 ... 50), Float.random(in: -50 ... 50), 0)
+        }
+        let radii = (0 ..< particleCount).map { Float($0 % 5 + 1) * 0.01 }
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: particleCount))
+        solver.setCollisionMaterial(radii: radii, phases: [Int](repeating: 0, count: particleCount),
+                                    filters: [Int](repeating: 0, count: particleCount))
+        solver.setVelocities((0 ..< particleCount).map { $0 % 3 == 0 ? SIMD4<Float>(1, 0, 0, 0) : .zero })
+        return (solver, positions, radii)
+    }
+
+    func testParticleBounds() throws {
+        let (solver, positions, radii) = makeSolver()
+        var lower = SIMD3<Float>(repeating: .greatestFiniteMagnitude), upper = -lower
+        var awakeLower = lower, awakeUpper = upper
+        for i in 0 ..< particleCount {
+            let p = SIMD3<Float>(positions[i].x, positions[i].y, positions[i].z)
+            lower = simd_min(lower, p - radii[i])
+            upper = simd_max(upper, p + radii[i])
+            if i % 3 == 0 {
+                awakeLower = simd_min(awakeLower, p - radii[i])
+                awakeUpper = simd_max(awakeUpper, p + radii[i])
+            }
+        }
+
+        let bounds = solver.bounds()
+        XCTAssertEqual(bounds.activeCount, particleCount)
+        XCTAssertEqual(bounds.awakeCount, (particleCount + 2) / 3)
+        XCTAssertEqual(bounds.lower, lower)
+        XCTAssertEqual(bounds.upper, upper)
+        XCTAssertEqual(bounds.awakeLower, awakeLower)
+        XCTAssertEqual(bounds.awakeUpper, awakeUpper)
+        XCTAssertFalse(bounds.isAsleep)
+
+        let repeats = 20
+        let start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< repeats {
+            _ = solver.bounds()
+        }
+        let time = (CFAbsoluteTimeGetCurrent() - start) / Double(repeats)
+        print(String(format: "solver bounds, %d particles, %d threads: %.3f ms, %.0f M particles/s", particleCount,
+                     CPUParticleSolver.threadCount, time * 1000, Double(particleCount) / time / 1e6))
+    }
+
+    func testSleepingSolver() throws {
+        let solver = CPUParticleSolver()
+        solver.gravity = .zero
+        solver.setParticles(positions: [SIMD4<Float>(), SIMD4<Float>(1, 0, 0, 0)], invMasses: [1, 1])
+        solver.setVelocities([SIMD4<Float>(0.001, 0, 0, 0), .zero])
+        XCTAssertEqual(solver.bounds().awakeCount, 1)
+        // below the sleep threshold, both particles are stopped.
+        solver.step(stepTime: 1 / 60, substeps: 1)
+        XCTAssertTrue(solver.bounds().isAsleep)
+        XCTAssertFalse(solver.bounds().isEmpty)
+    }
+
+    func testSimplexBoundsSweepAlongVelocities() throws {
+        let (solver, positions, radii) = makeSolver()
+        // a third of the particles as points, a third paired into edges, the rest grouped into triangles.
+        let third = particleCount / 3
+        let edgeCount = third / 2
+        let triangleCount = (particleCount - 2 * third) / 3
+        solver.setSimplices(points: (0 ..< third).map { Int32($0) },
+                            edges: (0 ..< edgeCount).map {
+                                SIMD2<Int32>(repeating: Int32(third + $0 * 2)) &+ SIMD2<Int32>(0, 1)
+                            },
+                            triangles: (0 ..< triangleCount).map {
+                                SIMD3<Int32>(repeating: Int32(2 * third + $0 * 3)) &+ SIMD3<Int32>(0, 1, 2)
+                            })
+        solver.collisionMargin = 0.01
+        solver.continuousCollisionDetection = 1
+        let stepTime: Float = 1 / 60
+        solver.calculateSimplexBounds(stepTime: stepTime)
+
+        let simplexBounds = solver.simplexBounds()
+        XCTAssertEqual(simplexBounds.count, third + edgeCount + triangleCount)
+        let lastTriangle = 2 * third + (triangleCount - 1) * 3
+        for (simplex, particles) in [(0, [0]), (third - 1, [third - 1]), (third, [third, third + 1]),
+                                     (simplexBounds.count - 1, [lastTriangle, lastTriangle + 1, lastTriangle + 2])]
+        {
+            var lower = SIMD3<Float>(repeating: .greatestFiniteMagnitude), upper = -lower
+            for i in particles {
+                let p = SIMD3<Float>(positions[i].x, positions[i].y, positions[i].z)
+                let swept = p + (i % 3 == 0 ? SIMD3<Float>(stepTime, 0, 0) : .zero)
+                let radius = radii[i] + solver.collisionMargin
+                lower = simd_min(lower, simd_min(p, swept) - radius)
+                upper = simd_max(upper, simd_max(p, swept) + radius)
+            }
+            XCTAssertEqual(simd_distance(simplexBounds[simplex].lower, lower), 0, accuracy: 1e-5)
+            XCTAssertEqual(simd_distance(simplexBounds[simplex].upper, upper), 0, accuracy: 1e-5)
+        }
+
+        let repeats = 20
+        let start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< repeats {
+            solver.calculateSimplexBounds(stepTime: stepTime)
+        }
+        let time = (CFAbsoluteTimeGetCurrent() - start) / Double(repeats)
+        print(String(format: "simplex bounds, %d simplices, %d threads: %.3f ms, %.0f M simplices/s",
+                     solver.simplexCount, CPUParticleSolver.threadCount, time * 1000,
+                     Double(solver.simplexCount) / time / 1e6))
+    }
+}
@@ -0,0 +1,170 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+import vox_flex
+import XCTest
+
+final class ClothBlueprintBenchmarkTests: XCTestCase {
+    let parameters = CClothBlueprintParameters(particleMass: 0.1, drag: 0.05, lift: 0.05, batchRounds: 4)
+
+    // a size x size vertex garment in the xz plane, two triangles per quad. Unwelded garments repeat the vertices
+    // of every triangle, as exported meshes split along uv seams do.
+    func makeGarment(size: Int, welded: Bool) -> ([SIMD3<Float>], [Int32]) {
+        var grid: [SIMD3<Float>] = []
+        for z in 0 ..< size {
+            for x in 0 ..< size {
+                grid.append(SIMD3<Float>(Float(x) * 0.01, 0, Float(z) * 0.01))
+            }
+        }
+        var triangles: [Int32] = []
+        for z in 0 ..< size - 1 {
+            for x in 0 ..< size - 1 {
+                let i = Int32(z * size + x)
+                let s = Int32(size)
+                triangles += [i, i + s, i + 1, i + 1, i + s, i + s + 1]
+            }
+        }
+        if welded {
+            return (grid, triangles)
+        }
+        return (triangles.map { grid[Int($0)] }, Array(0 ..< Int32(triangles.count)))
+    }
+
+    func makeMesh(size: Int, welded: Bool) -> CHalfEdgeMesh {
+        let (positions, triangles) = makeGarment(size: size, welded: welded)
+        let mesh = CHalfEdgeMesh()
+        mesh.build(withPositions: positions, vertexCount: UInt32(positions.count), triangles: triangles,
+                   triangleCount: UInt32(triangles.count / 3), scale: SIMD3<Float>(1, 1, 1))
+        return mesh
+    }
+
+    func testTopology() throws {
+        let size = 12
+        for welded in [true, false] {
+            let mesh = makeMesh(size: size, welded: welded)
+            XCTAssertEqual(Int(mesh.vertexCount), size * size)
+            XCTAssertEqual(Int(mesh.faceCount), (size - 1) * (size - 1) * 2)
+            XCTAssertEqual(Int(mesh.borderEdgeCount), (size - 1) * 4)
+            // a disk: V - E + F = 1.
+            XCTAssertEqual(Int(mesh.vertexCount) - Int(mesh.edgeCount) + Int(mesh.faceCount), 1)
+            XCTAssertEqual(mesh.area, Float((size - 1) * (size - 1)) * 0.0001, accuracy: 1e-5)
+
+            var halfEdges = [CHalfEdge](repeating: CHalfEdge(), count: Int(mesh.halfEdgeCount))
+            mesh.getHalfEdges(&halfEdges)
+            for (i, edge) in halfEdges.enumerated() {
+                XCTAssertEqual(Int(halfEdges[Int(edge.pair)].pair), i)
+                XCTAssertEqual(halfEdges[Int(edge.nextHalfEdge)].face, edge.face)
+            }
+
+            var vertexHalfEdges = [Int32](repeating: 0, count: Int(mesh.vertexCount))
+            var offsets = [Int32](repeating: 0, count: Int(mesh.vertexCount) + 1)
+            var outgoing = [Int32](repeating: 0, count: Int(mesh.outgoingCount))
+            mesh.getVertexHalfEdges(&vertexHalfEdges, outgoingOffsets: &offsets, outgoingHalfEdges: &outgoing)
+            XCTAssertEqual(Int(offsets.last!), halfEdges.count)
+            // welding numbers vertices in order of appearance, find grid ones by position.
+            var points = [SIMD4<Float>](repeating: .zero, count: Int(mesh.vertexCount))
+            mesh.getPositions(&points, restNormals: nil, restOrientations: nil, areaContributions: nil)
+            func degree(_ x: Int, _ z: Int) -> Int32 {
+                let v = points.firstIndex { abs($0.x - Float(x) * 0.01) < 1e-5 && abs($0.z - Float(z) * 0.01) < 1e-5 }!
+                return offsets[v + 1] - offsets[v]
+            }
+            // a face and a border half-edge leave the corners with a single face, one more the corners with two,
+            // six the inner vertices.
+            XCTAssertEqual(degree(0, 0), 2)
+            XCTAssertEqual(degree(size - 1, 0), 3)
+            XCTAssertEqual(degree(1, 1), 6)
+        }
+    }
+
+    func testHalfEdgeMeshEnumerators() throws {
+        let (positions, triangles) = makeGarment(size: 4, welded: false)
+        let topology = HalfEdgeMesh()
+        topology.Generate(vertices: positions.map { Vector3($0.x, $0.y, $0.z) }, indices: triangles.map { Int($0) })
+        XCTAssertTrue(topology.containsData)
+        XCTAssertEqual(topology.vertices.count, 16)
+        XCTAssertEqual(topology.GetEdgeList().count, 33)
+        let inner = topology.vertices.first { $0.position.x > 0.005 && $0.position.x < 0.015
+            && $0.position.z > 0.005 && $0.position.z < 0.015 }!
+        XCTAssertEqual(topology.GetNeighbourVerticesEnumerator(vertex: inner).count, 6)
+        XCTAssertEqual(topology.GetNeighbourFacesEnumerator(vertex: inner).count, 6)
+        for edge in topology.GetNeighbourEdgesEnumerator(vertex: inner) {
+            XCTAssertEqual(topology.GetHalfEdgeStartVertex(edge: edge), inner.index)
+        }
+        XCTAssertEqual(topology.GetFaceArea(face: topology.faces[0]), 0.00005, accuracy: 1e-7)
+    }
+
+    func testBatchesShareNoParticle() throws {
+        let blueprint = CClothBlueprint()
+        XCTAssertFalse(blueprint.generate(with: makeMesh(size: 20, welded: true), parameters: parameters,
+                                          invMasses: nil, cacheDirectory: nil))
+        XCTAssertEqual(blueprint.aerodynamicCount, blueprint.particleCount)
+
+        var indices = [Int32](repeating: 0, count: Int(blueprint.bendCount) * 3)
+        var restBends = [Float](repeating: 0, count: Int(blueprint.bendCount))
+        var batches = [CBatchData](repeating: CBatchData(), count: Int(blueprint.bendBatchCount))
+        blueprint.getBendIndices(&indices, restBends: &restBends, batches: &batches)
+        XCTAssertEqual(batches.reduce(0) { $0 + Int($1.constraintCount) }, Int(blueprint.bendCount))
+        for batch in batches {
+            var used = Set<Int32>()
+            for c in Int(batch.startIndex) ..< Int(batch.startIndex + batch.constraintCount) {
+                for k in 0 ..< 3 {
+                    XCTAssertTrue(used.insert(indices[c * 3 + k]).inserted)
+                }
+            }
+        }
+    }
+
+    func testCache() throws {
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let mesh = makeMesh(size: 30, welded: false)
+        let generated = CClothBlueprint()
+        XCTAssertFalse(generated.generate(with: mesh, parameters: parameters, invMasses: nil,
+                                          cacheDirectory: directory.path))
+        let cached = CClothBlueprint()
+        XCTAssertTrue(cached.generate(with: mesh, parameters: parameters, invMasses: nil,
+                                      cacheDirectory: directory.path))
+        XCTAssertEqual(cached.cacheKey, generated.cacheKey)
+        XCTAssertEqual(cached.distanceCount, generated.distanceCount)
+        XCTAssertEqual(cached.distanceBatchCount, generated.distanceBatchCount)
+        XCTAssertEqual(cached.bendCount, generated.bendCount)
+
+        // other parameters hash to another file.
+        var heavier = parameters
+        heavier.particleMass = 1
+        XCTAssertFalse(cached.generate(with: mesh, parameters: heavier, invMasses: nil,
+                                       cacheDirectory: directory.path))
+    }
+
+    func testGarmentThroughput() throws {
+        // 225 x 225 vertices: 100352 triangles.
+        let (positions, triangles) = makeGarment(size: 225, welded: false)
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let mesh = CHalfEdgeMesh()
+        let blueprint = CClothBlueprint()
+        var start = Date()
+        mesh.build(withPositions: positions, vertexCount: UInt32(positions.count), triangles: triangles,
+                   triangleCount: UInt32(triangles.count / 3), scale: SIMD3<Float>(1, 1, 1))
+        let build = Date().timeIntervalSince(start)
+        start = Date()
+        blueprint.generate(with: mesh, parameters: parameters, invMasses: nil, cacheDirectory: directory.path)
+        let generate = Date().timeIntervalSince(start)
+        start = Date()
+        XCTAssertTrue(blueprint.generate(with: mesh, parameters: parameters, invMasses: nil,
+                                         cacheDirectory: directory.path))
+        let load = Date().timeIntervalSince(start)
+        print(String(format: "garment %d triangles: topology %.1f ms, blueprint %.1f ms (%d distance, %d bend "
+                         + "batches), cached %.1f ms", mesh.faceCount, build * 1000, generate * 1000,
+                     blueprint.distanceBatchCount, blueprint.bendBatchCount, load * 1000))
+        XCTAssertLessThan(build + generate, 1)
+    }
+}
@@ -0,0 +1,216 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+import vox_flex
+import XCTest
+
+final class ColliderContactBenchmarkTests: XCTestCase {
+    let particleRadius: Float = 0.02
+    let contactOffset: Float = 0.01
+    let stepTime: Float = 1 / 60
+    let rotation = simd_quatf(angle: 0.7, axis: simd_normalize(SIMD3<Float>(1, 2, 3)))
+
+    func makeSolver(positions: [SIMD4<Float>], edges: [SIMD2<Int32>] = []) -> CPUParticleSolver {
+        let count = positions.count
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: count))
+        solver.setCollisionMaterial(radii: [Float](repeating: particleRadius, count: count),
+                                    phases: (0 ..< count).map { ObiUtils.MakePhase(group: $0, flags: []) },
+                                    filters: [Int](repeating: ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything,
+                                                                                  category: 0), count: count))
+        if edges.isEmpty {
+            solver.setSimplices(points: (0 ..< Int32(count)).map { $0 })
+        } else {
+            solver.setSimplices(points: [], edges: edges)
+        }
+        return solver
+    }
+
+    func randomPositions(count: Int, side: Float) -> [SIMD4<Float>] {
+        (0 ..< count).map { _ in
+            SIMD4<Float>(Float.random(in: 0 ..< side), Float.random(in: 0 ..< side), Float.random(in: 0 ..< side), 0)
+        }
+    }
+
+    /// unit cube of side 1 centered at the origin.
+    func cubeDistanceField() -> [DFNode] {
+        let vertices = (0 ..< 8).map { i in
+            Vector3(i & 4 != 0 ? 0.5 : -0.5, i & 2 != 0 ? 0.5 : -0.5, i & 1 != 0 ? 0.5 : -0.5)
+        }
+        let triangles = [0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+                         2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3]
+        var nodes: [DFNode] = []
+        ASDF.Build(maxError: 0.005, maxDepth: 5, vertexPositions: vertices, triangleIndices: triangles, nodes: &nodes)
+        return nodes
+    }
+
+    /// one collider of `type` per center, sizes as ColliderShape.size, rotated by `rotation`. Bounds are the sphere
+    /// around the center of radius |size|, enough for every shape here.
+    func setColliders(_ world: CPUColliderWorld, type: ColliderShape.ShapeType, size: SIMD3<Float>, scale: Float,
+                      centers: [SIMD3<Float>])
+    {
+        let reach = simd_length(size) * scale + contactOffset
+        let shapes = centers.map { _ in
+            ColliderShape(size: Vector4(size.x, size.y, size.z, 0), type: type, contactOffset: contactOffset,
+                          dataIndex: 0)
+        }
+        let bounds = centers.map {
+            Aabb(min: Vector4($0.x - reach, $0.y - reach, $0.z - reach, 0),
+                 max: Vector4($0.x + reach, $0.y + reach, $0.z + reach, 0))
+        }
+        let orientation = Quaternion(x: rotation.imag.x, y: rotation.imag.y, z: rotation.imag.z, w: rotation.real)
+        let transforms = centers.map {
+            AffineTransform(translation: Vector4($0.x, $0.y, $0.z, 0), rotation: orientation,
+                            scale: Vector4(scale, scale, scale, 1))
+        }
+        world.SetColliders(shapes: shapes, bounds: bounds, transforms: transforms, count: centers.count)
+        world.UpdateWorld(deltaTime: stepTime)
+    }
+
+    /// signed distance from a point in the collider frame to the scaled shape.
+    func signedDistance(_ local: SIMD3<Float>, type: ColliderShape.ShapeType, size: SIMD3<Float>,
+                        scale: Float) -> Float
+    {
+        switch type {
+        case .Sphere:
+            return simd_length(local) - size.x * scale
+        case .Capsule:
+            // size.z = 1: along y.
+            let radius = size.x * scale
+            let halfSegment = max(radius, size.y * 0.5 * scale) - radius
+            let segment = SIMD3<Float>(0, simd_clamp(local.y, -halfSegment, halfSegment), 0)
+            return simd_length(local - segment) - radius
+        default:
+            let q = simd_abs(local) - size * scale * 0.5
+            return simd_length(simd_max(q, .zero)) + min(max(q.x, max(q.y, q.z)), 0)
+        }
+    }
+
+    func testContactsMatchAnalyticShapes() throws {
+        let positions = randomPositions(count: 20000, side: 3).map { $0 - SIMD4<Float>(1.5, 1.5, 1.5, 0) }
+        let solver = makeSolver(positions: positions)
+        let world = CPUColliderWorld()
+        solver.colliderWorld = world
+        let threshold = particleRadius + contactOffset + solver.collisionMargin
+
+        for (type, size) in [(ColliderShape.ShapeType.Sphere, SIMD3<Float>(0.5, 0, 0)),
+                             (.Box, SIMD3<Float>(1, 0.6, 0.8)), (.Capsule, SIMD3<Float>(0.3, 1.6, 1))]
+        {
+            setColliders(world, type: type, size: size, scale: 1.2, centers: [.zero])
+            solver.collisionDetection(stepTime: stepTime)
+            let contacts = solver.colliderContacts()
+            XCTAssertEqual(solver.colliderContactCounts()[type], contacts.count)
+
+            var found = Set<Int>()
+            for contact in contacts {
+                found.insert(contact.bodyA)
+                // the contact point lies on the surface, the normal is a unit vector.
+                let surface = rotation.inverse.act(SIMD3<Float>(contact.pointB.x, contact.pointB.y, contact.pointB.z))
+                XCTAssertEqual(signedDistance(surface, type: type, size: size, scale: 1.2), 0, accuracy: 1e-4)
+                XCTAssertEqual(simd_length(SIMD3<Float>(contact.normal.x, contact.normal.y, contact.normal.z)), 1,
+                               accuracy: 1e-4)
+            }
+            for (p, position) in positions.enumerated() {
+                let local = rotation.inverse.act(SIMD3<Float>(position.x, position.y, position.z))
+                let distance = signedDistance(local, type: type, size: size, scale: 1.2)
+                if abs(distance - threshold) > 1e-4 {
+                    XCTAssertEqual(found.contains(p), distance <= threshold, "\(type) particle \(p)")
+                }
+            }
+        }
+
+        // the distance field of a cube finds the particles the box does, up to the field error.
+        let cube = cubeDistanceField()
+        world.SetDistanceFieldData(headers: [DistanceFieldHeader(firstNode: 0, nodeCount: cube.count)], nodes: cube)
+        setColliders(world, type: .SignedDistanceField, size: SIMD3<Float>(1, 1, 1), scale: 1.2, centers: [.zero])
+        solver.collisionDetection(stepTime: stepTime)
+        let fieldContacts = solver.colliderContacts()
+        XCTAssertGreaterThan(fieldContacts.count, 0)
+        for contact in fieldContacts {
+            let position = positions[contact.bodyA]
+            let local = rotation.inverse.act(SIMD3<Float>(position.x, position.y, position.z))
+            XCTAssertLessThanOrEqual(signedDistance(local, type: .Box, size: SIMD3<Float>(1, 1, 1), scale: 1.2),
+                                     threshold + 0.02)
+        }
+    }
+
+    func testEdgeContactsFindClosestPoint() throws {
+        // an edge lying across the top of a box, its middle just above the surface.
+        let solver = makeSolver(positions: [SIMD4<Float>(-1, 0.52, 0, 0), SIMD4<Float>(1, 0.52, 0, 0)],
+                                edges: [SIMD2<Int32>(0, 1)])
+        let world = CPUColliderWorld()
+        solver.colliderWorld = world
+        world.SetColliders(shapes: [ColliderShape(size: Vector4(0.5, 1, 0.5, 0), type: .Box)],
+                           bounds: [Aabb(min: Vector4(-0.5, -0.5, -0.5, 0), max: Vector4(0.5, 0.5, 0.5, 0))],
+                           transforms: [AffineTransform(translation: Vector4(), rotation: Quaternion(),
+                                                        scale: Vector4(1, 1, 1, 1))], count: 1)
+        world.UpdateWorld(deltaTime: stepTime)
+        solver.collisionDetection(stepTime: stepTime)
+
+        let contacts = solver.colliderContacts()
+        XCTAssertEqual(contacts.count, 1)
+        guard let contact = contacts.first else { return }
+        XCTAssertEqual(contact.pointB.y, 0.5, accuracy: 1e-3)
+        XCTAssertEqual(contact.normal.y, 1, accuracy: 1e-3)
+        XCTAssertEqual(contact.pointA.x + contact.pointA.y, 1, accuracy: 1e-4)
+        XCTAssertEqual(contact.distance, 0, accuracy: 1e-3)
+    }
+
+    func testContactThroughputPerShape() throws {
+        let side: Float = 8
+        let particleCount = 100_000
+        let colliderCount = 2000
+        // particles, paired into short edges for the edge runs.
+        var positions = randomPositions(count: particleCount, side: side)
+        for i in stride(from: 1, to: particleCount, by: 2) {
+            positions[i] = positions[i - 1] + SIMD4<Float>(Float.random(in: -0.05 ... 0.05),
+                                                           Float.random(in: -0.05 ... 0.05), 0, 0)
+        }
+        let centers = (0 ..< colliderCount).map { _ in
+            SIMD3<Float>(Float.random(in: 0 ..< side), Float.random(in: 0 ..< side), Float.random(in: 0 ..< side))
+        }
+        let cube = cubeDistanceField()
+        // the distance field is the unit cube scaled down to the size of the box.
+        let shapes: [(String, ColliderShape.ShapeType, SIMD3<Float>)] = [
+            ("sphere", .Sphere, SIMD3<Float>(0.2, 0, 0)), ("box", .Box, SIMD3<Float>(0.4, 0.4, 0.4)),
+            ("capsule", .Capsule, SIMD3<Float>(0.1, 0.4, 1)), ("distance field", .SignedDistanceField, SIMD3<Float>(1, 1, 1)),
+        ]
+        for useEdges in [false, true] {
+            let edges = useEdges ? stride(from: Int32(0), to: Int32(particleCount), by: 2).map { SIMD2<Int32>($0, $0 + 1) }
+                : []
+            let solver = makeSolver(positions: positions, edges: edges)
+            let steps = 10
+
+            // collision detection without colliders, subtracted from every shape's time.
+            var start = CFAbsoluteTimeGetCurrent()
+            for _ in 0 ..< steps {
+                solver.collisionDetection(stepTime: stepTime)
+            }
+            let baseline = (CFAbsoluteTimeGetCurrent() - start) / Double(steps)
+
+            for (name, type, size) in shapes {
+                let world = CPUColliderWorld()
+                world.SetDistanceFieldData(headers: [DistanceFieldHeader(firstNode: 0, nodeCount: cube.count)],
+                                           nodes: cube)
+                setColliders(world, type: type, size: size, scale: type == .SignedDistanceField ? 0.4 : 1,
+                             centers: centers)
+                solver.colliderWorld = world
+                start = CFAbsoluteTimeGetCurrent()
+                for _ in 0 ..< steps {
+                    solver.collisionDetection(stepTime: stepTime)
+                }
+                let time = (CFAbsoluteTimeGetCurrent() - start) / Double(steps) - baseline
+                let candidates = solver.colliderCandidates().count
+                print(String(format: "collider contacts, %@ vs %d %@ colliders, %d threads: %d candidates, %d contacts, %.2f ms, %.1f M candidates/s",
+                             useEdges ? "edges" : "particles", colliderCount, name, CPUParticleSolver.threadCount,
+                             candidates, solver.colliderContactCount, time * 1000,
+                             Double(candidates) / max(time, 1e-9) / 1e6))
+                solver.colliderWorld = nil
+            }
+        }
+    }
+}
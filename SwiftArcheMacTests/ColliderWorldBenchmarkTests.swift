@@ -0,0 +1,129 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+import vox_flex
+import XCTest
+
+final class ColliderWorldBenchmarkTests: XCTestCase {
+    let side: Float = 4
+    let particleRadius: Float = 0.02
+    let stepTime: Float = 1 / 60
+
+    struct MovingSphere {
+        var center: SIMD3<Float>
+        var velocity: SIMD3<Float>
+        var radius: Float
+    }
+
+    func makeSolver(particleCount: Int) -> CPUParticleSolver {
+        let positions = (0 ..< particleCount).map { _ in
+            SIMD4<Float>(Float.random(in: 0 ..< side), Float.random(in: 0 ..< side), Float.random(in: 0 ..< side), 0)
+        }
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: particleCount))
+        solver.setCollisionMaterial(radii: [Float](repeating: particleRadius, count: particleCount),
+                                    phases: (0 ..< particleCount).map { ObiUtils.MakePhase(group: $0, flags: []) },
+                                    filters: [Int](repeating: ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything,
+                                                                                  category: 0), count: particleCount))
+        solver.setSimplices(points: (0 ..< Int32(particleCount)).map { $0 })
+        return solver
+    }
+
+    func makeSpheres(count: Int) -> [MovingSphere] {
+        (0 ..< count).map { _ in
+            MovingSphere(center: SIMD3<Float>(Float.random(in: 0 ..< side), Float.random(in: 0 ..< side),
+                                              Float.random(in: 0 ..< side)),
+                         velocity: SIMD3<Float>(Float.random(in: -1 ... 1), Float.random(in: -1 ... 1),
+                                                Float.random(in: -1 ... 1)),
+                         radius: Float.random(in: 0.02 ... 0.3))
+        }
+    }
+
+    func bounds(_ sphere: MovingSphere) -> Aabb {
+        Aabb(min: Vector4(sphere.center.x - sphere.radius, sphere.center.y - sphere.radius, sphere.center.z - sphere.radius, 0),
+             max: Vector4(sphere.center.x + sphere.radius, sphere.center.y + sphere.radius, sphere.center.z + sphere.radius, 0))
+    }
+
+    /// moves the spheres and hands them to the world, each with its own kinematic rigidbody.
+    func move(_ spheres: inout [MovingSphere], world: CPUColliderWorld, by time: Float) {
+        for i in 0 ..< spheres.count {
+            spheres[i].center += spheres[i].velocity * time
+        }
+        let shapes = spheres.enumerated().map {
+            ColliderShape(center: Vector4(0, 0, 0, 0), size: Vector4($1.radius, $1.radius, $1.radius, 0), type: .Sphere,
+                          rigidbodyIndex: $0)
+        }
+        let transforms = spheres.map {
+            AffineTransform(translation: Vector4($0.center.x, $0.center.y, $0.center.z, 0), rotation: Quaternion(),
+                            scale: Vector4(1, 1, 1, 1))
+        }
+        world.SetColliders(shapes: shapes, bounds: spheres.map { bounds($0) }, transforms: transforms,
+                           count: spheres.count)
+        world.SetRigidbodies(rigidbody: spheres.map {
+            ColliderRigidbody(velocity: Vector4($0.velocity.x, $0.velocity.y, $0.velocity.z, 0))
+        })
+        world.UpdateWorld(deltaTime: stepTime)
+    }
+
+    func testCandidatesMatchBruteForce() throws {
+        let solver = makeSolver(particleCount: 2000)
+        let world = CPUColliderWorld()
+        solver.colliderWorld = world
+        var spheres = makeSpheres(count: 200)
+        let margin = solver.collisionMargin
+        let positions = solver.positions()
+
+        for _ in 0 ..< 5 {
+            move(&spheres, world: world, by: 0.1)
+            solver.collisionDetection(stepTime: stepTime)
+
+            var expected = Set<SIMD2<Int32>>()
+            for (c, sphere) in spheres.enumerated() {
+                // bounds swept by the rigidbody velocity, particles at rest.
+                let sweep = sphere.velocity * stepTime
+                let lower = sphere.center - sphere.radius + simd_min(sweep, .zero)
+                let upper = sphere.center + sphere.radius + simd_max(sweep, .zero)
+                for (p, position) in positions.enumerated() {
+                    let reach = particleRadius + margin
+                    let point = SIMD3<Float>(position.x, position.y, position.z)
+                    if all(point + reach .>= lower) && all(point - reach .<= upper) {
+                        expected.insert(SIMD2<Int32>(Int32(p), Int32(c)))
+                    }
+                }
+            }
+            let candidates = solver.colliderCandidates()
+            XCTAssertEqual(candidates.count, expected.count)
+            XCTAssertEqual(Set(candidates), expected)
+        }
+        XCTAssertEqual(world.referenceCount, 1)
+    }
+
+    func testMovingCollidersBenchmark() throws {
+        let solver = makeSolver(particleCount: 10000)
+        let world = CPUColliderWorld()
+        solver.colliderWorld = world
+        var spheres = makeSpheres(count: 1000)
+        move(&spheres, world: world, by: 0)
+
+        let steps = 60
+        var updateTime: Double = 0
+        var detectionTime: Double = 0
+        var candidates = 0
+        for _ in 0 ..< steps {
+            var start = CFAbsoluteTimeGetCurrent()
+            move(&spheres, world: world, by: stepTime)
+            updateTime += CFAbsoluteTimeGetCurrent() - start
+            start = CFAbsoluteTimeGetCurrent()
+            solver.collisionDetection(stepTime: stepTime)
+            detectionTime += CFAbsoluteTimeGetCurrent() - start
+            candidates += solver.colliderCandidates().count
+        }
+        print(String(format: "collider world 10000 particles vs 1000 moving colliders, %d cells, %d threads: update %.3f ms, collision detection %.2f ms, %d candidates/step",
+                     world.cellCount, CPUParticleSolver.threadCount, updateTime / Double(steps) * 1000,
+                     detectionTime / Double(steps) * 1000, candidates / steps))
+    }
+}
@@ -0,0 +1,72 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class ConstraintBatcherBenchmarkTests: XCTestCase {
+    // contacts of a packed particle block: each particle touches 12 neighbors, in shuffled order
+    // as they come out of parallel contact generation.
+    func makeContacts(side: Int) -> [SIMD2<Int32>] {
+        let offsets = [SIMD3<Int>(1, 0, 0), SIMD3<Int>(0, 1, 0), SIMD3<Int>(0, 0, 1),
+                       SIMD3<Int>(1, 1, 0), SIMD3<Int>(0, 1, 1), SIMD3<Int>(1, 0, 1)]
+        var contacts: [SIMD2<Int32>] = []
+        contacts.reserveCapacity(side * side * side * offsets.count)
+        for z in 0 ..< side {
+            for y in 0 ..< side {
+                for x in 0 ..< side {
+                    for o in offsets where x + o.x < side && y + o.y < side && z + o.z < side {
+                        let a = (z * side + y) * side + x
+                        let b = ((z + o.z) * side + y + o.y) * side + x + o.x
+                        contacts.append(SIMD2<Int32>(Int32(a), Int32(b)))
+                    }
+                }
+            }
+        }
+        contacts.shuffle()
+        return contacts
+    }
+
+    func testBatchesShareNoParticle() throws {
+        let side = 24
+        let contacts = makeContacts(side: side)
+        let particleCount = side * side * side
+        let (sortedIndices, batches) = CPUConstraintBatcher().batch(pairs: contacts, particleCount: particleCount,
+                                                                     constraintStride: 144)
+        XCTAssertEqual(Set(sortedIndices).count, contacts.count)
+        for batch in batches where !batch.isLast {
+            var used = [Bool](repeating: false, count: particleCount)
+            for slot in batch.startIndex ..< batch.startIndex + batch.constraintCount {
+                let contact = contacts[Int(sortedIndices[slot])]
+                XCTAssertFalse(used[Int(contact.x)] || used[Int(contact.y)])
+                used[Int(contact.x)] = true
+                used[Int(contact.y)] = true
+            }
+        }
+    }
+
+    func testColoringOneMillionContacts() throws {
+        // 56^3 particles, about 1M contacts.
+        let side = 56
+        let contacts = makeContacts(side: side)
+        let batcher = CPUConstraintBatcher()
+        var result = batcher.batch(pairs: contacts, particleCount: side * side * side, constraintStride: 144)
+        let start = CFAbsoluteTimeGetCurrent()
+        let runs = 10
+        for _ in 0 ..< runs {
+            result = batcher.batch(pairs: contacts, particleCount: side * side * side, constraintStride: 144)
+        }
+        let elapsed = (CFAbsoluteTimeGetCurrent() - start) / Double(runs)
+
+        let colored = result.batches.filter { !$0.isLast }
+        let largest = colored.map(\.constraintCount).max() ?? 0
+        let average = Double(colored.map(\.constraintCount).reduce(0, +)) / Double(max(colored.count, 1))
+        let overflow = result.batches.last(where: \.isLast)?.constraintCount ?? 0
+        print("batched \(contacts.count) contacts in \(elapsed * 1000) ms, \(Double(contacts.count) / elapsed / 1e6) Mcontacts/s")
+        print("\(result.batches.count) batches: sizes \(result.batches.map(\.constraintCount)), "
+            + "largest/average \(Double(largest) / average), overflow \(overflow)")
+    }
+}
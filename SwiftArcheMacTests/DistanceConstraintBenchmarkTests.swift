@@ -0,0 +1,92 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class DistanceConstraintBenchmarkTests: XCTestCase {
+    let spacing: Float = 0.01
+
+    // a side x side cloth lying in the xz plane, pinned along its first row, with structural constraints
+    // colored into batches sharing no particle.
+    func makeCloth(side: Int, order: CPUParticleSolver.EvaluationOrder, iterations: Int,
+                   sorFactor: Float = 1) -> (CPUParticleSolver, [SIMD2<Int32>])
+    {
+        var positions: [SIMD4<Float>] = []
+        var invMasses: [Float] = []
+        var pairs: [SIMD2<Int32>] = []
+        for z in 0 ..< side {
+            for x in 0 ..< side {
+                let i = Int32(z * side + x)
+                positions.append(SIMD4<Float>(Float(x) * spacing, 0, Float(z) * spacing, 0))
+                invMasses.append(z == 0 ? 0 : 1)
+                if x + 1 < side {
+                    pairs.append(SIMD2<Int32>(i, i + 1))
+                }
+                if z + 1 < side {
+                    pairs.append(SIMD2<Int32>(i, i + Int32(side)))
+                }
+            }
+        }
+
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: invMasses)
+        solver.setConstraintParameters(.Distance, order: order, iterations: iterations, sorFactor: sorFactor)
+
+        let (sortedIndices, batches) = CPUConstraintBatcher().batch(pairs: pairs, particleCount: positions.count,
+                                                                     constraintStride: 16)
+        for batch in batches {
+            XCTAssertFalse(batch.isLast)
+            let batchPairs = sortedIndices[batch.startIndex ..< batch.startIndex + batch.constraintCount].map {
+                pairs[Int($0)]
+            }
+            solver.addDistanceConstraints(pairs: batchPairs, restLengths: [Float](repeating: spacing,
+                                                                                   count: batchPairs.count))
+        }
+        return (solver, pairs)
+    }
+
+    func maxStretch(_ solver: CPUParticleSolver, _ pairs: [SIMD2<Int32>]) -> Float {
+        let positions = solver.positions()
+        return pairs.map { pair in
+            let d = positions[Int(pair.x)] - positions[Int(pair.y)]
+            return (d * d).sum().squareRoot() / spacing - 1
+        }.max() ?? 0
+    }
+
+    func testHangingClothKeepsItsLength() throws {
+        for order in [CPUParticleSolver.EvaluationOrder.sequential, .parallel] {
+            let (solver, pairs) = makeCloth(side: 12, order: order, iterations: 60,
+                                            sorFactor: order == .parallel ? 1.5 : 1)
+            for _ in 0 ..< 60 {
+                solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+            }
+            XCTAssertLessThan(maxStretch(solver, pairs), 0.05)
+        }
+    }
+
+    func testClothConstraintThroughput() throws {
+        // 512 x 512 particles, about 523k constraints.
+        let side = 512
+        let iterations = 10
+        let substeps = 20
+        let threads = CPUParticleSolver.threadCount
+        for order in [CPUParticleSolver.EvaluationOrder.sequential, .parallel] {
+            let (solver, pairs) = makeCloth(side: side, order: order, iterations: iterations,
+                                            sorFactor: order == .parallel ? 1.5 : 1)
+            solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+            let start = CFAbsoluteTimeGetCurrent()
+            for _ in 0 ..< substeps {
+                solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+            }
+            let elapsed = CFAbsoluteTimeGetCurrent() - start
+            let rate = Double(pairs.count * iterations * substeps) / elapsed
+            print("\(order): \(pairs.count) constraints x \(iterations) iterations, \(elapsed / Double(substeps) * 1000) ms/substep, "
+                + "\(rate / 1e6) Mconstraints/s, \(rate / Double(threads) / 1e6) Mconstraints/s per thread (\(threads) threads), "
+                + "max stretch \(maxStretch(solver, pairs))")
+        }
+    }
+}
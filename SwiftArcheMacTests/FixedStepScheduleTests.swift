@@ -0,0 +1,75 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import simd
+import vox_flex
+import XCTest
+
+final class FixedStepScheduleTests: XCTestCase {
+    /// irregular frame times, averaging a bit under 60 Hz.
+    let frameTimes: [Float] = [0.016, 0.017, 0.011, 0.025, 0.040, 0.009, 0.016, 0.033]
+
+    /// one free particle moving along x at 1 m/s.
+    func makeSolver(interpolation: Oni.SolverParameters.Interpolation) -> CPUParticleSolver {
+        let solver = CPUParticleSolver()
+        solver.gravity = .zero
+        solver.sleepThreshold = 0
+        solver.setParticles(positions: [SIMD4<Float>()], invMasses: [1])
+        solver.setVelocities([SIMD4<Float>(1, 0, 0, 0)])
+        solver.interpolation = interpolation
+        solver.fixedStepTime = 1 / 30
+        solver.fixedSubsteps = 2
+        return solver
+    }
+
+    func testRenderablesFollowTheFrameTime() throws {
+        for interpolation in [Oni.SolverParameters.Interpolation.Interpolate, .Extrapolate] {
+            let solver = makeSolver(interpolation: interpolation)
+            var time: Float = 0
+            var steps = 0
+            for frame in 0 ..< 80 {
+                let frameTime = frameTimes[frame % frameTimes.count]
+                time += frameTime
+                let statistics = solver.advance(frameTime: frameTime)
+                steps += statistics.steps
+                XCTAssertLessThan(statistics.unsimulatedTime, solver.fixedStepTime)
+
+                // interpolation renders one step behind the simulation, extrapolation right on time.
+                let expected = interpolation == .Interpolate ? max(time - solver.fixedStepTime, 0) : time
+                XCTAssertEqual(solver.renderablePositions()[0].x, expected, accuracy: 1e-4)
+            }
+            XCTAssertEqual(steps, solver.scheduleCounts.steps)
+            XCTAssertEqual(solver.scheduleCounts.frames, 80)
+            print(String(format: "fixed steps at %.0f Hz: %.2f steps per frame",
+                         1 / solver.fixedStepTime, Float(steps) / 80))
+        }
+    }
+
+    func testLoweringTheStepRateKeepsRenderablesContinuous() throws {
+        let solver = makeSolver(interpolation: .Extrapolate)
+        var time: Float = 0
+        for frame in 0 ..< 120 {
+            // under load the solver drops to 20 Hz halfway through.
+            if frame == 60 {
+                solver.fixedStepTime = 1 / 20
+            }
+            time += 1 / 60
+            solver.advance(frameTime: 1 / 60)
+            XCTAssertEqual(solver.renderablePositions()[0].x, time, accuracy: 1e-4)
+        }
+    }
+
+    func testHitchDropsWholeSteps() throws {
+        let solver = makeSolver(interpolation: .None)
+        solver.maxStepsPerFrame = 3
+        let statistics = solver.advance(frameTime: 0.5)
+        XCTAssertEqual(statistics.steps, 3)
+        XCTAssertEqual(statistics.droppedTime + statistics.unsimulatedTime + 3 * solver.fixedStepTime, 0.5,
+                       accuracy: 1e-5)
+        XCTAssertLessThan(statistics.unsimulatedTime, solver.fixedStepTime)
+        XCTAssertEqual(solver.renderablePositions()[0].x, 3 * solver.fixedStepTime, accuracy: 1e-4)
+    }
+}
@@ -0,0 +1,86 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class FluidDensityBenchmarkTests: XCTestCase {
+    let spacing: Float = 0.05
+    let restDensity: Float = 1000
+
+    // a side^3 block of fluid resting on a static floor layer one spacing below it.
+    func makeBlock(side: Int, iterations: Int) -> CPUParticleSolver {
+        var positions: [SIMD4<Float>] = []
+        var invMasses: [Float] = []
+        let floorSide = side + 4
+        for z in 0 ..< floorSide {
+            for x in 0 ..< floorSide {
+                positions.append(SIMD4<Float>(Float(x - 2) * spacing, -spacing, Float(z - 2) * spacing, 0))
+                invMasses.append(0)
+            }
+        }
+        for y in 0 ..< side {
+            for z in 0 ..< side {
+                for x in 0 ..< side {
+                    positions.append(SIMD4<Float>(Float(x) * spacing, Float(y) * spacing, Float(z) * spacing, 0))
+                    invMasses.append(1)
+                }
+            }
+        }
+
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: invMasses)
+        solver.setFluidMaterial(radius: spacing / 2, smoothingRadius: spacing * 2, restDensity: restDensity,
+                                viscosity: 0.01, vorticityConfinement: 0)
+        solver.setConstraintParameters(.Density, order: .parallel, iterations: iterations, sorFactor: 1)
+        return solver
+    }
+
+    func testFluidBlockKeepsItsDensity() throws {
+        let solver = makeBlock(side: 10, iterations: 4)
+        for _ in 0 ..< 60 {
+            solver.step(stepTime: 1 / 60, substeps: 4)
+        }
+        solver.updateRenderables()
+
+        XCTAssertGreaterThan(solver.fluidInteractionCount, 0)
+        let positions = solver.positions()
+        XCTAssertGreaterThan(positions.map { $0.y }.min() ?? -1, -spacing)
+        XCTAssertLessThan(solver.fluidDensities().max() ?? 0, restDensity * 1.1)
+        XCTAssertTrue(solver.anisotropies().allSatisfy { $0.w.isFinite && $0.w > 0 })
+    }
+
+    func testFluidScaling() throws {
+        let substeps = 4
+        let steps = 3
+        let threads = CPUParticleSolver.threadCount
+        // 8k, 64k, 216k and 512k fluid particles.
+        for side in [20, 40, 60, 80] {
+            let solver = makeBlock(side: side, iterations: 3)
+            solver.step(stepTime: 1 / 60, substeps: substeps)
+
+            var detectionTime: Double = 0
+            var substepTime: Double = 0
+            for _ in 0 ..< steps {
+                var start = CFAbsoluteTimeGetCurrent()
+                solver.collisionDetection(stepTime: 1 / 60)
+                detectionTime += CFAbsoluteTimeGetCurrent() - start
+                start = CFAbsoluteTimeGetCurrent()
+                for _ in 0 ..< substeps {
+                    solver.substep(stepTime: 1 / 60, substepTime: 1 / 60 / Float(substeps), substeps: substeps)
+                }
+                substepTime += CFAbsoluteTimeGetCurrent() - start
+            }
+
+            let particles = side * side * side
+            let stepMs = (detectionTime + substepTime) / Double(steps) * 1000
+            print(String(format: "fluid %7d particles, %8d pairs, %d threads: collision %.2f ms, substeps %.2f ms, %.2f ms/step, %.2f Mparticle-substeps/s",
+                         particles, solver.fluidInteractionCount, threads,
+                         detectionTime / Double(steps) * 1000, substepTime / Double(steps) * 1000, stepMs,
+                         Double(particles * substeps * steps) / substepTime / 1e6))
+        }
+    }
+}
@@ -0,0 +1,56 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class HashGridBenchmarkTests: XCTestCase {
+    let radius: Float = 0.1
+
+    // jittered lattice at SPH-like density, about 30 neighbors per particle inside `radius`.
+    func makeParticles(_ count: Int) -> [SIMD3<Float>] {
+        let side = Int(Double(count).squareRoot().squareRoot().rounded(.up))
+        let spacing = radius * 0.5
+        return (0 ..< count).map { i in
+            SIMD3<Float>(Float(i % side), Float((i / side) % side), Float(i / (side * side))) * spacing
+                + SIMD3<Float>.random(in: -0.1 ... 0.1) * spacing
+        }
+    }
+
+    func run(_ particles: [SIMD3<Float>], mode: CPUPointHashGridSearcher.NeighborhoodMode,
+             gridSpacing: Float) -> (neighbors: Int, seconds: Double)
+    {
+        let searcher = CPUPointHashGridSearcher(resolution: SIMD3<UInt32>(128, 128, 128), gridSpacing: gridSpacing)
+        searcher.neighborhoodMode = mode
+        searcher.build(particles)
+        let start = CFAbsoluteTimeGetCurrent()
+        let lists = searcher.neighborLists(radius: radius)
+        return (lists.neighbors.count, CFAbsoluteTimeGetCurrent() - start)
+    }
+
+    func testNeighborhoodModesAgree() throws {
+        let particles = makeParticles(20000)
+        let reference = run(particles, mode: .octant8, gridSpacing: 2 * radius).neighbors
+        XCTAssertEqual(run(particles, mode: .cube27, gridSpacing: radius).neighbors, reference)
+        XCTAssertEqual(run(particles, mode: .radius, gridSpacing: radius).neighbors, reference)
+        XCTAssertEqual(run(particles, mode: .radius, gridSpacing: radius * 0.5).neighbors, reference)
+    }
+
+    func testNeighborhoodThroughput() throws {
+        let particles = makeParticles(500_000)
+        let configurations: [(String, CPUPointHashGridSearcher.NeighborhoodMode, Float)] = [
+            ("octant8, h = 2r", .octant8, 2 * radius),
+            ("cube27, h = r", .cube27, radius),
+            ("radius, h = r", .radius, radius),
+            ("radius, h = r / 2", .radius, radius * 0.5),
+        ]
+        for (name, mode, gridSpacing) in configurations {
+            let result = run(particles, mode: mode, gridSpacing: gridSpacing)
+            print("\(name): \(Double(result.neighbors) / Double(particles.count)) neighbors/particle, "
+                + "\(Double(particles.count) / result.seconds / 1e6) Mparticles/s")
+        }
+    }
+}
@@ -0,0 +1,166 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+import vox_flex
+import XCTest
+
+final class HeightFieldBenchmarkTests: XCTestCase {
+    let particleRadius: Float = 0.02
+    let contactOffset: Float = 0.01
+    let stepTime: Float = 1 / 60
+
+    func makeSolver(positions: [SIMD4<Float>]) -> CPUParticleSolver {
+        let count = positions.count
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: count))
+        solver.setCollisionMaterial(radii: [Float](repeating: particleRadius, count: count),
+                                    phases: (0 ..< count).map { ObiUtils.MakePhase(group: $0, flags: []) },
+                                    filters: [Int](repeating: ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything,
+                                                                                  category: 0), count: count))
+        solver.setSimplices(points: (0 ..< Int32(count)).map { $0 })
+        return solver
+    }
+
+    /// a single heightfield collider spanning `size`, at the origin, over heightfield 0.
+    func setTerrain(_ world: CPUColliderWorld, size: SIMD3<Float>) {
+        world.SetColliders(shapes: [ColliderShape(size: Vector4(size.x, size.y, size.z, 0), type: .Heightmap,
+                                                  contactOffset: contactOffset, dataIndex: 0)],
+                           bounds: [Aabb(min: Vector4(0, -contactOffset, 0, 0),
+                                         max: Vector4(size.x, size.y + contactOffset, size.z, 0))],
+                           transforms: [AffineTransform(translation: Vector4(), rotation: Quaternion(),
+                                                        scale: Vector4(1, 1, 1, 1))], count: 1)
+        world.UpdateWorld(deltaTime: stepTime)
+    }
+
+    /// particles on a regular grid over [0, side] x [0, side], at height `y`.
+    func gridPositions(count: Int, side: Float, y: Float) -> [SIMD4<Float>] {
+        (0 ..< count * count).map { i in
+            SIMD4<Float>((Float(i % count) + 0.5) / Float(count) * side, y,
+                         (Float(i / count) + 0.5) / Float(count) * side, 0)
+        }
+    }
+
+    func testFlatTerrainContacts() throws {
+        let world = CPUColliderWorld()
+        world.SetHeightField(index: 0, resolutionU: 17, resolutionV: 9,
+                             samples: [Float](repeating: 0.5, count: 17 * 9))
+        setTerrain(world, size: SIMD3<Float>(4, 2, 4))
+        // resting on the surface, at height 0.5 * 2.
+        let solver = makeSolver(positions: gridPositions(count: 20, side: 4, y: 1 + particleRadius))
+        solver.colliderWorld = world
+        solver.collisionDetection(stepTime: stepTime)
+
+        let contacts = solver.colliderContacts()
+        XCTAssertEqual(solver.colliderContactCounts()[.Heightmap], contacts.count)
+        XCTAssertEqual(Set(contacts.map { $0.bodyA }).count, 400)
+        for contact in contacts {
+            XCTAssertEqual(contact.pointB.y, 1, accuracy: 1e-4)
+            XCTAssertEqual(contact.normal.y, 1, accuracy: 1e-4)
+            XCTAssertEqual(contact.distance, 0, accuracy: 1e-4)
+        }
+    }
+
+    func testHolesDropContacts() throws {
+        let world = CPUColliderWorld()
+        // Obi's layout: a negative sample makes a hole of the cell it is the first corner of.
+        let resolution = 9
+        var samples = [Float](repeating: 0.5, count: resolution * resolution)
+        for v in 0 ..< resolution - 1 {
+            for u in 0 ..< (resolution - 1) / 2 {
+                samples[v * resolution + u] = -0.5
+            }
+        }
+        world.SetHeightFieldData(headers: [HeightFieldHeader(firstSample: 0, sampleCount: samples.count)],
+                                 samples: samples)
+        setTerrain(world, size: SIMD3<Float>(4, 2, 4))
+        let solver = makeSolver(positions: gridPositions(count: 20, side: 4, y: 1 + particleRadius))
+        solver.colliderWorld = world
+        solver.collisionDetection(stepTime: stepTime)
+
+        // the left half of the terrain is a hole, particles well inside it get no contacts.
+        let contacts = solver.colliderContacts()
+        XCTAssertGreaterThan(contacts.count, 0)
+        for contact in contacts {
+            XCTAssertGreaterThanOrEqual(contact.pointB.x, 2 - 1e-4)
+        }
+    }
+
+    func testSubRectangleUpdate() throws {
+        let world = CPUColliderWorld()
+        let resolution = 33
+        world.SetHeightField(index: 0, resolutionU: resolution, resolutionV: resolution,
+                             samples: [Float](repeating: 0, count: resolution * resolution))
+        setTerrain(world, size: SIMD3<Float>(8, 1, 8))
+        // hovering at height 1, above a raised plateau only.
+        let solver = makeSolver(positions: gridPositions(count: 32, side: 8, y: 1 + particleRadius))
+        solver.colliderWorld = world
+        solver.collisionDetection(stepTime: stepTime)
+        XCTAssertEqual(solver.colliderContactCount, 0)
+
+        // samples 8 ..< 17 along both axes, the cells between them up to height 1: 2 to 4 along x and z.
+        world.UpdateHeightField(index: 0, u: 8, v: 8, width: 9, height: 9, samples: [Float](repeating: 1, count: 81))
+        solver.collisionDetection(stepTime: stepTime)
+        let contacts = solver.colliderContacts()
+        XCTAssertGreaterThan(contacts.count, 0)
+        for contact in contacts {
+            XCTAssertTrue((2 - 1e-4 ... 4 + 1e-4).contains(contact.pointB.x))
+            XCTAssertTrue((2 - 1e-4 ... 4 + 1e-4).contains(contact.pointB.z))
+        }
+    }
+
+    func testHeightFieldThroughput() throws {
+        let resolution = 513
+        let side: Float = 100
+        let height: Float = 10
+        let samples = (0 ..< resolution * resolution).map { i in
+            0.5 + 0.4 * sin(Float(i % resolution) * 0.05) * cos(Float(i / resolution) * 0.04)
+        }
+        let world = CPUColliderWorld()
+        var start = CFAbsoluteTimeGetCurrent()
+        world.SetHeightField(index: 0, resolutionU: resolution, resolutionV: resolution, samples: samples)
+        let fullTime = CFAbsoluteTimeGetCurrent() - start
+
+        // 33 x 33 samples rewritten in place, as terrain editing does.
+        let patch = [Float](repeating: 0.7, count: 33 * 33)
+        let updates = 1000
+        start = CFAbsoluteTimeGetCurrent()
+        for k in 0 ..< updates {
+            world.UpdateHeightField(index: 0, u: (k * 37) % 480, v: (k * 53) % 480, width: 33, height: 33,
+                                    samples: patch)
+        }
+        let updateTime = (CFAbsoluteTimeGetCurrent() - start) / Double(updates)
+        world.SetHeightField(index: 0, resolutionU: resolution, resolutionV: resolution, samples: samples)
+        setTerrain(world, size: SIMD3<Float>(side, height, side))
+
+        // 100k particles scattered just over the terrain surface.
+        let scale = Float(resolution - 1) / side
+        let positions = (0 ..< 100_000).map { _ -> SIMD4<Float> in
+            let x = Float.random(in: 0 ..< side), z = Float.random(in: 0 ..< side)
+            let surface = (0.5 + 0.4 * sin(x * scale * 0.05) * cos(z * scale * 0.04)) * height
+            return SIMD4<Float>(x, surface + Float.random(in: -0.02 ... 0.1), z, 0)
+        }
+        let solver = makeSolver(positions: positions)
+        let steps = 10
+        start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< steps {
+            solver.collisionDetection(stepTime: stepTime)
+        }
+        let baseline = (CFAbsoluteTimeGetCurrent() - start) / Double(steps)
+
+        solver.colliderWorld = world
+        start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< steps {
+            solver.collisionDetection(stepTime: stepTime)
+        }
+        let time = (CFAbsoluteTimeGetCurrent() - start) / Double(steps) - baseline
+        print(String(format: "heightfield %dx%d: full set %.3f ms, 33x33 update %.4f ms",
+                     resolution, resolution, fullTime * 1000, updateTime * 1000))
+        print(String(format: "heightfield contacts, %d particles, %d threads: %d contacts, %.2f ms, %.1f M particles/s",
+                     positions.count, CPUParticleSolver.threadCount, solver.colliderContactCount, time * 1000,
+                     Double(positions.count) / max(time, 1e-9) / 1e6))
+    }
+}
@@ -0,0 +1,64 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import simd
+import vox_flex
+import XCTest
+
+final class InertialFrameTests: XCTestCase {
+    let stepTime: Float = 1 / 120
+
+    /// solver space accelerates along x at 3 m/s^2 while spinning about y at 2 rad/s, carrying one free particle
+    /// at (1, 0, 0). Returns the particle's world positions and the frame's, step after step.
+    func simulate(linearInertiaScale: Float, angularInertiaScale: Float) -> [(particle: SIMD3<Float>,
+                                                                               anchor: SIMD3<Float>)] {
+        let solver = CPUParticleSolver()
+        solver.gravity = .zero
+        solver.sleepThreshold = 0
+        solver.damping = 0
+        solver.setParticles(positions: [SIMD4<Float>(1, 0, 0, 0)], invMasses: [1])
+        solver.setFrame(translation: .zero)
+
+        var result: [(SIMD3<Float>, SIMD3<Float>)] = []
+        var time: Float = 0
+        for _ in 0 ..< 240 {
+            time += stepTime
+            let translation = SIMD3<Float>(1.5 * time * time, 0, 0)
+            let rotation = simd_quatf(angle: 2 * time, axis: SIMD3<Float>(0, 1, 0))
+            solver.updateFrame(translation: translation, rotation: rotation, deltaTime: stepTime,
+                               linearInertiaScale: linearInertiaScale, angularInertiaScale: angularInertiaScale)
+            solver.step(stepTime: stepTime, substeps: 4)
+            let local = solver.positions()[0]
+            result.append((translation + rotation.act(SIMD3<Float>(local.x, local.y, local.z)),
+                           translation + rotation.act(SIMD3<Float>(1, 0, 0))))
+        }
+        return result
+    }
+
+    func testFullInertiaMatchesWorldSpace() throws {
+        // a free particle at rest in the world stays there, whatever solver space does.
+        for (particle, _) in simulate(linearInertiaScale: 1, angularInertiaScale: 1) {
+            XCTAssertLessThan(simd_distance(particle, SIMD3<Float>(1, 0, 0)), 0.05)
+        }
+    }
+
+    func testNoInertiaFollowsTheFrame() throws {
+        for (particle, anchor) in simulate(linearInertiaScale: 0, angularInertiaScale: 0) {
+            XCTAssertLessThan(simd_distance(particle, anchor), 1e-4)
+        }
+    }
+
+    func testFrameVelocities() throws {
+        let solver = CPUParticleSolver()
+        solver.setFrame(translation: .zero)
+        solver.updateFrame(translation: SIMD3<Float>(0.1, 0, 0),
+                           rotation: simd_quatf(angle: 0.05, axis: SIMD3<Float>(0, 0, 1)), deltaTime: 0.1)
+        let frame = solver.inertialFrame
+        XCTAssertEqual(frame.velocity.x, 1, accuracy: 1e-4)
+        XCTAssertEqual(frame.angularVelocity.z, 0.5, accuracy: 1e-3)
+        XCTAssertEqual(frame.acceleration.x, 10, accuracy: 1e-3)
+    }
+}
@@ -0,0 +1,101 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class MultilevelGridBenchmarkTests: XCTestCase {
+    func cellCoords(_ position: SIMD3<Float>, level: Int) -> int4 {
+        let cell = (position / CPUMultilevelGrid.cellSize(ofLevel: level)).rounded(.down)
+        return int4(Int32(cell.x), Int32(cell.y), Int32(cell.z), Int32(level))
+    }
+
+    func randomPositions(count: Int) -> [SIMD3<Float>] {
+        var generator = SystemRandomNumberGenerator()
+        return (0 ..< count).map { _ in
+            SIMD3<Float>(Float.random(in: 0 ..< 2, using: &generator), Float.random(in: 0 ..< 2, using: &generator),
+                         Float.random(in: 0 ..< 2, using: &generator))
+        }
+    }
+
+    // moves every position by up to `amount` cells and returns the entities that changed cell.
+    func jitter(_ positions: inout [SIMD3<Float>], _ coords: inout [int4], amount: Float) -> [MovingEntity] {
+        var moves: [MovingEntity] = []
+        for i in 0 ..< positions.count {
+            let cellSize = CPUMultilevelGrid.cellSize(ofLevel: Int(coords[i].w))
+            positions[i] += SIMD3<Float>(Float.random(in: -0.5 ... 0.5), Float.random(in: -0.5 ... 0.5),
+                                         Float.random(in: -0.5 ... 0.5)) * cellSize * amount
+            let newCoords = cellCoords(positions[i], level: Int(coords[i].w))
+            if newCoords != coords[i] {
+                moves.append(MovingEntity(oldCellCoord: coords[i], newCellCoord: newCoords, entity: i))
+                coords[i] = newCoords
+            }
+        }
+        return moves
+    }
+
+    func testIncrementalUpdateMatchesRebuild() throws {
+        let level = CPUMultilevelGrid.gridLevel(forSize: 0.05)
+        var positions = randomPositions(count: 20000)
+        // every 5th entity lives one level up.
+        var coords = positions.enumerated().map { cellCoords($1, level: level + ($0 % 5 == 0 ? 1 : 0)) }
+
+        let incremental = CPUMultilevelGrid()
+        incremental.build(cellCoords: coords)
+        for _ in 0 ..< 10 {
+            incremental.update(moving: jitter(&positions, &coords, amount: 0.5))
+        }
+
+        let rebuilt = CPUMultilevelGrid()
+        rebuilt.build(cellCoords: coords)
+        XCTAssertEqual(incremental.cellCount, rebuilt.cellCount)
+        XCTAssertEqual(incremental.entityCount, coords.count)
+        for cell in 0 ..< rebuilt.cellCount {
+            let cellCoords = rebuilt.cellCoords(cell)
+            guard let match = incremental.findCell(cellCoords) else {
+                XCTFail("missing cell \(cellCoords)")
+                continue
+            }
+            XCTAssertEqual(incremental.contents(match).sorted(), rebuilt.contents(cell).sorted())
+            XCTAssertTrue(rebuilt.contents(cell).allSatisfy { coords[Int($0)] == cellCoords })
+        }
+
+        XCTAssertEqual(CPUMultilevelGrid.parentCellCoords(int4(-3, 5, 8, 0), level: 2), int4(-1, 1, 2, 2))
+    }
+
+    func testRebuildVersusIncrementalUpdate() throws {
+        let count = 1_000_000
+        let level = CPUMultilevelGrid.gridLevel(forSize: 0.02)
+        let threads = CPUParticleSolver.threadCount
+        for amount: Float in [0.05, 0.2, 0.5] {
+            var positions = randomPositions(count: count)
+            var coords = positions.map { cellCoords($0, level: level) }
+            let grid = CPUMultilevelGrid()
+            grid.build(cellCoords: coords)
+
+            var rebuildTime: Double = 0
+            var updateTime: Double = 0
+            var moved = 0
+            let steps = 5
+            for _ in 0 ..< steps {
+                let moves = jitter(&positions, &coords, amount: amount)
+                moved += moves.count
+
+                var start = CFAbsoluteTimeGetCurrent()
+                grid.update(moving: moves)
+                updateTime += CFAbsoluteTimeGetCurrent() - start
+
+                let rebuilt = CPUMultilevelGrid()
+                start = CFAbsoluteTimeGetCurrent()
+                rebuilt.build(cellCoords: coords)
+                rebuildTime += CFAbsoluteTimeGetCurrent() - start
+            }
+            print(String(format: "multilevel grid %d entities, %d cells, %.1f%% moved, %d threads: rebuild %.2f ms, update %.2f ms, arena %d",
+                         count, grid.cellCount, Double(moved) / Double(count * steps) * 100, threads,
+                         rebuildTime / Double(steps) * 1000, updateTime / Double(steps) * 1000, grid.arenaSize))
+        }
+    }
+}
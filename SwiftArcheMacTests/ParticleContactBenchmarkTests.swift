@@ -0,0 +1,100 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class ParticleContactBenchmarkTests: XCTestCase {
+    func contactPairs(_ solver: CPUParticleSolver) -> Set<SIMD2<Int32>> {
+        Set(solver.particleContacts().map { SIMD2<Int32>(Int32(min($0.bodyA, $0.bodyB)), Int32(max($0.bodyA, $0.bodyB))) })
+    }
+
+    func testContactsBetweenSimplices() throws {
+        let positions: [SIMD4<Float>] = [
+            [0, 0, 0, 0], [0.15, 0, 0, 0], [0, -0.15, 0, 0], [-0.15, 0, 0, 0],
+            // edge crossing the triangle, 0.15 above particle 0.
+            [0, 0.15, -1, 0], [0, 0.15, 1, 0],
+            // triangle 0.15 in front of particle 0.
+            [-1, -1, 0.15, 0], [1, -1, 0.15, 0], [0, 1, 0.15, 0],
+        ]
+        let everything = ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything, category: 0)
+        let phases = [
+            ObiUtils.MakePhase(group: 1, flags: []), ObiUtils.MakePhase(group: 2, flags: []),
+            // same group as particle 0, neither self-colliding.
+            ObiUtils.MakePhase(group: 1, flags: []), ObiUtils.MakePhase(group: 3, flags: []),
+            ObiUtils.MakePhase(group: 4, flags: []), ObiUtils.MakePhase(group: 4, flags: []),
+            ObiUtils.MakePhase(group: 5, flags: []), ObiUtils.MakePhase(group: 5, flags: []),
+            ObiUtils.MakePhase(group: 5, flags: []),
+        ]
+        var filters = [Int](repeating: everything, count: positions.count)
+        // category 2, does not collide with category 0.
+        filters[3] = ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything & ~1, category: 2)
+
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: positions.count))
+        solver.setCollisionMaterial(radii: [Float](repeating: 0.1, count: positions.count), phases: phases,
+                                    filters: filters)
+        solver.setSimplices(points: [0, 1, 2, 3], edges: [SIMD2<Int32>(4, 5)], triangles: [SIMD3<Int32>(6, 7, 8)])
+        XCTAssertEqual(solver.simplexCount, 6)
+        solver.collisionDetection(stepTime: 1 / 60)
+
+        let pairs = contactPairs(solver)
+        XCTAssertTrue(pairs.contains([0, 1]))
+        XCTAssertFalse(pairs.contains([0, 2]))
+        XCTAssertFalse(pairs.contains([0, 3]))
+        XCTAssertTrue(pairs.contains([0, 4]))
+        XCTAssertTrue(pairs.contains([0, 5]))
+        XCTAssertTrue(pairs.contains([4, 5]))
+
+        for contact in solver.particleContacts() where contact.bodyA == 0 && contact.bodyB == 4 {
+            // from the edge towards the point, touching its middle.
+            XCTAssertEqual(contact.normal.y, -1, accuracy: 1e-3)
+            XCTAssertEqual(contact.pointB.x, 0.5, accuracy: 0.05)
+            XCTAssertEqual(contact.distance, -0.05, accuracy: 1e-3)
+        }
+    }
+
+    func testGranularContactThroughput() throws {
+        let radius: Float = 0.025
+        let steps = 5
+        let threads = CPUParticleSolver.threadCount
+        // 8k, 27k, 64k and 125k grains, jittered around a grid one diameter apart.
+        for side in [20, 30, 40, 50] {
+            var positions: [SIMD4<Float>] = []
+            for y in 0 ..< side {
+                for z in 0 ..< side {
+                    for x in 0 ..< side {
+                        let jitter = SIMD4<Float>(Float.random(in: -0.2 ... 0.2), Float.random(in: -0.2 ... 0.2),
+                                                  Float.random(in: -0.2 ... 0.2), 0) * radius
+                        positions.append(SIMD4<Float>(Float(x), Float(y), Float(z), 0) * radius * 2 + jitter)
+                    }
+                }
+            }
+            let count = positions.count
+            let solver = CPUParticleSolver()
+            solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: count))
+            solver.setCollisionMaterial(radii: [Float](repeating: radius, count: count),
+                                        phases: (0 ..< count).map { ObiUtils.MakePhase(group: $0, flags: []) },
+                                        filters: [Int](repeating: ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything,
+                                                                                      category: 0), count: count))
+            solver.setSimplices(points: (0 ..< Int32(count)).map { $0 })
+            solver.step(stepTime: 1 / 60, substeps: 1)
+
+            var detectionTime: Double = 0
+            var contacts = 0
+            for _ in 0 ..< steps {
+                let start = CFAbsoluteTimeGetCurrent()
+                solver.collisionDetection(stepTime: 1 / 60)
+                detectionTime += CFAbsoluteTimeGetCurrent() - start
+                contacts += solver.particleContactCount
+                solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+            }
+            print(String(format: "granular %6d grains, %7d contacts, %d threads: %.2f ms/step, %.2f Mcontacts/s",
+                         count, contacts / steps, threads, detectionTime / Double(steps) * 1000,
+                         Double(contacts) / detectionTime / 1e6))
+        }
+    }
+}
@@ -0,0 +1,177 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import simd
+import vox_flex
+import XCTest
+
+final class RodBenchmarkTests: XCTestCase {
+    let spacing: Float = 0.05
+    let stepTime: Float = 1 / 60
+    let identity = simd_quatf(ix: 0, iy: 0, iz: 0, r: 1)
+
+    /// `cables` cables of `count` particles from the origin downwards at `angle` below the x axis, the first
+    /// particle of each static.
+    func makeCables(count: Int, cables: Int = 1, angle: Float, tipInvMass: Float = 1) -> CPUParticleSolver {
+        var positions: [SIMD4<Float>] = []
+        var invMasses: [Float] = []
+        for c in 0 ..< cables {
+            for i in 0 ..< count {
+                let offset = Float(i) * spacing
+                positions.append(SIMD4<Float>(offset * cos(angle), -offset * sin(angle), Float(c) * 0.1, 0))
+                invMasses.append(i == 0 ? 0 : i == count - 1 ? tipInvMass : 1)
+            }
+        }
+        let solver = CPUParticleSolver()
+        solver.sleepThreshold = 0
+        solver.setParticles(positions: positions, invMasses: invMasses)
+        return solver
+    }
+
+    func cable(_ c: Int, count: Int) -> [Int32] {
+        (0 ..< Int32(count)).map { Int32(c * count) + $0 }
+    }
+
+    /// distance constraints along the cables in two batches, even and odd links.
+    func addDistanceConstraints(_ solver: CPUParticleSolver, count: Int, cables: Int = 1) {
+        for parity in 0 ..< 2 {
+            var pairs: [SIMD2<Int32>] = []
+            for c in 0 ..< cables {
+                let indices = cable(c, count: count)
+                for i in stride(from: parity, to: count - 1, by: 2) {
+                    pairs.append(SIMD2<Int32>(indices[i], indices[i + 1]))
+                }
+            }
+            solver.addDistanceConstraints(pairs: pairs, restLengths: [Float](repeating: spacing, count: pairs.count))
+        }
+    }
+
+    func maxStretch(_ solver: CPUParticleSolver, count: Int, cables: Int = 1) -> Float {
+        let positions = solver.positions()
+        var stretch: Float = 0
+        for c in 0 ..< cables {
+            for i in c * count ..< (c + 1) * count - 1 {
+                stretch = max(stretch, simd_distance(positions[i], positions[i + 1]) / spacing - 1)
+            }
+        }
+        return stretch
+    }
+
+    func simulate(_ solver: CPUParticleSolver, frames: Int, substeps: Int) {
+        for _ in 0 ..< frames * substeps {
+            solver.substep(stepTime: stepTime, substepTime: stepTime / Float(substeps), substeps: substeps)
+        }
+    }
+
+    func testChainHoldsHeavyLoad() throws {
+        // a 5 m cable with a tip 100 times heavier than the rest, one iteration and 4 substeps a frame.
+        let count = 100
+        var stretches: [Float] = []
+        for direct in [true, false] {
+            let solver = makeCables(count: count, angle: .pi / 2, tipInvMass: 0.01)
+            if direct {
+                solver.addChainConstraints(chains: [cable(0, count: count)], minLength: spacing, maxLength: spacing)
+                solver.setConstraintParameters(.Chain, order: .sequential, iterations: 1)
+            } else {
+                addDistanceConstraints(solver, count: count)
+                solver.setConstraintParameters(.Distance, order: .sequential, iterations: 1)
+            }
+            simulate(solver, frames: 120, substeps: 4)
+            stretches.append(maxStretch(solver, count: count))
+        }
+        print(String(format: "heavy load, max stretch: chain %.5f, distance %.3f", stretches[0], stretches[1]))
+        XCTAssertLessThan(stretches[0], 0.005)
+        XCTAssertGreaterThan(stretches[1], 0.5)
+
+        // the direct solve stays bounded at a single substep a frame.
+        let solver = makeCables(count: count, angle: .pi / 2, tipInvMass: 0.01)
+        solver.addChainConstraints(chains: [cable(0, count: count)], minLength: spacing, maxLength: spacing)
+        solver.setConstraintParameters(.Chain, order: .sequential, iterations: 1)
+        simulate(solver, frames: 120, substeps: 1)
+        let stretch = maxStretch(solver, count: count)
+        print(String(format: "heavy load, one substep, max stretch: chain %.5f", stretch))
+        XCTAssertLessThan(stretch, 0.01)
+    }
+
+    func testChainSwingsWithoutStretching() throws {
+        let count = 100
+        var stretches: [Float] = []
+        for direct in [true, false] {
+            let solver = makeCables(count: count, angle: .pi / 4)
+            if direct {
+                solver.addChainConstraints(chains: [cable(0, count: count)], minLength: spacing, maxLength: spacing)
+                solver.setConstraintParameters(.Chain, order: .sequential, iterations: 1)
+            } else {
+                addDistanceConstraints(solver, count: count)
+                solver.setConstraintParameters(.Distance, order: .sequential, iterations: 1)
+            }
+            simulate(solver, frames: 120, substeps: 4)
+            stretches.append(maxStretch(solver, count: count))
+        }
+        print(String(format: "swing, max stretch: chain %.5f, distance %.3f", stretches[0], stretches[1]))
+        XCTAssertLessThan(stretches[0], 0.01)
+        XCTAssertGreaterThan(stretches[1], 0.1)
+    }
+
+    func testCosseratCantileverStaysStraight() throws {
+        // a horizontal rod clamped at its first segment, with and without bend / twist constraints.
+        let count = 20
+        let rest = simd_quatf(angle: .pi / 2, axis: SIMD3<Float>(0, 1, 0)) // material z along the rod, +x.
+        var tips: [SIMD4<Float>] = []
+        for bend in [true, false] {
+            let solver = makeCables(count: count, angle: 0)
+            solver.setOrientations([simd_quatf](repeating: identity, count: count),
+                                   invRotationalMasses: (0 ..< count).map { $0 == 0 ? 0 : 1000 })
+            for parity in 0 ..< 2 {
+                let segments = stride(from: parity, to: count - 1, by: 2).map {
+                    SIMD2<Int32>(Int32($0), Int32($0 + 1))
+                }
+                solver.addStretchShearConstraints(pairs: segments,
+                                                  restLengths: [Float](repeating: spacing, count: segments.count),
+                                                  restOrientations: segments.map { _ in rest })
+                if bend {
+                    // consecutive segments, the last particle's orientation is unused.
+                    let joints = segments.filter { $0.y < Int32(count - 1) }
+                    solver.addBendTwistConstraints(pairs: joints,
+                                                   restDarboux: [simd_quatf](repeating: identity, count: joints.count))
+                }
+            }
+            solver.setConstraintParameters(.StretchShear, order: .sequential, iterations: 10)
+            solver.setConstraintParameters(.BendTwist, order: .sequential, iterations: 10)
+            simulate(solver, frames: 120, substeps: 16)
+            XCTAssertLessThan(maxStretch(solver, count: count), 0.01)
+            tips.append(solver.positions()[count - 1])
+        }
+        print(String(format: "cantilever tip: rigid (%.3f, %.3f), hinged (%.3f, %.3f)",
+                     tips[0].x, tips[0].y, tips[1].x, tips[1].y))
+        XCTAssertGreaterThan(tips[0].y, -0.15)
+        XCTAssertLessThan(tips[1].y, -0.2)
+    }
+
+    func testCableThroughput() throws {
+        // 1000 cables of 100 particles released at 45 degrees.
+        let count = 100
+        let cables = 1000
+        let frames = 60
+        for direct in [true, false] {
+            let solver = makeCables(count: count, cables: cables, angle: .pi / 4)
+            if direct {
+                solver.addChainConstraints(chains: (0 ..< cables).map { cable($0, count: count) },
+                                           minLength: spacing, maxLength: spacing)
+                solver.setConstraintParameters(.Chain, order: .parallel, iterations: 1)
+            } else {
+                addDistanceConstraints(solver, count: count, cables: cables)
+                solver.setConstraintParameters(.Distance, order: .sequential, iterations: 1)
+            }
+            let start = CFAbsoluteTimeGetCurrent()
+            simulate(solver, frames: frames, substeps: 4)
+            let time = (CFAbsoluteTimeGetCurrent() - start) / Double(frames)
+            print(String(format: "%@: %d cables x %d particles, %d threads: %.2f ms/frame, max stretch %.4f",
+                         direct ? "chain" : "distance", cables, count, CPUParticleSolver.threadCount, time * 1000,
+                         maxStretch(solver, count: count, cables: cables)))
+        }
+    }
+}
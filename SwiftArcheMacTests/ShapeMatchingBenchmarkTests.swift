@@ -0,0 +1,117 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+import simd
+import vox_flex
+import XCTest
+
+final class ShapeMatchingBenchmarkTests: XCTestCase {
+    let spacing: Float = 0.05
+
+    /// a block of particles on a regular grid, x fastest.
+    func blockPositions(_ size: SIMD3<Int>) -> [SIMD4<Float>] {
+        (0 ..< size.x * size.y * size.z).map { i in
+            SIMD4<Float>(Float(i % size.x), Float(i / size.x % size.y), Float(i / (size.x * size.y)), 0) * spacing
+        }
+    }
+
+    /// 3 x 3 x 3 clusters centered every other particle, neighbors overlapping by one layer.
+    func blockClusters(_ size: SIMD3<Int>) -> [[Int32]] {
+        var clusters: [[Int32]] = []
+        for z in stride(from: 0, to: size.z, by: 2) {
+            for y in stride(from: 0, to: size.y, by: 2) {
+                for x in stride(from: 0, to: size.x, by: 2) {
+                    var cluster: [Int32] = []
+                    for dz in -1 ... 1 {
+                        for dy in -1 ... 1 {
+                            for dx in -1 ... 1 {
+                                let p = SIMD3<Int>(x + dx, y + dy, z + dz)
+                                if all(p .>= SIMD3<Int>(repeating: 0)), all(p .< size) {
+                                    cluster.append(Int32((p.z * size.y + p.y) * size.x + p.x))
+                                }
+                            }
+                        }
+                    }
+                    clusters.append(cluster)
+                }
+            }
+        }
+        return clusters
+    }
+
+    func makeSoftbody(_ size: SIMD3<Int>, iterations: Int, plasticCreep: Float = 0) -> CPUParticleSolver {
+        let positions = blockPositions(size)
+        let solver = CPUParticleSolver()
+        solver.gravity = .zero
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: positions.count))
+        solver.setConstraintParameters(.ShapeMatching, order: .parallel, iterations: iterations)
+        solver.addShapeMatchingConstraints(clusters: blockClusters(size), plasticYield: 0.01,
+                                           plasticCreep: plasticCreep, maxDeformation: 1)
+        return solver
+    }
+
+    func testRotatedBodyKeepsItsShape() throws {
+        let size = SIMD3<Int>(8, 8, 8)
+        let solver = makeSoftbody(size, iterations: 4)
+        let rest = blockPositions(size)
+        let rotation = simd_quatf(angle: 1, axis: simd_normalize(SIMD3<Float>(1, 2, 3)))
+        solver.setPositions(rest.map { SIMD4<Float>(rotation.act($0.xyz) + SIMD3<Float>(1, 2, 3), 0) })
+        for _ in 0 ..< 10 {
+            solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+        }
+
+        // the corrections set the body spinning, but every cluster agrees on its rotation and the body is as it
+        // was apart from a rigid motion.
+        let orientations = solver.shapeMatchingState(batch: 0).orientations
+        for orientation in orientations {
+            XCTAssertGreaterThan(abs(simd_dot(orientation.vector, orientations[0].vector)), 0.999)
+        }
+        let positions = solver.positions()
+        for (a, b) in [(0, rest.count - 1), (7, 56), (100, 300)] {
+            XCTAssertEqual(simd_distance(positions[a], positions[b]), simd_distance(rest[a], rest[b]), accuracy: 1e-3)
+        }
+    }
+
+    func testPlasticDeformationKeepsVolume() throws {
+        let size = SIMD3<Int>(8, 8, 8)
+        let solver = makeSoftbody(size, iterations: 1, plasticCreep: 0.5)
+        // stretched along x, volume preserving.
+        let squeeze = 1 / Float(1.3).squareRoot()
+        let stretch = SIMD4<Float>(1.3, squeeze, squeeze, 0)
+        solver.setPositions(blockPositions(size).map { $0 * stretch })
+        for _ in 0 ..< 5 {
+            solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+        }
+
+        for deformation in solver.shapeMatchingState(batch: 0).plasticDeformations {
+            let rest = simd_float3x3(deformation.columns.0.xyz, deformation.columns.1.xyz, deformation.columns.2.xyz)
+            XCTAssertEqual(rest.determinant, 1, accuracy: 1e-3)
+            XCTAssertGreaterThan(rest.columns.0.x, 1.05)
+        }
+    }
+
+    func testSoftbodyThroughput() throws {
+        // 40 x 32 x 40 = 51200 particles in 6400 overlapping clusters of up to 27 particles.
+        let size = SIMD3<Int>(40, 32, 40)
+        let iterations = 10
+        let substeps = 20
+        let solver = makeSoftbody(size, iterations: iterations)
+        let clusterCount = solver.constraintCount(.ShapeMatching)
+        solver.gravity = SIMD3<Float>(0, -9.81, 0)
+        solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+
+        let start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< substeps {
+            solver.substep(stepTime: 1 / 60, substepTime: 1 / 60, substeps: 1)
+        }
+        let elapsed = CFAbsoluteTimeGetCurrent() - start
+        let rate = Double(clusterCount * iterations * substeps) / elapsed
+        print(String(format: "shape matching, %d particles, %d clusters x %d iterations, %d threads: %.2f ms/substep, %.2f M clusters/s",
+                     solver.particleCount, clusterCount, iterations, CPUParticleSolver.threadCount,
+                     elapsed / Double(substeps) * 1000, rate / 1e6))
+    }
+}
@@ -0,0 +1,97 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import vox_render
+import XCTest
+
+final class SortBenchmarkTests: XCTestCase {
+    // hash keys of a 128^3 grid, like HashGrid.build sorts every frame.
+    let keyBits = CPURadixSort.keyBits(for: 128 * 128 * 128)
+    let sorter = CPURadixSort()
+
+    func makeKeys(_ count: Int) -> ([UInt32], [UInt32]) {
+        let mask = (UInt32(1) << keyBits) - 1
+        return ((0 ..< count).map { _ in UInt32.random(in: 0 ... mask) }, (0 ..< count).map { UInt32($0) })
+    }
+
+    func testRadixSortIsStable() throws {
+        var (keys, values) = makeKeys(100_000)
+        let expected = zip(keys, values).sorted { $0.0 < $1.0 || ($0.0 == $1.0 && $0.1 < $1.1) }
+        sorter.sort(keys: &keys, values: &values, keyBits: keyBits)
+        XCTAssertEqual(keys, expected.map { $0.0 })
+        XCTAssertEqual(values, expected.map { $0.1 })
+    }
+
+    func testRadixSortScaling() throws {
+        for count in [65536, 262_144, 1_048_576, 4_194_304] {
+            let (keys, values) = makeKeys(count)
+            var sortedKeys = keys, sortedValues = values
+            let start = CFAbsoluteTimeGetCurrent()
+            sorter.sort(keys: &sortedKeys, values: &sortedValues, keyBits: keyBits)
+            let elapsed = CFAbsoluteTimeGetCurrent() - start
+            print("radix sort \(count) keys: \(elapsed * 1000) ms, \(Double(count) / elapsed / 1e6) Mkeys/s")
+        }
+    }
+
+    func testRadixSortPerformance() throws {
+        let (keys, values) = makeKeys(1_048_576)
+        measure {
+            var sortedKeys = keys, sortedValues = values
+            sorter.sort(keys: &sortedKeys, values: &sortedValues, keyBits: keyBits)
+        }
+    }
+}
+
+final class GPUSortBenchmarkTests: XCTestCase {
+    var canvas: Canvas!
+    var engine: Engine!
+    let keyBits = CPURadixSort.keyBits(for: 128 * 128 * 128)
+
+    override func setUpWithError() throws {
+        canvas = Canvas(frame: CGRect())
+        engine = Engine(canvas: canvas)
+    }
+
+    override func tearDownWithError() throws {
+        Engine.destroy()
+    }
+
+    /// sorts the pairs of `sortBuffer` in place and returns the GPU time of the sort.
+    func sort(_ sorter: RadixSort, _ sortBuffer: BufferView, count: Int) -> Double {
+        let itemCount = BufferView(array: [UInt32(count)])
+        let commandBuffer = Engine.commandQueue.makeCommandBuffer()!
+        let commandEncoder = commandBuffer.makeComputeCommandEncoder()!
+        sorter.run(commandEncoder: commandEncoder, maxSize: UInt(count), keyBits: keyBits, sortBuffer: sortBuffer,
+                   itemCount: itemCount)
+        commandEncoder.endEncoding()
+        commandBuffer.commit()
+        commandBuffer.waitUntilCompleted()
+        return commandBuffer.gpuEndTime - commandBuffer.gpuStartTime
+    }
+
+    // the (key, index) pairs HashGrid.build sorts, on the GPU.
+    func testRadixSortScaling() throws {
+        let sorter = RadixSort()
+        let mask = (UInt32(1) << keyBits) - 1
+        for count in [65536, 262_144, 1_048_576, 4_194_304] {
+            let pairs = (0 ..< count).map { SIMD2<UInt32>(UInt32.random(in: 0 ... mask), UInt32($0)) }
+            let sortBuffer = BufferView(array: pairs)
+            // the first run allocates the scratch buffers and warms the pipelines up.
+            _ = sort(sorter, sortBuffer, count: count)
+            sortBuffer.assign(with: pairs)
+            let elapsed = sort(sorter, sortBuffer, count: count)
+
+            let sorted = UnsafeBufferPointer(start: sortBuffer.buffer.contents().bindMemory(to: SIMD2<UInt32>.self,
+                                                                                           capacity: count),
+                                             count: count)
+            XCTAssertTrue(zip(sorted.dropLast(), sorted.dropFirst()).allSatisfy {
+                $0.x < $1.x || ($0.x == $1.x && $0.y < $1.y)
+            })
+            print("GPU radix sort \(count) keys: \(elapsed * 1000) ms, \(Double(count) / elapsed / 1e6) Mkeys/s")
+        }
+    }
+}
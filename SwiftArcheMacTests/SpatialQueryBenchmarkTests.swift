@@ -0,0 +1,160 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import simd
+import vox_flex
+import XCTest
+
+final class SpatialQueryBenchmarkTests: XCTestCase {
+    let identity = simd_quatf(ix: 0, iy: 0, iz: 0, r: 1)
+
+    /// `count` fluid-sized particles spread over a cube, a thousand per cubic meter.
+    func makeFluid(count: Int, radius: Float) -> (solver: CPUParticleSolver, side: Float) {
+        let side = cbrt(Float(count) / 1000)
+        let positions = (0 ..< count).map { _ in
+            SIMD4<Float>(Float.random(in: 0 ... side), Float.random(in: 0 ... side), Float.random(in: 0 ... side), 0)
+        }
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: count))
+        solver.setCollisionMaterial(radii: [Float](repeating: radius, count: count),
+                                    phases: (0 ..< count).map { ObiUtils.MakePhase(group: $0, flags: []) },
+                                    filters: [Int](repeating: Int(CPUParticleSolver.defaultFilter), count: count))
+        solver.setSimplices(points: (0 ..< Int32(count)).map { $0 })
+        solver.collisionDetection(stepTime: 1 / 60)
+        return (solver, side)
+    }
+
+    func testQueriesMatchBruteForce() throws {
+        let radius: Float = 0.05
+        let (solver, side) = makeFluid(count: 4000, radius: radius)
+        // solver space is moved and turned in the world, queries are given in world space.
+        let frameTranslation = SIMD3<Float>(3, -1, 2)
+        let frameRotation = simd_quatf(angle: 0.7, axis: simd_normalize(SIMD3<Float>(1, 1, 0)))
+        solver.setFrame(translation: frameTranslation, rotation: frameRotation)
+        let toWorld = { (p: SIMD3<Float>) in frameTranslation + frameRotation.act(p) }
+
+        var shapes: [CQueryShape] = []
+        var transforms: [CAffineTransform] = []
+        for i in 0 ..< 192 {
+            let center = SIMD3<Float>(Float.random(in: 0 ... side), Float.random(in: 0 ... side),
+                                      Float.random(in: 0 ... side))
+            let rotation = simd_quatf(angle: Float.random(in: 0 ... 3), axis: simd_normalize(SIMD3<Float>(1, 2, 3)))
+            var shape = CQueryShape(center: .zero, size: .zero, type: .sphere, contactOffset: 0.01,
+                                    maxDistance: i % 2 == 0 ? 0 : 0.05, filter: CPUParticleSolver.defaultFilter)
+            switch i % 3 {
+            case 0:
+                shape.size = SIMD4<Float>(repeating: Float.random(in: 0.05 ... 0.3))
+            case 1:
+                shape.type = .box
+                shape.size = SIMD4<Float>(Float.random(in: 0.1 ... 0.6), Float.random(in: 0.1 ... 0.6), 0.2, 0)
+            default:
+                shape.type = .ray
+                shape.size = SIMD4<Float>(Float.random(in: -1 ... 1), Float.random(in: -1 ... 1), 1, 0)
+            }
+            shapes.append(shape)
+            transforms.append(CAffineTransform(translation: SIMD4<Float>(toWorld(center), 0), scale: .one,
+                                               rotation: frameRotation * rotation))
+        }
+        var results: [CQueryResult] = []
+        let found = solver.spatialQuery(shapes: shapes, transforms: transforms, results: &results)
+        XCTAssertGreaterThan(found, 0)
+
+        // signed distance of every particle to every shape, in solver space.
+        let positions = solver.positions()
+        var expected: [SIMD2<Int32>: Float] = [:]
+        for (q, shape) in shapes.enumerated() {
+            let rotation = frameRotation.inverse * transforms[q].rotation
+            let center = frameRotation.inverse.act(SIMD3<Float>(transforms[q].translation.x,
+                                                                transforms[q].translation.y,
+                                                                transforms[q].translation.z) - frameTranslation)
+            for (p, position) in positions.enumerated() {
+                let x = SIMD3<Float>(position.x, position.y, position.z)
+                var distance: Float
+                switch shape.type {
+                case .sphere:
+                    distance = simd_length(x - center) - shape.size.x
+                case .box:
+                    let halfSize = SIMD3<Float>(shape.size.x, shape.size.y, shape.size.z) * 0.5
+                    let local = simd_abs(rotation.inverse.act(x - center)) - halfSize
+                    distance = simd_length(simd_max(local, .zero)) + min(local.max(), 0)
+                default:
+                    let end = center + rotation.act(SIMD3<Float>(shape.size.x, shape.size.y, shape.size.z))
+                    let mu = simd_clamp(simd_dot(x - center, end - center) / simd_length_squared(end - center), 0, 1)
+                    distance = simd_length(x - (center + (end - center) * mu))
+                }
+                distance -= shape.contactOffset + radius
+                if distance <= shape.maxDistance {
+                    expected[SIMD2<Int32>(Int32(q), Int32(p))] = distance
+                }
+            }
+        }
+        XCTAssertEqual(found, expected.count)
+        for result in results[0 ..< found] {
+            let distance = expected[SIMD2<Int32>(result.queryIndex, result.simplexIndex)]
+            XCTAssertNotNil(distance)
+            XCTAssertEqual(result.distance, distance ?? .infinity, accuracy: 1e-3)
+        }
+
+        // a preallocated buffer too small for every result gets the first ones.
+        var small = [CQueryResult](repeating: CQueryResult(), count: 8)
+        XCTAssertEqual(solver.spatialQuery(shapes: shapes, transforms: transforms, results: &small), found)
+        XCTAssertEqual(small.count, found)
+    }
+
+    func testPickingAndOverlaps() throws {
+        let solver = CPUParticleSolver()
+        let positions: [SIMD4<Float>] = [[0, 0, 0, 0], [0, 0, 1, 0], [0, 0, 2, 0], [0.5, 0, 1, 0]]
+        solver.setParticles(positions: positions, invMasses: [1, 1, 1, 1])
+        solver.setCollisionMaterial(radii: [0.1, 0.1, 0.1, 0.1],
+                                    phases: (0 ..< 4).map { ObiUtils.MakePhase(group: $0, flags: []) },
+                                    filters: [Int](repeating: Int(CPUParticleSolver.defaultFilter), count: 4))
+        solver.setSimplices(points: [0, 1, 2, 3])
+        solver.collisionDetection(stepTime: 1 / 60)
+
+        // picking from behind the last particle hits it first.
+        let hit = solver.raycast(origin: [0, 0, 3], direction: [0, 0, -1], length: 10)
+        XCTAssertEqual(hit?.simplex, 2)
+        XCTAssertEqual(hit?.distance ?? 0, 1, accuracy: 1e-3)
+        XCTAssertNil(solver.raycast(origin: [0, 1, 3], direction: [0, 0, -1], length: 10))
+        let thick = solver.raycast(origin: [0, 1, 1], direction: [0, -1, 0], length: 10, thickness: 0.05)
+        XCTAssertEqual(thick?.simplex, 1)
+
+        XCTAssertEqual(Set(solver.overlapSphere(center: [0.25, 0, 1], radius: 0.2)), [1, 3])
+        XCTAssertEqual(solver.overlapSphere(center: [0, 0, 0.5], radius: 0.3), [])
+        // categories outside the particles' mask see nothing.
+        let other = Int32(truncatingIfNeeded: ObiUtils.MakeFilter(mask: 0, category: 1))
+        XCTAssertEqual(solver.overlapSphere(center: [0, 0, 0], radius: 5, filter: other), [])
+    }
+
+    func testQueryThroughput() throws {
+        // picking rays across the whole fluid and explosion overlaps, against 200k fluid particles.
+        let (solver, side) = makeFluid(count: 200_000, radius: 0.05)
+        var shapes: [CQueryShape] = []
+        for i in 0 ..< 4096 {
+            let origin = SIMD4<Float>(Float.random(in: 0 ... side), Float.random(in: 0 ... side), 0, 0)
+            if i % 2 == 0 {
+                shapes.append(CQueryShape(center: origin, size: origin + SIMD4<Float>(0, 0, side, 0), type: .ray,
+                                          contactOffset: 0, maxDistance: 0, filter: CPUParticleSolver.defaultFilter))
+            } else {
+                shapes.append(CQueryShape(center: origin + SIMD4<Float>(0, 0, side / 2, 0),
+                                          size: SIMD4<Float>(repeating: 0.3), type: .sphere, contactOffset: 0,
+                                          maxDistance: 0, filter: CPUParticleSolver.defaultFilter))
+            }
+        }
+        var results: [CQueryResult] = []
+        solver.spatialQuery(shapes: shapes, results: &results)
+        let repeats = 5
+        var found = 0
+        let start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< repeats {
+            found = solver.spatialQuery(shapes: shapes, results: &results)
+        }
+        let time = (CFAbsoluteTimeGetCurrent() - start) / Double(repeats)
+        print(String(format: "spatial queries, %d queries, %d results, %d threads: %.2f ms, %.0f k queries/s",
+                     shapes.count, found, CPUParticleSolver.threadCount, time * 1000,
+                     Double(shapes.count) / max(time, 1e-9) / 1000))
+    }
+}
@@ -0,0 +1,43 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class SphBenchmarkTests: XCTestCase {
+    // water column in the corner of a 1 x 1 x 0.3 tank.
+    func makeDamBreak(_ method: CPUSphSolver.Method, spacing: Float) -> CPUSphSolver {
+        let solver = CPUSphSolver(method)
+        solver.targetSpacing = spacing
+        solver.setDomain(lower: .zero, upper: SIMD3<Float>(1, 1, 0.3))
+        solver.addBlock(lower: SIMD3<Float>(repeating: spacing * 0.5), upper: SIMD3<Float>(0.3, 0.5, 0.3 - spacing * 0.5))
+        return solver
+    }
+
+    func damBreak(_ method: CPUSphSolver.Method, spacing: Float, frames: Int) {
+        let solver = makeDamBreak(method, spacing: spacing)
+        let start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< frames {
+            solver.advance(1.0 / 60.0)
+        }
+        let elapsed = CFAbsoluteTimeGetCurrent() - start
+
+        let positions = solver.positions
+        XCTAssertFalse(positions.contains { $0.x.isNaN })
+        XCTAssertGreaterThan(positions.map(\.x).max()!, 0.3, "the column should collapse")
+        print("\(method) dam break: \(solver.particleCount) particles, \(solver.stepCount) steps, "
+            + "\(solver.neighborListBuildCount) neighbor list builds, "
+            + "\(Double(solver.particleCount * solver.stepCount) / elapsed) particles*steps/s")
+    }
+
+    func testWCSphDamBreak() throws {
+        damBreak(.wcsph, spacing: 0.02, frames: 20)
+    }
+
+    func testPCISphDamBreak() throws {
+        damBreak(.pcisph, spacing: 0.02, frames: 20)
+    }
+}
@@ -0,0 +1,145 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import vox_flex
+import XCTest
+
+final class TetherSkinBenchmarkTests: XCTestCase {
+    let spacing: Float = 0.05
+    let width = 30
+    let height = 40
+
+    // a width x height cape lying in the xz plane, pinned along its first row, with structural distance
+    // constraints colored into batches and optionally tethered to the pinned row.
+    func makeCape(iterations: Int, tethered: Bool) -> CPUParticleSolver {
+        var positions: [SIMD4<Float>] = []
+        var invMasses: [Float] = []
+        var pairs: [SIMD2<Int32>] = []
+        for z in 0 ..< height {
+            for x in 0 ..< width {
+                let i = Int32(z * width + x)
+                positions.append(SIMD4<Float>(Float(x) * spacing, 0, Float(z) * spacing, 0))
+                invMasses.append(z == 0 ? 0 : 1)
+                if x + 1 < width {
+                    pairs.append(SIMD2<Int32>(i, i + 1))
+                }
+                if z + 1 < height {
+                    pairs.append(SIMD2<Int32>(i, i + Int32(width)))
+                }
+            }
+        }
+
+        let solver = CPUParticleSolver()
+        solver.sleepThreshold = 0
+        solver.setParticles(positions: positions, invMasses: invMasses)
+        solver.setConstraintParameters(.Distance, order: .sequential, iterations: iterations)
+        let (sortedIndices, batches) = CPUConstraintBatcher().batch(pairs: pairs, particleCount: positions.count,
+                                                                     constraintStride: 16)
+        for batch in batches {
+            let batchPairs = sortedIndices[batch.startIndex ..< batch.startIndex + batch.constraintCount].map {
+                pairs[Int($0)]
+            }
+            solver.addDistanceConstraints(pairs: batchPairs, restLengths: [Float](repeating: spacing,
+                                                                                   count: batchPairs.count))
+        }
+        if tethered {
+            XCTAssertEqual(solver.addTetherConstraints(edges: pairs).count, 1)
+            XCTAssertEqual(solver.constraintCount(.Tether), width * (height - 1))
+            solver.setConstraintParameters(.Tether, order: .sequential, iterations: 1)
+        }
+        return solver
+    }
+
+    /// largest distance from the pinned row to the free edge over the rest length, minus one, after the cape has
+    /// fallen and while it swings.
+    func hangStretch(_ solver: CPUParticleSolver, steps: Int) -> Float {
+        var worst: Float = -1
+        for step in 0 ..< steps {
+            solver.step(stepTime: 1 / 60, substeps: 1)
+            if step >= 60 {
+                let positions = solver.positions()
+                for x in 0 ..< width {
+                    let d = positions[(height - 1) * width + x] - positions[x]
+                    worst = max(worst, (d * d).sum().squareRoot() / (spacing * Float(height - 1)) - 1)
+                }
+            }
+        }
+        return worst
+    }
+
+    func testGeodesicAnchors() throws {
+        // a U-shaped strip: the free end is 1 from the fixed one in a straight line but 3 along the edges.
+        let positions: [SIMD4<Float>] = [SIMD4(0, 0, 0, 0), SIMD4(1, 0, 0, 0), SIMD4(1, 1, 0, 0), SIMD4(0, 1, 0, 0),
+                                         SIMD4(5, 0, 0, 0), SIMD4(6, 0, 0, 0)]
+        let invMasses: [Float] = [0, 1, 1, 1, 0, 1]
+        let edges: [Int32] = [0, 1, 1, 2, 2, 3, 4, 5]
+        let anchors = CTetherAnchors()
+        XCTAssertEqual(anchors.build(withPositions: positions, invMasses: invMasses, particleCount: 6, edges: edges,
+                                     edgeCount: 4), 4)
+        XCTAssertEqual(anchors.islandCount, 2)
+        var tethers = [Int32](repeating: 0, count: 8)
+        var distances = [Float](repeating: 0, count: 4)
+        var offsets = [Int32](repeating: 0, count: 3)
+        anchors.getTethers(&tethers, distances: &distances)
+        anchors.getIslandOffsets(&offsets)
+        XCTAssertEqual(offsets, [0, 3, 4])
+        XCTAssertEqual(tethers, [1, 0, 2, 0, 3, 0, 5, 4])
+        XCTAssertEqual(distances, [1, 2, 3, 1])
+    }
+
+    func testCapeIterations() throws {
+        // fewest distance iterations keeping the swinging cape within 5% of its length.
+        let tolerance: Float = 0.05
+        var needed: [Bool: Int] = [:]
+        for tethered in [false, true] {
+            for iterations in [1, 2, 4, 8, 16, 32, 64, 128] {
+                let stretch = hangStretch(makeCape(iterations: iterations, tethered: tethered), steps: 180)
+                print(String(format: "cape %dx%d, %@, %3d iterations: stretch %.2f%%", width, height,
+                             tethered ? "tethered" : "untethered", iterations, stretch * 100))
+                if stretch < tolerance {
+                    needed[tethered] = iterations
+                    break
+                }
+            }
+        }
+        print("stable cape: \(needed[false] ?? -1) iterations untethered, \(needed[true] ?? -1) tethered")
+        XCTAssertEqual(needed[true], 1)
+        XCTAssertGreaterThan(needed[false] ?? .max, 16)
+    }
+
+    func testSkinFollowsSkinnedVertices() throws {
+        // the rows next to the pinned one are skinned to a buffer sliding upwards, read without copying it.
+        let solver = makeCape(iterations: 8, tethered: false)
+        let rest = solver.positions()
+        let skinned = Array(Int32(width) ..< Int32(width * 4))
+        let radius: Float = 0.02
+        let batch = solver.addSkinConstraints(particles: skinned, skinPoints: skinned.map { rest[Int($0)] },
+                                              skinNormals: skinned.map { _ in SIMD4<Float>(0, 1, 0, 0) },
+                                              radius: radius, backstopRadius: 1, backstop: 0)
+        solver.setConstraintParameters(.Skin, order: .sequential, iterations: 1)
+
+        var points = skinned.map { rest[Int($0)] }
+        let normals = [SIMD4<Float>](repeating: SIMD4<Float>(0, 1, 0, 0), count: skinned.count)
+        points.withUnsafeMutableBufferPointer { points in
+            normals.withUnsafeBufferPointer { normals in
+                solver.bindSkinnedVertices(batch: batch, positions: UnsafePointer(points.baseAddress),
+                                           normals: normals.baseAddress)
+                for step in 0 ..< 60 {
+                    for i in 0 ..< points.count {
+                        points[i].y = Float(step) * 0.002
+                    }
+                    solver.step(stepTime: 1 / 60, substeps: 1)
+                }
+                let positions = solver.positions()
+                for (i, particle) in skinned.enumerated() {
+                    let d = positions[Int(particle)] - points[i]
+                    XCTAssertLessThanOrEqual((d * d).sum().squareRoot(), radius + 1e-4)
+                }
+                solver.bindSkinnedVertices(batch: batch, positions: nil, normals: nil)
+            }
+        }
+    }
+}
@@ -0,0 +1,193 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+import vox_flex
+import vox_render
+import XCTest
+
+final class TriangleMeshBenchmarkTests: XCTestCase {
+    let particleRadius: Float = 0.02
+    let contactOffset: Float = 0.01
+    let stepTime: Float = 1 / 60
+
+    func makeSolver(positions: [SIMD4<Float>]) -> CPUParticleSolver {
+        let count = positions.count
+        let solver = CPUParticleSolver()
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: count))
+        solver.setCollisionMaterial(radii: [Float](repeating: particleRadius, count: count),
+                                    phases: (0 ..< count).map { ObiUtils.MakePhase(group: $0, flags: []) },
+                                    filters: [Int](repeating: ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything,
+                                                                                  category: 0), count: count))
+        solver.setSimplices(points: (0 ..< Int32(count)).map { $0 })
+        return solver
+    }
+
+    /// grid of `resolution` x `resolution` vertices over [0, side] x [0, side], two upward triangles per cell.
+    func gridMesh(resolution: Int, side: Float,
+                  height: (Int, Int) -> Float) -> (vertices: [SIMD3<Float>], indices: [Int32])
+    {
+        let cell = side / Float(resolution - 1)
+        var vertices: [SIMD3<Float>] = []
+        var indices: [Int32] = []
+        for v in 0 ..< resolution {
+            for u in 0 ..< resolution {
+                vertices.append(SIMD3<Float>(Float(u) * cell, height(u, v), Float(v) * cell))
+            }
+        }
+        for v in 0 ..< resolution - 1 {
+            for u in 0 ..< resolution - 1 {
+                let a = Int32(v * resolution + u), b = a + 1, c = a + Int32(resolution), d = c + 1
+                indices += [a, c, b, d, b, c]
+            }
+        }
+        return (vertices, indices)
+    }
+
+    /// one collider per translation, all instancing mesh `index` of the world.
+    func setMeshColliders(_ world: CPUColliderWorld, index: Int, translations: [SIMD3<Float>], extent: SIMD3<Float>) {
+        let shapes = translations.map { _ in
+            ColliderShape(size: Vector4(), type: .TriangleMesh, contactOffset: contactOffset, dataIndex: index)
+        }
+        let bounds = translations.map {
+            Aabb(min: Vector4($0.x, $0.y - contactOffset, $0.z, 0),
+                 max: Vector4($0.x + extent.x, $0.y + extent.y + contactOffset, $0.z + extent.z, 0))
+        }
+        let transforms = translations.map {
+            AffineTransform(translation: Vector4($0.x, $0.y, $0.z, 0), rotation: Quaternion(),
+                            scale: Vector4(1, 1, 1, 1))
+        }
+        world.SetColliders(shapes: shapes, bounds: bounds, transforms: transforms, count: translations.count)
+        world.UpdateWorld(deltaTime: stepTime)
+    }
+
+    func testInstancesShareOneTree() throws {
+        let world = CPUColliderWorld()
+        let mesh = gridMesh(resolution: 9, side: 2) { _, _ in 0 }
+        let first = world.AcquireTriangleMesh(vertices: mesh.vertices, indices: mesh.indices)
+        let second = world.AcquireTriangleMesh(vertices: mesh.vertices, indices: mesh.indices)
+        XCTAssertEqual(first, second)
+        XCTAssertEqual(world.TriangleMeshReferenceCount(index: first), 2)
+        XCTAssertGreaterThan(world.TriangleMeshNodeCount(index: first), 0)
+
+        // a different mesh gets its own index, reused once the first mesh is gone.
+        let raised = gridMesh(resolution: 9, side: 2) { _, _ in 1 }
+        let other = world.AcquireTriangleMesh(vertices: raised.vertices, indices: raised.indices)
+        XCTAssertNotEqual(other, first)
+        XCTAssertFalse(world.ReleaseTriangleMesh(index: first))
+        XCTAssertTrue(world.ReleaseTriangleMesh(index: first))
+        XCTAssertEqual(world.TriangleMeshNodeCount(index: first), 0)
+        XCTAssertEqual(world.AcquireTriangleMesh(vertices: mesh.vertices, indices: mesh.indices, key: 42), first)
+
+        // the Obi container stores a mesh once however many colliders use it.
+        let container = ObiTriangleMeshContainer()
+        let model = ModelMesh()
+        let vertices = mesh.vertices.map { Vector3($0.x, $0.y, $0.z) }
+        let indices = mesh.indices.map { Int($0) }
+        let handle = container.GetOrCreateTriangleMesh(mesh: model, vertices: vertices, indices: indices)
+        XCTAssertTrue(container.GetOrCreateTriangleMesh(mesh: model, vertices: vertices, indices: indices) === handle)
+        XCTAssertEqual(container.headers.count, 1)
+        XCTAssertEqual(container.triangles.count, mesh.indices.count / 3)
+        container.DestroyTriangleMesh(handle: handle)
+        XCTAssertEqual(container.headers.count, 1)
+        container.DestroyTriangleMesh(handle: handle)
+        XCTAssertTrue(container.headers.isEmpty)
+        XCTAssertTrue(container.vertices.isEmpty)
+        XCTAssertFalse(handle.isValid)
+    }
+
+    func testContactsOnSharedMesh() throws {
+        let world = CPUColliderWorld()
+        let mesh = gridMesh(resolution: 9, side: 2) { _, _ in 0 }
+        let index = world.AcquireTriangleMesh(vertices: mesh.vertices, indices: mesh.indices)
+        // two instances side by side, particles resting on both.
+        setMeshColliders(world, index: index, translations: [SIMD3<Float>(0, 0, 0), SIMD3<Float>(3, 1, 0)],
+                         extent: SIMD3<Float>(2, 0, 2))
+        var positions: [SIMD4<Float>] = []
+        for i in 0 ..< 100 {
+            let x = (Float(i % 10) + 0.5) * 0.2, z = (Float(i / 10) + 0.5) * 0.2
+            positions.append(SIMD4<Float>(x, particleRadius, z, 0))
+            positions.append(SIMD4<Float>(x + 3, 1 + particleRadius, z, 0))
+        }
+        let solver = makeSolver(positions: positions)
+        solver.colliderWorld = world
+        solver.collisionDetection(stepTime: stepTime)
+
+        let contacts = solver.colliderContacts()
+        XCTAssertEqual(solver.colliderContactCounts()[.TriangleMesh], contacts.count)
+        XCTAssertEqual(Set(contacts.map { $0.bodyA }).count, positions.count)
+        for contact in contacts {
+            XCTAssertEqual(contact.pointB.y, contact.bodyB == 0 ? 0 : 1, accuracy: 1e-4)
+            XCTAssertEqual(contact.normal.y, 1, accuracy: 1e-4)
+            XCTAssertEqual(contact.distance, 0, accuracy: 1e-4)
+        }
+    }
+
+    func testBuildAndQueryThroughput() throws {
+        // the terrain of HeightFieldBenchmarkTests as a mesh: 512 x 512 cells, 524288 triangles.
+        let resolution = 513
+        let side: Float = 100
+        let height: Float = 10
+        let heightAt = { (u: Int, v: Int) -> Float in 0.5 + 0.4 * sin(Float(u) * 0.05) * cos(Float(v) * 0.04) }
+        let mesh = gridMesh(resolution: resolution, side: side) { heightAt($0, $1) * height }
+        let triangleCount = mesh.indices.count / 3
+
+        let world = CPUColliderWorld()
+        var start = CFAbsoluteTimeGetCurrent()
+        let index = world.AcquireTriangleMesh(vertices: mesh.vertices, indices: mesh.indices, key: 1)
+        let buildTime = CFAbsoluteTimeGetCurrent() - start
+        // further instances only take a reference.
+        start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< 100 {
+            world.AcquireTriangleMesh(vertices: mesh.vertices, indices: mesh.indices, key: 1)
+        }
+        let instanceTime = (CFAbsoluteTimeGetCurrent() - start) / 100
+        print(String(format: "BIH build: %d triangles, %d nodes, %.1f ms, %.1f M triangles/s, instance %.4f ms",
+                     triangleCount, world.TriangleMeshNodeCount(index: index), buildTime * 1000,
+                     Double(triangleCount) / max(buildTime, 1e-9) / 1e6, instanceTime * 1000))
+
+        // 100k particles just over the surface, against the mesh and the same terrain as a heightfield.
+        let scale = Float(resolution - 1) / side
+        let positions = (0 ..< 100_000).map { _ -> SIMD4<Float> in
+            let x = Float.random(in: 0 ..< side), z = Float.random(in: 0 ..< side)
+            let surface = (0.5 + 0.4 * sin(x * scale * 0.05) * cos(z * scale * 0.04)) * height
+            return SIMD4<Float>(x, surface + Float.random(in: -0.02 ... 0.1), z, 0)
+        }
+        let solver = makeSolver(positions: positions)
+        let steps = 10
+        start = CFAbsoluteTimeGetCurrent()
+        for _ in 0 ..< steps {
+            solver.collisionDetection(stepTime: stepTime)
+        }
+        let baseline = (CFAbsoluteTimeGetCurrent() - start) / Double(steps)
+
+        let heightField = CPUColliderWorld()
+        heightField.SetHeightField(index: 0, resolutionU: resolution, resolutionV: resolution,
+                                   samples: (0 ..< resolution * resolution).map { heightAt($0 % resolution,
+                                                                                           $0 / resolution) })
+        heightField.SetColliders(shapes: [ColliderShape(size: Vector4(side, height, side, 0), type: .Heightmap,
+                                                        contactOffset: contactOffset, dataIndex: 0)],
+                                 bounds: [Aabb(min: Vector4(0, -contactOffset, 0, 0),
+                                               max: Vector4(side, height + contactOffset, side, 0))],
+                                 transforms: [AffineTransform(translation: Vector4(), rotation: Quaternion(),
+                                                              scale: Vector4(1, 1, 1, 1))], count: 1)
+        heightField.UpdateWorld(deltaTime: stepTime)
+        setMeshColliders(world, index: index, translations: [.zero], extent: SIMD3<Float>(side, height, side))
+
+        for (name, colliders) in [("triangle mesh", world), ("heightfield", heightField)] {
+            solver.colliderWorld = colliders
+            start = CFAbsoluteTimeGetCurrent()
+            for _ in 0 ..< steps {
+                solver.collisionDetection(stepTime: stepTime)
+            }
+            let time = (CFAbsoluteTimeGetCurrent() - start) / Double(steps) - baseline
+            print(String(format: "%@ terrain contacts, %d particles, %d threads: %d contacts, %.2f ms, %.1f M particles/s",
+                         name, positions.count, CPUParticleSolver.threadCount, solver.colliderContactCount,
+                         time * 1000, Double(positions.count) / max(time, 1e-9) / 1e6))
+            solver.colliderWorld = nil
+        }
+    }
+}
@@ -0,0 +1,111 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+import simd
+import vox_flex
+import XCTest
+
+final class VolumeBenchmarkTests: XCTestCase {
+    let stepTime: Float = 1 / 60
+
+    /// unit icosphere, outward facing triangles.
+    func icosphere(subdivisions: Int) -> (vertices: [SIMD3<Float>], triangles: [SIMD3<Int32>]) {
+        let g = (1 + sqrt(Float(5))) / 2
+        var vertices = [SIMD3<Float>(-1, g, 0), SIMD3<Float>(1, g, 0), SIMD3<Float>(-1, -g, 0), SIMD3<Float>(1, -g, 0),
+                        SIMD3<Float>(0, -1, g), SIMD3<Float>(0, 1, g), SIMD3<Float>(0, -1, -g), SIMD3<Float>(0, 1, -g),
+                        SIMD3<Float>(g, 0, -1), SIMD3<Float>(g, 0, 1), SIMD3<Float>(-g, 0, -1), SIMD3<Float>(-g, 0, 1)]
+            .map { simd_normalize($0) }
+        var triangles: [SIMD3<Int32>] = [[0, 11, 5], [0, 5, 1], [0, 1, 7], [0, 7, 10], [0, 10, 11], [1, 5, 9],
+                                         [5, 11, 4], [11, 10, 2], [10, 7, 6], [7, 1, 8], [3, 9, 4], [3, 4, 2],
+                                         [3, 2, 6], [3, 6, 8], [3, 8, 9], [4, 9, 5], [2, 4, 11], [6, 2, 10],
+                                         [8, 6, 7], [9, 8, 1]]
+        for _ in 0 ..< subdivisions {
+            var midpoints: [SIMD2<Int32>: Int32] = [:]
+            let midpoint = { (a: Int32, b: Int32) -> Int32 in
+                let key = SIMD2<Int32>(min(a, b), max(a, b))
+                if let index = midpoints[key] {
+                    return index
+                }
+                vertices.append(simd_normalize(vertices[Int(a)] + vertices[Int(b)]))
+                midpoints[key] = Int32(vertices.count - 1)
+                return Int32(vertices.count - 1)
+            }
+            triangles = triangles.flatMap { t -> [SIMD3<Int32>] in
+                let ab = midpoint(t.x, t.y), bc = midpoint(t.y, t.z), ca = midpoint(t.z, t.x)
+                return [[t.x, ab, ca], [t.y, bc, ab], [t.z, ca, bc], [ab, bc, ca]]
+            }
+        }
+        return (vertices, triangles)
+    }
+
+    /// `count` balloons side by side, each a mesh of its own.
+    func makeBalloons(count: Int, subdivisions: Int) -> (solver: CPUParticleSolver, meshes: [[SIMD3<Int32>]]) {
+        let sphere = icosphere(subdivisions: subdivisions)
+        var positions: [SIMD4<Float>] = []
+        var meshes: [[SIMD3<Int32>]] = []
+        for balloon in 0 ..< count {
+            let offset = Int32(positions.count)
+            positions += sphere.vertices.map { SIMD4<Float>($0 + SIMD3<Float>(Float(balloon) * 3, 0, 0), 0) }
+            meshes.append(sphere.triangles.map { $0 &+ offset })
+        }
+        let solver = CPUParticleSolver()
+        solver.gravity = .zero
+        solver.sleepThreshold = 0
+        solver.setParticles(positions: positions, invMasses: [Float](repeating: 1, count: positions.count))
+        return (solver, meshes)
+    }
+
+    func testSquashedBalloonsRecoverTheirVolume() throws {
+        let (solver, meshes) = makeBalloons(count: 2, subdivisions: 3)
+        solver.setConstraintParameters(.Volume, order: .sequential, iterations: 4)
+        solver.addVolumeConstraints(meshes: meshes)
+        let inflated = makeBalloons(count: 1, subdivisions: 3)
+        inflated.solver.setConstraintParameters(.Volume, order: .parallel, iterations: 4)
+        inflated.solver.addVolumeConstraints(meshes: inflated.meshes, pressure: 1.5)
+
+        // the second balloon is flattened to half its height.
+        let half = solver.particleCount / 2
+        solver.setPositions(solver.positions().enumerated().map { i, p in
+            i < half ? p : p * SIMD4<Float>(1, 0.5, 1, 1)
+        })
+        for _ in 0 ..< 20 {
+            solver.step(stepTime: stepTime, substeps: 4)
+            inflated.solver.step(stepTime: stepTime, substeps: 4)
+        }
+        // the untouched balloon keeps its rest volume, slightly less than the sphere's.
+        let volumes = solver.volumes(batch: 0)
+        XCTAssertEqual(volumes[0], 4 * Float.pi / 3, accuracy: 0.05)
+        XCTAssertEqual(volumes[1], volumes[0], accuracy: volumes[0] * 0.01)
+        XCTAssertEqual(inflated.solver.volumes(batch: 0)[0], volumes[0] * 1.5, accuracy: volumes[0] * 0.01)
+    }
+
+    func testVolumeThroughput() throws {
+        // 64 balloons of 1280 triangles, then a single one of 327680: both spread over every core.
+        for (count, subdivisions) in [(64, 3), (1, 7)] {
+            let (solver, meshes) = makeBalloons(count: count, subdivisions: subdivisions)
+            let triangleCount = meshes.reduce(0) { $0 + $1.count }
+            solver.addVolumeConstraints(meshes: meshes)
+            let substeps = 4
+            let steps = 10
+            solver.setConstraintParameters(.Volume, order: .sequential, iterations: 1, enabled: false)
+            var start = CFAbsoluteTimeGetCurrent()
+            for _ in 0 ..< steps {
+                solver.step(stepTime: stepTime, substeps: substeps)
+            }
+            let baseline = CFAbsoluteTimeGetCurrent() - start
+            solver.setConstraintParameters(.Volume, order: .sequential, iterations: 1)
+            start = CFAbsoluteTimeGetCurrent()
+            for _ in 0 ..< steps {
+                solver.step(stepTime: stepTime, substeps: substeps)
+            }
+            let time = (CFAbsoluteTimeGetCurrent() - start - baseline) / Double(steps * substeps)
+            print(String(format: "volume constraints, %d meshes, %d triangles, %d threads: %.3f ms, %.1f M triangles/s",
+                         count, triangleCount, CPUParticleSolver.threadCount, time * 1000,
+                         Double(triangleCount) / max(time, 1e-9) / 1e6))
+        }
+    }
+}
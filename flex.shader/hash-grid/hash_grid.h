@@ -11,6 +11,16 @@ using namespace metal;
 
 class PointHashGridSearcher {
 public:
+    // Buckets visited by ForEachNearbyPointFunc.
+    enum NeighborhoodMode : uint32_t {
+        // the 8 buckets nearest to the query, radius must not exceed half the grid spacing.
+        Octant8 = 0,
+        // the 3x3x3 buckets around the query, radius must not exceed the grid spacing.
+        Cube27 = 1,
+        // every bucket overlapped by the query box, any radius.
+        Radius = 2,
+    };
+
     class HashUtils {
     public:
         HashUtils();
@@ -26,6 +36,8 @@ public:
         
         uint32_t getHashKeyFromPosition(float3 position) const;
         
+        uint3 resolution() const { return _resolution; }
+        
     private:
         float _gridSpacing;
         uint3 _resolution;
@@ -36,9 +48,10 @@ public:
     class ForEachNearbyPointFunc {
     public:
         ForEachNearbyPointFunc(float r, float gridSpacing, uint3 resolution, device const uint32_t* sit,
-                               device const uint32_t* eit, device const float2* si, device const float3* p,
-                               device const float3* o, Callback cb)
+                               device const uint32_t* eit, device const uint2* si, device const float3* p,
+                               device const float3* o, Callback cb, NeighborhoodMode mode = Octant8)
         : _hashUtils(gridSpacing, resolution),
+        _mode(mode),
         _radius(r),
         _startIndexTable(sit),
         _endIndexTable(eit),
@@ -50,41 +63,79 @@ public:
         template <typename Index>
         void operator()(Index idx) {
             const float3 origin = _origins[idx];
-            
-            uint32_t nearbyKeys[8];
-            _hashUtils.getNearbyKeys(origin, nearbyKeys);
-            
             const float queryRadiusSquared = _radius * _radius;
             
-            for (int i = 0; i < 8; i++) {
-                uint32_t nearbyKey = nearbyKeys[i];
-                uint32_t start = _startIndexTable[nearbyKey];
+            if (_mode == Octant8) {
+                uint32_t nearbyKeys[8];
+                _hashUtils.getNearbyKeys(origin, nearbyKeys);
                 
-                // Empty bucket -- continue to next bucket
-                if (start == 0xffffffff) {
-                    continue;
+                for (int i = 0; i < 8; i++) {
+                    uint32_t nearbyKey = nearbyKeys[i];
+                    uint32_t start = _startIndexTable[nearbyKey];
+                    
+                    // Empty bucket -- continue to next bucket
+                    if (start == 0xffffffff) {
+                        continue;
+                    }
+                    
+                    visitRange(idx, origin, queryRadiusSquared, start, _endIndexTable[nearbyKey]);
                 }
-                
-                uint32_t end = _endIndexTable[nearbyKey];
-                
-                for (uint32_t j = start; j < end; ++j) {
-                    uint32_t index = _sortedIndices[j].y;
-                    float3 p = _points[index];
-                    float3 direction = p - origin;
-                    float distanceSquared = length_squared(direction);
-                    if (distanceSquared <= queryRadiusSquared) {
-                        _callback(idx, origin, index, p);
+                return;
+            }
+            
+            int3 lower, upper;
+            if (_mode == Cube27) {
+                lower = _hashUtils.getBucketIndex(origin) - 1;
+                upper = lower + 2;
+            } else {
+                lower = _hashUtils.getBucketIndex(origin - _radius);
+                upper = _hashUtils.getBucketIndex(origin + _radius);
+            }
+            upper = min(upper, lower + int3(_hashUtils.resolution()) - 1);
+            
+            // buckets are sorted by key and keys are consecutive along x, so neighboring non-empty
+            // buckets usually form one contiguous range: merge them and scan each range once.
+            uint32_t rangeStart = 0;
+            uint32_t rangeEnd = 0;
+            for (int z = lower.z; z <= upper.z; ++z) {
+                for (int y = lower.y; y <= upper.y; ++y) {
+                    for (int x = lower.x; x <= upper.x; ++x) {
+                        uint32_t key = _hashUtils.getHashKeyFromBucketIndex(int3(x, y, z));
+                        uint32_t start = _startIndexTable[key];
+                        if (start == 0xffffffff) {
+                            continue;
+                        }
+                        if (start != rangeEnd) {
+                            visitRange(idx, origin, queryRadiusSquared, rangeStart, rangeEnd);
+                            rangeStart = start;
+                        }
+                        rangeEnd = _endIndexTable[key];
                     }
                 }
             }
+            visitRange(idx, origin, queryRadiusSquared, rangeStart, rangeEnd);
         }
         
     private:
+        template <typename Index>
+        void visitRange(Index idx, float3 origin, float queryRadiusSquared, uint32_t start, uint32_t end) {
+            for (uint32_t j = start; j < end; ++j) {
+                uint32_t index = _sortedIndices[j].y;
+                float3 p = _points[index];
+                float3 direction = p - origin;
+                float distanceSquared = length_squared(direction);
+                if (distanceSquared <= queryRadiusSquared) {
+                    _callback(idx, origin, index, p);
+                }
+            }
+        }
+        
         HashUtils _hashUtils;
+        NeighborhoodMode _mode;
         float _radius;
         device const uint32_t* _startIndexTable;
         device const uint32_t* _endIndexTable;
-        device const float2* _sortedIndices;
+        device const uint2* _sortedIndices;
         device const float3* _points;
         device const float3* _origins;
         Callback _callback;
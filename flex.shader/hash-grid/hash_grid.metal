@@ -98,7 +98,7 @@ kernel void initHashGridArgs(constant uint& g_NumElements [[buffer(2)]],
     args.threadgroupsPerGrid[2] = 1;
 }
 
-kernel void prepareSortHash(device float2* u_sortedIndices [[buffer(4)]],
+kernel void prepareSortHash(device uint2* u_sortedIndices [[buffer(4)]],
                             device float3* u_positions [[buffer(5)]],
                             constant HashGridData& u_hashGridData [[buffer(6)]],
                             constant uint& g_NumElements [[buffer(2)]],
@@ -106,23 +106,23 @@ kernel void prepareSortHash(device float2* u_sortedIndices [[buffer(4)]],
     if (tpig.x < g_NumElements) {
         PointHashGridSearcher::HashUtils hashUtils(u_hashGridData.gridSpacing,
                                                    uint3(u_hashGridData.resolutionX, u_hashGridData.resolutionY, u_hashGridData.resolutionZ));
-        float2 sortedIndices = float2(hashUtils.getHashKeyFromPosition(u_positions[tpig.x]), tpig.x);
+        uint2 sortedIndices = uint2(hashUtils.getHashKeyFromPosition(u_positions[tpig.x]), tpig.x);
         u_sortedIndices[tpig.x] = sortedIndices;
     }
 }
 
 kernel void buildHashGrid(device uint* u_startIndexTable [[buffer(0)]],
                           device uint* u_endIndexTable [[buffer(1)]],
-                          device float2* u_sortedIndices [[buffer(4)]],
+                          device uint2* u_sortedIndices [[buffer(4)]],
                           constant uint& g_NumElements [[buffer(2)]],
                           uint3 tpig [[ thread_position_in_grid ]]) {
     if (tpig.x == 0) {
-        u_startIndexTable[uint(u_sortedIndices[0].x)] = 0;
-        u_endIndexTable[uint(u_sortedIndices[g_NumElements - 1].x)] = g_NumElements;
+        u_startIndexTable[u_sortedIndices[0].x] = 0;
+        u_endIndexTable[u_sortedIndices[g_NumElements - 1].x] = g_NumElements;
         return;
     }
     
-    if (tpig.x > 1 && tpig.x < g_NumElements) {
+    if (tpig.x >= 1 && tpig.x < g_NumElements) {
         uint k = u_sortedIndices[tpig.x].x;
         uint kLeft = u_sortedIndices[tpig.x - 1].x;
         if (k > kLeft) {
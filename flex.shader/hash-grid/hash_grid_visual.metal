@@ -18,7 +18,7 @@ struct Callback {
 
 kernel void visualHashGrid(device uint* u_startIndexTable [[buffer(0)]],
                            device uint* u_endIndexTable [[buffer(1)]],
-                           device float2* u_sortedIndices [[buffer(2)]],
+                           device uint2* u_sortedIndices [[buffer(2)]],
                            constant HashGridData& u_hashGridData [[buffer(3)]],
                            device float3* u_points [[buffer(4)]],
                            device float3* u_origins [[buffer(5)]],
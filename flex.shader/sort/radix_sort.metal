@@ -0,0 +1,148 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include <metal_stdlib>
+using namespace metal;
+
+// LSD radix sort of uint2(key, value) pairs, 4 bits per pass. Each pass runs
+//   radixSortCount   -> per-threadgroup digit histogram, stored digit-major: hist[digit * numGroups + group]
+//   radixSortScan    -> exclusive scan of the whole histogram in a single threadgroup
+//   radixSortScatter -> stable local split by digit, then scatter to hist offset + rank in digit
+// Every pass is stable, so keys ordered by the previous digits keep that order.
+
+#define RADIX_BITS          4
+#define RADIX               (1 << RADIX_BITS)
+#define RADIX_MASK          (RADIX - 1)
+#define SORT_THREADS        256
+#define SCAN_THREADS        1024
+#define SIMD_WIDTH          32
+
+// exclusive prefix sum over all threads of the threadgroup; scratch needs SIMD_WIDTH + 1 entries.
+template <uint THREADS>
+uint threadgroupExclusiveSum(uint value, threadgroup uint* scratch, uint lid, thread uint& total) {
+    const uint lane = lid % SIMD_WIDTH;
+    const uint simdGroup = lid / SIMD_WIDTH;
+    uint prefix = simd_prefix_exclusive_sum(value);
+    if (lane == SIMD_WIDTH - 1) {
+        scratch[simdGroup] = prefix + value;
+    }
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    if (simdGroup == 0) {
+        uint sum = lane < THREADS / SIMD_WIDTH ? scratch[lane] : 0;
+        uint groupPrefix = simd_prefix_exclusive_sum(sum);
+        scratch[lane] = groupPrefix;
+        if (lane == SIMD_WIDTH - 1) {
+            scratch[SIMD_WIDTH] = groupPrefix + sum;
+        }
+    }
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    total = scratch[SIMD_WIDTH];
+    uint result = prefix + scratch[simdGroup];
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+    return result;
+}
+
+uint radixGroupCount(uint numElements) {
+    return (numElements + SORT_THREADS - 1) / SORT_THREADS;
+}
+
+kernel void initRadixSortArgs(constant uint& g_NumElements [[buffer(1)]],
+                              device MTLDispatchThreadgroupsIndirectArguments& args [[buffer(2)]]) {
+    args.threadgroupsPerGrid[0] = radixGroupCount(g_NumElements);
+    args.threadgroupsPerGrid[1] = 1;
+    args.threadgroupsPerGrid[2] = 1;
+}
+
+kernel void radixSortCount(constant uint& g_NumElements [[buffer(1)]],
+                           device const uint2* Data [[buffer(2)]],
+                           device uint* Histogram [[buffer(3)]],
+                           constant uint& g_Shift [[buffer(4)]],
+                           uint gid [[thread_position_in_grid]],
+                           uint group [[threadgroup_position_in_grid]],
+                           uint lid [[thread_index_in_threadgroup]]) {
+    threadgroup atomic_uint bins[RADIX];
+    if (lid < RADIX) {
+        atomic_store_explicit(&bins[lid], 0, memory_order_relaxed);
+    }
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    if (gid < g_NumElements) {
+        atomic_fetch_add_explicit(&bins[(Data[gid].x >> g_Shift) & RADIX_MASK], 1, memory_order_relaxed);
+    }
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    if (lid < RADIX) {
+        Histogram[lid * radixGroupCount(g_NumElements) + group] = atomic_load_explicit(&bins[lid], memory_order_relaxed);
+    }
+}
+
+kernel void radixSortScan(constant uint& g_NumElements [[buffer(1)]],
+                          device uint* Histogram [[buffer(3)]],
+                          uint lid [[thread_index_in_threadgroup]]) {
+    threadgroup uint scratch[SIMD_WIDTH + 1];
+
+    const uint count = radixGroupCount(g_NumElements) * RADIX;
+    const uint chunk = (count + SCAN_THREADS - 1) / SCAN_THREADS;
+    const uint begin = min(lid * chunk, count);
+    const uint end = min(begin + chunk, count);
+
+    uint sum = 0;
+    for (uint i = begin; i < end; ++i) {
+        sum += Histogram[i];
+    }
+    uint total;
+    uint offset = threadgroupExclusiveSum<SCAN_THREADS>(sum, scratch, lid, total);
+    for (uint i = begin; i < end; ++i) {
+        uint n = Histogram[i];
+        Histogram[i] = offset;
+        offset += n;
+    }
+}
+
+kernel void radixSortScatter(constant uint& g_NumElements [[buffer(1)]],
+                             device const uint2* Data [[buffer(2)]],
+                             device const uint* Histogram [[buffer(3)]],
+                             constant uint& g_Shift [[buffer(4)]],
+                             device uint2* Output [[buffer(5)]],
+                             uint gid [[thread_position_in_grid]],
+                             uint group [[threadgroup_position_in_grid]],
+                             uint lid [[thread_index_in_threadgroup]]) {
+    threadgroup uint2 sData[SORT_THREADS];
+    threadgroup uint sDigits[SORT_THREADS];
+    threadgroup uint sBinStarts[RADIX];
+    threadgroup uint scratch[SIMD_WIDTH + 1];
+
+    // out-of-range threads carry the largest digit, so the stable split keeps them last.
+    const uint validCount = min(uint(SORT_THREADS), g_NumElements - group * SORT_THREADS);
+    uint2 item = gid < g_NumElements ? Data[gid] : uint2(0xFFFFFFFF, 0);
+    uint digit = gid < g_NumElements ? (item.x >> g_Shift) & RADIX_MASK : RADIX_MASK;
+
+    // stable local sort by digit: one split per bit
+    for (uint bit = 0; bit < RADIX_BITS; ++bit) {
+        uint isSet = (digit >> bit) & 1;
+        uint totalSet;
+        uint setBefore = threadgroupExclusiveSum<SORT_THREADS>(isSet, scratch, lid, totalSet);
+        uint slot = isSet ? SORT_THREADS - totalSet + setBefore : lid - setBefore;
+        sData[slot] = item;
+        sDigits[slot] = digit;
+        threadgroup_barrier(mem_flags::mem_threadgroup);
+        item = sData[lid];
+        digit = sDigits[lid];
+        threadgroup_barrier(mem_flags::mem_threadgroup);
+    }
+
+    if (lid == 0 || sDigits[lid - 1] != digit) {
+        sBinStarts[digit] = lid;
+    }
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    if (lid < validCount) {
+        uint offset = Histogram[digit * radixGroupCount(g_NumElements) + group];
+        Output[offset + lid - sBinStarts[digit]] = item;
+    }
+}
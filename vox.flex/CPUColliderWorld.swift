@@ -0,0 +1,203 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Math
+
+/// Native collider world, see ColliderWorld. Colliders are kept in a multilevel grid updated incrementally as
+/// they move; CPUParticleSolver instances attached to it read its arrays directly.
+public final class CPUColliderWorld: IColliderWorldImpl {
+    let _world = CColliderWorld()
+
+    /// Solvers using this world.
+    public internal(set) var referenceCount: Int = 0
+
+    public init() {}
+
+    public func IncreaseReferenceCount() {
+        referenceCount += 1
+    }
+
+    /// Unregisters the world from ObiColliderWorld once no solver uses it.
+    public func DecreaseReferenceCount() {
+        referenceCount -= 1
+        if referenceCount <= 0 {
+            ObiColliderWorld.GetInstance().UnregisterImplementation(self)
+        }
+    }
+
+    public var colliderCount: Int {
+        Int(_world.colliderCount)
+    }
+
+    public var cellCount: Int {
+        Int(_world.cellCount())
+    }
+
+    public func UpdateWorld(deltaTime: Float) {
+        _world.updateWorld(deltaTime)
+    }
+
+    public func SetColliders(shapes: [ColliderShape], bounds: [Aabb], transforms: [AffineTransform], count: Int) {
+        _world.colliderCount = UInt32(count)
+        let nativeShapes = _world.shapes()
+        let nativeBounds = _world.bounds()
+        let nativeTransforms = _world.transforms()
+        for i in 0 ..< count {
+            let shape = shapes[i]
+            nativeShapes[i] = CColliderShape(center: shape.center.internalValue, size: shape.size.internalValue,
+                                             type: Int32(shape.type.rawValue), contactOffset: shape.contactOffset,
+                                             dataIndex: Int32(shape.dataIndex),
+                                             rigidbodyIndex: Int32(shape.rigidbodyIndex),
+                                             materialIndex: Int32(shape.materialIndex),
+                                             filter: Int32(truncatingIfNeeded: shape.filter),
+                                             flags: Int32(shape.flags), is2D: Int32(shape.is2D))
+            nativeBounds[i] = CAabb(min: bounds[i].min.internalValue, max: bounds[i].max.internalValue)
+            nativeTransforms[i] = CAffineTransform(translation: transforms[i].translation.internalValue,
+                                                   scale: transforms[i].scale.internalValue,
+                                                   rotation: transforms[i].rotation.internalValue)
+        }
+    }
+
+    public func SetRigidbodies(rigidbody: [ColliderRigidbody]) {
+        _world.rigidbodyCount = UInt32(rigidbody.count)
+        let nativeRigidbodies = _world.rigidbodies()
+        for (i, body) in rigidbody.enumerated() {
+            nativeRigidbodies[i] = CColliderRigidbody(inverseInertiaTensor: body.inverseInertiaTensor.elements,
+                                                      velocity: body.velocity.internalValue,
+                                                      angularVelocity: body.angularVelocity.internalValue,
+                                                      com: body.com.internalValue, inverseMass: body.inverseMass)
+        }
+    }
+
+    public func SetCollisionMaterials(materials: [CollisionMaterial]) {
+        _world.materialCount = UInt32(materials.count)
+        let nativeMaterials = _world.materials()
+        for (i, material) in materials.enumerated() {
+            nativeMaterials[i] = CCollisionMaterial(dynamicFriction: material.dynamicFriction,
+                                                    staticFriction: material.staticFriction,
+                                                    rollingFriction: material.rollingFriction,
+                                                    stickiness: material.stickiness,
+                                                    stickDistance: material.stickDistance,
+                                                    frictionCombine: Int32(material.frictionCombine.rawValue),
+                                                    stickinessCombine: Int32(material.stickinessCombine.rawValue),
+                                                    rollingContacts: Int32(material.rollingContacts))
+        }
+    }
+
+    /// Replaces every mesh by those of the headers, mesh i getting data index i. Triangle indices are relative to
+    /// the first vertex of their mesh. The BIH nodes are not used: each mesh builds its own native tree.
+    public func SetTriangleMeshData(headers: [TriangleMeshHeader], nodes _: [BIHNode], triangles: [Triangle],
+                                    vertices: [Vector3])
+    {
+        _world.clearTriangleMeshes()
+        for (i, header) in headers.enumerated() {
+            let meshVertices = vertices[header.firstVertex ..< header.firstVertex + header.vertexCount]
+                .map { $0.internalValue }
+            let meshIndices = triangles[header.firstTriangle ..< header.firstTriangle + header.triangleCount]
+                .flatMap { [Int32($0.i1), Int32($0.i2), Int32($0.i3)] }
+            // a key per header, so identical meshes still get one index each.
+            _world.acquireTriangleMesh(UInt64(i), vertices: meshVertices, vertexCount: UInt32(meshVertices.count),
+                                       indices: meshIndices, triangleCount: UInt32(header.triangleCount))
+        }
+    }
+
+    /// Returns the data index of a TriangleMesh collider's mesh, referenced once more. Meshes are shared by key,
+    /// the content of the mesh by default: only the first reference copies the mesh and builds its tree.
+    @discardableResult
+    public func AcquireTriangleMesh(vertices: [SIMD3<Float>], indices: [Int32], key: UInt64? = nil) -> Int {
+        let triangleCount = UInt32(indices.count / 3)
+        let meshKey = key ?? CColliderWorld.key(forTriangleMeshVertices: vertices, vertexCount: UInt32(vertices.count),
+                                                indices: indices, triangleCount: triangleCount)
+        return Int(_world.acquireTriangleMesh(meshKey, vertices: vertices, vertexCount: UInt32(vertices.count),
+                                              indices: indices, triangleCount: triangleCount))
+    }
+
+    /// Drops one reference to mesh `index`, returns true if that freed it.
+    @discardableResult
+    public func ReleaseTriangleMesh(index: Int) -> Bool {
+        _world.releaseTriangleMesh(Int32(index))
+    }
+
+    public func TriangleMeshReferenceCount(index: Int) -> Int {
+        Int(_world.triangleMeshReferenceCount(Int32(index)))
+    }
+
+    public func TriangleMeshNodeCount(index: Int) -> Int {
+        Int(_world.triangleMeshNodeCount(Int32(index)))
+    }
+
+    public var distanceFieldCount: Int {
+        Int(_world.distanceFieldCount())
+    }
+
+    public func SetDistanceFieldData(headers: [DistanceFieldHeader], nodes: [DFNode]) {
+        let nativeHeaders = headers.map { SIMD2<Int32>(Int32($0.firstNode), Int32($0.nodeCount)) }
+        let distancesA = nodes.map { $0.distancesA.internalValue }
+        let distancesB = nodes.map { $0.distancesB.internalValue }
+        let centers = nodes.map { $0.center.internalValue }
+        let firstChildren = nodes.map { Int32($0.firstChild) }
+        _world.setDistanceFieldHeaders(nativeHeaders, headerCount: UInt32(headers.count), distancesA: distancesA,
+                                       distancesB: distancesB, centers: centers, firstChildren: firstChildren,
+                                       nodeCount: UInt32(nodes.count))
+    }
+
+    /// Obi's layout: each header is a square range of samples, negative ones marking the hole of the cell they
+    /// are the first corner of.
+    public func SetHeightFieldData(headers: [HeightFieldHeader], samples: [Float]) {
+        _world.heightFieldCount = UInt32(headers.count)
+        for (i, header) in headers.enumerated() {
+            let resolution = Int(Float(header.sampleCount).squareRoot().rounded())
+            let range = header.firstSample ..< header.firstSample + resolution * resolution
+            let heights = samples[range].map { abs($0) }
+            var holes = [UInt8](repeating: 0, count: (resolution - 1) * (resolution - 1))
+            for v in 0 ..< resolution - 1 {
+                for u in 0 ..< resolution - 1 where samples[range.lowerBound + v * resolution + u] < 0 {
+                    holes[v * (resolution - 1) + u] = 1
+                }
+            }
+            SetHeightField(index: i, resolutionU: resolution, resolutionV: resolution, samples: heights, holes: holes)
+        }
+    }
+
+    public var heightFieldCount: Int {
+        get {
+            Int(_world.heightFieldCount)
+        }
+        set {
+            _world.heightFieldCount = UInt32(newValue)
+        }
+    }
+
+    /// Replaces heightfield `index` by `resolutionU` x `resolutionV` normalized samples, row major along u, and
+    /// optional hole flags, one per cell.
+    public func SetHeightField(index: Int, resolutionU: Int, resolutionV: Int, samples: [Float],
+                               holes: [UInt8]? = nil)
+    {
+        withOptionalPointer(holes) {
+            _world.setHeightField(UInt32(index), resolutionU: UInt32(resolutionU), resolutionV: UInt32(resolutionV),
+                                  samples: samples, holes: $0)
+        }
+    }
+
+    /// Rewrites a `width` x `height` rectangle of samples of heightfield `index` starting at (u, v), and the hole
+    /// flags of the cells starting there if given, in place.
+    public func UpdateHeightField(index: Int, u: Int, v: Int, width: Int, height: Int, samples: [Float],
+                                  holes: [UInt8]? = nil)
+    {
+        withOptionalPointer(holes) {
+            _world.updateHeightField(UInt32(index), u: UInt32(u), v: UInt32(v), width: UInt32(width),
+                                     height: UInt32(height), samples: samples, holes: $0)
+        }
+    }
+
+    private func withOptionalPointer(_ array: [UInt8]?, _ body: (UnsafePointer<UInt8>?) -> Void) {
+        if let array {
+            array.withUnsafeBufferPointer { body($0.baseAddress) }
+        } else {
+            body(nil)
+        }
+    }
+}
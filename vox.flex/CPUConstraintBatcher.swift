@@ -0,0 +1,42 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+/// Multithreaded graph coloring of two-particle constraints into batches sharing no particle, see ConstraintBatcher.
+public final class CPUConstraintBatcher {
+    public struct Batch {
+        public var startIndex: Int
+        public var constraintCount: Int
+        public var workItemSize: Int
+        public var workItemCount: Int
+        /// the last batch holds constraints that could not be colored and must be solved sequentially.
+        public var isLast: Bool
+    }
+
+    private let _batcher: CConstraintBatcher
+
+    public init(maxBatches: Int = 17) {
+        _batcher = CConstraintBatcher(maxBatches: UInt32(maxBatches))
+    }
+
+    /// Constraint i links particles pairs[i].x and pairs[i].y. Returns the constraint index of every batch slot
+    /// and the batches, `constraintStride` being the size in bytes of one constraint.
+    public func batch(pairs: [SIMD2<Int32>], particleCount: Int,
+                      constraintStride: Int) -> (sortedIndices: [UInt32], batches: [Batch])
+    {
+        let batchCount = pairs.withUnsafeBytes { bytes in
+            _batcher.batchPairs(bytes.bindMemory(to: Int32.self).baseAddress!, count: UInt32(pairs.count),
+                                particleCount: UInt32(particleCount), constraintStride: UInt32(constraintStride))
+        }
+        var batchData = [CBatchData](repeating: CBatchData(), count: Int(batchCount))
+        _batcher.getBatchData(&batchData)
+        var sortedIndices = [UInt32](repeating: 0, count: pairs.count)
+        _batcher.getSortedIndices(&sortedIndices)
+        return (sortedIndices, batchData.map {
+            Batch(startIndex: Int($0.startIndex), constraintCount: Int($0.constraintCount),
+                  workItemSize: Int($0.workItemSize), workItemCount: Int($0.workItemCount), isLast: $0.isLast)
+        })
+    }
+}
@@ -0,0 +1,83 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+/// Multithreaded sparse multilevel grid of Int32 entities, see MultilevelGrid. Cell coords w is the grid level.
+public final class CPUMultilevelGrid {
+    private let _grid = CMultilevelGrid()
+    private var _moves: [CMovingEntity] = []
+
+    public init() {}
+
+    public static func gridLevel(forSize size: Float) -> Int {
+        Int(CMultilevelGrid.gridLevel(forSize: size))
+    }
+
+    public static func cellSize(ofLevel level: Int) -> Float {
+        CMultilevelGrid.cellSize(ofLevel: Int32(level))
+    }
+
+    public static func parentCellCoords(_ cellCoords: int4, level: Int) -> int4 {
+        CMultilevelGrid.parentCellCoords(cellCoords, level: Int32(level))
+    }
+
+    public var cellCount: Int {
+        Int(_grid.cellCount())
+    }
+
+    public var entityCount: Int {
+        Int(_grid.entityCount())
+    }
+
+    /// Arena entries in use, including slices abandoned by cells that grew.
+    public var arenaSize: Int {
+        Int(_grid.arenaSize())
+    }
+
+    public func clear() {
+        _grid.clear()
+    }
+
+    /// Rebuilds the grid with entity i in the cell at cellCoords[i].
+    public func build(cellCoords: [int4]) {
+        _grid.build(withCellCoords: cellCoords, count: UInt32(cellCoords.count))
+    }
+
+    /// Moves entities from their old cell to their new one, then removes the cells left empty.
+    public func update(moving entities: [MovingEntity]) {
+        _moves.removeAll(keepingCapacity: true)
+        for moving in entities {
+            _moves.append(CMovingEntity(oldCellCoords: moving.oldCellCoord, newCellCoords: moving.newCellCoord,
+                                        entity: Int32(moving.entity)))
+        }
+        _grid.update(withMovingEntities: _moves, count: UInt32(_moves.count))
+    }
+
+    public func addToCells(span: BurstCellSpan, entity: Int) {
+        _grid.addToCells(from: span.min, to: span.max, entity: Int32(entity))
+    }
+
+    public func removeFromCells(span: BurstCellSpan, entity: Int) {
+        _grid.removeFromCells(from: span.min, to: span.max, entity: Int32(entity))
+    }
+
+    public func removeEmpty() {
+        _grid.removeEmpty()
+    }
+
+    /// Index of the cell, nil if it holds no entity.
+    public func findCell(_ cellCoords: int4) -> Int? {
+        let cell = _grid.findCell(cellCoords)
+        return cell < 0 ? nil : Int(cell)
+    }
+
+    public func cellCoords(_ cell: Int) -> int4 {
+        _grid.cellCoords(Int32(cell))
+    }
+
+    public func contents(_ cell: Int) -> [Int32] {
+        Array(UnsafeBufferPointer(start: _grid.cellContents(Int32(cell)), count: Int(_grid.cellContentCount(Int32(cell)))))
+    }
+}
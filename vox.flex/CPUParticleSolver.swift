@@ -0,0 +1,743 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import simd
+
+/// Multithreaded native position based dynamics solver, see SolverImpl. Used directly by tools and benchmarks
+/// that need the solver core without a full ObiSolver setup.
+public final class CPUParticleSolver {
+    public enum EvaluationOrder {
+        /// batches are applied one after another, distance constraints are solved in place (Gauss-Seidel).
+        case sequential
+        /// every batch sees the same positions, corrections are averaged and scaled by the SOR factor (Jacobi).
+        case parallel
+    }
+
+    /// What a call to `advance` simulated.
+    public struct FrameStatistics {
+        /// whole fixed steps taken.
+        public var steps: Int
+        /// time left over, covered by interpolating or extrapolating the renderables.
+        public var unsimulatedTime: Float
+        /// time dropped because the frame hit `maxStepsPerFrame`.
+        public var droppedTime: Float
+    }
+
+    /// Bounds of the active particles and of the awake ones, each particle grown by its largest radius.
+    public struct Bounds {
+        public var lower: SIMD3<Float>
+        public var upper: SIMD3<Float>
+        public var awakeLower: SIMD3<Float>
+        public var awakeUpper: SIMD3<Float>
+        public var activeCount: Int
+        public var awakeCount: Int
+
+        public var isEmpty: Bool {
+            activeCount == 0
+        }
+
+        /// every particle is at rest: a solver out of sight can skip its steps.
+        public var isAsleep: Bool {
+            awakeCount == 0
+        }
+    }
+
+    private let _solver = CSolverImpl()
+    private var _distanceBatches: [CDistanceConstraintsBatch] = []
+    private var _shapeMatchingBatches: [CShapeMatchingConstraintsBatch] = []
+    private var _stretchShearBatches: [CStretchShearConstraintsBatch] = []
+    private var _bendTwistBatches: [CBendTwistConstraintsBatch] = []
+    private var _chainBatches: [CChainConstraintsBatch] = []
+    private var _tetherBatches: [CTetherConstraintsBatch] = []
+    private var _skinBatches: [CSkinConstraintsBatch] = []
+    private var _aerodynamicBatches: [CAerodynamicConstraintsBatch] = []
+    private var _volumeBatches: [CVolumeConstraintsBatch] = []
+
+    public init() {}
+
+    /// Threads taking part in a parallel loop, the calling one included.
+    public static var threadCount: Int {
+        Int(CSolverImpl.threadCount())
+    }
+
+    public var particleCount: Int {
+        Int(_solver.particleCount)
+    }
+
+    public var gravity: SIMD3<Float> {
+        get {
+            _solver.gravity
+        }
+        set {
+            _solver.gravity = newValue
+        }
+    }
+
+    public var sleepThreshold: Float {
+        get {
+            _solver.sleepThreshold
+        }
+        set {
+            _solver.sleepThreshold = newValue
+        }
+    }
+
+    /// Largest ratio between the principal axes of a fluid particle.
+    public var maxAnisotropy: Float {
+        get {
+            _solver.maxAnisotropy
+        }
+        set {
+            _solver.maxAnisotropy = newValue
+        }
+    }
+
+    public var damping: Float {
+        get {
+            _solver.damping
+        }
+        set {
+            _solver.damping = newValue
+        }
+    }
+
+    /// Distance added to particle radii when looking for contacts.
+    public var collisionMargin: Float {
+        get {
+            _solver.collisionMargin
+        }
+        set {
+            _solver.collisionMargin = newValue
+        }
+    }
+
+    /// Fraction of the step's motion that simplex bounds are swept by, 0 disables continuous collision detection.
+    public var continuousCollisionDetection: Float {
+        get {
+            _solver.continuousCollisionDetection
+        }
+        set {
+            _solver.continuousCollisionDetection = newValue
+        }
+    }
+
+    /// How `advance` fills the renderables between fixed steps.
+    public var interpolation: Oni.SolverParameters.Interpolation {
+        get {
+            switch _solver.interpolation {
+            case .interpolate:
+                return .Interpolate
+            case .extrapolate:
+                return .Extrapolate
+            default:
+                return .None
+            }
+        }
+        set {
+            switch newValue {
+            case .None:
+                _solver.interpolation = .none
+            case .Interpolate:
+                _solver.interpolation = .interpolate
+            case .Extrapolate:
+                _solver.interpolation = .extrapolate
+            }
+        }
+    }
+
+    /// Length of the fixed steps taken by `advance`, which may change between frames.
+    public var fixedStepTime: Float {
+        get {
+            _solver.fixedStepTime
+        }
+        set {
+            _solver.fixedStepTime = newValue
+        }
+    }
+
+    public var fixedSubsteps: Int {
+        get {
+            Int(_solver.fixedSubsteps)
+        }
+        set {
+            _solver.fixedSubsteps = Int32(newValue)
+        }
+    }
+
+    /// Steps a single `advance` may take, the time beyond them is dropped.
+    public var maxStepsPerFrame: Int {
+        get {
+            Int(_solver.maxStepsPerFrame)
+        }
+        set {
+            _solver.maxStepsPerFrame = Int32(newValue)
+        }
+    }
+
+    /// Replaces the particles, all of them active. Particles with a zero inverse mass are static.
+    public func setParticles(positions: [SIMD4<Float>], invMasses: [Float]) {
+        _solver.particleCount = UInt32(positions.count)
+        let count = positions.count
+        _solver.positions().update(from: positions, count: count)
+        _solver.prevPositions().update(from: positions, count: count)
+        _solver.restPositions().update(from: positions, count: count)
+        _solver.invMasses().update(from: invMasses, count: min(invMasses.count, count))
+        let active = (0 ..< Int32(count)).map { $0 }
+        _solver.setActiveParticles(active, count: UInt32(count))
+    }
+
+    /// Moves the particles without changing their rest positions.
+    public func setPositions(_ positions: [SIMD4<Float>]) {
+        _solver.positions().update(from: positions, count: min(positions.count, particleCount))
+    }
+
+    public func setVelocities(_ velocities: [SIMD4<Float>]) {
+        _solver.velocities().update(from: velocities, count: min(velocities.count, particleCount))
+    }
+
+    public func positions() -> [SIMD4<Float>] {
+        Array(UnsafeBufferPointer(start: _solver.positions(), count: particleCount))
+    }
+
+    /// Sets the particles' orientations, also as their previous and rest ones. Particles with a zero inverse
+    /// rotational mass don't rotate.
+    public func setOrientations(_ orientations: [simd_quatf], invRotationalMasses: [Float]) {
+        let count = min(orientations.count, particleCount)
+        _solver.orientations().update(from: orientations, count: count)
+        _solver.prevOrientations().update(from: orientations, count: count)
+        _solver.restOrientations().update(from: orientations, count: count)
+        _solver.invRotationalMasses().update(from: invRotationalMasses, count: min(invRotationalMasses.count, count))
+    }
+
+    public func orientations() -> [simd_quatf] {
+        Array(UnsafeBufferPointer(start: _solver.orientations(), count: particleCount))
+    }
+
+    public func renderablePositions() -> [SIMD4<Float>] {
+        Array(UnsafeBufferPointer(start: _solver.renderablePositions(), count: particleCount))
+    }
+
+    public func renderableOrientations() -> [simd_quatf] {
+        Array(UnsafeBufferPointer(start: _solver.renderableOrientations(), count: particleCount))
+    }
+
+    /// Turns every particle into fluid. Dynamic particles get the mass of a cube of fluid at rest as wide as
+    /// their diameter, static ones stay static.
+    public func setFluidMaterial(radius: Float, smoothingRadius: Float, restDensity: Float,
+                                 viscosity: Float = 0, vorticityConfinement: Float = 0)
+    {
+        let invMass = 1 / (restDensity * pow(radius * 2, 3))
+        for i in 0 ..< particleCount {
+            _solver.phases()[i] |= Int32(ObiUtils.ParticleFlags.Fluid.rawValue)
+            _solver.principalRadii()[i] = SIMD4<Float>(repeating: radius)
+            _solver.smoothingRadii()[i] = smoothingRadius
+            _solver.restDensities()[i] = restDensity
+            _solver.viscosities()[i] = viscosity
+            _solver.vortConfinement()[i] = vorticityConfinement
+            if _solver.invMasses()[i] > 0 {
+                _solver.invMasses()[i] = invMass
+            }
+        }
+    }
+
+    /// Density of every particle at the last density iteration.
+    public func fluidDensities() -> [Float] {
+        UnsafeBufferPointer(start: _solver.fluidData(), count: particleCount).map { $0.x }
+    }
+
+    /// Three principal axes per particle, radius along each in w, written by `applyInterpolation`.
+    public func anisotropies() -> [SIMD4<Float>] {
+        Array(UnsafeBufferPointer(start: _solver.anisotropies(), count: particleCount * 3))
+    }
+
+    public var fluidInteractionCount: Int {
+        Int(_solver.fluidInteractionCount())
+    }
+
+    /// Sets every particle's radius, phase (see ObiUtils.MakePhase) and collision filter (see ObiUtils.MakeFilter).
+    public func setCollisionMaterial(radii: [Float], phases: [Int], filters: [Int]) {
+        for i in 0 ..< particleCount {
+            _solver.principalRadii()[i] = SIMD4<Float>(repeating: radii[i])
+            _solver.phases()[i] = Int32(truncatingIfNeeded: phases[i])
+            _solver.filters()[i] = Int32(truncatingIfNeeded: filters[i])
+        }
+    }
+
+    /// Replaces the simplices colliding with each other. Simplex indices in contacts are in this order:
+    /// points first, then edges, then triangles.
+    public func setSimplices(points: [Int32], edges: [SIMD2<Int32>] = [], triangles: [SIMD3<Int32>] = []) {
+        var indices = points
+        indices.reserveCapacity(points.count + edges.count * 2 + triangles.count * 3)
+        for edge in edges {
+            indices.append(contentsOf: [edge.x, edge.y])
+        }
+        for triangle in triangles {
+            indices.append(contentsOf: [triangle.x, triangle.y, triangle.z])
+        }
+        _solver.setSimplices(indices, pointCount: UInt32(points.count), edgeCount: UInt32(edges.count),
+                             triangleCount: UInt32(triangles.count))
+    }
+
+    public var simplexCount: Int {
+        Int(_solver.simplexCount())
+    }
+
+    /// Recomputes the simplex bounds for a step of `stepTime`, as every collision detection does.
+    public func calculateSimplexBounds(stepTime: Float) {
+        _solver.calculateSimplexBounds(stepTime)
+    }
+
+    /// Bounds of every simplex as of the last collision detection, swept by its motion over the step.
+    public func simplexBounds() -> [(lower: SIMD3<Float>, upper: SIMD3<Float>)] {
+        var corners = [SIMD4<Float>](repeating: .zero, count: simplexCount * 2)
+        _solver.getSimplexBounds(&corners)
+        return (0 ..< simplexCount).map { i in
+            (SIMD3<Float>(corners[i * 2].x, corners[i * 2].y, corners[i * 2].z),
+             SIMD3<Float>(corners[i * 2 + 1].x, corners[i * 2 + 1].y, corners[i * 2 + 1].z))
+        }
+    }
+
+    /// Bounds for frustum and sleep culling.
+    public func bounds() -> Bounds {
+        let bounds = _solver.bounds()
+        return Bounds(lower: bounds.lower, upper: bounds.upper, awakeLower: bounds.awakeLower,
+                      awakeUpper: bounds.awakeUpper, activeCount: Int(bounds.activeCount),
+                      awakeCount: Int(bounds.awakeCount))
+    }
+
+    public var particleContactCount: Int {
+        Int(_solver.particleContactCount())
+    }
+
+    /// Colliders the simplices collide with. The world is updated by its owner, before collision detection.
+    public var colliderWorld: CPUColliderWorld? {
+        didSet {
+            oldValue?.referenceCount -= 1
+            colliderWorld?.referenceCount += 1
+            _solver.setColliderWorld(colliderWorld?._world)
+        }
+    }
+
+    /// (simplex, collider) pairs with intersecting bounds found by the last collision detection.
+    public func colliderCandidates() -> [SIMD2<Int32>] {
+        var candidates = [SIMD2<Int32>](repeating: .zero, count: Int(_solver.colliderCandidateCount()))
+        _solver.getColliderCandidates(&candidates)
+        return candidates
+    }
+
+    /// Contacts between simplices found by the last collision detection.
+    public func particleContacts() -> [BurstContact] {
+        var contacts = [CParticleContact](repeating: CParticleContact(), count: particleContactCount)
+        _solver.getParticleContacts(&contacts)
+        return contacts.map(CPUParticleSolver.burstContact)
+    }
+
+    public var colliderContactCount: Int {
+        Int(_solver.colliderContactCount())
+    }
+
+    /// Contacts between simplices and colliders found by the last collision detection, bodyB being the collider
+    /// and pointB a point of its surface.
+    public func colliderContacts() -> [BurstContact] {
+        var contacts = [CParticleContact](repeating: CParticleContact(), count: colliderContactCount)
+        _solver.getColliderContacts(&contacts)
+        return contacts.map(CPUParticleSolver.burstContact)
+    }
+
+    /// Collider contacts of the last collision detection per shape type.
+    public func colliderContactCounts() -> [ColliderShape.ShapeType: Int] {
+        let types: [ColliderShape.ShapeType] = [.Sphere, .Box, .Capsule, .Heightmap, .TriangleMesh, .EdgeMesh,
+                                                .SignedDistanceField]
+        var counts = [UInt32](repeating: 0, count: types.count)
+        _solver.getColliderContactCountsByType(&counts, count: UInt32(counts.count))
+        var result: [ColliderShape.ShapeType: Int] = [:]
+        for type in types {
+            result[type] = Int(counts[type.rawValue])
+        }
+        return result
+    }
+
+    /// Simplices near each shape, against the grid of the last collision detection. `transforms` are the world
+    /// transforms of the shapes, nil for shapes in solver space. Results are written to the front of `results`,
+    /// which only grows when it cannot hold them all so it can be reused from frame to frame; returns how many
+    /// were found.
+    @discardableResult
+    public func spatialQuery(shapes: [CQueryShape], transforms: [CAffineTransform]? = nil,
+                             results: inout [CQueryResult]) -> Int {
+        precondition(transforms == nil || transforms!.count == shapes.count)
+        func query() -> Int {
+            let count = UInt32(shapes.count)
+            let capacity = UInt32(results.count)
+            guard let transforms = transforms else {
+                return Int(_solver.spatialQuery(shapes, transforms: nil, count: count, results: &results,
+                                                capacity: capacity))
+            }
+            return Int(_solver.spatialQuery(shapes, transforms: transforms, count: count, results: &results,
+                                            capacity: capacity))
+        }
+        let found = query()
+        if found > results.count {
+            results = [CQueryResult](repeating: CQueryResult(), count: found)
+            return query()
+        }
+        return found
+    }
+
+    /// Nearest simplex a ray of `thickness` touches between `origin` and `origin + direction * length`, with
+    /// how far along the ray it comes closest to the ray's axis, all in solver space.
+    public func raycast(origin: SIMD3<Float>, direction: SIMD3<Float>, length: Float, thickness: Float = 0,
+                       filter: Int32 = CPUParticleSolver.defaultFilter) -> (simplex: Int, distance: Float)? {
+        let direction = simd_normalize(direction)
+        let ray = CQueryShape(center: SIMD4<Float>(origin, 0), size: SIMD4<Float>(origin + direction * length, 0),
+                              type: .ray, contactOffset: thickness, maxDistance: 0, filter: filter)
+        var results: [CQueryResult] = []
+        let found = spatialQuery(shapes: [ray], results: &results)
+        var hit: (simplex: Int, distance: Float)?
+        for result in results[0 ..< found] {
+            let distance = simd_dot(SIMD3<Float>(result.queryPoint.x, result.queryPoint.y, result.queryPoint.z) -
+                origin, direction)
+            if hit == nil || distance < hit!.distance {
+                hit = (Int(result.simplexIndex), max(distance, 0))
+            }
+        }
+        return hit
+    }
+
+    /// Simplices overlapping a sphere in solver space, in grid order.
+    public func overlapSphere(center: SIMD3<Float>, radius: Float,
+                              filter: Int32 = CPUParticleSolver.defaultFilter) -> [Int] {
+        let sphere = CQueryShape(center: SIMD4<Float>(center, 0), size: SIMD4<Float>(repeating: radius), type: .sphere,
+                                 contactOffset: 0, maxDistance: 0, filter: filter)
+        var results: [CQueryResult] = []
+        let found = spatialQuery(shapes: [sphere], results: &results)
+        return results[0 ..< found].map { Int($0.simplexIndex) }
+    }
+
+    /// First category, colliding with every category.
+    public static let defaultFilter =
+        Int32(truncatingIfNeeded: ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything, category: 0))
+
+    static func burstContact(_ contact: CParticleContact) -> BurstContact {
+        BurstContact(pointA: contact.pointA, pointB: contact.pointB, normal: contact.normal, distance: contact.distance,
+                     bodyA: Int(contact.bodyA), bodyB: Int(contact.bodyB))
+    }
+
+    public func setConstraintParameters(_ type: Oni.ConstraintType, order: EvaluationOrder, iterations: Int,
+                                        sorFactor: Float = 1, enabled: Bool = true)
+    {
+        _solver.setConstraintParameters(UInt32(type.rawValue), enabled: enabled,
+                                        order: order == .sequential ? .sequential : .parallel,
+                                        iterations: Int32(iterations), sorFactor: sorFactor)
+    }
+
+    public func constraintCount(_ type: Oni.ConstraintType) -> Int {
+        Int(_solver.constraintCount(UInt32(type.rawValue)))
+    }
+
+    /// Adds a batch of distance constraints, which must share no particle. Returns the batch index.
+    @discardableResult
+    public func addDistanceConstraints(pairs: [SIMD2<Int32>], restLengths: [Float], compliance: Float = 0,
+                                       maxCompression: Float = 0) -> Int
+    {
+        let batch = CDistanceConstraintsBatch(solver: _solver)
+        let stiffnesses = [SIMD2<Float>](repeating: SIMD2<Float>(compliance, maxCompression), count: pairs.count)
+        pairs.withUnsafeBytes { bytes in
+            batch.setDistanceConstraints(bytes.bindMemory(to: Int32.self).baseAddress!, restLengths: restLengths,
+                                         stiffnesses: stiffnesses, lambdas: nil, count: UInt32(pairs.count))
+        }
+        _distanceBatches.append(batch)
+        return _distanceBatches.count - 1
+    }
+
+    /// XPBD multipliers accumulated by a distance batch during the last substep.
+    public func distanceLambdas(batch: Int) -> [Float] {
+        var lambdas = [Float](repeating: 0, count: Int(_distanceBatches[batch].constraintCount()))
+        _distanceBatches[batch].getLambdas(&lambdas)
+        return lambdas
+    }
+
+    /// Adds a batch of shape matching clusters, which may share particles. Rest shapes are taken from the
+    /// particles' rest positions. Returns the batch index.
+    @discardableResult
+    public func addShapeMatchingConstraints(clusters: [[Int32]], stiffness: Float = 1, plasticYield: Float = 0,
+                                            plasticCreep: Float = 0, plasticRecovery: Float = 0,
+                                            maxDeformation: Float = 0) -> Int
+    {
+        let batch = CShapeMatchingConstraintsBatch(solver: _solver)
+        var firstIndex: [Int32] = []
+        var offset: Int32 = 0
+        for cluster in clusters {
+            firstIndex.append(offset)
+            offset += Int32(cluster.count)
+        }
+        let material = [stiffness, plasticYield, plasticCreep, plasticRecovery, maxDeformation]
+        batch.setShapeMatchingConstraints(clusters.flatMap { $0 }, firstIndex: firstIndex,
+                                          numIndices: clusters.map { Int32($0.count) },
+                                          explicitGroup: [Int32](repeating: 0, count: clusters.count),
+                                          materialParameters: clusters.flatMap { _ in material },
+                                          orientations: nil, plasticDeformations: nil, count: UInt32(clusters.count))
+        batch.calculateRestShapeMatching()
+        _shapeMatchingBatches.append(batch)
+        return _shapeMatchingBatches.count - 1
+    }
+
+    /// Best-match rotations and plastic deformations of a shape matching batch's clusters, as of the last
+    /// iteration.
+    public func shapeMatchingState(batch: Int) -> (orientations: [simd_quatf], plasticDeformations: [simd_float4x4]) {
+        let count = Int(_shapeMatchingBatches[batch].constraintCount())
+        var orientations = [simd_quatf](repeating: simd_quatf(), count: count)
+        var deformations = [simd_float4x4](repeating: simd_float4x4(), count: count)
+        _shapeMatchingBatches[batch].getRestComs(nil, coms: nil, orientations: &orientations, linearTransforms: nil,
+                                                 plasticDeformations: &deformations)
+        return (orientations, deformations)
+    }
+
+    /// Adds a batch of Cosserat stretch / shear constraints, which must share no particle. Each segment's material
+    /// frame is the orientation of its first particle times its rest orientation, whose third axis follows the
+    /// segment. Compliances are for shear along the first two axes and stretch along the third. Returns the batch
+    /// index.
+    @discardableResult
+    public func addStretchShearConstraints(pairs: [SIMD2<Int32>], restLengths: [Float], restOrientations: [simd_quatf],
+                                           compliance: SIMD3<Float> = .zero) -> Int
+    {
+        let batch = CStretchShearConstraintsBatch(solver: _solver)
+        let compliances = pairs.flatMap { _ in [compliance.x, compliance.y, compliance.z] }
+        batch.setStretchShearConstraints(pairs.flatMap { [$0.x, $0.y] }, orientationIndices: pairs.map { $0.x },
+                                         restLengths: restLengths, restOrientations: restOrientations,
+                                         stiffnesses: compliances, lambdas: nil, count: UInt32(pairs.count))
+        _stretchShearBatches.append(batch)
+        return _stretchShearBatches.count - 1
+    }
+
+    /// Adds a batch of Cosserat bend / twist constraints between pairs of orientations, which must share none.
+    /// Compliances are for bending around the first two material axes and twisting around the third. Returns the
+    /// batch index.
+    @discardableResult
+    public func addBendTwistConstraints(pairs: [SIMD2<Int32>], restDarboux: [simd_quatf],
+                                        compliance: SIMD3<Float> = .zero, plasticYield: Float = 0,
+                                        plasticCreep: Float = 0) -> Int
+    {
+        let batch = CBendTwistConstraintsBatch(solver: _solver)
+        let compliances = pairs.flatMap { _ in [compliance.x, compliance.y, compliance.z] }
+        let plasticity = [SIMD2<Float>](repeating: SIMD2<Float>(plasticYield, plasticCreep), count: pairs.count)
+        batch.setBendTwistConstraints(pairs.flatMap { [$0.x, $0.y] }, restDarboux: restDarboux,
+                                      stiffnesses: compliances, plasticity: plasticity, lambdas: nil,
+                                      count: UInt32(pairs.count))
+        _bendTwistBatches.append(batch)
+        return _bendTwistBatches.count - 1
+    }
+
+    /// Adds a batch of chains solved directly, which must share no particle. Links keep their length within
+    /// [minLength, maxLength]. Returns the batch index.
+    @discardableResult
+    public func addChainConstraints(chains: [[Int32]], minLength: Float, maxLength: Float) -> Int {
+        let batch = CChainConstraintsBatch(solver: _solver)
+        var firstIndex: [Int32] = []
+        var offset: Int32 = 0
+        for chain in chains {
+            firstIndex.append(offset)
+            offset += Int32(chain.count)
+        }
+        batch.setChainConstraints(chains.flatMap { $0 },
+                                  restLengths: [SIMD2<Float>](repeating: SIMD2<Float>(minLength, maxLength),
+                                                              count: chains.count),
+                                  firstIndex: firstIndex, numIndices: chains.map { Int32($0.count) },
+                                  count: UInt32(chains.count))
+        _chainBatches.append(batch)
+        return _chainBatches.count - 1
+    }
+
+    /// Tethers every dynamic particle reachable along `edges` to its geodesically closest fixed particle, measured
+    /// on the rest positions, with one batch per island of fixed particles. A tether lets its particle get as far as
+    /// `scale` times the geodesic distance from the anchor. Returns the indices of the new batches.
+    @discardableResult
+    public func addTetherConstraints(edges: [SIMD2<Int32>], scale: Float = 1, compliance: Float = 0) -> [Int] {
+        let anchors = CTetherAnchors()
+        let count = edges.withUnsafeBytes { bytes in
+            Int(anchors.build(withPositions: _solver.restPositions(), invMasses: _solver.invMasses(),
+                              particleCount: UInt32(particleCount),
+                              edges: bytes.bindMemory(to: Int32.self).baseAddress!, edgeCount: UInt32(edges.count)))
+        }
+        var tethers = [Int32](repeating: 0, count: count * 2)
+        var distances = [Float](repeating: 0, count: count)
+        var offsets = [Int32](repeating: 0, count: Int(anchors.islandCount) + 1)
+        anchors.getTethers(&tethers, distances: &distances)
+        anchors.getIslandOffsets(&offsets)
+
+        var indices: [Int] = []
+        for island in 0 ..< Int(anchors.islandCount) {
+            let range = Int(offsets[island]) ..< Int(offsets[island + 1])
+            let batch = CTetherConstraintsBatch(solver: _solver)
+            batch.setTetherConstraints(Array(tethers[range.lowerBound * 2 ..< range.upperBound * 2]),
+                                       maxLengthScale: distances[range].map { SIMD2<Float>($0, scale) },
+                                       stiffnesses: [Float](repeating: compliance, count: range.count),
+                                       lambdas: nil, count: UInt32(range.count))
+            _tetherBatches.append(batch)
+            indices.append(_tetherBatches.count - 1)
+        }
+        return indices
+    }
+
+    /// Adds a batch of skin constraints, one per particle, which must be distinct. Each particle stays within
+    /// `radius` of its skin point and out of a sphere of `backstopRadius` whose surface lies `backstop` behind the
+    /// skin along its normal. Returns the batch index.
+    @discardableResult
+    public func addSkinConstraints(particles: [Int32], skinPoints: [SIMD4<Float>], skinNormals: [SIMD4<Float>],
+                                   radius: Float, backstopRadius: Float, backstop: Float, compliance: Float = 0) -> Int
+    {
+        let batch = CSkinConstraintsBatch(solver: _solver)
+        let radiiBackstop = particles.flatMap { _ in [radius, backstopRadius, backstop] }
+        batch.setSkinConstraints(particles, skinPoints: skinPoints, skinNormals: skinNormals,
+                                 radiiBackstop: radiiBackstop,
+                                 stiffnesses: [Float](repeating: compliance, count: particles.count),
+                                 lambdas: nil, count: UInt32(particles.count))
+        _skinBatches.append(batch)
+        return _skinBatches.count - 1
+    }
+
+    /// Makes a skin batch read its targets from a skinned vertex buffer instead, see CSkinConstraintsBatch. The
+    /// buffers are borrowed and must outlive the binding; nil positions unbind them.
+    public func bindSkinnedVertices(batch: Int, positions: UnsafePointer<SIMD4<Float>>?,
+                                    normals: UnsafePointer<SIMD4<Float>>?, vertexIndices: UnsafePointer<Int32>? = nil)
+    {
+        _skinBatches[batch].bindSkinnedVertices(positions, normals: normals, vertexIndices: vertexIndices)
+    }
+
+    /// Triangles aerodynamic constraints compute their forces on.
+    public func setDeformableTriangles(_ triangles: [SIMD3<Int32>]) {
+        let indices = triangles.flatMap { [$0.x, $0.y, $0.z] }
+        _solver.setDeformableTriangles(indices, count: UInt32(triangles.count))
+    }
+
+    /// Sets the wind around every particle, in solver space.
+    public func setWind(_ wind: [SIMD4<Float>]) {
+        _solver.wind().update(from: wind, count: min(wind.count, particleCount))
+    }
+
+    /// Wind sampled on top of the particles' wind, see CSolverImpl. Nil samples remove the field.
+    public func setWindField(samples: [SIMD4<Float>]?, resolution: SIMD3<Int32> = .zero, lower: SIMD3<Float> = .zero,
+                             upper: SIMD3<Float> = .zero)
+    {
+        if let samples {
+            _solver.setWindField(samples, resolution: resolution, lower: lower, upper: upper)
+        } else {
+            _solver.clearWindField()
+        }
+    }
+
+    /// Adds a batch of aerodynamic constraints with the same area, drag and lift coefficients for every particle.
+    /// Returns the batch index.
+    @discardableResult
+    public func addAerodynamicConstraints(particles: [Int32], area: Float, drag: Float, lift: Float) -> Int {
+        let batch = CAerodynamicConstraintsBatch(solver: _solver)
+        batch.setAerodynamicConstraints(particles, aerodynamicCoeffs: particles.flatMap { _ in [area, drag, lift] },
+                                        count: UInt32(particles.count))
+        _aerodynamicBatches.append(batch)
+        return _aerodynamicBatches.count - 1
+    }
+
+    /// Triangles an aerodynamic batch computed its forces on during the last substep.
+    public func aerodynamicTriangleCount(batch: Int) -> Int {
+        Int(_aerodynamicBatches[batch].triangleCount())
+    }
+
+    /// Adds a batch of volume constraints, one per closed mesh of outward facing triangles. Meshes must share no
+    /// particle. Each keeps `pressure` times its volume at the rest positions. Returns the batch index.
+    @discardableResult
+    public func addVolumeConstraints(meshes: [[SIMD3<Int32>]], pressure: Float = 1, compliance: Float = 0) -> Int {
+        let batch = CVolumeConstraintsBatch(solver: _solver)
+        let rest = _solver.restPositions()
+        var firstTriangle: [Int32] = []
+        var restVolumes: [Float] = []
+        var offset: Int32 = 0
+        for mesh in meshes {
+            firstTriangle.append(offset)
+            offset += Int32(mesh.count)
+            restVolumes.append(mesh.reduce(0) { volume, t in
+                let a = rest[Int(t.x)], b = rest[Int(t.y)], c = rest[Int(t.z)]
+                return volume + simd_dot(SIMD3<Float>(a.x, a.y, a.z),
+                                         simd_cross(SIMD3<Float>(b.x, b.y, b.z), SIMD3<Float>(c.x, c.y, c.z))) / 6
+            })
+        }
+        batch.setVolumeConstraints(meshes.flatMap { $0.flatMap { [$0.x, $0.y, $0.z] } }, firstTriangle: firstTriangle,
+                                   numTriangles: meshes.map { Int32($0.count) }, restVolumes: restVolumes,
+                                   pressureStiffness: [SIMD2<Float>](repeating: SIMD2<Float>(pressure, compliance),
+                                                                     count: meshes.count),
+                                   lambdas: nil, count: UInt32(meshes.count))
+        _volumeBatches.append(batch)
+        return _volumeBatches.count - 1
+    }
+
+    /// Volumes of a volume batch's meshes, as of the last iteration.
+    public func volumes(batch: Int) -> [Float] {
+        var volumes = [Float](repeating: 0, count: Int(_volumeBatches[batch].constraintCount()))
+        _volumeBatches[batch].getVolumes(&volumes)
+        return volumes
+    }
+
+    /// Places solver space in the world, at rest.
+    public func setFrame(translation: SIMD3<Float>, scale: SIMD3<Float> = .one,
+                         rotation: simd_quatf = simd_quatf(ix: 0, iy: 0, iz: 0, r: 1)) {
+        _solver.initializeFrame(withTranslation: SIMD4<Float>(translation, 0), scale: SIMD4<Float>(scale, 1),
+                                rotation: rotation)
+    }
+
+    /// Moves solver space to its new world transform, `deltaTime` seconds after the last one, and applies the
+    /// resulting inertial forces to the coming step: a scale of 1 simulates as if in world space, 0 drags the
+    /// particles along with the frame.
+    public func updateFrame(translation: SIMD3<Float>, scale: SIMD3<Float> = .one,
+                            rotation: simd_quatf = simd_quatf(ix: 0, iy: 0, iz: 0, r: 1), deltaTime: Float,
+                            linearInertiaScale: Float = 1, angularInertiaScale: Float = 1) {
+        _solver.updateFrame(withTranslation: SIMD4<Float>(translation, 0), scale: SIMD4<Float>(scale, 1),
+                            rotation: rotation, deltaTime: deltaTime)
+        _solver.applyFrame(withLinearInertiaScale: linearInertiaScale, angularInertiaScale: angularInertiaScale)
+    }
+
+    public var inertialFrame: CInertialFrame {
+        _solver.inertialFrame()
+    }
+
+    /// Finds the fluid interactions, simplex contacts and collider candidates of the coming step.
+    public func collisionDetection(stepTime: Float) {
+        _solver.collisionDetection(stepTime)
+    }
+
+    public func substep(stepTime: Float, substepTime: Float, substeps: Int) {
+        _solver.substep(stepTime, substepTime: substepTime, substeps: Int32(substeps))
+    }
+
+    /// One full step: collision detection followed by `substeps` substeps.
+    public func step(stepTime: Float, substeps: Int) {
+        collisionDetection(stepTime: stepTime)
+        for _ in 0 ..< substeps {
+            substep(stepTime: stepTime, substepTime: stepTime / Float(substeps), substeps: substeps)
+        }
+    }
+
+    /// Simulates `frameTime` more seconds in fixed steps of `fixedStepTime`, then writes the renderables for the
+    /// time left over according to `interpolation`.
+    @discardableResult
+    public func advance(frameTime: Float) -> FrameStatistics {
+        let frame = _solver.advance(frameTime)
+        return FrameStatistics(steps: Int(frame.steps), unsimulatedTime: frame.unsimulatedTime,
+                               droppedTime: frame.droppedTime)
+    }
+
+    /// Forgets the time accumulated by `advance` and the state interpolation starts from.
+    public func resetSchedule() {
+        _solver.resetSchedule()
+    }
+
+    /// Frames and fixed steps run by `advance` so far.
+    public var scheduleCounts: (frames: Int, steps: Int) {
+        (Int(_solver.frameCount()), Int(_solver.stepCount()))
+    }
+
+    /// Copies the current state to the renderables, smoothing fluid particles and computing their anisotropy.
+    public func updateRenderables() {
+        _solver.applyInterpolation(withStartPositions: nil, startOrientations: nil, stepTime: 0, unsimulatedTime: 0)
+    }
+}
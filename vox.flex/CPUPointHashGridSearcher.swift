@@ -0,0 +1,56 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+/// Multithreaded CPU hash grid, same hashing as the Metal PointHashGridSearcher.
+public final class CPUPointHashGridSearcher {
+    public enum NeighborhoodMode: UInt32 {
+        /// 8 nearest buckets, radius up to half the grid spacing.
+        case octant8
+        /// 3x3x3 buckets, radius up to the grid spacing.
+        case cube27
+        /// every bucket overlapped by the query box, any radius.
+        case radius
+    }
+
+    private let _searcher: CPointHashGridSearcher
+    private var _count: UInt32 = 0
+
+    public init(resolution: SIMD3<UInt32>, gridSpacing: Float) {
+        _searcher = CPointHashGridSearcher(resolution: resolution, gridSpacing: gridSpacing)
+    }
+
+    public var neighborhoodMode: NeighborhoodMode {
+        get {
+            NeighborhoodMode(rawValue: _searcher.neighborhoodMode.rawValue)!
+        }
+        set {
+            _searcher.neighborhoodMode = CNeighborhoodMode(rawValue: newValue.rawValue)!
+        }
+    }
+
+    public var movedPointCount: UInt32 {
+        _searcher.movedPointCount()
+    }
+
+    public func build(_ positions: [SIMD3<Float>]) {
+        _count = UInt32(positions.count)
+        _searcher.build(positions, count: _count)
+    }
+
+    public func update(_ positions: [SIMD3<Float>], maxMovedFraction: Float = 0.25) {
+        _count = UInt32(positions.count)
+        _searcher.update(positions, count: _count, maxMovedFraction: maxMovedFraction)
+    }
+
+    /// CSR neighbor lists: neighbors of point i are neighbors[offsets[i] ..< offsets[i + 1]].
+    public func neighborLists(radius: Float) -> (offsets: [UInt32], neighbors: [UInt32]) {
+        let neighborCount = _searcher.buildNeighborLists(radius)
+        var offsets = [UInt32](repeating: 0, count: Int(_count) + 1)
+        var neighbors = [UInt32](repeating: 0, count: Int(neighborCount))
+        _searcher.getNeighborLists(&offsets, &neighbors)
+        return (offsets, neighbors)
+    }
+}
@@ -0,0 +1,31 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+/// Multithreaded LSD radix sort of UInt32 keys with a UInt32 payload, scratch memory is reused between calls.
+public final class CPURadixSort {
+    private let _sort = CRadixSort()
+
+    public init() {}
+
+    /// Number of bits needed for keys in 0..<keyCount.
+    public static func keyBits(for keyCount: UInt32) -> UInt32 {
+        keyCount <= 1 ? 1 : UInt32(32 - (keyCount - 1).leadingZeroBitCount)
+    }
+
+    /// Stable ascending sort of `keys`, permuting `values` alongside. Only the 8-bit digits covering the low
+    /// `keyBits` bits are sorted, so keys must fit in them.
+    public func sort(keys: inout [UInt32], values: inout [UInt32], keyBits: UInt32 = 32) {
+        precondition(keys.count == values.count)
+        if keys.isEmpty {
+            return
+        }
+        keys.withUnsafeMutableBufferPointer { keys in
+            values.withUnsafeMutableBufferPointer { values in
+                _sort.sort(keys.baseAddress!, values: values.baseAddress!, count: UInt32(keys.count), keyBits: keyBits)
+            }
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+/// Multithreaded CPU SPH solver for runs without a GPU, see WCSphSolver and PCISphSolver.
+public final class CPUSphSolver {
+    public enum Method {
+        case wcsph
+        case pcisph
+    }
+
+    private let _solver: CSphSolver
+
+    public init(_ method: Method) {
+        _solver = CSphSolver(type: method == .pcisph ? .PCISPH : .WCSPH)
+    }
+
+    public var targetSpacing: Float {
+        get {
+            _solver.targetSpacing
+        }
+        set {
+            _solver.targetSpacing = newValue
+        }
+    }
+
+    public var targetDensity: Float {
+        get {
+            _solver.targetDensity
+        }
+        set {
+            _solver.targetDensity = newValue
+        }
+    }
+
+    /// Extra neighbor search distance relative to the kernel radius; neighbor lists are rebuilt once a particle moved half of it.
+    public var neighborSkin: Float {
+        get {
+            _solver.neighborSkin
+        }
+        set {
+            _solver.neighborSkin = newValue
+        }
+    }
+
+    public var viscosityCoefficient: Float {
+        get {
+            _solver.viscosityCoefficient
+        }
+        set {
+            _solver.viscosityCoefficient = newValue
+        }
+    }
+
+    public var speedOfSound: Float {
+        get {
+            _solver.speedOfSound
+        }
+        set {
+            _solver.speedOfSound = newValue
+        }
+    }
+
+    public var particleCount: Int {
+        Int(_solver.particleCount())
+    }
+
+    public var stepCount: Int {
+        Int(_solver.stepCount())
+    }
+
+    public var neighborListBuildCount: Int {
+        Int(_solver.neighborListBuildCount())
+    }
+
+    public func setDomain(lower: SIMD3<Float>, upper: SIMD3<Float>) {
+        _solver.setDomainLower(lower, upper: upper)
+    }
+
+    public func addBlock(lower: SIMD3<Float>, upper: SIMD3<Float>) {
+        _solver.addBlockLower(lower, upper: upper)
+    }
+
+    public func advance(_ timeIntervalInSeconds: Float) {
+        _solver.advance(timeIntervalInSeconds)
+    }
+
+    public var positions: [SIMD3<Float>] {
+        var positions = [SIMD3<Float>](repeating: .zero, count: particleCount)
+        _solver.getPositions(&positions)
+        return positions
+    }
+
+    public var densities: [Float] {
+        var densities = [Float](repeating: 0, count: particleCount)
+        _solver.getDensities(&densities)
+        return densities
+    }
+}
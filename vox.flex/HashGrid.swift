@@ -17,7 +17,7 @@ public class HashGrid {
     let _initArgsPass: ComputePass
     let _preparePass: ComputePass
     let _buildPass: ComputePass
-    let _sortPass: BitonicSort
+    let _sortPass: RadixSort
 
     public static func builder() -> Builder {
         HashGrid.Builder()
@@ -70,7 +70,7 @@ public class HashGrid {
         _buildPass.data.append(_shaderData)
         _buildPass.precompileAll()
 
-        _sortPass = BitonicSort()
+        _sortPass = RadixSort()
     }
 
     public func build(commandBuffer: MTLCommandBuffer, positions: BufferView,
@@ -78,7 +78,7 @@ public class HashGrid {
     {
         if _sortedIndices == nil || _sortedIndices.count != maxNumberOfParticles {
             _sortedIndices = BufferView(count: Int(maxNumberOfParticles),
-                                        stride: MemoryLayout<SIMD2<Float>>.stride, options: .storageModePrivate)
+                                        stride: MemoryLayout<SIMD2<UInt32>>.stride, options: .storageModePrivate)
             _shaderData.setData("u_sortedIndices", _sortedIndices!)
         }
         _shaderData.setData("u_positions", positions)
@@ -106,7 +106,9 @@ public class HashGrid {
 
         if let commandEncoder = commandBuffer.makeComputeCommandEncoder() {
             commandEncoder.label = "hash grid sort"
-            _sortPass.run(commandEncoder: commandEncoder, maxSize: UInt(maxNumberOfParticles), sortBuffer: _sortedIndices, itemCount: itemCount)
+            let keyBits = CPURadixSort.keyBits(for: _resolution.x * _resolution.y * _resolution.z)
+            _sortPass.run(commandEncoder: commandEncoder, maxSize: UInt(maxNumberOfParticles), keyBits: keyBits,
+                          sortBuffer: _sortedIndices, itemCount: itemCount)
             commandEncoder.endEncoding()
         }
 
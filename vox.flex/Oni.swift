@@ -63,6 +63,7 @@ public enum Oni {
         public enum Interpolation {
             case None
             case Interpolate
+            case Extrapolate
         }
 
         public enum Mode {
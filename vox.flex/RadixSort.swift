@@ -0,0 +1,102 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+import Metal
+import vox_render
+
+/// LSD radix sort of SIMD2<UInt32>(key, value) pairs, 4 bits per pass.
+/// The cost is linear in the item count and only the 4-bit digits covering the low `keyBits` bits are sorted,
+/// which suits hash grid keys bounded by the bucket count. CPURadixSort runs the same sort on the CPU.
+public class RadixSort {
+    let RADIX_BITS: UInt32 = 4
+    let RADIX = 16
+    let THREADGROUP_SIZE = 256
+    let SCAN_THREADGROUP_SIZE = 1024
+    let initArgsPass: ComputePass
+    let countPass: ComputePass
+    let scanPass: ComputePass
+    let scatterPass: ComputePass
+    let indirectSortArgsBuffer: BufferView
+    var scratchBuffer: BufferView?
+    var histogramBuffer: BufferView?
+
+    public init() {
+        indirectSortArgsBuffer = BufferView(count: 1,
+                                            stride: MemoryLayout<MTLDispatchThreadgroupsIndirectArguments>.stride)
+        initArgsPass = ComputePass()
+        initArgsPass.shader.append(ShaderPass(Engine.library("flex.shader"), "initRadixSortArgs"))
+        initArgsPass.threadsPerGridX = 1
+        initArgsPass.threadsPerGridY = 1
+        initArgsPass.threadsPerGridZ = 1
+        initArgsPass.defaultShaderData.setData("args", indirectSortArgsBuffer)
+        initArgsPass.precompileAll()
+
+        countPass = ComputePass()
+        countPass.shader.append(ShaderPass(Engine.library("flex.shader"), "radixSortCount"))
+        countPass.precompileAll()
+
+        scanPass = ComputePass()
+        scanPass.shader.append(ShaderPass(Engine.library("flex.shader"), "radixSortScan"))
+        scanPass.precompileAll()
+
+        scatterPass = ComputePass()
+        scatterPass.shader.append(ShaderPass(Engine.library("flex.shader"), "radixSortScatter"))
+        scatterPass.precompileAll()
+    }
+
+    /// Sorts `sortBuffer` in place by key. The pass count is rounded up to an even number so the
+    /// ping-pong between `sortBuffer` and the scratch buffer ends in `sortBuffer`.
+    public func run(commandEncoder: MTLComputeCommandEncoder, maxSize: UInt, keyBits: UInt32,
+                    sortBuffer: BufferView, itemCount: BufferView)
+    {
+        _allocate(maxSize)
+
+        initArgsPass.defaultShaderData.setData("g_NumElements", itemCount)
+        initArgsPass.compute(commandEncoder: commandEncoder, label: "init radix sort args")
+
+        var passCount = (keyBits + RADIX_BITS - 1) / RADIX_BITS
+        passCount += passCount % 2
+        var source = sortBuffer
+        var destination = scratchBuffer!
+        for pass in 0 ..< passCount {
+            var shift = pass * RADIX_BITS
+            commandEncoder.setBytes(&shift, length: MemoryLayout<UInt32>.stride, index: 4)
+
+            countPass.defaultShaderData.setData("g_NumElements", itemCount)
+            countPass.defaultShaderData.setData("Data", source)
+            countPass.defaultShaderData.setData("Histogram", histogramBuffer!)
+            countPass.compute(commandEncoder: commandEncoder, indirectBuffer: indirectSortArgsBuffer.buffer,
+                              threadsPerThreadgroup: MTLSize(width: THREADGROUP_SIZE, height: 1, depth: 1),
+                              label: "radix count")
+
+            scanPass.defaultShaderData.setData("g_NumElements", itemCount)
+            scanPass.defaultShaderData.setData("Histogram", histogramBuffer!)
+            scanPass.compute(commandEncoder: commandEncoder,
+                             threadgroupsPerGrid: MTLSize(width: 1, height: 1, depth: 1),
+                             threadsPerThreadgroup: MTLSize(width: SCAN_THREADGROUP_SIZE, height: 1, depth: 1),
+                             label: "radix scan")
+
+            scatterPass.defaultShaderData.setData("g_NumElements", itemCount)
+            scatterPass.defaultShaderData.setData("Data", source)
+            scatterPass.defaultShaderData.setData("Histogram", histogramBuffer!)
+            scatterPass.defaultShaderData.setData("Output", destination)
+            scatterPass.compute(commandEncoder: commandEncoder, indirectBuffer: indirectSortArgsBuffer.buffer,
+                                threadsPerThreadgroup: MTLSize(width: THREADGROUP_SIZE, height: 1, depth: 1),
+                                label: "radix scatter")
+            swap(&source, &destination)
+        }
+    }
+
+    private func _allocate(_ maxSize: UInt) {
+        if scratchBuffer == nil || scratchBuffer!.count < Int(maxSize) {
+            scratchBuffer = BufferView(count: Int(maxSize), stride: MemoryLayout<SIMD2<UInt32>>.stride,
+                                       options: .storageModePrivate)
+            let groupCount = (Int(maxSize) + THREADGROUP_SIZE - 1) / THREADGROUP_SIZE
+            histogramBuffer = BufferView(count: max(groupCount, 1) * RADIX, stride: MemoryLayout<UInt32>.stride,
+                                         options: .storageModePrivate)
+        }
+    }
+}
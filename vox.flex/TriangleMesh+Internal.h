@@ -0,0 +1,17 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "TriangleMesh.h"
+#include <vector>
+
+@interface TriangleMesh ()
+
+// Copies the loaded geometry as an indexed triangle list; triangle soups get sequential indices.
+- (void)copyPositions:(std::vector<simd_float3> &)positions indices:(std::vector<uint32_t> &)indices;
+
+@end
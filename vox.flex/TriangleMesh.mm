@@ -5,6 +5,7 @@
 //  property of any third parties.
 
 #import "TriangleMesh.h"
+#import "TriangleMesh+Internal.h"
 #include <vector>
 #import <fstream>
 #import <iostream>
@@ -204,6 +205,21 @@ struct Node {
     }
 }
 
+- (void)copyPositions:(std::vector<simd_float3> &)positions indices:(std::vector<uint32_t> &)indices {
+    positions.resize(_points.size());
+    for (size_t i = 0; i < _points.size(); ++i) {
+        positions[i] = simd_make_float3(_points[i][0], _points[i][1], _points[i][2]);
+    }
+    
+    const size_t triangleCount = [self triangleCount];
+    indices.resize(triangleCount * 3);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        for (size_t k = 0; k < 3; ++k) {
+            indices[i * 3 + k] = _pointIndices.empty() ? static_cast<uint32_t>(i * 3 + k) : _pointIndices[i][k];
+        }
+    }
+}
+
 // MARK: - Builder
 - (simd_float3)lowerBounds {
     [self prepare];
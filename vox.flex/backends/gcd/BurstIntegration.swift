@@ -16,17 +16,20 @@ public enum BurstIntegration {
         return (position - prevPosition) / dt
     }
 
-    public static func AngularVelocityToSpinQuaternion(rotation _: quaternion, angularVelocity _: float4, dt _: Float) -> quaternion
+    public static func AngularVelocityToSpinQuaternion(rotation: quaternion, angularVelocity: float4, dt: Float) -> quaternion
     {
-        quaternion()
+        let delta = quaternion(ix: angularVelocity.x, iy: angularVelocity.y, iz: angularVelocity.z, r: 0)
+        return quaternion(vector: (delta * rotation).vector * 0.5 * dt)
     }
 
-    public static func IntegrateAngular(rotation _: quaternion, angularVelocity _: float4, dt _: Float) -> quaternion
+    public static func IntegrateAngular(rotation: quaternion, angularVelocity: float4, dt: Float) -> quaternion
     {
-        quaternion()
+        let spin = AngularVelocityToSpinQuaternion(rotation: rotation, angularVelocity: angularVelocity, dt: dt)
+        return simd_normalize(quaternion(vector: rotation.vector + spin.vector))
     }
 
-    public static func DifferentiateAngular(rotation _: quaternion, prevRotation _: quaternion, dt _: Float) -> float4 {
-        float4()
+    public static func DifferentiateAngular(rotation: quaternion, prevRotation: quaternion, dt: Float) -> float4 {
+        let delta = rotation * prevRotation.inverse
+        return float4(delta.imag * 2 / dt, 0)
     }
 }
@@ -6,6 +6,7 @@
 
 import Math
 
+/// See BoxShape in ShapeDistanceFunctions.h for the native kernel, run by CPUParticleSolver.
 public struct BurstBox: IDistanceFunction, IBurstCollider {
     public func Evaluate(point _: float4, radii _: float4, orientation _: quaternion,
                          projectedPoint _: BurstLocalOptimization.SurfacePoint) {}
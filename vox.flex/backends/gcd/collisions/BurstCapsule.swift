@@ -6,6 +6,7 @@
 
 import Math
 
+/// See CapsuleShape in ShapeDistanceFunctions.h for the native kernel, run by CPUParticleSolver.
 public struct BurstCapsule: IDistanceFunction, IBurstCollider {
     public var shape: BurstColliderShape
     public var colliderToSolver: BurstAffineTransform
@@ -6,6 +6,7 @@
 
 import vox_render
 
+/// See CPUColliderWorld for the native implementation.
 public class BurstColliderWorld: Script {
     struct MovingCollider {
         public var oldSpan: BurstCellSpan
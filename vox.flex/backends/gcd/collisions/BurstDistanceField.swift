@@ -6,6 +6,7 @@
 
 import Math
 
+/// See DistanceFieldShape in ShapeDistanceFunctions.h for the native kernel, run by CPUParticleSolver.
 public struct BurstDistanceField: IDistanceFunction, IBurstCollider {
     public var shape: BurstColliderShape
     public var colliderToSolver: BurstAffineTransform
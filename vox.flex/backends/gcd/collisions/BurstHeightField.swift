@@ -6,6 +6,7 @@
 
 import Math
 
+/// See HeightFieldShape in ShapeDistanceFunctions.h and HeightField for the native kernel, run by CPUParticleSolver.
 public struct BurstHeightField: IDistanceFunction, IBurstCollider {
     public var shape: BurstColliderShape
     public var colliderToSolver: BurstAffineTransform
@@ -6,6 +6,7 @@
 
 import Math
 
+/// See LocalOptimization.h for the native implementation.
 public enum BurstLocalOptimization {
     /// point in the surface of a signed distance field.
     public struct SurfacePoint {
@@ -6,6 +6,7 @@
 
 import Math
 
+/// See SphereShape in ShapeDistanceFunctions.h for the native kernel, run by CPUParticleSolver.
 public struct BurstSphere: IDistanceFunction, IBurstCollider {
     public var shape: BurstColliderShape
     public var colliderToSolver: BurstAffineTransform
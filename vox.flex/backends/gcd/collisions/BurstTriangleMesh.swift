@@ -6,6 +6,8 @@
 
 import Math
 
+/// See TriangleMeshShape in ShapeDistanceFunctions.h and TriangleMeshContainer for the native kernel, run by
+/// CPUParticleSolver.
 public struct BurstTriangleMesh: IDistanceFunction, IBurstCollider {
     public var shape: BurstColliderShape
     public var colliderToSolver: BurstAffineTransform
@@ -13,12 +13,16 @@ public class BurstConstraintsBatchImpl: IConstraintsBatchImpl {
     var m_Enabled = true
     var m_ConstraintCount = 0
 
+    /// native batch the constraints are solved by, set by the concrete batch types.
+    var m_NativeBatch: CConstraintsBatch?
+
     public var constraintType: Oni.ConstraintType { return m_ConstraintType }
 
     public var enabled: Bool {
         set {
             if m_Enabled != newValue {
                 m_Enabled = newValue
+                m_NativeBatch?.enabled = newValue
             }
         }
         get { return m_Enabled }
@@ -38,7 +42,10 @@ public class BurstConstraintsBatchImpl: IConstraintsBatchImpl {
     public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
     public func Apply(substepTime _: Float) {}
 
-    public func Destroy() {}
+    public func Destroy() {
+        m_NativeBatch?.destroy()
+        m_NativeBatch = nil
+    }
 
     public func SetConstraintCount(constraintCount: Int) {
         m_ConstraintCount = constraintCount
@@ -6,37 +6,29 @@
 
 import Math
 
+/// Aerodynamic forces are applied by the native solver at the start of every Substep, per deformable triangle, see
+/// CAerodynamicConstraintsBatch.
 public class BurstAerodynamicConstraintsBatch: BurstConstraintsBatchImpl, IAerodynamicConstraintsBatchImpl
 {
-    private var aerodynamicCoeffs: [Float] = []
+    private let m_Batch: CAerodynamicConstraintsBatch
 
     public init(constraints: BurstAerodynamicConstraints) {
+        m_Batch = CAerodynamicConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.Aerodynamics
+        m_NativeBatch = m_Batch
     }
 
-    public func SetAerodynamicConstraints(particleIndices _: [Int], aerodynamicCoeffs _: [Float], count _: Int) {}
+    public func SetAerodynamicConstraints(particleIndices: [Int], aerodynamicCoeffs: [Float], count: Int) {
+        self.particleIndices = particleIndices
+        SetConstraintCount(constraintCount: count)
 
-    override public func Initialize(substepTime _: Float) {}
+        let indices = particleIndices.prefix(count).map { Int32($0) }
+        m_Batch.setAerodynamicConstraints(indices, aerodynamicCoeffs: aerodynamicCoeffs, count: UInt32(count))
+    }
 
     override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
     override public func Apply(substepTime _: Float) {}
-
-    public struct AerodynamicConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var aerodynamicCoeffs: [Float]
-
-        public private(set) var positions: [float4]
-        public private(set) var normals: [float4]
-        public private(set) var wind: [float4]
-        public private(set) var invMasses: [Float]
-
-        public private(set) var velocities: [float4]
-
-        public private(set) var deltaTime: Float
-
-        public func Execute(i _: Int) {}
-    }
 }
@@ -6,53 +6,41 @@
 
 import Math
 
+/// Bend / twist constraints are projected by the native solver during Substep, see CBendTwistConstraintsBatch.
 public class BurstBendTwistConstraintsBatch: BurstConstraintsBatchImpl, IBendTwistConstraintsBatchImpl
 {
-    private var orientationIndices: [Int] = []
-    private var restDarboux: [quaternion] = []
-    private var stiffnesses: [float3] = []
-    private var plasticity: [float2] = []
+    private let m_Batch: CBendTwistConstraintsBatch
 
     public init(constraints: BurstBendTwistConstraints) {
+        m_Batch = CBendTwistConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.BendTwist
+        m_NativeBatch = m_Batch
     }
 
-    public func SetBendTwistConstraints(orientationIndices _: [Int], restDarboux _: [Quaternion],
-                                        stiffnesses _: [Vector3], plasticity _: [Vector2],
-                                        lambdas _: [Float], count _: Int) {}
+    public func SetBendTwistConstraints(orientationIndices: [Int], restDarboux: [Quaternion],
+                                        stiffnesses: [Vector3], plasticity: [Vector2],
+                                        lambdas: [Float], count: Int)
+    {
+        particleIndices = orientationIndices
+        self.lambdas = lambdas
+        SetConstraintCount(constraintCount: count)
+
+        let indices = orientationIndices.prefix(count * 2).map { Int32($0) }
+        let restDarboux = restDarboux.prefix(count).map { $0.internalValue }
+        let compliances = stiffnesses.prefix(count).flatMap { [$0.x, $0.y, $0.z] }
+        let plasticity = plasticity.prefix(count).map { SIMD2<Float>($0.x, $0.y) }
+        if lambdas.count >= count * 3 {
+            m_Batch.setBendTwistConstraints(indices, restDarboux: restDarboux, stiffnesses: compliances,
+                                            plasticity: plasticity, lambdas: lambdas, count: UInt32(count))
+        } else {
+            m_Batch.setBendTwistConstraints(indices, restDarboux: restDarboux, stiffnesses: compliances,
+                                            plasticity: plasticity, lambdas: nil, count: UInt32(count))
+        }
+    }
 
     override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
     override public func Apply(substepTime _: Float) {}
-
-    public struct BendTwistConstraintsBatchJob {
-        public private(set) var orientationIndices: [Int]
-        public private(set) var stiffnesses: [float3]
-        public private(set) var plasticity: [float2]
-        public var restDarboux: [quaternion]
-        public var lambdas: [float3]
-
-        public private(set) var orientations: [quaternion]
-        public private(set) var invRotationalMasses: [Float]
-
-        public var orientationDeltas: [quaternion]
-        public var orientationCounts: [Int]
-
-        public private(set) var deltaTime: Float
-
-        public func Execute(i _: Int) {}
-    }
-
-    public struct ApplyBendTwistConstraintsBatchJob {
-        public private(set) var orientationIndices: [Int]
-        public private(set) var sorFactor: Float
-
-        public var orientations: [quaternion]
-        public var orientationDeltas: [quaternion]
-        public var orientationCounts: [Int]
-
-        public func Execute(i _: Int) {}
-    }
 }
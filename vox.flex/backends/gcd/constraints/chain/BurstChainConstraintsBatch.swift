@@ -6,49 +6,33 @@
 
 import Math
 
+/// Chains are solved directly by the native solver during Substep, see CChainConstraintsBatch.
 public class BurstChainConstraintsBatch: BurstConstraintsBatchImpl, IChainConstraintsBatchImpl {
-    private var firstIndex: [Int] = []
-    private var numIndices: [Int] = []
-    private var restLengths: [float2] = []
+    private let m_Batch: CChainConstraintsBatch
 
     public init(constraints: BurstChainConstraints) {
+        m_Batch = CChainConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.Chain
+        m_NativeBatch = m_Batch
     }
 
-    public func SetChainConstraints(particleIndices _: [Int], restLengths _: [Vector2],
-                                    firstIndex _: [Int], numIndex _: [Int], count _: Int) {}
+    public func SetChainConstraints(particleIndices: [Int], restLengths: [Vector2],
+                                    firstIndex: [Int], numIndex: [Int], count: Int)
+    {
+        self.particleIndices = particleIndices
+        SetConstraintCount(constraintCount: count)
+
+        let indices = particleIndices.map { Int32($0) }
+        let restLengths = restLengths.prefix(count).map { SIMD2<Float>($0.x, $0.y) }
+        let firstIndex = firstIndex.prefix(count).map { Int32($0) }
+        let numIndices = numIndex.prefix(count).map { Int32($0) }
+        m_Batch.setChainConstraints(indices, restLengths: restLengths, firstIndex: firstIndex,
+                                    numIndices: numIndices, count: UInt32(count))
+    }
 
     override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
     override public func Apply(substepTime _: Float) {}
-
-    public struct ChainConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var firstIndex: [Int]
-        public private(set) var numIndices: [Int]
-        public private(set) var restLengths: [float2]
-
-        public private(set) var positions: [float4]
-        public private(set) var invMasses: [Float]
-
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public func Execute(c _: Int) {}
-    }
-
-    public struct ApplyChainConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var firstIndex: [Int]
-        public private(set) var numIndices: [Int]
-        public private(set) var sorFactor: Float
-
-        public var positions: [float4]
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public func Execute(i _: Int) {}
-    }
 }
@@ -6,52 +6,51 @@
 
 import Math
 
+/// Distance constraints are projected by the native solver during Substep, see CDistanceConstraintsBatch.
 public class BurstDistanceConstraintsBatch: BurstConstraintsBatchImpl, IDistanceConstraintsBatchImpl
 {
-    private var restLengths: [Float] = []
-    private var stiffnesses: [float2] = []
-
-    var projectConstraints = DistanceConstraintsBatchJob()
-    var applyConstraints = ApplyDistanceConstraintsBatchJob()
+    private let m_Batch: CDistanceConstraintsBatch
 
     public init(constraints: BurstDistanceConstraints) {
+        m_Batch = CDistanceConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.Distance
+        m_NativeBatch = m_Batch
     }
 
-    public func SetDistanceConstraints(particleIndices _: [Int], restLengths _: [Float],
-                                       stiffnesses _: [Vector2], lambdas _: [Float], count _: Int) {}
-
-    override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
-
-    override public func Apply(substepTime _: Float) {}
-
-    public struct DistanceConstraintsBatchJob {
-        public private(set) var particleIndices: [Int] = []
-        public private(set) var restLengths: [Float] = []
-        public private(set) var stiffnesses: [float2] = []
-        public var lambdas: [Float] = []
-
-        public private(set) var positions: [float4] = []
-        public private(set) var invMasses: [Float] = []
-
-        public var deltas: [float4] = []
-        public var counts: [Int] = []
-
-        public private(set) var deltaTimeSqr: Float = 0
-
-        public func Execute(i _: Int) {}
+    public func SetDistanceConstraints(particleIndices: [Int], restLengths: [Float],
+                                       stiffnesses: [Vector2], lambdas: [Float], count: Int)
+    {
+        precondition(particleIndices.count >= count * 2 && restLengths.count >= count && stiffnesses.count >= count,
+                     "distance constraint arrays shorter than the constraint count")
+        precondition(lambdas.isEmpty || lambdas.count >= count, "lambdas are either empty or one per constraint")
+        self.particleIndices = particleIndices
+        self.lambdas = lambdas
+        SetConstraintCount(constraintCount: count)
+
+        let indices = particleIndices.prefix(count * 2).map { Int32($0) }
+        let stiffnesses = stiffnesses.prefix(count).map { SIMD2<Float>($0.x, $0.y) }
+        if !lambdas.isEmpty {
+            m_Batch.setDistanceConstraints(indices, restLengths: restLengths, stiffnesses: stiffnesses,
+                                           lambdas: lambdas, count: UInt32(count))
+        } else {
+            m_Batch.setDistanceConstraints(indices, restLengths: restLengths, stiffnesses: stiffnesses,
+                                           lambdas: nil, count: UInt32(count))
+        }
     }
 
-    public struct ApplyDistanceConstraintsBatchJob {
-        public private(set) var particleIndices: [Int] = []
-        public private(set) var sorFactor: Float = 0
+    public func GetLambdas(lambdas: inout [Float]) {
+        if lambdas.count != m_ConstraintCount {
+            lambdas = [Float](repeating: 0, count: m_ConstraintCount)
+        }
+        if m_ConstraintCount > 0 {
+            m_Batch.getLambdas(&lambdas)
+        }
+        self.lambdas = lambdas
+    }
 
-        public var positions: [float4] = []
-        public var deltas: [float4] = []
-        public var counts: [Int] = []
+    override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
-        public func Execute(i _: Int) {}
-    }
+    override public func Apply(substepTime _: Float) {}
 }
@@ -6,111 +6,55 @@
 
 import Math
 
+/// Shape matching clusters are projected by the native solver during Substep, see CShapeMatchingConstraintsBatch.
 public class BurstShapeMatchingConstraintsBatch: BurstConstraintsBatchImpl, IShapeMatchingConstraintsBatchImpl
 {
-    private var firstIndex: [Int] = []
-    private var numIndices: [Int] = []
-    private var explicitGroup: [Int] = []
-    private var shapeMaterialParameters: [Float] = []
-    private var restComs: [float4] = []
-    private var coms: [float4] = []
-    private var constraintOrientations: [quaternion] = []
-
-    private var Aqq: [float4x4] = []
-    private var linearTransforms: [float4x4] = []
-    private var plasticDeformations: [float4x4] = []
+    private let m_Batch: CShapeMatchingConstraintsBatch
 
     public init(constraints: BurstShapeMatchingConstraints) {
+        m_Batch = CShapeMatchingConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.ShapeMatching
+        m_NativeBatch = m_Batch
     }
 
-    public func SetShapeMatchingConstraints(particleIndices _: [Int], firstIndex _: [Int],
-                                            numIndices _: [Int], explicitGroup _: [Int], shapeMaterialParameters _: [Float],
-                                            restComs _: [Vector4], coms _: [Vector4], orientations _: [Quaternion],
-                                            linearTransforms _: [Matrix], plasticDeformations _: [Matrix],
-                                            lambdas _: [Float], count _: Int) {}
-
-    public func CalculateRestShapeMatching() {}
-
-    override public func Initialize(substepTime _: Float) {}
-
-    override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
-
-    override public func Apply(substepTime _: Float) {}
-
-    static func RecalculateRestData(i _: Int,
-                                    particleIndices _: [Int],
-                                    firstIndex _: [Int],
-                                    restComs _: [float4],
-                                    Aqq _: [float4x4],
-                                    deformation _: [float4x4],
-                                    numIndices _: [Int],
-                                    invMasses _: [Float],
-                                    restPositions _: [float4],
-                                    restOrientations _: [quaternion],
-                                    invInertiaTensors _: [float4]) {}
-
-    public struct ShapeMatchingCalculateRestJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var firstIndex: [Int]
-        public private(set) var numIndices: [Int]
-        public var restComs: [float4]
-        public private(set) var coms: [float4]
-
-        public var Aqq: [float4x4]
-        public private(set) var deformation: [float4x4]
-
-        public private(set) var restPositions: [float4]
-        public private(set) var restOrientations: [quaternion]
-        public private(set) var invMasses: [Float]
-        public private(set) var invInertiaTensors: [float4]
-
-        public func Execute(i _: Int) {}
+    public func SetShapeMatchingConstraints(particleIndices: [Int], firstIndex: [Int],
+                                            numIndices: [Int], explicitGroup: [Int], shapeMaterialParameters: [Float],
+                                            restComs _: [Vector4], coms _: [Vector4], orientations: [Quaternion],
+                                            linearTransforms _: [Matrix], plasticDeformations: [Matrix],
+                                            lambdas: [Float], count: Int)
+    {
+        self.particleIndices = particleIndices
+        self.lambdas = lambdas
+        SetConstraintCount(constraintCount: count)
+
+        // centers of mass and linear transforms are derived from the rest positions by the native batch.
+        let indices = particleIndices.map { Int32($0) }
+        let firstIndex = firstIndex.prefix(count).map { Int32($0) }
+        let numIndices = numIndices.prefix(count).map { Int32($0) }
+        let explicitGroup = explicitGroup.prefix(count).map { Int32($0) }
+        // warm start rotations and plastic deformations are optional.
+        let rotations = orientations.prefix(count).map { $0.internalValue }
+        let deformations = plasticDeformations.prefix(count).map { $0.elements }
+        rotations.withUnsafeBufferPointer { rotations in
+            deformations.withUnsafeBufferPointer { deformations in
+                let rotations = rotations.count == count ? rotations.baseAddress : nil
+                let deformations = deformations.count == count ? deformations.baseAddress : nil
+                m_Batch.setShapeMatchingConstraints(indices, firstIndex: firstIndex, numIndices: numIndices,
+                                                    explicitGroup: explicitGroup,
+                                                    materialParameters: shapeMaterialParameters,
+                                                    orientations: rotations, plasticDeformations: deformations,
+                                                    count: UInt32(count))
+            }
+        }
     }
 
-    public struct ShapeMatchingConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var firstIndex: [Int]
-        public private(set) var numIndices: [Int]
-        public private(set) var explicitGroup: [Int]
-        public private(set) var shapeMaterialParameters: [Float]
-        public var restComs: [float4]
-        public var coms: [float4]
-        public var constraintOrientations: [quaternion]
-
-        public var Aqq: [float4x4]
-        public var linearTransforms: [float4x4]
-        public var deformation: [float4x4]
-
-        public private(set) var positions: [float4]
-        public private(set) var restPositions: [float4]
-
-        public private(set) var restOrientations: [quaternion]
-        public private(set) var invMasses: [Float]
-        public private(set) var invRotationalMasses: [Float]
-        public private(set) var invInertiaTensors: [float4]
-
-        public var orientations: [quaternion]
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public var deltaTime: Float
-
-        public func Execute(i _: Int) {}
+    public func CalculateRestShapeMatching() {
+        m_Batch.calculateRestShapeMatching()
     }
 
-    public struct ApplyShapeMatchingConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var firstIndex: [Int]
-        public private(set) var numIndices: [Int]
-        public private(set) var sorFactor: Float
-
-        public var positions: [float4]
-        public var deltas: [float4]
-        public var counts: [Int]
+    override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
-        public func Execute(i _: Int) {}
-    }
+    override public func Apply(substepTime _: Float) {}
 }
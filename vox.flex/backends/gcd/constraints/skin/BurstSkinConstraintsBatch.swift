@@ -6,53 +6,50 @@
 
 import Math
 
+/// Skin constraints are projected by the native solver during Substep, see CSkinConstraintsBatch.
 public class BurstSkinConstraintsBatch: BurstConstraintsBatchImpl, ISkinConstraintsBatchImpl {
-    private var skinPoints: [float4] = []
-    private var skinNormals: [float4] = []
-    private var skinRadiiBackstop: [Float] = []
-    private var skinCompliance: [Float] = []
+    private let m_Batch: CSkinConstraintsBatch
 
     public init(constraints: BurstSkinConstraints) {
+        m_Batch = CSkinConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.Skin
+        m_NativeBatch = m_Batch
     }
 
-    public func SetSkinConstraints(particleIndices _: [Int], skinPoints _: [Vector4],
-                                   skinNormals _: [Vector4], skinRadiiBackstop _: [Float],
-                                   skinCompliance _: [Float], lambdas _: [Float], count _: Int) {}
-
-    override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
-
-    override public func Apply(substepTime _: Float) {}
-
-    public struct SkinConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var skinPoints: [float4]
-        public private(set) var skinNormals: [float4]
-        public private(set) var skinRadiiBackstop: [float3]
-        public private(set) var skinCompliance: [Float]
-        public var lambdas: [Float]
-
-        public private(set) var positions: [float4]
-        public private(set) var invMasses: [Float]
-
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public private(set) var deltaTimeSqr: Float
-
-        public func Execute(i _: Int) {}
+    public func SetSkinConstraints(particleIndices: [Int], skinPoints: [Vector4],
+                                   skinNormals: [Vector4], skinRadiiBackstop: [Float],
+                                   skinCompliance: [Float], lambdas: [Float], count: Int)
+    {
+        self.particleIndices = particleIndices
+        self.lambdas = lambdas
+        SetConstraintCount(constraintCount: count)
+
+        let indices = particleIndices.prefix(count).map { Int32($0) }
+        let points = skinPoints.prefix(count).map { $0.internalValue }
+        let normals = skinNormals.prefix(count).map { $0.internalValue }
+        if lambdas.count >= count {
+            m_Batch.setSkinConstraints(indices, skinPoints: points, skinNormals: normals,
+                                       radiiBackstop: skinRadiiBackstop, stiffnesses: skinCompliance,
+                                       lambdas: lambdas, count: UInt32(count))
+        } else {
+            m_Batch.setSkinConstraints(indices, skinPoints: points, skinNormals: normals,
+                                       radiiBackstop: skinRadiiBackstop, stiffnesses: skinCompliance,
+                                       lambdas: nil, count: UInt32(count))
+        }
     }
 
-    public struct ApplySkinConstraintsBatchJob {
-        private(set) var particleIndices: [Int]
-        public private(set) var sorFactor: Float
+    /// Reads the skin targets straight from a skinned vertex buffer in solver space instead of the points and normals
+    /// set above, through `vertexIndices` (one per constraint) or in constraint order. The buffers are borrowed and
+    /// must outlive the binding; pass nil positions to unbind.
+    public func BindSkinnedVertices(positions: UnsafePointer<SIMD4<Float>>?, normals: UnsafePointer<SIMD4<Float>>?,
+                                    vertexIndices: UnsafePointer<Int32>?)
+    {
+        m_Batch.bindSkinnedVertices(positions, normals: normals, vertexIndices: vertexIndices)
+    }
 
-        public var positions: [float4]
-        public var deltas: [float4]
-        public var counts: [Int]
+    override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
-        public func Execute(i _: Int) {}
-    }
+    override public func Apply(substepTime _: Float) {}
 }
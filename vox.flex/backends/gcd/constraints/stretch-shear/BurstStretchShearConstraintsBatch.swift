@@ -6,63 +6,43 @@
 
 import Math
 
+/// Stretch / shear constraints are projected by the native solver during Substep, see CStretchShearConstraintsBatch.
 public class BurstStretchShearConstraintsBatch: BurstConstraintsBatchImpl, IStretchShearConstraintsBatchImpl
 {
-    private var orientationIndices: [Int] = []
-    private var restLengths: [Float] = []
-    private var restOrientations: [quaternion] = []
-    private var stiffnesses: [float3] = []
+    private let m_Batch: CStretchShearConstraintsBatch
 
     public init(constraints: BurstStretchShearConstraints) {
+        m_Batch = CStretchShearConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.StretchShear
+        m_NativeBatch = m_Batch
     }
 
-    public func SetStretchShearConstraints(particleIndices _: [Int], orientationIndices _: [Int],
-                                           restLengths _: [Float], restOrientations _: [Quaternion],
-                                           stiffnesses _: [Vector3], lambdas _: [Float], count _: Int) {}
+    public func SetStretchShearConstraints(particleIndices: [Int], orientationIndices: [Int],
+                                           restLengths: [Float], restOrientations: [Quaternion],
+                                           stiffnesses: [Vector3], lambdas: [Float], count: Int)
+    {
+        self.particleIndices = particleIndices
+        self.lambdas = lambdas
+        SetConstraintCount(constraintCount: count)
+
+        let indices = particleIndices.prefix(count * 2).map { Int32($0) }
+        let orientationIndices = orientationIndices.prefix(count).map { Int32($0) }
+        let restOrientations = restOrientations.prefix(count).map { $0.internalValue }
+        let compliances = stiffnesses.prefix(count).flatMap { [$0.x, $0.y, $0.z] }
+        if lambdas.count >= count * 3 {
+            m_Batch.setStretchShearConstraints(indices, orientationIndices: orientationIndices,
+                                               restLengths: restLengths, restOrientations: restOrientations,
+                                               stiffnesses: compliances, lambdas: lambdas, count: UInt32(count))
+        } else {
+            m_Batch.setStretchShearConstraints(indices, orientationIndices: orientationIndices,
+                                               restLengths: restLengths, restOrientations: restOrientations,
+                                               stiffnesses: compliances, lambdas: nil, count: UInt32(count))
+        }
+    }
 
     override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
     override public func Apply(substepTime _: Float) {}
-
-    public struct StretchShearConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var orientationIndices: [Int]
-        public private(set) var restLengths: [Float]
-        public private(set) var restOrientations: [quaternion]
-        public private(set) var stiffnesses: [float3]
-        public var lambdas: [float3]
-
-        public private(set) var positions: [float4]
-        public private(set) var orientations: [quaternion]
-        public private(set) var invMasses: [Float]
-        public private(set) var invRotationalMasses: [Float]
-
-        public var deltas: [float4]
-        public var orientationDeltas: [quaternion]
-        public var counts: [Int]
-        public var orientationCounts: [Int]
-
-        public private(set) var deltaTimeSqr: Float
-
-        public func Execute(i _: Int) {}
-    }
-
-    public struct ApplyStretchShearConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var orientationIndices: [Int]
-        public private(set) var sorFactor: Float
-
-        public var positions: [float4]
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public var orientations: [quaternion]
-        public var orientationDeltas: [quaternion]
-        public var orientationCounts: [Int]
-
-        public func Execute(i _: Int) {}
-    }
 }
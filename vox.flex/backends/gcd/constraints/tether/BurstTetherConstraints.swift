@@ -8,7 +8,7 @@ import Math
 
 public class BurstTetherConstraints: BurstConstraintsImpl<BurstTetherConstraintsBatch> {
     public init(solver: BurstSolverImpl) {
-        super.init(solver: solver, constraintType: Oni.ConstraintType.Distance)
+        super.init(solver: solver, constraintType: Oni.ConstraintType.Tether)
     }
 
     override public func CreateConstraintsBatch() -> IConstraintsBatchImpl {
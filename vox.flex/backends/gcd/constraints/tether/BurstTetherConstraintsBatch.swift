@@ -6,50 +6,37 @@
 
 import Math
 
+/// Tethers are projected by the native solver during Substep, see CTetherConstraintsBatch.
 public class BurstTetherConstraintsBatch: BurstConstraintsBatchImpl, ITetherConstraintsBatchImpl {
-    private var maxLengthScale: [float2] = []
-    private var stiffnesses: [Float] = []
+    private let m_Batch: CTetherConstraintsBatch
 
     public init(constraints: BurstTetherConstraints) {
+        m_Batch = CTetherConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.Tether
+        m_NativeBatch = m_Batch
     }
 
-    public func SetTetherConstraints(particleIndices _: [Int], maxLengthScale _: [Vector2],
-                                     stiffnesses _: [Float], lambdas _: [Float], count _: Int) {}
+    public func SetTetherConstraints(particleIndices: [Int], maxLengthScale: [Vector2],
+                                     stiffnesses: [Float], lambdas: [Float], count: Int)
+    {
+        self.particleIndices = particleIndices
+        self.lambdas = lambdas
+        SetConstraintCount(constraintCount: count)
+
+        let indices = particleIndices.prefix(count * 2).map { Int32($0) }
+        let maxLengthScale = maxLengthScale.prefix(count).map { SIMD2<Float>($0.x, $0.y) }
+        if lambdas.count >= count {
+            m_Batch.setTetherConstraints(indices, maxLengthScale: maxLengthScale, stiffnesses: stiffnesses,
+                                         lambdas: lambdas, count: UInt32(count))
+        } else {
+            m_Batch.setTetherConstraints(indices, maxLengthScale: maxLengthScale, stiffnesses: stiffnesses,
+                                         lambdas: nil, count: UInt32(count))
+        }
+    }
 
     override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
     override public func Apply(substepTime _: Float) {}
-
-    public struct TetherConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-        public private(set) var maxLengthScale: [float2]
-        public private(set) var stiffnesses: [Float]
-        public var lambdas: [Float]
-
-        public private(set) var positions: [float4]
-        public private(set) var invMasses: [Float]
-
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public private(set) var deltaTimeSqr: Float
-
-        public func Execute(i _: Int) {}
-    }
-
-    public struct ApplyTetherConstraintsBatchJob {
-        public private(set) var particleIndices: [Int]
-
-        // linear/position properties:
-        public var positions: [float4]
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public private(set) var sorFactor: Float
-
-        public func Execute(index _: Int) {}
-    }
 }
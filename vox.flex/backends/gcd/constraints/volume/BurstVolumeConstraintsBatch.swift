@@ -6,55 +6,41 @@
 
 import Math
 
+/// Volume constraints are projected by the native solver during Substep, see CVolumeConstraintsBatch.
 public class BurstVolumeConstraintsBatch: BurstConstraintsBatchImpl, IVolumeConstraintsBatchImpl {
-    private var firstTriangle: [Int] = []
-    private var numTriangles: [Int] = []
-    private var restVolumes: [Float] = []
-    private var pressureStiffness: [float2] = []
+    private let m_Batch: CVolumeConstraintsBatch
 
     public init(constraints: BurstVolumeConstraints) {
+        m_Batch = CVolumeConstraintsBatch(solver: (constraints.solver as! BurstSolverImpl).m_Native)
         super.init()
         m_Constraints = constraints
         m_ConstraintType = Oni.ConstraintType.Volume
+        m_NativeBatch = m_Batch
     }
 
-    public func SetVolumeConstraints(triangles _: [Int], firstTriangle _: [Int], numTriangles _: [Int],
-                                     restVolumes _: [Float], pressureStiffness _: [Vector2], lambdas _: [Float], count _: Int) {}
+    public func SetVolumeConstraints(triangles: [Int], firstTriangle: [Int], numTriangles: [Int],
+                                     restVolumes: [Float], pressureStiffness: [Vector2], lambdas: [Float], count: Int)
+    {
+        particleIndices = triangles
+        self.lambdas = lambdas
+        SetConstraintCount(constraintCount: count)
+
+        let pressureStiffness = pressureStiffness.prefix(count).map { SIMD2<Float>($0.x, $0.y) }
+        let firstTriangle = firstTriangle.prefix(count).map { Int32($0) }
+        let numTriangles = numTriangles.prefix(count).map { Int32($0) }
+        let triangles = triangles.map { Int32($0) }
+        if lambdas.count >= count {
+            m_Batch.setVolumeConstraints(triangles, firstTriangle: firstTriangle, numTriangles: numTriangles,
+                                         restVolumes: restVolumes, pressureStiffness: pressureStiffness,
+                                         lambdas: lambdas, count: UInt32(count))
+        } else {
+            m_Batch.setVolumeConstraints(triangles, firstTriangle: firstTriangle, numTriangles: numTriangles,
+                                         restVolumes: restVolumes, pressureStiffness: pressureStiffness,
+                                         lambdas: nil, count: UInt32(count))
+        }
+    }
 
     override public func Evaluate(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
 
     override public func Apply(substepTime _: Float) {}
-
-    public struct VolumeConstraintsBatchJob {
-        public private(set) var triangles: [Int]
-        public private(set) var firstTriangle: [Int]
-        public private(set) var numTriangles: [Int]
-        public private(set) var restVolumes: [Float]
-        public private(set) var pressureStiffness: [float2]
-        public var lambdas: [Float]
-
-        public private(set) var positions: [float4]
-        public private(set) var invMasses: [Float]
-
-        public var gradients: [float4]
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public var deltaTimeSqr: Float
-
-        public func Execute(i _: Int) {}
-    }
-
-    public struct ApplyVolumeConstraintsBatchJob {
-        public private(set) var triangles: [Int]
-        public private(set) var firstTriangle: [Int]
-        public private(set) var numTriangles: [Int]
-        public private(set) var sorFactor: Float
-
-        public var positions: [float4]
-        public var deltas: [float4]
-        public var counts: [Int]
-
-        public func Execute(i _: Int) {}
-    }
 }
@@ -21,49 +21,56 @@ public struct BurstAffineTransform {
         self.scale[3] = 1
     }
 
-    public static func * (_: BurstAffineTransform, _: BurstAffineTransform) -> BurstAffineTransform {
-        BurstAffineTransform(translation: float4(), rotation: quaternion(), scale: float4())
+    public static func * (a: BurstAffineTransform, b: BurstAffineTransform) -> BurstAffineTransform {
+        BurstAffineTransform(translation: a.TransformPoint(point: b.translation),
+                             rotation: a.rotation * b.rotation, scale: a.scale * b.scale)
     }
 
+    /// exact for uniform scales, as Obi's.
     public func Inverse() -> BurstAffineTransform {
-        BurstAffineTransform(translation: float4(), rotation: quaternion(), scale: float4())
+        let inverseRotation = rotation.conjugate
+        let inverseScale = 1 / scale
+        return BurstAffineTransform(translation: float4(inverseRotation.act(-translation.xyz) * inverseScale.xyz, 0),
+                                    rotation: inverseRotation, scale: inverseScale)
     }
 
-    public func Interpolate(other _: BurstAffineTransform, translationalMu _: Float,
-                            rotationalMu _: Float, scaleMu _: Float) -> BurstAffineTransform
+    public func Interpolate(other: BurstAffineTransform, translationalMu: Float,
+                            rotationalMu: Float, scaleMu: Float) -> BurstAffineTransform
     {
-        BurstAffineTransform(translation: float4(), rotation: quaternion(), scale: float4())
+        BurstAffineTransform(translation: simd_mix(translation, other.translation, float4(repeating: translationalMu)),
+                             rotation: simd_slerp(rotation, other.rotation, rotationalMu),
+                             scale: simd_mix(scale, other.scale, float4(repeating: scaleMu)))
     }
 
-    public func TransformPoint(point _: float4) -> float4 {
-        float4()
+    public func TransformPoint(point: float4) -> float4 {
+        float4(translation.xyz + rotation.act(point.xyz * scale.xyz), 0)
     }
 
-    public func InverseTransformPoint(point _: float4) -> float4 {
-        float4()
+    public func InverseTransformPoint(point: float4) -> float4 {
+        float4(rotation.conjugate.act(point.xyz - translation.xyz) / scale.xyz, 0)
     }
 
-    public func TransformPointUnscaled(point _: float4) -> float4 {
-        float4()
+    public func TransformPointUnscaled(point: float4) -> float4 {
+        float4(translation.xyz + rotation.act(point.xyz), 0)
     }
 
-    public func InverseTransformPointUnscaled(point _: float4) -> float4 {
-        float4()
+    public func InverseTransformPointUnscaled(point: float4) -> float4 {
+        float4(rotation.conjugate.act(point.xyz - translation.xyz), 0)
     }
 
-    public func TransformDirection(direction _: float4) -> float4 {
-        float4()
+    public func TransformDirection(direction: float4) -> float4 {
+        float4(rotation.act(direction.xyz), 0)
     }
 
-    public func InverseTransformDirection(direction _: float4) -> float4 {
-        float4()
+    public func InverseTransformDirection(direction: float4) -> float4 {
+        float4(rotation.conjugate.act(direction.xyz), 0)
     }
 
-    public func TransformVector(vector _: float4) -> float4 {
-        float4()
+    public func TransformVector(vector: float4) -> float4 {
+        float4(rotation.act(vector.xyz * scale.xyz), 0)
     }
 
-    public func InverseTransformVector(vector _: float4) -> float4 {
-        float4()
+    public func InverseTransformVector(vector: float4) -> float4 {
+        float4(rotation.conjugate.act(vector.xyz) / scale.xyz, 0)
     }
 }
@@ -36,5 +36,22 @@ public struct BurstInertialFrame {
         angularAcceleration = float4.zero
     }
 
-    public func Update(position _: float4, scale _: float4, rotation _: quaternion, dt _: Float) {}
+    /// Moves the frame to its new world transform `dt` seconds after the last one, see InertialFrame.
+    public mutating func Update(position: float4, scale: float4, rotation: quaternion, dt: Float) {
+        prevFrame = frame
+        let prevVelocity = velocity
+        let prevAngularVelocity = angularVelocity
+
+        frame = BurstAffineTransform(translation: position, rotation: rotation, scale: scale)
+        guard dt > 0 else {
+            return
+        }
+        velocity = BurstIntegration.DifferentiateLinear(position: frame.translation,
+                                                        prevPosition: prevFrame.translation, dt: dt)
+        angularVelocity = BurstIntegration.DifferentiateAngular(rotation: frame.rotation,
+                                                                prevRotation: prevFrame.rotation, dt: dt)
+        acceleration = BurstIntegration.DifferentiateLinear(position: velocity, prevPosition: prevVelocity, dt: dt)
+        angularAcceleration = BurstIntegration.DifferentiateLinear(position: angularVelocity,
+                                                                   prevPosition: prevAngularVelocity, dt: dt)
+    }
 }
@@ -18,8 +18,11 @@ import Math
 ///  These characteristics make it extremely flexible, memory efficient, and fast.
 ///  Its implementation is also fairly simple and concise.
 ///
+///  CPUMultilevelGrid is the multithreaded native counterpart for Int32 entities, with parallel rebuilds
+///  and incremental updates of moving entities.
+///
 public struct NativeMultilevelGrid<T> where T: Equatable {
-    public let minSize: Float = 0.01
+    public static let minSize: Float = 0.01
 
     /// A cell in the multilevel grid. Coords are 4-dimensional, the 4th component is the grid level.
     public struct Cell<K> where K: Equatable {
@@ -48,6 +51,7 @@ public struct NativeMultilevelGrid<T> where T: Equatable {
             }
             if let index {
                 contents.swapAt(index, contents.count - 1)
+                contents.removeLast()
                 return true
             }
             return false
@@ -71,26 +75,109 @@ public struct NativeMultilevelGrid<T> where T: Equatable {
         populatedLevels = [:]
     }
 
-    public func GetOrCreateCell(cellCoords _: int4) -> Int { 0 }
+    public mutating func GetOrCreateCell(cellCoords: int4) -> Int {
+        if let cellIndex = grid[cellCoords] {
+            return cellIndex
+        }
+        let cellIndex = usedCells.count
+        grid[cellCoords] = cellIndex
+        usedCells.append(Cell(coords: cellCoords))
+        IncreaseLevelPopulation(level: Int(cellCoords.w))
+        return cellIndex
+    }
 
-    public func TryGetCellIndex(cellCoords _: int4, cellIndex _: inout Int) -> Bool { false }
+    public func TryGetCellIndex(cellCoords: int4, cellIndex: inout Int) -> Bool {
+        if let index = grid[cellCoords] {
+            cellIndex = index
+            return true
+        }
+        return false
+    }
+
+    /// Removes cells with no contents, swapping the last cell into their place.
+    public mutating func RemoveEmpty() {
+        for i in stride(from: usedCells.count - 1, through: 0, by: -1) where usedCells[i].Length == 0 {
+            DecreaseLevelPopulation(level: Int(usedCells[i].coords.w))
+            grid.removeValue(forKey: usedCells[i].coords)
+            let last = usedCells.count - 1
+            if i != last {
+                usedCells[i] = usedCells[last]
+                grid[usedCells[i].coords] = i
+            }
+            usedCells.removeLast()
+        }
+    }
 
-    public func RemoveEmpty() {}
+    public static func GridLevelForSize(size: Float) -> Int {
+        Int(ceil(log2(max(size, minSize))))
+    }
 
-    public static func GridLevelForSize(size _: Float) -> Int { 0 }
+    public static func CellSizeOfLevel(level: Int) -> Float {
+        exp2(Float(level))
+    }
 
-    public static func CellSizeOfLevel(level _: Int) -> Float { 0 }
+    /// Coords of the cell of `level` (coarser than the cell's own) containing the cell.
+    public static func GetParentCellCoords(cellCoords: int4, level: Int) -> int4 {
+        let decimation = exp2(Float(level - Int(cellCoords.w)))
+        return int4(Int32(floor(Float(cellCoords.x) / decimation)), Int32(floor(Float(cellCoords.y) / decimation)),
+                    Int32(floor(Float(cellCoords.z) / decimation)), Int32(level))
+    }
 
-    public static func GetParentCellCoords(cellCoords _: int4, level _: Int) -> int4 { int4() }
+    public mutating func RemoveFromCells(span: BurstCellSpan, content: T) {
+        Self.forEachCell(span) { coords in
+            if let cellIndex = grid[coords] {
+                _ = usedCells[cellIndex].Remove(entity: content)
+            }
+        }
+    }
 
-    public func RemoveFromCells(span _: BurstCellSpan, content _: T) {}
+    public mutating func AddToCells(span: BurstCellSpan, content: T) {
+        Self.forEachCell(span) { coords in
+            let cellIndex = GetOrCreateCell(cellCoords: coords)
+            usedCells[cellIndex].Add(entity: content)
+        }
+    }
 
-    public func AddToCells(span _: BurstCellSpan, content _: T) {}
+    /// Appends the coords of every cell of `level` overlapped by the bounds, at most maxSize + 1 per axis.
+    public static func GetCellCoordsForBoundsAtLevel(coords: inout [int4], bounds: BurstAabb,
+                                                     level: Int, maxSize: Int = 10)
+    {
+        let cellSize = CellSizeOfLevel(level: level)
+        var minCell = int4(), maxCell = int4()
+        for axis in 0 ..< 3 {
+            minCell[axis] = Int32(floor(bounds.min[axis] / cellSize))
+            maxCell[axis] = min(Int32(floor(bounds.max[axis] / cellSize)), minCell[axis] + Int32(maxSize))
+        }
+        for x in minCell.x ... maxCell.x {
+            for y in minCell.y ... maxCell.y {
+                for z in minCell.z ... maxCell.z {
+                    coords.append(int4(x, y, z, Int32(level)))
+                }
+            }
+        }
+    }
 
-    public static func GetCellCoordsForBoundsAtLevel(coords _: [int4], bounds _: BurstAabb,
-                                                     level _: Int, maxSize _: Int = 10) {}
+    private static func forEachCell(_ span: BurstCellSpan, _ body: (int4) -> Void) {
+        for x in span.min.x ... span.max.x {
+            for y in span.min.y ... span.max.y {
+                for z in span.min.z ... span.max.z {
+                    body(int4(x, y, z, span.level))
+                }
+            }
+        }
+    }
 
-    private func IncreaseLevelPopulation(level _: Int) {}
+    private mutating func IncreaseLevelPopulation(level: Int) {
+        populatedLevels[level, default: 0] += 1
+    }
 
-    private func DecreaseLevelPopulation(level _: Int) {}
+    private mutating func DecreaseLevelPopulation(level: Int) {
+        if let population = populatedLevels[level] {
+            if population <= 1 {
+                populatedLevels.removeValue(forKey: level)
+            } else {
+                populatedLevels[level] = population - 1
+            }
+        }
+    }
 }
@@ -11,6 +11,12 @@ public struct MovingEntity {
     public var oldCellCoord: int4
     public var newCellCoord: int4
     public var entity: Int
+
+    public init(oldCellCoord: int4, newCellCoord: int4, entity: Int) {
+        self.oldCellCoord = oldCellCoord
+        self.newCellCoord = newCellCoord
+        self.entity = entity
+    }
 }
 
 public class ParticleGrid {
@@ -34,6 +40,7 @@ public class ParticleGrid {
         public func Execute() {}
     }
 
+    /// Implemented natively by ParticleGrid::generateParticleParticleContacts, see CPUParticleSolver.
     public struct GenerateParticleParticleContactsJob {
         public private(set) var grid: NativeMultilevelGrid<Int>
         public private(set) var gridLevels: [Int]
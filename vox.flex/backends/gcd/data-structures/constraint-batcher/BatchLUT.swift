@@ -13,13 +13,12 @@ public struct BatchLUT {
     public init(numBatches: Int) {
         self.numBatches = numBatches
 
-        batchIndex = [UInt16](repeating: 0, count: Int(UInt16.max) + 1)
-        let end = UInt16.max
         let numBits = UInt16(numBatches - 1)
+        batchIndex = [UInt16](repeating: numBits, count: Int(UInt16.max) + 1)
 
         // For each entry in the table, compute the position of the first '0' bit in the index, starting from the less significant bit.
-        // This is the index of the first batch where we can add the constraint to.
-        for value in 0 ..< end {
+        // This is the index of the first batch where we can add the constraint to, or the last batch if all bits are set.
+        for value in 0 ... UInt16.max {
             var valueCopy = value
             for i in 0 ..< numBits {
                 if (valueCopy & 1) == 0 {
@@ -29,7 +28,5 @@ public struct BatchLUT {
                 valueCopy >>= 1
             }
         }
-
-        batchIndex[Int(end)] = numBits
     }
 }
@@ -7,7 +7,7 @@
 import Math
 
 public struct BatchData {
-    /// Batch identifier. All bits will be '0', except for the one at the position of the batch./
+    /// Batch identifier. All bits will be '0', except for the one at the position of the batch (none for the last batch)./
     public var batchID: UInt16
     /// first constraint in the batch/
     public var startIndex: Int
@@ -23,8 +23,8 @@ public struct BatchData {
     public var isLast: Bool
 
     public init(index: Int, maxBatches: Int) {
-        batchID = UInt16(1 << index)
         isLast = index == (maxBatches - 1)
+        batchID = isLast || index >= 16 ? 0 : UInt16(1 << index)
         constraintCount = 0
         activeConstraintCount = 0
 
@@ -33,9 +33,26 @@ public struct BatchData {
         workItemCount = 0
     }
 
+    init(_ batch: CBatchData) {
+        batchID = batch.batchID
+        isLast = batch.isLast
+        startIndex = Int(batch.startIndex)
+        constraintCount = Int(batch.constraintCount)
+        activeConstraintCount = constraintCount
+        workItemSize = Int(batch.workItemSize)
+        workItemCount = Int(batch.workItemCount)
+    }
+
+    /// Work items start on multiples of workItemSize, so the first one of a batch may be shorter.
     public func GetConstraintRange(workItemIndex: Int, start: inout Int, end: inout Int) {
-        start = startIndex + workItemSize * workItemIndex
-        end = startIndex + min(constraintCount, workItemSize * (workItemIndex + 1))
+        if isLast {
+            start = startIndex
+            end = startIndex + constraintCount
+            return
+        }
+        let alignedStart = startIndex / workItemSize * workItemSize
+        start = max(startIndex, alignedStart + workItemSize * workItemIndex)
+        end = min(startIndex + constraintCount, alignedStart + workItemSize * (workItemIndex + 1))
     }
 }
 
@@ -56,37 +73,50 @@ public struct WorkItem {
 
 public struct ConstraintBatcher<T> where T: IConstraintProvider {
     public var maxBatches: Int
-    /// look up table for batch indices./
-    private var batchLUT: BatchLUT
+    /// native batcher, owns the look up table for batch indices./
+    private let batcher: CConstraintBatcher
 
     public init(maxBatches: Int) {
         self.maxBatches = min(17, maxBatches)
-        batchLUT = BatchLUT(numBatches: maxBatches)
+        batcher = CConstraintBatcher(maxBatches: UInt32(self.maxBatches))
     }
 
     /// Linear-time graph coloring using bitmasks and a look-up table. Used to organize contacts into batches for parallel processing.
     /// input: array of unsorted constraints.
     /// - Parameters:
-    ///   - particleCount: sorted constraint indices array.
+    ///   - constraintDesc: constraints to batch, sorted constraints are written back through it.
+    ///   - particleCount: number of particles in the solver.
     ///   - batchData: array of batchData, one per batch: startIndex, batchSize, workItemSize (at most == batchSize), numWorkItems
     ///   - activeBatchCount: number of active batches.
-    public func BatchConstraints(constraintDesc _: T,
-                                 particleCount _: Int,
-                                 batchData _: [BatchData],
-                                 activeBatchCount _: [Int]) {}
-
-    private struct BatchContactsJob {
-        public var batchMasks: [UInt16]
-
-        public var batchIndices: [Int]
-
-        public private(set) var lut: BatchLUT
-        public var constraintDesc: T
-        public var batchData: [BatchData]
-        public var activeBatchCount: [Int]
-
-        public var maxBatches: Int
-
-        public func Execute() {}
+    ///   - constraintStride: size of a sorted constraint, work items are sized in whole cache lines of it.
+    public func BatchConstraints(constraintDesc: inout T,
+                                 particleCount: Int,
+                                 batchData: inout [BatchData],
+                                 activeBatchCount: inout Int,
+                                 constraintStride: Int = MemoryLayout<BurstContact>.stride)
+    {
+        let constraintCount = constraintDesc.GetConstraintCount()
+        var offsets = [UInt32](repeating: 0, count: constraintCount + 1)
+        var particles: [Int32] = []
+        particles.reserveCapacity(constraintCount * 2)
+        for i in 0 ..< constraintCount {
+            for j in 0 ..< constraintDesc.GetParticleCount(at: i) {
+                particles.append(Int32(constraintDesc.GetParticle(at: i, index: j)))
+            }
+            offsets[i + 1] = UInt32(particles.count)
+        }
+
+        activeBatchCount = Int(batcher.batchConstraints(particles, offsets: offsets, count: UInt32(constraintCount),
+                                                        particleCount: UInt32(particleCount),
+                                                        constraintStride: UInt32(constraintStride)))
+        var batches = [CBatchData](repeating: CBatchData(), count: activeBatchCount)
+        batcher.getBatchData(&batches)
+        batchData = batches.map { BatchData($0) }
+
+        var sortedIndices = [UInt32](repeating: 0, count: constraintCount)
+        batcher.getSortedIndices(&sortedIndices)
+        for (sortedIndex, constraintIndex) in sortedIndices.enumerated() {
+            constraintDesc.WriteSortedConstraint(at: Int(constraintIndex), sortedIndex: sortedIndex)
+        }
     }
 }
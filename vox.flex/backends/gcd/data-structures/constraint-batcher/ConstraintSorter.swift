@@ -14,37 +14,24 @@ public class ConstraintSorter<T> where T: IConstraint {
         }
     }
 
-    /// Performs a single-threaded count sort on the constraints array using the first particle index,
-    /// then multiple parallel sorts over slices of the original array sorting by the second particle index.
-    public func SortConstraints(particleCount _: Int,
-                                constraints _: [T],
-                                sortedConstraints _: [T]) {}
-
-    public struct CountSortPerFirstParticleJob {
-        public var input: [T]
-        public var output: [T]
-
-        public var digitCount: [Int]
-
-        public var maxDigits: Int
-        public var maxIndex: Int
-
-        public func Execute() {}
-    }
-
-    /// Sorts slices of an array in parallel
-    public struct SortSubArraysJob {
-        public var InOutArray: [Int]
-
-        /// Typically lastDigitIndex is resulting RadixSortPerBodyAJob.digitCount.
-        /// nextElementIndex[i] = index of first element with bodyA index == i + 1
-        public var NextElementIndex: [Int]
-
-        public var comparer: ConstraintComparer<T>
-
-        public func Execute(workItemIndex _: Int) {}
-
-        public static func DefaultSortOfSubArrays(inOutArray _: [T], startIndex _: Int,
-                                                  length _: Int, comparer _: ConstraintComparer<T>) {}
+    private let sorter = CConstraintSorter()
+
+    public init() {}
+
+    /// Performs a count sort on the constraints array using the first particle index,
+    /// then parallel sorts over slices of the original array sorting by the second particle index.
+    public func SortConstraints(particleCount: Int,
+                                constraints: [T],
+                                sortedConstraints: inout [T])
+    {
+        var pairs = [Int32](repeating: 0, count: constraints.count * 2)
+        for (i, constraint) in constraints.enumerated() {
+            pairs[i * 2] = Int32(constraint.GetParticle(at: 0))
+            pairs[i * 2 + 1] = Int32(constraint.GetParticleCount() > 1 ? constraint.GetParticle(at: 1) : 0)
+        }
+        var sortedIndices = [UInt32](repeating: 0, count: constraints.count)
+        sorter.sortPairs(pairs, count: UInt32(constraints.count), particleCount: UInt32(particleCount),
+                         sortedIndices: &sortedIndices)
+        sortedConstraints = sortedIndices.map { constraints[Int($0)] }
     }
 }
@@ -35,6 +35,29 @@ public struct BurstContact: IConstraint {
     public var tangentInvMassB: Float
     public var bitangentInvMassB: Float
 
+    /// A contact as found by collision detection, with no impulse accumulated yet.
+    public init(pointA: float4, pointB: float4, normal: float4, distance: Float, bodyA: Int, bodyB: Int) {
+        self.pointA = pointA
+        self.pointB = pointB
+        self.normal = normal
+        tangent = float4()
+        bitangent = float4()
+        self.distance = distance
+        normalLambda = 0
+        tangentLambda = 0
+        bitangentLambda = 0
+        stickLambda = 0
+        rollingFrictionImpulse = 0
+        self.bodyA = bodyA
+        self.bodyB = bodyB
+        normalInvMassA = 0
+        tangentInvMassA = 0
+        bitangentInvMassA = 0
+        normalInvMassB = 0
+        tangentInvMassB = 0
+        bitangentInvMassB = 0
+    }
+
     public func GetParticleCount() -> Int { return 2 }
     public func GetParticle(at index: Int) -> Int { return index == 0 ? bodyA : bodyB }
 
@@ -5,6 +5,7 @@
 //  property of any third parties.
 
 import Math
+import simd
 
 public class BurstSolverImpl: ISolverImpl {
     var m_Solver: ObiSolver
@@ -24,6 +25,9 @@ public class BurstSolverImpl: ISolverImpl {
     public init(solver: ObiSolver) {
         m_Solver = solver
 
+        // Initialize collision world:
+        colliderGrid = BurstSolverImpl.GetOrCreateColliderWorld()
+
         // Initialize contact generation acceleration structure:
         particleGrid = ParticleGrid()
 
@@ -33,9 +37,26 @@ public class BurstSolverImpl: ISolverImpl {
 
         // Initialize constraint arrays:
         constraints.reserveCapacity(Oni.ConstraintTypeCount)
+
+        colliderGrid.IncreaseReferenceCount()
+        m_Native.setColliderWorld(colliderGrid._world)
     }
 
-    public func Destroy() {}
+    public func Destroy() {
+        m_Native.setColliderWorld(nil)
+        colliderGrid.DecreaseReferenceCount()
+    }
+
+    /// The native world registered with ObiColliderWorld, shared by every solver.
+    private static func GetOrCreateColliderWorld() -> CPUColliderWorld {
+        let world = ObiColliderWorld.GetInstance()
+        if let colliderWorld = world.implementations.lazy.compactMap({ $0 as? CPUColliderWorld }).first {
+            return colliderWorld
+        }
+        let colliderWorld = CPUColliderWorld()
+        world.RegisterImplementation(colliderWorld)
+        return colliderWorld
+    }
 
     private let maxBatches = 17
 
@@ -58,18 +79,22 @@ public class BurstSolverImpl: ISolverImpl {
     public lazy var fluidBatchData: [BatchData] = []
 
     // collider contact generation:
-//    private var colliderGrid: BurstColliderWorld
+    private var colliderGrid: CPUColliderWorld
     public lazy var colliderContacts: [BurstContact] = []
 
     // misc data:
     public lazy var activeParticles: [Int] = []
-    private lazy var deformableTriangles: [Int] = .init(repeating: 0, count: 64)
+    /// three particle indices per triangle, mirrored by the native solver.
+    private lazy var deformableTriangles: [Int32] = []
 
     public lazy var simplices: [Int] = []
-//    public var simplexCounts: SimplexCounts
+    public var simplexCounts = SimplexCounts(pointCount: 0, edgeCount: 0, triangleCount: 0)
 
     /// local to world inertial frame./
     private var m_InertialFrame: BurstInertialFrame!
+    /// native solver core, owns the simulated particle state.
+    let m_Native = CSolverImpl()
+    private var m_QueryResults: [CQueryResult] = []
     private var scheduledJobCounter = 0
 
     // cached particle data arrays (just wrappers over raw unmanaged data held by the abstract solver)
@@ -128,15 +153,130 @@ public class BurstSolverImpl: ISolverImpl {
         m_InertialFrame = BurstInertialFrame(position: translation.internalValue,
                                              scale: scale.internalValue,
                                              rotation: rotation.internalValue)
+        m_Native.initializeFrame(withTranslation: translation.internalValue, scale: scale.internalValue,
+                                 rotation: rotation.internalValue)
+    }
+
+    public func UpdateFrame(translation: Vector4, scale: Vector4, rotation: Quaternion, deltaTime: Float) {
+        m_InertialFrame.Update(position: translation.internalValue, scale: scale.internalValue,
+                               rotation: rotation.internalValue, dt: deltaTime)
+        m_Native.updateFrame(withTranslation: translation.internalValue, scale: scale.internalValue,
+                             rotation: rotation.internalValue, deltaTime: deltaTime)
+    }
+
+    /// The inertial forces are applied by the native solver during every substep of the coming step.
+    public func ApplyFrame(worldLinearInertiaScale: Float, worldAngularInertiaScale: Float, deltaTime _: Float) {
+        m_Native.applyFrame(withLinearInertiaScale: worldLinearInertiaScale,
+                            angularInertiaScale: worldAngularInertiaScale)
     }
 
-    public func UpdateFrame(translation _: Vector4, scale _: Vector4, rotation _: Quaternion, deltaTime _: Float) {}
+    public func ParticleCountChanged(solver: ObiSolver) {
+        m_Native.particleCount = UInt32(solver.positions.count)
+        m_Solver.m_DirtyAttributes = .all
+        PushParticleData()
+    }
 
-    public func ApplyFrame(worldLinearInertiaScale _: Float, worldAngularInertiaScale _: Float, deltaTime _: Float) {}
+    /// The native arrays own the particle state and the abstract solver's mirror it: attributes edited on the
+    /// solver since the last step are pushed before the next one, and the simulated state is read back once
+    /// per frame by ApplyInterpolation. Attributes the solver holds fewer of than particles keep their native
+    /// value for the rest.
+    private func PushParticleData() {
+        let dirty = m_Solver.m_DirtyAttributes
+        guard !dirty.isEmpty else { return }
+        let count = Int(m_Native.particleCount)
+        func push<Source, Target>(_ attribute: ObiSolver.ParticleAttributes, _ source: [Source],
+                                  _ target: UnsafeMutablePointer<Target>, _ convert: (Source) -> Target)
+        {
+            guard dirty.contains(attribute) else { return }
+            for i in 0 ..< min(source.count, count) {
+                target[i] = convert(source[i])
+            }
+        }
+        push(.positions, m_Solver.positions, m_Native.positions()) { $0.internalValue }
+        push(.restPositions, m_Solver.m_RestPositions, m_Native.restPositions()) { $0.internalValue }
+        push(.prevPositions, m_Solver.m_PrevPositions, m_Native.prevPositions()) { $0.internalValue }
+        push(.velocities, m_Solver.m_Velocities, m_Native.velocities()) { $0.internalValue }
+        push(.externalForces, m_Solver.m_ExternalForces, m_Native.externalForces()) { $0.internalValue }
+        push(.wind, m_Solver.m_Wind, m_Native.wind()) { $0.internalValue }
+        push(.invMasses, m_Solver.m_InvMasses, m_Native.invMasses()) { $0 }
+
+        push(.orientations, m_Solver.m_Orientations, m_Native.orientations()) { $0.internalValue }
+        push(.restOrientations, m_Solver.m_RestOrientations, m_Native.restOrientations()) { $0.internalValue }
+        push(.prevOrientations, m_Solver.m_PrevOrientations, m_Native.prevOrientations()) { $0.internalValue }
+        push(.angularVelocities, m_Solver.m_AngularVelocities, m_Native.angularVelocities()) { $0.internalValue }
+        push(.externalTorques, m_Solver.m_ExternalTorques, m_Native.externalTorques()) { $0.internalValue }
+        push(.invRotationalMasses, m_Solver.m_InvRotationalMasses, m_Native.invRotationalMasses()) { $0 }
+
+        push(.phases, m_Solver.m_Phases, m_Native.phases()) { Int32(truncatingIfNeeded: $0) }
+        push(.filters, m_Solver.m_Filters, m_Native.filters()) { Int32(truncatingIfNeeded: $0) }
+        push(.principalRadii, m_Solver.m_PrincipalRadii, m_Native.principalRadii()) { $0.internalValue }
+        push(.normals, m_Solver.m_Normals, m_Native.normals()) { $0.internalValue }
+        push(.buoyancies, m_Solver.m_Buoyancies, m_Native.buoyancies()) { $0 }
+
+        push(.smoothingRadii, m_Solver.m_SmoothingRadii, m_Native.smoothingRadii()) { $0 }
+        push(.restDensities, m_Solver.m_RestDensities, m_Native.restDensities()) { $0 }
+        push(.viscosities, m_Solver.m_Viscosities, m_Native.viscosities()) { $0 }
+        push(.vortConfinement, m_Solver.m_VortConfinement, m_Native.vortConfinement()) { $0 }
+        push(.surfaceTension, m_Solver.m_SurfaceTension, m_Native.surfaceTension()) { $0 }
+        push(.atmosphericDrag, m_Solver.m_AtmosphericDrag, m_Native.atmosphericDrag()) { $0 }
+        push(.atmosphericPressure, m_Solver.m_AtmosphericPressure, m_Native.atmosphericPressure()) { $0 }
+        push(.diffusion, m_Solver.m_Diffusion, m_Native.diffusion()) { $0 }
+        push(.userData, m_Solver.m_UserData, m_Native.userData()) { $0.internalValue }
+        push(.fluidData, m_Solver.m_FluidData, m_Native.fluidData()) { $0.internalValue }
+        push(.vorticities, m_Solver.m_Vorticities, m_Native.vorticities()) { $0.internalValue }
+        m_Solver.m_DirtyAttributes = []
+    }
 
-    public func ParticleCountChanged(solver _: ObiSolver) {}
+    /// Reads back what substeps change, in place, without marking it dirty.
+    private func PullSimulatedData() {
+        let count = Int(m_Native.particleCount)
+        let dirty = m_Solver.m_DirtyAttributes
+        Pull(m_Native.positions(), count, into: &m_Solver.positions)
+        Pull(m_Native.prevPositions(), count, into: &m_Solver.m_PrevPositions)
+        Pull(m_Native.velocities(), count, into: &m_Solver.m_Velocities)
+        Pull(m_Native.orientations(), count, into: &m_Solver.m_Orientations)
+        Pull(m_Native.prevOrientations(), count, into: &m_Solver.m_PrevOrientations)
+        Pull(m_Native.angularVelocities(), count, into: &m_Solver.m_AngularVelocities)
+        Pull(m_Native.fluidData(), count, into: &m_Solver.m_FluidData)
+        Pull(m_Native.vorticities(), count, into: &m_Solver.m_Vorticities)
+        Pull(m_Native.userData(), count, into: &m_Solver.m_UserData)
+        m_Solver.m_DirtyAttributes = dirty
+    }
 
-    public func SetActiveParticles(indices _: [Int]) {}
+    private func Pull(_ source: UnsafeMutablePointer<SIMD4<Float>>, _ count: Int, into target: inout [Vector4]) {
+        if target.count != count {
+            target = [Vector4](repeating: Vector4(), count: count)
+        }
+        target.withUnsafeMutableBufferPointer { buffer in
+            for i in 0 ..< count {
+                buffer[i] = Vector4(source[i].x, source[i].y, source[i].z, source[i].w)
+            }
+        }
+    }
+
+    private func Pull(_ source: UnsafeMutablePointer<simd_quatf>, _ count: Int, into target: inout [Quaternion]) {
+        if target.count != count {
+            target = [Quaternion](repeating: Quaternion(), count: count)
+        }
+        target.withUnsafeMutableBufferPointer { buffer in
+            for i in 0 ..< count {
+                buffer[i] = Quaternion(x: source[i].imag.x, y: source[i].imag.y, z: source[i].imag.z, w: source[i].real)
+            }
+        }
+    }
+
+    public func SetActiveParticles(indices: [Int]) {
+        activeParticles = indices
+        let nativeIndices = indices.map { Int32($0) }
+        nativeIndices.withUnsafeBufferPointer { buffer in
+            if let baseAddress = buffer.baseAddress {
+                m_Native.setActiveParticles(baseAddress, count: UInt32(buffer.count))
+            } else {
+                var none: Int32 = 0
+                m_Native.setActiveParticles(&none, count: 0)
+            }
+        }
+    }
 
     public func InterpolateDiffuseProperties(properties _: [Vector4], diffusePositions _: [Vector4],
                                              diffuseProperties _: [Vector4], neighbourCount _: [Int], diffuseCount _: Int) {}
@@ -149,40 +289,154 @@ public class BurstSolverImpl: ISolverImpl {
 
     public func DestroyConstraintsBatch(batch _: IConstraintsBatchImpl) {}
 
-    public func GetConstraintCount(type _: Oni.ConstraintType) -> Int {
-        0
+    public func GetConstraintCount(type: Oni.ConstraintType) -> Int {
+        Int(m_Native.constraintCount(UInt32(type.rawValue)))
     }
 
     public func GetCollisionContacts(contacts _: [Oni.Contact], count _: Int) {}
 
     public func GetParticleCollisionContacts(contacts _: [Oni.Contact], count _: Int) {}
 
-    public func SetConstraintGroupParameters(type _: Oni.ConstraintType, parameters _: Oni.ConstraintParameters) {}
+    public func SetConstraintGroupParameters(type: Oni.ConstraintType, parameters: Oni.ConstraintParameters) {
+        m_Native.setConstraintParameters(UInt32(type.rawValue), enabled: parameters.enabled,
+                                         order: parameters.evaluationOrder == .Parallel ? .parallel : .sequential,
+                                         iterations: Int32(parameters.iterations), sorFactor: parameters.SORFactor)
+    }
 
-    public func CollisionDetection(stepTime _: Float) {}
+    public func CollisionDetection(stepTime: Float) {
+        PushParticleData()
+        m_Native.collisionDetection(stepTime)
 
-    public func Substep(stepTime _: Float, substepTime _: Float, substeps _: Int) {}
+        var contacts = [CParticleContact](repeating: CParticleContact(), count: Int(m_Native.colliderContactCount()))
+        m_Native.getColliderContacts(&contacts)
+        colliderContacts = contacts.map(CPUParticleSolver.burstContact)
+    }
 
-    public func ApplyInterpolation(startPositions _: [Vector4], startOrientations _: [Quaternion],
-                                   stepTime _: Float, unsimulatedTime _: Float) {}
+    public func Substep(stepTime: Float, substepTime: Float, substeps: Int) {
+        m_Native.substep(stepTime, substepTime: substepTime, substeps: Int32(substeps))
+    }
+
+    public func ApplyInterpolation(startPositions: [Vector4], startOrientations: [Quaternion],
+                                   stepTime: Float, unsimulatedTime: Float)
+    {
+        let count = Int(m_Native.particleCount)
+        guard startPositions.count == count, startOrientations.count == count else {
+            m_Native.applyInterpolation(withStartPositions: nil, startOrientations: nil,
+                                        stepTime: stepTime, unsimulatedTime: unsimulatedTime)
+            PullRenderableData()
+            return
+        }
+        let positions = startPositions.map { $0.internalValue }
+        let orientations = startOrientations.map { $0.internalValue }
+        m_Native.applyInterpolation(withStartPositions: positions, startOrientations: orientations,
+                                    stepTime: stepTime, unsimulatedTime: unsimulatedTime)
+        PullRenderableData()
+    }
+
+    /// Reads back the state of the frame's last substep along with the renderables.
+    private func PullRenderableData() {
+        let count = Int(m_Native.particleCount)
+        PullSimulatedData()
+        Pull(m_Native.renderablePositions(), count, into: &m_Solver.m_RenderablePositions)
+        Pull(m_Native.renderableOrientations(), count, into: &m_Solver.m_RenderableOrientations)
+    }
 
     public func GetDeformableTriangleCount() -> Int {
-        0
+        deformableTriangles.count / 3
     }
 
-    public func SetDeformableTriangles(indices _: [Int], num _: Int, destOffset _: Int) {}
+    public func SetDeformableTriangles(indices: [Int], num: Int, destOffset: Int) {
+        if (destOffset + num) * 3 > deformableTriangles.count {
+            deformableTriangles += [Int32](repeating: 0, count: (destOffset + num) * 3 - deformableTriangles.count)
+        }
+        for i in 0 ..< num * 3 {
+            deformableTriangles[destOffset * 3 + i] = Int32(indices[i])
+        }
+        UpdateDeformableTriangles()
+    }
 
-    public func RemoveDeformableTriangles(num _: Int, sourceOffset _: Int) -> Int {
-        0
+    public func RemoveDeformableTriangles(num: Int, sourceOffset: Int) -> Int {
+        let count = min(num, GetDeformableTriangleCount() - sourceOffset)
+        guard sourceOffset >= 0, count > 0 else {
+            return 0
+        }
+        deformableTriangles.removeSubrange(sourceOffset * 3 ..< (sourceOffset + count) * 3)
+        UpdateDeformableTriangles()
+        return count
+    }
+
+    /// recolors the triangles for the native aerodynamics.
+    private func UpdateDeformableTriangles() {
+        deformableTriangles.withUnsafeBufferPointer { buffer in
+            m_Native.setDeformableTriangles(buffer.baseAddress, count: UInt32(buffer.count / 3))
+        }
     }
 
-    public func SetSimplices(simplices _: [Int], counts _: SimplexCounts) {}
+    /// Particle contacts, simplex bounds, collider candidates and spatial queries all run on these simplices.
+    public func SetSimplices(simplices: [Int], counts: SimplexCounts) {
+        let indexCount = counts.pointCount + counts.edgeCount * 2 + counts.triangleCount * 3
+        precondition(simplices.count >= indexCount, "fewer simplex indices than the counts need")
+        self.simplices = simplices
+        simplexCounts = counts
+        let nativeIndices = simplices.prefix(indexCount).map { Int32($0) }
+        nativeIndices.withUnsafeBufferPointer { buffer in
+            if let baseAddress = buffer.baseAddress {
+                m_Native.setSimplices(baseAddress, pointCount: UInt32(counts.pointCount),
+                                      edgeCount: UInt32(counts.edgeCount), triangleCount: UInt32(counts.triangleCount))
+            } else {
+                var none: Int32 = 0
+                m_Native.setSimplices(&none, pointCount: 0, edgeCount: 0, triangleCount: 0)
+            }
+        }
+    }
 
-    public func SetParameters(parameters _: Oni.SolverParameters) {}
+    public func SetParameters(parameters: Oni.SolverParameters) {
+        m_Native.mode = parameters.mode == .Mode2D ? .mode2D : .mode3D
+        switch parameters.interpolation {
+        case .None:
+            m_Native.interpolation = .none
+        case .Interpolate:
+            m_Native.interpolation = .interpolate
+        case .Extrapolate:
+            m_Native.interpolation = .extrapolate
+        }
+        m_Native.gravity = parameters.gravity.internalValue
+        m_Native.damping = parameters.damping
+        m_Native.maxAnisotropy = parameters.maxAnisotropy
+        m_Native.sleepThreshold = parameters.sleepThreshold
+        m_Native.collisionMargin = parameters.collisionMargin
+        m_Native.maxDepenetration = parameters.maxDepenetration
+        m_Native.continuousCollisionDetection = parameters.continuousCollisionDetection
+        m_Native.shockPropagation = parameters.shockPropagation
+        m_Native.surfaceCollisionIterations = Int32(parameters.surfaceCollisionIterations)
+        m_Native.surfaceCollisionTolerance = parameters.surfaceCollisionTolerance
+    }
 
-    public func GetBounds(min _: inout Vector3, max _: inout Vector3) {}
+    public func GetBounds(min: inout Vector3, max: inout Vector3) {
+        var lower = SIMD3<Float>()
+        var upper = SIMD3<Float>()
+        if m_Native.getBounds(&lower, upper: &upper) {
+            min = Vector3(lower.x, lower.y, lower.z)
+            max = Vector3(upper.x, upper.y, upper.z)
+        }
+    }
 
-    public func ResetForces() {}
+    /// Clears the solver's forces too, or the next step would push them back.
+    public func ResetForces() {
+        m_Native.resetForces()
+        let dirty = m_Solver.m_DirtyAttributes
+        for i in 0 ..< m_Solver.m_ExternalForces.count {
+            m_Solver.m_ExternalForces[i] = Vector4()
+        }
+        for i in 0 ..< m_Solver.m_ExternalTorques.count {
+            m_Solver.m_ExternalTorques[i] = Vector4()
+        }
+        for i in 0 ..< m_Solver.m_Wind.count {
+            m_Solver.m_Wind[i] = Vector4()
+        }
+        // both sides are cleared already.
+        m_Solver.m_DirtyAttributes = dirty.subtracting([.externalForces, .externalTorques, .wind])
+    }
 
     public func GetParticleGridSize() -> Int {
         0
@@ -190,7 +444,40 @@ public class BurstSolverImpl: ISolverImpl {
 
     public func GetParticleGrid(cells _: [Aabb]) {}
 
-    public func SpatialQuery(shapes _: [QueryShape], transforms _: [AffineTransform], results _: [QueryResult]) {}
+    /// Runs every query against the particle grid of the last collision detection. `transforms` holds the world
+    /// transform of each shape, or is empty for shapes in solver space.
+    public func SpatialQuery(shapes: [QueryShape], transforms: [AffineTransform], results: inout [QueryResult]) {
+        precondition(transforms.isEmpty || transforms.count == shapes.count)
+        let nativeShapes = shapes.map {
+            CQueryShape(center: $0.center.internalValue, size: $0.size.internalValue,
+                        type: CQueryType(rawValue: Int32($0.type.rawValue))!, contactOffset: $0.contactOffset,
+                        maxDistance: $0.maxDistance, filter: Int32(truncatingIfNeeded: $0.filter))
+        }
+        let nativeTransforms = transforms.map {
+            CAffineTransform(translation: $0.translation.internalValue, scale: $0.scale.internalValue,
+                             rotation: $0.rotation.internalValue)
+        }
+        func query() -> Int {
+            let capacity = UInt32(m_QueryResults.count)
+            return nativeTransforms.withUnsafeBufferPointer { buffer in
+                Int(m_Native.spatialQuery(nativeShapes, transforms: buffer.isEmpty ? nil : buffer.baseAddress,
+                                          count: UInt32(nativeShapes.count), results: &m_QueryResults,
+                                          capacity: capacity))
+            }
+        }
+        // the result buffer persists across calls, and only grows when a query finds more than it holds.
+        var found = query()
+        if found > m_QueryResults.count {
+            m_QueryResults = [CQueryResult](repeating: CQueryResult(), count: found)
+            found = query()
+        }
+        results = m_QueryResults[0 ..< found].map {
+            QueryResult(simplexBary: Vector4($0.simplexBary.x, $0.simplexBary.y, $0.simplexBary.z, $0.simplexBary.w),
+                        queryPoint: Vector4($0.queryPoint.x, $0.queryPoint.y, $0.queryPoint.z, $0.queryPoint.w),
+                        normal: Vector4($0.normal.x, $0.normal.y, $0.normal.z, $0.normal.w),
+                        distance: $0.distance, simplexIndex: Int($0.simplexIndex), queryIndex: Int($0.queryIndex))
+        }
+    }
 
     public func ReleaseJobHandles() {}
 }
@@ -7,7 +7,7 @@
 import Math
 import vox_render
 
-public protocol IColliderWorldImpl {
+public protocol IColliderWorldImpl: AnyObject {
     var referenceCount: Int { get }
 
     func UpdateWorld(deltaTime: Float)
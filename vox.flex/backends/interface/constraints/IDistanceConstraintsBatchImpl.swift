@@ -8,4 +8,7 @@ import Math
 
 public protocol IDistanceConstraintsBatchImpl: IConstraintsBatchImpl {
     func SetDistanceConstraints(particleIndices: [Int], restLengths: [Float], stiffnesses: [Vector2], lambdas: [Float], count: Int)
+
+    /// Resizes `lambdas` to the constraint count and fills it with the multipliers of the last substep.
+    func GetLambdas(lambdas: inout [Float])
 }
@@ -60,6 +60,6 @@ public protocol ISolverImpl {
     func ResetForces()
     func GetParticleGridSize() -> Int
     func GetParticleGrid(cells: [Aabb])
-    func SpatialQuery(shapes: [QueryShape], transforms: [AffineTransform], results: [QueryResult])
+    func SpatialQuery(shapes: [QueryShape], transforms: [AffineTransform], results: inout [QueryResult])
     func ReleaseJobHandles()
 }
@@ -77,6 +77,17 @@ public class ObiConstraintsBatch: IObiConstraintsBatch {
 
     public var implementation: IConstraintsBatchImpl!
 
+    /// Replaces the batch with `count` active constraints of `indices`, their IDs in order.
+    func SetConstraints(particleIndices indices: [Int], count: Int) {
+        particleIndices = indices
+        lambdas = [Float](repeating: 0, count: count)
+        m_IDs = Array(0 ..< count)
+        m_IDToIndex = Array(0 ..< count)
+        m_ConstraintCount = count
+        m_ActiveConstraintCount = count
+        m_InitialActiveConstraintCount = count
+    }
+
     public func AddToSolver(solver _: ObiSolver) {}
 
     public func RemoveFromSolver(solver _: ObiSolver) {}
@@ -21,6 +21,11 @@ public class ObiDistanceConstraintsBatch: ObiConstraintsBatch, IStructuralConstr
         implementation = m_BatchImpl
     }
 
+    /// Copies the lambdas of the solver's last substep into `lambdas`, if the batch is in a solver.
+    public func PullLambdas() {
+        m_BatchImpl?.GetLambdas(lambdas: &lambdas)
+    }
+
     public func GetRestLength(at _: Int) -> Float {
         0
     }
@@ -11,3 +11,4 @@
 #include "../flex.shader/macro_name.h"
 
 #include "TriangleMesh.h"
+#include "native/bridging.h"
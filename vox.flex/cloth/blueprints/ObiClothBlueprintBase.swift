@@ -4,7 +4,9 @@
 //  personal capacity and am not conveying any rights to any intellectual
 //  property of any third parties.
 
+import Foundation
 import Math
+import simd
 
 public class ObiClothBlueprintBase: ObiMeshBasedActorBlueprint {
     /// Topology generated from the input mesh.
@@ -18,5 +20,144 @@ public class ObiClothBlueprintBase: ObiMeshBasedActorBlueprint {
 
     public static let DEFAULT_PARTICLE_MASS: Float = 0.1
 
+    /// Mass of every particle.
+    public var particleMass = ObiClothBlueprintBase.DEFAULT_PARTICLE_MASS
+    /// Aerodynamic drag and lift coefficients of every particle.
+    public var drag: Float = 0.05
+    public var lift: Float = 0.05
+    /// Directory generated blueprints are cached in, by hash of their mesh and parameters. Nil disables caching.
+    public var cacheDirectory: URL?
+
     var colorizer = GraphColoring()
+
+    /// Generates the topology of the input mesh, then one particle per welded vertex with its distance, bend and
+    /// aerodynamic constraints, see CClothBlueprint. Returns true if they were read from the cache.
+    @discardableResult
+    public func Generate() -> Bool {
+        topology = HalfEdgeMesh()
+        topology.inputMesh = inputMesh
+        topology.scale = scale
+        topology.Generate()
+        return GenerateFromTopology()
+    }
+
+    /// Same as Generate, from triangles given by every three `indices` of `vertices` instead of the input mesh.
+    @discardableResult
+    public func Generate(vertices: [Vector3], indices: [Int]) -> Bool {
+        topology = HalfEdgeMesh()
+        topology.scale = scale
+        topology.Generate(vertices: vertices, indices: indices)
+        return GenerateFromTopology()
+    }
+
+    private func GenerateFromTopology() -> Bool {
+        guard topology.containsData else { return false }
+
+        let blueprint = CClothBlueprint()
+        let parameters = CClothBlueprintParameters(particleMass: particleMass, drag: drag, lift: lift, batchRounds: 4)
+        let cached = blueprint.generate(with: topology.native, parameters: parameters, invMasses: nil,
+                                        cacheDirectory: cacheDirectory?.path)
+        CreateSimulationData(blueprint)
+        CreateDistanceConstraints(blueprint)
+        CreateBendingConstraints(blueprint)
+        CreateAerodynamicConstraints(blueprint)
+        return cached
+    }
+
+    private func CreateSimulationData(_ blueprint: CClothBlueprint) {
+        let count = Int(blueprint.particleCount)
+        var masses = [Float](repeating: 0, count: count)
+        var radii = [Float](repeating: 0, count: count)
+        blueprint.getInvMasses(&masses, radii: &radii)
+
+        let frame = simd_quatf(ix: rotation.x, iy: rotation.y, iz: rotation.z, r: rotation.w)
+        positions = topology.vertices.map {
+            let p = simd_act(frame, $0.position.internalValue)
+            return Vector3(p.x, p.y, p.z)
+        }
+        restPositions = positions.map { Vector4($0.x, $0.y, $0.z, 1) }
+        // orientations and normals are in blueprint space too.
+        let rotated = topology.restOrientations.map {
+            let q = frame * simd_quatf(ix: $0.x, iy: $0.y, iz: $0.z, r: $0.w)
+            return Quaternion(x: q.imag.x, y: q.imag.y, z: q.imag.z, w: q.real)
+        }
+        orientations = rotated
+        restOrientations = rotated
+        velocities = [Vector3](repeating: Vector3(), count: count)
+        angularVelocities = [Vector3](repeating: Vector3(), count: count)
+        invMasses = masses
+        invRotationalMasses = masses
+        principalRadii = radii.map { Vector3($0, $0, $0) }
+        filters = [Int](repeating: ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything, category: 1),
+                        count: count)
+        points = Array(0 ..< count)
+        particleCount = count
+        activeParticleCount = count
+        m_ActiveParticleCount = count
+        m_InitialActiveParticleCount = count
+        m_Empty = count == 0
+
+        var triangles = [Int32](repeating: 0, count: Int(topology.native.faceCount) * 3)
+        topology.native.getTriangles(&triangles)
+        deformableTriangles = triangles.map { Int($0) }
+        restNormals = topology.restNormals.map {
+            let n = simd_act(frame, $0.internalValue)
+            return Vector3(n.x, n.y, n.z)
+        }
+        areaContribution = topology.areaContributions
+    }
+
+    private func CreateDistanceConstraints(_ blueprint: CClothBlueprint) {
+        var indices = [Int32](repeating: 0, count: Int(blueprint.distanceCount) * 2)
+        var restLengths = [Float](repeating: 0, count: Int(blueprint.distanceCount))
+        var batches = [CBatchData](repeating: CBatchData(), count: Int(blueprint.distanceBatchCount))
+        blueprint.getDistanceIndices(&indices, restLengths: &restLengths, batches: &batches)
+
+        let data = ObiDistanceConstraintsData()
+        for source in batches {
+            let range = Int(source.startIndex) ..< Int(source.startIndex + source.constraintCount)
+            let batch = ObiDistanceConstraintsBatch()
+            let particles = indices[range.lowerBound * 2 ..< range.upperBound * 2].map { Int($0) }
+            batch.SetConstraints(particleIndices: particles, count: range.count)
+            batch.restLengths = Array(restLengths[range])
+            batch.stiffnesses = [Vector2](repeating: Vector2(0, 0), count: range.count)
+            data.batches.append(batch)
+        }
+        distanceConstraintsData = data
+    }
+
+    private func CreateBendingConstraints(_ blueprint: CClothBlueprint) {
+        var indices = [Int32](repeating: 0, count: Int(blueprint.bendCount) * 3)
+        var restBends = [Float](repeating: 0, count: Int(blueprint.bendCount))
+        var batches = [CBatchData](repeating: CBatchData(), count: Int(blueprint.bendBatchCount))
+        blueprint.getBendIndices(&indices, restBends: &restBends, batches: &batches)
+
+        let data = ObiBendConstraintsData()
+        for source in batches {
+            let range = Int(source.startIndex) ..< Int(source.startIndex + source.constraintCount)
+            let batch = ObiBendConstraintsBatch(constraints: data)
+            let particles = indices[range.lowerBound * 3 ..< range.upperBound * 3].map { Int($0) }
+            batch.SetConstraints(particleIndices: particles, count: range.count)
+            batch.restBends = Array(restBends[range])
+            batch.bendingStiffnesses = [Vector2](repeating: Vector2(0, 0), count: range.count)
+            batch.plasticity = [Vector2](repeating: Vector2(0, 0), count: range.count)
+            data.batches.append(batch)
+        }
+        bendConstraintsData = data
+    }
+
+    /// A single batch: every constraint acts on a particle of its own.
+    private func CreateAerodynamicConstraints(_ blueprint: CClothBlueprint) {
+        let count = Int(blueprint.aerodynamicCount)
+        var particles = [Int32](repeating: 0, count: count)
+        var coeffs = [Float](repeating: 0, count: count * 3)
+        blueprint.getAerodynamicParticles(&particles, coeffs: &coeffs)
+
+        let data = ObiAerodynamicConstraintsData()
+        let batch = ObiAerodynamicConstraintsBatch(constraints: data)
+        batch.SetConstraints(particleIndices: particles.map { Int($0) }, count: count)
+        batch.aerodynamicCoeffs = coeffs
+        data.batches.append(batch)
+        aerodynamicConstraintsData = data
+    }
 }
@@ -5,6 +5,7 @@
 //  property of any third parties.
 
 import Math
+import simd
 import vox_render
 
 public class HalfEdgeMesh {
@@ -14,9 +15,13 @@ public class HalfEdgeMesh {
     private var _area: Float = 0
     private var _volume: Float = 0
 
+    /// Native topology the arrays below are read from, see CHalfEdgeMesh.
+    public private(set) var native = CHalfEdgeMesh()
+
     public struct HalfEdge {
         public var index: Int
         public var indexInFace: Int
+        /// -1 for border half-edges.
         public var face: Int
         public var nextHalfEdge: Int
         public var pair: Int
@@ -25,6 +30,7 @@ public class HalfEdgeMesh {
 
     public struct Vertex {
         public var index: Int
+        /// first half-edge leaving the vertex, -1 if no face uses it.
         public var halfEdge: Int
         public var position: Vector3
     }
@@ -36,40 +42,167 @@ public class HalfEdgeMesh {
 
     public var containsData = false
     public var vertices: [Vertex] = []
+    /// face half-edges first, three per face, then border ones.
     public var halfEdges: [HalfEdge] = []
     public var borderEdges: [HalfEdge] = []
     public var faces: [Face] = []
     public var restNormals: [Vector3] = []
     public var restOrientations: [Quaternion] = []
     public var rawToWelded: [Int] = []
+    /// a third of the area of the faces around every vertex.
+    public var areaContributions: [Float] = []
+
+    /// half-edges leaving vertex v are outgoingHalfEdges[outgoingOffsets[v] ..< outgoingOffsets[v + 1]].
+    public var outgoingOffsets: [Int] = []
+    public var outgoingHalfEdges: [Int] = []
+    private var _edges: [Int] = []
+
+    public var area: Float {
+        _area
+    }
+
+    public var volume: Float {
+        _volume
+    }
 
     public init() {}
 
-    public init(halfEdge _: HalfEdgeMesh) {}
+    public init(halfEdge: HalfEdgeMesh) {
+        inputMesh = halfEdge.inputMesh
+        scale = halfEdge.scale
+        _area = halfEdge._area
+        _volume = halfEdge._volume
+        native = halfEdge.native
+        containsData = halfEdge.containsData
+        vertices = halfEdge.vertices
+        halfEdges = halfEdge.halfEdges
+        borderEdges = halfEdge.borderEdges
+        faces = halfEdge.faces
+        restNormals = halfEdge.restNormals
+        restOrientations = halfEdge.restOrientations
+        rawToWelded = halfEdge.rawToWelded
+        areaContributions = halfEdge.areaContributions
+        outgoingOffsets = halfEdge.outgoingOffsets
+        outgoingHalfEdges = halfEdge.outgoingHalfEdges
+        _edges = halfEdge._edges
+    }
 
-    public func Generate() {}
+    /// Builds the topology of the input mesh, welding vertices at the same position.
+    public func Generate() {
+        guard let mesh = inputMesh, let positions = mesh.getPositions() else { return }
+
+        var indices: [Int] = []
+        if let indices32: [UInt32] = mesh.getIndices() {
+            indices = indices32.map { Int($0) }
+        } else if let indices16: [UInt16] = mesh.getIndices() {
+            indices = indices16.map { Int($0) }
+        } else {
+            indices = Array(0 ..< positions.count)
+        }
+        Generate(vertices: positions, indices: indices)
+    }
 
-    private func CalculateRestNormals() {}
+    /// Builds the topology of the triangles given by every three `indices` of `vertices`.
+    public func Generate(vertices meshVertices: [Vector3], indices: [Int]) {
+        let positions = meshVertices.map { $0.internalValue }
+        let triangles = indices.prefix(indices.count / 3 * 3).map { Int32($0) }
+        native = CHalfEdgeMesh()
+        native.build(withPositions: positions, vertexCount: UInt32(positions.count), triangles: triangles,
+                     triangleCount: UInt32(triangles.count / 3), scale: scale.internalValue)
+        _area = native.area
+        _volume = native.volume
+
+        let vertexCount = Int(native.vertexCount)
+        var welded = [SIMD4<Float>](repeating: .zero, count: vertexCount)
+        var normals = [SIMD4<Float>](repeating: .zero, count: vertexCount)
+        var orientations = [simd_quatf](repeating: simd_quatf(), count: vertexCount)
+        areaContributions = [Float](repeating: 0, count: vertexCount)
+        native.getPositions(&welded, restNormals: &normals, restOrientations: &orientations,
+                            areaContributions: &areaContributions)
+        CalculateRestNormals(normals)
+        CalculateRestOrientations(orientations)
+
+        var cHalfEdges = [CHalfEdge](repeating: CHalfEdge(), count: Int(native.halfEdgeCount))
+        native.getHalfEdges(&cHalfEdges)
+        halfEdges = cHalfEdges.enumerated().map { index, edge in
+            HalfEdge(index: index, indexInFace: edge.face < 0 ? 0 : index % 3, face: Int(edge.face),
+                     nextHalfEdge: Int(edge.nextHalfEdge), pair: Int(edge.pair), endVertex: Int(edge.endVertex))
+        }
+        let faceCount = Int(native.faceCount)
+        borderEdges = Array(halfEdges[faceCount * 3 ..< halfEdges.count])
+        faces = (0 ..< faceCount).map { Face(index: $0, halfEdge: $0 * 3) }
+
+        var vertexHalfEdges = [Int32](repeating: -1, count: vertexCount)
+        var offsets = [Int32](repeating: 0, count: vertexCount + 1)
+        var outgoing = [Int32](repeating: 0, count: Int(native.outgoingCount))
+        native.getVertexHalfEdges(&vertexHalfEdges, outgoingOffsets: &offsets, outgoingHalfEdges: &outgoing)
+        outgoingOffsets = offsets.map { Int($0) }
+        outgoingHalfEdges = outgoing.map { Int($0) }
+        vertices = (0 ..< vertexCount).map {
+            Vertex(index: $0, halfEdge: Int(vertexHalfEdges[$0]),
+                   position: Vector3(welded[$0].x, welded[$0].y, welded[$0].z))
+        }
+
+        var weldedIndices = [Int32](repeating: 0, count: Int(native.rawVertexCount))
+        native.getRawToWelded(&weldedIndices)
+        rawToWelded = weldedIndices.map { Int($0) }
+        var edges = [Int32](repeating: 0, count: Int(native.edgeCount))
+        native.getEdges(&edges)
+        _edges = edges.map { Int($0) }
+        containsData = true
+    }
 
-    private func CalculateRestOrientations() {}
+    /// Area weighted vertex normals.
+    private func CalculateRestNormals(_ normals: [SIMD4<Float>]) {
+        restNormals = normals.map { Vector3($0.x, $0.y, $0.z) }
+    }
+
+    /// Frames looking along the rest normal, up towards the end of each vertex's half-edge.
+    private func CalculateRestOrientations(_ orientations: [simd_quatf]) {
+        restOrientations = orientations.map {
+            Quaternion(x: $0.imag.x, y: $0.imag.y, z: $0.imag.z, w: $0.real)
+        }
+    }
 
     public func SwapVertices(index1 _: Int, index2 _: Int) {}
 
-    public func GetHalfEdgeStartVertex(edge _: HalfEdge) -> Int { 0 }
+    public func GetHalfEdgeStartVertex(edge: HalfEdge) -> Int {
+        edge.face < 0 ? halfEdges[edge.pair].endVertex : halfEdges[edge.face * 3 + (edge.indexInFace + 2) % 3].endVertex
+    }
 
-    public func GetFaceArea(face _: Face) -> Float { 0 }
+    public func GetFaceArea(face: Face) -> Float {
+        let a = vertices[GetHalfEdgeStartVertex(edge: halfEdges[face.halfEdge])].position
+        let b = vertices[halfEdges[face.halfEdge].endVertex].position
+        let c = vertices[halfEdges[halfEdges[face.halfEdge].nextHalfEdge].endVertex].position
+        return Vector3.cross(left: b - a, right: c - a).length() * 0.5
+    }
 
-    public func GetNeighbourVerticesEnumerator(vertex _: Vertex) {}
+    /// Vertices joined to `vertex` by an edge.
+    public func GetNeighbourVerticesEnumerator(vertex: Vertex) -> [Vertex] {
+        outgoingHalfEdges[outgoingOffsets[vertex.index] ..< outgoingOffsets[vertex.index + 1]].map {
+            vertices[halfEdges[$0].endVertex]
+        }
+    }
 
-    public func GetNeighbourEdgesEnumerator(vertex _: Vertex) {}
+    /// Half-edges leaving `vertex`, border ones included.
+    public func GetNeighbourEdgesEnumerator(vertex: Vertex) -> [HalfEdge] {
+        outgoingHalfEdges[outgoingOffsets[vertex.index] ..< outgoingOffsets[vertex.index + 1]].map {
+            halfEdges[$0]
+        }
+    }
 
-    public func GetNeighbourFacesEnumerator(vertex _: Vertex) {}
+    /// Faces around `vertex`.
+    public func GetNeighbourFacesEnumerator(vertex: Vertex) -> [Face] {
+        outgoingHalfEdges[outgoingOffsets[vertex.index] ..< outgoingOffsets[vertex.index + 1]].compactMap {
+            halfEdges[$0].face < 0 ? nil : faces[halfEdges[$0].face]
+        }
+    }
 
     /// Calculates and returns a list of all edges (note: not half-edges, but regular edges) in the mesh. Each edge is represented as the index of
     /// the first half-edge in the list that is part of the edge.
     /// This is O(2N) in both time and space, with N = number of edges.
     public func GetEdgeList() -> [Int] {
-        []
+        _edges
     }
 
     /// Returns true if the edge has been split in a vertex split operation. (as a result of tearing)
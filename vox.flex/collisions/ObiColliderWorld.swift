@@ -55,6 +55,8 @@ public class ObiRigidbodyHandle: ObiResourceHandle<ObiRigidbodyBase> {
 }
 
 public class ObiColliderWorld {
+    private static var instance: ObiColliderWorld?
+
     public var implementations: [IColliderWorldImpl] = []
     /// list of collider handles, used by ObiCollider components to retrieve them./
     public var colliderHandles: [ObiColliderHandle] = []
@@ -76,4 +78,40 @@ public class ObiColliderWorld {
     public var triangleMeshContainer = ObiTriangleMeshContainer()
     public var distanceFieldContainer = ObiDistanceFieldContainer()
 //    public var heightFieldContainer: ObiHeightFieldContainer
+
+    public static func GetInstance() -> ObiColliderWorld {
+        if let instance {
+            return instance
+        }
+        let world = ObiColliderWorld()
+        instance = world
+        return world
+    }
+
+    /// Adds an implementation, handing it the current colliders, rigidbodies and meshes.
+    public func RegisterImplementation(_ impl: IColliderWorldImpl) {
+        guard !implementations.contains(where: { $0 === impl }) else {
+            return
+        }
+        implementations.append(impl)
+        impl.SetColliders(shapes: colliderShapes, bounds: colliderAabbs, transforms: colliderTransforms,
+                          count: colliderShapes.count)
+        impl.SetTriangleMeshData(headers: triangleMeshContainer.headers, nodes: triangleMeshContainer.bihNodes,
+                                 triangles: triangleMeshContainer.triangles, vertices: triangleMeshContainer.vertices)
+        impl.SetDistanceFieldData(headers: distanceFieldContainer.headers, nodes: distanceFieldContainer.dfNodes)
+    }
+
+    public func UnregisterImplementation(_ impl: IColliderWorldImpl) {
+        implementations.removeAll { $0 === impl }
+    }
+
+    /// Hands the colliders to every implementation and lets them update their structures, call once per frame
+    /// before the solvers' collision detection.
+    public func UpdateWorld(deltaTime: Float) {
+        for impl in implementations {
+            impl.SetColliders(shapes: colliderShapes, bounds: colliderAabbs, transforms: colliderTransforms,
+                              count: colliderShapes.count)
+            impl.UpdateWorld(deltaTime: deltaTime)
+        }
+    }
 }
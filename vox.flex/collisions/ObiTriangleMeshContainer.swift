@@ -57,7 +57,7 @@ public struct TriangleMeshHeader // we need to use the header in the backend, so
 
 public class ObiTriangleMeshContainer {
     /// dictionary indexed by mesh, so that we don't generate data for the same mesh multiple times.
-//    public var handles: [Mesh: ObiTriangleMeshHandle] = [:]
+    public var handles: [ObjectIdentifier: ObiTriangleMeshHandle] = [:]
 
     /// One header per mesh.
     public var headers: [TriangleMeshHeader] = []
@@ -66,4 +66,51 @@ public class ObiTriangleMeshContainer {
     public var vertices: [Vector3] = []
 
     public init() {}
+
+    /// Returns the handle of `mesh`, referenced once more. Only its first reference stores its `vertices` and its
+    /// triangles, three `indices` each relative to the mesh's first vertex. Trees are built by the backends.
+    public func GetOrCreateTriangleMesh(mesh: ModelMesh, vertices meshVertices: [Vector3],
+                                        indices: [Int]) -> ObiTriangleMeshHandle
+    {
+        if let handle = handles[ObjectIdentifier(mesh)] {
+            handle.Reference()
+            return handle
+        }
+
+        let handle = ObiTriangleMeshHandle(mesh: mesh, index: headers.count)
+        headers.append(TriangleMeshHeader(firstNode: bihNodes.count, nodeCount: 0, firstTriangle: triangles.count,
+                                          triangleCount: indices.count / 3, firstVertex: vertices.count,
+                                          vertexCount: meshVertices.count))
+        for t in stride(from: 0, to: indices.count - 2, by: 3) {
+            triangles.append(Triangle(i1: indices[t], i2: indices[t + 1], i3: indices[t + 2],
+                                      v1: meshVertices[indices[t]], v2: meshVertices[indices[t + 1]],
+                                      v3: meshVertices[indices[t + 2]]))
+        }
+        vertices.append(contentsOf: meshVertices)
+        handle.Reference()
+        handles[ObjectIdentifier(mesh)] = handle
+        return handle
+    }
+
+    /// Dereferences `handle`, removing its mesh once no collider uses it. Later meshes move down to fill the gap.
+    public func DestroyTriangleMesh(handle: ObiTriangleMeshHandle) {
+        guard handle.isValid, handle.index < headers.count, handle.Dereference() else { return }
+
+        let index = handle.index
+        let header = headers[index]
+        bihNodes.removeSubrange(header.firstNode ..< header.firstNode + header.nodeCount)
+        triangles.removeSubrange(header.firstTriangle ..< header.firstTriangle + header.triangleCount)
+        vertices.removeSubrange(header.firstVertex ..< header.firstVertex + header.vertexCount)
+        headers.remove(at: index)
+        for i in index ..< headers.count {
+            headers[i].firstNode -= header.nodeCount
+            headers[i].firstTriangle -= header.triangleCount
+            headers[i].firstVertex -= header.vertexCount
+        }
+        for other in handles.values where other.index > index {
+            other.index -= 1
+        }
+        handles = handles.filter { $0.value !== handle }
+        handle.Invalidate()
+    }
 }
@@ -12,4 +12,14 @@ public struct ColliderRigidbody {
     public var angularVelocity: Vector4
     public var com: Vector4
     public var inverseMass: Float
+
+    public init(inverseInertiaTensor: Matrix = Matrix(), velocity: Vector4 = Vector4(), angularVelocity: Vector4 = Vector4(),
+                com: Vector4 = Vector4(), inverseMass: Float = 0)
+    {
+        self.inverseInertiaTensor = inverseInertiaTensor
+        self.velocity = velocity
+        self.angularVelocity = angularVelocity
+        self.com = com
+        self.inverseMass = inverseMass
+    }
 }
@@ -38,4 +38,21 @@ public struct ColliderShape {
     public var flags: Int
     /// whether the collider is 2D (1) or 3D (0)./
     public var is2D: Int
+
+    public init(center: Vector4 = Vector4(), size: Vector4 = Vector4(), type: ShapeType, contactOffset: Float = 0,
+                dataIndex: Int = -1, rigidbodyIndex: Int = -1, materialIndex: Int = -1,
+                filter: Int = ObiUtils.MakeFilter(mask: ObiUtils.CollideWithEverything, category: 0),
+                flags: Int = 0, is2D: Int = 0)
+    {
+        self.center = center
+        self.size = size
+        self.type = type
+        self.contactOffset = contactOffset
+        self.dataIndex = dataIndex
+        self.rigidbodyIndex = rigidbodyIndex
+        self.materialIndex = materialIndex
+        self.filter = filter
+        self.flags = flags
+        self.is2D = is2D
+    }
 }
@@ -46,11 +46,43 @@ public class ASDF {
 
     let sqrt3: Float = 1.73205
 
-    public static func Build(maxError _: Float, maxDepth _: Int,
-                             vertexPositions _: [Vector3], triangleIndices _: [Int],
-                             nodes _: [DFNode], yieldAfterNodeCount _: Int = 32) {}
+    public static func Build(maxError: Float, maxDepth: Int,
+                             vertexPositions: [Vector3], triangleIndices: [Int],
+                             nodes: inout [DFNode], yieldAfterNodeCount _: Int = 32)
+    {
+        nodes.removeAll()
+        guard !vertexPositions.isEmpty, !triangleIndices.isEmpty else { return }
 
-    public static func Sample(nodes _: [DFNode], position _: Vector3) -> Float {
-        0
+        let positions = vertexPositions.map { $0.internalValue }
+        let indices = triangleIndices.map { UInt32($0) }
+        let asdf = CASDF(positions: positions, vertexCount: UInt32(positions.count),
+                         indices: indices, indexCount: UInt32(indices.count))
+        asdf.build(withMaxError: maxError, maxDepth: UInt32(maxDepth))
+
+        let count = Int(asdf.nodeCount())
+        var distancesA = [SIMD4<Float>](repeating: .zero, count: count)
+        var distancesB = [SIMD4<Float>](repeating: .zero, count: count)
+        var centers = [SIMD4<Float>](repeating: .zero, count: count)
+        var firstChildren = [Int32](repeating: -1, count: count)
+        asdf.getNodes(&distancesA, &distancesB, &centers, &firstChildren)
+
+        nodes.reserveCapacity(count)
+        for i in 0 ..< count {
+            var node = DFNode(center: Vector4(centers[i].x, centers[i].y, centers[i].z, centers[i].w))
+            node.distancesA = Vector4(distancesA[i].x, distancesA[i].y, distancesA[i].z, distancesA[i].w)
+            node.distancesB = Vector4(distancesB[i].x, distancesB[i].y, distancesB[i].z, distancesB[i].w)
+            node.firstChild = Int(firstChildren[i])
+            nodes.append(node)
+        }
+    }
+
+    public static func Sample(nodes: [DFNode], position: Vector3) -> Float {
+        guard !nodes.isEmpty else { return 0 }
+
+        var nodeIndex = 0
+        while nodes[nodeIndex].firstChild >= 0 {
+            nodeIndex = nodes[nodeIndex].firstChild + nodes[nodeIndex].GetOctant(at: position)
+        }
+        return nodes[nodeIndex].Sample(at: position)
     }
 }
@@ -34,7 +34,7 @@ public struct DFNode {
     }
 
     public func GetNormalizedPos(at position: Vector3) -> Vector3 {
-        let size = center.z * 2
+        let size = center.w * 2
         return Vector3(
             (position.x - (center.x - center.w)) / size,
             (position.y - (center.y - center.w)) / size,
@@ -6,6 +6,7 @@
 
 import Math
 
+/// See BIH in native/data-structures/bih for the builder and traversals used by CPUColliderWorld meshes.
 public enum BIH {
     public static func Build(for _: [IBounded], maxDepth _: Int = 10, maxOverlap _: Float = 0.7) -> [BIHNode] {
         []
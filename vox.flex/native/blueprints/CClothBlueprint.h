@@ -0,0 +1,62 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../data-structures/constraint-batcher/CConstraintBatcher.h"
+#import "../data-structures/half-edge-mesh/CHalfEdgeMesh.h"
+#import <Foundation/Foundation.h>
+
+/// See ClothBlueprintParameters in ClothBlueprint.h.
+typedef struct {
+    float particleMass;
+    float drag;
+    float lift;
+    uint32_t batchRounds;
+} CClothBlueprintParameters;
+
+/// Particles and constraint batches of a cloth generated from its welded mesh, see ClothBlueprint.h.
+@interface CClothBlueprint : NSObject
+
+/// `invMasses` holds one inverse mass per welded vertex, nil for particles of particleMass and no tethers. A
+/// non-nil `cacheDirectory` reads the blueprint from it when it was generated before, and writes it otherwise.
+/// Returns true if it was read from the cache.
+- (BOOL)generateWithMesh:(CHalfEdgeMesh *_Nonnull)mesh
+              parameters:(CClothBlueprintParameters)parameters
+               invMasses:(const float *_Nullable)invMasses
+          cacheDirectory:(NSString *_Nullable)cacheDirectory;
+
+@property(nonatomic, readonly) uint64_t cacheKey;
+@property(nonatomic, readonly) uint32_t particleCount;
+@property(nonatomic, readonly) uint32_t distanceCount;
+@property(nonatomic, readonly) uint32_t distanceBatchCount;
+@property(nonatomic, readonly) uint32_t bendCount;
+@property(nonatomic, readonly) uint32_t bendBatchCount;
+@property(nonatomic, readonly) uint32_t aerodynamicCount;
+@property(nonatomic, readonly) uint32_t tetherCount;
+@property(nonatomic, readonly) uint32_t tetherIslandCount;
+
+- (void)getInvMasses:(float *_Nonnull)invMasses radii:(float *_Nonnull)radii;
+
+/// (a, b) pairs in batch order, their rest lengths and one entry per batch.
+- (void)getDistanceIndices:(int32_t *_Nonnull)indices
+               restLengths:(float *_Nonnull)restLengths
+                   batches:(CBatchData *_Nonnull)batches;
+
+/// (n1, n2, vertex) triplets in batch order, their rest bends and one entry per batch.
+- (void)getBendIndices:(int32_t *_Nonnull)indices
+             restBends:(float *_Nonnull)restBends
+               batches:(CBatchData *_Nonnull)batches;
+
+/// One particle and its area, drag and lift per constraint.
+- (void)getAerodynamicParticles:(int32_t *_Nonnull)particles coeffs:(float *_Nonnull)coeffs;
+
+/// (particle, anchor) pairs, geodesic distances and tetherIslandCount + 1 island offsets, see CTetherAnchors.
+- (void)getTethers:(int32_t *_Nonnull)tethers
+         distances:(float *_Nonnull)distances
+     islandOffsets:(int32_t *_Nonnull)islandOffsets;
+
+@end
@@ -0,0 +1,103 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CClothBlueprint.h"
+#import "../data-structures/half-edge-mesh/CHalfEdgeMeshInternal.h"
+#include "ClothBlueprint.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+static_assert(sizeof(ClothBlueprintParameters) == sizeof(CClothBlueprintParameters),
+              "ClothBlueprintParameters must match CClothBlueprintParameters layout");
+
+namespace {
+    void copyBatches(const std::vector<BatchData> &in, CBatchData *out) {
+        for (size_t i = 0; i < in.size(); ++i) {
+            const BatchData &batch = in[i];
+            out[i] = {batch.batchID,      batch.startIndex,    batch.constraintCount,
+                      batch.workItemSize, batch.workItemCount, batch.isLast};
+        }
+    }
+} // namespace
+
+@implementation CClothBlueprint {
+    ClothBlueprint _blueprint;
+}
+
+- (BOOL)generateWithMesh:(CHalfEdgeMesh *)mesh
+              parameters:(CClothBlueprintParameters)parameters
+               invMasses:(const float *)invMasses
+          cacheDirectory:(NSString *)cacheDirectory {
+    return _blueprint.generate(*[mesh nativeMesh], reinterpret_cast<const ClothBlueprintParameters &>(parameters),
+                               invMasses, cacheDirectory ? std::string(cacheDirectory.fileSystemRepresentation) : "");
+}
+
+- (uint64_t)cacheKey {
+    return _blueprint.key();
+}
+
+- (uint32_t)particleCount {
+    return uint32_t(_blueprint.particleCount());
+}
+
+- (uint32_t)distanceCount {
+    return uint32_t(_blueprint.restLengths().size());
+}
+
+- (uint32_t)distanceBatchCount {
+    return uint32_t(_blueprint.distanceBatches().size());
+}
+
+- (uint32_t)bendCount {
+    return uint32_t(_blueprint.restBends().size());
+}
+
+- (uint32_t)bendBatchCount {
+    return uint32_t(_blueprint.bendBatches().size());
+}
+
+- (uint32_t)aerodynamicCount {
+    return uint32_t(_blueprint.aerodynamicParticles().size());
+}
+
+- (uint32_t)tetherCount {
+    return uint32_t(_blueprint.tetherDistances().size());
+}
+
+- (uint32_t)tetherIslandCount {
+    return _blueprint.tetherIslandOffsets().empty() ? 0 : uint32_t(_blueprint.tetherIslandOffsets().size() - 1);
+}
+
+- (void)getInvMasses:(float *)invMasses radii:(float *)radii {
+    std::copy(_blueprint.invMasses().begin(), _blueprint.invMasses().end(), invMasses);
+    std::copy(_blueprint.radii().begin(), _blueprint.radii().end(), radii);
+}
+
+- (void)getDistanceIndices:(int32_t *)indices restLengths:(float *)restLengths batches:(CBatchData *)batches {
+    std::copy(_blueprint.distanceIndices().begin(), _blueprint.distanceIndices().end(), indices);
+    std::copy(_blueprint.restLengths().begin(), _blueprint.restLengths().end(), restLengths);
+    copyBatches(_blueprint.distanceBatches(), batches);
+}
+
+- (void)getBendIndices:(int32_t *)indices restBends:(float *)restBends batches:(CBatchData *)batches {
+    std::copy(_blueprint.bendIndices().begin(), _blueprint.bendIndices().end(), indices);
+    std::copy(_blueprint.restBends().begin(), _blueprint.restBends().end(), restBends);
+    copyBatches(_blueprint.bendBatches(), batches);
+}
+
+- (void)getAerodynamicParticles:(int32_t *)particles coeffs:(float *)coeffs {
+    std::copy(_blueprint.aerodynamicParticles().begin(), _blueprint.aerodynamicParticles().end(), particles);
+    std::copy(_blueprint.aerodynamicCoeffs().begin(), _blueprint.aerodynamicCoeffs().end(), coeffs);
+}
+
+- (void)getTethers:(int32_t *)tethers distances:(float *)distances islandOffsets:(int32_t *)islandOffsets {
+    std::copy(_blueprint.tethers().begin(), _blueprint.tethers().end(), tethers);
+    std::copy(_blueprint.tetherDistances().begin(), _blueprint.tetherDistances().end(), distances);
+    std::copy(_blueprint.tetherIslandOffsets().begin(), _blueprint.tetherIslandOffsets().end(), islandOffsets);
+}
+
+@end
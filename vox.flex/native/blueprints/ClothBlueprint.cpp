@@ -0,0 +1,359 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ClothBlueprint.h"
+#include "../common/Parallel.h"
+#include "../constraints/tether/TetherAnchors.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kEdgeGrain = 2048;
+        constexpr size_t kVertexGrain = 512;
+        constexpr char kCacheMagic[4] = {'V', 'X', 'C', 'B'};
+
+        struct CacheHeader {
+            char magic[4];
+            uint32_t version;
+            uint64_t key;
+        };
+
+        // FNV-1a over raw bytes.
+        uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+            const auto *bytes = static_cast<const uint8_t *>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return hash;
+        }
+
+        struct TripletProvider {
+            const int32_t *indices;
+            size_t count;
+
+            size_t constraintCount() const { return count; }
+
+            uint32_t particleCount(size_t) const { return 3; }
+
+            int32_t particle(size_t constraint, uint32_t index) const { return indices[constraint * 3 + index]; }
+        };
+
+        // Gathers constraints of `Width` indices each into batch order.
+        template <size_t Width>
+        void gatherIndices(const AlignedVector<int32_t> &in, AlignedVector<int32_t> &out,
+                           const std::vector<uint32_t> &sortedIndices) {
+            out.resize(in.size());
+            parallelFor(0, sortedIndices.size(), kEdgeGrain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    for (size_t k = 0; k < Width; ++k) {
+                        out[i * Width + k] = in[sortedIndices[i] * Width + k];
+                    }
+                }
+            });
+        }
+
+        template <typename T>
+        void writeArray(std::ofstream &file, const T &array) {
+            static_assert(std::is_trivially_copyable_v<typename T::value_type>);
+            const uint64_t count = array.size();
+            file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+            file.write(reinterpret_cast<const char *>(array.data()),
+                       std::streamsize(count * sizeof(typename T::value_type)));
+        }
+
+        // fails on counts larger than what is left of the file.
+        template <typename T>
+        bool readArray(std::ifstream &file, size_t &remaining, T &array) {
+            uint64_t count = 0;
+            if (!file.read(reinterpret_cast<char *>(&count), sizeof(count)) || remaining < sizeof(count)) {
+                return false;
+            }
+            remaining -= sizeof(count);
+            if (count > remaining / sizeof(typename T::value_type)) {
+                return false;
+            }
+            array.resize(size_t(count));
+            remaining -= size_t(count) * sizeof(typename T::value_type);
+            return bool(file.read(reinterpret_cast<char *>(array.data()),
+                                  std::streamsize(count * sizeof(typename T::value_type))));
+        }
+    } // namespace
+
+    uint64_t ClothBlueprint::cacheKey(const HalfEdgeMesh &mesh, const ClothBlueprintParameters &parameters,
+                                      const float *invMasses) {
+        uint64_t hash = 14695981039346656037ull;
+        const uint64_t meshHash = mesh.hash();
+        const uint32_t version = kCacheVersion;
+        hash = hashBytes(hash, &version, sizeof(version));
+        hash = hashBytes(hash, &meshHash, sizeof(meshHash));
+        hash = hashBytes(hash, &parameters.particleMass, sizeof(float));
+        hash = hashBytes(hash, &parameters.drag, sizeof(float));
+        hash = hashBytes(hash, &parameters.lift, sizeof(float));
+        hash = hashBytes(hash, &parameters.batchRounds, sizeof(uint32_t));
+        const uint8_t fixed = invMasses ? 1 : 0;
+        hash = hashBytes(hash, &fixed, sizeof(fixed));
+        if (invMasses) {
+            hash = hashBytes(hash, invMasses, mesh.vertexCount() * sizeof(float));
+        }
+        return hash;
+    }
+
+    std::string ClothBlueprint::cachePath(const std::string &directory, uint64_t key) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.clothblueprint", static_cast<unsigned long long>(key));
+        return directory.empty() || directory.back() == '/' ? directory + name : directory + '/' + name;
+    }
+
+    bool ClothBlueprint::generate(const HalfEdgeMesh &mesh, const ClothBlueprintParameters &parameters,
+                                  const float *invMasses, const std::string &cacheDirectory) {
+        const uint64_t key = cacheKey(mesh, parameters, invMasses);
+        if (!cacheDirectory.empty() && load(cachePath(cacheDirectory, key), key)) {
+            return true;
+        }
+
+        clear();
+        _key = key;
+        generateParticles(mesh, parameters, invMasses);
+        generateDistanceConstraints(mesh, parameters.batchRounds);
+        generateBendConstraints(mesh, parameters.batchRounds);
+        generateAerodynamicConstraints(mesh, parameters);
+        if (invMasses) {
+            generateTethers(mesh);
+        }
+        if (!cacheDirectory.empty()) {
+            save(cachePath(cacheDirectory, key));
+        }
+        return false;
+    }
+
+    void ClothBlueprint::clear() {
+        _key = 0;
+        _invMasses.clear();
+        _radii.clear();
+        _distanceIndices.clear();
+        _restLengths.clear();
+        _distanceBatches.clear();
+        _bendIndices.clear();
+        _restBends.clear();
+        _bendBatches.clear();
+        _aerodynamicParticles.clear();
+        _aerodynamicCoeffs.clear();
+        _tethers.clear();
+        _tetherDistances.clear();
+        _tetherIslandOffsets.clear();
+    }
+
+    void ClothBlueprint::generateParticles(const HalfEdgeMesh &mesh, const ClothBlueprintParameters &parameters,
+                                           const float *invMasses) {
+        const size_t count = mesh.vertexCount();
+        const auto &positions = mesh.positions();
+        const auto &halfEdges = mesh.halfEdges();
+        const auto &offsets = mesh.outgoingOffsets();
+        const auto &outgoing = mesh.outgoingHalfEdges();
+        const float invMass = parameters.particleMass > 0 ? 1 / parameters.particleMass : 0;
+        _invMasses.resize(count);
+        _radii.resize(count);
+        parallelFor(0, count, kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                _invMasses[v] = invMasses ? invMasses[v] : invMass;
+                float shortest = std::numeric_limits<float>::max();
+                for (int32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    shortest = std::min(shortest,
+                                        lengthSquared(positions[halfEdges[outgoing[i]].endVertex] - positions[v]));
+                }
+                _radii[v] = offsets[v] < offsets[v + 1] ? std::sqrt(shortest) * 0.5f : 0;
+            }
+        });
+    }
+
+    void ClothBlueprint::generateDistanceConstraints(const HalfEdgeMesh &mesh, uint32_t rounds) {
+        const auto &positions = mesh.positions();
+        const auto &edges = mesh.edges();
+        const size_t count = edges.size();
+        AlignedVector<int32_t> pairs(count * 2);
+        AlignedVector<float> restLengths(count);
+        parallelFor(0, count, kEdgeGrain, [&](size_t begin, size_t end) {
+            for (size_t e = begin; e < end; ++e) {
+                const int32_t a = mesh.startVertex(edges[e]), b = mesh.halfEdges()[edges[e]].endVertex;
+                pairs[e * 2] = a;
+                pairs[e * 2 + 1] = b;
+                restLengths[e] = length((positions[a] - positions[b]).xyz());
+            }
+        });
+
+        _batcher.batchPairs(pairs.data(), count, mesh.vertexCount(), sizeof(int32_t) * 2, _sortedIndices,
+                            _distanceBatches, rounds);
+        gatherIndices<2>(pairs, _distanceIndices, _sortedIndices);
+        _restLengths.resize(count);
+        ConstraintBatcher::reorder(restLengths.data(), _restLengths.data(), _sortedIndices);
+    }
+
+    void ClothBlueprint::generateBendConstraints(const HalfEdgeMesh &mesh, uint32_t rounds) {
+        const size_t vertexCount = mesh.vertexCount();
+        const auto &positions = mesh.positions();
+        const auto &halfEdges = mesh.halfEdges();
+        const auto &offsets = mesh.outgoingOffsets();
+        const auto &outgoing = mesh.outgoingHalfEdges();
+
+        // for every neighbor slot of a vertex, the slot of the neighbor most opposite to it, -1 if none is past
+        // a right angle.
+        std::vector<int32_t> opposite(outgoing.size());
+        std::vector<int32_t> counts(vertexCount + 1, 0);
+        parallelFor(0, vertexCount, kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                const float4 &center = positions[v];
+                for (int32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    const float3 d1 = normalize((positions[halfEdges[outgoing[i]].endVertex] - center).xyz());
+                    float cosBest = 0;
+                    int32_t best = -1;
+                    for (int32_t j = offsets[v]; j < offsets[v + 1]; ++j) {
+                        const float3 d2 = normalize((positions[halfEdges[outgoing[j]].endVertex] - center).xyz());
+                        const float cos = dot(d1, d2);
+                        if (cos < cosBest) {
+                            cosBest = cos;
+                            best = j;
+                        }
+                    }
+                    opposite[i] = best;
+                }
+                // mutually opposite neighbors make a single constraint.
+                int32_t count = 0;
+                for (int32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    count += opposite[i] >= 0 && (opposite[opposite[i]] != i || i < opposite[i]) ? 1 : 0;
+                }
+                counts[v] = count;
+            }
+        });
+        const size_t count = size_t(parallelExclusiveScan(counts.data(), counts.data(), vertexCount + 1));
+
+        AlignedVector<int32_t> triplets(count * 3);
+        AlignedVector<float> restBends(count);
+        parallelFor(0, vertexCount, kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                int32_t slot = counts[v];
+                for (int32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    const int32_t j = opposite[i];
+                    if (j < 0 || (opposite[j] == i && j < i)) {
+                        continue;
+                    }
+                    const int32_t n1 = halfEdges[outgoing[i]].endVertex, n2 = halfEdges[outgoing[j]].endVertex;
+                    const float4 centroid = (positions[n1] + positions[n2] + positions[v]) * (1.f / 3);
+                    triplets[slot * 3] = n1;
+                    triplets[slot * 3 + 1] = n2;
+                    triplets[slot * 3 + 2] = int32_t(v);
+                    restBends[slot++] = length((positions[v] - centroid).xyz());
+                }
+            }
+        });
+
+        _batcher.batchConstraints(TripletProvider{triplets.data(), count}, vertexCount, sizeof(int32_t) * 3,
+                                  _sortedIndices, _bendBatches, rounds);
+        gatherIndices<3>(triplets, _bendIndices, _sortedIndices);
+        _restBends.resize(count);
+        ConstraintBatcher::reorder(restBends.data(), _restBends.data(), _sortedIndices);
+    }
+
+    void ClothBlueprint::generateAerodynamicConstraints(const HalfEdgeMesh &mesh,
+                                                        const ClothBlueprintParameters &parameters) {
+        const size_t count = mesh.vertexCount();
+        const auto &areas = mesh.areaContributions();
+        _aerodynamicParticles.resize(count);
+        _aerodynamicCoeffs.resize(count * 3);
+        parallelFor(0, count, kEdgeGrain, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                _aerodynamicParticles[v] = int32_t(v);
+                _aerodynamicCoeffs[v * 3] = areas[v];
+                _aerodynamicCoeffs[v * 3 + 1] = parameters.drag;
+                _aerodynamicCoeffs[v * 3 + 2] = parameters.lift;
+            }
+        });
+    }
+
+    void ClothBlueprint::generateTethers(const HalfEdgeMesh &mesh) {
+        TetherAnchors anchors;
+        anchors.build(mesh.positions().data(), _invMasses.data(), mesh.vertexCount(), _distanceIndices.data(),
+                      _restLengths.size());
+        _tethers = anchors.tethers();
+        _tetherDistances = anchors.distances();
+        _tetherIslandOffsets = anchors.islandOffsets();
+    }
+
+    bool ClothBlueprint::save(const std::string &path) const {
+        // written aside then moved in place, so a reader never sees half a file.
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return false;
+            }
+            CacheHeader header{};
+            std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+            header.version = kCacheVersion;
+            header.key = _key;
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            writeArray(file, _invMasses);
+            writeArray(file, _radii);
+            writeArray(file, _distanceIndices);
+            writeArray(file, _restLengths);
+            writeArray(file, _distanceBatches);
+            writeArray(file, _bendIndices);
+            writeArray(file, _restBends);
+            writeArray(file, _bendBatches);
+            writeArray(file, _aerodynamicParticles);
+            writeArray(file, _aerodynamicCoeffs);
+            writeArray(file, _tethers);
+            writeArray(file, _tetherDistances);
+            writeArray(file, _tetherIslandOffsets);
+            if (!file.flush()) {
+                file.close();
+                std::remove(temporary.c_str());
+                return false;
+            }
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool ClothBlueprint::load(const std::string &path, uint64_t key) {
+        clear();
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return false;
+        }
+        size_t remaining = size_t(file.tellg());
+        file.seekg(0);
+        CacheHeader header{};
+        if (remaining < sizeof(header) || !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version != kCacheVersion ||
+            header.key != key) {
+            return false;
+        }
+        remaining -= sizeof(header);
+        const bool read = readArray(file, remaining, _invMasses) && readArray(file, remaining, _radii) &&
+                          readArray(file, remaining, _distanceIndices) &&
+                          readArray(file, remaining, _restLengths) &&
+                          readArray(file, remaining, _distanceBatches) && readArray(file, remaining, _bendIndices) &&
+                          readArray(file, remaining, _restBends) && readArray(file, remaining, _bendBatches) &&
+                          readArray(file, remaining, _aerodynamicParticles) &&
+                          readArray(file, remaining, _aerodynamicCoeffs) && readArray(file, remaining, _tethers) &&
+                          readArray(file, remaining, _tetherDistances) &&
+                          readArray(file, remaining, _tetherIslandOffsets);
+        if (!read) {
+            clear();
+            return false;
+        }
+        _key = key;
+        return true;
+    }
+} // namespace vox::flex
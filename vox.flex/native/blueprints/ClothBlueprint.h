@@ -0,0 +1,124 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/AlignedVector.h"
+#include "../data-structures/constraint-batcher/ConstraintBatcher.h"
+#include "../data-structures/half-edge-mesh/HalfEdgeMesh.h"
+#include <string>
+#include <vector>
+
+namespace vox::flex {
+    struct ClothBlueprintParameters {
+        // mass of every particle.
+        float particleMass = 0.1f;
+        float drag = 0.05f;
+        float lift = 0.05f;
+        // coloring rounds of the distance and bend batches, see ConstraintBatcher::batchConstraints.
+        uint32_t batchRounds = 4;
+    };
+
+    // Native counterpart of ObiClothBlueprint's generation: one particle per welded vertex of a HalfEdgeMesh,
+    //   distance:     one constraint per edge, at its rest length,
+    //   bend:         for every neighbor of a vertex, one constraint to the neighbor most opposite to it across
+    //                 the vertex (n1, n2, vertex), at the vertex's rest distance to the triangle's centroid,
+    //   aerodynamics: one constraint per particle, the area it represents being a third of its faces',
+    //   tethers:      to the fixed particles along the edges when inverse masses are given, see TetherAnchors.
+    // Distance and bend constraints are generated in parallel straight into arrays, then colored by a
+    // ConstraintBatcher and gathered in batch order. Aerodynamic constraints touch a single particle each and
+    // need no coloring; tethers come already batched by island.
+    //
+    // Generation can be cached in a directory: the file of a blueprint is named after a key hashing the mesh
+    // (HalfEdgeMesh::hash), the parameters and the inverse masses, so an unchanged garment is read back instead
+    // of generated. Batches of a cached blueprint are those of the run that wrote it.
+    class ClothBlueprint {
+    public:
+        static constexpr uint32_t kCacheVersion = 1;
+
+        static uint64_t cacheKey(const HalfEdgeMesh &mesh, const ClothBlueprintParameters &parameters,
+                                 const float *invMasses);
+
+        static std::string cachePath(const std::string &directory, uint64_t key);
+
+        // `invMasses` holds one inverse mass per welded vertex, or is null for particles of particleMass. An
+        // empty `cacheDirectory` disables caching. Returns true if the blueprint was read from the cache.
+        bool generate(const HalfEdgeMesh &mesh, const ClothBlueprintParameters &parameters,
+                      const float *invMasses = nullptr, const std::string &cacheDirectory = {});
+
+        // Both return false on failure, a failed load leaving the blueprint empty.
+        bool save(const std::string &path) const;
+
+        bool load(const std::string &path, uint64_t key);
+
+        void clear();
+
+        uint64_t key() const { return _key; }
+
+        size_t particleCount() const { return _invMasses.size(); }
+
+        const AlignedVector<float> &invMasses() const { return _invMasses; }
+
+        // half the length of the shortest edge around every particle.
+        const AlignedVector<float> &radii() const { return _radii; }
+
+        // (a, b) pairs in batch order.
+        const AlignedVector<int32_t> &distanceIndices() const { return _distanceIndices; }
+
+        const AlignedVector<float> &restLengths() const { return _restLengths; }
+
+        const std::vector<BatchData> &distanceBatches() const { return _distanceBatches; }
+
+        // (n1, n2, vertex) triplets in batch order.
+        const AlignedVector<int32_t> &bendIndices() const { return _bendIndices; }
+
+        const AlignedVector<float> &restBends() const { return _restBends; }
+
+        const std::vector<BatchData> &bendBatches() const { return _bendBatches; }
+
+        const AlignedVector<int32_t> &aerodynamicParticles() const { return _aerodynamicParticles; }
+
+        // area, drag and lift per constraint.
+        const AlignedVector<float> &aerodynamicCoeffs() const { return _aerodynamicCoeffs; }
+
+        // (particle, anchor) pairs, see TetherAnchors.
+        const AlignedVector<int32_t> &tethers() const { return _tethers; }
+
+        const AlignedVector<float> &tetherDistances() const { return _tetherDistances; }
+
+        const AlignedVector<int32_t> &tetherIslandOffsets() const { return _tetherIslandOffsets; }
+
+    private:
+        void generateParticles(const HalfEdgeMesh &mesh, const ClothBlueprintParameters &parameters,
+                               const float *invMasses);
+
+        void generateDistanceConstraints(const HalfEdgeMesh &mesh, uint32_t rounds);
+
+        void generateBendConstraints(const HalfEdgeMesh &mesh, uint32_t rounds);
+
+        void generateAerodynamicConstraints(const HalfEdgeMesh &mesh, const ClothBlueprintParameters &parameters);
+
+        void generateTethers(const HalfEdgeMesh &mesh);
+
+        uint64_t _key = 0;
+        AlignedVector<float> _invMasses;
+        AlignedVector<float> _radii;
+        AlignedVector<int32_t> _distanceIndices;
+        AlignedVector<float> _restLengths;
+        std::vector<BatchData> _distanceBatches;
+        AlignedVector<int32_t> _bendIndices;
+        AlignedVector<float> _restBends;
+        std::vector<BatchData> _bendBatches;
+        AlignedVector<int32_t> _aerodynamicParticles;
+        AlignedVector<float> _aerodynamicCoeffs;
+        AlignedVector<int32_t> _tethers;
+        AlignedVector<float> _tetherDistances;
+        AlignedVector<int32_t> _tetherIslandOffsets;
+
+        ConstraintBatcher _batcher;
+        std::vector<uint32_t> _sortedIndices;
+    };
+} // namespace vox::flex
@@ -0,0 +1,30 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "blueprints/CClothBlueprint.h"
+#include "collisions/CColliderWorld.h"
+#include "constraints/aerodynamics/CAerodynamicConstraintsBatch.h"
+#include "constraints/bend-twist/CBendTwistConstraintsBatch.h"
+#include "constraints/chain/CChainConstraintsBatch.h"
+#include "constraints/distance/CDistanceConstraintsBatch.h"
+#include "constraints/shape-matching/CShapeMatchingConstraintsBatch.h"
+#include "constraints/skin/CSkinConstraintsBatch.h"
+#include "constraints/stretch-shear/CStretchShearConstraintsBatch.h"
+#include "constraints/tether/CTetherAnchors.h"
+#include "constraints/tether/CTetherConstraintsBatch.h"
+#include "constraints/volume/CVolumeConstraintsBatch.h"
+#include "data-structures/asdf/CASDF.h"
+#include "data-structures/constraint-batcher/CConstraintBatcher.h"
+#include "data-structures/constraint-batcher/CConstraintSorter.h"
+#include "data-structures/half-edge-mesh/CHalfEdgeMesh.h"
+#include "data-structures/multilevel-grid/CMultilevelGrid.h"
+#include "hash-grid/CPointHashGridSearcher.h"
+#include "solver/CConstraintsBatch.h"
+#include "solver/CSolverImpl.h"
+#include "sort/CRadixSort.h"
+#include "sph/CSphSolver.h"
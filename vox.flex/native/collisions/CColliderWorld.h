@@ -0,0 +1,141 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+/// See ColliderShape in ColliderShape.h, `type` is a ColliderShape.ShapeType raw value.
+typedef struct {
+    simd_float4 center;
+    simd_float4 size;
+    int32_t type;
+    float contactOffset;
+    int32_t dataIndex;
+    int32_t rigidbodyIndex;
+    int32_t materialIndex;
+    int32_t filter;
+    int32_t flags;
+    int32_t is2D;
+} CColliderShape;
+
+typedef struct {
+    simd_float4 min;
+    simd_float4 max;
+} CAabb;
+
+typedef struct {
+    simd_float4 translation;
+    simd_float4 scale;
+    simd_quatf rotation;
+} CAffineTransform;
+
+typedef struct {
+    simd_float4x4 inverseInertiaTensor;
+    simd_float4 velocity;
+    simd_float4 angularVelocity;
+    simd_float4 com;
+    float inverseMass;
+} CColliderRigidbody;
+
+/// Combine modes are Oni.MaterialCombineMode raw values.
+typedef struct {
+    float dynamicFriction;
+    float staticFriction;
+    float rollingFriction;
+    float stickiness;
+    float stickDistance;
+    int32_t frictionCombine;
+    int32_t stickinessCombine;
+    int32_t rollingContacts;
+} CCollisionMaterial;
+
+/// Native collider world: one array per collider attribute, filled in place from Swift and read directly by
+/// solvers. Arrays stay valid until their count changes.
+@interface CColliderWorld : NSObject
+
+- (instancetype _Nonnull)init;
+
+/// New colliders are empty until given bounds.
+@property(nonatomic) uint32_t colliderCount;
+
+- (CColliderShape *_Nonnull)shapes;
+/// world space bounds, contact offset included.
+- (CAabb *_Nonnull)bounds;
+- (CAffineTransform *_Nonnull)transforms;
+
+@property(nonatomic) uint32_t rigidbodyCount;
+
+- (CColliderRigidbody *_Nonnull)rigidbodies;
+
+@property(nonatomic) uint32_t materialCount;
+
+- (CCollisionMaterial *_Nonnull)materials;
+
+/// Replaces the distance fields of SignedDistanceField colliders. Headers are (first node, node count) ranges of
+/// the node arrays, laid out as CASDF nodes with child indices relative to the first node of their field.
+- (void)setDistanceFieldHeaders:(const simd_int2 *_Nullable)headers
+                    headerCount:(uint32_t)headerCount
+                     distancesA:(const simd_float4 *_Nullable)distancesA
+                     distancesB:(const simd_float4 *_Nullable)distancesB
+                        centers:(const simd_float4 *_Nullable)centers
+                  firstChildren:(const int32_t *_Nullable)firstChildren
+                      nodeCount:(uint32_t)nodeCount;
+
+- (uint32_t)distanceFieldCount;
+
+/// Number of heightfields of Heightmap colliders, new ones being empty until set.
+@property(nonatomic) uint32_t heightFieldCount;
+
+/// Replaces heightfield `index` by `resolutionU` x `resolutionV` normalized samples, row major along u, and its
+/// hole flags, one per cell (non zero for holes), nil for none.
+- (void)setHeightField:(uint32_t)index
+           resolutionU:(uint32_t)resolutionU
+           resolutionV:(uint32_t)resolutionV
+               samples:(const float *_Nonnull)samples
+                 holes:(const uint8_t *_Nullable)holes;
+
+/// Rewrites the `width` x `height` samples of heightfield `index` starting at sample (u, v), and the hole flags of
+/// the cells starting at cell (u, v) if `holes` is not nil, without rebuilding the rest of it.
+- (void)updateHeightField:(uint32_t)index
+                        u:(uint32_t)u
+                        v:(uint32_t)v
+                    width:(uint32_t)width
+                   height:(uint32_t)height
+                  samples:(const float *_Nonnull)samples
+                    holes:(const uint8_t *_Nullable)holes;
+
+/// Content key of a mesh of `triangleCount` triangles, three indices of `vertices` each.
++ (uint64_t)keyForTriangleMeshVertices:(const simd_float3 *_Nonnull)vertices
+                           vertexCount:(uint32_t)vertexCount
+                               indices:(const int32_t *_Nonnull)indices
+                         triangleCount:(uint32_t)triangleCount;
+
+/// Returns the index of the TriangleMesh collider data of `key`, referenced once more. Only the first reference
+/// of a key copies the mesh and builds its tree, later ones share them.
+- (int32_t)acquireTriangleMesh:(uint64_t)key
+                      vertices:(const simd_float3 *_Nonnull)vertices
+                   vertexCount:(uint32_t)vertexCount
+                       indices:(const int32_t *_Nonnull)indices
+                 triangleCount:(uint32_t)triangleCount;
+
+/// Drops one reference to mesh `index`, returns YES if that freed it.
+- (BOOL)releaseTriangleMesh:(int32_t)index;
+
+- (int32_t)triangleMeshReferenceCount:(int32_t)index;
+
+/// Number of tree nodes of mesh `index`, 0 for free indices.
+- (uint32_t)triangleMeshNodeCount:(int32_t)index;
+
+- (void)clearTriangleMeshes;
+
+/// Moves the colliders whose bounds, swept by their rigidbody velocity over `deltaTime`, changed cells.
+- (void)updateWorld:(float)deltaTime;
+
+- (uint32_t)cellCount;
+
+@end
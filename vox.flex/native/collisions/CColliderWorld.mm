@@ -0,0 +1,186 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CColliderWorldInternal.h"
+#include <memory>
+
+using namespace vox::flex;
+
+static_assert(sizeof(CColliderShape) == sizeof(ColliderShape), "CColliderShape must match ColliderShape");
+static_assert(sizeof(CAabb) == sizeof(Aabb), "CAabb must match Aabb");
+static_assert(sizeof(CAffineTransform) == sizeof(AffineTransform), "CAffineTransform must match AffineTransform");
+static_assert(sizeof(CColliderRigidbody) == sizeof(ColliderRigidbody),
+              "CColliderRigidbody must match ColliderRigidbody");
+static_assert(sizeof(CCollisionMaterial) == sizeof(CollisionMaterial),
+              "CCollisionMaterial must match CollisionMaterial");
+static_assert(sizeof(float3) == sizeof(simd_float3), "float3 must match simd_float3 layout");
+
+@implementation CColliderWorld {
+    std::unique_ptr<ColliderWorld> _world;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _world = std::make_unique<ColliderWorld>();
+    }
+    return self;
+}
+
+- (ColliderWorld *)nativeWorld {
+    return _world.get();
+}
+
+- (uint32_t)colliderCount {
+    return static_cast<uint32_t>(_world->colliderCount());
+}
+
+- (void)setColliderCount:(uint32_t)colliderCount {
+    _world->setColliderCount(colliderCount);
+}
+
+- (CColliderShape *)shapes {
+    return reinterpret_cast<CColliderShape *>(_world->shapes().data());
+}
+
+- (CAabb *)bounds {
+    return reinterpret_cast<CAabb *>(_world->bounds().data());
+}
+
+- (CAffineTransform *)transforms {
+    return reinterpret_cast<CAffineTransform *>(_world->transforms().data());
+}
+
+- (uint32_t)rigidbodyCount {
+    return static_cast<uint32_t>(_world->rigidbodies().size());
+}
+
+- (void)setRigidbodyCount:(uint32_t)rigidbodyCount {
+    _world->rigidbodies().resize(rigidbodyCount);
+}
+
+- (CColliderRigidbody *)rigidbodies {
+    return reinterpret_cast<CColliderRigidbody *>(_world->rigidbodies().data());
+}
+
+- (uint32_t)materialCount {
+    return static_cast<uint32_t>(_world->materials().size());
+}
+
+- (void)setMaterialCount:(uint32_t)materialCount {
+    _world->materials().resize(materialCount);
+}
+
+- (CCollisionMaterial *)materials {
+    return reinterpret_cast<CCollisionMaterial *>(_world->materials().data());
+}
+
+- (void)setDistanceFieldHeaders:(const simd_int2 *)headers
+                    headerCount:(uint32_t)headerCount
+                     distancesA:(const simd_float4 *)distancesA
+                     distancesB:(const simd_float4 *)distancesB
+                        centers:(const simd_float4 *)centers
+                  firstChildren:(const int32_t *)firstChildren
+                      nodeCount:(uint32_t)nodeCount {
+    std::vector<DistanceFieldHeader> &nativeHeaders = _world->distanceFieldHeaders();
+    nativeHeaders.resize(headerCount);
+    for (uint32_t i = 0; i < headerCount; ++i) {
+        nativeHeaders[i] = {headers[i].x, headers[i].y};
+    }
+
+    std::vector<DFNode> &nodes = _world->distanceFieldNodes();
+    nodes.resize(nodeCount);
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        DFNode &node = nodes[i];
+        node.distancesA = float4(distancesA[i].x, distancesA[i].y, distancesA[i].z, distancesA[i].w);
+        node.distancesB = float4(distancesB[i].x, distancesB[i].y, distancesB[i].z, distancesB[i].w);
+        node.center = float4(centers[i].x, centers[i].y, centers[i].z, centers[i].w);
+        node.firstChild = firstChildren[i];
+    }
+}
+
+- (uint32_t)distanceFieldCount {
+    return static_cast<uint32_t>(_world->distanceFieldHeaders().size());
+}
+
+- (uint32_t)heightFieldCount {
+    return static_cast<uint32_t>(_world->heightFields().size());
+}
+
+- (void)setHeightFieldCount:(uint32_t)heightFieldCount {
+    _world->heightFields().resize(heightFieldCount);
+}
+
+- (void)setHeightField:(uint32_t)index
+           resolutionU:(uint32_t)resolutionU
+           resolutionV:(uint32_t)resolutionV
+               samples:(const float *)samples
+                 holes:(const uint8_t *)holes {
+    HeightField &field = _world->heightFields()[index];
+    field.resize(int32_t(resolutionU), int32_t(resolutionV));
+    field.setSamples(0, 0, int32_t(resolutionU), int32_t(resolutionV), samples);
+    if (holes != nullptr) {
+        field.setHoles(0, 0, field.cellCountU(), field.cellCountV(), holes);
+    }
+}
+
+- (void)updateHeightField:(uint32_t)index
+                        u:(uint32_t)u
+                        v:(uint32_t)v
+                    width:(uint32_t)width
+                   height:(uint32_t)height
+                  samples:(const float *)samples
+                    holes:(const uint8_t *)holes {
+    HeightField &field = _world->heightFields()[index];
+    field.setSamples(int32_t(u), int32_t(v), int32_t(width), int32_t(height), samples);
+    if (holes != nullptr) {
+        field.setHoles(int32_t(u), int32_t(v), int32_t(width), int32_t(height), holes);
+    }
+}
+
++ (uint64_t)keyForTriangleMeshVertices:(const simd_float3 *)vertices
+                           vertexCount:(uint32_t)vertexCount
+                               indices:(const int32_t *)indices
+                         triangleCount:(uint32_t)triangleCount {
+    return TriangleMeshContainer::hashMesh(reinterpret_cast<const float3 *>(vertices), vertexCount, indices,
+                                           triangleCount);
+}
+
+- (int32_t)acquireTriangleMesh:(uint64_t)key
+                      vertices:(const simd_float3 *)vertices
+                   vertexCount:(uint32_t)vertexCount
+                       indices:(const int32_t *)indices
+                 triangleCount:(uint32_t)triangleCount {
+    return _world->triangleMeshes().acquire(key, reinterpret_cast<const float3 *>(vertices), vertexCount, indices,
+                                            triangleCount);
+}
+
+- (BOOL)releaseTriangleMesh:(int32_t)index {
+    return _world->triangleMeshes().release(index);
+}
+
+- (int32_t)triangleMeshReferenceCount:(int32_t)index {
+    return _world->triangleMeshes().referenceCount(index);
+}
+
+- (uint32_t)triangleMeshNodeCount:(int32_t)index {
+    const TriangleMeshContainer &meshes = _world->triangleMeshes();
+    return meshes.contains(index) ? static_cast<uint32_t>(meshes.mesh(index).nodes.size()) : 0;
+}
+
+- (void)clearTriangleMeshes {
+    _world->triangleMeshes().clear();
+}
+
+- (void)updateWorld:(float)deltaTime {
+    _world->updateWorld(deltaTime);
+}
+
+- (uint32_t)cellCount {
+    return static_cast<uint32_t>(_world->grid().cellCount());
+}
+
+@end
@@ -0,0 +1,17 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "CColliderWorld.h"
+#include "ColliderWorld.h"
+
+/// Native access for the solver facade, Objective-C++ only.
+@interface CColliderWorld ()
+
+- (vox::flex::ColliderWorld *_Nonnull)nativeWorld;
+
+@end
@@ -0,0 +1,486 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ColliderContacts.h"
+#include "CollisionMath.h"
+#include "ShapeDistanceFunctions.h"
+#include "../common/Parallel.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kCandidateGrain = 1024;
+        constexpr uint32_t kBatchSize = 256;
+        constexpr size_t kLanes = ShapeLanes::kLanes;
+
+        constexpr uint32_t kTypeCount = uint32_t(ColliderShape::Type::SignedDistanceField) + 1;
+        // key of the candidates no kernel handles, sorted after every other.
+        constexpr uint32_t kDroppedKey = kTypeCount * 2;
+
+        uint32_t keyFor(ColliderShape::Type type, bool simplex) { return uint32_t(type) * 2 + (simplex ? 1 : 0); }
+
+        ColliderShape::Type typeOfKey(uint32_t key) { return ColliderShape::Type(key / 2); }
+
+        // candidates traverse a mesh together while their bounds stay within this many times the size of the
+        // largest of them, farther apart they would visit disjoint subtrees anyway.
+        constexpr float kPacketSpread = 4;
+
+        // spreads the low 10 bits of `v` to every third bit.
+        uint32_t spreadBits(uint32_t v) {
+            v &= 0x3ff;
+            v = (v | (v << 16)) & 0x030000ff;
+            v = (v | (v << 8)) & 0x0300f00f;
+            v = (v | (v << 4)) & 0x030c30c3;
+            return (v | (v << 2)) & 0x09249249;
+        }
+
+        // Morton code of `point` in a 1024^3 grid over `bounds`.
+        uint32_t mortonCode(const float4 &point, const Aabb &bounds) {
+            const float3 extent = max(bounds.size().xyz(), float3(1e-6f));
+            const float3 cell = (point - bounds.min).xyz() / extent * 1023.f;
+            return spreadBits(uint32_t(std::clamp(cell.x, 0.f, 1023.f))) |
+                   (spreadBits(uint32_t(std::clamp(cell.y, 0.f, 1023.f))) << 1) |
+                   (spreadBits(uint32_t(std::clamp(cell.z, 0.f, 1023.f))) << 2);
+        }
+
+        // rotates the vectors of every lane by their quaternion, or its conjugate.
+        void rotateLanes(const float *qx, const float *qy, const float *qz, const float *qw, bool inverse, float *x,
+                         float *y, float *z) {
+            const float sign = inverse ? -1.f : 1.f;
+            for (size_t i = 0; i < kLanes; ++i) {
+                const float ux = qx[i] * sign, uy = qy[i] * sign, uz = qz[i] * sign;
+                const float tx = (uy * z[i] - uz * y[i]) * 2;
+                const float ty = (uz * x[i] - ux * z[i]) * 2;
+                const float tz = (ux * y[i] - uy * x[i]) * 2;
+                x[i] += tx * qw[i] + (uy * tz - uz * ty);
+                y[i] += ty * qw[i] + (uz * tx - ux * tz);
+                z[i] += tz * qw[i] + (ux * ty - uy * tx);
+            }
+        }
+    } // namespace
+
+    struct ColliderContactGenerator::Context {
+        const ColliderWorld &world;
+        const AffineTransform &worldToSolver;
+        const AffineTransform &solverToWorld;
+        // transform of every collider of the world to solver space.
+        const AffineTransform *colliderToSolver;
+        const ParticleData &particles;
+        const int32_t *simplices;
+        const SimplexCounts &simplexCounts;
+        const Aabb *simplexBounds;
+        const ColliderCandidate *candidates;
+        const uint32_t *order;
+        ContactParameters parameters;
+
+        // Fills `contact` and returns true if the simplex point, moving at `velocity` relative to the collider,
+        // may get within the contact offset plus the collision margin of the collider surface over the step.
+        bool makeContact(const ColliderCandidate &candidate, const float4 &bary, const float4 &simplexPoint,
+                         const float4 &velocity, float radius, const float4 &surfacePoint, const float4 &normal,
+                         Contact &contact) const {
+            const ColliderShape &shape = world.shapes()[candidate.collider];
+            float4 relativeVelocity = velocity;
+            if (shape.rigidbodyIndex >= 0 && size_t(shape.rigidbodyIndex) < world.rigidbodies().size()) {
+                // the rigidbody moves in world space.
+                const ColliderRigidbody &rigidbody = world.rigidbodies()[shape.rigidbodyIndex];
+                const float4 bodyVelocity = rigidbody.velocityAtPoint(solverToWorld.transformPoint(surfacePoint));
+                relativeVelocity -= worldToSolver.transformVector(bodyVelocity);
+            }
+            const float distance = dot((simplexPoint - surfacePoint).xyz(), normal.xyz());
+            const float approach = dot(relativeVelocity.xyz(), normal.xyz()) * parameters.stepTime;
+            if (approach + distance > radius + shape.contactOffset + parameters.collisionMargin) {
+                return false;
+            }
+            contact = Contact();
+            contact.pointA = bary;
+            contact.pointB = surfacePoint;
+            contact.normal = normal;
+            contact.distance = distance - radius;
+            contact.bodyA = candidate.simplex;
+            contact.bodyB = candidate.collider;
+            return true;
+        }
+
+        // Appends the contact of a simplex against a triangle of a heightfield or mesh collider, if any. Single
+        // particles are projected from `localPoint`, their position in the collider frame.
+        void triangleContact(const ColliderCandidate &candidate, int32_t start, int32_t size, const float4 &localPoint,
+                             const TriangleShape &triangle, std::vector<Contact> &contacts) const {
+            const ParticleData &p = particles;
+            Contact contact;
+            if (size == 1) {
+                const int32_t particle = simplices[start];
+                float4 point, normal;
+                triangle.project(localPoint, point, normal);
+                if (makeContact(candidate, float4(1, 0, 0, 0), p.positions[particle], p.velocities[particle],
+                                p.principalRadii[particle].x, triangle.transform.transformPointUnscaled(point),
+                                triangle.transform.transformDirection(normal), contact)) {
+                    contacts.push_back(contact);
+                }
+                return;
+            }
+
+            float4 bary = barycenterForSimplexOfSize(size);
+            float4 simplexPoint;
+            const SurfacePoint surfacePoint = LocalOptimization::optimize(
+                triangle, p.positions.data(), p.orientations.data(), p.principalRadii.data(), simplices, start, size,
+                bary, simplexPoint, parameters.optimizationIterations, parameters.optimizationTolerance);
+            float4 velocity;
+            float radius = 0;
+            for (int32_t j = 0; j < size; ++j) {
+                const int32_t particle = simplices[start + j];
+                velocity += p.velocities[particle] * bary[j];
+                radius += p.principalRadii[particle].x * bary[j];
+            }
+            if (makeContact(candidate, bary, simplexPoint, velocity, radius, surfacePoint.point, surfacePoint.normal,
+                            contact)) {
+                contacts.push_back(contact);
+            }
+        }
+    };
+
+    template <typename Shape>
+    void ColliderContactGenerator::processBatch(const Context &context, const Batch &batch,
+                                                std::vector<Contact> &contacts) {
+        if (batch.key % 2 == 0) {
+            processParticles<Shape>(context, batch, contacts);
+        } else {
+            processSimplices<Shape>(context, batch, contacts);
+        }
+    }
+
+    template <typename Shape>
+    void ColliderContactGenerator::processParticles(const Context &context, const Batch &batch,
+                                                    std::vector<Contact> &contacts) {
+        const ParticleData &p = context.particles;
+        ShapeLanes lanes;
+        alignas(32) float qx[kLanes], qy[kLanes], qz[kLanes], qw[kLanes];
+        alignas(32) float tx[kLanes], ty[kLanes], tz[kLanes];
+        int32_t particles[kLanes];
+        const float4 bary(1, 0, 0, 0);
+
+        for (uint32_t base = batch.begin; base < batch.end; base += kLanes) {
+            const size_t laneCount = std::min<size_t>(kLanes, batch.end - base);
+            // gather, repeating the last candidate in the unused lanes.
+            for (size_t l = 0; l < kLanes; ++l) {
+                const size_t index = base + std::min(l, laneCount - 1);
+                const ColliderCandidate &candidate = context.candidates[context.order[index]];
+                int32_t size;
+                particles[l] = context.simplices[context.simplexCounts.getSimplexStartAndSize(candidate.simplex, size)];
+                const AffineTransform &transform = context.colliderToSolver[candidate.collider];
+                Shape(context.world, candidate.collider, transform).loadLane(lanes, l);
+
+                qx[l] = transform.rotation.x;
+                qy[l] = transform.rotation.y;
+                qz[l] = transform.rotation.z;
+                qw[l] = transform.rotation.w;
+                tx[l] = transform.translation.x;
+                ty[l] = transform.translation.y;
+                tz[l] = transform.translation.z;
+                const float4 &position = p.positions[particles[l]];
+                lanes.x[l] = position.x;
+                lanes.y[l] = position.y;
+                lanes.z[l] = position.z;
+            }
+
+            // to the collider frame and back around the shape kernel.
+            for (size_t l = 0; l < kLanes; ++l) {
+                lanes.x[l] -= tx[l];
+                lanes.y[l] -= ty[l];
+                lanes.z[l] -= tz[l];
+            }
+            rotateLanes(qx, qy, qz, qw, true, lanes.x, lanes.y, lanes.z);
+            Shape::projectLanes(lanes);
+            rotateLanes(qx, qy, qz, qw, false, lanes.x, lanes.y, lanes.z);
+            rotateLanes(qx, qy, qz, qw, false, lanes.nx, lanes.ny, lanes.nz);
+            for (size_t l = 0; l < kLanes; ++l) {
+                lanes.x[l] += tx[l];
+                lanes.y[l] += ty[l];
+                lanes.z[l] += tz[l];
+            }
+
+            for (size_t l = 0; l < laneCount; ++l) {
+                const ColliderCandidate &candidate = context.candidates[context.order[base + l]];
+                const int32_t particle = particles[l];
+                Contact contact;
+                if (context.makeContact(candidate, bary, p.positions[particle], p.velocities[particle],
+                                        p.principalRadii[particle].x, float4(lanes.x[l], lanes.y[l], lanes.z[l], 0),
+                                        float4(lanes.nx[l], lanes.ny[l], lanes.nz[l], 0), contact)) {
+                    contacts.push_back(contact);
+                }
+            }
+        }
+    }
+
+    template <typename Shape>
+    void ColliderContactGenerator::processSimplices(const Context &context, const Batch &batch,
+                                                    std::vector<Contact> &contacts) {
+        const ParticleData &p = context.particles;
+        const ContactParameters &parameters = context.parameters;
+        for (uint32_t i = batch.begin; i < batch.end; ++i) {
+            const ColliderCandidate &candidate = context.candidates[context.order[i]];
+            int32_t size;
+            const int32_t start = context.simplexCounts.getSimplexStartAndSize(candidate.simplex, size);
+
+            const Shape shape(context.world, candidate.collider, context.colliderToSolver[candidate.collider]);
+            float4 bary = barycenterForSimplexOfSize(size);
+            float4 simplexPoint;
+            const SurfacePoint surfacePoint = LocalOptimization::optimize(
+                shape, p.positions.data(), p.orientations.data(), p.principalRadii.data(), context.simplices, start,
+                size, bary, simplexPoint, parameters.optimizationIterations, parameters.optimizationTolerance);
+
+            float4 velocity;
+            float radius = 0;
+            for (int32_t j = 0; j < size; ++j) {
+                const int32_t particle = context.simplices[start + j];
+                velocity += p.velocities[particle] * bary[j];
+                radius += p.principalRadii[particle].x * bary[j];
+            }
+            Contact contact;
+            if (context.makeContact(candidate, bary, simplexPoint, velocity, radius, surfacePoint.point,
+                                    surfacePoint.normal, contact)) {
+                contacts.push_back(contact);
+            }
+        }
+    }
+
+    void ColliderContactGenerator::processHeightFields(const Context &context, const Batch &batch,
+                                                       std::vector<Contact> &contacts) {
+        const ParticleData &p = context.particles;
+        for (uint32_t i = batch.begin; i < batch.end; ++i) {
+            const ColliderCandidate &candidate = context.candidates[context.order[i]];
+            int32_t size;
+            const int32_t start = context.simplexCounts.getSimplexStartAndSize(candidate.simplex, size);
+
+            const HeightFieldShape shape(context.world, candidate.collider,
+                                         context.colliderToSolver[candidate.collider]);
+            Aabb bounds = context.simplexBounds[candidate.simplex];
+            bounds.expand(float4(context.world.shapes()[candidate.collider].contactOffset));
+            float4 local = shape.transform.inverseTransformPointUnscaled(p.positions[context.simplices[start]]);
+            if (shape.is2D) {
+                local.z = 0;
+            }
+            shape.forEachTriangle(bounds, [&](const TriangleShape &triangle) {
+                context.triangleContact(candidate, start, size, local, triangle, contacts);
+            });
+        }
+    }
+
+    void ColliderContactGenerator::processTriangleMeshes(const Context &context, const Batch &batch,
+                                                         std::vector<Contact> &contacts) {
+        const ParticleData &p = context.particles;
+        // the batch by collider then along a Morton curve, so neighbouring candidates of a collider follow
+        // each other.
+        const uint32_t count = batch.end - batch.begin;
+        Aabb batchBounds;
+        for (uint32_t i = batch.begin; i < batch.end; ++i) {
+            const ColliderCandidate &candidate = context.candidates[context.order[i]];
+            batchBounds.encapsulateParticle(context.simplexBounds[candidate.simplex].center(), 0);
+        }
+        uint64_t sortKeys[kBatchSize];
+        uint32_t sorted[kBatchSize];
+        for (uint32_t i = 0; i < count; ++i) {
+            const ColliderCandidate &candidate = context.candidates[context.order[batch.begin + i]];
+            const uint32_t code = mortonCode(context.simplexBounds[candidate.simplex].center(), batchBounds);
+            sortKeys[i] = (uint64_t(uint32_t(candidate.collider)) << 32) | code;
+            sorted[i] = i;
+        }
+        std::sort(sorted, sorted + count, [&](uint32_t a, uint32_t b) { return sortKeys[a] < sortKeys[b]; });
+        for (uint32_t i = 0; i < count; ++i) {
+            sorted[i] = context.order[batch.begin + sorted[i]];
+        }
+
+        alignas(32) float minX[kLanes], minY[kLanes], minZ[kLanes], maxX[kLanes], maxY[kLanes], maxZ[kLanes];
+        Aabb laneBounds[kLanes];
+        float4 localPoints[kLanes];
+        int32_t starts[kLanes], sizes[kLanes];
+        for (uint32_t group = 0; group < count;) {
+            const int32_t collider = context.candidates[sorted[group]].collider;
+            const TriangleMeshShape shape(context.world, collider, context.colliderToSolver[collider]);
+            const float contactOffset = context.world.shapes()[collider].contactOffset;
+
+            // up to kLanes nearby candidates of the same collider, traversing the tree together.
+            uint32_t laneCount = 0;
+            Aabb groupBounds;
+            float largest = 0;
+            while (laneCount < kLanes && group + laneCount < count &&
+                   context.candidates[sorted[group + laneCount]].collider == collider) {
+                const ColliderCandidate &candidate = context.candidates[sorted[group + laneCount]];
+                Aabb bounds = context.simplexBounds[candidate.simplex];
+                bounds.expand(float4(contactOffset));
+                const Aabb local = shape.localBounds(bounds);
+                Aabb grown = groupBounds;
+                grown.encapsulateBounds(local);
+                const float spread = std::max(largest, local.maxAxisLength()) * kPacketSpread;
+                if (laneCount > 0 && grown.maxAxisLength() > spread) {
+                    break;
+                }
+                groupBounds = grown;
+                largest = std::max(largest, local.maxAxisLength());
+
+                const uint32_t l = laneCount++;
+                laneBounds[l] = local;
+                starts[l] = context.simplexCounts.getSimplexStartAndSize(candidate.simplex, sizes[l]);
+                const float4 &position = p.positions[context.simplices[starts[l]]];
+                localPoints[l] = shape.transform.inverseTransformPointUnscaled(position);
+                if (shape.is2D) {
+                    localPoints[l].z = 0;
+                }
+            }
+            for (uint32_t l = 0; l < kLanes; ++l) {
+                const Aabb &bounds = laneBounds[std::min(l, laneCount - 1)];
+                minX[l] = bounds.min.x;
+                minY[l] = bounds.min.y;
+                minZ[l] = bounds.min.z;
+                maxX[l] = bounds.max.x;
+                maxY[l] = bounds.max.y;
+                maxZ[l] = bounds.max.z;
+            }
+
+            // triangles of the leaves reached, tested against the lanes whose own bounds they overlap.
+            const auto visitLeaf = [&](uint32_t first, uint32_t triangleCount, uint32_t lanes) {
+                for (uint32_t t = first; t < first + triangleCount; ++t) {
+                    const Aabb bounds = shape.triangleBounds(t);
+                    uint32_t overlapping = 0;
+                    for (uint32_t l = 0; l < laneCount; ++l) {
+                        overlapping |= uint32_t(bounds.intersectsAabb(laneBounds[l])) << l;
+                    }
+                    overlapping &= lanes;
+                    if (overlapping == 0) {
+                        continue;
+                    }
+                    const TriangleShape triangle = shape.triangle(t);
+                    for (uint32_t l = 0; l < laneCount; ++l) {
+                        if ((overlapping >> l) & 1) {
+                            context.triangleContact(context.candidates[sorted[group + l]], starts[l], sizes[l],
+                                                    localPoints[l], triangle, contacts);
+                        }
+                    }
+                }
+            };
+            BIH::queryLanes(shape.mesh->nodes.data(), minX, minY, minZ, maxX, maxY, maxZ, (1u << laneCount) - 1,
+                            visitLeaf);
+            group += laneCount;
+        }
+    }
+
+    void ColliderContactGenerator::generateContacts(const ColliderWorld &world, const AffineTransform &worldToSolver,
+                                                    const ParticleData &particles, const int32_t *simplices,
+                                                    const SimplexCounts &simplexCounts, const Aabb *simplexBounds,
+                                                    const ColliderCandidate *candidates, size_t count,
+                                                    const ContactParameters &parameters,
+                                                    std::vector<Contact> &contacts) {
+        contacts.clear();
+        _contactCountsByType.assign(kTypeCount, 0);
+        if (count == 0) {
+            return;
+        }
+
+        _keys.resize(count);
+        _order.resize(count);
+        parallelFor(0, count, kCandidateGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const ColliderCandidate &candidate = candidates[i];
+                const ColliderShape::Type type = world.shapes()[candidate.collider].type;
+                int32_t size;
+                simplexCounts.getSimplexStartAndSize(candidate.simplex, size);
+
+                uint32_t key = kDroppedKey;
+                switch (type) {
+                    case ColliderShape::Type::Sphere:
+                    case ColliderShape::Type::Box:
+                    case ColliderShape::Type::Capsule:
+                        key = keyFor(type, size > 1);
+                        break;
+                    case ColliderShape::Type::Heightmap:
+                        if (HeightFieldShape::hasData(world, candidate.collider)) {
+                            key = keyFor(type, size > 1);
+                        }
+                        break;
+                    case ColliderShape::Type::TriangleMesh:
+                        if (TriangleMeshShape::hasData(world, candidate.collider)) {
+                            key = keyFor(type, size > 1);
+                        }
+                        break;
+                    case ColliderShape::Type::SignedDistanceField:
+                        if (DistanceFieldShape::hasData(world, candidate.collider)) {
+                            key = keyFor(type, size > 1);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                _keys[i] = key;
+                _order[i] = uint32_t(i);
+            }
+        });
+        _sort.sort(_keys.data(), _order.data(), count, RadixSort::bitsForMaxKey(kDroppedKey));
+
+        // runs of equal keys, split in batches.
+        _batches.clear();
+        for (uint32_t key = 0, begin = 0; key < kDroppedKey; ++key) {
+            const auto end = uint32_t(std::upper_bound(_keys.begin() + begin, _keys.end(), key) - _keys.begin());
+            for (uint32_t start = begin; start < end; start += kBatchSize) {
+                _batches.push_back({key, start, std::min(end, start + kBatchSize)});
+            }
+            begin = end;
+        }
+
+        const size_t colliderCount = world.transforms().size();
+        _colliderToSolver.resize(colliderCount);
+        parallelFor(size_t(0), colliderCount, kCandidateGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _colliderToSolver[i] = worldToSolver * world.transforms()[i];
+            }
+        });
+
+        const AffineTransform solverToWorld = worldToSolver.inverse();
+        const Context context{world, worldToSolver, solverToWorld, _colliderToSolver.data(), particles,
+                              simplices, simplexCounts, simplexBounds, candidates, _order.data(), parameters};
+        const size_t batchCount = _batches.size();
+        if (_batchContacts.size() < batchCount) {
+            _batchContacts.resize(batchCount);
+        }
+        parallelForEach(batchCount, 1, [&](size_t b) {
+            const Batch &batch = _batches[b];
+            std::vector<Contact> &queue = _batchContacts[b];
+            queue.clear();
+            switch (typeOfKey(batch.key)) {
+                case ColliderShape::Type::Sphere:
+                    processBatch<SphereShape>(context, batch, queue);
+                    break;
+                case ColliderShape::Type::Box:
+                    processBatch<BoxShape>(context, batch, queue);
+                    break;
+                case ColliderShape::Type::Capsule:
+                    processBatch<CapsuleShape>(context, batch, queue);
+                    break;
+                case ColliderShape::Type::Heightmap:
+                    processHeightFields(context, batch, queue);
+                    break;
+                case ColliderShape::Type::TriangleMesh:
+                    processTriangleMeshes(context, batch, queue);
+                    break;
+                case ColliderShape::Type::SignedDistanceField:
+                    processBatch<DistanceFieldShape>(context, batch, queue);
+                    break;
+                default:
+                    break;
+            }
+        });
+
+        _offsets.resize(batchCount + 1);
+        for (size_t b = 0; b < batchCount; ++b) {
+            _offsets[b] = uint32_t(_batchContacts[b].size());
+            _contactCountsByType[uint32_t(typeOfKey(_batches[b].key))] += _offsets[b];
+        }
+        _offsets[batchCount] = parallelExclusiveScan(_offsets.data(), _offsets.data(), batchCount);
+        contacts.resize(_offsets[batchCount]);
+        parallelForEach(batchCount, 1, [&](size_t b) {
+            std::copy(_batchContacts[b].begin(), _batchContacts[b].end(), contacts.begin() + _offsets[b]);
+        });
+    }
+} // namespace vox::flex
@@ -0,0 +1,86 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "ColliderWorld.h"
+#include "../data-structures/queries/Contact.h"
+#include "../sort/RadixSort.h"
+#include <vector>
+
+namespace vox::flex {
+    // Narrow phase between simplices and colliders, native counterpart of the Contacts methods of the Burst
+    // shapes. Candidates are radix sorted by shape type, single particles apart from edges and triangles, and
+    // every run of equal keys is split in batches processed in parallel: a batch switches on its shape once
+    // and runs that shape's kernel on all of its candidates, with no per-contact dispatch.
+    //
+    // Particles go through the lane kernel of their shape, kLanes at a time. Edges and triangles take the
+    // local optimization of LocalOptimization with the shape as distance function. A candidate becomes a
+    // contact if the simplex, moving at its velocity relative to the collider's rigidbody, may get within
+    // the collider's contact offset plus the collision margin of the surface over the step.
+    //
+    // Heightfields only visit the cells under the simplex bounds, tile by tile, and test the simplex against
+    // each of their triangles, which may give several contacts per candidate. Triangle meshes regroup the
+    // candidates of a batch by collider and traverse the mesh's BIH once for up to kLanes of them.
+    //
+    // Supported shapes are spheres, boxes, capsules, heightfields, triangle meshes and distance fields;
+    // candidates of other shapes, and of colliders missing their data, are dropped.
+    class ColliderContactGenerator {
+    public:
+        struct ContactParameters {
+            float stepTime = 0;
+            float collisionMargin = 0;
+            int optimizationIterations = 16;
+            float optimizationTolerance = 0.004f;
+        };
+
+        // Contacts come grouped by shape type, those of particles first, in candidate order. pointA holds the
+        // barycentric coords of the simplex point nearest to the collider, pointB the collider surface point in
+        // solver space, the normal points from the collider to the simplex and bodyB is the collider.
+        // Particles and `simplexBounds` are in solver space, colliders and rigidbodies in world space, brought
+        // to solver space by `worldToSolver`.
+        void generateContacts(const ColliderWorld &world, const AffineTransform &worldToSolver,
+                              const ParticleData &particles, const int32_t *simplices,
+                              const SimplexCounts &simplexCounts, const Aabb *simplexBounds,
+                              const ColliderCandidate *candidates, size_t count, const ContactParameters &parameters,
+                              std::vector<Contact> &contacts);
+
+        // Number of contacts of each shape type found by the last call, indexed by ColliderShape::Type.
+        const std::vector<uint32_t> &contactCountsByType() const { return _contactCountsByType; }
+
+    private:
+        // a batch of candidates sharing the same sort key, as a range of _order.
+        struct Batch {
+            uint32_t key = 0;
+            uint32_t begin = 0;
+            uint32_t end = 0;
+        };
+
+        struct Context;
+
+        template <typename Shape>
+        static void processBatch(const Context &context, const Batch &batch, std::vector<Contact> &contacts);
+
+        template <typename Shape>
+        static void processParticles(const Context &context, const Batch &batch, std::vector<Contact> &contacts);
+
+        template <typename Shape>
+        static void processSimplices(const Context &context, const Batch &batch, std::vector<Contact> &contacts);
+
+        static void processHeightFields(const Context &context, const Batch &batch, std::vector<Contact> &contacts);
+
+        static void processTriangleMeshes(const Context &context, const Batch &batch, std::vector<Contact> &contacts);
+
+        RadixSort _sort;
+        std::vector<uint32_t> _keys;
+        std::vector<uint32_t> _order;
+        std::vector<Batch> _batches;
+        std::vector<std::vector<Contact>> _batchContacts;
+        std::vector<uint32_t> _offsets;
+        std::vector<uint32_t> _contactCountsByType;
+        std::vector<AffineTransform> _colliderToSolver;
+    };
+} // namespace vox::flex
@@ -0,0 +1,121 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+
+namespace vox::flex {
+    // Native counterparts of the collider world data (ColliderShape, AffineTransform, ColliderRigidbody and
+    // CollisionMaterial on the Swift side), with 32-bit indices.
+    struct alignas(16) ColliderShape {
+        enum class Type : int32_t { Sphere, Box, Capsule, Heightmap, TriangleMesh, EdgeMesh, SignedDistanceField };
+
+        float4 center;
+        // box: size along each axis, sphere: radius in x, capsule: radius (x), height (y) and axis (z),
+        // heightmap: width (x), height (y) and depth (z), its resolution being that of its heightfield.
+        float4 size;
+        Type type = Type::Sphere;
+        float contactOffset = 0;
+        // index of the shape data (mesh, heightfield, distance field) in the world.
+        int32_t dataIndex = -1;
+        int32_t rigidbodyIndex = -1;
+        int32_t materialIndex = -1;
+        // category in the low 16 bits, mask in the high 16 bits, as particle filters.
+        int32_t filter = int32_t(0xffff0001);
+        // 1 for triggers.
+        int32_t flags = 0;
+        int32_t is2D = 0;
+    };
+
+    struct alignas(16) AffineTransform {
+        float4 translation;
+        float4 scale{1, 1, 1, 1};
+        quaternion rotation;
+
+        float4 transformPoint(const float4 &point) const {
+            return float4(translation.xyz() + rotate(rotation, point.xyz() * scale.xyz()), 0);
+        }
+
+        float4 inverseTransformPoint(const float4 &point) const {
+            return float4(rotate(conjugate(rotation), point.xyz() - translation.xyz()) / scale.xyz(), 0);
+        }
+
+        // rigid part of the transform only: shapes apply the scale to their own dimensions.
+        float4 transformPointUnscaled(const float4 &point) const {
+            return float4(translation.xyz() + rotate(rotation, point.xyz()), 0);
+        }
+
+        float4 inverseTransformPointUnscaled(const float4 &point) const {
+            return float4(rotate(conjugate(rotation), point.xyz() - translation.xyz()), 0);
+        }
+
+        float4 transformDirection(const float4 &direction) const {
+            return float4(rotate(rotation, direction.xyz()), 0);
+        }
+
+        float4 inverseTransformDirection(const float4 &direction) const {
+            return float4(rotate(conjugate(rotation), direction.xyz()), 0);
+        }
+
+        // scaled, unlike directions.
+        float4 transformVector(const float4 &vector) const {
+            return float4(rotate(rotation, vector.xyz() * scale.xyz()), 0);
+        }
+
+        // Scale and rotation only commute under uniform scales, which the inverse assumes as Obi's transforms do.
+        AffineTransform inverse() const {
+            AffineTransform result;
+            result.rotation = conjugate(rotation);
+            result.scale = float4(float3(1) / scale.xyz(), 1);
+            result.translation = float4(-rotate(result.rotation, translation.xyz()) * result.scale.xyz(), 0);
+            return result;
+        }
+
+        // `transform` followed by this one.
+        AffineTransform operator*(const AffineTransform &transform) const {
+            AffineTransform result;
+            result.translation = transformPoint(transform.translation);
+            result.rotation = rotation * transform.rotation;
+            result.scale = float4(scale.xyz() * transform.scale.xyz(), 1);
+            return result;
+        }
+    };
+
+    struct alignas(16) ColliderRigidbody {
+        // columns of the world space inverse inertia tensor.
+        float4 inverseInertiaTensor[4];
+        float4 velocity;
+        float4 angularVelocity;
+        // center of mass, world space.
+        float4 com;
+        float inverseMass = 0;
+
+        float4 velocityAtPoint(const float4 &point) const {
+            return velocity + float4(cross(angularVelocity.xyz(), point.xyz() - com.xyz()), 0);
+        }
+    };
+
+    // Range of a distance field's nodes in the world's node array, as DistanceFieldHeader.
+    struct DistanceFieldHeader {
+        int32_t firstNode = 0;
+        int32_t nodeCount = 0;
+    };
+
+    struct CollisionMaterial {
+        // same values as Oni.MaterialCombineMode.
+        enum class CombineMode : int32_t { Average, Minimum, Multiply, Maximum };
+
+        float dynamicFriction = 0;
+        float staticFriction = 0;
+        float rollingFriction = 0;
+        float stickiness = 0;
+        float stickDistance = 0;
+        CombineMode frictionCombine = CombineMode::Average;
+        CombineMode stickinessCombine = CombineMode::Average;
+        int32_t rollingContacts = 0;
+    };
+} // namespace vox::flex
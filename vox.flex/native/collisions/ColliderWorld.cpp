@@ -0,0 +1,183 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ColliderWorld.h"
+#include "../common/Parallel.h"
+
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kColliderGrain = 256;
+        constexpr size_t kSimplexGrain = 256;
+
+        constexpr int32_t kFilterCategoryBitmask = 0x0000ffff;
+
+        const int4 kNoCell{0, 0, 0, MultilevelGrid::kNoLevel};
+
+        int32_t cellFloor(float value, float cellSize) { return int32_t(std::floor(value / cellSize)); }
+
+        template <typename Callback>
+        void forEachCell(const CellSpan &span, Callback &&callback) {
+            if (span.empty()) {
+                return;
+            }
+            for (int32_t x = span.min.x; x <= span.max.x; ++x) {
+                for (int32_t y = span.min.y; y <= span.max.y; ++y) {
+                    for (int32_t z = span.min.z; z <= span.max.z; ++z) {
+                        callback(int4(x, y, z, span.min.w));
+                    }
+                }
+            }
+        }
+    } // namespace
+
+    CellSpan ColliderWorld::spanForBounds(const Aabb &bounds, bool is2D) {
+        CellSpan span;
+        if (!(bounds.min.x <= bounds.max.x && bounds.min.y <= bounds.max.y && bounds.min.z <= bounds.max.z)) {
+            return span;
+        }
+        // cells as wide as the largest axis: a collider overlaps at most two of them per axis.
+        const int32_t level = MultilevelGrid::gridLevelForSize(bounds.maxAxisLength());
+        const float cellSize = MultilevelGrid::cellSizeOfLevel(level);
+        span.min = int4(cellFloor(bounds.min.x, cellSize), cellFloor(bounds.min.y, cellSize),
+                        is2D ? 0 : cellFloor(bounds.min.z, cellSize), level);
+        span.max = int4(cellFloor(bounds.max.x, cellSize), cellFloor(bounds.max.y, cellSize),
+                        is2D ? 0 : cellFloor(bounds.max.z, cellSize), level);
+        return span;
+    }
+
+    void ColliderWorld::addMoves(const CellSpan &from, const CellSpan &to, int32_t collider) {
+        const size_t first = _moves.size();
+        forEachCell(from, [&](const int4 &cell) { _moves.push_back({cell, kNoCell, collider}); });
+        size_t paired = first;
+        forEachCell(to, [&](const int4 &cell) {
+            if (paired < _moves.size()) {
+                _moves[paired++].newCellCoords = cell;
+            } else {
+                _moves.push_back({kNoCell, cell, collider});
+                ++paired;
+            }
+        });
+    }
+
+    void ColliderWorld::setColliderCount(size_t count) {
+        _moves.clear();
+        for (size_t i = count; i < _cellSpans.size(); ++i) {
+            addMoves(_cellSpans[i], CellSpan(), int32_t(i));
+        }
+        _grid.update(_moves.data(), _moves.size());
+
+        _shapes.resize(count);
+        _bounds.resize(count);
+        _transforms.resize(count);
+        _sweptBounds.resize(count);
+        _cellSpans.resize(count);
+    }
+
+    void ColliderWorld::updateWorld(float deltaTime) {
+        const size_t count = _shapes.size();
+        _newCellSpans.resize(count);
+        parallelFor(0, count, kColliderGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const ColliderShape &shape = _shapes[i];
+                Aabb bounds = _bounds[i];
+                if (shape.rigidbodyIndex >= 0 && size_t(shape.rigidbodyIndex) < _rigidbodies.size()) {
+                    bounds.sweep(_rigidbodies[shape.rigidbodyIndex].velocity * deltaTime);
+                }
+                if (shape.materialIndex >= 0 && size_t(shape.materialIndex) < _materials.size()) {
+                    bounds.expand(float4(_materials[shape.materialIndex].stickDistance));
+                }
+                _sweptBounds[i] = bounds;
+                _newCellSpans[i] = spanForBounds(bounds, shape.is2D != 0);
+            }
+        });
+
+        _moves.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (_newCellSpans[i] != _cellSpans[i]) {
+                addMoves(_cellSpans[i], _newCellSpans[i], int32_t(i));
+                _cellSpans[i] = _newCellSpans[i];
+            }
+        }
+        _grid.update(_moves.data(), _moves.size());
+    }
+
+    void ColliderWorld::generateCandidates(const ParticleData &particles, const int32_t *simplices,
+                                           const SimplexCounts &simplexCounts, const Aabb *simplexBounds, bool is2D,
+                                           std::vector<ColliderCandidate> &candidates) {
+        candidates.clear();
+        const size_t simplexCount = size_t(simplexCounts.simplexCount());
+        if (simplexCount == 0 || _grid.cellCount() == 0) {
+            return;
+        }
+        _grid.populatedLevels(_populatedLevels);
+
+        const size_t chunkCount = (simplexCount + kSimplexGrain - 1) / kSimplexGrain;
+        if (_chunkCandidates.size() < chunkCount) {
+            _chunkCandidates.resize(chunkCount);
+        }
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            std::vector<ColliderCandidate> &queue = _chunkCandidates[chunk];
+            queue.clear();
+            for (size_t i = chunk * kSimplexGrain, end = std::min(simplexCount, i + kSimplexGrain); i < end; ++i) {
+                int32_t size;
+                const int32_t start = simplexCounts.getSimplexStartAndSize(int32_t(i), size);
+                int32_t category = 0, mask = 0;
+                for (int32_t j = 0; j < size; ++j) {
+                    const int32_t filter = particles.filters[simplices[start + j]];
+                    category |= filter & kFilterCategoryBitmask;
+                    mask |= int32_t(uint32_t(filter) >> 16);
+                }
+
+                const Aabb &bounds = simplexBounds[i];
+                for (const int32_t level : _populatedLevels) {
+                    const float cellSize = MultilevelGrid::cellSizeOfLevel(level);
+                    const int4 lower(cellFloor(bounds.min.x, cellSize), cellFloor(bounds.min.y, cellSize),
+                                     is2D ? 0 : cellFloor(bounds.min.z, cellSize), level);
+                    const int4 upper(cellFloor(bounds.max.x, cellSize), cellFloor(bounds.max.y, cellSize),
+                                     is2D ? 0 : cellFloor(bounds.max.z, cellSize), level);
+                    forEachCell({lower, upper}, [&](const int4 &coords) {
+                        const int32_t cell = _grid.findCell(coords);
+                        if (cell < 0) {
+                            return;
+                        }
+                        const int32_t *contents = _grid.contents(cell);
+                        for (uint32_t k = 0, n = _grid.cell(cell).count; k < n; ++k) {
+                            const int32_t collider = contents[k];
+                            // report the pair only from the first cell of the overlap of both spans.
+                            const int4 &spanMin = _cellSpans[collider].min;
+                            if (coords.x != std::max(lower.x, spanMin.x) || coords.y != std::max(lower.y, spanMin.y) ||
+                                coords.z != std::max(lower.z, spanMin.z)) {
+                                continue;
+                            }
+                            const ColliderShape &shape = _shapes[collider];
+                            const int32_t shapeCategory = shape.filter & kFilterCategoryBitmask;
+                            const int32_t shapeMask = int32_t(uint32_t(shape.filter) >> 16);
+                            if ((category & shapeMask) == 0 || (mask & shapeCategory) == 0) {
+                                continue;
+                            }
+                            if (bounds.intersectsAabb(_sweptBounds[collider], is2D || shape.is2D != 0)) {
+                                queue.push_back({int32_t(i), collider});
+                            }
+                        }
+                    });
+                }
+            }
+        });
+
+        _offsets.resize(chunkCount + 1);
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            _offsets[chunk] = uint32_t(_chunkCandidates[chunk].size());
+        }
+        _offsets[chunkCount] = parallelExclusiveScan(_offsets.data(), _offsets.data(), chunkCount);
+        candidates.resize(_offsets[chunkCount]);
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            std::copy(_chunkCandidates[chunk].begin(), _chunkCandidates[chunk].end(),
+                      candidates.begin() + _offsets[chunk]);
+        });
+    }
+} // namespace vox::flex
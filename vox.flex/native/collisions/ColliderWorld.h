@@ -0,0 +1,130 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "ColliderShape.h"
+#include "TriangleMeshContainer.h"
+#include "../common/AlignedVector.h"
+#include "../common/Aabb.h"
+#include "../data-structures/asdf/ASDF.h"
+#include "../data-structures/heightfield/HeightField.h"
+#include "../data-structures/multilevel-grid/MultilevelGrid.h"
+#include "../solver/ParticleData.h"
+#include "../solver/SimplexCounts.h"
+#include <vector>
+
+namespace vox::flex {
+    // Cells of one grid level overlapped by a collider, inclusive. An empty span is at MultilevelGrid::kNoLevel.
+    struct CellSpan {
+        int4 min{0, 0, 0, MultilevelGrid::kNoLevel};
+        int4 max{0, 0, 0, MultilevelGrid::kNoLevel};
+
+        bool empty() const { return min.w == MultilevelGrid::kNoLevel; }
+
+        bool operator==(const CellSpan &o) const { return min == o.min && max == o.max; }
+
+        bool operator!=(const CellSpan &o) const { return !(*this == o); }
+    };
+
+    // A simplex whose bounds overlap a collider's, passing their filters.
+    struct ColliderCandidate {
+        int32_t simplex = -1;
+        int32_t collider = -1;
+    };
+
+    // Native counterpart of BurstColliderWorld: the colliders of a scene, shared by every solver.
+    //
+    // Collider data is kept as one aligned array per attribute (shapes, world bounds, transforms, plus
+    // rigidbodies and materials referenced by index), which the owner fills in place and solvers read
+    // directly. Each collider sits in every cell its bounds overlap at the grid level matching its size,
+    // at most two cells per axis. `updateWorld` only moves the colliders whose cell span changed. 2D colliders
+    // live in the z = 0 layer of cells, which is where 2D solvers look for them.
+    class ColliderWorld {
+    public:
+        // New colliders are empty until given bounds, removed ones leave the grid right away.
+        void setColliderCount(size_t count);
+
+        size_t colliderCount() const { return _shapes.size(); }
+
+        AlignedVector<ColliderShape> &shapes() { return _shapes; }
+        const AlignedVector<ColliderShape> &shapes() const { return _shapes; }
+
+        // world space, contact offset included.
+        AlignedVector<Aabb> &bounds() { return _bounds; }
+        const AlignedVector<Aabb> &bounds() const { return _bounds; }
+
+        AlignedVector<AffineTransform> &transforms() { return _transforms; }
+        const AlignedVector<AffineTransform> &transforms() const { return _transforms; }
+
+        AlignedVector<ColliderRigidbody> &rigidbodies() { return _rigidbodies; }
+        const AlignedVector<ColliderRigidbody> &rigidbodies() const { return _rigidbodies; }
+
+        AlignedVector<CollisionMaterial> &materials() { return _materials; }
+        const AlignedVector<CollisionMaterial> &materials() const { return _materials; }
+
+        // Distance fields referenced by SignedDistanceField shapes through their data index. Each header is a
+        // range of `distanceFieldNodes`, child indices being relative to the first node of the range.
+        std::vector<DistanceFieldHeader> &distanceFieldHeaders() { return _distanceFieldHeaders; }
+        const std::vector<DistanceFieldHeader> &distanceFieldHeaders() const { return _distanceFieldHeaders; }
+
+        std::vector<DFNode> &distanceFieldNodes() { return _distanceFieldNodes; }
+        const std::vector<DFNode> &distanceFieldNodes() const { return _distanceFieldNodes; }
+
+        // Heightfields referenced by Heightmap shapes through their data index, updatable in place.
+        std::vector<HeightField> &heightFields() { return _heightFields; }
+        const std::vector<HeightField> &heightFields() const { return _heightFields; }
+
+        // Meshes referenced by TriangleMesh shapes through their data index.
+        TriangleMeshContainer &triangleMeshes() { return _triangleMeshes; }
+        const TriangleMeshContainer &triangleMeshes() const { return _triangleMeshes; }
+
+        // Moves colliders to the cells overlapped by their bounds, swept by their rigidbody velocity over
+        // `deltaTime` and grown by their material stick distance.
+        void updateWorld(float deltaTime);
+
+        const CellSpan &cellSpan(size_t collider) const { return _cellSpans[collider]; }
+
+        const Aabb &sweptBounds(size_t collider) const { return _sweptBounds[collider]; }
+
+        const MultilevelGrid &grid() const { return _grid; }
+
+        // Pairs of simplices and colliders with intersecting bounds and compatible filters, as of the last
+        // `updateWorld`. Simplices look up the cells their bounds overlap in every populated level; a pair
+        // found in several cells is only reported from the first cell both spans share. Simplices are
+        // processed in parallel chunks, each filling its own queue, concatenated in simplex order.
+        void generateCandidates(const ParticleData &particles, const int32_t *simplices,
+                                const SimplexCounts &simplexCounts, const Aabb *simplexBounds, bool is2D,
+                                std::vector<ColliderCandidate> &candidates);
+
+    private:
+        static CellSpan spanForBounds(const Aabb &bounds, bool is2D);
+
+        // appends the moves taking a collider from one span to another, pairing cells so each move is a
+        // single grid edit.
+        void addMoves(const CellSpan &from, const CellSpan &to, int32_t collider);
+
+        AlignedVector<ColliderShape> _shapes;
+        AlignedVector<Aabb> _bounds;
+        AlignedVector<AffineTransform> _transforms;
+        AlignedVector<ColliderRigidbody> _rigidbodies;
+        AlignedVector<CollisionMaterial> _materials;
+        std::vector<DistanceFieldHeader> _distanceFieldHeaders;
+        std::vector<DFNode> _distanceFieldNodes;
+        std::vector<HeightField> _heightFields;
+        TriangleMeshContainer _triangleMeshes;
+
+        MultilevelGrid _grid;
+        // bounds as of the last update: swept and grown like the spans computed from them.
+        std::vector<Aabb> _sweptBounds;
+        std::vector<CellSpan> _cellSpans;
+        std::vector<CellSpan> _newCellSpans;
+        std::vector<MovingEntity> _moves;
+        std::vector<int32_t> _populatedLevels;
+        std::vector<std::vector<ColliderCandidate>> _chunkCandidates;
+        std::vector<uint32_t> _offsets;
+    };
+} // namespace vox::flex
@@ -0,0 +1,89 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+
+namespace vox::flex {
+    // Point of the segment p1 p2 nearest to `point`, `mu` gets its parameter along the segment.
+    inline float4 nearestPointOnEdge(const float4 &p1, const float4 &p2, const float4 &point, float &mu) {
+        const float4 edge = p2 - p1;
+        const float lengthSq = dot(edge.xyz(), edge.xyz());
+        mu = lengthSq > 1e-12f ? std::clamp(dot((point - p1).xyz(), edge.xyz()) / lengthSq, 0.f, 1.f) : 0.f;
+        return p1 + edge * mu;
+    }
+
+    // Point of the triangle p1 p2 p3 nearest to `point` (Ericson, Real-Time Collision Detection 5.1.5),
+    // `bary` gets its barycentric coords in xyz.
+    inline float4 nearestPointOnTri(const float4 &p1, const float4 &p2, const float4 &p3, const float4 &point,
+                                    float4 &bary) {
+        const float3 a = p1.xyz(), b = p2.xyz(), c = p3.xyz(), p = point.xyz();
+        const float3 ab = b - a, ac = c - a, ap = p - a;
+        const float d1 = dot(ab, ap), d2 = dot(ac, ap);
+        if (d1 <= 0 && d2 <= 0) {
+            bary = {1, 0, 0, 0};
+            return p1;
+        }
+
+        const float3 bp = p - b;
+        const float d3 = dot(ab, bp), d4 = dot(ac, bp);
+        if (d3 >= 0 && d4 <= d3) {
+            bary = {0, 1, 0, 0};
+            return p2;
+        }
+
+        const float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+            const float v = d1 / (d1 - d3);
+            bary = {1 - v, v, 0, 0};
+            return p1 + (p2 - p1) * v;
+        }
+
+        const float3 cp = p - c;
+        const float d5 = dot(ab, cp), d6 = dot(ac, cp);
+        if (d6 >= 0 && d5 <= d6) {
+            bary = {0, 0, 1, 0};
+            return p3;
+        }
+
+        const float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+            const float w = d2 / (d2 - d6);
+            bary = {1 - w, 0, w, 0};
+            return p1 + (p3 - p1) * w;
+        }
+
+        const float va = d3 * d6 - d5 * d4;
+        if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+            const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            bary = {0, 1 - w, w, 0};
+            return p2 + (p3 - p2) * w;
+        }
+
+        const float denominator = 1 / (va + vb + vc);
+        const float v = vb * denominator, w = vc * denominator;
+        bary = {1 - v - w, v, w, 0};
+        return p1 * bary.x + p2 * v + p3 * w;
+    }
+
+    // Barycentric coords of the center of a simplex of 1 to 4 particles.
+    inline float4 barycenterForSimplexOfSize(int32_t size) {
+        float4 bary;
+        for (int32_t i = 0; i < size; ++i) {
+            bary[i] = 1.f / float(size);
+        }
+        return bary;
+    }
+
+    // Reflects `normal` so it never points against `forward`, for one-sided surfaces.
+    inline void oneSidedNormal(const float4 &forward, float4 &normal) {
+        const float d = dot(normal.xyz(), forward.xyz());
+        if (d < 0) {
+            normal -= float4(forward.xyz() * (2 * d), 0);
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,170 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+
+namespace vox::flex {
+    // Point on the surface of a distance function: its barycentric coords when the function is a simplex,
+    // the point itself and the outward surface normal there.
+    struct SurfacePoint {
+        float4 bary;
+        float4 point;
+        float4 normal;
+    };
+
+    // Closest points between a solver simplex, whose particles may have different radii, and a distance
+    // function. Distance functions expose
+    //   void evaluate(const float4 &point, const float4 &radii, const quaternion &orientation,
+    //                 SurfacePoint &projectedPoint) const;
+    // writing the point of their surface nearest to `point` and the surface normal there.
+    class LocalOptimization {
+    public:
+        // Returns the point of `function` nearest to the simplex. `convexBary` is the initial guess and gets
+        // the barycentric coords of the simplex point nearest to the function, `convexPoint` that point.
+        // Points take a single evaluation, edges a golden section search and triangles Frank-Wolfe.
+        template <typename Function>
+        static SurfacePoint optimize(const Function &function, const float4 *positions, const quaternion *orientations,
+                                     const float4 *radii, const int32_t *simplices, int32_t simplexStart,
+                                     int32_t simplexSize, float4 &convexBary, float4 &convexPoint,
+                                     int maxIterations = 16, float tolerance = 0.004f);
+
+    private:
+        struct ConvexData {
+            const float4 *positions;
+            const quaternion *orientations;
+            const float4 *radii;
+            const int32_t *simplices;
+            int32_t simplexStart;
+            int32_t simplexSize;
+        };
+
+        // position, radii and orientation of the simplex at `bary`. Null orientations are the identity.
+        static void interpolate(const ConvexData &data, const float4 &bary, float4 &point, float4 &thickness,
+                                quaternion &orientation);
+
+        template <typename Function>
+        static void frankWolfe(const Function &function, const ConvexData &data, float4 &convexBary,
+                               float4 &convexPoint, SurfacePoint &pointInFunction, int maxIterations, float tolerance);
+
+        template <typename Function>
+        static void goldenSearch(const Function &function, const ConvexData &data, float4 &convexBary,
+                                 float4 &convexPoint, SurfacePoint &pointInFunction, int maxIterations, float tolerance);
+    };
+
+    inline void LocalOptimization::interpolate(const ConvexData &data, const float4 &bary, float4 &point,
+                                               float4 &thickness, quaternion &orientation) {
+        point = float4();
+        thickness = float4();
+        quaternion q(0, 0, 0, 0);
+        for (int32_t j = 0; j < data.simplexSize; ++j) {
+            const int32_t particle = data.simplices[data.simplexStart + j];
+            point += data.positions[particle] * bary[j];
+            thickness += data.radii[particle] * bary[j];
+            if (data.orientations != nullptr) {
+                q = q + data.orientations[particle] * bary[j];
+            }
+        }
+        orientation = data.orientations != nullptr ? normalize(q) : quaternion();
+    }
+
+    template <typename Function>
+    SurfacePoint LocalOptimization::optimize(const Function &function, const float4 *positions,
+                                             const quaternion *orientations, const float4 *radii,
+                                             const int32_t *simplices, int32_t simplexStart, int32_t simplexSize,
+                                             float4 &convexBary, float4 &convexPoint, int maxIterations,
+                                             float tolerance) {
+        const ConvexData data{positions, orientations, radii, simplices, simplexStart, simplexSize};
+        SurfacePoint pointInFunction;
+        if (simplexSize == 1 || maxIterations < 1) {
+            float4 thickness;
+            quaternion orientation;
+            interpolate(data, convexBary, convexPoint, thickness, orientation);
+            function.evaluate(convexPoint, thickness, orientation, pointInFunction);
+        } else if (simplexSize == 2) {
+            goldenSearch(function, data, convexBary, convexPoint, pointInFunction, maxIterations, tolerance * 10);
+        } else {
+            frankWolfe(function, data, convexBary, convexPoint, pointInFunction, maxIterations, tolerance);
+        }
+        return pointInFunction;
+    }
+
+    template <typename Function>
+    void LocalOptimization::frankWolfe(const Function &function, const ConvexData &data, float4 &convexBary,
+                                       float4 &convexPoint, SurfacePoint &pointInFunction, int maxIterations,
+                                       float tolerance) {
+        float4 thickness;
+        quaternion orientation;
+        interpolate(data, convexBary, convexPoint, thickness, orientation);
+        for (int iteration = 0; iteration < maxIterations; ++iteration) {
+            function.evaluate(convexPoint, thickness, orientation, pointInFunction);
+
+            // the vertex of the thickened simplex furthest along -normal is the descent direction, its distance
+            // to the current point along it the duality gap.
+            int32_t descent = 0;
+            float gap = std::numeric_limits<float>::lowest();
+            for (int32_t j = 0; j < data.simplexSize; ++j) {
+                const int32_t particle = data.simplices[data.simplexStart + j];
+                const float4 candidate = data.positions[particle] - convexPoint -
+                                         pointInFunction.normal * (data.radii[particle].x - thickness.x);
+                const float correlation = -dot(pointInFunction.normal, candidate);
+                if (correlation > gap) {
+                    gap = correlation;
+                    descent = j;
+                }
+            }
+            if (gap < tolerance) {
+                return;
+            }
+
+            const float step = 0.3f * 2.f / float(iteration + 2);
+            convexBary *= 1 - step;
+            convexBary[descent] += step;
+            interpolate(data, convexBary, convexPoint, thickness, orientation);
+        }
+        function.evaluate(convexPoint, thickness, orientation, pointInFunction);
+    }
+
+    template <typename Function>
+    void LocalOptimization::goldenSearch(const Function &function, const ConvexData &data, float4 &convexBary,
+                                         float4 &convexPoint, SurfacePoint &pointInFunction, int maxIterations,
+                                         float tolerance) {
+        const float invPhi = (std::sqrt(5.f) - 1) * 0.5f;
+        const float invPhi2 = (3 - std::sqrt(5.f)) * 0.5f;
+        float4 thickness;
+        quaternion orientation;
+
+        // signed distance between the thickened edge at `mu` and the function.
+        auto distance = [&](float mu) {
+            convexBary = {1 - mu, mu, 0, 0};
+            interpolate(data, convexBary, convexPoint, thickness, orientation);
+            function.evaluate(convexPoint, thickness, orientation, pointInFunction);
+            return dot(convexPoint - pointInFunction.point, pointInFunction.normal) - thickness.x;
+        };
+
+        float a = 0, b = 1, h = 1;
+        float c = a + invPhi2 * h, d = a + invPhi * h;
+        float yc = distance(c), yd = distance(d);
+        for (int k = 0; k < maxIterations && h > tolerance; ++k) {
+            h *= invPhi;
+            if (yc < yd) {
+                b = d;
+                d = c;
+                yd = yc;
+                c = a + invPhi2 * h;
+                yc = distance(c);
+            } else {
+                a = c;
+                c = d;
+                yc = yd;
+                d = a + invPhi * h;
+                yd = distance(d);
+            }
+        }
+        distance(yc < yd ? (a + d) * 0.5f : (c + b) * 0.5f);
+    }
+} // namespace vox::flex
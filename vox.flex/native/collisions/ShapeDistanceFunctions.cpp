@@ -0,0 +1,282 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ShapeDistanceFunctions.h"
+
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kLanes = ShapeLanes::kLanes;
+
+        // moves the query points by minus the shape center, flattening 2D lanes.
+        void toShapeCenter(ShapeLanes &l) {
+            for (size_t i = 0; i < kLanes; ++i) {
+                l.x[i] -= l.cx[i];
+                l.y[i] -= l.cy[i];
+                l.z[i] = l.flat[i] != 0 ? 0.f : l.z[i] - l.cz[i];
+            }
+        }
+
+        // normalizes (x, y, z) into the normal lanes and returns the lengths, (0, 1, 0) for null vectors.
+        void normalizeLanes(ShapeLanes &l, const float *x, const float *y, const float *z, float *lengths) {
+            for (size_t i = 0; i < kLanes; ++i) {
+                const float length = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+                const bool valid = length > 1e-12f;
+                const float inverse = valid ? 1 / length : 0.f;
+                l.nx[i] = x[i] * inverse;
+                l.ny[i] = valid ? y[i] * inverse : 1.f;
+                l.nz[i] = z[i] * inverse;
+                lengths[i] = length;
+            }
+        }
+
+        bool is2DCollider(const ColliderWorld &world, int32_t collider) {
+            return world.shapes()[collider].is2D != 0;
+        }
+    } // namespace
+
+    // MARK: - Sphere
+    SphereShape::SphereShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform)
+        : transform(transform), is2D(is2DCollider(world, collider)) {
+        const ColliderShape &shape = world.shapes()[collider];
+        center = shape.center.xyz() * transform.scale.xyz();
+        radius = shape.size.x * maxComponent(abs(transform.scale.xyz()));
+    }
+
+    void SphereShape::loadLane(ShapeLanes &lanes, size_t lane) const {
+        lanes.cx[lane] = center.x;
+        lanes.cy[lane] = center.y;
+        lanes.cz[lane] = center.z;
+        lanes.sx[lane] = radius;
+        lanes.flat[lane] = is2D ? 1.f : 0.f;
+    }
+
+    void SphereShape::projectLanes(ShapeLanes &l) {
+        alignas(32) float lengths[kLanes];
+        toShapeCenter(l);
+        normalizeLanes(l, l.x, l.y, l.z, lengths);
+        for (size_t i = 0; i < kLanes; ++i) {
+            l.x[i] = l.cx[i] + l.nx[i] * l.sx[i];
+            l.y[i] = l.cy[i] + l.ny[i] * l.sx[i];
+            l.z[i] = l.cz[i] + l.nz[i] * l.sx[i];
+        }
+    }
+
+    // MARK: - Box
+    BoxShape::BoxShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform)
+        : transform(transform), is2D(is2DCollider(world, collider)) {
+        const ColliderShape &shape = world.shapes()[collider];
+        center = shape.center.xyz() * transform.scale.xyz();
+        halfSize = shape.size.xyz() * abs(transform.scale.xyz()) * 0.5f;
+    }
+
+    void BoxShape::loadLane(ShapeLanes &lanes, size_t lane) const {
+        lanes.cx[lane] = center.x;
+        lanes.cy[lane] = center.y;
+        lanes.cz[lane] = center.z;
+        lanes.sx[lane] = halfSize.x;
+        lanes.sy[lane] = halfSize.y;
+        lanes.sz[lane] = halfSize.z;
+        lanes.flat[lane] = is2D ? 1.f : 0.f;
+    }
+
+    void BoxShape::projectLanes(ShapeLanes &l) {
+        alignas(32) float ox[kLanes], oy[kLanes], oz[kLanes], lengths[kLanes];
+        toShapeCenter(l);
+        // outside: clamp to the box, the normal going from the clamped point to the query.
+        for (size_t i = 0; i < kLanes; ++i) {
+            ox[i] = l.x[i] - std::clamp(l.x[i], -l.sx[i], l.sx[i]);
+            oy[i] = l.y[i] - std::clamp(l.y[i], -l.sy[i], l.sy[i]);
+            oz[i] = l.z[i] - std::clamp(l.z[i], -l.sz[i], l.sz[i]);
+        }
+        normalizeLanes(l, ox, oy, oz, lengths);
+
+        // inside: push out through the nearest face, never a z face in 2D.
+        for (size_t i = 0; i < kLanes; ++i) {
+            const float distanceX = l.sx[i] - std::fabs(l.x[i]);
+            const float distanceY = l.sy[i] - std::fabs(l.y[i]);
+            const float distanceZ = l.flat[i] != 0 ? std::numeric_limits<float>::max() : l.sz[i] - std::fabs(l.z[i]);
+            const bool inside = distanceX > 0 && distanceY > 0 && distanceZ > 0;
+            const bool alongY = distanceY < distanceX && distanceY <= distanceZ;
+            const bool alongZ = !alongY && distanceZ < distanceX;
+            const bool alongX = !alongY && !alongZ;
+            const float signX = l.x[i] < 0 ? -1.f : 1.f;
+            const float signY = l.y[i] < 0 ? -1.f : 1.f;
+            const float signZ = l.z[i] < 0 ? -1.f : 1.f;
+
+            const float x = inside ? (alongX ? l.sx[i] * signX : l.x[i]) : l.x[i] - ox[i];
+            const float y = inside ? (alongY ? l.sy[i] * signY : l.y[i]) : l.y[i] - oy[i];
+            const float z = inside ? (alongZ ? l.sz[i] * signZ : l.z[i]) : l.z[i] - oz[i];
+            l.nx[i] = inside ? (alongX ? signX : 0.f) : l.nx[i];
+            l.ny[i] = inside ? (alongY ? signY : 0.f) : l.ny[i];
+            l.nz[i] = inside ? (alongZ ? signZ : 0.f) : l.nz[i];
+            l.x[i] = l.cx[i] + x;
+            l.y[i] = l.cy[i] + y;
+            l.z[i] = l.cz[i] + z;
+        }
+    }
+
+    // MARK: - Capsule
+    CapsuleShape::CapsuleShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform)
+        : transform(transform), is2D(is2DCollider(world, collider)) {
+        const ColliderShape &shape = world.shapes()[collider];
+        const float3 scale = abs(transform.scale.xyz());
+        const int direction = std::clamp(int(shape.size.z), 0, 2);
+        center = shape.center.xyz() * transform.scale.xyz();
+        axis = float3(0, 0, 0);
+        axis[direction] = 1;
+        radius = shape.size.x * std::max(scale[(direction + 1) % 3], scale[(direction + 2) % 3]);
+        halfSegment = std::max(radius, shape.size.y * 0.5f * scale[direction]) - radius;
+    }
+
+    void CapsuleShape::loadLane(ShapeLanes &lanes, size_t lane) const {
+        lanes.cx[lane] = center.x;
+        lanes.cy[lane] = center.y;
+        lanes.cz[lane] = center.z;
+        lanes.sx[lane] = radius;
+        lanes.sy[lane] = halfSegment;
+        lanes.dx[lane] = axis.x;
+        lanes.dy[lane] = axis.y;
+        lanes.dz[lane] = axis.z;
+        lanes.flat[lane] = is2D ? 1.f : 0.f;
+    }
+
+    void CapsuleShape::projectLanes(ShapeLanes &l) {
+        alignas(32) float ox[kLanes], oy[kLanes], oz[kLanes], sx[kLanes], sy[kLanes], sz[kLanes], lengths[kLanes];
+        toShapeCenter(l);
+        for (size_t i = 0; i < kLanes; ++i) {
+            const float t = std::clamp(l.x[i] * l.dx[i] + l.y[i] * l.dy[i] + l.z[i] * l.dz[i], -l.sy[i], l.sy[i]);
+            sx[i] = l.dx[i] * t;
+            sy[i] = l.dy[i] * t;
+            sz[i] = l.dz[i] * t;
+            ox[i] = l.x[i] - sx[i];
+            oy[i] = l.y[i] - sy[i];
+            oz[i] = l.z[i] - sz[i];
+        }
+        normalizeLanes(l, ox, oy, oz, lengths);
+        for (size_t i = 0; i < kLanes; ++i) {
+            l.x[i] = l.cx[i] + sx[i] + l.nx[i] * l.sx[i];
+            l.y[i] = l.cy[i] + sy[i] + l.ny[i] * l.sx[i];
+            l.z[i] = l.cz[i] + sz[i] + l.nz[i] * l.sx[i];
+        }
+    }
+
+    // MARK: - DistanceField
+    DistanceFieldShape::DistanceFieldShape(const ColliderWorld &world, int32_t collider,
+                                           const AffineTransform &transform)
+        : transform(transform), is2D(is2DCollider(world, collider)) {
+        if (hasData(world, collider)) {
+            const DistanceFieldHeader &header = world.distanceFieldHeaders()[world.shapes()[collider].dataIndex];
+            nodes = world.distanceFieldNodes().data() + header.firstNode;
+            nodeCount = header.nodeCount;
+        }
+    }
+
+    bool DistanceFieldShape::hasData(const ColliderWorld &world, int32_t collider) {
+        const int32_t index = world.shapes()[collider].dataIndex;
+        if (index < 0 || size_t(index) >= world.distanceFieldHeaders().size()) {
+            return false;
+        }
+        const DistanceFieldHeader &header = world.distanceFieldHeaders()[index];
+        return header.nodeCount > 0 && header.firstNode >= 0 &&
+               size_t(header.firstNode) + size_t(header.nodeCount) <= world.distanceFieldNodes().size();
+    }
+
+    void DistanceFieldShape::loadLane(ShapeLanes &lanes, size_t lane) const {
+        lanes.sx[lane] = transform.scale.x;
+        lanes.sy[lane] = transform.scale.y;
+        lanes.sz[lane] = transform.scale.z;
+        lanes.flat[lane] = is2D ? 1.f : 0.f;
+        lanes.nodes[lane] = nodes;
+        lanes.nodeCounts[lane] = nodeCount;
+    }
+
+    // the octree descent differs per lane, only the unscaling and rescaling around it run across lanes.
+    void DistanceFieldShape::projectLanes(ShapeLanes &l) {
+        alignas(32) float gx[kLanes], gy[kLanes], gz[kLanes], distances[kLanes], lengths[kLanes];
+        for (size_t i = 0; i < kLanes; ++i) {
+            l.x[i] /= l.sx[i];
+            l.y[i] /= l.sy[i];
+            l.z[i] = l.flat[i] != 0 ? 0.f : l.z[i] / l.sz[i];
+        }
+        for (size_t i = 0; i < kLanes; ++i) {
+            const float4 sample =
+                ASDF::sampleWithGradient(l.nodes[i], size_t(l.nodeCounts[i]), float3(l.x[i], l.y[i], l.z[i]));
+            gx[i] = sample.x;
+            gy[i] = sample.y;
+            gz[i] = sample.z;
+            distances[i] = sample.w;
+        }
+        // local surface point, then the normal from the gradient through the inverse transpose of the scale.
+        normalizeLanes(l, gx, gy, gz, lengths);
+        for (size_t i = 0; i < kLanes; ++i) {
+            l.x[i] = (l.x[i] - l.nx[i] * distances[i]) * l.sx[i];
+            l.y[i] = (l.y[i] - l.ny[i] * distances[i]) * l.sy[i];
+            l.z[i] = (l.z[i] - l.nz[i] * distances[i]) * l.sz[i];
+            gx[i] /= l.sx[i];
+            gy[i] /= l.sy[i];
+            gz[i] /= l.sz[i];
+        }
+        normalizeLanes(l, gx, gy, gz, lengths);
+    }
+
+    // MARK: - Triangle
+    TriangleShape::TriangleShape(const float4 &a, const float4 &b, const float4 &c, const AffineTransform &transform,
+                                 bool is2D)
+        : a(a), b(b), c(c), transform(transform), is2D(is2D) {
+        const float3 normal = cross((b - a).xyz(), (c - a).xyz());
+        const float area = length(normal);
+        faceNormal = area > 1e-12f ? float4(normal / area, 0) : float4(0, 1, 0, 0);
+    }
+
+    // MARK: - HeightField
+    HeightFieldShape::HeightFieldShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform)
+        : transform(transform), is2D(is2DCollider(world, collider)) {
+        if (hasData(world, collider)) {
+            const ColliderShape &shape = world.shapes()[collider];
+            field = &world.heightFields()[shape.dataIndex];
+            const float3 scale = transform.scale.xyz();
+            cellWidth = shape.size.x * std::abs(scale.x) / float(field->cellCountU());
+            cellDepth = shape.size.z * std::abs(scale.z) / float(field->cellCountV());
+            heightScale = shape.size.y * scale.y;
+        }
+    }
+
+    bool HeightFieldShape::hasData(const ColliderWorld &world, int32_t collider) {
+        const ColliderShape &shape = world.shapes()[collider];
+        return shape.dataIndex >= 0 && size_t(shape.dataIndex) < world.heightFields().size() &&
+               !world.heightFields()[shape.dataIndex].empty() && shape.size.x > 0 && shape.size.z > 0;
+    }
+
+    // MARK: - TriangleMesh
+    TriangleMeshShape::TriangleMeshShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform)
+        : transform(transform), is2D(is2DCollider(world, collider)) {
+        if (hasData(world, collider)) {
+            mesh = &world.triangleMeshes().mesh(world.shapes()[collider].dataIndex);
+        }
+    }
+
+    bool TriangleMeshShape::hasData(const ColliderWorld &world, int32_t collider) {
+        const int32_t index = world.shapes()[collider].dataIndex;
+        return world.triangleMeshes().contains(index) && world.triangleMeshes().mesh(index).triangleCount() > 0;
+    }
+
+    Aabb TriangleMeshShape::localBounds(const Aabb &bounds) const {
+        Aabb local;
+        for (int i = 0; i < 8; ++i) {
+            const float4 corner((i & 1) != 0 ? bounds.max.x : bounds.min.x,
+                                (i & 2) != 0 ? bounds.max.y : bounds.min.y,
+                                (i & 4) != 0 ? bounds.max.z : bounds.min.z, 0);
+            local.encapsulateParticle(transform.inverseTransformPoint(corner), 0);
+        }
+        if (is2D) {
+            local.min.z = std::min(local.min.z, 0.f);
+            local.max.z = std::max(local.max.z, 0.f);
+        }
+        return local;
+    }
+} // namespace vox::flex
@@ -0,0 +1,298 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "ColliderWorld.h"
+#include "CollisionMath.h"
+#include "LocalOptimization.h"
+
+namespace vox::flex {
+    // Closest point queries of up to kLanes points against as many shapes of the same type, one per lane.
+    // Points are in the frame of their collider (translated and rotated, not scaled), and so are the results.
+    struct alignas(32) ShapeLanes {
+        static constexpr size_t kLanes = 8;
+
+        // query point in, nearest surface point out.
+        alignas(32) float x[kLanes];
+        alignas(32) float y[kLanes];
+        alignas(32) float z[kLanes];
+        // outward surface normal out.
+        alignas(32) float nx[kLanes];
+        alignas(32) float ny[kLanes];
+        alignas(32) float nz[kLanes];
+        // shape parameters, scaled by the collider transform: center, dimensions and direction.
+        alignas(32) float cx[kLanes];
+        alignas(32) float cy[kLanes];
+        alignas(32) float cz[kLanes];
+        alignas(32) float sx[kLanes];
+        alignas(32) float sy[kLanes];
+        alignas(32) float sz[kLanes];
+        alignas(32) float dx[kLanes];
+        alignas(32) float dy[kLanes];
+        alignas(32) float dz[kLanes];
+        // 1 for 2D shapes, whose queries are flattened to z = 0.
+        alignas(32) float flat[kLanes];
+        // distance field of each lane, distance field shapes only.
+        const DFNode *nodes[kLanes];
+        int32_t nodeCounts[kLanes];
+    };
+
+    // Distance functions of the analytic and distance field shapes, in solver space, for LocalOptimization.
+    // Each is built from a collider of the world and the transform from that collider to solver space, and
+    // also comes as a lane kernel, `projectLanes`, computing the same nearest points for kLanes particles at
+    // once once the lanes are filled by `loadLane`.
+    // Shapes apply the scale of their transform to their own dimensions, as Obi's Burst shapes do.
+    struct SphereShape {
+        float3 center;
+        float radius;
+        AffineTransform transform;
+        bool is2D;
+
+        SphereShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform);
+
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            float3 local = transform.inverseTransformPointUnscaled(point).xyz() - center;
+            if (is2D) {
+                local.z = 0;
+            }
+            const float distance = length(local);
+            const float3 normal = distance > 1e-12f ? local / distance : float3(0, 1, 0);
+            projectedPoint.point = transform.transformPointUnscaled(float4(center + normal * radius, 0));
+            projectedPoint.normal = transform.transformDirection(float4(normal, 0));
+        }
+
+        void loadLane(ShapeLanes &lanes, size_t lane) const;
+
+        static void projectLanes(ShapeLanes &lanes);
+    };
+
+    struct BoxShape {
+        float3 center;
+        float3 halfSize;
+        AffineTransform transform;
+        bool is2D;
+
+        BoxShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform);
+
+        // points inside the box are pushed out through the nearest face.
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            float3 local = transform.inverseTransformPointUnscaled(point).xyz() - center;
+            if (is2D) {
+                local.z = 0;
+            }
+            const float3 distances = halfSize - abs(local);
+            float3 nearest, normal;
+            if (distances.x > 0 && distances.y > 0 && (is2D || distances.z > 0)) {
+                int axis = distances.y < distances.x ? 1 : 0;
+                if (!is2D && distances.z < distances[axis]) {
+                    axis = 2;
+                }
+                nearest = local;
+                normal = float3(0, 0, 0);
+                nearest[axis] = local[axis] < 0 ? -halfSize[axis] : halfSize[axis];
+                normal[axis] = local[axis] < 0 ? -1.f : 1.f;
+            } else {
+                nearest = min(max(local, -halfSize), halfSize);
+                const float distance = length(local - nearest);
+                normal = distance > 1e-12f ? (local - nearest) / distance : float3(0, 1, 0);
+            }
+            projectedPoint.point = transform.transformPointUnscaled(float4(center + nearest, 0));
+            projectedPoint.normal = transform.transformDirection(float4(normal, 0));
+        }
+
+        void loadLane(ShapeLanes &lanes, size_t lane) const;
+
+        static void projectLanes(ShapeLanes &lanes);
+    };
+
+    struct CapsuleShape {
+        float3 center;
+        // unit axis, along x, y or z.
+        float3 axis;
+        float radius;
+        // half length of the inner segment.
+        float halfSegment;
+        AffineTransform transform;
+        bool is2D;
+
+        CapsuleShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform);
+
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            float3 local = transform.inverseTransformPointUnscaled(point).xyz() - center;
+            if (is2D) {
+                local.z = 0;
+            }
+            const float3 segmentPoint = axis * std::clamp(dot(local, axis), -halfSegment, halfSegment);
+            const float3 offset = local - segmentPoint;
+            const float distance = length(offset);
+            const float3 normal = distance > 1e-12f ? offset / distance : float3(0, 1, 0);
+            projectedPoint.point = transform.transformPointUnscaled(float4(center + segmentPoint + normal * radius, 0));
+            projectedPoint.normal = transform.transformDirection(float4(normal, 0));
+        }
+
+        void loadLane(ShapeLanes &lanes, size_t lane) const;
+
+        static void projectLanes(ShapeLanes &lanes);
+    };
+
+    // The distance field is sampled in the unscaled space of the field, its gradient giving the normal.
+    struct DistanceFieldShape {
+        const DFNode *nodes = nullptr;
+        int32_t nodeCount = 0;
+        AffineTransform transform;
+        bool is2D;
+
+        DistanceFieldShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform);
+
+        // false for colliders whose data index is not a distance field of the world.
+        static bool hasData(const ColliderWorld &world, int32_t collider);
+
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            float3 local = transform.inverseTransformPoint(point).xyz();
+            if (is2D) {
+                local.z = 0;
+            }
+            const float4 sample = ASDF::sampleWithGradient(nodes, size_t(nodeCount), local);
+            const float3 gradient = sample.xyz();
+            projectedPoint.point = transform.transformPoint(float4(local - normalize(gradient) * sample.w, 0));
+            // the inverse transpose of a scale is its inverse.
+            projectedPoint.normal =
+                normalize(transform.transformDirection(float4(gradient / transform.scale.xyz(), 0)));
+        }
+
+        void loadLane(ShapeLanes &lanes, size_t lane) const;
+
+        static void projectLanes(ShapeLanes &lanes);
+    };
+
+    // One-sided triangle, vertices in the frame of its collider with the scale applied: the triangles of
+    // heightfield cells and meshes, tested one at a time. The normal never points against the face normal,
+    // so points below the surface are pushed back up through it.
+    struct TriangleShape {
+        float4 a;
+        float4 b;
+        float4 c;
+        // unit, along (b - a) x (c - a).
+        float4 faceNormal;
+        AffineTransform transform;
+        bool is2D = false;
+
+        TriangleShape(const float4 &a, const float4 &b, const float4 &c, const AffineTransform &transform, bool is2D);
+
+        // nearest point and normal in the collider frame, for points already there.
+        void project(const float4 &local, float4 &point, float4 &normal) const {
+            float4 bary;
+            point = nearestPointOnTri(a, b, c, local, bary);
+            const float4 offset = local - point;
+            const float distance = length(offset.xyz());
+            normal = distance > 1e-12f ? offset / distance : faceNormal;
+            oneSidedNormal(faceNormal, normal);
+        }
+
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            float4 local = transform.inverseTransformPointUnscaled(point);
+            if (is2D) {
+                local.z = 0;
+            }
+            float4 nearest, normal;
+            project(local, nearest, normal);
+            projectedPoint.point = transform.transformPointUnscaled(nearest);
+            projectedPoint.normal = transform.transformDirection(normal);
+        }
+    };
+
+    // Heightfield collider over a HeightField of the world: x and z span [0, size.x] and [0, size.z] of the
+    // collider frame, y is the normalized sample times size.y, all scaled by the transform. Every cell is
+    // split in two upward facing triangles along its (u + 1, v) (u, v + 1) diagonal.
+    struct HeightFieldShape {
+        const HeightField *field = nullptr;
+        float cellWidth = 0;
+        float cellDepth = 0;
+        float heightScale = 0;
+        AffineTransform transform;
+        bool is2D;
+
+        HeightFieldShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform);
+
+        // false for colliders whose data index is not a non empty heightfield of the world.
+        static bool hasData(const ColliderWorld &world, int32_t collider);
+
+        // Calls `callback(triangle)` for both triangles of every solid cell whose bounds may overlap `bounds`,
+        // given in solver space.
+        template <typename Callback>
+        void forEachTriangle(const Aabb &bounds, Callback &&callback) const;
+    };
+
+    // Triangle mesh collider over a mesh of the world, whose vertices are in the unscaled space of the collider.
+    struct TriangleMeshShape {
+        const CollisionMesh *mesh = nullptr;
+        AffineTransform transform;
+        bool is2D;
+
+        TriangleMeshShape(const ColliderWorld &world, int32_t collider, const AffineTransform &transform);
+
+        // false for colliders whose data index is not a mesh of the world.
+        static bool hasData(const ColliderWorld &world, int32_t collider);
+
+        // Bounds in mesh space of `bounds`, given in solver space.
+        Aabb localBounds(const Aabb &bounds) const;
+
+        // Bounds in mesh space of triangle `index` of the mesh, in tree order.
+        Aabb triangleBounds(uint32_t index) const {
+            const int32_t *triangle = &mesh->triangles[size_t(index) * 3];
+            Aabb bounds;
+            for (int j = 0; j < 3; ++j) {
+                bounds.encapsulateParticle(mesh->vertices[triangle[j]], 0);
+            }
+            return bounds;
+        }
+
+        TriangleShape triangle(uint32_t index) const {
+            const int32_t *triangle = &mesh->triangles[size_t(index) * 3];
+            const float4 scale(transform.scale.xyz(), 0);
+            return TriangleShape(mesh->vertices[triangle[0]] * scale, mesh->vertices[triangle[1]] * scale,
+                                 mesh->vertices[triangle[2]] * scale, transform, is2D);
+        }
+    };
+
+    template <typename Callback>
+    void HeightFieldShape::forEachTriangle(const Aabb &bounds, Callback &&callback) const {
+        // bounds of the box corners in the collider frame.
+        Aabb local;
+        for (int i = 0; i < 8; ++i) {
+            const float4 corner((i & 1) != 0 ? bounds.max.x : bounds.min.x,
+                                (i & 2) != 0 ? bounds.max.y : bounds.min.y,
+                                (i & 4) != 0 ? bounds.max.z : bounds.min.z, 0);
+            local.encapsulateParticle(transform.inverseTransformPointUnscaled(corner), 0);
+        }
+        if (is2D) {
+            local.min.z = std::min(local.min.z, 0.f);
+            local.max.z = std::max(local.max.z, 0.f);
+        }
+
+        // clamped before the conversion, bounds far off the field would overflow it.
+        const auto cell = [](float coordinate, float size) {
+            return int32_t(std::clamp(std::floor(coordinate / size), -1.f, float(1 << 30)));
+        };
+        const int32_t minU = cell(local.min.x, cellWidth), maxU = cell(local.max.x, cellWidth);
+        const int32_t minV = cell(local.min.z, cellDepth), maxV = cell(local.max.z, cellDepth);
+        float minHeight = std::numeric_limits<float>::lowest(), maxHeight = std::numeric_limits<float>::max();
+        if (std::abs(heightScale) > 1e-12f) {
+            minHeight = std::min(local.min.y / heightScale, local.max.y / heightScale);
+            maxHeight = std::max(local.min.y / heightScale, local.max.y / heightScale);
+        }
+
+        field->forEachCell(minU, maxU, minV, maxV, minHeight, maxHeight, [&](int32_t u, int32_t v, const float4 &h) {
+            const float x = float(u) * cellWidth, z = float(v) * cellDepth;
+            const float4 p00(x, h.x * heightScale, z, 0), p10(x + cellWidth, h.y * heightScale, z, 0);
+            const float4 p01(x, h.z * heightScale, z + cellDepth, 0);
+            const float4 p11(x + cellWidth, h.w * heightScale, z + cellDepth, 0);
+            callback(TriangleShape(p00, p01, p10, transform, is2D));
+            callback(TriangleShape(p11, p10, p01, transform, is2D));
+        });
+    }
+} // namespace vox::flex
@@ -0,0 +1,51 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "CollisionMath.h"
+#include "LocalOptimization.h"
+
+namespace vox::flex {
+    // A solver simplex as a distance function for LocalOptimization: `evaluate` gives the simplex point
+    // nearest to the query, its barycentric coords and the direction from it to the query. Radii are left
+    // to the caller. Call `cacheData` after changing the simplex or the positions.
+    struct Simplex {
+        const float4 *positions = nullptr;
+        const int32_t *simplices = nullptr;
+        int32_t simplexStart = 0;
+        int32_t simplexSize = 0;
+
+        void cacheData() {
+            for (int32_t j = 0; j < simplexSize; ++j) {
+                _vertices[j] = positions[simplices[simplexStart + j]];
+            }
+        }
+
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            switch (simplexSize) {
+                case 2: {
+                    float mu;
+                    projectedPoint.point = nearestPointOnEdge(_vertices[0], _vertices[1], point, mu);
+                    projectedPoint.bary = {1 - mu, mu, 0, 0};
+                    break;
+                }
+                case 3:
+                    projectedPoint.point =
+                        nearestPointOnTri(_vertices[0], _vertices[1], _vertices[2], point, projectedPoint.bary);
+                    break;
+                default:
+                    projectedPoint.point = _vertices[0];
+                    projectedPoint.bary = {1, 0, 0, 0};
+                    break;
+            }
+            projectedPoint.normal = normalize(float4((point - projectedPoint.point).xyz(), 0));
+        }
+
+    private:
+        float4 _vertices[3];
+    };
+} // namespace vox::flex
@@ -0,0 +1,94 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "TriangleMeshContainer.h"
+
+#include <cstring>
+
+namespace vox::flex {
+    namespace {
+        // FNV-1a over raw bytes.
+        uint64_t hashBytes(uint64_t hash, const void *data, size_t size) {
+            const auto *bytes = static_cast<const uint8_t *>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return hash;
+        }
+    } // namespace
+
+    uint64_t TriangleMeshContainer::hashMesh(const float3 *vertices, size_t vertexCount, const int32_t *indices,
+                                             size_t triangleCount) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            const float xyz[3] = {vertices[i].x, vertices[i].y, vertices[i].z};
+            hash = hashBytes(hash, xyz, sizeof(xyz));
+        }
+        return hashBytes(hash, indices, triangleCount * 3 * sizeof(int32_t));
+    }
+
+    int32_t TriangleMeshContainer::acquire(uint64_t key, const float3 *vertices, size_t vertexCount,
+                                           const int32_t *indices, size_t triangleCount) {
+        const auto found = _indices.find(key);
+        if (found != _indices.end()) {
+            ++_entries[found->second].references;
+            return found->second;
+        }
+
+        int32_t index;
+        if (_freeIndices.empty()) {
+            index = int32_t(_entries.size());
+            _entries.emplace_back();
+        } else {
+            index = _freeIndices.back();
+            _freeIndices.pop_back();
+        }
+        Entry &entry = _entries[index];
+        entry.key = key;
+        entry.references = 1;
+        _indices.emplace(key, index);
+
+        CollisionMesh &mesh = entry.mesh;
+        mesh.vertices.resize(vertexCount);
+        mesh.bounds = Aabb();
+        for (size_t i = 0; i < vertexCount; ++i) {
+            mesh.vertices[i] = float4(vertices[i], 0);
+            mesh.bounds.encapsulateParticle(mesh.vertices[i], 0);
+        }
+
+        std::vector<Aabb> triangleBounds(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            Aabb &bounds = triangleBounds[t];
+            for (int j = 0; j < 3; ++j) {
+                bounds.encapsulateParticle(mesh.vertices[indices[t * 3 + j]], 0);
+            }
+        }
+        std::vector<uint32_t> order;
+        BIH::build(triangleBounds.data(), triangleCount, mesh.nodes, order);
+        mesh.triangles.resize(triangleCount * 3);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            std::memcpy(&mesh.triangles[t * 3], indices + size_t(order[t]) * 3, 3 * sizeof(int32_t));
+        }
+        return index;
+    }
+
+    bool TriangleMeshContainer::release(int32_t index) {
+        if (!contains(index) || --_entries[index].references > 0) {
+            return false;
+        }
+        Entry &entry = _entries[index];
+        _indices.erase(entry.key);
+        entry.mesh = CollisionMesh();
+        _freeIndices.push_back(index);
+        return true;
+    }
+
+    void TriangleMeshContainer::clear() {
+        _entries.clear();
+        _indices.clear();
+        _freeIndices.clear();
+    }
+} // namespace vox::flex
@@ -0,0 +1,67 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../data-structures/bih/BIH.h"
+#include <unordered_map>
+#include <vector>
+
+namespace vox::flex {
+    // Triangle mesh of mesh colliders, in mesh space, its triangles reordered along its BIH.
+    struct CollisionMesh {
+        std::vector<BIHNode> nodes;
+        // three vertex indices per triangle.
+        std::vector<int32_t> triangles;
+        std::vector<float4> vertices;
+        Aabb bounds;
+
+        size_t triangleCount() const { return triangles.size() / 3; }
+    };
+
+    // Native counterpart of ObiTriangleMeshContainer: the meshes of TriangleMesh colliders, referenced by their
+    // data index. Meshes are reference counted by key, so every collider instancing the same mesh shares its
+    // vertices and tree, which are only built by the first reference. The index of an unreferenced mesh is
+    // reused by the next new one.
+    class TriangleMeshContainer {
+    public:
+        // Key of a mesh from its contents, for owners without a key of their own.
+        static uint64_t hashMesh(const float3 *vertices, size_t vertexCount, const int32_t *indices,
+                                 size_t triangleCount);
+
+        // Returns the index of the mesh of `key`, referenced once more. A new key builds the mesh of
+        // `triangleCount` triangles, three indices of `vertices` each.
+        int32_t acquire(uint64_t key, const float3 *vertices, size_t vertexCount, const int32_t *indices,
+                        size_t triangleCount);
+
+        // Drops one reference to mesh `index`, freeing it once unreferenced. Returns true if it was freed.
+        bool release(int32_t index);
+
+        void clear();
+
+        // number of indices in use or free.
+        size_t size() const { return _entries.size(); }
+
+        bool contains(int32_t index) const {
+            return index >= 0 && size_t(index) < _entries.size() && _entries[index].references > 0;
+        }
+
+        const CollisionMesh &mesh(int32_t index) const { return _entries[index].mesh; }
+
+        int32_t referenceCount(int32_t index) const { return contains(index) ? _entries[index].references : 0; }
+
+    private:
+        struct Entry {
+            CollisionMesh mesh;
+            uint64_t key = 0;
+            int32_t references = 0;
+        };
+
+        std::vector<Entry> _entries;
+        std::unordered_map<uint64_t, int32_t> _indices;
+        std::vector<int32_t> _freeIndices;
+    };
+} // namespace vox::flex
@@ -0,0 +1,60 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "Math.h"
+
+namespace vox::flex {
+    // Axis aligned box with float4 corners (w unused), native counterpart of BurstAabb. A default box is
+    // empty (min above max), so encapsulating anything into it yields that thing's bounds.
+    struct alignas(16) Aabb {
+        float4 min;
+        float4 max;
+
+        Aabb() : min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest()) {}
+
+        Aabb(const float4 &min, const float4 &max) : min(min), max(max) {}
+
+        float4 size() const { return max - min; }
+
+        float4 center() const { return (min + max) * 0.5f; }
+
+        float maxAxisLength() const { return maxComponent(size().xyz()); }
+
+        void encapsulateParticle(const float4 &position, float radius) {
+            min = vox::flex::min(min, position - float4(radius));
+            max = vox::flex::max(max, position + float4(radius));
+        }
+
+        void encapsulateParticle(const float4 &previousPosition, const float4 &position, float radius) {
+            encapsulateParticle(previousPosition, radius);
+            encapsulateParticle(position, radius);
+        }
+
+        void encapsulateBounds(const Aabb &bounds) {
+            min = vox::flex::min(min, bounds.min);
+            max = vox::flex::max(max, bounds.max);
+        }
+
+        void expand(const float4 &amount) {
+            min -= amount;
+            max += amount;
+        }
+
+        // grows the box to also contain itself moved by `velocity`.
+        void sweep(const float4 &velocity) {
+            min = vox::flex::min(min, min + velocity);
+            max = vox::flex::max(max, max + velocity);
+        }
+
+        // in 2D the z axis is ignored.
+        bool intersectsAabb(const Aabb &bounds, bool in2D = false) const {
+            return min.x <= bounds.max.x && max.x >= bounds.min.x && min.y <= bounds.max.y &&
+                   max.y >= bounds.min.y && (in2D || (min.z <= bounds.max.z && max.z >= bounds.min.z));
+        }
+    };
+} // namespace vox::flex
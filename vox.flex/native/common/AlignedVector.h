@@ -0,0 +1,47 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace vox::flex {
+    // Allocator returning storage aligned to `Alignment` bytes whatever the element type, so scalar
+    // arrays (inverse masses, counters...) can be streamed with aligned 4-wide loads like float4 ones.
+    template <typename T, size_t Alignment = 16>
+    struct AlignedAllocator {
+        static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0);
+
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+        T *allocate(size_t count) {
+            return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T *pointer, size_t) { ::operator delete(pointer, std::align_val_t(Alignment)); }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment> &) const { return true; }
+
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment> &) const { return false; }
+    };
+
+    template <typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+} // namespace vox::flex
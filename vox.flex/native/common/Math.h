@@ -0,0 +1,286 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace vox::flex {
+    // Plain vector types for the native core. They deliberately mirror the memory layout of
+    // simd_float3 / simd_float4 (16 bytes, 16 byte aligned) so buffers can be shared with
+    // Swift and Metal without conversion, while keeping the core free of Apple headers.
+    struct alignas(16) float3 {
+        float x, y, z;
+
+        float3() : x(0), y(0), z(0) {}
+
+        explicit float3(float s) : x(s), y(s), z(s) {}
+
+        float3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+        float &operator[](int i) { return (&x)[i]; }
+
+        float operator[](int i) const { return (&x)[i]; }
+    };
+
+    struct alignas(16) float4 {
+        float x, y, z, w;
+
+        float4() : x(0), y(0), z(0), w(0) {}
+
+        explicit float4(float s) : x(s), y(s), z(s), w(s) {}
+
+        float4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+        float4(const float3 &v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+        float3 xyz() const { return {x, y, z}; }
+
+        float &operator[](int i) { return (&x)[i]; }
+
+        float operator[](int i) const { return (&x)[i]; }
+    };
+
+    struct alignas(16) int4 {
+        int32_t x, y, z, w;
+
+        int4() : x(0), y(0), z(0), w(0) {}
+
+        int4(int32_t x, int32_t y, int32_t z, int32_t w) : x(x), y(y), z(z), w(w) {}
+
+        int32_t &operator[](int i) { return (&x)[i]; }
+
+        int32_t operator[](int i) const { return (&x)[i]; }
+
+        bool operator==(const int4 &o) const { return x == o.x && y == o.y && z == o.z && w == o.w; }
+
+        bool operator!=(const int4 &o) const { return !(*this == o); }
+    };
+
+    // Rotation quaternion with the vector part first, same layout as simd_quatf.
+    struct alignas(16) quaternion {
+        float x, y, z, w;
+
+        quaternion() : x(0), y(0), z(0), w(1) {}
+
+        quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+        quaternion(const float3 &v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+        float3 xyz() const { return {x, y, z}; }
+    };
+
+    // Column-major 3x3 matrix, same layout as simd_float3x3.
+    struct float3x3 {
+        float3 columns[3];
+
+        float3x3() = default;
+
+        explicit float3x3(float diagonal)
+            : columns{float3(diagonal, 0, 0), float3(0, diagonal, 0), float3(0, 0, diagonal)} {}
+
+        float3x3(const float3 &c0, const float3 &c1, const float3 &c2) : columns{c0, c1, c2} {}
+
+        float3 &operator[](int i) { return columns[i]; }
+
+        const float3 &operator[](int i) const { return columns[i]; }
+    };
+
+    // MARK: - float3
+    inline float3 operator+(const float3 &a, const float3 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+
+    inline float3 operator-(const float3 &a, const float3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+
+    inline float3 operator*(const float3 &a, const float3 &b) { return {a.x * b.x, a.y * b.y, a.z * b.z}; }
+
+    inline float3 operator/(const float3 &a, const float3 &b) { return {a.x / b.x, a.y / b.y, a.z / b.z}; }
+
+    inline float3 operator*(const float3 &a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+
+    inline float3 operator*(float s, const float3 &a) { return {a.x * s, a.y * s, a.z * s}; }
+
+    inline float3 operator/(const float3 &a, float s) { return a * (1.f / s); }
+
+    inline float3 operator-(const float3 &a) { return {-a.x, -a.y, -a.z}; }
+
+    inline float3 &operator+=(float3 &a, const float3 &b) { return a = a + b; }
+
+    inline float3 &operator-=(float3 &a, const float3 &b) { return a = a - b; }
+
+    inline float3 &operator*=(float3 &a, float s) { return a = a * s; }
+
+    inline float dot(const float3 &a, const float3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    inline float3 cross(const float3 &a, const float3 &b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    inline float lengthSquared(const float3 &a) { return dot(a, a); }
+
+    inline float length(const float3 &a) { return std::sqrt(dot(a, a)); }
+
+    inline float3 normalize(const float3 &a) {
+        float l = length(a);
+        return l > 1e-12f ? a / l : float3();
+    }
+
+    inline float3 min(const float3 &a, const float3 &b) {
+        return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+    }
+
+    inline float3 max(const float3 &a, const float3 &b) {
+        return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+    }
+
+    inline float3 abs(const float3 &a) { return {std::fabs(a.x), std::fabs(a.y), std::fabs(a.z)}; }
+
+    inline float maxComponent(const float3 &a) { return std::max(a.x, std::max(a.y, a.z)); }
+
+    // MARK: - float4
+    inline float4 operator+(const float4 &a, const float4 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; }
+
+    inline float4 operator-(const float4 &a, const float4 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; }
+
+    inline float4 operator*(const float4 &a, const float4 &b) { return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w}; }
+
+    inline float4 operator*(const float4 &a, float s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
+
+    inline float4 operator*(float s, const float4 &a) { return a * s; }
+
+    inline float4 operator/(const float4 &a, float s) { return a * (1.f / s); }
+
+    inline float4 operator-(const float4 &a) { return {-a.x, -a.y, -a.z, -a.w}; }
+
+    inline float4 &operator+=(float4 &a, const float4 &b) { return a = a + b; }
+
+    inline float4 &operator-=(float4 &a, const float4 &b) { return a = a - b; }
+
+    inline float4 &operator*=(float4 &a, float s) { return a = a * s; }
+
+    inline float dot(const float4 &a, const float4 &b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    inline float lengthSquared(const float4 &a) { return dot(a, a); }
+
+    inline float length(const float4 &a) { return std::sqrt(dot(a, a)); }
+
+    inline float4 normalize(const float4 &a) {
+        float l = length(a);
+        return l > 1e-12f ? a / l : float4();
+    }
+
+    inline float4 min(const float4 &a, const float4 &b) {
+        return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z), std::min(a.w, b.w)};
+    }
+
+    inline float4 max(const float4 &a, const float4 &b) {
+        return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z), std::max(a.w, b.w)};
+    }
+
+    inline float4 lerp(const float4 &a, const float4 &b, float t) { return a + (b - a) * t; }
+
+    // MARK: - quaternion
+    inline quaternion operator+(const quaternion &a, const quaternion &b) {
+        return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+    }
+
+    inline quaternion operator*(const quaternion &a, float s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
+
+    inline quaternion operator*(const quaternion &a, const quaternion &b) {
+        return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y, a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w, a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+    }
+
+    inline float dot(const quaternion &a, const quaternion &b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    }
+
+    inline quaternion conjugate(const quaternion &q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+    inline quaternion inverse(const quaternion &q) { return conjugate(q) * (1.f / dot(q, q)); }
+
+    inline quaternion normalize(const quaternion &q) {
+        float l = std::sqrt(dot(q, q));
+        return l > 0 ? q * (1.f / l) : quaternion();
+    }
+
+    inline float3 rotate(const quaternion &q, const float3 &v) {
+        float3 u = q.xyz();
+        float3 t = cross(u, v) * 2.f;
+        return v + t * q.w + cross(u, t);
+    }
+
+    // Normalized linear interpolation along the shortest arc.
+    inline quaternion nlerp(const quaternion &a, const quaternion &b, float t) {
+        float s = dot(a, b) < 0 ? -1.f : 1.f;
+        return normalize(a * (1 - t) + b * (s * t));
+    }
+
+    // MARK: - float3x3
+    inline float3x3 operator+(const float3x3 &a, const float3x3 &b) {
+        return {a[0] + b[0], a[1] + b[1], a[2] + b[2]};
+    }
+
+    inline float3x3 operator-(const float3x3 &a, const float3x3 &b) {
+        return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+    }
+
+    inline float3x3 operator*(const float3x3 &a, float s) { return {a[0] * s, a[1] * s, a[2] * s}; }
+
+    inline float3 operator*(const float3x3 &a, const float3 &v) { return a[0] * v.x + a[1] * v.y + a[2] * v.z; }
+
+    inline float3x3 operator*(const float3x3 &a, const float3x3 &b) { return {a * b[0], a * b[1], a * b[2]}; }
+
+    inline float3x3 transpose(const float3x3 &a) {
+        return {{a[0].x, a[1].x, a[2].x}, {a[0].y, a[1].y, a[2].y}, {a[0].z, a[1].z, a[2].z}};
+    }
+
+    inline float determinant(const float3x3 &a) { return dot(a[0], cross(a[1], a[2])); }
+
+    // Zero when `a` is singular.
+    inline float3x3 inverse(const float3x3 &a) {
+        const float det = determinant(a);
+        if (det == 0) {
+            return float3x3(0);
+        }
+        return transpose(float3x3(cross(a[1], a[2]), cross(a[2], a[0]), cross(a[0], a[1]))) * (1.f / det);
+    }
+
+    // a * b^T
+    inline float3x3 outerProduct(const float3 &a, const float3 &b) { return {a * b.x, a * b.y, a * b.z}; }
+
+    inline float frobeniusNorm(const float3x3 &a) {
+        return std::sqrt(lengthSquared(a[0]) + lengthSquared(a[1]) + lengthSquared(a[2]));
+    }
+
+    inline float3x3 rotationMatrix(const quaternion &q) {
+        return {rotate(q, float3(1, 0, 0)), rotate(q, float3(0, 1, 0)), rotate(q, float3(0, 0, 1))};
+    }
+
+    // Rotation about `axis` (unit length) by `angle` radians.
+    inline quaternion axisAngle(const float3 &axis, float angle) {
+        return {axis * std::sin(angle * 0.5f), std::cos(angle * 0.5f)};
+    }
+
+    // Rotational part of `a` (Müller et al. 2016, "A Robust Method to Extract the Rotational Part of
+    // Deformations"). Refines `q` in place, so a rotation kept from the previous frame converges in a couple of
+    // iterations, and stays a valid rotation for degenerate or inverted matrices where polar decomposition
+    // is undefined.
+    inline void extractRotation(const float3x3 &a, quaternion &q, int iterations) {
+        for (int i = 0; i < iterations; ++i) {
+            const float3x3 r = rotationMatrix(q);
+            const float3 omega = (cross(r[0], a[0]) + cross(r[1], a[1]) + cross(r[2], a[2])) *
+                                 (1.f / (std::fabs(dot(r[0], a[0]) + dot(r[1], a[1]) + dot(r[2], a[2])) + 1e-9f));
+            const float w = length(omega);
+            if (w < 1e-9f) {
+                break;
+            }
+            q = normalize(axisAngle(omega * (1.f / w), w) * q);
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,176 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "Parallel.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        thread_local bool tInsideParallelFor = false;
+
+        uint64_t packRange(uint32_t begin, uint32_t end) { return uint64_t(begin) | uint64_t(end) << 32; }
+
+        uint32_t rangeBegin(uint64_t range) { return uint32_t(range); }
+
+        uint32_t rangeEnd(uint64_t range) { return uint32_t(range >> 32); }
+
+        // owner side: takes up to `grain` items from the front.
+        bool popFront(std::atomic<uint64_t> &bounds, uint32_t grain, uint32_t &begin, uint32_t &end) {
+            uint64_t range = bounds.load(std::memory_order_relaxed);
+            while (rangeBegin(range) < rangeEnd(range)) {
+                begin = rangeBegin(range);
+                end = std::min(rangeEnd(range), begin + grain);
+                if (bounds.compare_exchange_weak(range, packRange(end, rangeEnd(range)), std::memory_order_acq_rel)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // thief side: takes the back half (or the whole remainder if it is a single chunk).
+        bool stealBack(std::atomic<uint64_t> &bounds, uint32_t grain, uint32_t &begin, uint32_t &end) {
+            uint64_t range = bounds.load(std::memory_order_relaxed);
+            while (rangeBegin(range) < rangeEnd(range)) {
+                uint32_t count = rangeEnd(range) - rangeBegin(range);
+                uint32_t take = count > grain ? count / 2 : count;
+                begin = rangeEnd(range) - take;
+                end = rangeEnd(range);
+                if (bounds.compare_exchange_weak(range, packRange(rangeBegin(range), begin),
+                                                 std::memory_order_acq_rel)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } // namespace
+
+    ThreadPool &ThreadPool::shared() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    ThreadPool::ThreadPool(size_t workerCount) {
+        _workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            _workers.emplace_back([this, i] { workerLoop(i + 1); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto &worker : _workers) {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::runChunks(Job &job, size_t participant) {
+        tInsideParallelFor = true;
+        const uint32_t grain = static_cast<uint32_t>(job.grain);
+        std::atomic<uint64_t> &own = job.ranges[participant].bounds;
+        uint32_t begin, end;
+        while (true) {
+            while (popFront(own, grain, begin, end)) {
+                (*job.function)(job.begin + begin, job.begin + end);
+            }
+
+            // out of work: steal from the others, starting with the next participant. Our own range
+            // is empty at this point, so nobody else can be modifying it while we refill it.
+            bool stole = false;
+            for (size_t k = 1; k < job.rangeCount && !stole; ++k) {
+                stole = stealBack(job.ranges[(participant + k) % job.rangeCount].bounds, grain, begin, end);
+            }
+            if (!stole) {
+                break;
+            }
+            own.store(packRange(begin, end), std::memory_order_release);
+        }
+        tInsideParallelFor = false;
+    }
+
+    void ThreadPool::workerLoop(size_t participant) {
+        uint64_t seen = 0;
+        while (true) {
+            Job *job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&] { return _stop || (_job != nullptr && _generation != seen); });
+                if (_stop) {
+                    return;
+                }
+                seen = _generation;
+                job = _job;
+            }
+
+            runChunks(*job, participant);
+
+            if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _done.notify_all();
+            }
+        }
+    }
+
+    void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction &function) {
+        if (end <= begin) {
+            return;
+        }
+        grain = std::max<size_t>(grain, 1);
+
+        // serial fallback: tiny loops, no workers, or nested loops issued from inside a chunk.
+        if (_workers.empty() || tInsideParallelFor || end - begin <= grain) {
+            bool wasInside = tInsideParallelFor;
+            tInsideParallelFor = true;
+            function(begin, end);
+            tInsideParallelFor = wasInside;
+            return;
+        }
+
+        // offsets are packed in 32 bits; larger loops are issued as several jobs.
+        constexpr size_t kMaxJobSize = size_t(UINT32_MAX);
+        if (end - begin > kMaxJobSize) {
+            for (size_t b = begin; b < end; b += kMaxJobSize) {
+                parallelFor(b, std::min(end, b + kMaxJobSize), grain, function);
+            }
+            return;
+        }
+        grain = std::min(grain, kMaxJobSize);
+
+        // only one loop is in flight at a time; concurrent callers queue up here.
+        static std::mutex submitMutex;
+        std::lock_guard<std::mutex> submit(submitMutex);
+
+        Job job;
+        job.function = &function;
+        job.begin = begin;
+        job.grain = grain;
+        job.rangeCount = concurrency();
+        job.ranges = std::make_unique<WorkRange[]>(job.rangeCount);
+        const size_t count = end - begin;
+        for (size_t p = 0; p < job.rangeCount; ++p) {
+            job.ranges[p].bounds.store(packRange(uint32_t(count * p / job.rangeCount),
+                                                 uint32_t(count * (p + 1) / job.rangeCount)),
+                                       std::memory_order_relaxed);
+        }
+        job.pending.store(_workers.size(), std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = &job;
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        runChunks(job, 0);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [&] { return job.pending.load(std::memory_order_acquire) == 0; });
+        _job = nullptr;
+    }
+} // namespace vox::flex
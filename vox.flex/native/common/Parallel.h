@@ -0,0 +1,132 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vox::flex {
+    // Persistent worker pool used by every parallel stage of the native core. A loop is split evenly
+    // between the participating threads up front; each walks its own contiguous range in grain-sized
+    // chunks from the front, and a thread that runs dry steals the back half of another one's range,
+    // so uneven chunks balance out while most items stay on the thread that touched their neighbors.
+    // The calling thread takes part in the loop. Nested calls run serially on the calling thread.
+    class ThreadPool {
+    public:
+        using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+        static ThreadPool &shared();
+
+        explicit ThreadPool(size_t workerCount);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Number of threads taking part in a parallel loop, including the caller.
+        size_t concurrency() const { return _workers.size() + 1; }
+
+        void parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction &function);
+
+    private:
+        // [begin, end) offsets relative to Job::begin, packed as begin | end << 32 so that owner pops
+        // and steals are single compare-exchanges.
+        struct alignas(64) WorkRange {
+            std::atomic<uint64_t> bounds{0};
+        };
+
+        struct Job {
+            const RangeFunction *function = nullptr;
+            size_t begin = 0;
+            size_t grain = 1;
+            std::unique_ptr<WorkRange[]> ranges;
+            size_t rangeCount = 0;
+            std::atomic<size_t> pending{0};
+        };
+
+        void workerLoop(size_t participant);
+
+        static void runChunks(Job &job, size_t participant);
+
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        Job *_job = nullptr;
+        uint64_t _generation = 0;
+        bool _stop = false;
+    };
+
+    // Splits [begin, end) into chunks of at least `grain` items and calls `function(begin, end)`
+    // for each of them on the shared pool.
+    template <typename Function>
+    void parallelFor(size_t begin, size_t end, size_t grain, Function &&function) {
+        if (end <= begin) {
+            return;
+        }
+        ThreadPool::RangeFunction range = std::forward<Function>(function);
+        ThreadPool::shared().parallelFor(begin, end, grain, range);
+    }
+
+    // Per-index convenience over `parallelFor`.
+    template <typename Function>
+    void parallelForEach(size_t count, size_t grain, Function &&function) {
+        parallelFor(0, count, grain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                function(i);
+            }
+        });
+    }
+
+    // Exclusive prefix sum of `count` values, computed block-wise in parallel. `out` may alias `in`.
+    // Returns the total sum.
+    template <typename T>
+    T parallelExclusiveScan(const T *in, T *out, size_t count) {
+        const size_t blockCount = std::min(count, ThreadPool::shared().concurrency() * 4);
+        if (blockCount <= 1) {
+            T sum = 0;
+            for (size_t i = 0; i < count; ++i) {
+                T value = in[i];
+                out[i] = sum;
+                sum += value;
+            }
+            return sum;
+        }
+
+        const size_t blockSize = (count + blockCount - 1) / blockCount;
+        std::vector<T> blockSums(blockCount + 1, 0);
+        parallelForEach(blockCount, 1, [&](size_t block) {
+            T sum = 0;
+            for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; ++i) {
+                sum += in[i];
+            }
+            blockSums[block + 1] = sum;
+        });
+        for (size_t block = 0; block < blockCount; ++block) {
+            blockSums[block + 1] += blockSums[block];
+        }
+        parallelForEach(blockCount, 1, [&](size_t block) {
+            T sum = blockSums[block];
+            for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; ++i) {
+                T value = in[i];
+                out[i] = sum;
+                sum += value;
+            }
+        });
+        return blockSums[blockCount];
+    }
+} // namespace vox::flex
@@ -0,0 +1,94 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "Math.h"
+
+namespace vox::flex {
+    // Vectors of N constraints in SoA lanes.
+    template <size_t N>
+    struct VectorLanes {
+        alignas(32) float x[N], y[N], z[N];
+
+        void set(size_t l, const float3 &v) {
+            x[l] = v.x;
+            y[l] = v.y;
+            z[l] = v.z;
+        }
+
+        float3 get(size_t l) const { return {x[l], y[l], z[l]}; }
+    };
+
+    // Quaternions of N constraints in SoA lanes. The operations below are straight-line lane loops, which the
+    // compiler turns into 4/8-wide SIMD the same way as the scalar lanes of the constraint kernels.
+    template <size_t N>
+    struct QuaternionLanes {
+        alignas(32) float x[N], y[N], z[N], w[N];
+
+        void set(size_t l, const quaternion &q) {
+            x[l] = q.x;
+            y[l] = q.y;
+            z[l] = q.z;
+            w[l] = q.w;
+        }
+
+        quaternion get(size_t l) const { return {x[l], y[l], z[l], w[l]}; }
+    };
+
+    // out = a * b, conjugating either operand first if asked. `out` may not alias the operands.
+    template <bool ConjugateA = false, bool ConjugateB = false, size_t N>
+    inline void multiply(const QuaternionLanes<N> &a, const QuaternionLanes<N> &b, QuaternionLanes<N> &out) {
+        constexpr float sa = ConjugateA ? -1.f : 1.f;
+        constexpr float sb = ConjugateB ? -1.f : 1.f;
+        for (size_t l = 0; l < N; ++l) {
+            const float ax = a.x[l] * sa, ay = a.y[l] * sa, az = a.z[l] * sa, aw = a.w[l];
+            const float bx = b.x[l] * sb, by = b.y[l] * sb, bz = b.z[l] * sb, bw = b.w[l];
+            out.x[l] = aw * bx + ax * bw + ay * bz - az * by;
+            out.y[l] = aw * by - ax * bz + ay * bw + az * bx;
+            out.z[l] = aw * bz + ax * by - ay * bx + az * bw;
+            out.w[l] = aw * bw - ax * bx - ay * by - az * bz;
+        }
+    }
+
+    // out = q * (v, 0), the product of a quaternion and a pure one.
+    template <size_t N>
+    inline void multiply(const QuaternionLanes<N> &q, const VectorLanes<N> &v, QuaternionLanes<N> &out) {
+        for (size_t l = 0; l < N; ++l) {
+            out.x[l] = q.w[l] * v.x[l] + q.y[l] * v.z[l] - q.z[l] * v.y[l];
+            out.y[l] = q.w[l] * v.y[l] - q.x[l] * v.z[l] + q.z[l] * v.x[l];
+            out.z[l] = q.w[l] * v.z[l] + q.x[l] * v.y[l] - q.y[l] * v.x[l];
+            out.w[l] = -q.x[l] * v.x[l] - q.y[l] * v.y[l] - q.z[l] * v.z[l];
+        }
+    }
+
+    // out = (v, 0) * q.
+    template <size_t N>
+    inline void multiply(const VectorLanes<N> &v, const QuaternionLanes<N> &q, QuaternionLanes<N> &out) {
+        for (size_t l = 0; l < N; ++l) {
+            out.x[l] = v.x[l] * q.w[l] + v.y[l] * q.z[l] - v.z[l] * q.y[l];
+            out.y[l] = -v.x[l] * q.z[l] + v.y[l] * q.w[l] + v.z[l] * q.x[l];
+            out.z[l] = v.x[l] * q.y[l] - v.y[l] * q.x[l] + v.z[l] * q.w[l];
+            out.w[l] = -v.x[l] * q.x[l] - v.y[l] * q.y[l] - v.z[l] * q.z[l];
+        }
+    }
+
+    // out = q v q*, or q* v q when `Inverse`, for unit quaternions. `out` may not alias `v`.
+    template <bool Inverse = false, size_t N>
+    inline void rotate(const QuaternionLanes<N> &q, const VectorLanes<N> &v, VectorLanes<N> &out) {
+        constexpr float s = Inverse ? -1.f : 1.f;
+        for (size_t l = 0; l < N; ++l) {
+            // v + 2w (u x v) + 2 u x (u x v), u the vector part.
+            const float ux = q.x[l] * s, uy = q.y[l] * s, uz = q.z[l] * s;
+            const float tx = 2 * (uy * v.z[l] - uz * v.y[l]);
+            const float ty = 2 * (uz * v.x[l] - ux * v.z[l]);
+            const float tz = 2 * (ux * v.y[l] - uy * v.x[l]);
+            out.x[l] = v.x[l] + q.w[l] * tx + uy * tz - uz * ty;
+            out.y[l] = v.y[l] + q.w[l] * ty + uz * tx - ux * tz;
+            out.z[l] = v.z[l] + q.w[l] * tz + ux * ty - uy * tx;
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,226 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "AerodynamicConstraintsBatch.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kGroupGrain = 32;
+        constexpr size_t kParticleGrain = 512;
+        constexpr float kEpsilon = 1e-7f;
+    } // namespace
+
+    void AerodynamicConstraintsBatch::setAerodynamicConstraints(const int32_t *particleIndices,
+                                                                const float *aerodynamicCoeffs, size_t count) {
+        _particleIndices.assign(particleIndices, particleIndices + count);
+        _coefficients.assign(aerodynamicCoeffs, aerodynamicCoeffs + count * 3);
+        _trianglesDirty = true;
+    }
+
+    void AerodynamicConstraintsBatch::bind(const DeformableTriangles *triangles, const WindField *windField) {
+        if (triangles != _deformableTriangles) {
+            _deformableTriangles = triangles;
+            _trianglesDirty = true;
+        }
+        _windField = windField != nullptr && !windField->empty() ? windField : nullptr;
+    }
+
+    void AerodynamicConstraintsBatch::updateTriangles(size_t particleCount) {
+        _triangles.clear();
+        _drag.clear();
+        _lift.clear();
+        _colorOffsets.assign(1, 0);
+        _lastColorSequential = false;
+
+        // constraint of every particle, -1 for particles of other batches.
+        std::vector<int32_t> constraints(particleCount, -1);
+        for (size_t c = 0; c < _particleIndices.size(); ++c) {
+            constraints[_particleIndices[c]] = int32_t(c);
+        }
+        std::vector<uint8_t> covered(_particleIndices.size(), 0);
+
+        if (_deformableTriangles != nullptr) {
+            const std::vector<int32_t> &indices = _deformableTriangles->indices();
+            const std::vector<uint32_t> &sorted = _deformableTriangles->sortedIndices();
+            for (const BatchData &batch : _deformableTriangles->batches()) {
+                for (uint32_t slot = batch.startIndex; slot < batch.startIndex + batch.constraintCount; ++slot) {
+                    const int32_t *triangle = indices.data() + size_t(sorted[slot]) * 3;
+                    int32_t c[3];
+                    bool inBatch = true;
+                    for (int k = 0; k < 3; ++k) {
+                        c[k] = size_t(triangle[k]) < particleCount ? constraints[triangle[k]] : -1;
+                        inBatch = inBatch && c[k] >= 0;
+                    }
+                    if (!inBatch) {
+                        continue;
+                    }
+                    float drag = 0, lift = 0;
+                    for (int k = 0; k < 3; ++k) {
+                        _triangles.push_back(triangle[k]);
+                        drag += _coefficients[c[k] * 3 + 1] / 3;
+                        lift += _coefficients[c[k] * 3 + 2] / 3;
+                        covered[c[k]] = 1;
+                    }
+                    _drag.push_back(drag);
+                    _lift.push_back(lift);
+                }
+                if (_drag.size() > _colorOffsets.back()) {
+                    _colorOffsets.push_back(_drag.size());
+                    _lastColorSequential = batch.isLast;
+                }
+            }
+            _trianglesVersion = _deformableTriangles->version();
+        }
+
+        _looseConstraints.clear();
+        for (size_t c = 0; c < covered.size(); ++c) {
+            if (!covered[c]) {
+                _looseConstraints.push_back(int32_t(c));
+            }
+        }
+        _trianglesDirty = false;
+    }
+
+    void AerodynamicConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &, float,
+                                               float substepTime, int) {
+        if (_trianglesDirty ||
+            (_deformableTriangles != nullptr && _deformableTriangles->version() != _trianglesVersion)) {
+            updateTriangles(particles.size());
+        }
+
+        const size_t colorCount = _colorOffsets.size() - 1;
+        for (size_t color = 0; color < colorCount; ++color) {
+            const size_t first = _colorOffsets[color];
+            const size_t count = _colorOffsets[color + 1] - first;
+            const size_t groupCount = (count + kLanes - 1) / kLanes;
+            auto forces = [&](size_t begin, size_t end) {
+                begin = first + begin * kLanes;
+                end = first + std::min(count, end * kLanes);
+                _windField != nullptr ? triangleForces<true>(particles, begin, end, substepTime)
+                                      : triangleForces<false>(particles, begin, end, substepTime);
+            };
+            // triangles of the overflow color may share particles.
+            if (_lastColorSequential && color + 1 == colorCount) {
+                forces(0, groupCount);
+            } else {
+                parallelFor(0, groupCount, kGroupGrain, forces);
+            }
+        }
+
+        parallelFor(0, _looseConstraints.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            particleForces(particles, begin, end, substepTime);
+        });
+    }
+
+    template <bool Field>
+    void AerodynamicConstraintsBatch::triangleForces(ParticleData &particles, size_t begin, size_t end,
+                                                     float deltaTime) const {
+        const float4 *positions = particles.positions.data();
+        float4 *velocities = particles.velocities.data();
+        const float4 *wind = particles.wind.data();
+        const float *invMasses = particles.invMasses.data();
+
+        for (size_t base = begin; base < end; base += kLanes) {
+            const size_t lanes = std::min(kLanes, end - base);
+
+            // gather edges, center, mean velocity relative to the wind and coefficients of every triangle,
+            // padding the tail of the last group with degenerate triangles at rest.
+            alignas(32) float e1x[kLanes], e1y[kLanes], e1z[kLanes], e2x[kLanes], e2y[kLanes], e2z[kLanes];
+            alignas(32) float cx[kLanes], cy[kLanes], cz[kLanes], vx[kLanes], vy[kLanes], vz[kLanes];
+            alignas(32) float drag[kLanes], lift[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const size_t t = base + l;
+                    const int32_t a = _triangles[t * 3], b = _triangles[t * 3 + 1], c = _triangles[t * 3 + 2];
+                    const float4 e1 = positions[b] - positions[a];
+                    const float4 e2 = positions[c] - positions[a];
+                    const float4 center = (positions[a] + positions[b] + positions[c]) * (1.f / 3);
+                    const float4 v = (velocities[a] + velocities[b] + velocities[c] - wind[a] - wind[b] - wind[c]) *
+                                     (1.f / 3);
+                    e1x[l] = e1.x, e1y[l] = e1.y, e1z[l] = e1.z;
+                    e2x[l] = e2.x, e2y[l] = e2.y, e2z[l] = e2.z;
+                    cx[l] = center.x, cy[l] = center.y, cz[l] = center.z;
+                    vx[l] = v.x, vy[l] = v.y, vz[l] = v.z;
+                    drag[l] = _drag[t];
+                    lift[l] = _lift[t];
+                } else {
+                    e1x[l] = e1y[l] = e1z[l] = e2x[l] = e2y[l] = e2z[l] = 0;
+                    cx[l] = cy[l] = cz[l] = vx[l] = vy[l] = vz[l] = 0;
+                    drag[l] = lift[l] = 0;
+                }
+            }
+            if constexpr (Field) {
+                alignas(32) float wx[kLanes], wy[kLanes], wz[kLanes];
+                _windField->sample(cx, cy, cz, wx, wy, wz, kLanes);
+                for (size_t l = 0; l < kLanes; ++l) {
+                    vx[l] -= wx[l];
+                    vy[l] -= wy[l];
+                    vz[l] -= wz[l];
+                }
+            }
+
+            // with r the unit relative velocity and n the unit normal facing it, cos = n.r and
+            //   F = 1/2 |v|^2 area cos (-drag r + lift (r cos - n)),
+            // drag over the area seen by the air and lift across the flow, growing as sin 2 theta. Every
+            // particle of the triangle takes a third.
+            alignas(32) float fx[kLanes], fy[kLanes], fz[kLanes], relativeSpeed[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                float nx = e1y[l] * e2z[l] - e1z[l] * e2y[l];
+                float ny = e1z[l] * e2x[l] - e1x[l] * e2z[l];
+                float nz = e1x[l] * e2y[l] - e1y[l] * e2x[l];
+                const float doubleArea = std::sqrt(nx * nx + ny * ny + nz * nz);
+                const float speedSqr = vx[l] * vx[l] + vy[l] * vy[l] + vz[l] * vz[l];
+                const float speed = std::sqrt(speedSqr);
+                relativeSpeed[l] = speed;
+                const float invNormal = doubleArea > kEpsilon ? 1 / doubleArea : 0;
+                const float invSpeed = speed > kEpsilon ? 1 / speed : 0;
+                const float rx = vx[l] * invSpeed, ry = vy[l] * invSpeed, rz = vz[l] * invSpeed;
+                float cosine = (nx * rx + ny * ry + nz * rz) * invNormal;
+                const float side = cosine < 0 ? -invNormal : invNormal;
+                nx *= side, ny *= side, nz *= side;
+                cosine = std::fabs(cosine);
+                const float factor = 0.25f * speedSqr * doubleArea * cosine * (1.f / 3) * deltaTime;
+                fx[l] = factor * (-drag[l] * rx + lift[l] * (rx * cosine - nx));
+                fy[l] = factor * (-drag[l] * ry + lift[l] * (ry * cosine - ny));
+                fz[l] = factor * (-drag[l] * rz + lift[l] * (rz * cosine - nz));
+            }
+
+            // scatter, the triangles of a color share no particle. Light particles in fast flows would overshoot
+            // the wind within a substep, so no particle changes by more than the relative speed.
+            for (size_t l = 0; l < lanes; ++l) {
+                const float4 impulse(fx[l], fy[l], fz[l], 0);
+                const float magnitude = std::sqrt(fx[l] * fx[l] + fy[l] * fy[l] + fz[l] * fz[l]);
+                for (size_t k = 0; k < 3; ++k) {
+                    const int32_t p = _triangles[(base + l) * 3 + k];
+                    const float w = invMasses[p];
+                    velocities[p] += impulse * (magnitude * w > relativeSpeed[l] ? relativeSpeed[l] / magnitude : w);
+                }
+            }
+        }
+    }
+
+    void AerodynamicConstraintsBatch::particleForces(ParticleData &particles, size_t begin, size_t end,
+                                                     float deltaTime) const {
+        for (size_t k = begin; k < end; ++k) {
+            const int32_t c = _looseConstraints[k];
+            const int32_t p = _particleIndices[c];
+            float4 v = particles.velocities[p] - particles.wind[p];
+            if (_windField != nullptr) {
+                v -= float4(_windField->sample(particles.positions[p].xyz()), 0);
+            }
+            const float speedSqr = lengthSquared(v);
+            if (speedSqr > kEpsilon * kEpsilon && particles.invMasses[p] > 0) {
+                // drag only, along the relative velocity: -1/2 |v|^2 area drag r.
+                const float factor = 0.5f * std::sqrt(speedSqr) * _coefficients[c * 3] * _coefficients[c * 3 + 1];
+                particles.velocities[p] -= v * std::min(factor * particles.invMasses[p] * deltaTime, 1.f);
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,71 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+#include "../../solver/DeformableTriangles.h"
+#include "../../data-structures/wind-field/WindField.h"
+
+namespace vox::flex {
+    // Drag and lift of the air flowing past cloth, applied to velocities once per substep before positions
+    // are predicted. Forces are computed per deformable triangle whose three particles belong to the batch,
+    // from the triangle's area and normal and the velocity of its particles relative to the wind, and shared
+    // equally by its particles. The wind is the mean of the particles' wind plus, when the solver has one, the
+    // wind field sampled at the triangle's center.
+    //
+    // Triangles are kept in the solver's coloring so each batch of colors scatters straight to the velocities
+    // from every thread, kLanes triangles at a time. Particles of the batch in no triangle (ropes, or cloth
+    // without deformable triangles) only get drag along their relative velocity, scaled by their area
+    // coefficient.
+    class AerodynamicConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+
+        // One particle per constraint, `aerodynamicCoeffs` holds 3 floats per constraint: area, drag and lift
+        // coefficients, air density premultiplied.
+        void setAerodynamicConstraints(const int32_t *particleIndices, const float *aerodynamicCoeffs, size_t count);
+
+        // The solver's triangles and wind field (null when it has none), bound before every evaluation.
+        void bind(const DeformableTriangles *triangles, const WindField *windField);
+
+        size_t constraintCount() const override { return _particleIndices.size(); }
+
+        // Triangles the forces were computed on by the last evaluation.
+        size_t triangleCount() const { return _drag.size(); }
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &, const ConstraintParameters &, float) override {}
+
+    private:
+        void updateTriangles(size_t particleCount);
+
+        template <bool Field>
+        void triangleForces(ParticleData &particles, size_t begin, size_t end, float deltaTime) const;
+
+        void particleForces(ParticleData &particles, size_t begin, size_t end, float deltaTime) const;
+
+        AlignedVector<int32_t> _particleIndices;
+        AlignedVector<float> _coefficients;
+
+        const DeformableTriangles *_deformableTriangles = nullptr;
+        const WindField *_windField = nullptr;
+        uint64_t _trianglesVersion = 0;
+        bool _trianglesDirty = true;
+
+        // triangles of the batch in color order, with their mean drag and lift coefficients. Color i is
+        // [colorOffsets[i], colorOffsets[i + 1]), the last color may have to run sequentially.
+        AlignedVector<int32_t> _triangles;
+        AlignedVector<float> _drag;
+        AlignedVector<float> _lift;
+        std::vector<size_t> _colorOffsets;
+        bool _lastColorSequential = false;
+        // constraints whose particle is in no triangle.
+        AlignedVector<int32_t> _looseConstraints;
+    };
+} // namespace vox::flex
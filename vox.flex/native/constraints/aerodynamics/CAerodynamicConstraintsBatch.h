@@ -0,0 +1,25 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+
+/// Per-triangle drag and lift of cloth, see AerodynamicConstraintsBatch.
+@interface CAerodynamicConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// One particle per constraint, aerodynamicCoeffs holds 3 floats per constraint: area, drag and lift.
+- (void)setAerodynamicConstraints:(const int32_t *_Nonnull)particleIndices
+                aerodynamicCoeffs:(const float *_Nonnull)aerodynamicCoeffs
+                            count:(uint32_t)count;
+
+/// Deformable triangles of the solver whose particles all belong to the batch, as of the last substep.
+- (uint32_t)triangleCount;
+
+@end
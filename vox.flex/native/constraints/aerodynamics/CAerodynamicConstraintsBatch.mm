@@ -0,0 +1,38 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CAerodynamicConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "AerodynamicConstraintsBatch.h"
+
+using namespace vox::flex;
+
+@implementation CAerodynamicConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::Aerodynamics
+                           batch:std::make_unique<AerodynamicConstraintsBatch>()];
+}
+
+- (AerodynamicConstraintsBatch *)aerodynamicBatch {
+    return static_cast<AerodynamicConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setAerodynamicConstraints:(const int32_t *)particleIndices
+                aerodynamicCoeffs:(const float *)aerodynamicCoeffs
+                            count:(uint32_t)count {
+    if (auto *batch = [self aerodynamicBatch]) {
+        batch->setAerodynamicConstraints(particleIndices, aerodynamicCoeffs, count);
+    }
+}
+
+- (uint32_t)triangleCount {
+    auto *batch = [self aerodynamicBatch];
+    return batch != nullptr ? static_cast<uint32_t>(batch->triangleCount()) : 0;
+}
+
+@end
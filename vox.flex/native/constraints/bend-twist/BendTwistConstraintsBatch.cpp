@@ -0,0 +1,157 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "BendTwistConstraintsBatch.h"
+#include "../../common/Parallel.h"
+#include "../../common/QuaternionLanes.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kGroupGrain = 32;
+        constexpr float kEpsilon = 1e-7f;
+    } // namespace
+
+    void BendTwistConstraintsBatch::setBendTwistConstraints(const int32_t *orientationIndices,
+                                                            const quaternion *restDarboux, const float *stiffnesses,
+                                                            const float *plasticity, const float *lambdas,
+                                                            size_t count) {
+        _orientationIndices.assign(orientationIndices, orientationIndices + count * 2);
+        _restDarboux.assign(restDarboux, restDarboux + count);
+        _compliances.assign(stiffnesses, stiffnesses + count * 3);
+        _plasticity.assign(plasticity, plasticity + count * 2);
+        if (lambdas != nullptr) {
+            _lambdas.assign(lambdas, lambdas + count * 3);
+        } else {
+            _lambdas.assign(count * 3, 0.f);
+        }
+    }
+
+    void BendTwistConstraintsBatch::initialize(ParticleData &, float) {
+        std::fill(_lambdas.begin(), _lambdas.end(), 0.f);
+    }
+
+    void BendTwistConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &parameters, float,
+                                             float substepTime, int) {
+        const size_t count = constraintCount();
+        const size_t groupCount = (count + kLanes - 1) / kLanes;
+        const float deltaTimeSqr = substepTime * substepTime;
+        const bool inPlace = parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Sequential;
+        const float sorFactor = parameters.SORFactor;
+        parallelFor(0, groupCount, kGroupGrain, [&](size_t begin, size_t end) {
+            if (inPlace) {
+                project<true>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            } else {
+                project<false>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            }
+        });
+    }
+
+    void BendTwistConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters, float) {
+        if (parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Parallel) {
+            applyOrientationDeltas(particles, _orientationIndices.data(), _orientationIndices.size(),
+                                   parameters.SORFactor);
+        }
+    }
+
+    template <bool InPlace>
+    void BendTwistConstraintsBatch::project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr,
+                                            float sorFactor) {
+        const int32_t *indices = _orientationIndices.data();
+        quaternion *orientations = particles.orientations.data();
+        const float *invRotationalMasses = particles.invRotationalMasses.data();
+
+        for (size_t base = begin; base < end; base += kLanes) {
+            const size_t lanes = std::min(kLanes, end - base);
+
+            // gather, padding the tail of the last group with massless constraints at rest.
+            QuaternionLanes<kLanes> q1, q2, rest;
+            VectorLanes<kLanes> compliance, lambda;
+            alignas(32) float w1[kLanes], w2[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const size_t c = base + l;
+                    const int32_t o1 = indices[c * 2];
+                    const int32_t o2 = indices[c * 2 + 1];
+                    q1.set(l, orientations[o1]);
+                    q2.set(l, orientations[o2]);
+                    rest.set(l, _restDarboux[c]);
+                    compliance.set(l, float3(_compliances[c * 3], _compliances[c * 3 + 1], _compliances[c * 3 + 2]));
+                    lambda.set(l, float3(_lambdas[c * 3], _lambdas[c * 3 + 1], _lambdas[c * 3 + 2]));
+                    w1[l] = invRotationalMasses[o1];
+                    w2[l] = invRotationalMasses[o2];
+                } else {
+                    q1.set(l, quaternion());
+                    q2.set(l, quaternion());
+                    rest.set(l, quaternion());
+                    compliance.set(l, float3());
+                    lambda.set(l, float3());
+                    w1[l] = w2[l] = 0;
+                }
+            }
+
+            // Darboux vector, against whichever of +-rest is closest: both are the same rotation.
+            QuaternionLanes<kLanes> darboux;
+            multiply<true>(q1, q2, darboux);
+            VectorLanes<kLanes> dlambda;
+            alignas(32) float sign[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                const float dot = darboux.x[l] * rest.x[l] + darboux.y[l] * rest.y[l] + darboux.z[l] * rest.z[l] +
+                                  darboux.w[l] * rest.w[l];
+                sign[l] = dot < 0 ? -1.f : 1.f;
+                const float cx = darboux.x[l] - rest.x[l] * sign[l];
+                const float cy = darboux.y[l] - rest.y[l] * sign[l];
+                const float cz = darboux.z[l] - rest.z[l] * sign[l];
+
+                // dlambda = (-C - alpha * lambda) / (w1 + w2 + alpha)
+                const float w = w1[l] + w2[l] + kEpsilon;
+                const float ax = compliance.x[l] / deltaTimeSqr;
+                const float ay = compliance.y[l] / deltaTimeSqr;
+                const float az = compliance.z[l] / deltaTimeSqr;
+                dlambda.x[l] = (-cx - ax * lambda.x[l]) / (w + ax);
+                dlambda.y[l] = (-cy - ay * lambda.y[l]) / (w + ay);
+                dlambda.z[l] = (-cz - az * lambda.z[l]) / (w + az);
+            }
+
+            // q1 -= w1 q2 (dlambda, 0), q2 += w2 q1 (dlambda, 0).
+            QuaternionLanes<kLanes> delta1, delta2;
+            multiply(q2, dlambda, delta1);
+            multiply(q1, dlambda, delta2);
+
+            // scatter.
+            for (size_t l = 0; l < lanes; ++l) {
+                const size_t c = base + l;
+                const int32_t o1 = indices[c * 2];
+                const int32_t o2 = indices[c * 2 + 1];
+                _lambdas[c * 3] += dlambda.x[l];
+                _lambdas[c * 3 + 1] += dlambda.y[l];
+                _lambdas[c * 3 + 2] += dlambda.z[l];
+
+                // plastic flow of the rest shape, using the Darboux vector before correction.
+                const float yield = _plasticity[c * 2], creep = _plasticity[c * 2 + 1];
+                if (creep > 0) {
+                    const quaternion current = darboux.get(l);
+                    const quaternion restValue = rest.get(l) * sign[l];
+                    const float3 bend = current.xyz() - restValue.xyz();
+                    if (lengthSquared(bend) > yield * yield) {
+                        _restDarboux[c] = normalize(restValue + (current + restValue * -1.f) * creep);
+                    }
+                }
+
+                if constexpr (InPlace) {
+                    orientations[o1] = normalize(orientations[o1] + delta1.get(l) * (-w1[l] * sorFactor));
+                    orientations[o2] = normalize(orientations[o2] + delta2.get(l) * (w2[l] * sorFactor));
+                } else {
+                    particles.orientationDeltas[o1] = particles.orientationDeltas[o1] + delta1.get(l) * -w1[l];
+                    particles.orientationDeltas[o2] = particles.orientationDeltas[o2] + delta2.get(l) * w2[l];
+                    ++particles.orientationConstraintCounts[o1];
+                    ++particles.orientationConstraintCounts[o2];
+                }
+            }
+        }
+    }
+} // namespace vox::flex
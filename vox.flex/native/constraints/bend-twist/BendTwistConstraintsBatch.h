@@ -0,0 +1,52 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+
+namespace vox::flex {
+    // XPBD bend / twist constraints of Cosserat rods (Kugelstadt and Schömer 2016): each keeps the Darboux
+    // vector between two consecutive material frames, conjugate(q1) * q2, at its rest value. Compliances apply
+    // to bending around the first two axes and twisting around the third. Plastic constraints move their rest
+    // Darboux vector towards the current one by `creep` once they bend further than `yield`.
+    //
+    // Projected kLanes at a time with lane-wise quaternion products, in place or accumulated like the other
+    // Cosserat batch, see StretchShearConstraintsBatch.
+    class BendTwistConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+
+        // Two orientations per constraint. `stiffnesses` are 3 compliances and `plasticity` (yield, creep)
+        // pairs per constraint. Lambdas (3 per constraint) may be null.
+        void setBendTwistConstraints(const int32_t *orientationIndices, const quaternion *restDarboux,
+                                     const float *stiffnesses, const float *plasticity, const float *lambdas,
+                                     size_t count);
+
+        size_t constraintCount() const override { return _restDarboux.size(); }
+
+        const AlignedVector<float> &lambdas() const { return _lambdas; }
+
+        const AlignedVector<quaternion> &restDarboux() const { return _restDarboux; }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        template <bool InPlace>
+        void project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr, float sorFactor);
+
+        AlignedVector<int32_t> _orientationIndices;
+        AlignedVector<quaternion> _restDarboux;
+        AlignedVector<float> _compliances;
+        AlignedVector<float> _plasticity;
+        AlignedVector<float> _lambdas;
+    };
+} // namespace vox::flex
@@ -0,0 +1,34 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// XPBD bend / twist constraints of Cosserat rods, see BendTwistConstraintsBatch.
+@interface CBendTwistConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// Two orientation indices per constraint. Stiffnesses are three compliances per constraint, bending around the
+/// first two material axes and twisting around the third; plasticity holds (yield, creep) pairs. Lambdas (three per
+/// constraint) may be null.
+- (void)setBendTwistConstraints:(const int32_t *_Nonnull)orientationIndices
+                    restDarboux:(const simd_quatf *_Nonnull)restDarboux
+                    stiffnesses:(const float *_Nonnull)stiffnesses
+                     plasticity:(const simd_float2 *_Nonnull)plasticity
+                        lambdas:(const float *_Nullable)lambdas
+                          count:(uint32_t)count;
+
+/// Accumulated XPBD multipliers of the current substep, three per constraint.
+- (void)getLambdas:(float *_Nonnull)lambdas;
+
+/// Rest Darboux vectors, moved by plastic flow, one per constraint.
+- (void)getRestDarboux:(simd_quatf *_Nonnull)restDarboux;
+
+@end
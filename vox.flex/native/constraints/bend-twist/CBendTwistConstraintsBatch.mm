@@ -0,0 +1,53 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CBendTwistConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "BendTwistConstraintsBatch.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+static_assert(sizeof(quaternion) == sizeof(simd_quatf), "quaternion must match simd_quatf layout");
+
+@implementation CBendTwistConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::BendTwist
+                           batch:std::make_unique<BendTwistConstraintsBatch>()];
+}
+
+- (BendTwistConstraintsBatch *)bendTwistBatch {
+    return static_cast<BendTwistConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setBendTwistConstraints:(const int32_t *)orientationIndices
+                    restDarboux:(const simd_quatf *)restDarboux
+                    stiffnesses:(const float *)stiffnesses
+                     plasticity:(const simd_float2 *)plasticity
+                        lambdas:(const float *)lambdas
+                          count:(uint32_t)count {
+    if (auto *batch = [self bendTwistBatch]) {
+        batch->setBendTwistConstraints(orientationIndices, reinterpret_cast<const quaternion *>(restDarboux),
+                                       stiffnesses, reinterpret_cast<const float *>(plasticity), lambdas, count);
+    }
+}
+
+- (void)getLambdas:(float *)lambdas {
+    if (auto *batch = [self bendTwistBatch]) {
+        std::copy(batch->lambdas().begin(), batch->lambdas().end(), lambdas);
+    }
+}
+
+- (void)getRestDarboux:(simd_quatf *)restDarboux {
+    if (auto *batch = [self bendTwistBatch]) {
+        std::copy(batch->restDarboux().begin(), batch->restDarboux().end(),
+                  reinterpret_cast<quaternion *>(restDarboux));
+    }
+}
+
+@end
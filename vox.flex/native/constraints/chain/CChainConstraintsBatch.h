@@ -0,0 +1,26 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// Chains solved directly with a tridiagonal solve, see ChainConstraintsBatch.
+@interface CChainConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// Chain i links particleIndices[firstIndex[i] ..< firstIndex[i] + numIndices[i]] in order; restLengths holds the
+/// (min, max) length of the links of every chain.
+- (void)setChainConstraints:(const int32_t *_Nonnull)particleIndices
+                restLengths:(const simd_float2 *_Nonnull)restLengths
+                 firstIndex:(const int32_t *_Nonnull)firstIndex
+                 numIndices:(const int32_t *_Nonnull)numIndices
+                      count:(uint32_t)count;
+
+@end
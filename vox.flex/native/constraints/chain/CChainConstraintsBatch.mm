@@ -0,0 +1,36 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CChainConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "ChainConstraintsBatch.h"
+
+using namespace vox::flex;
+
+@implementation CChainConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::Chain
+                           batch:std::make_unique<ChainConstraintsBatch>()];
+}
+
+- (ChainConstraintsBatch *)chainBatch {
+    return static_cast<ChainConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setChainConstraints:(const int32_t *)particleIndices
+                restLengths:(const simd_float2 *)restLengths
+                 firstIndex:(const int32_t *)firstIndex
+                 numIndices:(const int32_t *)numIndices
+                      count:(uint32_t)count {
+    if (auto *batch = [self chainBatch]) {
+        batch->setChainConstraints(particleIndices, reinterpret_cast<const float *>(restLengths), firstIndex,
+                                   numIndices, count);
+    }
+}
+
+@end
@@ -0,0 +1,205 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ChainConstraintsBatch.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr float kEpsilon = 1e-7f;
+        // most linearized solves per evaluation, stopping once the chain is within tolerance of its lengths.
+        constexpr int kNewtonSteps = 16;
+        // relative to the minimum link length.
+        constexpr float kNewtonTolerance = 1e-4f;
+    } // namespace
+
+    void ChainConstraintsBatch::setChainConstraints(const int32_t *particleIndices, const float *restLengths,
+                                                    const int32_t *firstIndex, const int32_t *numIndices,
+                                                    size_t count) {
+        _firstIndex.assign(firstIndex, firstIndex + count);
+        _numIndices.assign(numIndices, numIndices + count);
+        _restLengths.assign(restLengths, restLengths + count * 2);
+        size_t indexCount = 0;
+        _maxLinks = 0;
+        for (size_t i = 0; i < count; ++i) {
+            indexCount = std::max(indexCount, size_t(firstIndex[i] + numIndices[i]));
+            _maxLinks = std::max(_maxLinks, size_t(std::max(numIndices[i] - 1, 0)));
+        }
+        _particleIndices.assign(particleIndices, particleIndices + indexCount);
+        _tensions.assign(indexCount, 0.f);
+        _scratch.assign(std::min(count, ThreadPool::shared().concurrency() * 4), Scratch(_maxLinks));
+        _hasTensions = false;
+    }
+
+    void ChainConstraintsBatch::initialize(ParticleData &, float) {
+        std::fill(_tensions.begin(), _tensions.end(), 0.f);
+        _hasTensions = false;
+    }
+
+    void ChainConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &parameters, float,
+                                         float, int) {
+        const bool inPlace = parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Sequential;
+        const float sorFactor = parameters.SORFactor;
+        const size_t count = constraintCount();
+        const size_t sliceCount = _scratch.size();
+        if (sliceCount == 0) {
+            return;
+        }
+        // contiguous slices of chains, each solved with its own scratch.
+        const size_t sliceSize = (count + sliceCount - 1) / sliceCount;
+        const bool estimateTensions = !_hasTensions;
+        parallelForEach(sliceCount, 1, [&](size_t slice) {
+            Scratch &scratch = _scratch[slice];
+            for (size_t chain = slice * sliceSize, end = std::min(count, chain + sliceSize); chain < end; ++chain) {
+                if (inPlace) {
+                    solveChain<true>(particles, chain, scratch, sorFactor, estimateTensions);
+                } else {
+                    solveChain<false>(particles, chain, scratch, sorFactor, estimateTensions);
+                }
+            }
+        });
+        _hasTensions = true;
+    }
+
+    void ChainConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters, float) {
+        if (parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Parallel) {
+            applyPositionDeltas(particles, _particleIndices.data(), _particleIndices.size(), parameters.SORFactor);
+        }
+    }
+
+    template <bool InPlace>
+    void ChainConstraintsBatch::solveChain(ParticleData &particles, size_t chain, Scratch &scratch, float sorFactor,
+                                           bool estimateTensions) {
+        const int32_t *indices = _particleIndices.data() + _firstIndex[chain];
+        const int links = _numIndices[chain] - 1;
+        if (links <= 0) {
+            return;
+        }
+        float4 *positions = particles.positions.data();
+        const float *invMasses = particles.invMasses.data();
+        const float minLength = _restLengths[chain * 2];
+        const float maxLength = _restLengths[chain * 2 + 1];
+        const float tolerance = kNewtonTolerance * std::max(minLength, kEpsilon);
+        float *tensions = _tensions.data() + _firstIndex[chain];
+        float3 *points = scratch.points.data();
+        float3 *normals = scratch.normals.data();
+        float3x3 *weights = scratch.weights.data();
+        float *lengths = scratch.lengths.data();
+        float *violations = scratch.violations.data();
+        float *diagonal = scratch.diagonal.data();
+        float *upper = scratch.upper.data();
+        float *rhs = scratch.rhs.data();
+        float *lambdas = scratch.lambdas.data();
+
+        for (int j = 0; j <= links; ++j) {
+            points[j] = positions[indices[j]].xyz();
+        }
+        std::fill(lambdas, lambdas + links, 0.f);
+
+        // Newton steps: the system is linearized at the chain's current shape, so a single solve leaves errors
+        // growing with the rotation of the links it corrects, which at large time steps feed on themselves.
+        // Solving again from the corrected shape converges to the projection: in one or two steps for a hanging
+        // chain, in up to kNewtonSteps for a long chain swinging at a single substep.
+        for (int step = 0; step < kNewtonSteps; ++step) {
+            // directions and violations. Links within range, or between two static particles, get an identity
+            // row with a zero right hand side and are decoupled from their neighbours.
+            float maxViolation = 0;
+            for (int i = 0; i < links; ++i) {
+                const float3 d = points[i + 1] - points[i];
+                const float len = length(d);
+                const float violation = len - std::clamp(len, minLength, maxLength);
+                normals[i] = len > kEpsilon && violation != 0 ? d * (1.f / len) : float3();
+                lengths[i] = len;
+                violations[i] = violation;
+                maxViolation = std::max(maxViolation, std::abs(violation));
+            }
+            if (step > 0 && maxViolation <= tolerance) {
+                break;
+            }
+
+            // the first iteration of a substep has no tensions yet: a first pass without stiffening estimates
+            // them.
+            for (int pass = estimateTensions && step == 0 ? 0 : 1; pass < 2; ++pass) {
+                // inverse masses stiffened across the adjacent links by their geometric stiffness, lumped to
+                // 2 lambda / length (I - n n^T) per end (Tournier et al. 2015, Andrews et al. 2017). A correction
+                // along a link moves its ends sideways by the link's tension over its length times their offset,
+                // which overshoots and grows once the tension of a long chain exceeds a few link lengths. Along the
+                // links the masses are unchanged, so the solve still meets the constraints.
+                for (int j = 0; j <= links; ++j) {
+                    const float w = invMasses[indices[j]];
+                    if (w <= 0) {
+                        weights[j] = float3x3(0);
+                        continue;
+                    }
+                    float3x3 mass(1 / w);
+                    for (int i = std::max(j - 1, 0); i <= std::min(j, links - 1); ++i) {
+                        mass = mass + (float3x3(1) - outerProduct(normals[i], normals[i])) * (2 * tensions[i]);
+                    }
+                    weights[j] = inverse(mass);
+                }
+
+                for (int i = 0; i < links; ++i) {
+                    const float a = dot(normals[i], (weights[i] + weights[i + 1]) * normals[i]);
+                    const bool active = a > kEpsilon;
+                    diagonal[i] = active ? a : 1;
+                    rhs[i] = active ? -violations[i] : 0;
+                }
+
+                // Thomas algorithm on the symmetric system, overwriting upper with c' and rhs with d', then
+                // lambda. Links i and i + 1 are coupled through the particle they share by -n_i W_{i+1} n_{i+1}.
+                for (int i = 0; i < links; ++i) {
+                    float m = diagonal[i];
+                    if (i > 0) {
+                        const float lower = -dot(normals[i - 1], weights[i] * normals[i]);
+                        m -= lower * upper[i - 1];
+                        rhs[i] -= lower * rhs[i - 1];
+                    }
+                    const float inv = std::abs(m) > kEpsilon ? 1.f / m : 0.f;
+                    upper[i] = i + 1 < links ? -dot(normals[i], weights[i + 1] * normals[i + 1]) * inv : 0;
+                    rhs[i] *= inv;
+                }
+                for (int i = links - 2; i >= 0; --i) {
+                    rhs[i] -= upper[i] * rhs[i + 1];
+                }
+
+                // tensions for the stiffness of the next pass, step or iteration, from the lambdas so far.
+                for (int i = 0; i < links; ++i) {
+                    const float lambda = pass == 0 ? rhs[i] : lambdas[i] + rhs[i];
+                    tensions[i] = lengths[i] > kEpsilon ? std::abs(lambda) / lengths[i] : 0;
+                }
+            }
+
+            // dp_j = W_j (n_{j-1} lambda_{j-1} - n_j lambda_j).
+            for (int j = 0; j <= links; ++j) {
+                float3 delta;
+                if (j > 0) {
+                    delta = delta + normals[j - 1] * rhs[j - 1];
+                }
+                if (j < links) {
+                    delta = delta - normals[j] * rhs[j];
+                }
+                points[j] = points[j] + weights[j] * delta;
+            }
+            for (int i = 0; i < links; ++i) {
+                lambdas[i] += rhs[i];
+            }
+        }
+
+        for (int j = 0; j <= links; ++j) {
+            const int32_t p = indices[j];
+            const float4 d(points[j] - positions[p].xyz(), 0);
+            if constexpr (InPlace) {
+                positions[p] += d * sorFactor;
+            } else {
+                particles.positionDeltas[p] += d;
+                ++particles.positionConstraintCounts[p];
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,69 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+
+#include <vector>
+
+namespace vox::flex {
+    // Inextensible chains solved directly rather than iteratively: the links of a chain form a tridiagonal
+    // system J W J^T lambda = -C, coupling every link to its neighbours through the particle they share, which
+    // the Thomas algorithm solves in O(links). One evaluation thus corrects the whole chain at once, instead of
+    // needing as many Gauss-Seidel iterations as it has links for a correction to travel along it.
+    //
+    // Links keep their length within the chain's [min, max] range: links inside it are inactive, their rows
+    // decoupled from the system. The masses of the system are stiffened sideways by the tension of the links
+    // they hang from, which keeps long heavy chains from buckling into a zigzag under the direct solve, and the
+    // linearized solve is repeated from the corrected shape until the links meet their lengths, which keeps it
+    // stable at one or two substeps.
+    // Chains of a batch share no particle and are solved in parallel.
+    class ChainConstraintsBatch : public ConstraintsBatch {
+    public:
+        // Chain i links particleIndices[firstIndex[i] ..< firstIndex[i] + numIndices[i]] in order.
+        // `restLengths` holds the (min, max) length of the links of every chain.
+        void setChainConstraints(const int32_t *particleIndices, const float *restLengths,
+                                 const int32_t *firstIndex, const int32_t *numIndices, size_t count);
+
+        size_t constraintCount() const override { return _numIndices.size(); }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        // buffers of the tridiagonal solve, sized for the longest chain.
+        struct Scratch {
+            std::vector<float3> points, normals;
+            std::vector<float3x3> weights;
+            std::vector<float> lengths, violations, diagonal, upper, rhs, lambdas;
+
+            explicit Scratch(size_t links)
+                : points(links + 1), normals(links), weights(links + 1), lengths(links), violations(links),
+                  diagonal(links), upper(links), rhs(links), lambdas(links) {}
+        };
+
+        template <bool InPlace>
+        void solveChain(ParticleData &particles, size_t chain, Scratch &scratch, float sorFactor,
+                        bool estimateTensions);
+
+        AlignedVector<int32_t> _particleIndices;
+        AlignedVector<int32_t> _firstIndex;
+        AlignedVector<int32_t> _numIndices;
+        AlignedVector<float> _restLengths;
+        // |lambda| / length of every link in the last iteration of the substep, per index like the particles.
+        AlignedVector<float> _tensions;
+        // false until the first iteration of the substep solved the chains.
+        bool _hasTensions = false;
+        size_t _maxLinks = 0;
+        // one per slice of chains solved in parallel, sized once the chains are set.
+        std::vector<Scratch> _scratch;
+    };
+} // namespace vox::flex
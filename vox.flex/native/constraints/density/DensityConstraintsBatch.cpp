@@ -0,0 +1,364 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "DensityConstraintsBatch.h"
+#include "FluidKernels.h"
+#include "../../common/Parallel.h"
+
+#include <cmath>
+#include <limits>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 512;
+        constexpr float kEpsilon = 1e-6f;
+
+        struct InteractionProvider {
+            const FluidInteraction *interactions;
+            size_t count;
+
+            size_t constraintCount() const { return count; }
+
+            uint32_t particleCount(size_t) const { return 2; }
+
+            int32_t particle(size_t constraint, uint32_t index) const {
+                return index == 0 ? interactions[constraint].particleA : interactions[constraint].particleB;
+            }
+        };
+
+        // Eigen decomposition of a symmetric 3x3 matrix by cyclic Jacobi rotations, eigenvectors in the columns
+        // of `vectors`.
+        void symmetricEigen(float a[3][3], float values[3], float vectors[3][3]) {
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    vectors[i][j] = i == j ? 1.f : 0.f;
+                }
+            }
+            const float scale = std::fabs(a[0][0]) + std::fabs(a[1][1]) + std::fabs(a[2][2]);
+            for (int sweep = 0; sweep < 8; ++sweep) {
+                const float off = std::fabs(a[0][1]) + std::fabs(a[0][2]) + std::fabs(a[1][2]);
+                if (off <= 1e-6f * scale) {
+                    break;
+                }
+                for (int p = 0; p < 2; ++p) {
+                    for (int q = p + 1; q < 3; ++q) {
+                        if (a[p][q] == 0) {
+                            continue;
+                        }
+                        const float theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                        const float t = std::copysign(1.f, theta) / (std::fabs(theta) + std::sqrt(theta * theta + 1));
+                        const float c = 1 / std::sqrt(t * t + 1);
+                        const float s = t * c;
+                        for (int k = 0; k < 3; ++k) {
+                            const float akp = a[k][p], akq = a[k][q];
+                            a[k][p] = c * akp - s * akq;
+                            a[k][q] = s * akp + c * akq;
+                        }
+                        for (int k = 0; k < 3; ++k) {
+                            const float apk = a[p][k], aqk = a[q][k];
+                            a[p][k] = c * apk - s * aqk;
+                            a[q][k] = s * apk + c * aqk;
+                        }
+                        for (int k = 0; k < 3; ++k) {
+                            const float vkp = vectors[k][p], vkq = vectors[k][q];
+                            vectors[k][p] = c * vkp - s * vkq;
+                            vectors[k][q] = s * vkp + c * vkq;
+                        }
+                    }
+                }
+            }
+            for (int i = 0; i < 3; ++i) {
+                values[i] = a[i][i];
+            }
+        }
+    } // namespace
+
+    void DensityConstraintsBatch::setInteractions(const std::vector<FluidInteraction> &interactions,
+                                                  const int32_t *fluidParticles, size_t fluidCount,
+                                                  size_t particleCount) {
+        _fluidParticles.assign(fluidParticles, fluidParticles + fluidCount);
+        _batcher.batchConstraints(InteractionProvider{interactions.data(), interactions.size()}, particleCount,
+                                  sizeof(FluidInteraction), _sortedIndices, _batchData, kColoringRounds);
+        _interactions.resize(interactions.size());
+        ConstraintBatcher::reorder(interactions.data(), _interactions.data(), _sortedIndices);
+
+        for (auto *array : {&_fluidProperties, &_gradients, &_velocityDeltas, &_eta, &_fluidNormals, &_userDataDeltas,
+                            &_smoothPositions, &_covariancesDiagonal, &_covariancesOffDiagonal}) {
+            array->resize(particleCount);
+        }
+    }
+
+    template <typename Function>
+    void DensityConstraintsBatch::forEachInteraction(Function &&function) {
+        for (const BatchData &batch : _batchData) {
+            parallelForEach(batch.workItemCount, 1, [&](size_t workItem) {
+                uint32_t begin, end;
+                batch.getConstraintRange(uint32_t(workItem), begin, end);
+                for (uint32_t c = begin; c < end; ++c) {
+                    function(_interactions[c]);
+                }
+            });
+        }
+    }
+
+    template <typename Function>
+    void DensityConstraintsBatch::forEachFluidParticle(Function &&function) {
+        parallelFor(0, _fluidParticles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                function(_fluidParticles[k]);
+            }
+        });
+    }
+
+    // static particles weigh as much as their volume of fluid at rest.
+    float DensityConstraintsBatch::mass(const ParticleData &particles, int32_t i) const {
+        if (particles.invMasses[i] > 0) {
+            return 1 / particles.invMasses[i];
+        }
+        const float diameter = particles.principalRadii[i].x * 2;
+        return particles.restDensities[i] * diameter * diameter * (_mode2D ? 1 : diameter);
+    }
+
+    void DensityConstraintsBatch::updateFluidProperties(const ParticleData &particles) {
+        const Poly6Kernel densityKernel(_mode2D);
+        const SpikyKernel gradientKernel(_mode2D);
+        forEachFluidParticle([&](int32_t i) {
+            const float h = particles.smoothingRadii[i];
+            _fluidProperties[i] = float4(mass(particles, i), h, densityKernel.scale(h), gradientKernel.scale(h));
+        });
+    }
+
+    // MARK: - Density constraints
+    void DensityConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &, float, float,
+                                           int) {
+        const Poly6Kernel densityKernel(_mode2D);
+        const SpikyKernel gradientKernel(_mode2D);
+        ParticleData &p = particles;
+        updateFluidProperties(p);
+
+        // every particle is its own neighbor for density.
+        forEachFluidParticle([&](int32_t i) {
+            const float4 &properties = _fluidProperties[i];
+            p.fluidData[i].x = properties.x * densityKernel(0, properties.y, properties.z);
+            _gradients[i] = float4();
+        });
+
+        // _gradients: xyz the gradient of the density constraint with respect to the particle itself, w the
+        // inverse mass weighted squared gradients with respect to its neighbors, both times the rest density.
+        forEachInteraction([&](FluidInteraction &pair) {
+            const int32_t a = pair.particleA, b = pair.particleB;
+            float3 d = p.positions[a].xyz() - p.positions[b].xyz();
+            if (_mode2D) {
+                d.z = 0;
+            }
+            const float distance = length(d);
+            const float4 &propertiesA = _fluidProperties[a], &propertiesB = _fluidProperties[b];
+            pair.gradient = float4(d / (distance + std::numeric_limits<float>::min()), 0);
+            pair.avgKernel = (densityKernel(distance, propertiesA.y, propertiesA.z) +
+                              densityKernel(distance, propertiesB.y, propertiesB.z)) * 0.5f;
+            pair.avgGradient = (gradientKernel(distance, propertiesA.y, propertiesA.w) +
+                                gradientKernel(distance, propertiesB.y, propertiesB.w)) * 0.5f;
+
+            const float massA = propertiesA.x, massB = propertiesB.x;
+            const float4 gradient = pair.gradient * pair.avgGradient;
+            const float gradientSq = lengthSquared(gradient);
+            p.fluidData[a].x += massB * pair.avgKernel;
+            p.fluidData[b].x += massA * pair.avgKernel;
+            _gradients[a] += float4(gradient.xyz() * massB, p.invMasses[b] * massB * massB * gradientSq);
+            _gradients[b] += float4(gradient.xyz() * -massA, p.invMasses[a] * massA * massA * gradientSq);
+        });
+
+        // C = density / restDensity - 1, only ever pushing particles apart.
+        forEachFluidParticle([&](int32_t i) {
+            const float restDensity = p.restDensities[i];
+            const float constraint = std::max(p.fluidData[i].x / restDensity - 1, 0.f);
+            const float denominator =
+                (p.invMasses[i] * lengthSquared(_gradients[i].xyz()) + _gradients[i].w) / (restDensity * restDensity);
+            p.fluidData[i].y = -constraint / (denominator + kEpsilon);
+        });
+
+        forEachInteraction([&](const FluidInteraction &pair) {
+            const int32_t a = pair.particleA, b = pair.particleB;
+            const float s = p.fluidData[a].y * _fluidProperties[b].x / p.restDensities[a] +
+                            p.fluidData[b].y * _fluidProperties[a].x / p.restDensities[b];
+            const float4 delta = pair.gradient * (pair.avgGradient * s);
+            p.positionDeltas[a] += delta * p.invMasses[a];
+            p.positionDeltas[b] -= delta * p.invMasses[b];
+        });
+    }
+
+    void DensityConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters, float) {
+        const float sorFactor = parameters.SORFactor;
+        forEachFluidParticle([&](int32_t i) {
+            particles.positions[i] += particles.positionDeltas[i] * sorFactor;
+            particles.positionDeltas[i] = float4();
+        });
+    }
+
+    // MARK: - Velocity corrections
+    void DensityConstraintsBatch::applyVelocityCorrections(ParticleData &particles, float substepTime) {
+        ParticleData &p = particles;
+        const CohesionKernel cohesionKernel(_mode2D);
+        auto volume = [&](int32_t i) {
+            return p.fluidData[i].x > 0 ? _fluidProperties[i].x / p.fluidData[i].x : 0.f;
+        };
+
+        forEachFluidParticle([&](int32_t i) {
+            _velocityDeltas[i] = float4();
+            _eta[i] = float4();
+            _fluidNormals[i] = float4();
+            _userDataDeltas[i] = float4();
+            p.vorticities[i] = float4();
+        });
+
+        // XSPH viscosity, vorticity, normals and user data differences, from the kernel terms of the last iteration.
+        forEachInteraction([&](const FluidInteraction &pair) {
+            const int32_t a = pair.particleA, b = pair.particleB;
+            const float volumeA = volume(a), volumeB = volume(b);
+            const float3 relative = p.velocities[b].xyz() - p.velocities[a].xyz();
+            const float viscosity = (p.viscosities[a] + p.viscosities[b]) * 0.5f * pair.avgKernel;
+            _velocityDeltas[a] += float4(relative * (viscosity * volumeB), 0);
+            _velocityDeltas[b] -= float4(relative * (viscosity * volumeA), 0);
+
+            const float4 gradient = pair.gradient * pair.avgGradient;
+            const float3 vorticity = cross(relative, gradient.xyz());
+            p.vorticities[a] += float4(vorticity * volumeB, 0);
+            p.vorticities[b] += float4(vorticity * volumeA, 0);
+
+            _fluidNormals[a] += gradient * (volumeB * p.smoothingRadii[a]);
+            _fluidNormals[b] -= gradient * (volumeA * p.smoothingRadii[b]);
+
+            const float4 userDelta = (p.userData[b] - p.userData[a]) * pair.avgKernel;
+            _userDataDeltas[a] += userDelta * volumeB;
+            _userDataDeltas[b] -= userDelta * volumeA;
+        });
+
+        // eta: gradient of the vorticity magnitude, its direction points towards the vortex center. Surface
+        // tension needs every normal, so it is accumulated here too.
+        forEachInteraction([&](const FluidInteraction &pair) {
+            const int32_t a = pair.particleA, b = pair.particleB;
+            const float4 gradient = pair.gradient * pair.avgGradient;
+            _eta[a] += gradient * (volume(b) * length(p.vorticities[b]));
+            _eta[b] -= gradient * (volume(a) * length(p.vorticities[a]));
+
+            const float tension = (p.surfaceTension[a] + p.surfaceTension[b]) * 0.5f;
+            const float densitySum = p.fluidData[a].x + p.fluidData[b].x;
+            if (tension <= 0 || densitySum <= 0) {
+                return;
+            }
+            // corrects the particle deficiency at the surface.
+            const float k = (p.restDensities[a] + p.restDensities[b]) / densitySum;
+            const float massA = _fluidProperties[a].x, massB = _fluidProperties[b].x;
+            const float distance = length(p.positions[a].xyz() - p.positions[b].xyz());
+            const float h = (p.smoothingRadii[a] + p.smoothingRadii[b]) * 0.5f;
+            const float4 cohesion = pair.gradient * (massA * massB * cohesionKernel(distance, h));
+            const float4 curvature = _fluidNormals[a] - _fluidNormals[b];
+            const float4 force = (cohesion + curvature * ((massA + massB) * 0.5f)) * (-tension * k * substepTime);
+            _velocityDeltas[a] += force * p.invMasses[a];
+            _velocityDeltas[b] -= force * p.invMasses[b];
+        });
+
+        forEachFluidParticle([&](int32_t i) {
+            p.userData[i] += _userDataDeltas[i] * std::min(p.diffusion[i] * substepTime, 1.f);
+            if (p.invMasses[i] <= 0) {
+                return;
+            }
+            p.velocities[i] += _velocityDeltas[i];
+
+            // the emptier a particle's neighborhood, the more of its surface is exposed to the air.
+            const float air = std::max(1 - p.fluidData[i].x / p.restDensities[i], 0.f);
+            if (air > 0) {
+                const float drag = std::min(p.atmosphericDrag[i] * air * substepTime, 1.f);
+                p.velocities[i] -= float4((p.velocities[i] - p.wind[i]).xyz() * drag, 0);
+                p.velocities[i] += float4(_fluidNormals[i].xyz() * (p.atmosphericPressure[i] * air * substepTime), 0);
+            }
+
+            const float etaLength = length(_eta[i]);
+            if (p.vortConfinement[i] > 0 && etaLength > kEpsilon) {
+                const float3 n = _eta[i].xyz() / etaLength;
+                p.velocities[i] += float4(cross(n, p.vorticities[i].xyz()) * (p.vortConfinement[i] * substepTime), 0);
+            }
+        });
+    }
+
+    // MARK: - Anisotropy
+    void DensityConstraintsBatch::calculateAnisotropyLaplacianSmoothing(ParticleData &particles, float maxAnisotropy) {
+        ParticleData &p = particles;
+        maxAnisotropy = std::max(maxAnisotropy, 1.f);
+        auto weight = [](float distance, float h) {
+            const float x = std::min(distance / h, 1.f);
+            return 1 - x * x * x;
+        };
+
+        // weighted mean of the neighbors, sum of weights in w.
+        forEachFluidParticle([&](int32_t i) {
+            _smoothPositions[i] = float4();
+            _covariancesDiagonal[i] = float4();
+            _covariancesOffDiagonal[i] = float4();
+        });
+        forEachInteraction([&](const FluidInteraction &pair) {
+            const int32_t a = pair.particleA, b = pair.particleB;
+            const float distance = length(p.renderablePositions[a].xyz() - p.renderablePositions[b].xyz());
+            const float weightA = weight(distance, p.smoothingRadii[a]);
+            const float weightB = weight(distance, p.smoothingRadii[b]);
+            _smoothPositions[a] += float4(p.renderablePositions[b].xyz() * weightA, weightA);
+            _smoothPositions[b] += float4(p.renderablePositions[a].xyz() * weightB, weightB);
+        });
+        forEachFluidParticle([&](int32_t i) {
+            if (_smoothPositions[i].w > 0) {
+                _smoothPositions[i] = float4(_smoothPositions[i].xyz() / _smoothPositions[i].w, _smoothPositions[i].w);
+            }
+        });
+
+        // weighted covariance around that mean, neighbor count in the w of the off-diagonal terms.
+        forEachInteraction([&](const FluidInteraction &pair) {
+            const int32_t a = pair.particleA, b = pair.particleB;
+            const float distance = length(p.renderablePositions[a].xyz() - p.renderablePositions[b].xyz());
+            auto accumulate = [&](int32_t i, int32_t j, float w) {
+                const float3 d = p.renderablePositions[j].xyz() - _smoothPositions[i].xyz();
+                _covariancesDiagonal[i] += float4(d * d * w, 0);
+                _covariancesOffDiagonal[i] += float4(d.x * d.y * w, d.x * d.z * w, d.y * d.z * w, w > 0 ? 1.f : 0.f);
+            };
+            accumulate(a, b, weight(distance, p.smoothingRadii[a]));
+            accumulate(b, a, weight(distance, p.smoothingRadii[b]));
+        });
+
+        forEachFluidParticle([&](int32_t i) {
+            const float radius = p.principalRadii[i].x;
+            float4 *axes = &p.anisotropies[size_t(i) * 3];
+            if (_covariancesOffDiagonal[i].w < float(kMinAnisotropyNeighbors)) {
+                axes[0] = float4(1, 0, 0, radius);
+                axes[1] = float4(0, 1, 0, radius);
+                axes[2] = float4(0, 0, 1, radius);
+                return;
+            }
+
+            const float w = 1 / _smoothPositions[i].w;
+            const float4 &diagonal = _covariancesDiagonal[i];
+            const float4 &offDiagonal = _covariancesOffDiagonal[i];
+            float covariance[3][3] = {{diagonal.x * w, offDiagonal.x * w, offDiagonal.y * w},
+                                      {offDiagonal.x * w, diagonal.y * w, offDiagonal.z * w},
+                                      {offDiagonal.y * w, offDiagonal.z * w, diagonal.z * w}};
+            float values[3], vectors[3][3];
+            symmetricEigen(covariance, values, vectors);
+
+            // clamp the axis ratio, then scale so the ellipsoid keeps the volume of the particle.
+            float sigma[3];
+            const float largest = std::sqrt(std::max({values[0], values[1], values[2], 0.f}));
+            for (int k = 0; k < 3; ++k) {
+                sigma[k] = std::max(std::sqrt(std::max(values[k], 0.f)), largest / maxAnisotropy);
+            }
+            const float scale = radius / std::max(std::cbrt(sigma[0] * sigma[1] * sigma[2]), kEpsilon);
+            for (int k = 0; k < 3; ++k) {
+                axes[k] = float4(vectors[0][k], vectors[1][k], vectors[2][k], sigma[k] * scale);
+            }
+
+            const float3 position = p.renderablePositions[i].xyz();
+            p.renderablePositions[i] = float4(
+                position + (_smoothPositions[i].xyz() - position) * kLaplacianSmoothing, p.renderablePositions[i].w);
+        });
+    }
+} // namespace vox::flex
@@ -0,0 +1,89 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../data-structures/constraint-batcher/ConstraintBatcher.h"
+#include "../../data-structures/particle-grid/FluidInteraction.h"
+#include "../../solver/Constraints.h"
+
+namespace vox::flex {
+    // Position based fluids (Macklin and Müller 2013), one density constraint per fluid particle. The solver
+    // hands over the step's fluid interactions, which are colored once into batches sharing no particle;
+    // every pass then walks the batches in order and the pairs of a batch in parallel, accumulating into both
+    // particles of a pair without atomics. An iteration is
+    //   densities: refresh the stored kernel terms of every pair and sum densities and constraint gradients,
+    //   lambdas:   one multiplier per fluid particle,
+    //   deltas:    sum the position corrections of every pair, applied by `apply`.
+    // The solver owns a single instance, registered as the only density batch.
+    class DensityConstraintsBatch : public ConstraintsBatch {
+    public:
+        // Yu and Turk's blend between a particle and the weighted mean of its neighbors.
+        static constexpr float kLaplacianSmoothing = 0.9f;
+        // particles with fewer neighbors are rendered as spheres.
+        static constexpr int kMinAnisotropyNeighbors = 6;
+        // fluid particles have dozens of neighbors, interactions are colored in up to this many rounds.
+        static constexpr uint32_t kColoringRounds = 8;
+
+        void setMode2D(bool mode2D) { _mode2D = mode2D; }
+
+        // Replaces the interactions and fluid particles of the step.
+        void setInteractions(const std::vector<FluidInteraction> &interactions, const int32_t *fluidParticles,
+                             size_t fluidCount, size_t particleCount);
+
+        size_t constraintCount() const override { return _fluidParticles.size(); }
+
+        size_t interactionCount() const { return _interactions.size(); }
+
+        size_t interactionBatchCount() const { return _batchData.size(); }
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+        // Once velocities have been derived from the positions: XSPH viscosity, vorticity confinement, surface
+        // tension (cohesion and curvature, Akinci et al. 2013), drag and pressure of the air around particles at
+        // the surface, and diffusion of user data between neighbors.
+        void applyVelocityCorrections(ParticleData &particles, float substepTime);
+
+        // Smooths renderable positions and writes the principal axes of every fluid particle's neighborhood
+        // (Yu and Turk 2013), with the axis ratio clamped to `maxAnisotropy`.
+        void calculateAnisotropyLaplacianSmoothing(ParticleData &particles, float maxAnisotropy);
+
+    private:
+        template <typename Function>
+        void forEachInteraction(Function &&function);
+
+        template <typename Function>
+        void forEachFluidParticle(Function &&function);
+
+        float mass(const ParticleData &particles, int32_t i) const;
+
+        // mass, smoothing radius and both kernel scales of every fluid particle.
+        void updateFluidProperties(const ParticleData &particles);
+
+        bool _mode2D = false;
+        AlignedVector<int32_t> _fluidParticles;
+        // in batch order.
+        std::vector<FluidInteraction> _interactions;
+        std::vector<BatchData> _batchData;
+        std::vector<uint32_t> _sortedIndices;
+        ConstraintBatcher _batcher;
+
+        // per particle scratch, only fluid entries are used.
+        AlignedVector<float4> _fluidProperties;
+        AlignedVector<float4> _gradients;
+        AlignedVector<float4> _velocityDeltas;
+        AlignedVector<float4> _eta;
+        // h times the gradient of the color field, pointing into the fluid.
+        AlignedVector<float4> _fluidNormals;
+        AlignedVector<float4> _userDataDeltas;
+        AlignedVector<float4> _smoothPositions;
+        AlignedVector<float4> _covariancesDiagonal;
+        AlignedVector<float4> _covariancesOffDiagonal;
+    };
+} // namespace vox::flex
@@ -0,0 +1,73 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../sph/SphKernels.h"
+#include <algorithm>
+
+namespace vox::flex {
+    // Poly6 density kernel taking the smoothing radius per call, same as Poly6Kernel.swift. `scale(h)`
+    // can be computed once per particle and passed to the three argument form in pair loops.
+    struct Poly6Kernel {
+        float norm;
+        bool norm2D;
+
+        explicit Poly6Kernel(bool norm2D) : norm(norm2D ? 4.f / kPiF : 315.f / (64.f * kPiF)), norm2D(norm2D) {}
+
+        float scale(float h) const {
+            const float h2 = h * h;
+            const float h8 = h2 * h2 * h2 * h2;
+            return norm2D ? norm / h8 : norm / (h8 * h);
+        }
+
+        float operator()(float r, float h, float scale) const {
+            const float rl = std::min(r, h);
+            const float hr = h * h - rl * rl;
+            return scale * hr * hr * hr;
+        }
+
+        float operator()(float r, float h) const { return (*this)(r, h, scale(h)); }
+    };
+
+    // Derivative of the Spiky kernel (negative) taking the smoothing radius per call, same as SpikyKernel.swift.
+    struct SpikyKernel {
+        float norm;
+        bool norm2D;
+
+        explicit SpikyKernel(bool norm2D) : norm(norm2D ? -30.f / kPiF : -45.f / kPiF), norm2D(norm2D) {}
+
+        float scale(float h) const {
+            const float h4 = h * h * h * h;
+            return norm2D ? norm / (h4 * h) : norm / (h4 * h * h);
+        }
+
+        float operator()(float r, float h, float scale) const {
+            const float hr = h - std::min(r, h);
+            return scale * hr * hr;
+        }
+
+        float operator()(float r, float h) const { return (*this)(r, h, scale(h)); }
+    };
+
+    // Cohesion spline of Akinci et al. 2013 for surface tension: attracts beyond h / 2, repels closer. The 2D
+    // variant drops a power of h like the kernels above.
+    struct CohesionKernel {
+        bool norm2D;
+
+        explicit CohesionKernel(bool norm2D) : norm2D(norm2D) {}
+
+        float operator()(float r, float h) const {
+            if (r >= h || r <= 0) {
+                return 0;
+            }
+            const float h3 = h * h * h;
+            const float scale = 32.f / (kPiF * h3 * h3 * h * h * (norm2D ? 1 : h));
+            const float spline = (h - r) * (h - r) * (h - r) * r * r * r;
+            return scale * (r > h * 0.5f ? spline : 2 * spline - h3 * h3 / 64);
+        }
+    };
+} // namespace vox::flex
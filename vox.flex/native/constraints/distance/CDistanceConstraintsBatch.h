@@ -0,0 +1,28 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// XPBD distance constraints, see DistanceConstraintsBatch.
+@interface CDistanceConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// Two particle indices per constraint; stiffnesses are (compliance, max compression) pairs. Lambdas may be null.
+- (void)setDistanceConstraints:(const int32_t *_Nonnull)particleIndices
+                   restLengths:(const float *_Nonnull)restLengths
+                   stiffnesses:(const simd_float2 *_Nonnull)stiffnesses
+                       lambdas:(const float *_Nullable)lambdas
+                         count:(uint32_t)count;
+
+/// Accumulated XPBD multipliers of the current substep, `constraintCount` values.
+- (void)getLambdas:(float *_Nonnull)lambdas;
+
+@end
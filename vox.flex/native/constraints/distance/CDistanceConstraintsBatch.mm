@@ -0,0 +1,43 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CDistanceConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "DistanceConstraintsBatch.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+@implementation CDistanceConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::Distance
+                           batch:std::make_unique<DistanceConstraintsBatch>()];
+}
+
+- (DistanceConstraintsBatch *)distanceBatch {
+    return static_cast<DistanceConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setDistanceConstraints:(const int32_t *)particleIndices
+                   restLengths:(const float *)restLengths
+                   stiffnesses:(const simd_float2 *)stiffnesses
+                       lambdas:(const float *)lambdas
+                         count:(uint32_t)count {
+    if (auto *batch = [self distanceBatch]) {
+        batch->setDistanceConstraints(particleIndices, restLengths, reinterpret_cast<const float *>(stiffnesses),
+                                      lambdas, count);
+    }
+}
+
+- (void)getLambdas:(float *)lambdas {
+    if (auto *batch = [self distanceBatch]) {
+        std::copy(batch->lambdas().begin(), batch->lambdas().end(), lambdas);
+    }
+}
+
+@end
@@ -0,0 +1,132 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "DistanceConstraintsBatch.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kGroupGrain = 32;
+        constexpr float kEpsilon = 1e-7f;
+    } // namespace
+
+    void DistanceConstraintsBatch::setDistanceConstraints(const int32_t *particleIndices, const float *restLengths,
+                                                          const float *stiffnesses, const float *lambdas,
+                                                          size_t count) {
+        _particleIndices.assign(particleIndices, particleIndices + count * 2);
+        _restLengths.assign(restLengths, restLengths + count);
+        _compliances.resize(count);
+        _maxCompressions.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            _compliances[i] = stiffnesses[i * 2];
+            _maxCompressions[i] = stiffnesses[i * 2 + 1];
+        }
+        if (lambdas != nullptr) {
+            _lambdas.assign(lambdas, lambdas + count);
+        } else {
+            _lambdas.assign(count, 0.f);
+        }
+    }
+
+    void DistanceConstraintsBatch::initialize(ParticleData &, float) {
+        std::fill(_lambdas.begin(), _lambdas.end(), 0.f);
+    }
+
+    void DistanceConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &parameters, float,
+                                            float substepTime, int) {
+        const size_t count = constraintCount();
+        const size_t groupCount = (count + kLanes - 1) / kLanes;
+        const float deltaTimeSqr = substepTime * substepTime;
+        const bool inPlace = parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Sequential;
+        const float sorFactor = parameters.SORFactor;
+        parallelFor(0, groupCount, kGroupGrain, [&](size_t begin, size_t end) {
+            if (inPlace) {
+                project<true>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            } else {
+                project<false>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            }
+        });
+    }
+
+    void DistanceConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters, float) {
+        // in-place evaluation leaves nothing to apply.
+        if (parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Parallel) {
+            applyPositionDeltas(particles, _particleIndices.data(), _particleIndices.size(), parameters.SORFactor);
+        }
+    }
+
+    template <bool InPlace>
+    void DistanceConstraintsBatch::project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr,
+                                           float sorFactor) {
+        const int32_t *indices = _particleIndices.data();
+        float4 *positions = particles.positions.data();
+        const float *invMasses = particles.invMasses.data();
+
+        for (size_t base = begin; base < end; base += kLanes) {
+            const size_t lanes = std::min(kLanes, end - base);
+
+            // gather, padding the tail of the last group with massless unit-length constraints at rest.
+            alignas(32) float dx[kLanes], dy[kLanes], dz[kLanes];
+            alignas(32) float w1[kLanes], w2[kLanes];
+            alignas(32) float restLength[kLanes], compliance[kLanes], maxCompression[kLanes], lambda[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const size_t c = base + l;
+                    const int32_t p1 = indices[c * 2];
+                    const int32_t p2 = indices[c * 2 + 1];
+                    const float4 d = positions[p1] - positions[p2];
+                    dx[l] = d.x;
+                    dy[l] = d.y;
+                    dz[l] = d.z;
+                    w1[l] = invMasses[p1];
+                    w2[l] = invMasses[p2];
+                    restLength[l] = _restLengths[c];
+                    compliance[l] = _compliances[c];
+                    maxCompression[l] = _maxCompressions[c];
+                    lambda[l] = _lambdas[c];
+                } else {
+                    dx[l] = 1;
+                    dy[l] = dz[l] = 0;
+                    w1[l] = w2[l] = 0;
+                    restLength[l] = 1;
+                    compliance[l] = maxCompression[l] = lambda[l] = 0;
+                }
+            }
+
+            // solve: dlambda = (-C - alpha * lambda) / (w1 + w2 + alpha), alpha being the time-scaled compliance.
+            alignas(32) float dlambda[kLanes], scale[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                const float alpha = compliance[l] / deltaTimeSqr;
+                const float distance = std::sqrt(dx[l] * dx[l] + dy[l] * dy[l] + dz[l] * dz[l]);
+                float constraint = distance - restLength[l];
+                constraint -= std::max(std::min(constraint, 0.f), -maxCompression[l]);
+                dlambda[l] = (-constraint - alpha * lambda[l]) / (w1[l] + w2[l] + alpha + kEpsilon);
+                scale[l] = dlambda[l] / (distance + kEpsilon);
+            }
+
+            // scatter.
+            for (size_t l = 0; l < lanes; ++l) {
+                const size_t c = base + l;
+                const int32_t p1 = indices[c * 2];
+                const int32_t p2 = indices[c * 2 + 1];
+                const float4 delta(dx[l] * scale[l], dy[l] * scale[l], dz[l] * scale[l], 0);
+                _lambdas[c] += dlambda[l];
+                if constexpr (InPlace) {
+                    positions[p1] += delta * (w1[l] * sorFactor);
+                    positions[p2] -= delta * (w2[l] * sorFactor);
+                } else {
+                    particles.positionDeltas[p1] += delta * w1[l];
+                    particles.positionDeltas[p2] -= delta * w2[l];
+                    ++particles.positionConstraintCounts[p1];
+                    ++particles.positionConstraintCounts[p2];
+                }
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,50 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+
+namespace vox::flex {
+    // XPBD distance constraints between particle pairs. Constraints are projected kLanes at a time: the
+    // positions and inverse masses of a group are gathered into SoA lanes, solved with straight-line lane
+    // loops the compiler turns into 4/8-wide SIMD, and the corrections scattered back.
+    //
+    // With sequential evaluation the batch is solved Gauss-Seidel style, writing the SOR-scaled
+    // corrections straight to the positions: constraints of a batch share no particle, so this equals
+    // accumulating and applying them, minus the round trip through the delta buffers. With parallel
+    // evaluation corrections are accumulated into the particle deltas and averaged by `apply` (Jacobi).
+    class DistanceConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+
+        // `particleIndices` holds two particles per constraint, `stiffnesses` two floats per constraint:
+        // the compliance and how much shorter than its rest length the constraint may get unopposed.
+        void setDistanceConstraints(const int32_t *particleIndices, const float *restLengths,
+                                    const float *stiffnesses, const float *lambdas, size_t count);
+
+        size_t constraintCount() const override { return _restLengths.size(); }
+
+        const AlignedVector<float> &lambdas() const { return _lambdas; }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        template <bool InPlace>
+        void project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr, float sorFactor);
+
+        AlignedVector<int32_t> _particleIndices;
+        AlignedVector<float> _restLengths;
+        AlignedVector<float> _compliances;
+        AlignedVector<float> _maxCompressions;
+        AlignedVector<float> _lambdas;
+    };
+} // namespace vox::flex
@@ -0,0 +1,40 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// Shape matching clusters, see ShapeMatchingConstraintsBatch.
+@interface CShapeMatchingConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// Cluster i owns particleIndices[firstIndex[i] ..< firstIndex[i] + numIndices[i]]. Material parameters are
+/// 5 floats per cluster: stiffness, plastic yield, creep, recovery and max deformation. Orientations and
+/// plastic deformations (upper 3x3 used) may be null.
+- (void)setShapeMatchingConstraints:(const int32_t *_Nonnull)particleIndices
+                         firstIndex:(const int32_t *_Nonnull)firstIndex
+                         numIndices:(const int32_t *_Nonnull)numIndices
+                      explicitGroup:(const int32_t *_Nonnull)explicitGroup
+                 materialParameters:(const float *_Nonnull)materialParameters
+                       orientations:(const simd_quatf *_Nullable)orientations
+                plasticDeformations:(const simd_float4x4 *_Nullable)plasticDeformations
+                              count:(uint32_t)count;
+
+/// Recomputes the rest shape of every cluster from the solver's rest positions and inverse masses.
+- (void)calculateRestShapeMatching;
+
+/// `constraintCount` values each, any may be null.
+- (void)getRestComs:(simd_float4 *_Nullable)restComs
+                coms:(simd_float4 *_Nullable)coms
+        orientations:(simd_quatf *_Nullable)orientations
+    linearTransforms:(simd_float4x4 *_Nullable)linearTransforms
+ plasticDeformations:(simd_float4x4 *_Nullable)plasticDeformations;
+
+@end
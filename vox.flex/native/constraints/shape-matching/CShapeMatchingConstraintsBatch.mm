@@ -0,0 +1,98 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CShapeMatchingConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "ShapeMatchingConstraintsBatch.h"
+#include <algorithm>
+#include <vector>
+
+using namespace vox::flex;
+
+static_assert(sizeof(float4) == sizeof(simd_float4), "float4 must match simd_float4 layout");
+static_assert(sizeof(quaternion) == sizeof(simd_quatf), "quaternion must match simd_quatf layout");
+
+namespace {
+    float3x3 toNative(const simd_float4x4 &m) {
+        return {float3(m.columns[0].x, m.columns[0].y, m.columns[0].z),
+                float3(m.columns[1].x, m.columns[1].y, m.columns[1].z),
+                float3(m.columns[2].x, m.columns[2].y, m.columns[2].z)};
+    }
+
+    simd_float4x4 toSimd(const float3x3 &m) {
+        return simd_matrix(simd_make_float4(m[0].x, m[0].y, m[0].z, 0), simd_make_float4(m[1].x, m[1].y, m[1].z, 0),
+                           simd_make_float4(m[2].x, m[2].y, m[2].z, 0), simd_make_float4(0, 0, 0, 1));
+    }
+
+    template <typename Source, typename Destination>
+    void copyTo(const Source &source, Destination *destination) {
+        if (destination != nullptr) {
+            std::copy(source.begin(), source.end(), reinterpret_cast<typename Source::value_type *>(destination));
+        }
+    }
+} // namespace
+
+@implementation CShapeMatchingConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::ShapeMatching
+                           batch:std::make_unique<ShapeMatchingConstraintsBatch>()];
+}
+
+- (ShapeMatchingConstraintsBatch *)shapeMatchingBatch {
+    return static_cast<ShapeMatchingConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setShapeMatchingConstraints:(const int32_t *)particleIndices
+                         firstIndex:(const int32_t *)firstIndex
+                         numIndices:(const int32_t *)numIndices
+                      explicitGroup:(const int32_t *)explicitGroup
+                 materialParameters:(const float *)materialParameters
+                       orientations:(const simd_quatf *)orientations
+                plasticDeformations:(const simd_float4x4 *)plasticDeformations
+                              count:(uint32_t)count {
+    if (auto *batch = [self shapeMatchingBatch]) {
+        std::vector<float3x3> deformations;
+        if (plasticDeformations != nullptr) {
+            deformations.resize(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                deformations[i] = toNative(plasticDeformations[i]);
+            }
+        }
+        batch->setShapeMatchingConstraints(particleIndices, firstIndex, numIndices, explicitGroup,
+                                           materialParameters, reinterpret_cast<const quaternion *>(orientations),
+                                           plasticDeformations != nullptr ? deformations.data() : nullptr, count);
+    }
+}
+
+- (void)calculateRestShapeMatching {
+    if (auto *batch = [self shapeMatchingBatch]) {
+        batch->calculateRestShapeMatching([[self solver] nativeSolver]->particles());
+    }
+}
+
+- (void)getRestComs:(simd_float4 *)restComs
+                coms:(simd_float4 *)coms
+        orientations:(simd_quatf *)orientations
+    linearTransforms:(simd_float4x4 *)linearTransforms
+ plasticDeformations:(simd_float4x4 *)plasticDeformations {
+    if (auto *batch = [self shapeMatchingBatch]) {
+        copyTo(batch->restComs(), restComs);
+        copyTo(batch->coms(), coms);
+        copyTo(batch->orientations(), orientations);
+        for (size_t i = 0; i < batch->constraintCount(); ++i) {
+            if (linearTransforms != nullptr) {
+                linearTransforms[i] = toSimd(batch->linearTransforms()[i]);
+            }
+            if (plasticDeformations != nullptr) {
+                plasticDeformations[i] = toSimd(batch->plasticDeformations()[i]);
+            }
+        }
+    }
+}
+
+@end
@@ -0,0 +1,301 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ShapeMatchingConstraintsBatch.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kClusterGrain = 16;
+        constexpr size_t kParticleGrain = 512;
+        constexpr float kEpsilon = 1e-6f;
+        // rest covariances with a smaller determinant relative to their scale are treated as singular.
+        constexpr float kSingularity = 1e-6f;
+
+        constexpr size_t kMaterialStride = 5;
+
+        // static particles get a large finite mass, which pins the center of mass of their clusters.
+        inline float massOf(float invMass) { return 1.f / (invMass + kEpsilon); }
+    } // namespace
+
+    void ShapeMatchingConstraintsBatch::setShapeMatchingConstraints(
+        const int32_t *particleIndices, const int32_t *firstIndex, const int32_t *numIndices,
+        const int32_t *explicitGroup, const float *materialParameters, const quaternion *orientations,
+        const float3x3 *plasticDeformations, size_t count) {
+        _numIndices.assign(numIndices, numIndices + count);
+        _explicitGroup.assign(explicitGroup, explicitGroup + count);
+        _materialParameters.assign(materialParameters, materialParameters + count * kMaterialStride);
+        if (orientations != nullptr) {
+            _orientations.assign(orientations, orientations + count);
+        } else {
+            _orientations.assign(count, quaternion());
+        }
+        if (plasticDeformations != nullptr) {
+            _deformations.assign(plasticDeformations, plasticDeformations + count);
+        } else {
+            _deformations.assign(count, float3x3(1));
+        }
+        _restComs.assign(count, float4());
+        _coms.assign(count, float4());
+        _invRestCovariances.assign(count, float3x3(0));
+        _linearTransforms.assign(count, float3x3(1));
+        _invertible.assign(count, 0);
+
+        // clusters are copied to lane aligned entries, so every lane group of the reduction is a full aligned
+        // load of the rest offsets.
+        _firstLane.resize(count + 1);
+        int32_t maxParticle = -1;
+        int32_t laneCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            _firstLane[i] = laneCount;
+            laneCount += int32_t((size_t(numIndices[i]) + kLanes - 1) / kLanes * kLanes);
+        }
+        _firstLane[count] = laneCount;
+        _particleIndices.assign(size_t(laneCount), -1);
+        for (size_t i = 0; i < count; ++i) {
+            for (int32_t j = 0; j < numIndices[i]; ++j) {
+                const int32_t p = particleIndices[firstIndex[i] + j];
+                _particleIndices[_firstLane[i] + j] = p;
+                maxParticle = std::max(maxParticle, p);
+            }
+        }
+        _restX.assign(size_t(laneCount), 0.f);
+        _restY.assign(size_t(laneCount), 0.f);
+        _restZ.assign(size_t(laneCount), 0.f);
+        _corrections.assign(size_t(laneCount), float4());
+
+        // entries of every particle, in entry order.
+        _particleOffsets.assign(size_t(maxParticle + 2), 0);
+        for (int32_t p : _particleIndices) {
+            if (p >= 0) {
+                ++_particleOffsets[p];
+            }
+        }
+        _particles.clear();
+        for (int32_t p = 0; p <= maxParticle; ++p) {
+            if (_particleOffsets[p] > 0) {
+                _particles.push_back(p);
+            }
+        }
+        parallelExclusiveScan(_particleOffsets.data(), _particleOffsets.data(), _particleOffsets.size());
+        _particleEntries.resize(size_t(_particleOffsets.back()));
+        AlignedVector<int32_t> cursors(_particleOffsets.begin(), _particleOffsets.end() - 1);
+        for (int32_t e = 0; e < laneCount; ++e) {
+            if (_particleIndices[e] >= 0) {
+                _particleEntries[cursors[_particleIndices[e]]++] = e;
+            }
+        }
+        _restDirty = true;
+    }
+
+    void ShapeMatchingConstraintsBatch::calculateRestShapeMatching(const ParticleData &particles) {
+        _restDirty = false;
+        const float4 *restPositions = particles.restPositions.data();
+        const float *invMasses = particles.invMasses.data();
+        parallelForEach(constraintCount(), kClusterGrain, [&](size_t i) {
+            const int32_t first = _firstLane[i];
+            const int32_t count = _numIndices[i];
+            float mass = 0;
+            float3 com;
+            for (int32_t j = 0; j < count; ++j) {
+                const int32_t p = _particleIndices[first + j];
+                const float m = massOf(invMasses[p]);
+                com += restPositions[p].xyz() * m;
+                mass += m;
+            }
+            com = mass > 0 ? com * (1.f / mass) : com;
+
+            float3x3 covariance(0);
+            for (int32_t j = 0; j < count; ++j) {
+                const int32_t p = _particleIndices[first + j];
+                const float3 q = restPositions[p].xyz() - com;
+                _restX[first + j] = q.x;
+                _restY[first + j] = q.y;
+                _restZ[first + j] = q.z;
+                covariance = covariance + outerProduct(q * massOf(invMasses[p]), q);
+            }
+            const float scale = (covariance[0].x + covariance[1].y + covariance[2].z) / 3;
+            _invertible[i] = determinant(covariance) > kSingularity * scale * scale * scale;
+            _invRestCovariances[i] = _invertible[i] ? inverse(covariance) : float3x3(0);
+            _restComs[i] = float4(com, 0);
+            _coms[i] = _restComs[i];
+        });
+    }
+
+    void ShapeMatchingConstraintsBatch::initialize(ParticleData &particles, float) {
+        if (_restDirty) {
+            calculateRestShapeMatching(particles);
+        }
+    }
+
+    void ShapeMatchingConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &, float,
+                                                 float substepTime, int) {
+        parallelForEach(constraintCount(), kClusterGrain,
+                        [&](size_t i) { matchShape(particles, i, substepTime); });
+
+        // gather: every particle sums its entries' corrections, in entry order.
+        parallelFor(0, _particles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t p = _particles[k];
+                const int32_t first = _particleOffsets[p], last = _particleOffsets[p + 1];
+                float4 sum;
+                for (int32_t e = first; e < last; ++e) {
+                    sum += _corrections[_particleEntries[e]];
+                }
+                particles.positionDeltas[p] += sum;
+                particles.positionConstraintCounts[p] += last - first;
+            }
+        });
+    }
+
+    void ShapeMatchingConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters,
+                                              float) {
+        // clusters overlap, so corrections are always averaged whatever the evaluation order.
+        applyPositionDeltas(particles, _particles.data(), _particles.size(), parameters.SORFactor);
+    }
+
+    void ShapeMatchingConstraintsBatch::matchShape(ParticleData &particles, size_t cluster, float substepTime) {
+        const int32_t first = _firstLane[cluster];
+        const auto count = size_t(_numIndices[cluster]);
+        if (count == 0) {
+            return;
+        }
+        const int32_t *indices = _particleIndices.data() + first;
+        const float *restX = _restX.data() + first;
+        const float *restY = _restY.data() + first;
+        const float *restZ = _restZ.data() + first;
+        const float4 *positions = particles.positions.data();
+        const float *invMasses = particles.invMasses.data();
+
+        // reduce sum m, sum m x, sum m q and sum m x q^T lane-wise, then across lanes. Padding lanes are massless.
+        alignas(32) float sm[kLanes] = {}, smx[kLanes] = {}, smy[kLanes] = {}, smz[kLanes] = {};
+        alignas(32) float smqx[kLanes] = {}, smqy[kLanes] = {}, smqz[kLanes] = {};
+        alignas(32) float sxx[kLanes] = {}, sxy[kLanes] = {}, sxz[kLanes] = {};
+        alignas(32) float syx[kLanes] = {}, syy[kLanes] = {}, syz[kLanes] = {};
+        alignas(32) float szx[kLanes] = {}, szy[kLanes] = {}, szz[kLanes] = {};
+        for (size_t base = 0; base < count; base += kLanes) {
+            const size_t lanes = std::min(kLanes, count - base);
+            alignas(32) float px[kLanes], py[kLanes], pz[kLanes], m[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const int32_t p = indices[base + l];
+                    px[l] = positions[p].x;
+                    py[l] = positions[p].y;
+                    pz[l] = positions[p].z;
+                    m[l] = massOf(invMasses[p]);
+                } else {
+                    px[l] = py[l] = pz[l] = m[l] = 0;
+                }
+            }
+            const float *qx = restX + base, *qy = restY + base, *qz = restZ + base;
+            for (size_t l = 0; l < kLanes; ++l) {
+                const float mx = m[l] * px[l], my = m[l] * py[l], mz = m[l] * pz[l];
+                sm[l] += m[l];
+                smx[l] += mx;
+                smy[l] += my;
+                smz[l] += mz;
+                smqx[l] += m[l] * qx[l];
+                smqy[l] += m[l] * qy[l];
+                smqz[l] += m[l] * qz[l];
+                sxx[l] += mx * qx[l];
+                sxy[l] += mx * qy[l];
+                sxz[l] += mx * qz[l];
+                syx[l] += my * qx[l];
+                syy[l] += my * qy[l];
+                syz[l] += my * qz[l];
+                szx[l] += mz * qx[l];
+                szy[l] += mz * qy[l];
+                szz[l] += mz * qz[l];
+            }
+        }
+        float sums[16] = {};
+        const float *accumulators[16] = {sm,  smx, smy, smz, smqx, smqy, smqz, sxx,
+                                         sxy, sxz, syx, syy, syz,  szx,  szy,  szz};
+        for (int k = 0; k < 16; ++k) {
+            for (size_t l = 0; l < kLanes; ++l) {
+                sums[k] += accumulators[k][l];
+            }
+        }
+        const float3 com = float3(sums[1], sums[2], sums[3]) * (1.f / sums[0]);
+        const float3 mq(sums[4], sums[5], sums[6]);
+        // Apq = sum m (x - c) q^T = sum m x q^T - c (sum m q)^T, column j pairs x with q_j.
+        const float3x3 apq = float3x3(float3(sums[7], sums[10], sums[13]), float3(sums[8], sums[11], sums[14]),
+                                      float3(sums[9], sums[12], sums[15])) -
+                             outerProduct(com, mq);
+
+        // best rotation towards the plastically deformed rest shape D q, whose Apq is Apq D^T.
+        const float3x3 &deformation = _deformations[cluster];
+        quaternion &orientation = _orientations[cluster];
+        extractRotation(apq * transpose(deformation), orientation, kRotationIterations);
+        const float3x3 rotation = rotationMatrix(orientation);
+        const float3x3 transform = rotation * deformation;
+        _coms[cluster] = float4(com, 0);
+        _linearTransforms[cluster] = transform;
+
+        // goals: c + R D q, corrections scaled by the stiffness. Static particles are not moved.
+        const float stiffness = _materialParameters[cluster * kMaterialStride];
+        float4 *corrections = _corrections.data() + first;
+        for (size_t base = 0; base < count; base += kLanes) {
+            const size_t lanes = std::min(kLanes, count - base);
+            const float *qx = restX + base, *qy = restY + base, *qz = restZ + base;
+            alignas(32) float gx[kLanes], gy[kLanes], gz[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                gx[l] = com.x + transform[0].x * qx[l] + transform[1].x * qy[l] + transform[2].x * qz[l];
+                gy[l] = com.y + transform[0].y * qx[l] + transform[1].y * qy[l] + transform[2].y * qz[l];
+                gz[l] = com.z + transform[0].z * qx[l] + transform[1].z * qy[l] + transform[2].z * qz[l];
+            }
+            for (size_t l = 0; l < lanes; ++l) {
+                const int32_t p = indices[base + l];
+                const float scale = invMasses[p] > 0 ? stiffness : 0.f;
+                const float4 &x = positions[p];
+                corrections[base + l] = float4(gx[l] - x.x, gy[l] - x.y, gz[l] - x.z, 0) * scale;
+            }
+        }
+
+        // explicit clusters (rigid pieces) carry their particles' orientations along, they must not overlap.
+        if (_explicitGroup[cluster] > 0) {
+            for (size_t j = 0; j < count; ++j) {
+                const int32_t p = indices[j];
+                particles.orientations[p] = orientation * particles.restOrientations[p];
+            }
+        }
+
+        if (_invertible[cluster]) {
+            updatePlasticity(cluster, apq, rotation, substepTime);
+        }
+    }
+
+    void ShapeMatchingConstraintsBatch::updatePlasticity(size_t cluster, const float3x3 &apq,
+                                                         const float3x3 &rotation, float substepTime) {
+        const float *material = _materialParameters.data() + cluster * kMaterialStride;
+        const float yield = material[1], creep = material[2], recovery = material[3], maxDeformation = material[4];
+        if (creep <= 0 && recovery <= 0) {
+            return;
+        }
+        const float3x3 identity(1);
+        float3x3 &deformation = _deformations[cluster];
+
+        // observed stretch: the symmetric part of R^T A, A = Apq Aqq^-1 mapping the rest shape to the current one.
+        const float3x3 stretch = transpose(rotation) * (apq * _invRestCovariances[cluster]);
+        const float3x3 symmetric = (stretch + transpose(stretch)) * 0.5f;
+        if (frobeniusNorm(symmetric - deformation) > yield) {
+            deformation = deformation + (symmetric - deformation) * std::min(creep, 1.f);
+        }
+        deformation = deformation + (identity - deformation) * std::min(recovery * substepTime, 1.f);
+
+        const float3x3 offset = deformation - identity;
+        const float amount = frobeniusNorm(offset);
+        if (amount > maxDeformation) {
+            deformation = identity + offset * (maxDeformation / amount);
+        }
+        // plastic flow keeps the volume.
+        const float det = determinant(deformation);
+        deformation = det > kEpsilon ? deformation * (1.f / std::cbrt(det)) : identity;
+    }
+} // namespace vox::flex
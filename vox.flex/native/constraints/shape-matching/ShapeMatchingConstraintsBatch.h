@@ -0,0 +1,92 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+#include <vector>
+
+namespace vox::flex {
+    // Shape matching (Müller et al. 2005) over clusters of particles. Cluster i owns the entries
+    // particleIndices[firstIndex[i] ..< firstIndex[i] + numIndices[i]], and the clusters of a batch may share
+    // particles, as the overlapping clusters of a softbody do. An evaluation
+    //   reduces:  the center of mass and Apq = sum m (x - c) q^T of every cluster, kLanes entries at a time
+    //             over the rest offsets q kept in SoA lanes,
+    //   rotates:  extracts the rotation of Apq with a few iterations warm started from the cluster's last one,
+    //   goals:    writes the correction towards its goal position of every entry,
+    // then gathers the corrections of every particle over the entries referring to it, so overlapping
+    // clusters run in parallel without atomics and sum in the same order every time.
+    //
+    // Plastic clusters deform their rest shape by a symmetric matrix that creeps towards the observed stretch
+    // while it exceeds the yield, recovers towards identity over time and keeps the cluster's volume.
+    class ShapeMatchingConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+        // extraction iterations per evaluation, enough once warm started.
+        static constexpr int kRotationIterations = 2;
+
+        // `materialParameters` holds 5 floats per cluster: stiffness, plastic yield, creep, recovery and max
+        // deformation. Explicit clusters (explicitGroup > 0) also drive their particles' orientations.
+        // `orientations` warm start the extraction and `plasticDeformations` are the initial rest shape
+        // deformations, both may be null. The rest shape is computed from the rest positions before the next
+        // substep, or by calculateRestShapeMatching.
+        void setShapeMatchingConstraints(const int32_t *particleIndices, const int32_t *firstIndex,
+                                         const int32_t *numIndices, const int32_t *explicitGroup,
+                                         const float *materialParameters, const quaternion *orientations,
+                                         const float3x3 *plasticDeformations, size_t count);
+
+        // Rest centers of mass and covariances from the rest positions and current masses.
+        void calculateRestShapeMatching(const ParticleData &particles);
+
+        size_t constraintCount() const override { return _numIndices.size(); }
+
+        // Clusters' current state, as of the last evaluation.
+        const AlignedVector<float4> &restComs() const { return _restComs; }
+        const AlignedVector<float4> &coms() const { return _coms; }
+        const AlignedVector<quaternion> &orientations() const { return _orientations; }
+        const std::vector<float3x3> &linearTransforms() const { return _linearTransforms; }
+        const std::vector<float3x3> &plasticDeformations() const { return _deformations; }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        void matchShape(ParticleData &particles, size_t cluster, float substepTime);
+
+        void updatePlasticity(size_t cluster, const float3x3 &apq, const float3x3 &rotation, float substepTime);
+
+        AlignedVector<int32_t> _particleIndices;
+        AlignedVector<int32_t> _numIndices;
+        AlignedVector<int32_t> _explicitGroup;
+        AlignedVector<float> _materialParameters;
+
+        // per cluster
+        AlignedVector<float4> _restComs;
+        AlignedVector<float4> _coms;
+        AlignedVector<quaternion> _orientations;
+        std::vector<float3x3> _invRestCovariances;
+        std::vector<float3x3> _linearTransforms;
+        std::vector<float3x3> _deformations;
+        // clusters whose rest covariance is singular (flat or tiny ones) have no linear transform.
+        std::vector<uint8_t> _invertible;
+        // first entry of every cluster in the per entry arrays.
+        AlignedVector<int32_t> _firstLane;
+        bool _restDirty = false;
+
+        // per entry, padded so every cluster starts on a lane boundary: rest offsets and goal corrections.
+        std::vector<float, AlignedAllocator<float, 32>> _restX, _restY, _restZ;
+        AlignedVector<float4> _corrections;
+
+        // entries of every particle (CSR), for the gather.
+        AlignedVector<int32_t> _particles;
+        AlignedVector<int32_t> _particleOffsets;
+        AlignedVector<int32_t> _particleEntries;
+    };
+} // namespace vox::flex
@@ -0,0 +1,38 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// Skin constraints of skinned cloth, see SkinConstraintsBatch.
+@interface CSkinConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// One particle per constraint. radiiBackstop holds 3 floats per constraint: skin radius, backstop sphere radius and
+/// backstop distance; stiffnesses are compliances. Lambdas may be null.
+- (void)setSkinConstraints:(const int32_t *_Nonnull)particleIndices
+                skinPoints:(const simd_float4 *_Nonnull)skinPoints
+               skinNormals:(const simd_float4 *_Nonnull)skinNormals
+             radiiBackstop:(const float *_Nonnull)radiiBackstop
+               stiffnesses:(const float *_Nonnull)stiffnesses
+                   lambdas:(const float *_Nullable)lambdas
+                     count:(uint32_t)count;
+
+/// Reads skin points and normals straight from a skinned vertex buffer in solver space, through vertexIndices (one
+/// per constraint) or in constraint order when it is null. The buffers are borrowed, not copied: they must outlive
+/// the binding, which a null positions pointer removes.
+- (void)bindSkinnedVertices:(const simd_float4 *_Nullable)positions
+                    normals:(const simd_float4 *_Nullable)normals
+              vertexIndices:(const int32_t *_Nullable)vertexIndices;
+
+/// Accumulated XPBD multipliers of the current substep.
+- (void)getLambdas:(float *_Nonnull)lambdas;
+
+@end
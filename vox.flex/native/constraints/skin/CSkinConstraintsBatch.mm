@@ -0,0 +1,57 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CSkinConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "SkinConstraintsBatch.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+static_assert(sizeof(float4) == sizeof(simd_float4), "float4 must match simd_float4 layout");
+
+@implementation CSkinConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::Skin
+                           batch:std::make_unique<SkinConstraintsBatch>()];
+}
+
+- (SkinConstraintsBatch *)skinBatch {
+    return static_cast<SkinConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setSkinConstraints:(const int32_t *)particleIndices
+                skinPoints:(const simd_float4 *)skinPoints
+               skinNormals:(const simd_float4 *)skinNormals
+             radiiBackstop:(const float *)radiiBackstop
+               stiffnesses:(const float *)stiffnesses
+                   lambdas:(const float *)lambdas
+                     count:(uint32_t)count {
+    if (auto *batch = [self skinBatch]) {
+        batch->setSkinConstraints(particleIndices, reinterpret_cast<const float4 *>(skinPoints),
+                                  reinterpret_cast<const float4 *>(skinNormals), radiiBackstop, stiffnesses, lambdas,
+                                  count);
+    }
+}
+
+- (void)bindSkinnedVertices:(const simd_float4 *)positions
+                    normals:(const simd_float4 *)normals
+              vertexIndices:(const int32_t *)vertexIndices {
+    if (auto *batch = [self skinBatch]) {
+        batch->bindSkinnedVertices(reinterpret_cast<const float4 *>(positions),
+                                   reinterpret_cast<const float4 *>(normals), vertexIndices);
+    }
+}
+
+- (void)getLambdas:(float *)lambdas {
+    if (auto *batch = [self skinBatch]) {
+        std::copy(batch->lambdas().begin(), batch->lambdas().end(), lambdas);
+    }
+}
+
+@end
@@ -0,0 +1,158 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "SkinConstraintsBatch.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kGroupGrain = 32;
+        constexpr float kEpsilon = 1e-7f;
+    } // namespace
+
+    void SkinConstraintsBatch::setSkinConstraints(const int32_t *particleIndices, const float4 *skinPoints,
+                                                  const float4 *skinNormals, const float *radiiBackstop,
+                                                  const float *stiffnesses, const float *lambdas, size_t count) {
+        _particleIndices.assign(particleIndices, particleIndices + count);
+        _skinPoints.assign(skinPoints, skinPoints + count);
+        _skinNormals.assign(skinNormals, skinNormals + count);
+        _radiiBackstop.assign(radiiBackstop, radiiBackstop + count * 3);
+        _compliances.assign(stiffnesses, stiffnesses + count);
+        if (lambdas != nullptr) {
+            _lambdas.assign(lambdas, lambdas + count);
+        } else {
+            _lambdas.assign(count, 0.f);
+        }
+    }
+
+    void SkinConstraintsBatch::bindSkinnedVertices(const float4 *positions, const float4 *normals,
+                                                   const int32_t *vertexIndices) {
+        _skinnedPositions = positions;
+        _skinnedNormals = positions != nullptr ? normals : nullptr;
+        _skinnedIndices = positions != nullptr ? vertexIndices : nullptr;
+    }
+
+    void SkinConstraintsBatch::initialize(ParticleData &, float) {
+        std::fill(_lambdas.begin(), _lambdas.end(), 0.f);
+    }
+
+    void SkinConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &parameters, float,
+                                        float substepTime, int) {
+        const size_t count = constraintCount();
+        const size_t groupCount = (count + kLanes - 1) / kLanes;
+        const float deltaTimeSqr = substepTime * substepTime;
+        const bool inPlace = parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Sequential;
+        const bool skinned = _skinnedPositions != nullptr;
+        const float sorFactor = parameters.SORFactor;
+        parallelFor(0, groupCount, kGroupGrain, [&](size_t begin, size_t end) {
+            end = std::min(count, end * kLanes);
+            begin *= kLanes;
+            if (inPlace) {
+                skinned ? project<true, true>(particles, begin, end, deltaTimeSqr, sorFactor)
+                        : project<true, false>(particles, begin, end, deltaTimeSqr, sorFactor);
+            } else {
+                skinned ? project<false, true>(particles, begin, end, deltaTimeSqr, sorFactor)
+                        : project<false, false>(particles, begin, end, deltaTimeSqr, sorFactor);
+            }
+        });
+    }
+
+    void SkinConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters, float) {
+        if (parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Parallel) {
+            applyPositionDeltas(particles, _particleIndices.data(), _particleIndices.size(), parameters.SORFactor);
+        }
+    }
+
+    template <bool InPlace, bool Skinned>
+    void SkinConstraintsBatch::project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr,
+                                       float sorFactor) {
+        const int32_t *indices = _particleIndices.data();
+        const float4 *skinPoints = Skinned ? _skinnedPositions : _skinPoints.data();
+        const float4 *skinNormals = Skinned ? _skinnedNormals : _skinNormals.data();
+        float4 *positions = particles.positions.data();
+        const float *invMasses = particles.invMasses.data();
+
+        for (size_t base = begin; base < end; base += kLanes) {
+            const size_t lanes = std::min(kLanes, end - base);
+
+            // gather the offset of every particle from its skin point, padding the tail with massless ones.
+            alignas(32) float dx[kLanes], dy[kLanes], dz[kLanes], nx[kLanes], ny[kLanes], nz[kLanes];
+            alignas(32) float w[kLanes], radius[kLanes], sphereRadius[kLanes], backstop[kLanes];
+            alignas(32) float compliance[kLanes], lambda[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const size_t c = base + l;
+                    size_t s = c;
+                    if constexpr (Skinned) {
+                        s = _skinnedIndices != nullptr ? size_t(_skinnedIndices[c]) : c;
+                    }
+                    const float4 d = positions[indices[c]] - skinPoints[s];
+                    const float4 &n = skinNormals[s];
+                    dx[l] = d.x;
+                    dy[l] = d.y;
+                    dz[l] = d.z;
+                    nx[l] = n.x;
+                    ny[l] = n.y;
+                    nz[l] = n.z;
+                    w[l] = invMasses[indices[c]];
+                    radius[l] = _radiiBackstop[c * 3];
+                    sphereRadius[l] = _radiiBackstop[c * 3 + 1];
+                    backstop[l] = _radiiBackstop[c * 3 + 2];
+                    compliance[l] = _compliances[c];
+                    lambda[l] = _lambdas[c];
+                } else {
+                    dx[l] = dy[l] = dz[l] = nx[l] = ny[l] = nz[l] = 0;
+                    w[l] = sphereRadius[l] = backstop[l] = compliance[l] = lambda[l] = 0;
+                    radius[l] = 1;
+                }
+            }
+
+            alignas(32) float cx[kLanes], cy[kLanes], cz[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                // max distance: C = |d| - radius while positive, compliant and never pushing outwards.
+                const float len = std::sqrt(dx[l] * dx[l] + dy[l] * dy[l] + dz[l] * dz[l]);
+                const float alpha = compliance[l] / deltaTimeSqr;
+                float dlambda = (-(len - radius[l]) - alpha * lambda[l]) / (w[l] + alpha + kEpsilon);
+                dlambda = std::min(lambda[l] + dlambda, 0.f) - lambda[l];
+                lambda[l] += dlambda;
+                const float s = len > kEpsilon ? dlambda * w[l] / len : 0;
+                cx[l] = dx[l] * s;
+                cy[l] = dy[l] * s;
+                cz[l] = dz[l] * s;
+
+                // backstop: a hard constraint keeping the corrected particle out of the sphere whose surface
+                // lies `backstop` behind the skin point, along the normal.
+                const float offset = backstop[l] + sphereRadius[l];
+                const float ex = dx[l] + cx[l] + nx[l] * offset;
+                const float ey = dy[l] + cy[l] + ny[l] * offset;
+                const float ez = dz[l] + cz[l] + nz[l] * offset;
+                const float distance = std::sqrt(ex * ex + ey * ey + ez * ez);
+                const float depth = w[l] > 0 && distance > kEpsilon ? std::max(sphereRadius[l] - distance, 0.f) : 0;
+                const float push = depth / (distance + kEpsilon);
+                cx[l] += ex * push;
+                cy[l] += ey * push;
+                cz[l] += ez * push;
+            }
+
+            // scatter.
+            for (size_t l = 0; l < lanes; ++l) {
+                const size_t c = base + l;
+                const int32_t p = indices[c];
+                const float4 d(cx[l], cy[l], cz[l], 0);
+                _lambdas[c] = lambda[l];
+                if constexpr (InPlace) {
+                    positions[p] += d * sorFactor;
+                } else {
+                    particles.positionDeltas[p] += d;
+                    ++particles.positionConstraintCounts[p];
+                }
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,62 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+
+namespace vox::flex {
+    // Skin constraints keep each particle of a skinned cloth near its skinned position: within a compliant
+    // radius of the skin point, and outside a backstop sphere placed behind the skin along its normal so the
+    // cloth can't sink into the body it covers. Like tethers they are unilateral and move only their particle.
+    //
+    // Skin points and normals are either copied by setSkinConstraints or read straight from a skinned vertex
+    // buffer bound with bindSkinnedVertices, which saves copying the whole skinned mesh into the batch every
+    // frame. Constraints of a batch share no particle.
+    class SkinConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+
+        // `radiiBackstop` holds 3 floats per constraint: the radius the particle may move from its skin point,
+        // the backstop sphere radius and the backstop distance of the sphere's surface behind the skin.
+        // `stiffnesses` are compliances, lambdas may be null.
+        void setSkinConstraints(const int32_t *particleIndices, const float4 *skinPoints, const float4 *skinNormals,
+                                const float *radiiBackstop, const float *stiffnesses, const float *lambdas,
+                                size_t count);
+
+        // Reads skin points and normals of constraint c from positions[vertexIndices[c]] and
+        // normals[vertexIndices[c]] (or [c] when `vertexIndices` is null) instead of the copied ones, until
+        // rebound or unbound with null positions. The buffers are borrowed, in solver space, and must stay
+        // alive and unchanged while the solver steps.
+        void bindSkinnedVertices(const float4 *positions, const float4 *normals, const int32_t *vertexIndices);
+
+        size_t constraintCount() const override { return _particleIndices.size(); }
+
+        const AlignedVector<float> &lambdas() const { return _lambdas; }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        template <bool InPlace, bool Skinned>
+        void project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr, float sorFactor);
+
+        AlignedVector<int32_t> _particleIndices;
+        AlignedVector<float4> _skinPoints;
+        AlignedVector<float4> _skinNormals;
+        AlignedVector<float> _radiiBackstop;
+        AlignedVector<float> _compliances;
+        AlignedVector<float> _lambdas;
+
+        const float4 *_skinnedPositions = nullptr;
+        const float4 *_skinnedNormals = nullptr;
+        const int32_t *_skinnedIndices = nullptr;
+    };
+} // namespace vox::flex
@@ -0,0 +1,31 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// XPBD stretch / shear constraints of Cosserat rods, see StretchShearConstraintsBatch.
+@interface CStretchShearConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// Two particle indices and one orientation index per constraint. Stiffnesses are three compliances per constraint,
+/// shear along the first two material axes and stretch along the third. Lambdas (three per constraint) may be null.
+- (void)setStretchShearConstraints:(const int32_t *_Nonnull)particleIndices
+                orientationIndices:(const int32_t *_Nonnull)orientationIndices
+                       restLengths:(const float *_Nonnull)restLengths
+                  restOrientations:(const simd_quatf *_Nonnull)restOrientations
+                       stiffnesses:(const float *_Nonnull)stiffnesses
+                           lambdas:(const float *_Nullable)lambdas
+                             count:(uint32_t)count;
+
+/// Accumulated XPBD multipliers of the current substep, three per constraint.
+- (void)getLambdas:(float *_Nonnull)lambdas;
+
+@end
@@ -0,0 +1,48 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CStretchShearConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "StretchShearConstraintsBatch.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+static_assert(sizeof(quaternion) == sizeof(simd_quatf), "quaternion must match simd_quatf layout");
+
+@implementation CStretchShearConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::StretchShear
+                           batch:std::make_unique<StretchShearConstraintsBatch>()];
+}
+
+- (StretchShearConstraintsBatch *)stretchShearBatch {
+    return static_cast<StretchShearConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setStretchShearConstraints:(const int32_t *)particleIndices
+                orientationIndices:(const int32_t *)orientationIndices
+                       restLengths:(const float *)restLengths
+                  restOrientations:(const simd_quatf *)restOrientations
+                       stiffnesses:(const float *)stiffnesses
+                           lambdas:(const float *)lambdas
+                             count:(uint32_t)count {
+    if (auto *batch = [self stretchShearBatch]) {
+        batch->setStretchShearConstraints(particleIndices, orientationIndices, restLengths,
+                                          reinterpret_cast<const quaternion *>(restOrientations), stiffnesses,
+                                          lambdas, count);
+    }
+}
+
+- (void)getLambdas:(float *)lambdas {
+    if (auto *batch = [self stretchShearBatch]) {
+        std::copy(batch->lambdas().begin(), batch->lambdas().end(), lambdas);
+    }
+}
+
+@end
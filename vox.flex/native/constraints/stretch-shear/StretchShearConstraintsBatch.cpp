@@ -0,0 +1,178 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "StretchShearConstraintsBatch.h"
+#include "../../common/Parallel.h"
+#include "../../common/QuaternionLanes.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kGroupGrain = 32;
+        constexpr float kEpsilon = 1e-7f;
+    } // namespace
+
+    void StretchShearConstraintsBatch::setStretchShearConstraints(const int32_t *particleIndices,
+                                                                  const int32_t *orientationIndices,
+                                                                  const float *restLengths,
+                                                                  const quaternion *restOrientations,
+                                                                  const float *stiffnesses, const float *lambdas,
+                                                                  size_t count) {
+        _particleIndices.assign(particleIndices, particleIndices + count * 2);
+        _orientationIndices.assign(orientationIndices, orientationIndices + count);
+        _restLengths.assign(restLengths, restLengths + count);
+        _restOrientations.assign(restOrientations, restOrientations + count);
+        _compliances.assign(stiffnesses, stiffnesses + count * 3);
+        if (lambdas != nullptr) {
+            _lambdas.assign(lambdas, lambdas + count * 3);
+        } else {
+            _lambdas.assign(count * 3, 0.f);
+        }
+    }
+
+    void StretchShearConstraintsBatch::initialize(ParticleData &, float) {
+        std::fill(_lambdas.begin(), _lambdas.end(), 0.f);
+    }
+
+    void StretchShearConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &parameters,
+                                                float, float substepTime, int) {
+        const size_t count = constraintCount();
+        const size_t groupCount = (count + kLanes - 1) / kLanes;
+        const float deltaTimeSqr = substepTime * substepTime;
+        const bool inPlace = parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Sequential;
+        const float sorFactor = parameters.SORFactor;
+        parallelFor(0, groupCount, kGroupGrain, [&](size_t begin, size_t end) {
+            if (inPlace) {
+                project<true>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            } else {
+                project<false>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            }
+        });
+    }
+
+    void StretchShearConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters,
+                                             float) {
+        if (parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Parallel) {
+            applyPositionDeltas(particles, _particleIndices.data(), _particleIndices.size(), parameters.SORFactor);
+            applyOrientationDeltas(particles, _orientationIndices.data(), _orientationIndices.size(),
+                                   parameters.SORFactor);
+        }
+    }
+
+    template <bool InPlace>
+    void StretchShearConstraintsBatch::project(ParticleData &particles, size_t begin, size_t end,
+                                               float deltaTimeSqr, float sorFactor) {
+        const int32_t *indices = _particleIndices.data();
+        const int32_t *orientationIndices = _orientationIndices.data();
+        float4 *positions = particles.positions.data();
+        quaternion *orientations = particles.orientations.data();
+        const float *invMasses = particles.invMasses.data();
+        const float *invRotationalMasses = particles.invRotationalMasses.data();
+
+        for (size_t base = begin; base < end; base += kLanes) {
+            const size_t lanes = std::min(kLanes, end - base);
+
+            // gather, padding the tail of the last group with massless constraints at rest.
+            QuaternionLanes<kLanes> orientation, rest;
+            VectorLanes<kLanes> segment, compliance, lambda;
+            alignas(32) float w1[kLanes], w2[kLanes], wq[kLanes], restLength[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const size_t c = base + l;
+                    const int32_t p1 = indices[c * 2];
+                    const int32_t p2 = indices[c * 2 + 1];
+                    const int32_t q = orientationIndices[c];
+                    segment.set(l, (positions[p2] - positions[p1]).xyz());
+                    orientation.set(l, orientations[q]);
+                    rest.set(l, _restOrientations[c]);
+                    compliance.set(l, float3(_compliances[c * 3], _compliances[c * 3 + 1], _compliances[c * 3 + 2]));
+                    lambda.set(l, float3(_lambdas[c * 3], _lambdas[c * 3 + 1], _lambdas[c * 3 + 2]));
+                    w1[l] = invMasses[p1];
+                    w2[l] = invMasses[p2];
+                    wq[l] = invRotationalMasses[q];
+                    restLength[l] = _restLengths[c];
+                } else {
+                    segment.set(l, float3(0, 0, 1));
+                    orientation.set(l, quaternion());
+                    rest.set(l, quaternion());
+                    compliance.set(l, float3());
+                    lambda.set(l, float3());
+                    w1[l] = w2[l] = wq[l] = 0;
+                    restLength[l] = 1;
+                }
+            }
+
+            // material frame q r, its third axis d3 and the constraint C = (p2 - p1) - l d3.
+            QuaternionLanes<kLanes> frame;
+            multiply(orientation, rest, frame);
+            VectorLanes<kLanes> constraint;
+            for (size_t l = 0; l < kLanes; ++l) {
+                const float d3x = 2 * (frame.x[l] * frame.z[l] + frame.w[l] * frame.y[l]);
+                const float d3y = 2 * (frame.y[l] * frame.z[l] - frame.w[l] * frame.x[l]);
+                const float d3z = 1 - 2 * (frame.x[l] * frame.x[l] + frame.y[l] * frame.y[l]);
+                constraint.x[l] = segment.x[l] - restLength[l] * d3x;
+                constraint.y[l] = segment.y[l] - restLength[l] * d3y;
+                constraint.z[l] = segment.z[l] - restLength[l] * d3z;
+            }
+
+            // solve along the frame's axes: dlambda = (-C - alpha * lambda) / (w1 + w2 + 4 wq l^2 + alpha).
+            VectorLanes<kLanes> local, dlambda;
+            rotate<true>(frame, constraint, local);
+            for (size_t l = 0; l < kLanes; ++l) {
+                const float w = w1[l] + w2[l] + 4 * wq[l] * restLength[l] * restLength[l] + kEpsilon;
+                const float ax = compliance.x[l] / deltaTimeSqr;
+                const float ay = compliance.y[l] / deltaTimeSqr;
+                const float az = compliance.z[l] / deltaTimeSqr;
+                local.x[l] = (-local.x[l] - ax * lambda.x[l]) / (w + ax);
+                local.y[l] = (-local.y[l] - ay * lambda.y[l]) / (w + ay);
+                local.z[l] = (-local.z[l] - az * lambda.z[l]) / (w + az);
+            }
+            rotate(frame, local, dlambda);
+
+            // frame correction -2 wq l (dlambda, 0) (q r) e3*, moved onto q by right-multiplying r*.
+            QuaternionLanes<kLanes> frameAxis, product, delta;
+            VectorLanes<kLanes> scaled;
+            for (size_t l = 0; l < kLanes; ++l) {
+                // (q r) e3*, e3* = (0, 0, -1, 0).
+                frameAxis.x[l] = -frame.y[l];
+                frameAxis.y[l] = frame.x[l];
+                frameAxis.z[l] = -frame.w[l];
+                frameAxis.w[l] = frame.z[l];
+                const float s = -2 * wq[l] * restLength[l];
+                scaled.x[l] = dlambda.x[l] * s;
+                scaled.y[l] = dlambda.y[l] * s;
+                scaled.z[l] = dlambda.z[l] * s;
+            }
+            multiply(scaled, frameAxis, product);
+            multiply<false, true>(product, rest, delta);
+
+            // scatter.
+            for (size_t l = 0; l < lanes; ++l) {
+                const size_t c = base + l;
+                const int32_t p1 = indices[c * 2];
+                const int32_t p2 = indices[c * 2 + 1];
+                const int32_t q = orientationIndices[c];
+                const float4 d(dlambda.x[l], dlambda.y[l], dlambda.z[l], 0);
+                _lambdas[c * 3] += local.x[l];
+                _lambdas[c * 3 + 1] += local.y[l];
+                _lambdas[c * 3 + 2] += local.z[l];
+                if constexpr (InPlace) {
+                    positions[p1] -= d * (w1[l] * sorFactor);
+                    positions[p2] += d * (w2[l] * sorFactor);
+                    orientations[q] = normalize(orientations[q] + delta.get(l) * sorFactor);
+                } else {
+                    particles.positionDeltas[p1] -= d * w1[l];
+                    particles.positionDeltas[p2] += d * w2[l];
+                    particles.orientationDeltas[q] = particles.orientationDeltas[q] + delta.get(l);
+                    ++particles.positionConstraintCounts[p1];
+                    ++particles.positionConstraintCounts[p2];
+                    ++particles.orientationConstraintCounts[q];
+                }
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,53 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+
+namespace vox::flex {
+    // XPBD stretch / shear constraints of Cosserat rods (Kugelstadt and Schömer 2016): each couples the two
+    // particles of a rod segment with the orientation of its material frame, keeping the segment as long as its
+    // rest length and aligned with the frame's third axis. Compliances apply along the frame's axes: the first
+    // two resist shear, the third stretch.
+    //
+    // Constraints are projected kLanes at a time like distance constraints, with the quaternion products of a
+    // group done lane-wise. Sequential evaluation writes straight to positions and orientations, parallel
+    // evaluation accumulates into the particle deltas for `apply` to average.
+    class StretchShearConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+
+        // Two particles and one orientation per constraint. `restOrientations` rotate the frame's third axis
+        // onto the segment at rest, `stiffnesses` are 3 compliances per constraint. Lambdas (3 per constraint)
+        // may be null.
+        void setStretchShearConstraints(const int32_t *particleIndices, const int32_t *orientationIndices,
+                                        const float *restLengths, const quaternion *restOrientations,
+                                        const float *stiffnesses, const float *lambdas, size_t count);
+
+        size_t constraintCount() const override { return _restLengths.size(); }
+
+        const AlignedVector<float> &lambdas() const { return _lambdas; }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        template <bool InPlace>
+        void project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr, float sorFactor);
+
+        AlignedVector<int32_t> _particleIndices;
+        AlignedVector<int32_t> _orientationIndices;
+        AlignedVector<float> _restLengths;
+        AlignedVector<quaternion> _restOrientations;
+        AlignedVector<float> _compliances;
+        AlignedVector<float> _lambdas;
+    };
+} // namespace vox::flex
@@ -0,0 +1,30 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+/// Geodesic tether anchors of a blueprint, see TetherAnchors.h.
+@interface CTetherAnchors : NSObject
+
+/// `edges` holds (a, b) particle pairs. Returns the number of tethers, grouped by island of fixed particles.
+- (uint32_t)buildWithPositions:(const simd_float4 *_Nonnull)positions
+                     invMasses:(const float *_Nonnull)invMasses
+                 particleCount:(uint32_t)particleCount
+                         edges:(const int32_t *_Nonnull)edges
+                     edgeCount:(uint32_t)edgeCount;
+
+@property(nonatomic, readonly) uint32_t islandCount;
+
+/// (particle, anchor) pairs and the geodesic distance of every tether of the last build.
+- (void)getTethers:(int32_t *_Nonnull)tethers distances:(float *_Nonnull)distances;
+
+/// islandCount + 1 offsets: the tethers of island i are [offsets[i], offsets[i + 1]).
+- (void)getIslandOffsets:(int32_t *_Nonnull)offsets;
+
+@end
@@ -0,0 +1,41 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CTetherAnchors.h"
+#include "TetherAnchors.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+static_assert(sizeof(float4) == sizeof(simd_float4), "float4 must match simd_float4 layout");
+
+@implementation CTetherAnchors {
+    TetherAnchors _anchors;
+}
+
+- (uint32_t)buildWithPositions:(const simd_float4 *)positions
+                     invMasses:(const float *)invMasses
+                 particleCount:(uint32_t)particleCount
+                         edges:(const int32_t *)edges
+                     edgeCount:(uint32_t)edgeCount {
+    return uint32_t(_anchors.build(reinterpret_cast<const float4 *>(positions), invMasses, particleCount, edges,
+                                   edgeCount));
+}
+
+- (uint32_t)islandCount {
+    return uint32_t(_anchors.islandCount());
+}
+
+- (void)getTethers:(int32_t *)tethers distances:(float *)distances {
+    std::copy(_anchors.tethers().begin(), _anchors.tethers().end(), tethers);
+    std::copy(_anchors.distances().begin(), _anchors.distances().end(), distances);
+}
+
+- (void)getIslandOffsets:(int32_t *)offsets {
+    std::copy(_anchors.islandOffsets().begin(), _anchors.islandOffsets().end(), offsets);
+}
+
+@end
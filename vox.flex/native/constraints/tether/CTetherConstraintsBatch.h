@@ -0,0 +1,29 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// Unilateral long range attachments, see TetherConstraintsBatch.
+@interface CTetherConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// (particle, anchor) pairs; maxLengthScale holds the (max length, scale) of every tether and stiffnesses their
+/// compliances. Lambdas may be null.
+- (void)setTetherConstraints:(const int32_t *_Nonnull)particleIndices
+              maxLengthScale:(const simd_float2 *_Nonnull)maxLengthScale
+                 stiffnesses:(const float *_Nonnull)stiffnesses
+                     lambdas:(const float *_Nullable)lambdas
+                       count:(uint32_t)count;
+
+/// Accumulated XPBD multipliers of the current substep.
+- (void)getLambdas:(float *_Nonnull)lambdas;
+
+@end
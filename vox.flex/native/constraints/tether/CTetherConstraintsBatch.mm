@@ -0,0 +1,43 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CTetherConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "TetherConstraintsBatch.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+@implementation CTetherConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::Tether
+                           batch:std::make_unique<TetherConstraintsBatch>()];
+}
+
+- (TetherConstraintsBatch *)tetherBatch {
+    return static_cast<TetherConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setTetherConstraints:(const int32_t *)particleIndices
+              maxLengthScale:(const simd_float2 *)maxLengthScale
+                 stiffnesses:(const float *)stiffnesses
+                     lambdas:(const float *)lambdas
+                       count:(uint32_t)count {
+    if (auto *batch = [self tetherBatch]) {
+        batch->setTetherConstraints(particleIndices, reinterpret_cast<const float *>(maxLengthScale), stiffnesses,
+                                    lambdas, count);
+    }
+}
+
+- (void)getLambdas:(float *)lambdas {
+    if (auto *batch = [self tetherBatch]) {
+        std::copy(batch->lambdas().begin(), batch->lambdas().end(), lambdas);
+    }
+}
+
+@end
@@ -0,0 +1,131 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "TetherAnchors.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+namespace vox::flex {
+    namespace {
+        int32_t findRoot(std::vector<int32_t> &parents, int32_t i) {
+            while (parents[i] != i) {
+                parents[i] = parents[parents[i]];
+                i = parents[i];
+            }
+            return i;
+        }
+    } // namespace
+
+    size_t TetherAnchors::build(const float4 *positions, const float *invMasses, size_t particleCount,
+                                const int32_t *edges, size_t edgeCount) {
+        _tethers.clear();
+        _distances.clear();
+        _islandOffsets.clear();
+
+        // adjacency (CSR) over both directions of every edge.
+        std::vector<int32_t> offsets(particleCount + 1, 0);
+        for (size_t e = 0; e < edgeCount * 2; ++e) {
+            ++offsets[edges[e] + 1];
+        }
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<int32_t> neighbors(edgeCount * 2);
+        std::vector<float> weights(edgeCount * 2);
+        {
+            std::vector<int32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t e = 0; e < edgeCount; ++e) {
+                const int32_t a = edges[e * 2], b = edges[e * 2 + 1];
+                const float length = vox::flex::length((positions[a] - positions[b]).xyz());
+                neighbors[cursor[a]] = b;
+                weights[cursor[a]++] = length;
+                neighbors[cursor[b]] = a;
+                weights[cursor[b]++] = length;
+            }
+        }
+
+        // islands of fixed particles joined by edges.
+        std::vector<int32_t> parents(particleCount);
+        std::iota(parents.begin(), parents.end(), 0);
+        for (size_t e = 0; e < edgeCount; ++e) {
+            const int32_t a = edges[e * 2], b = edges[e * 2 + 1];
+            if (invMasses[a] <= 0 && invMasses[b] <= 0) {
+                parents[findRoot(parents, a)] = findRoot(parents, b);
+            }
+        }
+        std::vector<std::vector<int32_t>> islands;
+        std::vector<int32_t> islandOfRoot(particleCount, -1);
+        for (size_t i = 0; i < particleCount; ++i) {
+            // fixed particles with no edge can't anchor anything.
+            if (invMasses[i] > 0 || offsets[i] == offsets[i + 1]) {
+                continue;
+            }
+            const int32_t root = findRoot(parents, int32_t(i));
+            if (islandOfRoot[root] < 0) {
+                islandOfRoot[root] = int32_t(islands.size());
+                islands.emplace_back();
+            }
+            islands[islandOfRoot[root]].push_back(int32_t(i));
+        }
+
+        // one multi-source Dijkstra per island, recording for every particle the source it was reached from.
+        struct Tether {
+            int32_t particle, anchor;
+            float distance;
+        };
+        std::vector<std::vector<Tether>> results(islands.size());
+        parallelFor(0, islands.size(), 1, [&](size_t begin, size_t end) {
+            std::vector<float> distances(particleCount);
+            std::vector<int32_t> sources(particleCount);
+            using Entry = std::pair<float, int32_t>;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+            for (size_t island = begin; island < end; ++island) {
+                std::fill(distances.begin(), distances.end(), std::numeric_limits<float>::infinity());
+                for (int32_t source : islands[island]) {
+                    distances[source] = 0;
+                    sources[source] = source;
+                    queue.emplace(0.f, source);
+                }
+                while (!queue.empty()) {
+                    const auto [distance, i] = queue.top();
+                    queue.pop();
+                    if (distance > distances[i]) {
+                        continue;
+                    }
+                    for (int32_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                        const int32_t j = neighbors[k];
+                        const float candidate = distance + weights[k];
+                        if (candidate < distances[j]) {
+                            distances[j] = candidate;
+                            sources[j] = sources[i];
+                            queue.emplace(candidate, j);
+                        }
+                    }
+                }
+                for (size_t i = 0; i < particleCount; ++i) {
+                    if (invMasses[i] > 0 && distances[i] < std::numeric_limits<float>::infinity()) {
+                        results[island].push_back({int32_t(i), sources[i], distances[i]});
+                    }
+                }
+            }
+        });
+
+        _islandOffsets.push_back(0);
+        for (const auto &island : results) {
+            for (const Tether &tether : island) {
+                _tethers.push_back(tether.particle);
+                _tethers.push_back(tether.anchor);
+                _distances.push_back(tether.distance);
+            }
+            _islandOffsets.push_back(int32_t(_distances.size()));
+        }
+        return _distances.size();
+    }
+} // namespace vox::flex
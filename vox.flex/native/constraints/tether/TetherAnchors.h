@@ -0,0 +1,46 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/AlignedVector.h"
+#include "../../common/Math.h"
+
+namespace vox::flex {
+    // Tether anchor tables, built once per blueprint. Fixed particles (zero inverse mass) joined by edges form
+    // islands; every dynamic particle connected to an island gets one tether to the island's particle closest
+    // to it along the edges, with that geodesic distance as its maximum length. Geodesic rather than straight
+    // distances let cloth fold and drape freely while still bounding how far it can stretch from where it
+    // hangs.
+    //
+    // Islands are searched in parallel with one multi-source Dijkstra each. Tethers are sorted by island, and
+    // the tethers of one island share no tethered particle, so each island is a ready-made batch.
+    class TetherAnchors {
+    public:
+        // `edges` holds (a, b) pairs, weighted by the distance between their positions. Returns the number of
+        // tethers.
+        size_t build(const float4 *positions, const float *invMasses, size_t particleCount, const int32_t *edges,
+                     size_t edgeCount);
+
+        size_t tetherCount() const { return _distances.size(); }
+
+        size_t islandCount() const { return _islandOffsets.empty() ? 0 : _islandOffsets.size() - 1; }
+
+        // (particle, anchor) pairs.
+        const AlignedVector<int32_t> &tethers() const { return _tethers; }
+
+        // geodesic distance from every tethered particle to its anchor.
+        const AlignedVector<float> &distances() const { return _distances; }
+
+        // tethers of island i are [islandOffsets[i], islandOffsets[i + 1]).
+        const AlignedVector<int32_t> &islandOffsets() const { return _islandOffsets; }
+
+    private:
+        AlignedVector<int32_t> _tethers;
+        AlignedVector<float> _distances;
+        AlignedVector<int32_t> _islandOffsets;
+    };
+} // namespace vox::flex
@@ -0,0 +1,121 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "TetherConstraintsBatch.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kGroupGrain = 32;
+        constexpr float kEpsilon = 1e-7f;
+    } // namespace
+
+    void TetherConstraintsBatch::setTetherConstraints(const int32_t *particleIndices, const float *maxLengthScale,
+                                                      const float *stiffnesses, const float *lambdas,
+                                                      size_t count) {
+        _particleIndices.assign(particleIndices, particleIndices + count * 2);
+        _particles.resize(count);
+        _maxLengths.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            _particles[i] = particleIndices[i * 2];
+            _maxLengths[i] = maxLengthScale[i * 2] * maxLengthScale[i * 2 + 1];
+        }
+        _compliances.assign(stiffnesses, stiffnesses + count);
+        if (lambdas != nullptr) {
+            _lambdas.assign(lambdas, lambdas + count);
+        } else {
+            _lambdas.assign(count, 0.f);
+        }
+    }
+
+    void TetherConstraintsBatch::initialize(ParticleData &, float) {
+        std::fill(_lambdas.begin(), _lambdas.end(), 0.f);
+    }
+
+    void TetherConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &parameters, float,
+                                          float substepTime, int) {
+        const size_t count = constraintCount();
+        const size_t groupCount = (count + kLanes - 1) / kLanes;
+        const float deltaTimeSqr = substepTime * substepTime;
+        const bool inPlace = parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Sequential;
+        const float sorFactor = parameters.SORFactor;
+        parallelFor(0, groupCount, kGroupGrain, [&](size_t begin, size_t end) {
+            if (inPlace) {
+                project<true>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            } else {
+                project<false>(particles, begin * kLanes, std::min(count, end * kLanes), deltaTimeSqr, sorFactor);
+            }
+        });
+    }
+
+    void TetherConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters, float) {
+        if (parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Parallel) {
+            applyPositionDeltas(particles, _particles.data(), _particles.size(), parameters.SORFactor);
+        }
+    }
+
+    template <bool InPlace>
+    void TetherConstraintsBatch::project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr,
+                                         float sorFactor) {
+        const int32_t *indices = _particleIndices.data();
+        float4 *positions = particles.positions.data();
+        const float *invMasses = particles.invMasses.data();
+
+        for (size_t base = begin; base < end; base += kLanes) {
+            const size_t lanes = std::min(kLanes, end - base);
+
+            // gather, padding the tail of the last group with slack massless tethers.
+            alignas(32) float dx[kLanes], dy[kLanes], dz[kLanes];
+            alignas(32) float w[kLanes], maxLength[kLanes], compliance[kLanes], lambda[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const size_t c = base + l;
+                    const float4 d = positions[indices[c * 2]] - positions[indices[c * 2 + 1]];
+                    dx[l] = d.x;
+                    dy[l] = d.y;
+                    dz[l] = d.z;
+                    w[l] = invMasses[indices[c * 2]];
+                    maxLength[l] = _maxLengths[c];
+                    compliance[l] = _compliances[c];
+                    lambda[l] = _lambdas[c];
+                } else {
+                    dx[l] = dy[l] = dz[l] = w[l] = compliance[l] = lambda[l] = 0;
+                    maxLength[l] = 1;
+                }
+            }
+
+            // C = |d| - max length while positive. The accumulated lambda never turns positive, so a tether
+            // relaxing within an iteration gives back what it pulled but never pushes.
+            alignas(32) float scale[kLanes];
+            for (size_t l = 0; l < kLanes; ++l) {
+                const float len = std::sqrt(dx[l] * dx[l] + dy[l] * dy[l] + dz[l] * dz[l]);
+                const float constraint = len - maxLength[l];
+                const float alpha = compliance[l] / deltaTimeSqr;
+                float dlambda = (-constraint - alpha * lambda[l]) / (w[l] + alpha + kEpsilon);
+                dlambda = std::min(lambda[l] + dlambda, 0.f) - lambda[l];
+                lambda[l] += dlambda;
+                scale[l] = len > kEpsilon ? dlambda * w[l] / len : 0;
+            }
+
+            // scatter.
+            for (size_t l = 0; l < lanes; ++l) {
+                const size_t c = base + l;
+                const int32_t p = indices[c * 2];
+                const float4 d(dx[l] * scale[l], dy[l] * scale[l], dz[l] * scale[l], 0);
+                _lambdas[c] = lambda[l];
+                if constexpr (InPlace) {
+                    positions[p] += d * sorFactor;
+                } else {
+                    particles.positionDeltas[p] += d;
+                    ++particles.positionConstraintCounts[p];
+                }
+            }
+        }
+    }
+} // namespace vox::flex
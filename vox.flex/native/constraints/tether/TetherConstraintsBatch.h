@@ -0,0 +1,50 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+
+namespace vox::flex {
+    // Long range attachments (Kim et al. 2012): each tether keeps a particle within its maximum distance of an
+    // anchor, usually the geodesic distance to a fixed particle found by TetherAnchors. Tethers are unilateral,
+    // pulling only while stretched, and move only the tethered particle, so a single pass bounds the stretch of
+    // a whole cloth however few iterations its other constraints get.
+    //
+    // Projected kLanes at a time in place or accumulated like DistanceConstraintsBatch. Tethers of a batch may
+    // share anchors but not tethered particles.
+    class TetherConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+
+        // (particle, anchor) pairs; `maxLengthScale` holds (max length, scale) per tether, the particle may get
+        // as far as their product from its anchor. `stiffnesses` are compliances, lambdas may be null.
+        void setTetherConstraints(const int32_t *particleIndices, const float *maxLengthScale,
+                                  const float *stiffnesses, const float *lambdas, size_t count);
+
+        size_t constraintCount() const override { return _maxLengths.size(); }
+
+        const AlignedVector<float> &lambdas() const { return _lambdas; }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        template <bool InPlace>
+        void project(ParticleData &particles, size_t begin, size_t end, float deltaTimeSqr, float sorFactor);
+
+        AlignedVector<int32_t> _particleIndices;
+        // tethered particles alone, for apply.
+        AlignedVector<int32_t> _particles;
+        AlignedVector<float> _maxLengths;
+        AlignedVector<float> _compliances;
+        AlignedVector<float> _lambdas;
+    };
+} // namespace vox::flex
@@ -0,0 +1,34 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "../../solver/CConstraintsBatch.h"
+#import "../../solver/CSolverImpl.h"
+#import <simd/simd.h>
+
+/// Volume preservation of closed meshes, see VolumeConstraintsBatch.
+@interface CVolumeConstraintsBatch : CConstraintsBatch
+
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver;
+
+/// Mesh i owns triangles[firstTriangle[i] ..< firstTriangle[i] + numTriangles[i]], 3 particle indices each.
+/// pressureStiffness holds the (pressure, compliance) of every mesh. Lambdas may be null.
+- (void)setVolumeConstraints:(const int32_t *_Nonnull)triangles
+               firstTriangle:(const int32_t *_Nonnull)firstTriangle
+                numTriangles:(const int32_t *_Nonnull)numTriangles
+                 restVolumes:(const float *_Nonnull)restVolumes
+           pressureStiffness:(const simd_float2 *_Nonnull)pressureStiffness
+                     lambdas:(const float *_Nullable)lambdas
+                       count:(uint32_t)count;
+
+/// Accumulated XPBD multipliers of the current substep.
+- (void)getLambdas:(float *_Nonnull)lambdas;
+
+/// Meshes' volumes as of the last iteration.
+- (void)getVolumes:(float *_Nonnull)volumes;
+
+@end
@@ -0,0 +1,51 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CVolumeConstraintsBatch.h"
+#import "../../solver/CConstraintsBatchInternal.h"
+#include "VolumeConstraintsBatch.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+@implementation CVolumeConstraintsBatch
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver {
+    return [super initWithSolver:solver
+                            type:ConstraintType::Volume
+                           batch:std::make_unique<VolumeConstraintsBatch>()];
+}
+
+- (VolumeConstraintsBatch *)volumeBatch {
+    return static_cast<VolumeConstraintsBatch *>([self nativeBatch]);
+}
+
+- (void)setVolumeConstraints:(const int32_t *)triangles
+               firstTriangle:(const int32_t *)firstTriangle
+                numTriangles:(const int32_t *)numTriangles
+                 restVolumes:(const float *)restVolumes
+           pressureStiffness:(const simd_float2 *)pressureStiffness
+                     lambdas:(const float *)lambdas
+                       count:(uint32_t)count {
+    if (auto *batch = [self volumeBatch]) {
+        batch->setVolumeConstraints(triangles, firstTriangle, numTriangles, restVolumes,
+                                    reinterpret_cast<const float *>(pressureStiffness), lambdas, count);
+    }
+}
+
+- (void)getLambdas:(float *)lambdas {
+    if (auto *batch = [self volumeBatch]) {
+        std::copy(batch->lambdas().begin(), batch->lambdas().end(), lambdas);
+    }
+}
+
+- (void)getVolumes:(float *)volumes {
+    if (auto *batch = [self volumeBatch]) {
+        std::copy(batch->volumes().begin(), batch->volumes().end(), volumes);
+    }
+}
+
+@end
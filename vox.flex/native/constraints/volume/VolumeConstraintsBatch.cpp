@@ -0,0 +1,239 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "VolumeConstraintsBatch.h"
+#include "../../common/Parallel.h"
+#include "../../common/QuaternionLanes.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kBlockGrain = 4;
+        constexpr size_t kMeshGrain = 64;
+        constexpr float kEpsilon = 1e-7f;
+    } // namespace
+
+    void VolumeConstraintsBatch::setVolumeConstraints(const int32_t *triangles, const int32_t *firstTriangle,
+                                                      const int32_t *numTriangles, const float *restVolumes,
+                                                      const float *pressureStiffness, const float *lambdas,
+                                                      size_t count) {
+        _restVolumes.assign(restVolumes, restVolumes + count);
+        _pressureStiffness.assign(pressureStiffness, pressureStiffness + count * 2);
+        if (lambdas != nullptr) {
+            _lambdas.assign(lambdas, lambdas + count);
+        } else {
+            _lambdas.assign(count, 0.f);
+        }
+        _volumes.assign(count, 0.f);
+        _dlambdas.assign(count, 0.f);
+
+        // triangles are copied in mesh order, so the triangles of a mesh are contiguous.
+        _triangleOffsets.resize(count + 1);
+        _triangleOffsets[0] = 0;
+        for (size_t i = 0; i < count; ++i) {
+            _triangleOffsets[i + 1] = _triangleOffsets[i] + numTriangles[i];
+        }
+        _triangles.resize(size_t(_triangleOffsets[count]) * 3);
+        for (size_t i = 0; i < count; ++i) {
+            std::copy(triangles + size_t(firstTriangle[i]) * 3,
+                      triangles + size_t(firstTriangle[i] + numTriangles[i]) * 3,
+                      _triangles.begin() + _triangleOffsets[i] * 3);
+        }
+        _cornerGradients.assign(_triangles.size(), float4());
+
+        // distinct particles of every mesh and their corners: (particle, corner) keys sorted per mesh.
+        std::vector<uint64_t> keys(_triangles.size());
+        for (size_t corner = 0; corner < _triangles.size(); ++corner) {
+            keys[corner] = uint64_t(uint32_t(_triangles[corner])) << 32 | uint32_t(corner);
+        }
+        _particles.clear();
+        _cornerOffsets.assign(1, 0);
+        _corners.resize(_triangles.size());
+        AlignedVector<int32_t> particleOffsets(count + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            const auto first = keys.begin() + _triangleOffsets[i] * 3;
+            const auto last = keys.begin() + _triangleOffsets[i + 1] * 3;
+            std::sort(first, last);
+            for (auto key = first; key != last; ++key) {
+                const auto particle = int32_t(*key >> 32);
+                if (key == first || particle != int32_t(*(key - 1) >> 32)) {
+                    _particles.push_back(particle);
+                    _cornerOffsets.push_back(_cornerOffsets.back());
+                }
+                _corners[size_t(_cornerOffsets.back())] = int32_t(*key & 0xffffffffu);
+                ++_cornerOffsets.back();
+            }
+            particleOffsets[i + 1] = int32_t(_particles.size());
+        }
+        _gradients.assign(_particles.size(), float4());
+
+        _triangleBlocks.clear();
+        _particleBlocks.clear();
+        _triangleBlockOffsets.resize(count + 1);
+        _particleBlockOffsets.resize(count + 1);
+        for (size_t i = 0; i < count; ++i) {
+            _triangleBlockOffsets[i] = int32_t(_triangleBlocks.size());
+            _particleBlockOffsets[i] = int32_t(_particleBlocks.size());
+            appendBlocks(_triangleBlocks, int32_t(i), _triangleOffsets[i], _triangleOffsets[i + 1]);
+            appendBlocks(_particleBlocks, int32_t(i), particleOffsets[i], particleOffsets[i + 1]);
+        }
+        _triangleBlockOffsets[count] = int32_t(_triangleBlocks.size());
+        _particleBlockOffsets[count] = int32_t(_particleBlocks.size());
+        _blockVolumes.assign(_triangleBlocks.size(), 0.f);
+        _blockDenominators.assign(_particleBlocks.size(), 0.f);
+    }
+
+    void VolumeConstraintsBatch::appendBlocks(std::vector<Block> &blocks, int32_t constraint, int32_t begin,
+                                              int32_t end) {
+        for (int32_t b = begin; b < end; b += int32_t(kBlockSize)) {
+            blocks.push_back({constraint, b, std::min(end, b + int32_t(kBlockSize))});
+        }
+    }
+
+    void VolumeConstraintsBatch::initialize(ParticleData &, float) {
+        std::fill(_lambdas.begin(), _lambdas.end(), 0.f);
+    }
+
+    void VolumeConstraintsBatch::evaluate(ParticleData &particles, const ConstraintParameters &parameters, float,
+                                          float substepTime, int) {
+        const float deltaTimeSqr = substepTime * substepTime;
+
+        // first level: triangles.
+        parallelFor(0, _triangleBlocks.size(), kBlockGrain, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                reduceTriangles(particles, b);
+            }
+        });
+
+        // gradients of the meshes' particles, summed over their corners in corner order.
+        const float *invMasses = particles.invMasses.data();
+        parallelFor(0, _particleBlocks.size(), kBlockGrain, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                const Block &block = _particleBlocks[b];
+                float denominator = 0;
+                for (int32_t k = block.begin; k < block.end; ++k) {
+                    float4 gradient;
+                    for (int32_t c = _cornerOffsets[k]; c < _cornerOffsets[k + 1]; ++c) {
+                        gradient += _cornerGradients[_corners[c]];
+                    }
+                    _gradients[k] = gradient;
+                    denominator += invMasses[_particles[k]] * lengthSquared(gradient);
+                }
+                _blockDenominators[b] = denominator;
+            }
+        });
+
+        // second level: meshes.
+        parallelForEach(constraintCount(), kMeshGrain, [&](size_t i) {
+            double volume = 0, denominator = 0;
+            for (int32_t b = _triangleBlockOffsets[i]; b < _triangleBlockOffsets[i + 1]; ++b) {
+                volume += _blockVolumes[b];
+            }
+            for (int32_t b = _particleBlockOffsets[i]; b < _particleBlockOffsets[i + 1]; ++b) {
+                denominator += _blockDenominators[b];
+            }
+            const float pressure = _pressureStiffness[i * 2];
+            const float alpha = _pressureStiffness[i * 2 + 1] / deltaTimeSqr;
+            const float constraint = float(volume) - pressure * _restVolumes[i];
+            const float dlambda = (-constraint - alpha * _lambdas[i]) / (float(denominator) + alpha + kEpsilon);
+            _volumes[i] = float(volume);
+            _lambdas[i] += dlambda;
+            _dlambdas[i] = dlambda;
+        });
+
+        const bool inPlace = parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Sequential;
+        const float sorFactor = parameters.SORFactor;
+        parallelFor(0, _particleBlocks.size(), kBlockGrain, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                if (inPlace) {
+                    correct<true>(particles, _particleBlocks[b], sorFactor);
+                } else {
+                    correct<false>(particles, _particleBlocks[b], sorFactor);
+                }
+            }
+        });
+    }
+
+    void VolumeConstraintsBatch::apply(ParticleData &particles, const ConstraintParameters &parameters, float) {
+        if (parameters.evaluationOrder == ConstraintParameters::EvaluationOrder::Parallel) {
+            applyPositionDeltas(particles, _particles.data(), _particles.size(), parameters.SORFactor);
+        }
+    }
+
+    void VolumeConstraintsBatch::reduceTriangles(const ParticleData &particles, size_t blockIndex) {
+        const Block &block = _triangleBlocks[blockIndex];
+        const int32_t *triangles = _triangles.data();
+        const float4 *positions = particles.positions.data();
+        // positions relative to a vertex of the mesh keep the products small far from the origin. The volume
+        // of a closed mesh doesn't depend on the origin, nor do the gradients once summed over the corners.
+        const float3 origin = positions[triangles[_triangleOffsets[block.constraint] * 3]].xyz();
+
+        alignas(32) float volume[kLanes] = {};
+        for (int32_t base = block.begin; base < block.end; base += int32_t(kLanes)) {
+            const size_t lanes = std::min(kLanes, size_t(block.end - base));
+
+            // gather, padding the tail with degenerate triangles at the origin.
+            VectorLanes<kLanes> a, b, c;
+            for (size_t l = 0; l < kLanes; ++l) {
+                if (l < lanes) {
+                    const int32_t *t = triangles + (base + l) * 3;
+                    a.set(l, positions[t[0]].xyz() - origin);
+                    b.set(l, positions[t[1]].xyz() - origin);
+                    c.set(l, positions[t[2]].xyz() - origin);
+                } else {
+                    a.set(l, float3());
+                    b.set(l, float3());
+                    c.set(l, float3());
+                }
+            }
+
+            // V = a . (b x c) / 6, dV/da = (b x c) / 6, dV/db = (c x a) / 6, dV/dc = (a x b) / 6.
+            VectorLanes<kLanes> bc, ca, ab;
+            for (size_t l = 0; l < kLanes; ++l) {
+                bc.x[l] = b.y[l] * c.z[l] - b.z[l] * c.y[l];
+                bc.y[l] = b.z[l] * c.x[l] - b.x[l] * c.z[l];
+                bc.z[l] = b.x[l] * c.y[l] - b.y[l] * c.x[l];
+                ca.x[l] = c.y[l] * a.z[l] - c.z[l] * a.y[l];
+                ca.y[l] = c.z[l] * a.x[l] - c.x[l] * a.z[l];
+                ca.z[l] = c.x[l] * a.y[l] - c.y[l] * a.x[l];
+                ab.x[l] = a.y[l] * b.z[l] - a.z[l] * b.y[l];
+                ab.y[l] = a.z[l] * b.x[l] - a.x[l] * b.z[l];
+                ab.z[l] = a.x[l] * b.y[l] - a.y[l] * b.x[l];
+                volume[l] += a.x[l] * bc.x[l] + a.y[l] * bc.y[l] + a.z[l] * bc.z[l];
+            }
+
+            for (size_t l = 0; l < lanes; ++l) {
+                float4 *gradients = _cornerGradients.data() + (base + l) * 3;
+                gradients[0] = float4(bc.get(l) * (1.f / 6), 0);
+                gradients[1] = float4(ca.get(l) * (1.f / 6), 0);
+                gradients[2] = float4(ab.get(l) * (1.f / 6), 0);
+            }
+        }
+
+        float sum = 0;
+        for (float v : volume) {
+            sum += v;
+        }
+        _blockVolumes[blockIndex] = sum / 6;
+    }
+
+    template <bool InPlace>
+    void VolumeConstraintsBatch::correct(ParticleData &particles, const Block &block, float sorFactor) {
+        const float dlambda = _dlambdas[block.constraint];
+        const float *invMasses = particles.invMasses.data();
+        for (int32_t k = block.begin; k < block.end; ++k) {
+            const int32_t p = _particles[k];
+            const float4 delta = _gradients[k] * (invMasses[p] * dlambda);
+            if constexpr (InPlace) {
+                particles.positions[p] += delta * sorFactor;
+            } else {
+                particles.positionDeltas[p] += delta;
+                ++particles.positionConstraintCounts[p];
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,92 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../solver/Constraints.h"
+#include <vector>
+
+namespace vox::flex {
+    // Volume preservation of closed triangle meshes: C = V - pressure * restVolume, with V the signed volume
+    // enclosed by the mesh's outward facing triangles. Mesh i owns triangles[firstTriangle[i] ..<
+    // firstTriangle[i] + numTriangles[i]], a batch may hold any number of meshes sharing no particle.
+    //
+    // A mesh's volume and gradient are sums over all of its triangles, so an evaluation reduces in two levels
+    // over fixed size blocks, which spreads a single large mesh over every core as well as many small ones:
+    //   triangles: every block computes the volume and corner gradients of its triangles, kLanes at a time,
+    //              and its partial volume,
+    //   particles: every block of the meshes' particles gathers their gradients over the corners referring to
+    //              them, and its partial sum w |grad|^2,
+    //   meshes:    sums the partials of every mesh into its XPBD multiplier update,
+    // then every particle moves along its gradient. Blocks always sum in the same order, so results don't
+    // depend on the thread count.
+    class VolumeConstraintsBatch : public ConstraintsBatch {
+    public:
+        static constexpr size_t kLanes = 8;
+        // triangles or particles per block of the reductions, a multiple of kLanes.
+        static constexpr size_t kBlockSize = 256;
+
+        // `triangles` holds 3 particle indices per triangle, `pressureStiffness` (pressure, compliance) per
+        // mesh. Lambdas may be null.
+        void setVolumeConstraints(const int32_t *triangles, const int32_t *firstTriangle,
+                                  const int32_t *numTriangles, const float *restVolumes,
+                                  const float *pressureStiffness, const float *lambdas, size_t count);
+
+        size_t constraintCount() const override { return _restVolumes.size(); }
+
+        const AlignedVector<float> &lambdas() const { return _lambdas; }
+
+        // Meshes' volumes as of the last evaluation.
+        const AlignedVector<float> &volumes() const { return _volumes; }
+
+        void initialize(ParticleData &particles, float substepTime) override;
+
+        void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                      float substepTime, int substeps) override;
+
+        void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) override;
+
+    private:
+        // a run of triangles or particles of one mesh.
+        struct Block {
+            int32_t constraint;
+            int32_t begin;
+            int32_t end;
+        };
+
+        void reduceTriangles(const ParticleData &particles, size_t blockIndex);
+
+        template <bool InPlace>
+        void correct(ParticleData &particles, const Block &block, float sorFactor);
+
+        static void appendBlocks(std::vector<Block> &blocks, int32_t constraint, int32_t begin, int32_t end);
+
+        // per mesh
+        AlignedVector<int32_t> _triangleOffsets;
+        AlignedVector<float> _restVolumes;
+        AlignedVector<float> _pressureStiffness;
+        AlignedVector<float> _lambdas;
+        AlignedVector<float> _volumes;
+        AlignedVector<float> _dlambdas;
+        AlignedVector<int32_t> _triangleBlockOffsets;
+        AlignedVector<int32_t> _particleBlockOffsets;
+
+        // per triangle, in mesh order: particle indices and the volume gradient at each corner.
+        AlignedVector<int32_t> _triangles;
+        AlignedVector<float4> _cornerGradients;
+
+        // distinct particles of every mesh, and the corners referring to each of them (CSR).
+        AlignedVector<int32_t> _particles;
+        AlignedVector<int32_t> _cornerOffsets;
+        AlignedVector<int32_t> _corners;
+        AlignedVector<float4> _gradients;
+
+        std::vector<Block> _triangleBlocks;
+        std::vector<Block> _particleBlocks;
+        AlignedVector<float> _blockVolumes;
+        AlignedVector<float> _blockDenominators;
+    };
+} // namespace vox::flex
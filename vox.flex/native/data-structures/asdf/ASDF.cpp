@@ -0,0 +1,211 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ASDF.h"
+#include "../bvh/TriangleMeshBVH.h"
+#include "../../common/Parallel.h"
+
+namespace vox::flex {
+    namespace {
+        // 3x3x3 lattice of a node, indexed as x * 9 + y * 3 + z with coordinates in {0, 1, 2}.
+        constexpr int kLatticeSize = 27;
+
+        constexpr int latticeIndex(int x, int y, int z) { return x * 9 + y * 3 + z; }
+
+        bool isCorner(int x, int y, int z) { return x != 1 && y != 1 && z != 1; }
+
+        float3 latticePosition(const float4 &center, int x, int y, int z) {
+            return {center.x + float(x - 1) * center.w, center.y + float(y - 1) * center.w,
+                    center.z + float(z - 1) * center.w};
+        }
+
+        // corners of a child cell taken from its parent's lattice; (ox, oy, oz) is the child octant.
+        void setChildCorners(DFNode &node, const float *lattice, int ox, int oy, int oz) {
+            int x0 = ox, x1 = ox + 1, y0 = oy, y1 = oy + 1, z0 = oz, z1 = oz + 1;
+            node.distancesA = {lattice[latticeIndex(x0, y0, z0)], lattice[latticeIndex(x0, y0, z1)],
+                               lattice[latticeIndex(x0, y1, z0)], lattice[latticeIndex(x0, y1, z1)]};
+            node.distancesB = {lattice[latticeIndex(x1, y0, z0)], lattice[latticeIndex(x1, y0, z1)],
+                               lattice[latticeIndex(x1, y1, z0)], lattice[latticeIndex(x1, y1, z1)]};
+        }
+    } // namespace
+
+    // MARK: - DFNode
+    float3 DFNode::normalizedPosition(const float3 &position) const {
+        float size = center.w * 2;
+        return {(position.x - (center.x - center.w)) / size, (position.y - (center.y - center.w)) / size,
+                (position.z - (center.z - center.w)) / size};
+    }
+
+    float DFNode::sample(const float3 &position) const {
+        float3 nPos = normalizedPosition(position);
+
+        // trilinear interpolation: interpolate along x axis
+        float4 x = distancesA + (distancesB - distancesA) * nPos.x;
+
+        // interpolate along y axis
+        float y0 = x.x + (x.z - x.x) * nPos.y;
+        float y1 = x.y + (x.w - x.y) * nPos.y;
+
+        // interpolate along z axis.
+        return y0 + (y1 - y0) * nPos.z;
+    }
+
+    float4 DFNode::sampleWithGradient(const float3 &position) const {
+        float3 nPos = normalizedPosition(position);
+
+        float4 dx = distancesB - distancesA;
+        float4 x = distancesA + dx * nPos.x;
+
+        float y0 = x.x + (x.z - x.x) * nPos.y;
+        float y1 = x.y + (x.w - x.y) * nPos.y;
+
+        // partial derivatives along the normalized axes, then scaled to world units.
+        float dy0 = dx.x + (dx.z - dx.x) * nPos.y;
+        float dy1 = dx.y + (dx.w - dx.y) * nPos.y;
+        float du = dy0 + (dy1 - dy0) * nPos.z;
+        float dv = (x.z - x.x) + ((x.w - x.y) - (x.z - x.x)) * nPos.z;
+        float dw = y1 - y0;
+        float invSize = 1 / (center.w * 2);
+        return {du * invSize, dv * invSize, dw * invSize, y0 + (y1 - y0) * nPos.z};
+    }
+
+    int DFNode::octant(const float3 &position) const {
+        int index = 0;
+        if (position.x > center.x) index |= 4;
+        if (position.y > center.y) index |= 2;
+        if (position.z > center.z) index |= 1;
+        return index;
+    }
+
+    // MARK: - ASDF
+    void ASDF::build(float maxError, int maxDepth, const TriangleMeshBVH &mesh, std::vector<DFNode> &nodes) {
+        build(maxError, maxDepth, mesh.lowerBounds(), mesh.upperBounds(),
+              [&mesh](const float3 &p) { return mesh.signedDistance(p); }, nodes);
+    }
+
+    void ASDF::build(float maxError, int maxDepth, const float3 &lowerBounds, const float3 &upperBounds,
+                     const DistanceFunction &distance, std::vector<DFNode> &nodes) {
+        nodes.clear();
+
+        // cubic root cell, padded so the surface never lies exactly on its boundary.
+        float3 size = upperBounds - lowerBounds;
+        float halfSize = std::max(maxComponent(size) * 0.5f * 1.1f, 1e-4f);
+        float3 center = (lowerBounds + upperBounds) * 0.5f;
+
+        DFNode root;
+        root.center = float4(center, halfSize);
+        for (int x = 0; x <= 2; x += 2) {
+            for (int y = 0; y <= 2; y += 2) {
+                for (int z = 0; z <= 2; z += 2) {
+                    float value = distance(latticePosition(root.center, x, y, z));
+                    float *target = x == 0 ? &root.distancesA.x : &root.distancesB.x;
+                    target[(y / 2) * 2 + z / 2] = value;
+                }
+            }
+        }
+        nodes.push_back(root);
+
+        std::vector<float> lattices;
+        std::vector<uint8_t> subdivide;
+        std::vector<uint32_t> childOffsets;
+        size_t levelBegin = 0;
+        size_t levelEnd = 1;
+        for (int depth = 0; depth < maxDepth && levelBegin < levelEnd; ++depth) {
+            size_t levelCount = levelEnd - levelBegin;
+            lattices.resize(levelCount * kLatticeSize);
+            subdivide.assign(levelCount, 0);
+
+            // evaluate the 19 non-corner lattice points of every node in this level.
+            parallelFor(0, levelCount, 16, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const DFNode &node = nodes[levelBegin + i];
+                    float *lattice = &lattices[i * kLatticeSize];
+                    float error = 0;
+                    for (int x = 0; x < 3; ++x) {
+                        for (int y = 0; y < 3; ++y) {
+                            for (int z = 0; z < 3; ++z) {
+                                int index = latticeIndex(x, y, z);
+                                if (isCorner(x, y, z)) {
+                                    const float4 &face = x == 0 ? node.distancesA : node.distancesB;
+                                    lattice[index] = face[(y / 2) * 2 + z / 2];
+                                    continue;
+                                }
+                                float3 position = latticePosition(node.center, x, y, z);
+                                lattice[index] = distance(position);
+                                error = std::max(error, std::fabs(lattice[index] - node.sample(position)));
+                            }
+                        }
+                    }
+                    subdivide[i] = error > maxError;
+                }
+            });
+
+            // assign child ranges in level order so each level stays contiguous.
+            childOffsets.resize(levelCount);
+            size_t childCount = 0;
+            for (size_t i = 0; i < levelCount; ++i) {
+                childOffsets[i] = static_cast<uint32_t>(levelEnd + childCount);
+                childCount += subdivide[i] ? 8 : 0;
+            }
+            nodes.resize(levelEnd + childCount);
+
+            parallelFor(0, levelCount, 64, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    if (!subdivide[i]) {
+                        continue;
+                    }
+                    DFNode &parent = nodes[levelBegin + i];
+                    parent.firstChild = static_cast<int32_t>(childOffsets[i]);
+                    const float *lattice = &lattices[i * kLatticeSize];
+                    float childHalf = parent.center.w * 0.5f;
+                    for (int octant = 0; octant < 8; ++octant) {
+                        int ox = (octant >> 2) & 1, oy = (octant >> 1) & 1, oz = octant & 1;
+                        DFNode &child = nodes[childOffsets[i] + octant];
+                        child.center = float4(parent.center.x + float(ox * 2 - 1) * childHalf,
+                                              parent.center.y + float(oy * 2 - 1) * childHalf,
+                                              parent.center.z + float(oz * 2 - 1) * childHalf, childHalf);
+                        child.firstChild = -1;
+                        setChildCorners(child, lattice, ox, oy, oz);
+                    }
+                }
+            });
+
+            levelBegin = levelEnd;
+            levelEnd = nodes.size();
+        }
+    }
+
+    float ASDF::sample(const DFNode *nodes, size_t count, const float3 &position) {
+        if (count == 0) {
+            return 0;
+        }
+        size_t index = 0;
+        while (nodes[index].firstChild >= 0) {
+            index = static_cast<size_t>(nodes[index].firstChild + nodes[index].octant(position));
+        }
+        return nodes[index].sample(position);
+    }
+
+    float4 ASDF::sampleWithGradient(const DFNode *nodes, size_t count, const float3 &position) {
+        if (count == 0) {
+            return {};
+        }
+        size_t index = 0;
+        while (nodes[index].firstChild >= 0) {
+            index = static_cast<size_t>(nodes[index].firstChild + nodes[index].octant(position));
+        }
+        return nodes[index].sampleWithGradient(position);
+    }
+
+    void ASDF::sample(const DFNode *nodes, size_t nodeCount, const float3 *positions, float *distances,
+                      size_t count) {
+        parallelFor(0, count, 256, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                distances[i] = sample(nodes, nodeCount, positions[i]);
+            }
+        });
+    }
+} // namespace vox::flex
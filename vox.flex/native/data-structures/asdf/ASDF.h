@@ -0,0 +1,57 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Math.h"
+#include <functional>
+#include <vector>
+
+namespace vox::flex {
+    class TriangleMeshBVH;
+
+    // Octree node of an adaptive distance field, same layout as the Swift DFNode.
+    // distancesA holds the four corner distances on the -x face, distancesB the ones on the +x face,
+    // both ordered (y-,z-), (y-,z+), (y+,z-), (y+,z+). center.w is the half size of the node.
+    struct DFNode {
+        float4 distancesA;
+        float4 distancesB;
+        float4 center;
+        int32_t firstChild = -1;
+
+        float sample(const float3 &position) const;
+
+        // Trilinear distance in w, its gradient in xyz.
+        float4 sampleWithGradient(const float3 &position) const;
+
+        float3 normalizedPosition(const float3 &position) const;
+
+        int octant(const float3 &position) const;
+    };
+
+    // Adaptive signed distance field builder: a node is subdivided whenever trilinear interpolation
+    // of its corner distances deviates from the real distance by more than `maxError` at any of the
+    // 19 edge/face/center points of its 3x3x3 lattice. Each octree level is evaluated in parallel,
+    // and children reuse the lattice values of their parent as corner distances.
+    class ASDF {
+    public:
+        using DistanceFunction = std::function<float(const float3 &)>;
+
+        static void build(float maxError, int maxDepth, const TriangleMeshBVH &mesh, std::vector<DFNode> &nodes);
+
+        static void build(float maxError, int maxDepth, const float3 &lowerBounds, const float3 &upperBounds,
+                          const DistanceFunction &distance, std::vector<DFNode> &nodes);
+
+        static float sample(const DFNode *nodes, size_t count, const float3 &position);
+
+        // Distance in w and its gradient in xyz, from the leaf containing `position`.
+        static float4 sampleWithGradient(const DFNode *nodes, size_t count, const float3 &position);
+
+        // Samples `count` positions at once, in parallel.
+        static void sample(const DFNode *nodes, size_t nodeCount, const float3 *positions, float *distances,
+                           size_t count);
+    };
+} // namespace vox::flex
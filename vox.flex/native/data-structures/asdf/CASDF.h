@@ -0,0 +1,42 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+@class TriangleMesh;
+
+/// Adaptive signed distance field built on the CPU from a triangle mesh.
+@interface CASDF : NSObject
+
+- (instancetype _Nonnull)initWithPositions:(const simd_float3 *_Nonnull)positions
+                               vertexCount:(uint32_t)vertexCount
+                                   indices:(const uint32_t *_Nonnull)indices
+                                indexCount:(uint32_t)indexCount;
+
+- (instancetype _Nonnull)initWithMesh:(TriangleMesh *_Nonnull)mesh;
+
+- (void)buildWithMaxError:(float)maxError maxDepth:(uint32_t)maxDepth;
+
+- (uint32_t)nodeCount;
+
+- (void)getNodes:(simd_float4 *_Nonnull)distancesA
+                :(simd_float4 *_Nonnull)distancesB
+                :(simd_float4 *_Nonnull)centers
+                :(int32_t *_Nonnull)firstChildren;
+
+/// Samples the adaptive field.
+- (float)sample:(simd_float3)position;
+
+/// Samples `count` positions in parallel.
+- (void)sample:(const simd_float3 *_Nonnull)positions :(float *_Nonnull)distances count:(uint32_t)count;
+
+/// Exact distance to the mesh, negative inside.
+- (float)signedDistance:(simd_float3)position;
+
+@end
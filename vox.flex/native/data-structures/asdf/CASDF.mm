@@ -0,0 +1,80 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CASDF.h"
+#import "../../../TriangleMesh+Internal.h"
+#include "ASDF.h"
+#include "../bvh/TriangleMeshBVH.h"
+#include <vector>
+
+using namespace vox::flex;
+
+static_assert(sizeof(float3) == sizeof(simd_float3), "float3 must match simd_float3 layout");
+
+@implementation CASDF {
+    TriangleMeshBVH _mesh;
+    std::vector<DFNode> _nodes;
+}
+
+- (instancetype)initWithPositions:(const simd_float3 *)positions
+                      vertexCount:(uint32_t)vertexCount
+                          indices:(const uint32_t *)indices
+                       indexCount:(uint32_t)indexCount {
+    self = [super init];
+    if (self) {
+        _mesh.build(reinterpret_cast<const float3 *>(positions), vertexCount, indices, indexCount / 3);
+    }
+    return self;
+}
+
+- (instancetype)initWithMesh:(TriangleMesh *)mesh {
+    std::vector<simd_float3> positions;
+    std::vector<uint32_t> indices;
+    [mesh copyPositions:positions indices:indices];
+    return [self initWithPositions:positions.data()
+                       vertexCount:static_cast<uint32_t>(positions.size())
+                           indices:indices.data()
+                        indexCount:static_cast<uint32_t>(indices.size())];
+}
+
+- (void)buildWithMaxError:(float)maxError maxDepth:(uint32_t)maxDepth {
+    if (_mesh.empty()) {
+        _nodes.clear();
+        return;
+    }
+    ASDF::build(maxError, static_cast<int>(maxDepth), _mesh, _nodes);
+}
+
+- (uint32_t)nodeCount {
+    return static_cast<uint32_t>(_nodes.size());
+}
+
+- (void)getNodes:(simd_float4 *)distancesA
+                :(simd_float4 *)distancesB
+                :(simd_float4 *)centers
+                :(int32_t *)firstChildren {
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        const DFNode &node = _nodes[i];
+        distancesA[i] = simd_make_float4(node.distancesA.x, node.distancesA.y, node.distancesA.z, node.distancesA.w);
+        distancesB[i] = simd_make_float4(node.distancesB.x, node.distancesB.y, node.distancesB.z, node.distancesB.w);
+        centers[i] = simd_make_float4(node.center.x, node.center.y, node.center.z, node.center.w);
+        firstChildren[i] = node.firstChild;
+    }
+}
+
+- (float)sample:(simd_float3)position {
+    return ASDF::sample(_nodes.data(), _nodes.size(), float3(position.x, position.y, position.z));
+}
+
+- (void)sample:(const simd_float3 *)positions :(float *)distances count:(uint32_t)count {
+    ASDF::sample(_nodes.data(), _nodes.size(), reinterpret_cast<const float3 *>(positions), distances, count);
+}
+
+- (float)signedDistance:(simd_float3)position {
+    return _mesh.signedDistance(float3(position.x, position.y, position.z));
+}
+
+@end
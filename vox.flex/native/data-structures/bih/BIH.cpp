@@ -0,0 +1,110 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "BIH.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace vox::flex {
+    namespace {
+        struct BuildTask {
+            uint32_t node;
+            uint32_t start;
+            uint32_t end;
+            int depth;
+        };
+    } // namespace
+
+    uint32_t BIH::hoarePartition(uint32_t *order, const float *centers, uint32_t start, uint32_t end, float pivot) {
+        uint32_t i = start, j = end;
+        while (true) {
+            while (i < j && centers[order[i]] < pivot) {
+                ++i;
+            }
+            while (i < j && centers[order[j - 1]] >= pivot) {
+                --j;
+            }
+            if (i >= j) {
+                return i;
+            }
+            std::swap(order[i++], order[--j]);
+        }
+    }
+
+    void BIH::build(const Aabb *bounds, size_t count, std::vector<BIHNode> &nodes, std::vector<uint32_t> &order,
+                    int maxDepth, int maxLeafSize) {
+        nodes.assign(1, BIHNode());
+        order.resize(count);
+        std::iota(order.begin(), order.end(), 0u);
+        nodes[0].count = uint32_t(count);
+        if (count == 0) {
+            return;
+        }
+        // the traversal stacks hold one pending node per level.
+        maxDepth = std::min(maxDepth, kStackSize - 2);
+        maxLeafSize = std::max(maxLeafSize, 1);
+
+        // centers along each axis, axis after axis.
+        std::vector<float> centers(count * 3);
+        for (size_t i = 0; i < count; ++i) {
+            const float4 center = bounds[i].center();
+            centers[i] = center.x;
+            centers[count + i] = center.y;
+            centers[count * 2 + i] = center.z;
+        }
+
+        std::vector<BuildTask> tasks;
+        tasks.push_back({0, 0, uint32_t(count), 0});
+        while (!tasks.empty()) {
+            const BuildTask task = tasks.back();
+            tasks.pop_back();
+            const uint32_t elementCount = task.end - task.start;
+            if (elementCount <= uint32_t(maxLeafSize) || task.depth >= maxDepth) {
+                nodes[task.node].data = (task.start << 2) | BIHNode::kLeaf;
+                nodes[task.node].count = elementCount;
+                continue;
+            }
+
+            // split the centers' extent in half along its longest axis.
+            float4 lower(std::numeric_limits<float>::max()), upper(std::numeric_limits<float>::lowest());
+            for (uint32_t i = task.start; i < task.end; ++i) {
+                const uint32_t element = order[i];
+                const float4 center(centers[element], centers[count + element], centers[count * 2 + element], 0);
+                lower = min(lower, center);
+                upper = max(upper, center);
+            }
+            const float4 extent = upper - lower;
+            const uint32_t axis = extent.y > extent.x ? (extent.z > extent.y ? 2 : 1) : (extent.z > extent.x ? 2 : 0);
+            const float *axisCenters = centers.data() + count * axis;
+            uint32_t split = hoarePartition(order.data(), axisCenters, task.start, task.end,
+                                            (lower[axis] + upper[axis]) * 0.5f);
+            // all centers on one side: halve the elements instead.
+            if (split == task.start || split == task.end) {
+                split = task.start + elementCount / 2;
+                std::nth_element(order.begin() + task.start, order.begin() + split, order.begin() + task.end,
+                                 [&](uint32_t a, uint32_t b) { return axisCenters[a] < axisCenters[b]; });
+            }
+
+            float leftMax = std::numeric_limits<float>::lowest(), rightMin = std::numeric_limits<float>::max();
+            for (uint32_t i = task.start; i < split; ++i) {
+                leftMax = std::max(leftMax, bounds[order[i]].max[axis]);
+            }
+            for (uint32_t i = split; i < task.end; ++i) {
+                rightMin = std::min(rightMin, bounds[order[i]].min[axis]);
+            }
+
+            const auto firstChild = uint32_t(nodes.size());
+            nodes.resize(nodes.size() + 2);
+            BIHNode &node = nodes[task.node];
+            node.data = (firstChild << 2) | axis;
+            node.clip[0] = leftMax;
+            node.clip[1] = rightMin;
+            tasks.push_back({firstChild + 1, split, task.end, task.depth + 1});
+            tasks.push_back({firstChild, task.start, split, task.depth + 1});
+        }
+    }
+} // namespace vox::flex
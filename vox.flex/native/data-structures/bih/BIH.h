@@ -0,0 +1,134 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Aabb.h"
+#include <vector>
+
+namespace vox::flex {
+    // Node of a bounding interval hierarchy, native counterpart of BIHNode packed in 12 bytes. Interior nodes
+    // keep the axis of their split and two consecutive children: the left one holds the elements whose bounds
+    // end below `clip[0]` along that axis, the right one those starting above `clip[1]`. Leaves keep a range
+    // of the reordered elements.
+    struct BIHNode {
+        static constexpr uint32_t kLeaf = 3;
+
+        // axis (0, 1, 2) or kLeaf in the low 2 bits, first child or first element above.
+        uint32_t data = kLeaf;
+        union {
+            float clip[2];
+            uint32_t count;
+        };
+
+        BIHNode() : clip{0, 0} {}
+
+        bool isLeaf() const { return (data & 3) == kLeaf; }
+
+        uint32_t axis() const { return data & 3; }
+
+        // first child of interior nodes, first element of leaves.
+        uint32_t index() const { return data >> 2; }
+    };
+    static_assert(sizeof(BIHNode) == 12, "BIH nodes are 12 bytes");
+
+    // Bounding interval hierarchy builder and traversals, native counterpart of BIH. Only two split planes
+    // are stored per node instead of a box per child, so a tree takes a fraction of a BVH's memory and a query
+    // narrows its interval along a single axis per node.
+    class BIH {
+    public:
+        static constexpr int kLanes = 8;
+
+        // Builds the tree of `count` elements from their bounds. `order` gets the element order the leaves
+        // refer to. Nodes stop splitting at `maxLeafSize` elements or `maxDepth` levels.
+        static void build(const Aabb *bounds, size_t count, std::vector<BIHNode> &nodes, std::vector<uint32_t> &order,
+                          int maxDepth = 32, int maxLeafSize = 4);
+
+        // Moves the elements of order[start ..< end] whose center along `axis` is below `pivot` in front of the
+        // others and returns the index of the first of the others.
+        static uint32_t hoarePartition(uint32_t *order, const float *centers, uint32_t start, uint32_t end,
+                                       float pivot);
+
+        // Calls `callback(first, count)` for every leaf whose elements may overlap `bounds`.
+        template <typename Callback>
+        static void query(const BIHNode *nodes, const Aabb &bounds, Callback &&callback);
+
+        // Traverses the tree once for up to kLanes boxes, given by their corners one lane each: a node is
+        // visited if any lane of `mask` may overlap it. Calls `callback(first, count, laneMask)` for every leaf
+        // reached, with the lanes that reached it.
+        template <typename Callback>
+        static void queryLanes(const BIHNode *nodes, const float *minX, const float *minY, const float *minZ,
+                               const float *maxX, const float *maxY, const float *maxZ, uint32_t mask,
+                               Callback &&callback);
+
+    private:
+        static constexpr int kStackSize = 64;
+    };
+
+    template <typename Callback>
+    void BIH::query(const BIHNode *nodes, const Aabb &bounds, Callback &&callback) {
+        uint32_t stack[kStackSize];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const BIHNode &node = nodes[stack[--top]];
+            if (node.isLeaf()) {
+                if (node.count > 0) {
+                    callback(node.index(), node.count);
+                }
+                continue;
+            }
+            const uint32_t axis = node.axis();
+            if (bounds.max[axis] >= node.clip[1]) {
+                stack[top++] = node.index() + 1;
+            }
+            if (bounds.min[axis] <= node.clip[0]) {
+                stack[top++] = node.index();
+            }
+        }
+    }
+
+    template <typename Callback>
+    void BIH::queryLanes(const BIHNode *nodes, const float *minX, const float *minY, const float *minZ,
+                         const float *maxX, const float *maxY, const float *maxZ, uint32_t mask,
+                         Callback &&callback) {
+        const float *mins[3] = {minX, minY, minZ};
+        const float *maxs[3] = {maxX, maxY, maxZ};
+        uint32_t stack[kStackSize];
+        uint32_t masks[kStackSize];
+        int top = 0;
+        stack[top] = 0;
+        masks[top++] = mask;
+        while (top > 0) {
+            --top;
+            const BIHNode &node = nodes[stack[top]];
+            const uint32_t active = masks[top];
+            if (node.isLeaf()) {
+                if (node.count > 0) {
+                    callback(node.index(), node.count, active);
+                }
+                continue;
+            }
+            const float *lower = mins[node.axis()];
+            const float *upper = maxs[node.axis()];
+            uint32_t left = 0, right = 0;
+            for (int l = 0; l < kLanes; ++l) {
+                left |= uint32_t(lower[l] <= node.clip[0]) << l;
+                right |= uint32_t(upper[l] >= node.clip[1]) << l;
+            }
+            left &= active;
+            right &= active;
+            if (right != 0) {
+                stack[top] = node.index() + 1;
+                masks[top++] = right;
+            }
+            if (left != 0) {
+                stack[top] = node.index();
+                masks[top++] = left;
+            }
+        }
+    }
+} // namespace vox::flex
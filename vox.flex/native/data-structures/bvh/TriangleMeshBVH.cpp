@@ -0,0 +1,296 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "TriangleMeshBVH.h"
+
+#include <numeric>
+#include <unordered_map>
+
+namespace vox::flex {
+    namespace {
+        float angleAt(const float3 &corner, const float3 &a, const float3 &b) {
+            float3 e0 = normalize(a - corner);
+            float3 e1 = normalize(b - corner);
+            return std::acos(std::clamp(dot(e0, e1), -1.f, 1.f));
+        }
+
+        float boxDistanceSquared(const TriangleMeshBVH::Node &node, const float3 &p) {
+            float d = 0;
+            for (int i = 0; i < 3; ++i) {
+                float v = p[i];
+                if (v < node.bbox[i]) {
+                    d += (node.bbox[i] - v) * (node.bbox[i] - v);
+                } else if (v > node.bbox[i + 3]) {
+                    d += (v - node.bbox[i + 3]) * (v - node.bbox[i + 3]);
+                }
+            }
+            return d;
+        }
+
+        uint64_t edgeKey(uint32_t a, uint32_t b) {
+            if (a > b) {
+                std::swap(a, b);
+            }
+            return (uint64_t(a) << 32) | b;
+        }
+    } // namespace
+
+    float3 closestPointOnTriangle(const float3 &p, const float3 &a, const float3 &b, const float3 &c,
+                                  float3 &barycentric) {
+        float3 ab = b - a;
+        float3 ac = c - a;
+        float3 ap = p - a;
+        float d1 = dot(ab, ap);
+        float d2 = dot(ac, ap);
+        if (d1 <= 0 && d2 <= 0) {
+            barycentric = {1, 0, 0};
+            return a;
+        }
+
+        float3 bp = p - b;
+        float d3 = dot(ab, bp);
+        float d4 = dot(ac, bp);
+        if (d3 >= 0 && d4 <= d3) {
+            barycentric = {0, 1, 0};
+            return b;
+        }
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+            float v = d1 / (d1 - d3);
+            barycentric = {1 - v, v, 0};
+            return a + ab * v;
+        }
+
+        float3 cp = p - c;
+        float d5 = dot(ab, cp);
+        float d6 = dot(ac, cp);
+        if (d6 >= 0 && d5 <= d6) {
+            barycentric = {0, 0, 1};
+            return c;
+        }
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+            float w = d2 / (d2 - d6);
+            barycentric = {1 - w, 0, w};
+            return a + ac * w;
+        }
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+            float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            barycentric = {0, 1 - w, w};
+            return b + (c - b) * w;
+        }
+
+        float denom = 1.f / (va + vb + vc);
+        float v = vb * denom;
+        float w = vc * denom;
+        barycentric = {1 - v - w, v, w};
+        return a + ab * v + ac * w;
+    }
+
+    void TriangleMeshBVH::build(const float3 *positions, size_t vertexCount, const uint32_t *indices,
+                                size_t triangleCount, uint32_t maxLeafSize) {
+        _nodes.clear();
+        _triangles.clear();
+        if (triangleCount == 0) {
+            return;
+        }
+
+        // accumulate angle weighted pseudo-normals for vertices and edges.
+        std::vector<float3> vertexNormals(vertexCount);
+        std::unordered_map<uint64_t, float3> edgeNormals;
+        edgeNormals.reserve(triangleCount * 3);
+        std::vector<float3> faceNormals(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const uint32_t *tri = indices + t * 3;
+            const float3 &a = positions[tri[0]];
+            const float3 &b = positions[tri[1]];
+            const float3 &c = positions[tri[2]];
+            float3 n = normalize(cross(b - a, c - a));
+            faceNormals[t] = n;
+
+            vertexNormals[tri[0]] += n * angleAt(a, b, c);
+            vertexNormals[tri[1]] += n * angleAt(b, c, a);
+            vertexNormals[tri[2]] += n * angleAt(c, a, b);
+            for (int e = 0; e < 3; ++e) {
+                edgeNormals[edgeKey(tri[e], tri[(e + 1) % 3])] += n;
+            }
+        }
+
+        std::vector<Triangle> source(triangleCount);
+        std::vector<float3> centers(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const uint32_t *tri = indices + t * 3;
+            Triangle &triangle = source[t];
+            for (int k = 0; k < 3; ++k) {
+                triangle.v[k] = positions[tri[k]];
+                triangle.vertexNormals[k] = normalize(vertexNormals[tri[k]]);
+                triangle.edgeNormals[k] = normalize(edgeNormals[edgeKey(tri[k], tri[(k + 1) % 3])]);
+            }
+            triangle.faceNormal = faceNormals[t];
+            centers[t] = (triangle.v[0] + triangle.v[1] + triangle.v[2]) / 3.f;
+        }
+
+        std::vector<uint32_t> order(triangleCount);
+        std::iota(order.begin(), order.end(), 0);
+        _nodes.reserve(triangleCount * 2);
+        _nodes.emplace_back();
+        fillNode(0, 0, static_cast<uint32_t>(triangleCount), std::max(maxLeafSize, 1u), order, centers);
+
+        _triangles.resize(triangleCount);
+        for (size_t i = 0; i < triangleCount; ++i) {
+            _triangles[i] = source[order[i]];
+        }
+        refit();
+    }
+
+    void TriangleMeshBVH::fillNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t maxLeafSize,
+                                   std::vector<uint32_t> &order, const std::vector<float3> &centers) {
+        Node &node = _nodes[nodeIndex];
+        if (end - begin <= maxLeafSize) {
+            node.childIndex = begin;
+            node.childCount = end - begin;
+            return;
+        }
+        node.childCount = 0;
+
+        // median split along the axis of largest centroid spread.
+        float3 lower(std::numeric_limits<float>::max());
+        float3 upper(-std::numeric_limits<float>::max());
+        for (uint32_t i = begin; i < end; ++i) {
+            lower = min(lower, centers[order[i]]);
+            upper = max(upper, centers[order[i]]);
+        }
+        float3 extent = upper - lower;
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        uint32_t mid = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                         [&](uint32_t a, uint32_t b) { return centers[a][axis] < centers[b][axis]; });
+
+        auto first = static_cast<uint32_t>(_nodes.size());
+        node.childIndex = first;
+        _nodes.emplace_back();
+        _nodes.emplace_back();
+        fillNode(first, begin, mid, maxLeafSize, order, centers);
+        fillNode(first + 1, mid, end, maxLeafSize, order, centers);
+    }
+
+    void TriangleMeshBVH::refit() {
+        // children are always stored after their parent, so a reverse sweep sees them first.
+        for (size_t n = _nodes.size(); n-- > 0;) {
+            Node &node = _nodes[n];
+            float3 lower(std::numeric_limits<float>::max());
+            float3 upper(-std::numeric_limits<float>::max());
+            if (node.childCount > 0) {
+                for (uint32_t t = node.childIndex; t < node.childIndex + node.childCount; ++t) {
+                    for (const float3 &v : _triangles[t].v) {
+                        lower = min(lower, v);
+                        upper = max(upper, v);
+                    }
+                }
+            } else {
+                for (uint32_t c = node.childIndex; c < node.childIndex + 2; ++c) {
+                    const Node &child = _nodes[c];
+                    lower = min(lower, float3(child.bbox[0], child.bbox[1], child.bbox[2]));
+                    upper = max(upper, float3(child.bbox[3], child.bbox[4], child.bbox[5]));
+                }
+            }
+            node.bbox[0] = lower.x;
+            node.bbox[1] = lower.y;
+            node.bbox[2] = lower.z;
+            node.bbox[3] = upper.x;
+            node.bbox[4] = upper.y;
+            node.bbox[5] = upper.z;
+        }
+    }
+
+    float3 TriangleMeshBVH::lowerBounds() const {
+        return _nodes.empty() ? float3() : float3(_nodes[0].bbox[0], _nodes[0].bbox[1], _nodes[0].bbox[2]);
+    }
+
+    float3 TriangleMeshBVH::upperBounds() const {
+        return _nodes.empty() ? float3() : float3(_nodes[0].bbox[3], _nodes[0].bbox[4], _nodes[0].bbox[5]);
+    }
+
+    float TriangleMeshBVH::closestPoint(const float3 &point, float3 &closest, float3 &normal) const {
+        float best = std::numeric_limits<float>::infinity();
+        if (_nodes.empty()) {
+            return best;
+        }
+
+        uint32_t stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node &node = _nodes[stack[--top]];
+            if (boxDistanceSquared(node, point) >= best) {
+                continue;
+            }
+
+            if (node.childCount > 0) {
+                for (uint32_t t = node.childIndex; t < node.childIndex + node.childCount; ++t) {
+                    const Triangle &tri = _triangles[t];
+                    float3 bary;
+                    float3 candidate = closestPointOnTriangle(point, tri.v[0], tri.v[1], tri.v[2], bary);
+                    float d = lengthSquared(point - candidate);
+                    if (d < best) {
+                        best = d;
+                        closest = candidate;
+                        normal = featureNormal(tri, bary);
+                    }
+                }
+            } else {
+                // visit the nearest child first so the other one is more likely to be culled.
+                uint32_t near = node.childIndex;
+                uint32_t far = node.childIndex + 1;
+                if (boxDistanceSquared(_nodes[far], point) < boxDistanceSquared(_nodes[near], point)) {
+                    std::swap(near, far);
+                }
+                stack[top++] = far;
+                stack[top++] = near;
+            }
+        }
+        return best;
+    }
+
+    float TriangleMeshBVH::signedDistance(const float3 &point) const {
+        float3 closest, normal;
+        float distanceSquared = closestPoint(point, closest, normal);
+        if (!std::isfinite(distanceSquared)) {
+            return distanceSquared;
+        }
+        float distance = std::sqrt(distanceSquared);
+        return dot(point - closest, normal) < 0 ? -distance : distance;
+    }
+
+    float3 TriangleMeshBVH::featureNormal(const Triangle &triangle, const float3 &barycentric) {
+        const float epsilon = 1e-6f;
+        int zeros = 0;
+        int zeroIndex = 0;
+        int nonZeroIndex = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (barycentric[k] <= epsilon) {
+                ++zeros;
+                zeroIndex = k;
+            } else {
+                nonZeroIndex = k;
+            }
+        }
+
+        switch (zeros) {
+            case 0:
+                return triangle.faceNormal;
+            case 1:
+                // the edge opposite to the vertex whose weight vanished.
+                return triangle.edgeNormals[(zeroIndex + 1) % 3];
+            default:
+                return triangle.vertexNormals[nonZeroIndex];
+        }
+    }
+} // namespace vox::flex
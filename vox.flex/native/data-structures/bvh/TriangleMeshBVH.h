@@ -0,0 +1,70 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Math.h"
+#include <vector>
+
+namespace vox::flex {
+    // Bounding volume hierarchy over a triangle mesh, used for closest point / signed distance
+    // queries. Nodes share the flattened layout of TriangleMesh's GPU tree: interior nodes point
+    // to two consecutive children, leaves to a contiguous range of reordered triangles.
+    class TriangleMeshBVH {
+    public:
+        struct Node {
+            float bbox[6]; // min xyz, max xyz
+            uint32_t childIndex;
+            uint32_t childCount; // childCount is always 0 for interior nodes
+        };
+
+        // Triangle with the angle weighted pseudo-normals of its face, edges and vertices,
+        // so the sign of a distance is robust no matter which feature is closest.
+        struct Triangle {
+            float3 v[3];
+            float3 faceNormal;
+            float3 edgeNormals[3]; // edges v0v1, v1v2, v2v0
+            float3 vertexNormals[3];
+        };
+
+        // `indices` holds three vertex indices per triangle.
+        void build(const float3 *positions, size_t vertexCount, const uint32_t *indices, size_t triangleCount,
+                   uint32_t maxLeafSize = 4);
+
+        bool empty() const { return _nodes.empty(); }
+
+        float3 lowerBounds() const;
+
+        float3 upperBounds() const;
+
+        const std::vector<Node> &nodes() const { return _nodes; }
+
+        const std::vector<Triangle> &triangles() const { return _triangles; }
+
+        // Closest point on the surface to `point`, and the pseudo-normal of the closest feature.
+        // Returns the squared distance, or infinity for empty meshes.
+        float closestPoint(const float3 &point, float3 &closest, float3 &normal) const;
+
+        // Distance to the surface, negative inside the mesh.
+        float signedDistance(const float3 &point) const;
+
+    private:
+        void fillNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t maxLeafSize,
+                      std::vector<uint32_t> &order, const std::vector<float3> &centers);
+
+        void refit();
+
+        static float3 featureNormal(const Triangle &triangle, const float3 &barycentric);
+
+        std::vector<Node> _nodes;
+        std::vector<Triangle> _triangles;
+    };
+
+    // Closest point on triangle abc to p (Ericson, Real-Time Collision Detection 5.1.5).
+    // Also returns the barycentric coordinates of the closest point.
+    float3 closestPointOnTriangle(const float3 &p, const float3 &a, const float3 &b, const float3 &c,
+                                  float3 &barycentric);
+} // namespace vox::flex
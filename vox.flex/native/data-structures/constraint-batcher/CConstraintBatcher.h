@@ -0,0 +1,47 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+/// See BatchData in ConstraintBatcher.h.
+typedef struct {
+    uint16_t batchID;
+    uint32_t startIndex;
+    uint32_t constraintCount;
+    uint32_t workItemSize;
+    uint32_t workItemCount;
+    bool isLast;
+} CBatchData;
+
+/// Parallel greedy graph coloring of constraints into batches sharing no particle.
+@interface CConstraintBatcher : NSObject
+
+/// At most 17 batches, the last one collecting constraints that could not be colored.
+- (instancetype _Nonnull)initWithMaxBatches:(uint32_t)maxBatches;
+
+/// Two-particle constraints given as (a, b) pairs, returns the number of batches.
+/// `constraintStride` is the size in bytes of one constraint, used to align work items on cache lines.
+- (uint32_t)batchPairs:(const int32_t *_Nonnull)pairs
+                 count:(uint32_t)count
+         particleCount:(uint32_t)particleCount
+      constraintStride:(uint32_t)constraintStride;
+
+/// Constraints with any number of particles: those of constraint i are particles[offsets[i] ..< offsets[i + 1]].
+- (uint32_t)batchConstraints:(const int32_t *_Nonnull)particles
+                     offsets:(const uint32_t *_Nonnull)offsets
+                       count:(uint32_t)count
+               particleCount:(uint32_t)particleCount
+            constraintStride:(uint32_t)constraintStride;
+
+/// Constraint index of every batch slot, as many as constraints in the last call.
+- (void)getSortedIndices:(uint32_t *_Nonnull)sortedIndices;
+
+/// One entry per batch of the last call.
+- (void)getBatchData:(CBatchData *_Nonnull)batchData;
+
+@end
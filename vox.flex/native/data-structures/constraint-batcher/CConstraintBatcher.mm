@@ -0,0 +1,70 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CConstraintBatcher.h"
+#include "ConstraintBatcher.h"
+#include <algorithm>
+#include <memory>
+
+using namespace vox::flex;
+
+namespace {
+    struct CSRProvider {
+        const int32_t *particles;
+        const uint32_t *offsets;
+        size_t count;
+
+        size_t constraintCount() const { return count; }
+
+        uint32_t particleCount(size_t constraint) const { return offsets[constraint + 1] - offsets[constraint]; }
+
+        int32_t particle(size_t constraint, uint32_t index) const { return particles[offsets[constraint] + index]; }
+    };
+} // namespace
+
+@implementation CConstraintBatcher {
+    std::unique_ptr<ConstraintBatcher> _batcher;
+    std::vector<uint32_t> _sortedIndices;
+    std::vector<BatchData> _batchData;
+}
+
+- (instancetype)initWithMaxBatches:(uint32_t)maxBatches {
+    self = [super init];
+    if (self) {
+        _batcher = std::make_unique<ConstraintBatcher>(maxBatches);
+    }
+    return self;
+}
+
+- (uint32_t)batchPairs:(const int32_t *)pairs
+                 count:(uint32_t)count
+         particleCount:(uint32_t)particleCount
+      constraintStride:(uint32_t)constraintStride {
+    return _batcher->batchPairs(pairs, count, particleCount, constraintStride, _sortedIndices, _batchData);
+}
+
+- (uint32_t)batchConstraints:(const int32_t *)particles
+                     offsets:(const uint32_t *)offsets
+                       count:(uint32_t)count
+               particleCount:(uint32_t)particleCount
+            constraintStride:(uint32_t)constraintStride {
+    return _batcher->batchConstraints(CSRProvider{particles, offsets, count}, particleCount, constraintStride,
+                                      _sortedIndices, _batchData);
+}
+
+- (void)getSortedIndices:(uint32_t *)sortedIndices {
+    std::copy(_sortedIndices.begin(), _sortedIndices.end(), sortedIndices);
+}
+
+- (void)getBatchData:(CBatchData *)batchData {
+    for (size_t i = 0; i < _batchData.size(); ++i) {
+        const BatchData &batch = _batchData[i];
+        batchData[i] = {batch.batchID,      batch.startIndex,    batch.constraintCount,
+                        batch.workItemSize, batch.workItemCount, batch.isLast};
+    }
+}
+
+@end
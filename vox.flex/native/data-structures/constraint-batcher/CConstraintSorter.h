@@ -0,0 +1,20 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+/// Sorts two-particle constraints by first then second particle, see ConstraintSorter.h.
+@interface CConstraintSorter : NSObject
+
+/// Writes the constraint index of every sorted position to `sortedIndices` (`count` entries).
+- (void)sortPairs:(const int32_t *_Nonnull)pairs
+            count:(uint32_t)count
+    particleCount:(uint32_t)particleCount
+    sortedIndices:(uint32_t *_Nonnull)sortedIndices;
+
+@end
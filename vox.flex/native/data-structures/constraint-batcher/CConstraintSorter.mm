@@ -0,0 +1,26 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CConstraintSorter.h"
+#include "ConstraintSorter.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+@implementation CConstraintSorter {
+    ConstraintSorter _sorter;
+    std::vector<uint32_t> _sortedIndices;
+}
+
+- (void)sortPairs:(const int32_t *)pairs
+            count:(uint32_t)count
+    particleCount:(uint32_t)particleCount
+    sortedIndices:(uint32_t *)sortedIndices {
+    _sorter.sortPairs(pairs, count, particleCount, _sortedIndices);
+    std::copy(_sortedIndices.begin(), _sortedIndices.end(), sortedIndices);
+}
+
+@end
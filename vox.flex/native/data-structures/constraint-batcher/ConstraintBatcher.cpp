@@ -0,0 +1,102 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ConstraintBatcher.h"
+
+#include <numeric>
+
+namespace vox::flex {
+    namespace {
+        struct PairProvider {
+            const int32_t *pairs;
+            size_t count;
+
+            size_t constraintCount() const { return count; }
+
+            uint32_t particleCount(size_t) const { return 2; }
+
+            int32_t particle(size_t constraint, uint32_t index) const { return pairs[constraint * 2 + index]; }
+        };
+    } // namespace
+
+    // MARK: - BatchLUT
+    BatchLUT::BatchLUT(uint32_t numBatches) : _numBatches(numBatches), _batchIndex(size_t(UINT16_MAX) + 1) {
+        // index of the first '0' among the colorable bits, starting from the least significant one.
+        const uint32_t numBits = numBatches - 1;
+        for (uint32_t value = 0; value <= UINT16_MAX; ++value) {
+            uint32_t index = 0;
+            while (index < numBits && (value >> index) & 1) {
+                ++index;
+            }
+            _batchIndex[value] = uint8_t(index);
+        }
+    }
+
+    // MARK: - ConstraintBatcher
+    ConstraintBatcher::ConstraintBatcher(uint32_t maxBatches)
+        : _lut(std::clamp(maxBatches, 1u, kMaxBatches)) {}
+
+    void ConstraintBatcher::resetMasks(size_t particleCount) {
+        if (particleCount > _maskCapacity) {
+            _masks = std::make_unique<std::atomic<uint16_t>[]>(particleCount);
+            _maskCapacity = particleCount;
+        }
+        parallelFor(0, particleCount, kColoringGrain * 4, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _masks[i].store(0, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    uint32_t ConstraintBatcher::batchPairs(const int32_t *pairs, size_t count, size_t particleCount,
+                                           size_t constraintStride, std::vector<uint32_t> &sortedIndices,
+                                           std::vector<BatchData> &batchData, uint32_t rounds) {
+        return batchConstraints(PairProvider{pairs, count}, particleCount, constraintStride, sortedIndices,
+                                batchData, rounds);
+    }
+
+    void ConstraintBatcher::buildBatches(size_t count, uint32_t baseIndex, size_t constraintStride,
+                                         uint32_t *sortedIndices, std::vector<BatchData> &batchData) {
+        const uint32_t numBatches = _lut.numBatches();
+
+        // stable counting sort on the batch index; the colors end up sorted, marking batch boundaries.
+        uint32_t *indices = sortedIndices + baseIndex;
+        parallelFor(0, count, kColoringGrain, [&](size_t begin, size_t end) {
+            std::iota(indices + begin, indices + end, uint32_t(begin));
+        });
+        _sort.sort(_colors.data(), indices, count, RadixSort::bitsForMaxKey(numBatches - 1));
+
+        // smallest work item spanning whole cache lines of the sorted constraint array.
+        size_t stride = std::max<size_t>(constraintStride, 1);
+        uint32_t lineGroup = uint32_t(kCacheLineSize / std::gcd(size_t(kCacheLineSize), stride));
+        uint32_t workItemSize = (kMinWorkItemSize + lineGroup - 1) / lineGroup * lineGroup;
+
+        const uint32_t end = baseIndex + uint32_t(count);
+        uint32_t start = baseIndex;
+        for (uint32_t i = 0; i < numBatches && start < end; ++i) {
+            auto last = std::upper_bound(_colors.begin() + (start - baseIndex), _colors.begin() + count, i);
+            BatchData batch;
+            batch.isLast = i == numBatches - 1;
+            batch.batchID = batch.isLast ? 0 : uint16_t(1u << i);
+            batch.startIndex = start;
+            batch.constraintCount = baseIndex + uint32_t(last - _colors.begin()) - start;
+            if (batch.isLast) {
+                batch.workItemSize = batch.constraintCount;
+                batch.workItemCount = 1;
+            } else {
+                uint32_t alignedStart = start / workItemSize * workItemSize;
+                batch.workItemSize = workItemSize;
+                batch.workItemCount = (start + batch.constraintCount - alignedStart + workItemSize - 1) / workItemSize;
+            }
+            // rolled back claims may leave a batch empty with later ones in use.
+            if (batch.constraintCount == 0) {
+                continue;
+            }
+            batchData.push_back(batch);
+            start += batch.constraintCount;
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,221 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Parallel.h"
+#include "../../sort/RadixSort.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace vox::flex {
+    // A group of constraints sharing no particle. Constraints of a batch are
+    // sortedIndices[startIndex ..< startIndex + constraintCount] and are processed in work items of
+    // `workItemSize` constraints. The last batch collects whatever could not be colored and must be
+    // processed sequentially, as a single work item.
+    struct BatchData {
+        // bit of the batch in particle masks, 0 for the last batch.
+        uint16_t batchID = 0;
+        uint32_t startIndex = 0;
+        uint32_t constraintCount = 0;
+        uint32_t workItemSize = 0;
+        uint32_t workItemCount = 0;
+        bool isLast = false;
+
+        // Work item boundaries fall on absolute multiples of workItemSize, so two work items never write
+        // to the same cache line of a sorted constraint array; the first item of a batch may be shorter.
+        void getConstraintRange(uint32_t workItem, uint32_t &begin, uint32_t &end) const {
+            if (isLast) {
+                begin = startIndex;
+                end = startIndex + constraintCount;
+                return;
+            }
+            uint32_t alignedStart = startIndex / workItemSize * workItemSize;
+            begin = std::max(startIndex, alignedStart + workItem * workItemSize);
+            end = std::min(startIndex + constraintCount, alignedStart + (workItem + 1) * workItemSize);
+        }
+    };
+
+    // Maps a 16-bit batch mask to the first batch whose bit is clear, or to the last (overflow) batch
+    // when all of the colorable batches are taken.
+    class BatchLUT {
+    public:
+        explicit BatchLUT(uint32_t numBatches);
+
+        uint32_t numBatches() const { return _numBatches; }
+
+        uint8_t batchIndex(uint16_t mask) const { return _batchIndex[mask]; }
+
+    private:
+        uint32_t _numBatches;
+        std::vector<uint8_t> _batchIndex;
+    };
+
+    // Linear-time greedy graph coloring of constraints using per-particle bitmasks and a look-up table:
+    // a constraint goes to the first batch none of its particles belongs to yet. Constraints are colored
+    // in parallel; each one claims its batch bit on its particles with atomic ORs and retries with the
+    // updated masks if another thread claimed the same bit on a shared particle first. Coloring is thus
+    // valid but may differ between runs. Batches are then laid out contiguously with a stable radix
+    // sort on the batch index, so constraints keep their input order inside a batch.
+    //
+    // Providers expose `size_t constraintCount() const`, `uint32_t particleCount(size_t constraint) const`
+    // and `int32_t particle(size_t constraint, uint32_t index) const`.
+    class ConstraintBatcher {
+    public:
+        static constexpr uint32_t kMaxBatches = 17;
+        static constexpr uint32_t kMinWorkItemSize = 64;
+        static constexpr uint32_t kCacheLineSize = 64;
+
+        // At most kMaxBatches: 16 colorable batches plus the overflow one.
+        explicit ConstraintBatcher(uint32_t maxBatches = kMaxBatches);
+
+        uint32_t maxBatches() const { return _lut.numBatches(); }
+
+        // Fills `sortedIndices` (slot -> constraint) and one BatchData per non-empty batch in batch order, returns the
+        // number of batches. `constraintStride` is the size in bytes of a constraint in the arrays that
+        // will be reordered, used to size work items in whole cache lines.
+        //
+        // Dense graphs (fluid particles have dozens of neighbors) overflow the colorable batches. Every
+        // extra round re-colors the overflow batch with fresh masks and appends up to maxBatches - 1 more
+        // batches, until the overflow is smaller than a work item or `rounds` is reached.
+        template <typename Provider>
+        uint32_t batchConstraints(const Provider &provider, size_t particleCount, size_t constraintStride,
+                                  std::vector<uint32_t> &sortedIndices, std::vector<BatchData> &batchData,
+                                  uint32_t rounds = 1);
+
+        // Two-particle constraints (fluid interactions, particle contacts) given as (a, b) pairs.
+        uint32_t batchPairs(const int32_t *pairs, size_t count, size_t particleCount, size_t constraintStride,
+                            std::vector<uint32_t> &sortedIndices, std::vector<BatchData> &batchData,
+                            uint32_t rounds = 1);
+
+        // Gathers constraints into batch order: out[i] = in[sortedIndices[i]].
+        template <typename T>
+        static void reorder(const T *in, T *out, const std::vector<uint32_t> &sortedIndices);
+
+    private:
+        static constexpr size_t kColoringGrain = 4096;
+        // conflicts before a constraint gives up and goes to the overflow batch.
+        static constexpr int kMaxColoringAttempts = 16;
+
+        void resetMasks(size_t particleCount);
+
+        // constraints of a provider picked by index, for the re-coloring rounds.
+        template <typename Provider>
+        struct SubsetProvider {
+            const Provider &provider;
+            const uint32_t *indices;
+            size_t count;
+
+            size_t constraintCount() const { return count; }
+
+            uint32_t particleCount(size_t constraint) const { return provider.particleCount(indices[constraint]); }
+
+            int32_t particle(size_t constraint, uint32_t index) const {
+                return provider.particle(indices[constraint], index);
+            }
+        };
+
+        template <typename Provider>
+        uint8_t colorConstraint(const Provider &provider, size_t constraint) const;
+
+        template <typename Provider>
+        void colorConstraints(const Provider &provider, size_t particleCount);
+
+        // Sorts the `count` colored constraints into sortedIndices[baseIndex ..< baseIndex + count] (indices
+        // relative to the colored set) and appends their batches to `batchData`.
+        void buildBatches(size_t count, uint32_t baseIndex, size_t constraintStride, uint32_t *sortedIndices,
+                          std::vector<BatchData> &batchData);
+
+        BatchLUT _lut;
+        std::unique_ptr<std::atomic<uint16_t>[]> _masks;
+        size_t _maskCapacity = 0;
+        std::vector<uint32_t> _colors;
+        std::vector<uint32_t> _overflow;
+        RadixSort _sort;
+    };
+
+    template <typename Provider>
+    uint8_t ConstraintBatcher::colorConstraint(const Provider &provider, size_t constraint) const {
+        const uint8_t overflow = uint8_t(_lut.numBatches() - 1);
+        const uint32_t particleCount = provider.particleCount(constraint);
+        for (int attempt = 0; attempt < kMaxColoringAttempts; ++attempt) {
+            uint16_t mask = 0;
+            for (uint32_t k = 0; k < particleCount; ++k) {
+                mask |= _masks[provider.particle(constraint, k)].load(std::memory_order_relaxed);
+            }
+            const uint8_t batch = _lut.batchIndex(mask);
+            if (batch == overflow) {
+                return overflow;
+            }
+
+            // claim the batch bit on every particle; on conflict release the ones claimed so far and retry.
+            const uint16_t bit = uint16_t(1u << batch);
+            uint32_t claimed = 0;
+            while (claimed < particleCount &&
+                   !(_masks[provider.particle(constraint, claimed)].fetch_or(bit, std::memory_order_relaxed) & bit)) {
+                ++claimed;
+            }
+            if (claimed == particleCount) {
+                return batch;
+            }
+            for (uint32_t k = 0; k < claimed; ++k) {
+                _masks[provider.particle(constraint, k)].fetch_and(uint16_t(~bit), std::memory_order_relaxed);
+            }
+        }
+        return overflow;
+    }
+
+    template <typename Provider>
+    void ConstraintBatcher::colorConstraints(const Provider &provider, size_t particleCount) {
+        const size_t count = provider.constraintCount();
+        resetMasks(particleCount);
+        _colors.resize(count);
+        parallelFor(0, count, kColoringGrain, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                _colors[c] = colorConstraint(provider, c);
+            }
+        });
+    }
+
+    template <typename Provider>
+    uint32_t ConstraintBatcher::batchConstraints(const Provider &provider, size_t particleCount,
+                                                 size_t constraintStride, std::vector<uint32_t> &sortedIndices,
+                                                 std::vector<BatchData> &batchData, uint32_t rounds) {
+        const size_t count = provider.constraintCount();
+        colorConstraints(provider, particleCount);
+        sortedIndices.resize(count);
+        batchData.clear();
+        buildBatches(count, 0, constraintStride, sortedIndices.data(), batchData);
+
+        for (uint32_t round = 1; round < rounds && !batchData.empty() && batchData.back().isLast &&
+                                 batchData.back().constraintCount >= kMinWorkItemSize;
+             ++round) {
+            const uint32_t start = batchData.back().startIndex;
+            batchData.pop_back();
+            _overflow.assign(sortedIndices.begin() + start, sortedIndices.end());
+
+            colorConstraints(SubsetProvider<Provider>{provider, _overflow.data(), _overflow.size()}, particleCount);
+            buildBatches(_overflow.size(), start, constraintStride, sortedIndices.data(), batchData);
+            parallelFor(start, count, kColoringGrain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    sortedIndices[i] = _overflow[sortedIndices[i]];
+                }
+            });
+        }
+        return uint32_t(batchData.size());
+    }
+
+    template <typename T>
+    void ConstraintBatcher::reorder(const T *in, T *out, const std::vector<uint32_t> &sortedIndices) {
+        parallelFor(0, sortedIndices.size(), kColoringGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                out[i] = in[sortedIndices[i]];
+            }
+        });
+    }
+} // namespace vox::flex
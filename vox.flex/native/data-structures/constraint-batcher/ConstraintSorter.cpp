@@ -0,0 +1,49 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ConstraintSorter.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kSortGrain = 4096;
+    } // namespace
+
+    void ConstraintSorter::sortPairs(const int32_t *pairs, size_t count, size_t particleCount,
+                                     std::vector<uint32_t> &sortedIndices) {
+        _keys.resize(count);
+        sortedIndices.resize(count);
+        parallelFor(0, count, kSortGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _keys[i] = uint32_t(pairs[i * 2]);
+                sortedIndices[i] = uint32_t(i);
+            }
+        });
+        const uint32_t maxKey = particleCount > 0 ? uint32_t(particleCount - 1) : 0;
+        _sort.sort(_keys.data(), sortedIndices.data(), count, RadixSort::bitsForMaxKey(maxKey));
+
+        // every chunk sorts the runs starting inside it, runs may extend past the chunk end.
+        parallelFor(0, count, kSortGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (i > 0 && _keys[i] == _keys[i - 1]) {
+                    continue;
+                }
+                size_t runEnd = i + 1;
+                while (runEnd < count && _keys[runEnd] == _keys[i]) {
+                    ++runEnd;
+                }
+                if (runEnd - i > 1) {
+                    std::stable_sort(sortedIndices.begin() + i, sortedIndices.begin() + runEnd,
+                                     [&](uint32_t a, uint32_t b) { return pairs[a * 2 + 1] < pairs[b * 2 + 1]; });
+                }
+                i = runEnd - 1;
+            }
+        });
+    }
+} // namespace vox::flex
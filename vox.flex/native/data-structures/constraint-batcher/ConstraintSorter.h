@@ -0,0 +1,26 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../sort/RadixSort.h"
+#include <vector>
+
+namespace vox::flex {
+    // Puts constraints generated in arbitrary order by parallel jobs (contacts, fluid interactions)
+    // into a deterministic order: by first particle with a counting (radix) sort, then each run of
+    // constraints sharing their first particle by second particle, runs being sorted in parallel.
+    class ConstraintSorter {
+    public:
+        // `pairs` holds the (first, second) particles of every constraint. On return sortedIndices[i] is
+        // the constraint at position i; constraints with the same pair keep their input order.
+        void sortPairs(const int32_t *pairs, size_t count, size_t particleCount, std::vector<uint32_t> &sortedIndices);
+
+    private:
+        std::vector<uint32_t> _keys;
+        RadixSort _sort;
+    };
+} // namespace vox::flex
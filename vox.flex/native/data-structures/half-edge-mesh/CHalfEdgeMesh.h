@@ -0,0 +1,66 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+/// See HalfEdge in HalfEdgeMesh.h.
+typedef struct {
+    int32_t face;
+    int32_t nextHalfEdge;
+    int32_t pair;
+    int32_t endVertex;
+} CHalfEdge;
+
+/// Welded half-edge topology of a triangle mesh, see HalfEdgeMesh.h.
+@interface CHalfEdgeMesh : NSObject
+
+/// `triangles` holds three indices of `positions` per triangle. Welded positions are multiplied by `scale`.
+- (void)buildWithPositions:(const simd_float3 *_Nonnull)positions
+               vertexCount:(uint32_t)vertexCount
+                 triangles:(const int32_t *_Nonnull)triangles
+             triangleCount:(uint32_t)triangleCount
+                     scale:(simd_float3)scale;
+
+@property(nonatomic, readonly) uint32_t rawVertexCount;
+@property(nonatomic, readonly) uint32_t vertexCount;
+@property(nonatomic, readonly) uint32_t faceCount;
+/// face half-edges first, three per face, then border ones.
+@property(nonatomic, readonly) uint32_t halfEdgeCount;
+@property(nonatomic, readonly) uint32_t borderEdgeCount;
+@property(nonatomic, readonly) uint32_t edgeCount;
+/// half-edges in the adjacency table: every one but the sides of degenerate faces.
+@property(nonatomic, readonly) uint32_t outgoingCount;
+@property(nonatomic, readonly) uint64_t meshHash;
+@property(nonatomic, readonly) float area;
+@property(nonatomic, readonly) float volume;
+
+/// One entry per welded vertex in every non-null array.
+- (void)getPositions:(simd_float4 *_Nullable)positions
+         restNormals:(simd_float4 *_Nullable)restNormals
+    restOrientations:(simd_quatf *_Nullable)restOrientations
+   areaContributions:(float *_Nullable)areaContributions;
+
+- (void)getHalfEdges:(CHalfEdge *_Nonnull)halfEdges;
+
+/// Three welded vertices per face.
+- (void)getTriangles:(int32_t *_Nonnull)triangles;
+
+/// Welded vertex of every raw one.
+- (void)getRawToWelded:(int32_t *_Nonnull)rawToWelded;
+
+/// First half-edge leaving every vertex, and the CSR table of all of them: vertexCount + 1 offsets and
+/// outgoingCount half-edges.
+- (void)getVertexHalfEdges:(int32_t *_Nonnull)vertexHalfEdges
+           outgoingOffsets:(int32_t *_Nonnull)outgoingOffsets
+         outgoingHalfEdges:(int32_t *_Nonnull)outgoingHalfEdges;
+
+/// One half-edge per edge.
+- (void)getEdges:(int32_t *_Nonnull)edges;
+
+@end
@@ -0,0 +1,117 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CHalfEdgeMeshInternal.h"
+#include <algorithm>
+
+using namespace vox::flex;
+
+static_assert(sizeof(float3) == sizeof(simd_float3), "float3 must match simd_float3 layout");
+static_assert(sizeof(float4) == sizeof(simd_float4), "float4 must match simd_float4 layout");
+static_assert(sizeof(quaternion) == sizeof(simd_quatf), "quaternion must match simd_quatf layout");
+static_assert(sizeof(HalfEdge) == sizeof(CHalfEdge), "HalfEdge must match CHalfEdge layout");
+
+@implementation CHalfEdgeMesh {
+    HalfEdgeMesh _mesh;
+}
+
+- (const HalfEdgeMesh *)nativeMesh {
+    return &_mesh;
+}
+
+- (void)buildWithPositions:(const simd_float3 *)positions
+               vertexCount:(uint32_t)vertexCount
+                 triangles:(const int32_t *)triangles
+             triangleCount:(uint32_t)triangleCount
+                     scale:(simd_float3)scale {
+    _mesh.build(reinterpret_cast<const float3 *>(positions), vertexCount, triangles, triangleCount,
+                float3(scale.x, scale.y, scale.z));
+}
+
+- (uint32_t)rawVertexCount {
+    return uint32_t(_mesh.rawToWelded().size());
+}
+
+- (uint32_t)vertexCount {
+    return uint32_t(_mesh.vertexCount());
+}
+
+- (uint32_t)faceCount {
+    return uint32_t(_mesh.faceCount());
+}
+
+- (uint32_t)halfEdgeCount {
+    return uint32_t(_mesh.halfEdgeCount());
+}
+
+- (uint32_t)borderEdgeCount {
+    return uint32_t(_mesh.borderEdgeCount());
+}
+
+- (uint32_t)edgeCount {
+    return uint32_t(_mesh.edges().size());
+}
+
+- (uint32_t)outgoingCount {
+    return uint32_t(_mesh.outgoingHalfEdges().size());
+}
+
+- (uint64_t)meshHash {
+    return _mesh.hash();
+}
+
+- (float)area {
+    return _mesh.area();
+}
+
+- (float)volume {
+    return _mesh.volume();
+}
+
+- (void)getPositions:(simd_float4 *)positions
+         restNormals:(simd_float4 *)restNormals
+    restOrientations:(simd_quatf *)restOrientations
+   areaContributions:(float *)areaContributions {
+    if (positions) {
+        std::copy(_mesh.positions().begin(), _mesh.positions().end(), reinterpret_cast<float4 *>(positions));
+    }
+    if (restNormals) {
+        std::copy(_mesh.restNormals().begin(), _mesh.restNormals().end(), reinterpret_cast<float4 *>(restNormals));
+    }
+    if (restOrientations) {
+        std::copy(_mesh.restOrientations().begin(), _mesh.restOrientations().end(),
+                  reinterpret_cast<quaternion *>(restOrientations));
+    }
+    if (areaContributions) {
+        std::copy(_mesh.areaContributions().begin(), _mesh.areaContributions().end(), areaContributions);
+    }
+}
+
+- (void)getHalfEdges:(CHalfEdge *)halfEdges {
+    std::copy(_mesh.halfEdges().begin(), _mesh.halfEdges().end(), reinterpret_cast<HalfEdge *>(halfEdges));
+}
+
+- (void)getTriangles:(int32_t *)triangles {
+    std::copy(_mesh.triangles().begin(), _mesh.triangles().end(), triangles);
+}
+
+- (void)getRawToWelded:(int32_t *)rawToWelded {
+    std::copy(_mesh.rawToWelded().begin(), _mesh.rawToWelded().end(), rawToWelded);
+}
+
+- (void)getVertexHalfEdges:(int32_t *)vertexHalfEdges
+           outgoingOffsets:(int32_t *)outgoingOffsets
+         outgoingHalfEdges:(int32_t *)outgoingHalfEdges {
+    std::copy(_mesh.vertexHalfEdges().begin(), _mesh.vertexHalfEdges().end(), vertexHalfEdges);
+    std::copy(_mesh.outgoingOffsets().begin(), _mesh.outgoingOffsets().end(), outgoingOffsets);
+    std::copy(_mesh.outgoingHalfEdges().begin(), _mesh.outgoingHalfEdges().end(), outgoingHalfEdges);
+}
+
+- (void)getEdges:(int32_t *)edges {
+    std::copy(_mesh.edges().begin(), _mesh.edges().end(), edges);
+}
+
+@end
@@ -0,0 +1,17 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "CHalfEdgeMesh.h"
+#include "HalfEdgeMesh.h"
+
+/// Native access for the blueprint facades, Objective-C++ only.
+@interface CHalfEdgeMesh ()
+
+- (const vox::flex::HalfEdgeMesh *_Nonnull)nativeMesh;
+
+@end
@@ -0,0 +1,372 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "HalfEdgeMesh.h"
+#include "../../collisions/TriangleMeshContainer.h"
+#include "../../common/Parallel.h"
+#include "../../sort/RadixSort.h"
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kFaceGrain = 2048;
+        constexpr size_t kVertexGrain = 1024;
+        // fixed block size of compactions and sums, so their results don't depend on the thread count.
+        constexpr size_t kBlockSize = 4096;
+        constexpr uint64_t kEmptyKey = std::numeric_limits<uint64_t>::max();
+        constexpr int32_t kNone = std::numeric_limits<int32_t>::max();
+
+        size_t tableCapacity(size_t count) {
+            size_t capacity = 16;
+            while (capacity < count * 2) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        uint64_t mix(uint64_t key) { return key * 0x9E3779B97F4A7C15ull; }
+
+        uint64_t edgeKey(int32_t start, int32_t end) { return uint64_t(uint32_t(start)) << 32 | uint32_t(end); }
+
+        void atomicMin(std::atomic<int32_t> &target, int32_t value) {
+            int32_t current = target.load(std::memory_order_relaxed);
+            while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+        }
+
+        // Indices i < count for which `keep(i)` holds, in order: every block counts its survivors, a scan
+        // gives the block's first output slot.
+        template <typename Predicate>
+        void compact(size_t count, Predicate &&keep, AlignedVector<int32_t> &out) {
+            const size_t blockCount = (count + kBlockSize - 1) / kBlockSize;
+            std::vector<int32_t> offsets(blockCount);
+            parallelForEach(blockCount, 1, [&](size_t block) {
+                int32_t kept = 0;
+                for (size_t i = block * kBlockSize, end = std::min(count, i + kBlockSize); i < end; ++i) {
+                    kept += keep(i) ? 1 : 0;
+                }
+                offsets[block] = kept;
+            });
+            out.resize(size_t(parallelExclusiveScan(offsets.data(), offsets.data(), blockCount)));
+            parallelForEach(blockCount, 1, [&](size_t block) {
+                int32_t slot = offsets[block];
+                for (size_t i = block * kBlockSize, end = std::min(count, i + kBlockSize); i < end; ++i) {
+                    if (keep(i)) {
+                        out[slot++] = int32_t(i);
+                    }
+                }
+            });
+        }
+
+        // Open-addressing table from directed edges to the lowest half-edge running along them. Half-edges
+        // are inserted concurrently: a slot is claimed by swapping its key in, then its half-edge lowered.
+        class EdgeTable {
+        public:
+            explicit EdgeTable(size_t count)
+                : _mask(tableCapacity(count) - 1), _keys(new std::atomic<uint64_t>[_mask + 1]),
+                  _halfEdges(new std::atomic<int32_t>[_mask + 1]) {
+                parallelFor(0, _mask + 1, kBlockSize, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        _keys[i].store(kEmptyKey, std::memory_order_relaxed);
+                        _halfEdges[i].store(kNone, std::memory_order_relaxed);
+                    }
+                });
+            }
+
+            void insert(uint64_t key, int32_t halfEdge) {
+                for (size_t slot = home(key);; slot = (slot + 1) & _mask) {
+                    uint64_t current = _keys[slot].load(std::memory_order_relaxed);
+                    if (current == kEmptyKey &&
+                        _keys[slot].compare_exchange_strong(current, key, std::memory_order_relaxed)) {
+                        current = key;
+                    }
+                    if (current == key) {
+                        atomicMin(_halfEdges[slot], halfEdge);
+                        return;
+                    }
+                }
+            }
+
+            // -1 if no half-edge runs along `key`.
+            int32_t find(uint64_t key) const {
+                for (size_t slot = home(key);; slot = (slot + 1) & _mask) {
+                    const uint64_t current = _keys[slot].load(std::memory_order_relaxed);
+                    if (current == key) {
+                        return _halfEdges[slot].load(std::memory_order_relaxed);
+                    }
+                    if (current == kEmptyKey) {
+                        return -1;
+                    }
+                }
+            }
+
+        private:
+            size_t home(uint64_t key) const { return size_t(mix(key) >> 32) & _mask; }
+
+            size_t _mask;
+            std::unique_ptr<std::atomic<uint64_t>[]> _keys;
+            std::unique_ptr<std::atomic<int32_t>[]> _halfEdges;
+        };
+
+        // Rotation whose third axis is `forward` and whose second one is as close to `up` as possible, identity
+        // if they are parallel.
+        quaternion lookRotation(const float3 &forward, const float3 &up) {
+            const float3 z = normalize(forward);
+            const float3 x = normalize(cross(up, z));
+            if (lengthSquared(z) == 0 || lengthSquared(x) == 0) {
+                return {};
+            }
+            const float3 y = cross(z, x);
+            const float trace = x.x + y.y + z.z;
+            quaternion q;
+            if (trace > 0) {
+                const float s = std::sqrt(trace + 1) * 2;
+                q = {(y.z - z.y) / s, (z.x - x.z) / s, (x.y - y.x) / s, s * 0.25f};
+            } else if (x.x > y.y && x.x > z.z) {
+                const float s = std::sqrt(1 + x.x - y.y - z.z) * 2;
+                q = {s * 0.25f, (y.x + x.y) / s, (z.x + x.z) / s, (y.z - z.y) / s};
+            } else if (y.y > z.z) {
+                const float s = std::sqrt(1 + y.y - x.x - z.z) * 2;
+                q = {(y.x + x.y) / s, s * 0.25f, (z.y + y.z) / s, (z.x - x.z) / s};
+            } else {
+                const float s = std::sqrt(1 + z.z - x.x - y.y) * 2;
+                q = {(z.x + x.z) / s, (z.y + y.z) / s, s * 0.25f, (x.y - y.x) / s};
+            }
+            return normalize(q);
+        }
+    } // namespace
+
+    void HalfEdgeMesh::build(const float3 *positions, size_t vertexCount, const int32_t *triangles,
+                             size_t triangleCount, const float3 &scale) {
+        weld(positions, vertexCount, triangles, triangleCount, scale);
+        pairHalfEdges();
+        linkBorder();
+        buildAdjacency();
+        calculateRestFrames();
+    }
+
+    float HalfEdgeMesh::faceArea(size_t face) const {
+        const float3 a = _positions[_triangles[face * 3]].xyz();
+        const float3 b = _positions[_triangles[face * 3 + 1]].xyz();
+        const float3 c = _positions[_triangles[face * 3 + 2]].xyz();
+        return length(cross(b - a, c - a)) * 0.5f;
+    }
+
+    void HalfEdgeMesh::weld(const float3 *positions, size_t vertexCount, const int32_t *triangles,
+                            size_t triangleCount, const float3 &scale) {
+        std::vector<float3> scaled(vertexCount);
+        parallelFor(0, vertexCount, kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                // adding zero turns -0 into +0, so both hash alike.
+                scaled[i] = positions[i] * scale + float3(0.f);
+            }
+        });
+        _hash = TriangleMeshContainer::hashMesh(scaled.data(), vertexCount, triangles, triangleCount);
+
+        // vertices are numbered in order of first appearance, which makes this pass sequential.
+        _positions.clear();
+        _rawToWelded.resize(vertexCount);
+        std::vector<int32_t> table(tableCapacity(vertexCount), -1);
+        const size_t mask = table.size() - 1;
+        for (size_t i = 0; i < vertexCount; ++i) {
+            const float3 &p = scaled[i];
+            uint32_t bits[3];
+            std::memcpy(&bits[0], &p.x, sizeof(float));
+            std::memcpy(&bits[1], &p.y, sizeof(float));
+            std::memcpy(&bits[2], &p.z, sizeof(float));
+            const uint64_t key = mix(mix(mix(bits[0]) ^ bits[1]) ^ bits[2]);
+            size_t slot = size_t(key >> 32) & mask;
+            while (table[slot] >= 0) {
+                const float4 &welded = _positions[table[slot]];
+                if (welded.x == p.x && welded.y == p.y && welded.z == p.z) {
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+            if (table[slot] < 0) {
+                table[slot] = int32_t(_positions.size());
+                _positions.push_back(float4(p, 0));
+            }
+            _rawToWelded[i] = table[slot];
+        }
+
+        _triangles.resize(triangleCount * 3);
+        parallelFor(0, triangleCount * 3, kFaceGrain * 3, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _triangles[i] = _rawToWelded[triangles[i]];
+            }
+        });
+    }
+
+    void HalfEdgeMesh::pairHalfEdges() {
+        const size_t faceEdges = _triangles.size();
+        _halfEdges.resize(faceEdges);
+        EdgeTable table(faceEdges);
+        parallelFor(0, faceEdges, kFaceGrain, [&](size_t begin, size_t end) {
+            for (size_t h = begin; h < end; ++h) {
+                const size_t face = h / 3, next = face * 3 + (h + 1) % 3;
+                HalfEdge &edge = _halfEdges[h];
+                edge.face = int32_t(face);
+                edge.nextHalfEdge = int32_t(next);
+                edge.pair = -1;
+                edge.endVertex = _triangles[next];
+                if (_triangles[h] != edge.endVertex) {
+                    table.insert(edgeKey(_triangles[h], edge.endVertex), int32_t(h));
+                }
+            }
+        });
+
+        // only the lowest half-edge along a directed edge pairs, so pairs are mutual.
+        parallelFor(0, faceEdges, kFaceGrain, [&](size_t begin, size_t end) {
+            for (size_t h = begin; h < end; ++h) {
+                const int32_t start = _triangles[h], finish = _halfEdges[h].endVertex;
+                if (start != finish && table.find(edgeKey(start, finish)) == int32_t(h)) {
+                    _halfEdges[h].pair = table.find(edgeKey(finish, start));
+                }
+            }
+        });
+    }
+
+    void HalfEdgeMesh::linkBorder() {
+        const size_t faceEdges = _triangles.size();
+        AlignedVector<int32_t> unpaired;
+        compact(
+            faceEdges,
+            [&](size_t h) { return _halfEdges[h].pair < 0 && _triangles[h] != _halfEdges[h].endVertex; },
+            unpaired);
+
+        // the border half-edge of face half-edge h runs back along it, from its end to its start.
+        const size_t borderCount = unpaired.size();
+        _halfEdges.resize(faceEdges + borderCount);
+        std::unique_ptr<std::atomic<int32_t>[]> leaving(new std::atomic<int32_t>[_positions.size()]);
+        parallelFor(0, _positions.size(), kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                leaving[v].store(kNone, std::memory_order_relaxed);
+            }
+        });
+        parallelFor(0, borderCount, kFaceGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const int32_t h = unpaired[i], border = int32_t(faceEdges + i);
+                _halfEdges[h].pair = border;
+                _halfEdges[border] = {-1, -1, h, _triangles[h]};
+                atomicMin(leaving[_halfEdges[h].endVertex], border);
+            }
+        });
+        // around a hole, the next border half-edge leaves the vertex this one ends at.
+        parallelFor(0, borderCount, kFaceGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                HalfEdge &border = _halfEdges[faceEdges + i];
+                border.nextHalfEdge = leaving[border.endVertex].load(std::memory_order_relaxed);
+            }
+        });
+    }
+
+    void HalfEdgeMesh::buildAdjacency() {
+        const size_t vertexCount = _positions.size();
+        const size_t halfEdgeCount = _halfEdges.size();
+
+        // sorted by start vertex, the sides of degenerate faces last.
+        std::vector<uint32_t> keys(halfEdgeCount), values(halfEdgeCount);
+        parallelFor(0, halfEdgeCount, kFaceGrain, [&](size_t begin, size_t end) {
+            for (size_t h = begin; h < end; ++h) {
+                keys[h] = _halfEdges[h].pair < 0 ? uint32_t(vertexCount) : uint32_t(startVertex(int32_t(h)));
+                values[h] = uint32_t(h);
+            }
+        });
+        RadixSort sort;
+        sort.sort(keys.data(), values.data(), halfEdgeCount, RadixSort::bitsForMaxKey(uint32_t(vertexCount)));
+
+        // every vertex starts at the first key not below it.
+        _outgoingOffsets.resize(vertexCount + 1);
+        parallelFor(0, halfEdgeCount + 1, kFaceGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const size_t first = i == 0 ? 0 : size_t(keys[i - 1]) + 1;
+                const size_t last = i == halfEdgeCount ? vertexCount : std::min(size_t(keys[i]), vertexCount);
+                for (size_t v = first; v <= last; ++v) {
+                    _outgoingOffsets[v] = int32_t(i);
+                }
+            }
+        });
+        _outgoingHalfEdges.resize(size_t(_outgoingOffsets[vertexCount]));
+        _vertexHalfEdges.resize(vertexCount);
+        parallelFor(0, _outgoingHalfEdges.size(), kFaceGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _outgoingHalfEdges[i] = int32_t(values[i]);
+            }
+        });
+        parallelFor(0, vertexCount, kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                const int32_t first = _outgoingOffsets[v];
+                _vertexHalfEdges[v] = first < _outgoingOffsets[v + 1] ? _outgoingHalfEdges[first] : -1;
+            }
+        });
+
+        // border half-edges are above every face one, so a side is listed once by its face half-edge.
+        compact(
+            _triangles.size(),
+            [&](size_t h) { return _halfEdges[h].pair > int32_t(h); },
+            _edges);
+    }
+
+    void HalfEdgeMesh::calculateRestFrames() {
+        const size_t vertexCount = _positions.size();
+        _restNormals.resize(vertexCount);
+        _restOrientations.resize(vertexCount);
+        _areaContributions.resize(vertexCount);
+        parallelFor(0, vertexCount, kVertexGrain, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                // every face around v has exactly one half-edge leaving it.
+                float3 normal;
+                float area = 0;
+                for (int32_t i = _outgoingOffsets[v]; i < _outgoingOffsets[v + 1]; ++i) {
+                    const int32_t face = _halfEdges[_outgoingHalfEdges[i]].face;
+                    if (face >= 0) {
+                        const float3 a = _positions[_triangles[face * 3]].xyz();
+                        const float3 weighted = cross(_positions[_triangles[face * 3 + 1]].xyz() - a,
+                                                      _positions[_triangles[face * 3 + 2]].xyz() - a);
+                        normal += weighted;
+                        area += length(weighted) * 0.5f;
+                    }
+                }
+                normal = normalize(normal);
+                _restNormals[v] = float4(normal, 0);
+                _areaContributions[v] = area / 3;
+
+                const int32_t halfEdge = _vertexHalfEdges[v];
+                _restOrientations[v] = halfEdge < 0 ? quaternion()
+                                                    : lookRotation(normal, (_positions[_halfEdges[halfEdge].endVertex] -
+                                                                            _positions[v]).xyz());
+            }
+        });
+
+        const size_t faceCount = this->faceCount();
+        const size_t blockCount = (faceCount + kBlockSize - 1) / kBlockSize;
+        std::vector<float> areas(blockCount), volumes(blockCount);
+        parallelForEach(blockCount, 1, [&](size_t block) {
+            float area = 0, volume = 0;
+            for (size_t f = block * kBlockSize, end = std::min(faceCount, f + kBlockSize); f < end; ++f) {
+                const float3 a = _positions[_triangles[f * 3]].xyz();
+                const float3 b = _positions[_triangles[f * 3 + 1]].xyz();
+                const float3 c = _positions[_triangles[f * 3 + 2]].xyz();
+                area += length(cross(b - a, c - a)) * 0.5f;
+                volume += dot(a, cross(b, c)) / 6;
+            }
+            areas[block] = area;
+            volumes[block] = volume;
+        });
+        _area = 0;
+        _volume = 0;
+        for (size_t block = 0; block < blockCount; ++block) {
+            _area += areas[block];
+            _volume += volumes[block];
+        }
+    }
+} // namespace vox::flex
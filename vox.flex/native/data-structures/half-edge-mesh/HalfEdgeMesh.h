@@ -0,0 +1,121 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/AlignedVector.h"
+#include "../../common/Math.h"
+
+namespace vox::flex {
+    // Half-edge of face f's k-th side, index f * 3 + k, going from the face's k-th vertex to its (k + 1)-th.
+    // Border half-edges follow the face ones, one per side no other face shares, with no face of their own.
+    struct HalfEdge {
+        int32_t face = -1;
+        int32_t nextHalfEdge = -1;
+        // opposite half-edge, -1 for the sides of degenerate faces only.
+        int32_t pair = -1;
+        int32_t endVertex = -1;
+    };
+
+    // Native counterpart of HalfEdgeMesh: the welded topology of a triangle mesh, built in parallel.
+    //   welding:   raw vertices at the same position become one vertex, in order of first appearance,
+    //   pairing:   every face half-edge is entered in an open-addressing table keyed by its (start, end)
+    //              vertices, then finds its pair by looking up (end, start). A side shared by more than two
+    //              faces pairs its lowest half-edges and leaves the others on the border,
+    //   border:    sides left unpaired get a border half-edge, linked around each hole,
+    //   adjacency: the half-edges leaving every vertex are sorted by vertex into a CSR table, which gives the
+    //              neighbor vertices (their end vertices), edges and faces of a vertex without any walk.
+    // Every stage is deterministic, so the same mesh always gives the same topology.
+    class HalfEdgeMesh {
+    public:
+        // `positions` holds vertexCount raw vertices, `triangles` three indices of them per triangle. Welded
+        // positions are multiplied by `scale`.
+        void build(const float3 *positions, size_t vertexCount, const int32_t *triangles, size_t triangleCount,
+                   const float3 &scale = float3(1, 1, 1));
+
+        size_t vertexCount() const { return _positions.size(); }
+
+        size_t faceCount() const { return _triangles.size() / 3; }
+
+        size_t halfEdgeCount() const { return _halfEdges.size(); }
+
+        size_t borderEdgeCount() const { return _halfEdges.size() - faceCount() * 3; }
+
+        // Key of the raw mesh and scale, see TriangleMeshContainer::hashMesh.
+        uint64_t hash() const { return _hash; }
+
+        float area() const { return _area; }
+
+        // signed volume enclosed by the faces, positive when they face outwards.
+        float volume() const { return _volume; }
+
+        const AlignedVector<float4> &positions() const { return _positions; }
+
+        // three welded vertices per face.
+        const AlignedVector<int32_t> &triangles() const { return _triangles; }
+
+        const AlignedVector<int32_t> &rawToWelded() const { return _rawToWelded; }
+
+        const AlignedVector<HalfEdge> &halfEdges() const { return _halfEdges; }
+
+        // first half-edge leaving every vertex, a face one unless the vertex only has degenerate faces, -1 for
+        // vertices no face uses.
+        const AlignedVector<int32_t> &vertexHalfEdges() const { return _vertexHalfEdges; }
+
+        // half-edges leaving vertex v are outgoingHalfEdges[outgoingOffsets[v] ..< outgoingOffsets[v + 1]], by
+        // index, so face half-edges come first.
+        const AlignedVector<int32_t> &outgoingOffsets() const { return _outgoingOffsets; }
+
+        const AlignedVector<int32_t> &outgoingHalfEdges() const { return _outgoingHalfEdges; }
+
+        // one half-edge per edge: the lowest of the two.
+        const AlignedVector<int32_t> &edges() const { return _edges; }
+
+        // area weighted vertex normals.
+        const AlignedVector<float4> &restNormals() const { return _restNormals; }
+
+        // frames looking along the rest normal, up towards the end of the vertex's half-edge.
+        const AlignedVector<quaternion> &restOrientations() const { return _restOrientations; }
+
+        // a third of the area of every face around each vertex.
+        const AlignedVector<float> &areaContributions() const { return _areaContributions; }
+
+        int32_t startVertex(int32_t halfEdge) const {
+            const int32_t faceEdges = int32_t(_triangles.size());
+            return halfEdge < faceEdges ? _triangles[halfEdge]
+                                        : _halfEdges[_halfEdges[halfEdge].pair].endVertex;
+        }
+
+        float faceArea(size_t face) const;
+
+    private:
+        void weld(const float3 *positions, size_t vertexCount, const int32_t *triangles, size_t triangleCount,
+                  const float3 &scale);
+
+        void pairHalfEdges();
+
+        void linkBorder();
+
+        void buildAdjacency();
+
+        void calculateRestFrames();
+
+        uint64_t _hash = 0;
+        float _area = 0;
+        float _volume = 0;
+        AlignedVector<float4> _positions;
+        AlignedVector<int32_t> _triangles;
+        AlignedVector<int32_t> _rawToWelded;
+        AlignedVector<HalfEdge> _halfEdges;
+        AlignedVector<int32_t> _vertexHalfEdges;
+        AlignedVector<int32_t> _outgoingOffsets;
+        AlignedVector<int32_t> _outgoingHalfEdges;
+        AlignedVector<int32_t> _edges;
+        AlignedVector<float4> _restNormals;
+        AlignedVector<quaternion> _restOrientations;
+        AlignedVector<float> _areaContributions;
+    };
+} // namespace vox::flex
@@ -0,0 +1,100 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "HeightField.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    void HeightField::resize(int32_t resolutionU, int32_t resolutionV) {
+        _resolutionU = std::max(resolutionU, 2);
+        _resolutionV = std::max(resolutionV, 2);
+        _tileCountU = (cellCountU() + kTileCells - 1) / kTileCells;
+        _tileCountV = (cellCountV() + kTileCells - 1) / kTileCells;
+        _tiles.assign(size_t(_tileCountU) * size_t(_tileCountV) * kTileStride, 0.f);
+        _tileInfos.assign(size_t(_tileCountU) * size_t(_tileCountV), TileInfo());
+    }
+
+    void HeightField::setSamples(int32_t u, int32_t v, int32_t width, int32_t height, const float *samples) {
+        const int32_t beginU = std::max(u, 0), endU = std::min(u + width, _resolutionU);
+        const int32_t beginV = std::max(v, 0), endV = std::min(v + height, _resolutionV);
+        if (beginU >= endU || beginV >= endV) {
+            return;
+        }
+
+        // a sample on the border between tiles is also stored by the tiles before it.
+        for (int32_t sv = beginV; sv < endV; ++sv) {
+            const int32_t lastTileV = std::min(sv / kTileCells, _tileCountV - 1);
+            const int32_t firstTileV = sv % kTileCells == 0 && sv > 0 ? sv / kTileCells - 1 : lastTileV;
+            for (int32_t su = beginU; su < endU; ++su) {
+                const float value = samples[size_t(sv - v) * size_t(width) + size_t(su - u)];
+                const int32_t lastTileU = std::min(su / kTileCells, _tileCountU - 1);
+                const int32_t firstTileU = su % kTileCells == 0 && su > 0 ? su / kTileCells - 1 : lastTileU;
+                for (int32_t tileV = firstTileV; tileV <= lastTileV; ++tileV) {
+                    for (int32_t tileU = firstTileU; tileU <= lastTileU; ++tileU) {
+                        const size_t offset =
+                            size_t(sv - tileV * kTileCells) * kTileSamples + size_t(su - tileU * kTileCells);
+                        _tiles[size_t(tileIndex(tileU, tileV)) * kTileStride + offset] = value;
+                    }
+                }
+            }
+        }
+
+        const int32_t lastCellU = std::min(endU - 1, cellCountU() - 1);
+        const int32_t lastCellV = std::min(endV - 1, cellCountV() - 1);
+        updateRanges(std::max(beginU - 1, 0) / kTileCells, lastCellU / kTileCells,
+                     std::max(beginV - 1, 0) / kTileCells, lastCellV / kTileCells);
+    }
+
+    void HeightField::setHoles(int32_t u, int32_t v, int32_t width, int32_t height, const uint8_t *holes) {
+        const int32_t beginU = std::max(u, 0), endU = std::min(u + width, cellCountU());
+        const int32_t beginV = std::max(v, 0), endV = std::min(v + height, cellCountV());
+        for (int32_t cv = beginV; cv < endV; ++cv) {
+            for (int32_t cu = beginU; cu < endU; ++cu) {
+                TileInfo &info = _tileInfos[tileIndex(cu / kTileCells, cv / kTileCells)];
+                const uint64_t bit = uint64_t(1) << ((cv % kTileCells) * kTileCells + cu % kTileCells);
+                if (holes[size_t(cv - v) * size_t(width) + size_t(cu - u)] != 0) {
+                    info.holes |= bit;
+                } else {
+                    info.holes &= ~bit;
+                }
+            }
+        }
+    }
+
+    float HeightField::sample(int32_t u, int32_t v) const {
+        const int32_t tileU = std::min(u / kTileCells, _tileCountU - 1);
+        const int32_t tileV = std::min(v / kTileCells, _tileCountV - 1);
+        const size_t offset = size_t(v - tileV * kTileCells) * kTileSamples + (u - tileU * kTileCells);
+        return _tiles[size_t(tileIndex(tileU, tileV)) * kTileStride + offset];
+    }
+
+    bool HeightField::isHole(int32_t u, int32_t v) const {
+        const TileInfo &info = _tileInfos[tileIndex(u / kTileCells, v / kTileCells)];
+        return (info.holes >> ((v % kTileCells) * kTileCells + u % kTileCells)) & 1;
+    }
+
+    void HeightField::updateRanges(int32_t minTileU, int32_t maxTileU, int32_t minTileV, int32_t maxTileV) {
+        for (int32_t tileV = minTileV; tileV <= maxTileV; ++tileV) {
+            for (int32_t tileU = minTileU; tileU <= maxTileU; ++tileU) {
+                const int32_t tile = tileIndex(tileU, tileV);
+                // only the samples of cells inside the field: the last tiles may be partial.
+                const int32_t samplesU = std::min(kTileCells, cellCountU() - tileU * kTileCells) + 1;
+                const int32_t samplesV = std::min(kTileCells, cellCountV() - tileV * kTileCells) + 1;
+                const float *samples = _tiles.data() + size_t(tile) * kTileStride;
+                float lower = samples[0], upper = samples[0];
+                for (int32_t sv = 0; sv < samplesV; ++sv) {
+                    for (int32_t su = 0; su < samplesU; ++su) {
+                        lower = std::min(lower, samples[sv * kTileSamples + su]);
+                        upper = std::max(upper, samples[sv * kTileSamples + su]);
+                    }
+                }
+                _tileInfos[tile].minHeight = lower;
+                _tileInfos[tile].maxHeight = upper;
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,121 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/AlignedVector.h"
+#include "../../common/Math.h"
+#include <algorithm>
+#include <vector>
+
+namespace vox::flex {
+    // Regular grid of normalized height samples, native storage behind heightfield colliders. Sample (u, v)
+    // sits at (u, v) in cell units; cell (u, v) spans samples u ..< u + 2 and v ..< v + 2, and may be a hole.
+    //
+    // Samples are stored in square tiles of kTileCells x kTileCells cells, each holding the samples of its
+    // cells including the ones shared with the next tiles, so the four corners of a cell always come from the
+    // same cache line aligned block. Every tile also keeps its hole flags as a 64-bit mask and the range of
+    // its heights, which lets queries skip whole tiles. Rectangles of samples can be rewritten in place,
+    // only the tiles they touch being updated.
+    class HeightField {
+    public:
+        static constexpr int32_t kTileCells = 8;
+        static constexpr int32_t kTileSamples = kTileCells + 1;
+        // floats per tile, padded to a multiple of the cache line.
+        static constexpr int32_t kTileStride = 96;
+
+        // Resizes to `resolutionU` x `resolutionV` samples (at least 2 x 2), all zero and without holes.
+        void resize(int32_t resolutionU, int32_t resolutionV);
+
+        int32_t resolutionU() const { return _resolutionU; }
+        int32_t resolutionV() const { return _resolutionV; }
+
+        int32_t cellCountU() const { return _resolutionU - 1; }
+        int32_t cellCountV() const { return _resolutionV - 1; }
+
+        bool empty() const { return _resolutionU < 2 || _resolutionV < 2; }
+
+        // Writes the `width` x `height` samples starting at (u, v), row major along u. Samples outside the
+        // field are ignored.
+        void setSamples(int32_t u, int32_t v, int32_t width, int32_t height, const float *samples);
+
+        // Sets the hole flags of the `width` x `height` cells starting at (u, v), non zero for holes.
+        void setHoles(int32_t u, int32_t v, int32_t width, int32_t height, const uint8_t *holes);
+
+        float sample(int32_t u, int32_t v) const;
+
+        bool isHole(int32_t u, int32_t v) const;
+
+        // Calls `callback(u, v, corners)` for every solid cell in [minU, maxU] x [minV, maxV] (clamped to the
+        // field) whose heights may reach [minHeight, maxHeight], tile by tile. corners holds the heights at
+        // (u, v), (u + 1, v), (u, v + 1) and (u + 1, v + 1).
+        template <typename Callback>
+        void forEachCell(int32_t minU, int32_t maxU, int32_t minV, int32_t maxV, float minHeight, float maxHeight,
+                         Callback &&callback) const;
+
+    private:
+        struct TileInfo {
+            uint64_t holes = 0;
+            float minHeight = 0;
+            float maxHeight = 0;
+        };
+
+        int32_t tileIndex(int32_t tileU, int32_t tileV) const { return tileV * _tileCountU + tileU; }
+
+        // recomputes the height range of the tiles in the inclusive tile rectangle.
+        void updateRanges(int32_t minTileU, int32_t maxTileU, int32_t minTileV, int32_t maxTileV);
+
+        int32_t _resolutionU = 0;
+        int32_t _resolutionV = 0;
+        int32_t _tileCountU = 0;
+        int32_t _tileCountV = 0;
+        std::vector<float, AlignedAllocator<float, 64>> _tiles;
+        std::vector<TileInfo> _tileInfos;
+    };
+
+    template <typename Callback>
+    void HeightField::forEachCell(int32_t minU, int32_t maxU, int32_t minV, int32_t maxV, float minHeight,
+                                  float maxHeight, Callback &&callback) const {
+        minU = std::max(minU, 0);
+        minV = std::max(minV, 0);
+        maxU = std::min(maxU, cellCountU() - 1);
+        maxV = std::min(maxV, cellCountV() - 1);
+        if (minU > maxU || minV > maxV) {
+            return;
+        }
+
+        for (int32_t tileV = minV / kTileCells; tileV <= maxV / kTileCells; ++tileV) {
+            for (int32_t tileU = minU / kTileCells; tileU <= maxU / kTileCells; ++tileU) {
+                const int32_t tile = tileIndex(tileU, tileV);
+                const TileInfo &info = _tileInfos[tile];
+                if (info.minHeight > maxHeight || info.maxHeight < minHeight) {
+                    continue;
+                }
+                const float *samples = _tiles.data() + size_t(tile) * kTileStride;
+                const int32_t baseU = tileU * kTileCells, baseV = tileV * kTileCells;
+                const int32_t beginU = std::max(minU, baseU) - baseU;
+                const int32_t endU = std::min(maxU, baseU + kTileCells - 1) - baseU;
+                const int32_t beginV = std::max(minV, baseV) - baseV;
+                const int32_t endV = std::min(maxV, baseV + kTileCells - 1) - baseV;
+                for (int32_t cv = beginV; cv <= endV; ++cv) {
+                    const float *row = samples + cv * kTileSamples;
+                    for (int32_t cu = beginU; cu <= endU; ++cu) {
+                        if ((info.holes >> (cv * kTileCells + cu)) & 1) {
+                            continue;
+                        }
+                        const float4 corners(row[cu], row[cu + 1], row[cu + kTileSamples],
+                                             row[cu + kTileSamples + 1]);
+                        if (std::min(std::min(corners.x, corners.y), std::min(corners.z, corners.w)) > maxHeight ||
+                            std::max(std::max(corners.x, corners.y), std::max(corners.z, corners.w)) < minHeight) {
+                            continue;
+                        }
+                        callback(baseU + cu, baseV + cv, corners);
+                    }
+                }
+            }
+        }
+    }
+} // namespace vox::flex
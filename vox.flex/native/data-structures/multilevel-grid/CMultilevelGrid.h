@@ -0,0 +1,61 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+/// See MovingEntity in MultilevelGrid.h, cell coords w is the level.
+typedef struct {
+    simd_int4 oldCellCoords;
+    simd_int4 newCellCoords;
+    int32_t entity;
+} CMovingEntity;
+
+/// Sparse multilevel grid backed by an open-addressing hash table and a shared content arena.
+@interface CMultilevelGrid : NSObject
+
+- (instancetype _Nonnull)init;
+
++ (int32_t)gridLevelForSize:(float)size;
+
++ (float)cellSizeOfLevel:(int32_t)level;
+
++ (simd_int4)parentCellCoords:(simd_int4)cellCoords level:(int32_t)level;
+
+- (void)clear;
+
+/// Entity i goes to the cell at cellCoords[i].
+- (void)buildWithCellCoords:(const simd_int4 *_Nonnull)cellCoords count:(uint32_t)count;
+
+/// Moves entities between cells, then removes empty cells.
+- (void)updateWithMovingEntities:(const CMovingEntity *_Nonnull)moves count:(uint32_t)count;
+
+- (void)addToCellsFrom:(simd_int4)min to:(simd_int4)max entity:(int32_t)entity;
+
+- (void)removeFromCellsFrom:(simd_int4)min to:(simd_int4)max entity:(int32_t)entity;
+
+- (void)removeEmpty;
+
+- (uint32_t)cellCount;
+
+- (uint32_t)entityCount;
+
+/// -1 when there is no such cell.
+- (int32_t)findCell:(simd_int4)cellCoords;
+
+- (simd_int4)cellCoords:(int32_t)cell;
+
+- (uint32_t)cellContentCount:(int32_t)cell;
+
+/// Valid until the grid is modified.
+- (const int32_t *_Nonnull)cellContents:(int32_t)cell;
+
+/// Arena entries in use, including slices abandoned by cells that grew.
+- (uint32_t)arenaSize;
+
+@end
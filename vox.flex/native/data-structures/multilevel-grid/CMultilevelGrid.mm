@@ -0,0 +1,97 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CMultilevelGrid.h"
+#include "MultilevelGrid.h"
+#include <memory>
+
+using namespace vox::flex;
+
+static_assert(sizeof(CMovingEntity) == sizeof(MovingEntity), "CMovingEntity must match MovingEntity");
+
+namespace {
+    int4 toInt4(simd_int4 v) { return {v.x, v.y, v.z, v.w}; }
+
+    simd_int4 toSimd(const int4 &v) { return simd_make_int4(v.x, v.y, v.z, v.w); }
+} // namespace
+
+@implementation CMultilevelGrid {
+    std::unique_ptr<MultilevelGrid> _grid;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _grid = std::make_unique<MultilevelGrid>();
+    }
+    return self;
+}
+
++ (int32_t)gridLevelForSize:(float)size {
+    return MultilevelGrid::gridLevelForSize(size);
+}
+
++ (float)cellSizeOfLevel:(int32_t)level {
+    return MultilevelGrid::cellSizeOfLevel(level);
+}
+
++ (simd_int4)parentCellCoords:(simd_int4)cellCoords level:(int32_t)level {
+    return toSimd(MultilevelGrid::getParentCellCoords(toInt4(cellCoords), level));
+}
+
+- (void)clear {
+    _grid->clear();
+}
+
+- (void)buildWithCellCoords:(const simd_int4 *)cellCoords count:(uint32_t)count {
+    _grid->build(reinterpret_cast<const int4 *>(cellCoords), count);
+}
+
+- (void)updateWithMovingEntities:(const CMovingEntity *)moves count:(uint32_t)count {
+    _grid->update(reinterpret_cast<const MovingEntity *>(moves), count);
+}
+
+- (void)addToCellsFrom:(simd_int4)min to:(simd_int4)max entity:(int32_t)entity {
+    _grid->addToCells(toInt4(min), toInt4(max), entity);
+}
+
+- (void)removeFromCellsFrom:(simd_int4)min to:(simd_int4)max entity:(int32_t)entity {
+    _grid->removeFromCells(toInt4(min), toInt4(max), entity);
+}
+
+- (void)removeEmpty {
+    _grid->removeEmpty();
+}
+
+- (uint32_t)cellCount {
+    return static_cast<uint32_t>(_grid->cellCount());
+}
+
+- (uint32_t)entityCount {
+    return static_cast<uint32_t>(_grid->entityCount());
+}
+
+- (int32_t)findCell:(simd_int4)cellCoords {
+    return _grid->findCell(toInt4(cellCoords));
+}
+
+- (simd_int4)cellCoords:(int32_t)cell {
+    return toSimd(_grid->cell(cell).coords);
+}
+
+- (uint32_t)cellContentCount:(int32_t)cell {
+    return _grid->cell(cell).count;
+}
+
+- (const int32_t *)cellContents:(int32_t)cell {
+    return _grid->contents(cell);
+}
+
+- (uint32_t)arenaSize {
+    return static_cast<uint32_t>(_grid->arenaSize());
+}
+
+@end
@@ -0,0 +1,460 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "MultilevelGrid.h"
+#include "../../common/Parallel.h"
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <tuple>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kEntityGrain = 2048;
+        constexpr size_t kCellGrain = 256;
+        constexpr size_t kMinTableSize = 64;
+        // abandoned arena entries tolerated before compacting.
+        constexpr size_t kMinCompactSize = 4096;
+
+        // Calls `function(key, begin, end)` in parallel for every run of equal keys. A run belongs to the chunk
+        // holding its first element, so no two threads ever see the same key.
+        template <typename Function>
+        void forEachRun(const uint32_t *keys, size_t count, Function &&function) {
+            parallelFor(0, count, kEntityGrain, [&](size_t begin, size_t end) {
+                size_t i = begin;
+                while (i < end && i > 0 && keys[i] == keys[i - 1]) {
+                    ++i;
+                }
+                while (i < end) {
+                    size_t j = i + 1;
+                    while (j < count && keys[j] == keys[i]) {
+                        ++j;
+                    }
+                    function(keys[i], i, j);
+                    i = j;
+                }
+            });
+        }
+    } // namespace
+
+    // MARK: - Levels
+    // kMinSize keeps levels above kMinLevel; sizes past the coarsest level (NaN included) are gridded there.
+    int32_t MultilevelGrid::gridLevelForSize(float size) {
+        constexpr int32_t kMaxLevel = kMinLevel + kLevelCount - 1;
+        if (!(size < cellSizeOfLevel(kMaxLevel))) {
+            return kMaxLevel;
+        }
+        return int32_t(std::ceil(std::log2(std::max(size, kMinSize))));
+    }
+
+    float MultilevelGrid::cellSizeOfLevel(int32_t level) { return std::exp2(float(level)); }
+
+    int4 MultilevelGrid::getParentCellCoords(const int4 &cellCoords, int32_t level) {
+        const float decimation = std::exp2(float(level - cellCoords.w));
+        return {int32_t(std::floor(float(cellCoords.x) / decimation)),
+                int32_t(std::floor(float(cellCoords.y) / decimation)),
+                int32_t(std::floor(float(cellCoords.z) / decimation)), level};
+    }
+
+    // Levels come from gridLevelForSize, which stays in range: any other level is a caller bug, and counting it
+    // at another level would make populatedLevels send contacts to the wrong neighborhoods.
+    void MultilevelGrid::changeLevelPopulation(int32_t level, int32_t delta) {
+        const int32_t index = level - kMinLevel;
+        assert(index >= 0 && index < kLevelCount && "cell level out of the grid's range");
+        if (index < 0 || index >= kLevelCount) {
+            return;
+        }
+        _levelPopulation[index] += delta;
+    }
+
+    void MultilevelGrid::populatedLevels(std::vector<int32_t> &levels) const {
+        levels.clear();
+        for (int32_t i = 0; i < kLevelCount; ++i) {
+            if (_levelPopulation[i] > 0) {
+                levels.push_back(i + kMinLevel);
+            }
+        }
+    }
+
+    // MARK: - Hash table
+    uint32_t MultilevelGrid::hashCoords(const int4 &coords) {
+        const uint64_t a = uint64_t(uint32_t(coords.x)) | uint64_t(uint32_t(coords.y)) << 32;
+        const uint64_t b = uint64_t(uint32_t(coords.z)) | uint64_t(uint32_t(coords.w)) << 32;
+        return uint32_t(((a ^ (b * 0x9E3779B97F4A7C15ull)) * 0xC2B2AE3D27D4EB4Full) >> 32);
+    }
+
+    size_t MultilevelGrid::findSlot(const int4 &coords, uint32_t hash) const {
+        const size_t mask = _slots.size() - 1;
+        for (size_t s = homeSlot(hash);; s = (s + 1) & mask) {
+            const Slot &slot = _slots[s];
+            if (slot.cell < 0 || (slot.hash == hash && _cells[slot.cell].coords == coords)) {
+                return s;
+            }
+        }
+    }
+
+    void MultilevelGrid::growTable(size_t cellCount, bool force) {
+        size_t size = kMinTableSize;
+        while (float(cellCount) > kMaxLoadFactor * float(size)) {
+            size *= 2;
+        }
+        if (!force && size <= _slots.size()) {
+            return;
+        }
+
+        _slots.assign(size, Slot());
+        _shift = 32 - uint32_t(std::countr_zero(size));
+        const size_t mask = size - 1;
+        for (size_t c = 0; c < _cells.size(); ++c) {
+            const uint32_t hash = hashCoords(_cells[c].coords);
+            size_t s = homeSlot(hash);
+            while (_slots[s].cell >= 0) {
+                s = (s + 1) & mask;
+            }
+            _slots[s] = {hash, int32_t(c)};
+        }
+    }
+
+    // backward shift deletion: later entries of the probe run move into the hole, so no tombstones are needed.
+    void MultilevelGrid::eraseSlot(size_t slot) {
+        const size_t mask = _slots.size() - 1;
+        size_t hole = slot;
+        for (size_t j = (slot + 1) & mask; _slots[j].cell >= 0; j = (j + 1) & mask) {
+            const size_t home = homeSlot(_slots[j].hash);
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                _slots[hole] = _slots[j];
+                hole = j;
+            }
+        }
+        _slots[hole] = Slot();
+    }
+
+    int32_t MultilevelGrid::findCell(const int4 &coords) const {
+        if (_slots.empty()) {
+            return -1;
+        }
+        return _slots[findSlot(coords, hashCoords(coords))].cell;
+    }
+
+    int32_t MultilevelGrid::getOrCreateCell(const int4 &coords) { return getOrCreateCell(coords, hashCoords(coords)); }
+
+    int32_t MultilevelGrid::getOrCreateCell(const int4 &coords, uint32_t hash) {
+        growTable(_cells.size() + 1);
+        Slot &slot = _slots[findSlot(coords, hash)];
+        if (slot.cell < 0) {
+            slot = {hash, int32_t(_cells.size())};
+            Cell &cell = _cells.emplace_back();
+            cell.coords = coords;
+            changeLevelPopulation(coords.w, 1);
+        }
+        return slot.cell;
+    }
+
+    // MARK: - Contents
+    void MultilevelGrid::reserveArena(size_t size) {
+        if (_contents.size() < size) {
+            _contents.resize(std::max(size, _contents.size() + _contents.size() / 2));
+        }
+    }
+
+    void MultilevelGrid::relocate(Cell &cell, uint32_t capacity) {
+        reserveArena(_arenaEnd + capacity);
+        std::copy_n(_contents.begin() + cell.start, cell.count, _contents.begin() + _arenaEnd);
+        _abandoned += cell.capacity;
+        cell.start = uint32_t(_arenaEnd);
+        cell.capacity = capacity;
+        _arenaEnd += capacity;
+    }
+
+    void MultilevelGrid::addToCell(int32_t index, int32_t entity) {
+        Cell &cell = _cells[index];
+        if (cell.count == cell.capacity) {
+            relocate(cell, capacityFor(cell.count + 1));
+        }
+        _contents[cell.start + cell.count++] = entity;
+        ++_entityCount;
+    }
+
+    bool MultilevelGrid::removeFromCell(int32_t index, int32_t entity) {
+        Cell &cell = _cells[index];
+        int32_t *contents = _contents.data() + cell.start;
+        for (uint32_t j = 0; j < cell.count; ++j) {
+            if (contents[j] == entity) {
+                contents[j] = contents[--cell.count];
+                --_entityCount;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void MultilevelGrid::addToCells(const int4 &min, const int4 &max, int32_t entity) {
+        for (int32_t x = min.x; x <= max.x; ++x) {
+            for (int32_t y = min.y; y <= max.y; ++y) {
+                for (int32_t z = min.z; z <= max.z; ++z) {
+                    addToCell(getOrCreateCell(int4(x, y, z, min.w)), entity);
+                }
+            }
+        }
+    }
+
+    void MultilevelGrid::removeFromCells(const int4 &min, const int4 &max, int32_t entity) {
+        for (int32_t x = min.x; x <= max.x; ++x) {
+            for (int32_t y = min.y; y <= max.y; ++y) {
+                for (int32_t z = min.z; z <= max.z; ++z) {
+                    int32_t cell = findCell(int4(x, y, z, min.w));
+                    if (cell >= 0) {
+                        removeFromCell(cell, entity);
+                    }
+                }
+            }
+        }
+    }
+
+    void MultilevelGrid::removeEmpty() {
+        // back to front, so the last cell swapped into a removed one has already been checked.
+        for (size_t c = _cells.size(); c-- > 0;) {
+            if (_cells[c].count > 0) {
+                continue;
+            }
+            _abandoned += _cells[c].capacity;
+            changeLevelPopulation(_cells[c].coords.w, -1);
+            eraseSlot(findSlot(_cells[c].coords, hashCoords(_cells[c].coords)));
+
+            const size_t last = _cells.size() - 1;
+            if (c != last) {
+                _slots[findSlot(_cells[last].coords, hashCoords(_cells[last].coords))].cell = int32_t(c);
+                _cells[c] = _cells[last];
+            }
+            _cells.pop_back();
+        }
+
+        if (_abandoned > kMinCompactSize && _abandoned * 2 > _arenaEnd) {
+            compact();
+        }
+    }
+
+    void MultilevelGrid::compact() {
+        const size_t cellCount = _cells.size();
+        _capacities.resize(cellCount);
+        parallelForEach(cellCount, kCellGrain, [&](size_t c) { _capacities[c] = capacityFor(_cells[c].count); });
+        const size_t total = parallelExclusiveScan(_capacities.data(), _capacities.data(), cellCount);
+
+        _scratchContents.resize(std::max(total, _contents.size()));
+        parallelForEach(cellCount, kCellGrain, [&](size_t c) {
+            Cell &cell = _cells[c];
+            std::copy_n(_contents.begin() + cell.start, cell.count, _scratchContents.begin() + _capacities[c]);
+            cell.start = _capacities[c];
+            cell.capacity = capacityFor(cell.count);
+        });
+        _contents.swap(_scratchContents);
+        _arenaEnd = total;
+        _abandoned = 0;
+    }
+
+    // MARK: - Bulk operations
+    void MultilevelGrid::clear() {
+        std::fill(_slots.begin(), _slots.end(), Slot());
+        _cells.clear();
+        _arenaEnd = 0;
+        _abandoned = 0;
+        _entityCount = 0;
+        _levelPopulation.fill(0);
+    }
+
+    void MultilevelGrid::build(const int4 *cellCoords, size_t count) {
+        clear();
+        if (count == 0) {
+            return;
+        }
+
+        _keys.resize(count);
+        _values.resize(count);
+        parallelFor(0, count, kEntityGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _keys[i] = hashCoords(cellCoords[i]);
+                _values[i] = uint32_t(i);
+            }
+        });
+        _sort.sort(_keys.data(), _values.data(), count);
+
+        // coords in sorted order, gathered once so the passes below stream through them.
+        _sortedCoords.resize(count);
+        parallelFor(0, count, kEntityGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _sortedCoords[i] = cellCoords[_values[i]];
+            }
+        });
+
+        // a cell starts wherever the hash changes. Runs of equal hash holding different coords (collisions)
+        // are sorted by coords and split, which keeps entities of a cell contiguous.
+        _hashes.resize(count + 1);
+        _hashes[count] = 0;
+        forEachRun(_keys.data(), count, [&](uint32_t, size_t begin, size_t end) {
+            const bool collision = std::any_of(_sortedCoords.begin() + begin + 1, _sortedCoords.begin() + end,
+                                               [&](const int4 &coords) { return coords != _sortedCoords[begin]; });
+            if (collision) {
+                std::sort(_values.begin() + begin, _values.begin() + end, [&](uint32_t a, uint32_t b) {
+                    const int4 &ca = cellCoords[a], &cb = cellCoords[b];
+                    return std::tie(ca.x, ca.y, ca.z, ca.w, a) < std::tie(cb.x, cb.y, cb.z, cb.w, b);
+                });
+                for (size_t k = begin; k < end; ++k) {
+                    _sortedCoords[k] = cellCoords[_values[k]];
+                }
+            }
+            _hashes[begin] = 1;
+            for (size_t k = begin + 1; k < end; ++k) {
+                _hashes[k] = collision && _sortedCoords[k] != _sortedCoords[k - 1];
+            }
+        });
+        const size_t cellCount = parallelExclusiveScan(_hashes.data(), _hashes.data(), count + 1);
+
+        _cells.resize(cellCount);
+        parallelFor(0, count, kEntityGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (_hashes[i + 1] != _hashes[i]) {
+                    Cell &cell = _cells[_hashes[i]];
+                    cell.coords = _sortedCoords[i];
+                    cell.start = uint32_t(i);
+                }
+            }
+        });
+        _capacities.resize(cellCount);
+        parallelForEach(cellCount, kCellGrain, [&](size_t c) {
+            _cells[c].count = uint32_t((c + 1 < cellCount ? _cells[c + 1].start : count) - _cells[c].start);
+            _capacities[c] = capacityFor(_cells[c].count);
+        });
+
+        // cells are in hash order, so the table is filled front to back.
+        growTable(cellCount, true);
+        for (const Cell &cell : _cells) {
+            changeLevelPopulation(cell.coords.w, 1);
+        }
+
+        _arenaEnd = parallelExclusiveScan(_capacities.data(), _capacities.data(), cellCount);
+        reserveArena(_arenaEnd);
+        parallelForEach(cellCount, kCellGrain, [&](size_t c) {
+            Cell &cell = _cells[c];
+            std::copy_n(_values.begin() + cell.start, cell.count, _contents.begin() + _capacities[c]);
+            cell.start = _capacities[c];
+            cell.capacity = capacityFor(cell.count);
+        });
+        _entityCount = count;
+    }
+
+    void MultilevelGrid::update(const MovingEntity *moves, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        _keys.resize(count);
+        _values.resize(count);
+
+        // leave the old cells, grouped by cell.
+        uint32_t skipKey = uint32_t(_cells.size());
+        parallelFor(0, count, kEntityGrain, [&](size_t begin, size_t end) {
+            for (size_t m = begin; m < end; ++m) {
+                const MovingEntity &move = moves[m];
+                const int32_t c = move.oldCellCoords == move.newCellCoords || move.oldCellCoords.w == kNoLevel
+                                      ? -1
+                                      : findCell(move.oldCellCoords);
+                _keys[m] = c < 0 ? skipKey : uint32_t(c);
+                _values[m] = uint32_t(m);
+            }
+        });
+        _sort.sort(_keys.data(), _values.data(), count, RadixSort::bitsForMaxKey(skipKey));
+
+        std::atomic<size_t> removed{0};
+        forEachRun(_keys.data(), count, [&](uint32_t c, size_t begin, size_t end) {
+            if (c == skipKey) {
+                return;
+            }
+            Cell &cell = _cells[c];
+            int32_t *contents = _contents.data() + cell.start;
+            size_t found = 0;
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t entity = moves[_values[k]].entity;
+                for (uint32_t j = 0; j < cell.count; ++j) {
+                    if (contents[j] == entity) {
+                        contents[j] = contents[--cell.count];
+                        ++found;
+                        break;
+                    }
+                }
+            }
+            removed.fetch_add(found, std::memory_order_relaxed);
+        });
+
+        // enter the new cells: existing ones are looked up in parallel, missing ones created serially.
+        constexpr uint32_t kMissing = UINT32_MAX;
+        constexpr uint32_t kSkip = UINT32_MAX - 1;
+        parallelFor(0, count, kEntityGrain, [&](size_t begin, size_t end) {
+            for (size_t m = begin; m < end; ++m) {
+                if (moves[m].oldCellCoords == moves[m].newCellCoords || moves[m].newCellCoords.w == kNoLevel) {
+                    _keys[m] = kSkip;
+                } else {
+                    const int32_t c = findCell(moves[m].newCellCoords);
+                    _keys[m] = c < 0 ? kMissing : uint32_t(c);
+                }
+                _values[m] = uint32_t(m);
+            }
+        });
+        size_t added = 0;
+        for (size_t m = 0; m < count; ++m) {
+            if (_keys[m] == kMissing) {
+                _keys[m] = uint32_t(getOrCreateCell(moves[m].newCellCoords));
+            }
+        }
+        skipKey = uint32_t(_cells.size());
+        for (size_t m = 0; m < count; ++m) {
+            if (_keys[m] == kSkip) {
+                _keys[m] = skipKey;
+            } else {
+                ++added;
+            }
+        }
+        _sort.sort(_keys.data(), _values.data(), count, RadixSort::bitsForMaxKey(skipKey));
+
+        // cells outgrowing their slice get a new one at the end of the arena, sized up front.
+        std::atomic<size_t> growth{0};
+        forEachRun(_keys.data(), count, [&](uint32_t c, size_t begin, size_t end) {
+            if (c == skipKey) {
+                return;
+            }
+            const uint32_t needed = _cells[c].count + uint32_t(end - begin);
+            if (needed > _cells[c].capacity) {
+                growth.fetch_add(capacityFor(needed), std::memory_order_relaxed);
+            }
+        });
+        reserveArena(_arenaEnd + growth.load());
+
+        std::atomic<size_t> arenaEnd{_arenaEnd};
+        std::atomic<size_t> abandoned{0};
+        forEachRun(_keys.data(), count, [&](uint32_t c, size_t begin, size_t end) {
+            if (c == skipKey) {
+                return;
+            }
+            Cell &cell = _cells[c];
+            const uint32_t needed = cell.count + uint32_t(end - begin);
+            if (needed > cell.capacity) {
+                const uint32_t capacity = capacityFor(needed);
+                const size_t start = arenaEnd.fetch_add(capacity, std::memory_order_relaxed);
+                std::copy_n(_contents.begin() + cell.start, cell.count, _contents.begin() + start);
+                abandoned.fetch_add(cell.capacity, std::memory_order_relaxed);
+                cell.start = uint32_t(start);
+                cell.capacity = capacity;
+            }
+            for (size_t k = begin; k < end; ++k) {
+                _contents[cell.start + cell.count++] = moves[_values[k]].entity;
+            }
+        });
+        _arenaEnd = arenaEnd.load();
+        _abandoned += abandoned.load();
+        _entityCount = _entityCount + added - removed.load();
+
+        removeEmpty();
+    }
+} // namespace vox::flex
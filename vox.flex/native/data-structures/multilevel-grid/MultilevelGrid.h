@@ -0,0 +1,173 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Math.h"
+#include "../../sort/RadixSort.h"
+#include <array>
+#include <limits>
+#include <vector>
+
+namespace vox::flex {
+    // An entity changing cell between two updates of a MultilevelGrid. Coords at level
+    // MultilevelGrid::kNoLevel stand for no cell, for entities only entering or only leaving a cell.
+    struct MovingEntity {
+        int4 oldCellCoords;
+        int4 newCellCoords;
+        int32_t entity = -1;
+    };
+
+    // Native counterpart of NativeMultilevelGrid: unbounded, sparse and implicit multilevel grid. Cell
+    // coords are 4-dimensional, w being the level; cells of level l are 2^l wide.
+    //
+    // Cells live in a flat array and are found through an open-addressing hash table with linear probing,
+    // whose 8-byte slots hold a 32-bit hash of the cell coords and the cell index, so probing touches a
+    // single cache line and coords are only compared on hash matches. The home slot of a hash is given by
+    // its high bits, so cells inserted in hash order fill the table front to back.
+    //
+    // The contents of every cell are a slice of one shared arena, cells[c].start ..< start + count, with
+    // some spare capacity so entities can move in without relocating the slice. A cell outgrowing its slice
+    // moves to the end of the arena, and the arena is compacted once abandoned slices take up half of it.
+    class MultilevelGrid {
+    public:
+        static constexpr float kMinSize = 0.01f;
+        static constexpr int32_t kMinLevel = -16;
+        static constexpr int32_t kLevelCount = 48;
+        static constexpr int32_t kNoLevel = std::numeric_limits<int32_t>::min();
+
+        struct alignas(16) Cell {
+            int4 coords;
+            uint32_t start = 0;
+            uint32_t count = 0;
+            uint32_t capacity = 0;
+        };
+
+        static int32_t gridLevelForSize(float size);
+
+        static float cellSizeOfLevel(int32_t level);
+
+        // Coords of the cell of `level` (coarser than the cell's own) containing the cell.
+        static int4 getParentCellCoords(const int4 &cellCoords, int32_t level);
+
+        // Calls `callback(coords)` for every cell of `level` overlapped by the box, at most maxSize + 1 per axis.
+        template <typename Callback>
+        static void forEachCellCoordsForBoundsAtLevel(const float3 &lower, const float3 &upper, int32_t level,
+                                                      int32_t maxSize, Callback &&callback);
+
+        void clear();
+
+        // Full rebuild: entity i goes to the cell at cellCoords[i]. Entities are radix sorted by cell hash, so
+        // every cell is a run of the sorted entities: cells, their contents and the table are then filled
+        // in hash order without any lookup.
+        void build(const int4 *cellCoords, size_t count);
+
+        // Incremental update: every entity leaves its old cell and enters its new one, then empty cells are
+        // removed. Entities are grouped by cell with a radix sort, so each cell is edited by a single thread;
+        // only cells that did not exist yet are created serially. Moves within the same cell are ignored.
+        void update(const MovingEntity *moves, size_t count);
+
+        // Index of the cell, or -1 if it does not exist.
+        int32_t findCell(const int4 &coords) const;
+
+        int32_t getOrCreateCell(const int4 &coords);
+
+        void addToCell(int32_t cell, int32_t entity);
+
+        // Returns false when the entity was not in the cell. Contents order is not preserved.
+        bool removeFromCell(int32_t cell, int32_t entity);
+
+        // Adds / removes the entity to every cell of the span [min, max], all at level min.w.
+        void addToCells(const int4 &min, const int4 &max, int32_t entity);
+
+        void removeFromCells(const int4 &min, const int4 &max, int32_t entity);
+
+        // Removes cells with no contents. Cell indices are not stable across this call.
+        void removeEmpty();
+
+        size_t cellCount() const { return _cells.size(); }
+
+        const Cell &cell(int32_t index) const { return _cells[index]; }
+
+        const int32_t *contents(int32_t index) const { return _contents.data() + _cells[index].start; }
+
+        size_t entityCount() const { return _entityCount; }
+
+        // Levels holding at least one cell, finest first.
+        void populatedLevels(std::vector<int32_t> &levels) const;
+
+        // Used part of the content arena, live slices and abandoned ones.
+        size_t arenaSize() const { return _arenaEnd; }
+
+    private:
+        static constexpr float kMaxLoadFactor = 0.5f;
+
+        struct Slot {
+            uint32_t hash = 0;
+            int32_t cell = -1;
+        };
+
+        static uint32_t hashCoords(const int4 &coords);
+
+        // slice size for `count` entities, leaving room for a few more.
+        static uint32_t capacityFor(uint32_t count) { return count + count / 4 + 2; }
+
+        size_t homeSlot(uint32_t hash) const { return hash >> _shift; }
+
+        size_t findSlot(const int4 &coords, uint32_t hash) const;
+
+        int32_t getOrCreateCell(const int4 &coords, uint32_t hash);
+
+        // Rebuilds the table if `cellCount` cells would exceed the load factor, or always if `force` is set.
+        void growTable(size_t cellCount, bool force = false);
+
+        void eraseSlot(size_t slot);
+
+        void changeLevelPopulation(int32_t level, int32_t delta);
+
+        // moves the cell slice to a new one of `capacity` at the end of the arena.
+        void relocate(Cell &cell, uint32_t capacity);
+
+        void reserveArena(size_t size);
+
+        void compact();
+
+        std::vector<Slot> _slots;
+        uint32_t _shift = 32;
+        std::vector<Cell> _cells;
+        std::vector<int32_t> _contents;
+        size_t _arenaEnd = 0;
+        size_t _abandoned = 0;
+        size_t _entityCount = 0;
+        std::array<uint32_t, kLevelCount> _levelPopulation{};
+
+        RadixSort _sort;
+        std::vector<uint32_t> _hashes;
+        std::vector<int4> _sortedCoords;
+        std::vector<uint32_t> _keys;
+        std::vector<uint32_t> _values;
+        std::vector<uint32_t> _capacities;
+        std::vector<int32_t> _scratchContents;
+    };
+
+    template <typename Callback>
+    void MultilevelGrid::forEachCellCoordsForBoundsAtLevel(const float3 &lower, const float3 &upper, int32_t level,
+                                                           int32_t maxSize, Callback &&callback) {
+        const float cellSize = cellSizeOfLevel(level);
+        int32_t minCell[3], maxCell[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            minCell[axis] = int32_t(std::floor(lower[axis] / cellSize));
+            maxCell[axis] = std::min(int32_t(std::floor(upper[axis] / cellSize)), minCell[axis] + maxSize);
+        }
+        for (int32_t x = minCell[0]; x <= maxCell[0]; ++x) {
+            for (int32_t y = minCell[1]; y <= maxCell[1]; ++y) {
+                for (int32_t z = minCell[2]; z <= maxCell[2]; ++z) {
+                    callback(int4(x, y, z, level));
+                }
+            }
+        }
+    }
+} // namespace vox::flex
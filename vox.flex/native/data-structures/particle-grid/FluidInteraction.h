@@ -0,0 +1,27 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Math.h"
+
+namespace vox::flex {
+    // Pair of fluid particles close enough to interact during a step. Pairs are found once per step and
+    // reused by every substep and iteration; the kernel terms are refreshed at the start of each iteration
+    // and then shared by every pass over the pair, so neither kernel is evaluated more than once per pair.
+    struct FluidInteraction {
+        // (positionA - positionB) normalized, w unused.
+        float4 gradient;
+        // Poly6 kernel averaged over the smoothing radii of both particles.
+        float avgKernel = 0;
+        // Spiky kernel derivative averaged over both smoothing radii, negative.
+        float avgGradient = 0;
+        int32_t particleA = 0;
+        int32_t particleB = 0;
+    };
+
+    static_assert(sizeof(FluidInteraction) == 32, "FluidInteraction must fill half a cache line");
+} // namespace vox::flex
@@ -0,0 +1,591 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "ParticleGrid.h"
+#include "../../collisions/Simplex.h"
+#include "../../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 256;
+        constexpr size_t kCellGrain = 64;
+        constexpr size_t kQueryGrain = 16;
+
+        constexpr int32_t kFilterCategoryBitmask = 0x0000ffff;
+
+        // same level neighbors whose pairs a cell owns: one of every two opposite offsets.
+        constexpr int32_t kHalfNeighborCount = 13;
+        constexpr int32_t kHalfNeighborCount2D = 4;
+        constexpr int32_t kHalfNeighbors[kHalfNeighborCount][3] = {
+            {1, 0, 0},  {1, 1, 0},  {0, 1, 0},   {-1, 1, 0}, {1, 0, 1},  {1, 1, 1},  {0, 1, 1},
+            {-1, 1, 1}, {0, 0, 1},  {1, -1, 1},  {0, -1, 1}, {-1, -1, 1}, {-1, 0, 1}};
+    } // namespace
+
+    struct ParticleGrid::ContactContext {
+        const ParticleData &particles;
+        const int32_t *simplices;
+        const Aabb *bounds;
+        const SimplexInfo *info;
+        const ContactParameters &parameters;
+    };
+
+    void ParticleGrid::generateFluidInteractions(const ParticleData &particles, const int32_t *fluidParticles,
+                                                 size_t count, float margin, float stepTime,
+                                                 std::vector<FluidInteraction> &interactions) {
+        interactions.clear();
+        if (count == 0) {
+            return;
+        }
+
+        // gather compact positions; cutoff and reach are the two halves of the pair test.
+        _positions.resize(count);
+        _cutoffs.resize(count);
+        _reach.resize(count);
+        float maxCutoff = 0, maxReach = 0;
+        for (size_t k = 0; k < count; ++k) {
+            const int32_t i = fluidParticles[k];
+            _positions[k] = particles.positions[i].xyz();
+            _cutoffs[k] = particles.smoothingRadii[i];
+            _reach[k] = length(particles.velocities[i].xyz()) * stepTime;
+            maxCutoff = std::max(maxCutoff, _cutoffs[k]);
+            maxReach = std::max(maxReach, _reach[k]);
+        }
+        const float radius = std::max(maxCutoff + margin + 2 * maxReach, 1e-6f);
+
+        if (_searcher == nullptr ||
+            std::abs(_searcher->hashUtils().gridSpacing() - radius) > kSpacingTolerance * radius) {
+            _searcher = std::make_unique<PointHashGridSearcher>(kResolution, kResolution, kResolution, radius);
+        }
+        _searcher->setNeighborhoodMode(_searcher->hashUtils().gridSpacing() >= radius
+                                           ? PointHashGridSearcher::NeighborhoodMode::Cube27
+                                           : PointHashGridSearcher::NeighborhoodMode::Radius);
+        _searcher->build(_positions.data(), count);
+
+        const auto &sortedIndices = _searcher->sortedIndices();
+        const auto &sortedPositions = _searcher->sortedPositions();
+        auto forEachPair = [&](size_t s, auto &&callback) {
+            const uint32_t a = sortedIndices[s];
+            _searcher->forEachNearbyPoint(sortedPositions[s], radius, [&](uint32_t b, const float3 &position) {
+                if (b > a) {
+                    const float cutoff = std::max(_cutoffs[a], _cutoffs[b]) + margin + _reach[a] + _reach[b];
+                    if (lengthSquared(position - sortedPositions[s]) < cutoff * cutoff) {
+                        callback(a, b);
+                    }
+                }
+            });
+        };
+
+        // one pass: every chunk of points collects the pairs it owns, chunks are then concatenated in order.
+        const size_t chunkCount = (count + kParticleGrain - 1) / kParticleGrain;
+        if (_chunkInteractions.size() < chunkCount) {
+            _chunkInteractions.resize(chunkCount);
+        }
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            std::vector<FluidInteraction> &pairs = _chunkInteractions[chunk];
+            pairs.clear();
+            for (size_t s = chunk * kParticleGrain, end = std::min(count, s + kParticleGrain); s < end; ++s) {
+                forEachPair(s, [&](uint32_t a, uint32_t b) {
+                    FluidInteraction &pair = pairs.emplace_back();
+                    pair.particleA = fluidParticles[a];
+                    pair.particleB = fluidParticles[b];
+                });
+            }
+        });
+
+        _offsets.resize(chunkCount + 1);
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            _offsets[chunk] = uint32_t(_chunkInteractions[chunk].size());
+        }
+        _offsets[chunkCount] = parallelExclusiveScan(_offsets.data(), _offsets.data(), chunkCount);
+        interactions.resize(_offsets[chunkCount]);
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            std::copy(_chunkInteractions[chunk].begin(), _chunkInteractions[chunk].end(),
+                      interactions.begin() + _offsets[chunk]);
+        });
+    }
+
+    // MARK: - Simplex contacts
+    void ParticleGrid::update(const Aabb *simplexBounds, size_t simplexCount, bool is2D) {
+        _newCellCoords.resize(simplexCount);
+        parallelFor(size_t(0), simplexCount, kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Aabb &bounds = simplexBounds[i];
+                const int32_t level = MultilevelGrid::gridLevelForSize(bounds.maxAxisLength());
+                const float cellSize = MultilevelGrid::cellSizeOfLevel(level);
+                const float4 center = bounds.center();
+                _newCellCoords[i] = int4(int32_t(std::floor(center.x / cellSize)),
+                                         int32_t(std::floor(center.y / cellSize)),
+                                         is2D ? 0 : int32_t(std::floor(center.z / cellSize)), level);
+            }
+        });
+
+        if (_simplexCellCoords.size() != simplexCount || simplexCount == 0) {
+            _grid.build(_newCellCoords.data(), simplexCount);
+        } else {
+            _movingSimplices.clear();
+            for (size_t i = 0; i < simplexCount; ++i) {
+                if (_newCellCoords[i] != _simplexCellCoords[i]) {
+                    _movingSimplices.push_back({_simplexCellCoords[i], _newCellCoords[i], int32_t(i)});
+                }
+            }
+            _grid.update(_movingSimplices.data(), _movingSimplices.size());
+        }
+        std::swap(_simplexCellCoords, _newCellCoords);
+    }
+
+    void ParticleGrid::generateParticleParticleContacts(const ParticleData &particles, const int32_t *simplices,
+                                                        const SimplexCounts &simplexCounts, const Aabb *simplexBounds,
+                                                        const ContactParameters &parameters,
+                                                        std::vector<Contact> &contacts) {
+        contacts.clear();
+        const size_t cellCount = _grid.cellCount();
+        if (cellCount == 0) {
+            return;
+        }
+
+        // merge phases and filters once per simplex rather than once per tested pair.
+        const size_t simplexCount = size_t(simplexCounts.simplexCount());
+        _simplexInfo.resize(simplexCount);
+        parallelFor(size_t(0), simplexCount, kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                SimplexInfo &info = _simplexInfo[i];
+                info.start = simplexCounts.getSimplexStartAndSize(int32_t(i), info.size);
+                info.group = kParticleGroupMask;
+                info.flags = 0;
+                info.category = 0;
+                info.mask = 0;
+                info.restPositionsEnabled = false;
+                for (int32_t j = 0; j < info.size; ++j) {
+                    const int32_t particle = simplices[info.start + j];
+                    const int32_t phase = particles.phases[particle];
+                    const int32_t filter = particles.filters[particle];
+                    info.group = std::min(info.group, phase & kParticleGroupMask);
+                    info.flags |= phase & ~kParticleGroupMask;
+                    info.category |= filter & kFilterCategoryBitmask;
+                    info.mask |= int32_t(uint32_t(filter) >> 16);
+                    info.restPositionsEnabled |= particles.restPositions[particle].w > 0.5f;
+                }
+            }
+        });
+
+        _grid.populatedLevels(_populatedLevels);
+        const ContactContext context{particles, simplices, simplexBounds, _simplexInfo.data(), parameters};
+        const int32_t neighborCount = parameters.is2D ? kHalfNeighborCount2D : kHalfNeighborCount;
+        const int32_t depth = parameters.is2D ? 0 : 1;
+
+        const size_t chunkCount = (cellCount + kCellGrain - 1) / kCellGrain;
+        if (_chunkContacts.size() < chunkCount) {
+            _chunkContacts.resize(chunkCount);
+        }
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            std::vector<Contact> &queue = _chunkContacts[chunk];
+            queue.clear();
+            for (size_t c = chunk * kCellGrain, end = std::min(cellCount, c + kCellGrain); c < end; ++c) {
+                const MultilevelGrid::Cell &cell = _grid.cell(int32_t(c));
+                const int32_t *contents = _grid.contents(int32_t(c));
+                auto testAgainst = [&](int32_t other) {
+                    if (other < 0) {
+                        return;
+                    }
+                    const int32_t *otherContents = _grid.contents(other);
+                    const uint32_t otherCount = _grid.cell(other).count;
+                    for (uint32_t a = 0; a < cell.count; ++a) {
+                        for (uint32_t b = 0; b < otherCount; ++b) {
+                            interactionTest(context, contents[a], otherContents[b], queue);
+                        }
+                    }
+                };
+
+                for (uint32_t a = 0; a < cell.count; ++a) {
+                    for (uint32_t b = a + 1; b < cell.count; ++b) {
+                        interactionTest(context, contents[a], contents[b], queue);
+                    }
+                }
+
+                for (int32_t n = 0; n < neighborCount; ++n) {
+                    const int32_t *offset = kHalfNeighbors[n];
+                    testAgainst(_grid.findCell(
+                        int4(cell.coords.x + offset[0], cell.coords.y + offset[1], cell.coords.z + offset[2],
+                             cell.coords.w)));
+                }
+
+                // simplices of coarser levels overlapping this cell sit around its parent at that level.
+                for (const int32_t level : _populatedLevels) {
+                    if (level <= cell.coords.w) {
+                        continue;
+                    }
+                    const int4 parent = MultilevelGrid::getParentCellCoords(cell.coords, level);
+                    for (int32_t x = -1; x <= 1; ++x) {
+                        for (int32_t y = -1; y <= 1; ++y) {
+                            for (int32_t z = -depth; z <= depth; ++z) {
+                                testAgainst(_grid.findCell(int4(parent.x + x, parent.y + y, parent.z + z, level)));
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        _offsets.resize(chunkCount + 1);
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            _offsets[chunk] = uint32_t(_chunkContacts[chunk].size());
+        }
+        _offsets[chunkCount] = parallelExclusiveScan(_offsets.data(), _offsets.data(), chunkCount);
+        contacts.resize(_offsets[chunkCount]);
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            std::copy(_chunkContacts[chunk].begin(), _chunkContacts[chunk].end(), contacts.begin() + _offsets[chunk]);
+        });
+    }
+
+    void ParticleGrid::interactionTest(const ContactContext &context, int32_t A, int32_t B,
+                                       std::vector<Contact> &contacts) {
+        const ContactParameters &parameters = context.parameters;
+        if (!context.bounds[A].intersectsAabb(context.bounds[B], parameters.is2D)) {
+            return;
+        }
+
+        // the closest point search is not symmetric: order pairs by index so results do not depend on the
+        // order of cell contents, which incremental updates do not preserve.
+        if (A > B) {
+            std::swap(A, B);
+        }
+        const SimplexInfo *infoA = &context.info[A];
+        const SimplexInfo *infoB = &context.info[B];
+        const int32_t *simplices = context.simplices;
+        for (int32_t i = 0; i < infoA->size; ++i) {
+            for (int32_t j = 0; j < infoB->size; ++j) {
+                if (simplices[infoA->start + i] == simplices[infoB->start + j]) {
+                    return;
+                }
+            }
+        }
+
+        if (infoA->group == infoB->group) {
+            if ((infoA->flags & infoB->flags & kParticleSelfCollide) == 0) {
+                return;
+            }
+        } else if ((infoA->mask & infoB->category) == 0 || (infoB->mask & infoA->category) == 0) {
+            return;
+        }
+        if ((infoA->flags & infoB->flags & kParticleFluid) != 0) {
+            return;
+        }
+
+        // one-sided simplices are always B, so their normals orient the contact.
+        if ((infoA->flags & kParticleOneSided) != 0 && (infoB->flags & kParticleOneSided) == 0) {
+            std::swap(A, B);
+            std::swap(infoA, infoB);
+        }
+
+        const ParticleData &particles = context.particles;
+        float4 simplexBary = barycenterForSimplexOfSize(infoA->size);
+        float4 simplexPoint;
+
+        Simplex simplexShape;
+        simplexShape.simplices = simplices;
+        simplexShape.simplexStart = infoB->start;
+        simplexShape.simplexSize = infoB->size;
+
+        if (infoA->group == infoB->group && infoA->restPositionsEnabled && infoB->restPositionsEnabled) {
+            simplexShape.positions = particles.restPositions.data();
+            simplexShape.cacheData();
+            const SurfacePoint restPoint = LocalOptimization::optimize(
+                simplexShape, particles.restPositions.data(), particles.restOrientations.data(),
+                particles.principalRadii.data(), simplices, infoA->start, infoA->size, simplexBary, simplexPoint,
+                parameters.optimizationIterations, parameters.optimizationTolerance);
+
+            float restRadii = 0;
+            for (int32_t j = 0; j < infoA->size; ++j) {
+                restRadii += particles.principalRadii[simplices[infoA->start + j]].x * simplexBary[j];
+            }
+            for (int32_t j = 0; j < infoB->size; ++j) {
+                restRadii += particles.principalRadii[simplices[infoB->start + j]].x * restPoint.bary[j];
+            }
+            if (length((simplexPoint - restPoint.point).xyz()) <= restRadii) {
+                return;
+            }
+            simplexBary = barycenterForSimplexOfSize(infoA->size);
+        }
+
+        simplexShape.positions = particles.positions.data();
+        simplexShape.cacheData();
+        SurfacePoint surfacePoint = LocalOptimization::optimize(
+            simplexShape, particles.positions.data(), particles.orientations.data(), particles.principalRadii.data(),
+            simplices, infoA->start, infoA->size, simplexBary, simplexPoint, parameters.optimizationIterations,
+            parameters.optimizationTolerance);
+
+        float radiusA = 0, radiusB = 0, invMassA = 0, invMassB = 0;
+        float4 velocityA, velocityB, normalB;
+        for (int32_t j = 0; j < infoA->size; ++j) {
+            const int32_t particle = simplices[infoA->start + j];
+            radiusA += particles.principalRadii[particle].x * simplexBary[j];
+            invMassA += particles.invMasses[particle] * simplexBary[j];
+            velocityA += particles.velocities[particle] * simplexBary[j];
+        }
+        for (int32_t j = 0; j < infoB->size; ++j) {
+            const int32_t particle = simplices[infoB->start + j];
+            radiusB += particles.principalRadii[particle].x * surfacePoint.bary[j];
+            invMassB += particles.invMasses[particle] * surfacePoint.bary[j];
+            velocityB += particles.velocities[particle] * surfacePoint.bary[j];
+            normalB += particles.normals[particle] * surfacePoint.bary[j];
+        }
+        if (invMassA <= 0 && invMassB <= 0) {
+            return;
+        }
+
+        // coincident simplices have no direction between them: push them apart vertically.
+        if (lengthSquared(surfacePoint.normal.xyz()) < 1e-12f) {
+            surfacePoint.normal = float4(0, 1, 0, 0);
+        }
+        if ((infoB->flags & kParticleOneSided) != 0) {
+            oneSidedNormal(normalB, surfacePoint.normal);
+        }
+
+        const float dAB = dot((simplexPoint - surfacePoint.point).xyz(), surfacePoint.normal.xyz());
+        const float velocity = dot((velocityA - velocityB).xyz(), surfacePoint.normal.xyz());
+        if (velocity * parameters.stepTime + dAB <= radiusA + radiusB + parameters.collisionMargin) {
+            Contact &contact = contacts.emplace_back();
+            contact.bodyA = A;
+            contact.bodyB = B;
+            contact.pointA = simplexBary;
+            contact.pointB = surfacePoint.bary;
+            contact.normal = surfacePoint.normal;
+            contact.distance = dAB - radiusA - radiusB;
+        }
+    }
+
+    // MARK: - Spatial queries
+    size_t ParticleGrid::spatialQuery(const ParticleData &particles, const int32_t *simplices,
+                                      const Aabb *simplexBounds, const QueryShape *shapes,
+                                      const AffineTransform *shapeToSolver, size_t count,
+                                      const QueryParameters &parameters, QueryResult *results, size_t capacity) {
+        const size_t cellCount = _grid.cellCount();
+        if (count == 0 || cellCount == 0 || _simplexInfo.empty()) {
+            return 0;
+        }
+
+        // counting sort of the cells by level, so a query can fall back to scanning the cells of one level.
+        _grid.populatedLevels(_populatedLevels);
+        const size_t levelCount = _populatedLevels.size();
+        auto levelIndex = [&](int32_t level) {
+            return size_t(std::find(_populatedLevels.begin(), _populatedLevels.end(), level) -
+                          _populatedLevels.begin());
+        };
+        _levelOffsets.assign(levelCount + 1, 0);
+        _cellEntries.resize(cellCount + 1);
+        for (size_t c = 0; c < cellCount; ++c) {
+            const MultilevelGrid::Cell &cell = _grid.cell(int32_t(c));
+            ++_levelOffsets[levelIndex(cell.coords.w) + 1];
+            _cellEntries[c] = cell.count;
+        }
+        for (size_t l = 0; l < levelCount; ++l) {
+            _levelOffsets[l + 1] += _levelOffsets[l];
+        }
+        _levelCells.resize(cellCount);
+        _offsets.assign(_levelOffsets.begin(), _levelOffsets.end());
+        for (size_t c = 0; c < cellCount; ++c) {
+            _levelCells[_offsets[levelIndex(_grid.cell(int32_t(c)).coords.w)]++] = int32_t(c);
+        }
+
+        // gather the bounds and filters of the simplices in cell order once, rather than once per query
+        // visiting them: queries then read every cell as one contiguous run.
+        _cellEntries[cellCount] = parallelExclusiveScan(_cellEntries.data(), _cellEntries.data(), cellCount);
+        _queryEntries.resize(_cellEntries[cellCount]);
+        parallelFor(size_t(0), cellCount, kCellGrain, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                const int32_t *contents = _grid.contents(int32_t(c));
+                QueryEntry *entries = _queryEntries.data() + _cellEntries[c];
+                for (uint32_t k = 0, n = _cellEntries[c + 1] - _cellEntries[c]; k < n; ++k) {
+                    const SimplexInfo &info = _simplexInfo[contents[k]];
+                    entries[k] = {simplexBounds[contents[k]], contents[k],
+                                  int32_t((uint32_t(info.mask) << 16) | uint32_t(info.category)), info.start,
+                                  info.size};
+                }
+            }
+        });
+
+        const size_t chunkCount = (count + kQueryGrain - 1) / kQueryGrain;
+        if (_chunkResults.size() < chunkCount) {
+            _chunkResults.resize(chunkCount);
+            _chunkCells.resize(chunkCount);
+        }
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            std::vector<QueryResult> &queue = _chunkResults[chunk];
+            std::vector<int32_t> &cells = _chunkCells[chunk];
+            queue.clear();
+            for (size_t q = chunk * kQueryGrain, end = std::min(count, q + kQueryGrain); q < end; ++q) {
+                const QueryShape &shape = shapes[q];
+                const AffineTransform transform = shapeToSolver != nullptr ? shapeToSolver[q] : AffineTransform();
+                switch (shape.type) {
+                    case QueryShape::Type::Sphere:
+                        queryTest(SphereQuery(shape, transform), particles, simplices, shape, int32_t(q), parameters,
+                                  cells, queue);
+                        break;
+                    case QueryShape::Type::Box:
+                        queryTest(BoxQuery(shape, transform), particles, simplices, shape, int32_t(q), parameters,
+                                  cells, queue);
+                        break;
+                    case QueryShape::Type::Ray:
+                        queryTest(RayQuery(shape, transform), particles, simplices, shape, int32_t(q), parameters,
+                                  cells, queue);
+                        break;
+                }
+            }
+        });
+
+        _offsets.resize(chunkCount + 1);
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            _offsets[chunk] = uint32_t(_chunkResults[chunk].size());
+        }
+        _offsets[chunkCount] = parallelExclusiveScan(_offsets.data(), _offsets.data(), chunkCount);
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            const std::vector<QueryResult> &queue = _chunkResults[chunk];
+            const size_t first = std::min(size_t(_offsets[chunk]), capacity);
+            const size_t last = std::min(first + queue.size(), capacity);
+            std::copy(queue.begin(), queue.begin() + ptrdiff_t(last - first), results + first);
+        });
+        return _offsets[chunkCount];
+    }
+
+    template <typename Function>
+    void ParticleGrid::queryTest(const Function &function, const ParticleData &particles, const int32_t *simplices,
+                                 const QueryShape &shape, int32_t queryIndex, const QueryParameters &parameters,
+                                 std::vector<int32_t> &cells, std::vector<QueryResult> &results) const {
+        const float margin = std::max(shape.maxDistance, 0.f);
+        Aabb bounds = function.bounds();
+        bounds.expand(float4(float3(margin), 0));
+        const int32_t category = shape.filter & kFilterCategoryBitmask;
+        const int32_t mask = int32_t(uint32_t(shape.filter) >> 16);
+        const bool is2D = parameters.is2D;
+
+        auto testCell = [&](int32_t c) {
+            for (uint32_t k = _cellEntries[c]; k < _cellEntries[c + 1]; ++k) {
+                const QueryEntry &entry = _queryEntries[k];
+                if ((category & int32_t(uint32_t(entry.filter) >> 16)) == 0 ||
+                    (mask & entry.filter & kFilterCategoryBitmask) == 0 || !entry.bounds.intersectsAabb(bounds, is2D) ||
+                    !function.overlaps(entry.bounds, margin, is2D)) {
+                    continue;
+                }
+
+                float4 simplexBary = barycenterForSimplexOfSize(entry.size);
+                float4 simplexPoint;
+                // query shapes ignore the simplex orientation, which is then left out of the search.
+                const SurfacePoint surfacePoint = LocalOptimization::optimize(
+                    function, particles.positions.data(), nullptr, particles.principalRadii.data(), simplices,
+                    entry.start, entry.size, simplexBary, simplexPoint, parameters.optimizationIterations,
+                    parameters.optimizationTolerance);
+
+                float radius = 0;
+                for (int32_t j = 0; j < entry.size; ++j) {
+                    radius += particles.principalRadii[simplices[entry.start + j]].x * simplexBary[j];
+                }
+                const float distance =
+                    dot((simplexPoint - surfacePoint.point).xyz(), surfacePoint.normal.xyz()) - radius;
+                if (distance <= shape.maxDistance) {
+                    QueryResult &result = results.emplace_back();
+                    result.simplexBary = simplexBary;
+                    result.queryPoint = surfacePoint.point;
+                    result.normal = surfacePoint.normal;
+                    result.distance = distance;
+                    result.simplexIndex = entry.simplex;
+                    result.queryIndex = queryIndex;
+                }
+            }
+        };
+
+        for (size_t l = 0; l < _populatedLevels.size(); ++l) {
+            const int32_t level = _populatedLevels[l];
+            const float cellSize = MultilevelGrid::cellSizeOfLevel(level);
+            const float half = cellSize * 0.5f;
+            const uint32_t first = _levelOffsets[l], last = _levelOffsets[l + 1];
+
+            // simplices stick out of their cell by up to half a cell, so a cell may hold simplices near the
+            // shape if the cell grown by that much overlaps it.
+            auto reaches = [&](const int4 &coords) {
+                const float4 lower(float(coords.x) * cellSize - half, float(coords.y) * cellSize - half,
+                                   float(coords.z) * cellSize - half, 0);
+                return function.overlaps(Aabb(lower, lower + float4(float3(cellSize * 2), 0)), margin, is2D);
+            };
+            auto spanOf = [&](const Aabb &box, int4 &minCell, int4 &maxCell) {
+                const float4 lower = (box.min - float4(half)) / cellSize;
+                const float4 upper = (box.max + float4(half)) / cellSize;
+                minCell = int4(int32_t(std::floor(lower.x)), int32_t(std::floor(lower.y)),
+                               is2D ? 0 : int32_t(std::floor(lower.z)), level);
+                maxCell = int4(int32_t(std::floor(upper.x)), int32_t(std::floor(upper.y)),
+                               is2D ? 0 : int32_t(std::floor(upper.z)), level);
+                return (double(maxCell.x) - minCell.x + 1) * (double(maxCell.y) - minCell.y + 1) *
+                       (double(maxCell.z) - minCell.z + 1);
+            };
+
+            // rays are split in pieces about a cell long, so long rays only visit the cells around them.
+            size_t pieceCount = 1;
+            if constexpr (std::is_same_v<Function, RayQuery>) {
+                const float length = maxComponent(abs((function.end - function.start).xyz()));
+                pieceCount = size_t(std::clamp(std::ceil(length / cellSize), 1.f, float(last - first)));
+            }
+            auto pieceBounds = [&](size_t piece) {
+                if constexpr (std::is_same_v<Function, RayQuery>) {
+                    if (pieceCount > 1) {
+                        Aabb box = function.pieceBounds(float(piece) / float(pieceCount),
+                                                        float(piece + 1) / float(pieceCount));
+                        box.expand(float4(float3(margin), 0));
+                        return box;
+                    }
+                }
+                return bounds;
+            };
+
+            int4 minCell, maxCell;
+            double visits = 0;
+            for (size_t piece = 0; piece < pieceCount && visits <= double(last - first); ++piece) {
+                visits += spanOf(pieceBounds(piece), minCell, maxCell);
+            }
+
+            // scanning the level's cells is cheaper than visiting that many coords.
+            if (visits > double(last - first)) {
+                spanOf(bounds, minCell, maxCell);
+                for (uint32_t k = first; k < last; ++k) {
+                    const int4 &coords = _grid.cell(_levelCells[k]).coords;
+                    if (coords.x >= minCell.x && coords.x <= maxCell.x && coords.y >= minCell.y &&
+                        coords.y <= maxCell.y && coords.z >= minCell.z && coords.z <= maxCell.z && reaches(coords)) {
+                        testCell(_levelCells[k]);
+                    }
+                }
+                continue;
+            }
+
+            cells.clear();
+            for (size_t piece = 0; piece < pieceCount; ++piece) {
+                spanOf(pieceBounds(piece), minCell, maxCell);
+                for (int32_t x = minCell.x; x <= maxCell.x; ++x) {
+                    for (int32_t y = minCell.y; y <= maxCell.y; ++y) {
+                        for (int32_t z = minCell.z; z <= maxCell.z; ++z) {
+                            const int4 coords(x, y, z, level);
+                            if (reaches(coords)) {
+                                const int32_t c = _grid.findCell(coords);
+                                if (c >= 0) {
+                                    cells.push_back(c);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            // consecutive pieces share cells: visit each once, in index order.
+            if (pieceCount > 1) {
+                std::sort(cells.begin(), cells.end());
+                cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+            }
+            for (const int32_t c : cells) {
+                testCell(c);
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,143 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Aabb.h"
+#include "../../hash-grid/PointHashGridSearcher.h"
+#include "../../solver/ParticleData.h"
+#include "../../solver/SimplexCounts.h"
+#include "../multilevel-grid/MultilevelGrid.h"
+#include "../queries/Contact.h"
+#include "../queries/SpatialQuery.h"
+#include "FluidInteraction.h"
+#include <memory>
+#include <vector>
+
+namespace vox::flex {
+    // Per-step neighbor finding for the solver. Pairs are searched once at the start of a step with a cutoff
+    // large enough to stay valid for every substep of it: fluid particles on the CPU hash grid, simplices of
+    // any size on a multilevel grid where each simplex lives in a single cell of the level matching its size.
+    class ParticleGrid {
+    public:
+        static constexpr uint32_t kResolution = 64;
+
+        struct ContactParameters {
+            float stepTime = 0;
+            float collisionMargin = 0;
+            // closest point search between simplices of more than one particle.
+            int optimizationIterations = 16;
+            float optimizationTolerance = 0.004f;
+            bool is2D = false;
+        };
+
+        struct QueryParameters {
+            // closest point search between simplices and query shapes.
+            int optimizationIterations = 16;
+            float optimizationTolerance = 0.004f;
+            bool is2D = false;
+        };
+
+        // Interactions between the given fluid particles: a pair interacts if its distance is below the
+        // larger smoothing radius plus `margin`, grown by how far both particles may travel in `stepTime`.
+        // Each pair is reported once, pairs come out in grid order.
+        void generateFluidInteractions(const ParticleData &particles, const int32_t *fluidParticles, size_t count,
+                                       float margin, float stepTime, std::vector<FluidInteraction> &interactions);
+
+        // Moves every simplex to the cell matching its bounds. The grid is updated incrementally with the
+        // simplices that changed cell, and rebuilt when the simplex count changed or after `invalidate`.
+        void update(const Aabb *simplexBounds, size_t simplexCount, bool is2D);
+
+        // Forces the next `update` to rebuild the grid, for when simplices were replaced.
+        void invalidate() { _simplexCellCoords.clear(); }
+
+        const MultilevelGrid &grid() const { return _grid; }
+
+        // Contacts between simplices of the grid, as of the last `update`. Each cell is tested against itself,
+        // half of its neighbors at the same level and the neighborhood of its parent cell in every coarser
+        // populated level, so each pair is tested once. Pairs must have intersecting bounds, share no particle
+        // and pass the phase tests: simplices of the same group only collide if self-colliding, others if
+        // the category of each is in the mask of the other. Fluid pairs are left to the fluid interactions.
+        // Simplices at rest intersecting each other in their rest shape never collide.
+        //
+        // Cells are processed in parallel chunks, each filling its own contact queue; queues are then
+        // concatenated in chunk order, without locks and with a deterministic result.
+        void generateParticleParticleContacts(const ParticleData &particles, const int32_t *simplices,
+                                              const SimplexCounts &simplexCounts, const Aabb *simplexBounds,
+                                              const ContactParameters &parameters, std::vector<Contact> &contacts);
+
+        // Simplices near each of the `count` shapes, on the grid of the last `update` with the phases and
+        // filters of the last contact generation. `shapeToSolver` holds the transform of every shape, null
+        // for shapes already in solver space. A simplex is reported when the category of each of them is in
+        // the mask of the other and its distance to the shape is at most the shape's maxDistance.
+        //
+        // Bounds and filters of the simplices are first gathered in cell order, so cells are read as
+        // contiguous runs. Each shape then visits, at every populated level, the cells its bounds overlap
+        // widened by half a cell since simplices may stick out of their cell by that much: rays piece by
+        // piece so long ones only visit the cells around them, or the level's whole cell list when that is
+        // shorter. Shapes are processed in parallel chunks, each filling its own result queue; queues are
+        // then copied in chunk order into `results`, up to `capacity` of them. Returns the number of results
+        // found, which may exceed `capacity`.
+        size_t spatialQuery(const ParticleData &particles, const int32_t *simplices, const Aabb *simplexBounds,
+                            const QueryShape *shapes, const AffineTransform *shapeToSolver, size_t count,
+                            const QueryParameters &parameters, QueryResult *results, size_t capacity);
+
+    private:
+        // phase and filter data of a simplex, merged over its particles.
+        struct SimplexInfo {
+            int32_t start = 0;
+            int32_t size = 0;
+            int32_t group = 0;
+            int32_t flags = 0;
+            int32_t category = 0;
+            int32_t mask = 0;
+            bool restPositionsEnabled = false;
+        };
+
+        struct ContactContext;
+
+        static void interactionTest(const ContactContext &context, int32_t A, int32_t B, std::vector<Contact> &contacts);
+
+        // what queries read of a simplex, its merged filter laid out as a particle filter.
+        struct alignas(16) QueryEntry {
+            Aabb bounds;
+            int32_t simplex = 0;
+            int32_t filter = 0;
+            int32_t start = 0;
+            int32_t size = 0;
+        };
+
+        template <typename Function>
+        void queryTest(const Function &function, const ParticleData &particles, const int32_t *simplices,
+                       const QueryShape &shape, int32_t queryIndex, const QueryParameters &parameters,
+                       std::vector<int32_t> &cells, std::vector<QueryResult> &results) const;
+
+        // rebuilt when the search radius changes by more than this fraction, so the grid spacing stays close to it.
+        static constexpr float kSpacingTolerance = 0.25f;
+
+        std::unique_ptr<PointHashGridSearcher> _searcher;
+        std::vector<float3> _positions;
+        std::vector<float> _cutoffs;
+        std::vector<float> _reach;
+        std::vector<std::vector<FluidInteraction>> _chunkInteractions;
+        std::vector<uint32_t> _offsets;
+
+        MultilevelGrid _grid;
+        std::vector<int4> _simplexCellCoords;
+        std::vector<int4> _newCellCoords;
+        std::vector<MovingEntity> _movingSimplices;
+        std::vector<SimplexInfo> _simplexInfo;
+        std::vector<int32_t> _populatedLevels;
+        std::vector<std::vector<Contact>> _chunkContacts;
+        // cells grouped by populated level, for queries.
+        std::vector<int32_t> _levelCells;
+        std::vector<uint32_t> _levelOffsets;
+        std::vector<uint32_t> _cellEntries;
+        std::vector<QueryEntry> _queryEntries;
+        std::vector<std::vector<QueryResult>> _chunkResults;
+        std::vector<std::vector<int32_t>> _chunkCells;
+    };
+} // namespace vox::flex
@@ -0,0 +1,44 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/Math.h"
+
+namespace vox::flex {
+    // A contact between two simplices, or a simplex and a collider. Field order follows BurstContact.
+    struct alignas(16) Contact {
+        // barycentric coords in simplex A; in simplex B, or a solver space position for colliders.
+        float4 pointA;
+        float4 pointB;
+
+        // points from B towards A.
+        float4 normal;
+        float4 tangent;
+        float4 bitangent;
+
+        // signed distance between the surfaces along the normal at detection time, radii included.
+        float distance = 0;
+
+        float normalLambda = 0;
+        float tangentLambda = 0;
+        float bitangentLambda = 0;
+        float stickLambda = 0;
+        float rollingFrictionImpulse = 0;
+
+        // simplex index for A; simplex or collider index for B.
+        int32_t bodyA = -1;
+        int32_t bodyB = -1;
+
+        float normalInvMassA = 0;
+        float tangentInvMassA = 0;
+        float bitangentInvMassA = 0;
+
+        float normalInvMassB = 0;
+        float tangentInvMassB = 0;
+        float bitangentInvMassB = 0;
+    };
+} // namespace vox::flex
@@ -0,0 +1,193 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../collisions/ColliderShape.h"
+#include "../../collisions/CollisionMath.h"
+#include "../../collisions/LocalOptimization.h"
+#include "../../common/Aabb.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    // A shape looking for the simplices around it, native counterpart of QueryShape. Center and size are in
+    // the frame of the query's transform:
+    //   sphere: center and radius (size.x),
+    //   box:    center and size along each axis,
+    //   ray:    start (center) and end (size) of a segment, contactOffset being its thickness.
+    // Every shape is grown by contactOffset, simplices up to maxDistance from its surface are reported.
+    struct alignas(16) QueryShape {
+        enum class Type : int32_t { Sphere = 0, Box = 1, Ray = 2 };
+
+        float4 center;
+        float4 size;
+        Type type = Type::Sphere;
+        float contactOffset = 0;
+        float maxDistance = 0;
+        int32_t filter = int32_t(0xffff0001);
+    };
+
+    // A simplex found by a query, native counterpart of QueryResult: barycentric coords of the simplex point
+    // nearest to the shape, the nearest point of the shape's surface and the direction from it towards the
+    // simplex, all in solver space. The distance includes the simplex radius, and is negative on overlap.
+    struct alignas(16) QueryResult {
+        float4 simplexBary;
+        float4 queryPoint;
+        float4 normal;
+        float distance = 0;
+        int32_t simplexIndex = -1;
+        int32_t queryIndex = -1;
+    };
+
+    // Distance functions of the query shapes in solver space, for LocalOptimization. `transform` maps the
+    // shape's frame to solver space, and its scale applies to the shape's dimensions.
+    struct SphereQuery {
+        float3 center;
+        float radius;
+        AffineTransform transform;
+
+        SphereQuery(const QueryShape &shape, const AffineTransform &shapeToSolver)
+            : center(shape.center.xyz() * shapeToSolver.scale.xyz()),
+              radius(shape.size.x * shapeToSolver.scale.x + shape.contactOffset), transform(shapeToSolver) {}
+
+        Aabb bounds() const {
+            const float4 c = transform.transformPointUnscaled(float4(center, 0));
+            return {c - float4(radius), c + float4(radius)};
+        }
+
+        bool overlaps(const Aabb &box, float margin, bool in2D) const {
+            const float4 c = transform.transformPointUnscaled(float4(center, 0));
+            const float4 outside = max(max(box.min - c, c - box.max), float4());
+            const float reach = radius + margin;
+            return lengthSquared(in2D ? float3(outside.x, outside.y, 0) : outside.xyz()) <= reach * reach;
+        }
+
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            const float3 local = transform.inverseTransformPointUnscaled(point).xyz() - center;
+            const float distance = length(local);
+            const float3 normal = distance > 1e-12f ? local / distance : float3(0, 1, 0);
+            projectedPoint.point = transform.transformPointUnscaled(float4(center + normal * radius, 0));
+            projectedPoint.normal = transform.transformDirection(float4(normal, 0));
+        }
+    };
+
+    struct BoxQuery {
+        float3 center;
+        float3 halfSize;
+        float offset;
+        AffineTransform transform;
+
+        BoxQuery(const QueryShape &shape, const AffineTransform &shapeToSolver)
+            : center(shape.center.xyz() * shapeToSolver.scale.xyz()),
+              halfSize(abs(shape.size.xyz() * shapeToSolver.scale.xyz()) * 0.5f), offset(shape.contactOffset),
+              transform(shapeToSolver) {}
+
+        Aabb bounds() const {
+            // extent of the rotated box along each axis: |R| halfSize.
+            const float3 extent = abs(rotate(transform.rotation, float3(halfSize.x, 0, 0))) +
+                                  abs(rotate(transform.rotation, float3(0, halfSize.y, 0))) +
+                                  abs(rotate(transform.rotation, float3(0, 0, halfSize.z))) + float3(offset);
+            const float4 c = transform.transformPointUnscaled(float4(center, 0));
+            return {c - float4(extent, 0), c + float4(extent, 0)};
+        }
+
+        // separating axes of the box only, enough to cull boxes away from its corners and edges.
+        bool overlaps(const Aabb &box, float margin, bool in2D) const {
+            float3 local = transform.inverseTransformPointUnscaled(box.center()).xyz() - center;
+            float3 extent = box.size().xyz() * 0.5f;
+            if (in2D) {
+                local.z = 0;
+                extent.z = 0;
+            }
+            const quaternion inverse = conjugate(transform.rotation);
+            const float3 reach = abs(rotate(inverse, float3(extent.x, 0, 0))) +
+                                 abs(rotate(inverse, float3(0, extent.y, 0))) +
+                                 abs(rotate(inverse, float3(0, 0, extent.z))) + halfSize + float3(offset + margin);
+            const float3 distance = abs(local);
+            return distance.x <= reach.x && distance.y <= reach.y && distance.z <= reach.z;
+        }
+
+        // points inside the box are pushed out through the nearest face, as BoxShape does.
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            const float3 local = transform.inverseTransformPointUnscaled(point).xyz() - center;
+            const float3 distances = halfSize - abs(local);
+            float3 nearest, normal;
+            if (distances.x > 0 && distances.y > 0 && distances.z > 0) {
+                int axis = distances.y < distances.x ? 1 : 0;
+                if (distances.z < distances[axis]) {
+                    axis = 2;
+                }
+                nearest = local;
+                normal = float3(0, 0, 0);
+                nearest[axis] = local[axis] < 0 ? -halfSize[axis] : halfSize[axis];
+                normal[axis] = local[axis] < 0 ? -1.f : 1.f;
+            } else {
+                nearest = min(max(local, -halfSize), halfSize);
+                const float distance = length(local - nearest);
+                normal = distance > 1e-12f ? (local - nearest) / distance : float3(0, 1, 0);
+            }
+            projectedPoint.point = transform.transformPointUnscaled(float4(center + nearest + normal * offset, 0));
+            projectedPoint.normal = transform.transformDirection(float4(normal, 0));
+        }
+    };
+
+    struct RayQuery {
+        // segment ends in solver space.
+        float4 start;
+        float4 end;
+        float thickness;
+
+        RayQuery(const QueryShape &shape, const AffineTransform &shapeToSolver)
+            : start(shapeToSolver.transformPoint(shape.center)), end(shapeToSolver.transformPoint(shape.size)),
+              thickness(shape.contactOffset) {}
+
+        Aabb bounds() const { return pieceBounds(0, 1); }
+
+        // bounds of the part of the segment between `from` and `to`, as fractions of its length.
+        Aabb pieceBounds(float from, float to) const {
+            Aabb box;
+            box.encapsulateParticle(start + (end - start) * from, start + (end - start) * to, thickness);
+            return box;
+        }
+
+        // slab test of the segment against the box grown by the thickness.
+        bool overlaps(const Aabb &box, float margin, bool in2D) const {
+            const float reach = thickness + margin;
+            float enter = 0, exit = 1;
+            for (int axis = 0; axis < (in2D ? 2 : 3); ++axis) {
+                const float lower = box.min[axis] - reach, upper = box.max[axis] + reach;
+                const float direction = end[axis] - start[axis];
+                if (std::abs(direction) < 1e-12f) {
+                    if (start[axis] < lower || start[axis] > upper) {
+                        return false;
+                    }
+                    continue;
+                }
+                float t0 = (lower - start[axis]) / direction, t1 = (upper - start[axis]) / direction;
+                if (t0 > t1) {
+                    std::swap(t0, t1);
+                }
+                enter = std::max(enter, t0);
+                exit = std::min(exit, t1);
+                if (enter > exit) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void evaluate(const float4 &point, const float4 &, const quaternion &, SurfacePoint &projectedPoint) const {
+            float mu;
+            const float4 centerLine = nearestPointOnEdge(start, end, point, mu);
+            const float3 towardsPoint = (point - centerLine).xyz();
+            const float distance = length(towardsPoint);
+            const float3 normal = distance > 1e-12f ? towardsPoint / distance : float3(0, 1, 0);
+            projectedPoint.point = centerLine + float4(normal * thickness, 0);
+            projectedPoint.normal = float4(normal, 0);
+        }
+    };
+} // namespace vox::flex
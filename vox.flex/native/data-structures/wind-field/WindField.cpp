@@ -0,0 +1,61 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "WindField.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    void WindField::set(const float4 *samples, int32_t resolutionX, int32_t resolutionY, int32_t resolutionZ,
+                        const float3 &lower, const float3 &upper) {
+        _resolution[0] = std::max(resolutionX, 2);
+        _resolution[1] = std::max(resolutionY, 2);
+        _resolution[2] = std::max(resolutionZ, 2);
+        _samples.assign(samples, samples + size_t(resolutionX) * resolutionY * resolutionZ);
+        _samples.resize(size_t(_resolution[0]) * _resolution[1] * _resolution[2]);
+        _lower = lower;
+        const float3 size = max(upper - lower, float3(1e-6f));
+        _scale = float3(float(_resolution[0] - 1), float(_resolution[1] - 1), float(_resolution[2] - 1)) / size;
+    }
+
+    void WindField::clear() {
+        _samples.clear();
+        _resolution[0] = _resolution[1] = _resolution[2] = 0;
+    }
+
+    void WindField::sample(const float *x, const float *y, const float *z, float *outX, float *outY, float *outZ,
+                           size_t n) const {
+        const int32_t rx = _resolution[0], ry = _resolution[1], rz = _resolution[2];
+        const size_t strideY = size_t(rx), strideZ = size_t(rx) * ry;
+        for (size_t l = 0; l < n; ++l) {
+            // grid coordinates clamped to the box, split into a cell and the offset inside it.
+            const float gx = std::clamp((x[l] - _lower.x) * _scale.x, 0.f, float(rx - 1));
+            const float gy = std::clamp((y[l] - _lower.y) * _scale.y, 0.f, float(ry - 1));
+            const float gz = std::clamp((z[l] - _lower.z) * _scale.z, 0.f, float(rz - 1));
+            const int32_t ix = std::min(int32_t(gx), rx - 2);
+            const int32_t iy = std::min(int32_t(gy), ry - 2);
+            const int32_t iz = std::min(int32_t(gz), rz - 2);
+            const float fx = gx - float(ix), fy = gy - float(iy), fz = gz - float(iz);
+
+            const float4 *c = _samples.data() + iz * strideZ + iy * strideY + ix;
+            const float4 x00 = lerp(c[0], c[1], fx);
+            const float4 x10 = lerp(c[strideY], c[strideY + 1], fx);
+            const float4 x01 = lerp(c[strideZ], c[strideZ + 1], fx);
+            const float4 x11 = lerp(c[strideZ + strideY], c[strideZ + strideY + 1], fx);
+            const float4 v = lerp(lerp(x00, x10, fy), lerp(x01, x11, fy), fz);
+            outX[l] = v.x;
+            outY[l] = v.y;
+            outZ[l] = v.z;
+        }
+    }
+
+    float3 WindField::sample(const float3 &point) const {
+        float3 v;
+        sample(&point.x, &point.y, &point.z, &v.x, &v.y, &v.z, 1);
+        return v;
+    }
+} // namespace vox::flex
@@ -0,0 +1,40 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../../common/AlignedVector.h"
+#include "../../common/Math.h"
+
+namespace vox::flex {
+    // Wind velocities on a regular 3D grid over a box in solver space, the CPU side of a wind texture. Sample
+    // (i, j, k) sits at lower + (i, j, k) * cell size, so samples span the box corner to corner; points are
+    // interpolated trilinearly and clamped to the box, like a clamped texture read.
+    class WindField {
+    public:
+        // `samples` holds resolutionX * resolutionY * resolutionZ velocities, x fastest, with w unused. Every
+        // resolution is at least 2.
+        void set(const float4 *samples, int32_t resolutionX, int32_t resolutionY, int32_t resolutionZ,
+                 const float3 &lower, const float3 &upper);
+
+        void clear();
+
+        bool empty() const { return _samples.empty(); }
+
+        // Wind velocity at `n` points given in SoA lanes, xyz written to the output lanes.
+        void sample(const float *x, const float *y, const float *z, float *outX, float *outY, float *outZ,
+                    size_t n) const;
+
+        float3 sample(const float3 &point) const;
+
+    private:
+        AlignedVector<float4> _samples;
+        int32_t _resolution[3] = {0, 0, 0};
+        float3 _lower;
+        // samples per unit length along each axis.
+        float3 _scale;
+    };
+} // namespace vox::flex
@@ -0,0 +1,51 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+/// Buckets visited by neighbor queries, see PointHashGridSearcher::NeighborhoodMode.
+typedef NS_ENUM(uint32_t, CNeighborhoodMode) {
+    /// 8 nearest buckets, radius up to half the grid spacing.
+    CNeighborhoodModeOctant8,
+    /// 3x3x3 buckets, radius up to the grid spacing.
+    CNeighborhoodModeCube27,
+    /// every bucket overlapped by the query box.
+    CNeighborhoodModeRadius,
+};
+
+/// CPU hash grid neighbor searcher, same hashing as the Metal PointHashGridSearcher.
+@interface CPointHashGridSearcher : NSObject
+
+- (instancetype _Nonnull)initWithResolution:(simd_uint3)resolution gridSpacing:(float)gridSpacing;
+
+@property(nonatomic) CNeighborhoodMode neighborhoodMode;
+
+- (void)build:(const simd_float3 *_Nonnull)positions count:(uint32_t)count;
+
+/// Incremental rebuild for mostly static points, falls back to a full build when too many points moved.
+- (void)update:(const simd_float3 *_Nonnull)positions count:(uint32_t)count maxMovedFraction:(float)maxMovedFraction;
+
+- (uint32_t)movedPointCount;
+
+- (uint32_t)hashKeyFromPosition:(simd_float3)position;
+
+- (uint32_t)bucketStart:(uint32_t)key;
+
+- (uint32_t)bucketEnd:(uint32_t)key;
+
+/// Point indices grouped by bucket.
+- (void)getSortedIndices:(uint32_t *_Nonnull)indices;
+
+/// Number of neighbor entries of the last `buildNeighborLists:` call.
+- (uint32_t)buildNeighborLists:(float)radius;
+
+/// offsets holds pointCount + 1 entries, neighbors as many as returned by `buildNeighborLists:`.
+- (void)getNeighborLists:(uint32_t *_Nonnull)offsets :(uint32_t *_Nonnull)neighbors;
+
+@end
@@ -0,0 +1,74 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CPointHashGridSearcher.h"
+#include "PointHashGridSearcher.h"
+#include <memory>
+#include <vector>
+
+using namespace vox::flex;
+
+@implementation CPointHashGridSearcher {
+    std::unique_ptr<PointHashGridSearcher> _searcher;
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _neighbors;
+}
+
+- (instancetype)initWithResolution:(simd_uint3)resolution gridSpacing:(float)gridSpacing {
+    self = [super init];
+    if (self) {
+        _searcher = std::make_unique<PointHashGridSearcher>(resolution.x, resolution.y, resolution.z, gridSpacing);
+    }
+    return self;
+}
+
+- (CNeighborhoodMode)neighborhoodMode {
+    return static_cast<CNeighborhoodMode>(_searcher->neighborhoodMode());
+}
+
+- (void)setNeighborhoodMode:(CNeighborhoodMode)neighborhoodMode {
+    _searcher->setNeighborhoodMode(static_cast<PointHashGridSearcher::NeighborhoodMode>(neighborhoodMode));
+}
+
+- (void)build:(const simd_float3 *)positions count:(uint32_t)count {
+    _searcher->build(reinterpret_cast<const float3 *>(positions), count);
+}
+
+- (void)update:(const simd_float3 *)positions count:(uint32_t)count maxMovedFraction:(float)maxMovedFraction {
+    _searcher->update(reinterpret_cast<const float3 *>(positions), count, maxMovedFraction);
+}
+
+- (uint32_t)movedPointCount {
+    return static_cast<uint32_t>(_searcher->movedPointCount());
+}
+
+- (uint32_t)hashKeyFromPosition:(simd_float3)position {
+    return _searcher->hashUtils().getHashKeyFromPosition(float3(position.x, position.y, position.z));
+}
+
+- (uint32_t)bucketStart:(uint32_t)key {
+    return _searcher->bucketStart(key);
+}
+
+- (uint32_t)bucketEnd:(uint32_t)key {
+    return _searcher->bucketEnd(key);
+}
+
+- (void)getSortedIndices:(uint32_t *)indices {
+    std::copy(_searcher->sortedIndices().begin(), _searcher->sortedIndices().end(), indices);
+}
+
+- (uint32_t)buildNeighborLists:(float)radius {
+    _searcher->buildNeighborLists(radius, _offsets, _neighbors);
+    return static_cast<uint32_t>(_neighbors.size());
+}
+
+- (void)getNeighborLists:(uint32_t *)offsets :(uint32_t *)neighbors {
+    std::copy(_offsets.begin(), _offsets.end(), offsets);
+    std::copy(_neighbors.begin(), _neighbors.end(), neighbors);
+}
+
+@end
@@ -0,0 +1,261 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "PointHashGridSearcher.h"
+#include "../common/Parallel.h"
+
+#include <atomic>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kPointGrain = 1024;
+        constexpr size_t kBucketGrain = 4096;
+
+        uint32_t roundUpToPowerOfTwo(uint32_t v) {
+            v = std::max(v, 1u) - 1;
+            v |= v >> 1;
+            v |= v >> 2;
+            v |= v >> 4;
+            v |= v >> 8;
+            v |= v >> 16;
+            return v + 1;
+        }
+    } // namespace
+
+    // MARK: - HashUtils
+    PointHashGridSearcher::HashUtils::HashUtils(float gridSpacing, uint32_t resolutionX, uint32_t resolutionY,
+                                                uint32_t resolutionZ)
+        : _gridSpacing(gridSpacing),
+          _resolution{roundUpToPowerOfTwo(resolutionX), roundUpToPowerOfTwo(resolutionY),
+                      roundUpToPowerOfTwo(resolutionZ)} {}
+
+    void PointHashGridSearcher::HashUtils::getNearbyKeys(const float3 &position, uint32_t *nearbyKeys) const {
+        int4 originIndex = getBucketIndex(position), nearbyBucketIndices[8];
+
+        for (int i = 0; i < 8; i++) {
+            nearbyBucketIndices[i] = originIndex;
+        }
+
+        // for each axis, odd slots of the matching bit take the neighbor on the closer side.
+        for (int axis = 0; axis < 3; ++axis) {
+            int offset = (float(originIndex[axis]) + 0.5f) * _gridSpacing <= position[axis] ? 1 : -1;
+            for (int i = 0; i < 8; i++) {
+                if (i & (1 << axis)) {
+                    nearbyBucketIndices[i][axis] += offset;
+                }
+            }
+        }
+
+        for (int i = 0; i < 8; i++) {
+            nearbyKeys[i] = getHashKeyFromBucketIndex(nearbyBucketIndices[i]);
+        }
+    }
+
+    int4 PointHashGridSearcher::HashUtils::getBucketIndex(const float3 &position) const {
+        return {static_cast<int32_t>(std::floor(position.x / _gridSpacing)),
+                static_cast<int32_t>(std::floor(position.y / _gridSpacing)),
+                static_cast<int32_t>(std::floor(position.z / _gridSpacing)), 0};
+    }
+
+    uint32_t PointHashGridSearcher::HashUtils::getHashKeyFromBucketIndex(const int4 &bucketIndex) const {
+        // resolution is a power of two, so masking wraps negative indices as well.
+        uint32_t x = static_cast<uint32_t>(bucketIndex.x) & (_resolution[0] - 1);
+        uint32_t y = static_cast<uint32_t>(bucketIndex.y) & (_resolution[1] - 1);
+        uint32_t z = static_cast<uint32_t>(bucketIndex.z) & (_resolution[2] - 1);
+        return z * _resolution[1] * _resolution[0] + y * _resolution[0] + x;
+    }
+
+    uint32_t PointHashGridSearcher::HashUtils::getHashKeyFromPosition(const float3 &position) const {
+        return getHashKeyFromBucketIndex(getBucketIndex(position));
+    }
+
+    // MARK: - PointHashGridSearcher
+    PointHashGridSearcher::PointHashGridSearcher(uint32_t resolutionX, uint32_t resolutionY, uint32_t resolutionZ,
+                                                 float gridSpacing)
+        : _hashUtils(gridSpacing, resolutionX, resolutionY, resolutionZ) {
+        _bucketStarts.assign(_hashUtils.bucketCount() + 1, 0);
+    }
+
+    void PointHashGridSearcher::computeKeys(const float3 *positions, size_t count, std::vector<uint32_t> &keys) const {
+        keys.resize(count);
+        parallelFor(0, count, kPointGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                keys[i] = _hashUtils.getHashKeyFromPosition(positions[i]);
+            }
+        });
+    }
+
+    void PointHashGridSearcher::gatherPositions(const float3 *positions) {
+        _sortedPositions.resize(_sortedIndices.size());
+        parallelFor(0, _sortedIndices.size(), kPointGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _sortedPositions[i] = positions[_sortedIndices[i]];
+            }
+        });
+    }
+
+    void PointHashGridSearcher::build(const float3 *positions, size_t count) {
+        const uint32_t bucketCount = _hashUtils.bucketCount();
+        computeKeys(positions, count, _keys);
+        _movedCount = count;
+
+        // histogram
+        std::vector<std::atomic<uint32_t>> cursors(bucketCount);
+        parallelFor(0, count, kPointGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                cursors[_keys[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        parallelFor(0, bucketCount, kBucketGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                _bucketStarts[k] = cursors[k].load(std::memory_order_relaxed);
+            }
+        });
+        _bucketStarts[bucketCount] = parallelExclusiveScan(_bucketStarts.data(), _bucketStarts.data(), bucketCount);
+
+        // scatter
+        parallelFor(0, bucketCount, kBucketGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                cursors[k].store(_bucketStarts[k], std::memory_order_relaxed);
+            }
+        });
+        _sortedIndices.resize(count);
+        parallelFor(0, count, kPointGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                uint32_t slot = cursors[_keys[i]].fetch_add(1, std::memory_order_relaxed);
+                _sortedIndices[slot] = static_cast<uint32_t>(i);
+            }
+        });
+
+        // scattering is racy within a bucket; restore index order so results are deterministic.
+        parallelFor(0, bucketCount, kBucketGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                std::sort(_sortedIndices.begin() + _bucketStarts[k], _sortedIndices.begin() + _bucketStarts[k + 1]);
+            }
+        });
+
+        gatherPositions(positions);
+    }
+
+    void PointHashGridSearcher::update(const float3 *positions, size_t count, float maxMovedFraction) {
+        if (count != _keys.size()) {
+            build(positions, count);
+            return;
+        }
+
+        computeKeys(positions, count, _newKeys);
+
+        // compact the points that changed bucket, keeping them in index order.
+        const size_t chunkCount = (count + kPointGrain - 1) / kPointGrain;
+        std::vector<uint32_t> chunkOffsets(chunkCount + 1, 0);
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            uint32_t moved = 0;
+            for (size_t i = chunk * kPointGrain, end = std::min(count, i + kPointGrain); i < end; ++i) {
+                moved += _newKeys[i] != _keys[i];
+            }
+            chunkOffsets[chunk] = moved;
+        });
+        _movedCount = parallelExclusiveScan(chunkOffsets.data(), chunkOffsets.data(), chunkCount);
+
+        if (_movedCount > size_t(maxMovedFraction * float(count))) {
+            build(positions, count);
+            return;
+        }
+        if (_movedCount == 0) {
+            gatherPositions(positions);
+            return;
+        }
+
+        std::vector<uint32_t> movers(_movedCount);
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            uint32_t slot = chunkOffsets[chunk];
+            for (size_t i = chunk * kPointGrain, end = std::min(count, i + kPointGrain); i < end; ++i) {
+                if (_newKeys[i] != _keys[i]) {
+                    movers[slot++] = static_cast<uint32_t>(i);
+                }
+            }
+        });
+
+        // arrivals sorted by destination bucket, each bucket's arrivals in index order.
+        std::stable_sort(movers.begin(), movers.end(),
+                         [&](uint32_t a, uint32_t b) { return _newKeys[a] < _newKeys[b]; });
+
+        const uint32_t bucketCount = _hashUtils.bucketCount();
+        std::vector<uint32_t> oldStarts = _bucketStarts;
+        std::vector<int32_t> delta(bucketCount, 0);
+        for (uint32_t index : movers) {
+            --delta[_keys[index]];
+            ++delta[_newKeys[index]];
+        }
+        parallelFor(0, bucketCount, kBucketGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                _bucketStarts[k] = uint32_t(int32_t(oldStarts[k + 1] - oldStarts[k]) + delta[k]);
+            }
+        });
+        parallelExclusiveScan(_bucketStarts.data(), _bucketStarts.data(), bucketCount);
+        _bucketStarts[bucketCount] = static_cast<uint32_t>(count);
+
+        // merge the members that stayed with the arrivals, bucket by bucket.
+        _scratch.resize(count);
+        parallelFor(0, bucketCount, kBucketGrain, [&](size_t begin, size_t end) {
+            auto arrival = std::lower_bound(movers.begin(), movers.end(), uint32_t(begin),
+                                            [&](uint32_t index, uint32_t key) { return _newKeys[index] < key; });
+            for (size_t k = begin; k < end; ++k) {
+                uint32_t out = _bucketStarts[k];
+                uint32_t stay = oldStarts[k];
+                const uint32_t stayEnd = oldStarts[k + 1];
+                auto nextStayer = [&]() {
+                    while (stay < stayEnd && _newKeys[_sortedIndices[stay]] != k) {
+                        ++stay;
+                    }
+                };
+                nextStayer();
+                while (stay < stayEnd || (arrival != movers.end() && _newKeys[*arrival] == k)) {
+                    bool takeArrival = arrival != movers.end() && _newKeys[*arrival] == k &&
+                                       (stay >= stayEnd || *arrival < _sortedIndices[stay]);
+                    if (takeArrival) {
+                        _scratch[out++] = *arrival++;
+                    } else {
+                        _scratch[out++] = _sortedIndices[stay++];
+                        nextStayer();
+                    }
+                }
+            }
+        });
+        _sortedIndices.swap(_scratch);
+        _keys.swap(_newKeys);
+
+        gatherPositions(positions);
+    }
+
+    void PointHashGridSearcher::buildNeighborLists(float radius, std::vector<uint32_t> &offsets,
+                                                   std::vector<uint32_t> &neighbors) const {
+        const size_t count = _sortedIndices.size();
+        offsets.assign(count + 1, 0);
+        parallelFor(0, count, 256, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                uint32_t self = _sortedIndices[s];
+                uint32_t n = 0;
+                forEachNearbyPoint(_sortedPositions[s], radius, [&](uint32_t j, const float3 &) { n += j != self; });
+                offsets[self] = n;
+            }
+        });
+        offsets[count] = parallelExclusiveScan(offsets.data(), offsets.data(), count);
+
+        neighbors.resize(offsets[count]);
+        parallelFor(0, count, 256, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                uint32_t self = _sortedIndices[s];
+                uint32_t slot = offsets[self];
+                forEachNearbyPoint(_sortedPositions[s], radius, [&](uint32_t j, const float3 &) {
+                    if (j != self) {
+                        neighbors[slot++] = j;
+                    }
+                });
+            }
+        });
+    }
+} // namespace vox::flex
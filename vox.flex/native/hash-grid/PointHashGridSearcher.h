@@ -0,0 +1,209 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+#include <algorithm>
+#include <vector>
+
+namespace vox::flex {
+    // CPU counterpart of the Metal PointHashGridSearcher (flex.shader/hash-grid). Points are bucketed
+    // with the same HashUtils hashing, but the table is built with a parallel counting sort instead of
+    // a comparison sort, and stored CSR style: the points of bucket k are
+    // sortedIndices[bucketStart(k) ..< bucketEnd(k)], always in increasing point index order.
+    class PointHashGridSearcher {
+    public:
+        // Buckets visited by neighbor queries.
+        enum class NeighborhoodMode : uint32_t {
+            // the 8 buckets nearest to the query, radius must not exceed half the grid spacing (default).
+            Octant8,
+            // the 3x3x3 buckets around the query, radius must not exceed the grid spacing.
+            Cube27,
+            // every bucket overlapped by the query box, any radius.
+            Radius,
+        };
+
+        class HashUtils {
+        public:
+            HashUtils() = default;
+
+            // `resolution` components must be powers of two.
+            HashUtils(float gridSpacing, uint32_t resolutionX, uint32_t resolutionY, uint32_t resolutionZ);
+
+            void getNearbyKeys(const float3 &position, uint32_t *nearbyKeys) const;
+
+            int4 getBucketIndex(const float3 &position) const;
+
+            uint32_t getHashKeyFromBucketIndex(const int4 &bucketIndex) const;
+
+            uint32_t getHashKeyFromPosition(const float3 &position) const;
+
+            // Calls `callback(firstKey, lastKey)` for every run of consecutive keys covering the bucket
+            // box [lower, upper]. Buckets along x are contiguous keys, so each row is one or two runs
+            // (two when it wraps around the resolution); axes wider than the resolution are clamped.
+            template <typename Callback>
+            void forEachKeyRange(const int4 &lower, const int4 &upper, Callback &&callback) const;
+
+            uint32_t bucketCount() const { return _resolution[0] * _resolution[1] * _resolution[2]; }
+
+            uint32_t resolution(int axis) const { return _resolution[axis]; }
+
+            float gridSpacing() const { return _gridSpacing; }
+
+        private:
+            float _gridSpacing = 1;
+            uint32_t _resolution[3] = {1, 1, 1};
+        };
+
+        PointHashGridSearcher(uint32_t resolutionX, uint32_t resolutionY, uint32_t resolutionZ, float gridSpacing);
+
+        // Full rebuild from scratch.
+        void build(const float3 *positions, size_t count);
+
+        // Rebuild reusing the previous table. Points that stayed in their bucket keep their slot order and
+        // only the ones that changed bucket are re-inserted, which is much cheaper than `build` for
+        // mostly static point sets. The result is identical to a full build. Falls back to `build`
+        // when the point count changed or more than `maxMovedFraction` of the points moved.
+        void update(const float3 *positions, size_t count, float maxMovedFraction = 0.25f);
+
+        const HashUtils &hashUtils() const { return _hashUtils; }
+
+        NeighborhoodMode neighborhoodMode() const { return _neighborhoodMode; }
+
+        // Cube27 and Radius let the grid spacing equal the query radius, so fewer far points are tested.
+        void setNeighborhoodMode(NeighborhoodMode mode) { _neighborhoodMode = mode; }
+
+        size_t pointCount() const { return _keys.size(); }
+
+        // Number of points whose bucket changed during the last `update` (all of them after `build`).
+        size_t movedPointCount() const { return _movedCount; }
+
+        uint32_t bucketStart(uint32_t key) const { return _bucketStarts[key]; }
+
+        uint32_t bucketEnd(uint32_t key) const { return _bucketStarts[key + 1]; }
+
+        // Point indices grouped by bucket.
+        const std::vector<uint32_t> &sortedIndices() const { return _sortedIndices; }
+
+        // Point positions in bucket order, so neighbor loops stream through contiguous memory.
+        const std::vector<float3> &sortedPositions() const { return _sortedPositions; }
+
+        // Gathers any per-point attribute into bucket order: out[i] = in[sortedIndices[i]].
+        template <typename T>
+        void reorder(const T *in, T *out) const;
+
+        // Calls `callback(index, position)` for every point within `radius` of `origin`, visiting the
+        // buckets selected by the neighborhood mode.
+        template <typename Callback>
+        void forEachNearbyPoint(const float3 &origin, float radius, Callback &&callback) const;
+
+        // Builds CSR neighbor lists for every point: neighbors of point i are
+        // neighbors[offsets[i] ..< offsets[i + 1]] (the point itself excluded).
+        void buildNeighborLists(float radius, std::vector<uint32_t> &offsets, std::vector<uint32_t> &neighbors) const;
+
+    private:
+        void computeKeys(const float3 *positions, size_t count, std::vector<uint32_t> &keys) const;
+
+        void gatherPositions(const float3 *positions);
+
+        template <typename Callback>
+        void forEachPointInKeyRange(uint32_t firstKey, uint32_t lastKey, const float3 &origin,
+                                    float queryRadiusSquared, Callback &callback) const;
+
+        HashUtils _hashUtils;
+        NeighborhoodMode _neighborhoodMode = NeighborhoodMode::Octant8;
+        std::vector<uint32_t> _keys;
+        std::vector<uint32_t> _newKeys;
+        std::vector<uint32_t> _bucketStarts;
+        std::vector<uint32_t> _sortedIndices;
+        std::vector<float3> _sortedPositions;
+        std::vector<uint32_t> _scratch;
+        size_t _movedCount = 0;
+    };
+
+    template <typename T>
+    void PointHashGridSearcher::reorder(const T *in, T *out) const {
+        for (size_t i = 0; i < _sortedIndices.size(); ++i) {
+            out[i] = in[_sortedIndices[i]];
+        }
+    }
+
+    template <typename Callback>
+    void PointHashGridSearcher::HashUtils::forEachKeyRange(const int4 &lower, const int4 &upper,
+                                                           Callback &&callback) const {
+        int4 last = upper;
+        for (int axis = 0; axis < 3; ++axis) {
+            last[axis] = std::min(upper[axis], lower[axis] + int32_t(_resolution[axis]) - 1);
+        }
+
+        const uint32_t maskX = _resolution[0] - 1;
+        for (int32_t z = lower.z; z <= last.z; ++z) {
+            for (int32_t y = lower.y; y <= last.y; ++y) {
+                uint32_t rowKey = getHashKeyFromBucketIndex({0, y, z, 0});
+                uint32_t x0 = uint32_t(lower.x) & maskX;
+                uint32_t x1 = uint32_t(last.x) & maskX;
+                if (x0 <= x1) {
+                    callback(rowKey + x0, rowKey + x1);
+                } else {
+                    callback(rowKey + x0, rowKey + maskX);
+                    callback(rowKey, rowKey + x1);
+                }
+            }
+        }
+    }
+
+    template <typename Callback>
+    void PointHashGridSearcher::forEachPointInKeyRange(uint32_t firstKey, uint32_t lastKey, const float3 &origin,
+                                                       float queryRadiusSquared, Callback &callback) const {
+        // buckets are stored in key order, so a run of keys is one contiguous slice of points.
+        const uint32_t end = _bucketStarts[lastKey + 1];
+        for (uint32_t j = _bucketStarts[firstKey]; j < end; ++j) {
+            const float3 &p = _sortedPositions[j];
+            if (lengthSquared(p - origin) <= queryRadiusSquared) {
+                callback(_sortedIndices[j], p);
+            }
+        }
+    }
+
+    template <typename Callback>
+    void PointHashGridSearcher::forEachNearbyPoint(const float3 &origin, float radius, Callback &&callback) const {
+        if (_sortedIndices.empty()) {
+            return;
+        }
+
+        const float queryRadiusSquared = radius * radius;
+        switch (_neighborhoodMode) {
+            case NeighborhoodMode::Octant8: {
+                uint32_t nearbyKeys[8];
+                _hashUtils.getNearbyKeys(origin, nearbyKeys);
+                for (uint32_t nearbyKey : nearbyKeys) {
+                    forEachPointInKeyRange(nearbyKey, nearbyKey, origin, queryRadiusSquared, callback);
+                }
+                break;
+            }
+            case NeighborhoodMode::Cube27: {
+                int4 center = _hashUtils.getBucketIndex(origin);
+                _hashUtils.forEachKeyRange({center.x - 1, center.y - 1, center.z - 1, 0},
+                                           {center.x + 1, center.y + 1, center.z + 1, 0},
+                                           [&](uint32_t firstKey, uint32_t lastKey) {
+                                               forEachPointInKeyRange(firstKey, lastKey, origin,
+                                                                      queryRadiusSquared, callback);
+                                           });
+                break;
+            }
+            case NeighborhoodMode::Radius: {
+                _hashUtils.forEachKeyRange(_hashUtils.getBucketIndex(origin - float3(radius)),
+                                           _hashUtils.getBucketIndex(origin + float3(radius)),
+                                           [&](uint32_t firstKey, uint32_t lastKey) {
+                                               forEachPointInKeyRange(firstKey, lastKey, origin,
+                                                                      queryRadiusSquared, callback);
+                                           });
+                break;
+            }
+        }
+    }
+} // namespace vox::flex
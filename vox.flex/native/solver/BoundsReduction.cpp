@@ -0,0 +1,205 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "BoundsReduction.h"
+#include "../common/Parallel.h"
+#include "../common/QuaternionLanes.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kLanes = BoundsReduction::kLanes;
+        // lane groups per parallel chunk of the simplex bounds.
+        constexpr size_t kGroupGrain = 128;
+        constexpr float kMax = std::numeric_limits<float>::max();
+        constexpr float kLowest = std::numeric_limits<float>::lowest();
+        constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+        struct LaneBounds {
+            VectorLanes<kLanes> min;
+            VectorLanes<kLanes> max;
+
+            LaneBounds() {
+                std::fill(std::begin(min.x), std::end(min.x), kMax);
+                std::fill(std::begin(min.y), std::end(min.y), kMax);
+                std::fill(std::begin(min.z), std::end(min.z), kMax);
+                std::fill(std::begin(max.x), std::end(max.x), kLowest);
+                std::fill(std::begin(max.y), std::end(max.y), kLowest);
+                std::fill(std::begin(max.z), std::end(max.z), kLowest);
+            }
+
+            // merges the lanes into a single box.
+            Aabb reduce() const {
+                Aabb bounds;
+                for (size_t l = 0; l < kLanes; ++l) {
+                    bounds.encapsulateBounds(Aabb(float4(min.get(l), 0), float4(max.get(l), 0)));
+                }
+                return bounds;
+            }
+        };
+
+        // boxes of `count` simplices of `Size` particles each, laid out contiguously in `simplices`.
+        template <int Size>
+        void buildSimplexRun(const ParticleData &particles, const int32_t *simplices, size_t count, float margin,
+                             float sweepTime, Aabb *bounds) {
+            const float4 *positions = particles.positions.data();
+            const float4 *velocities = particles.velocities.data();
+            const float4 *radii = particles.principalRadii.data();
+            const size_t groupCount = (count + kLanes - 1) / kLanes;
+            parallelFor(0, groupCount, kGroupGrain, [&](size_t begin, size_t end) {
+                for (size_t group = begin; group < end; ++group) {
+                    const size_t base = group * kLanes;
+                    const size_t lanes = std::min(kLanes, count - base);
+
+                    LaneBounds box;
+                    for (int j = 0; j < Size; ++j) {
+                        // gather, padding the tail with the group's last simplex.
+                        VectorLanes<kLanes> start, swept;
+                        alignas(32) float radius[kLanes];
+                        for (size_t l = 0; l < kLanes; ++l) {
+                            const int32_t p = simplices[(base + std::min(l, lanes - 1)) * Size + j];
+                            const float4 &position = positions[p];
+                            const float4 &velocity = velocities[p];
+                            start.x[l] = position.x;
+                            start.y[l] = position.y;
+                            start.z[l] = position.z;
+                            swept.x[l] = position.x + velocity.x * sweepTime;
+                            swept.y[l] = position.y + velocity.y * sweepTime;
+                            swept.z[l] = position.z + velocity.z * sweepTime;
+                            radius[l] = radii[p].x + margin;
+                        }
+                        for (size_t l = 0; l < kLanes; ++l) {
+                            box.min.x[l] = std::min(box.min.x[l], std::min(start.x[l], swept.x[l]) - radius[l]);
+                            box.min.y[l] = std::min(box.min.y[l], std::min(start.y[l], swept.y[l]) - radius[l]);
+                            box.min.z[l] = std::min(box.min.z[l], std::min(start.z[l], swept.z[l]) - radius[l]);
+                            box.max.x[l] = std::max(box.max.x[l], std::max(start.x[l], swept.x[l]) + radius[l]);
+                            box.max.y[l] = std::max(box.max.y[l], std::max(start.y[l], swept.y[l]) + radius[l]);
+                            box.max.z[l] = std::max(box.max.z[l], std::max(start.z[l], swept.z[l]) + radius[l]);
+                        }
+                    }
+                    for (size_t l = 0; l < lanes; ++l) {
+                        bounds[base + l] = Aabb(float4(box.min.get(l), 0), float4(box.max.get(l), 0));
+                    }
+                }
+            });
+        }
+
+        // the awake box and count are only reduced when asked for, as they read the velocities too.
+        template <bool Awake>
+        SolverBounds reduceParticles(const ParticleData &particles, const int32_t *activeParticles, size_t count) {
+            constexpr size_t kBlockSize = BoundsReduction::kBlockSize;
+            const float4 *positions = particles.positions.data();
+            const float4 *velocities = particles.velocities.data();
+            const float4 *angularVelocities = particles.angularVelocities.data();
+            const float4 *radii = particles.principalRadii.data();
+
+            // first level: blocks of particles.
+            const size_t blockCount = (count + kBlockSize - 1) / kBlockSize;
+            std::vector<Aabb> blockBounds(blockCount);
+            std::vector<Aabb> blockAwakeBounds(Awake ? blockCount : 0);
+            std::vector<size_t> blockAwakeCounts(Awake ? blockCount : 0, 0);
+            parallelForEach(blockCount, 1, [&](size_t block) {
+                const size_t first = block * kBlockSize;
+                const size_t last = std::min(count, first + kBlockSize);
+                LaneBounds all, awake;
+                size_t awakeCount = 0;
+                for (size_t base = first; base < last; base += kLanes) {
+                    const size_t lanes = std::min(kLanes, last - base);
+
+                    // gather, padding the tail with the block's last particle.
+                    const int32_t *indices = activeParticles + base;
+                    alignas(32) int32_t tail[kLanes];
+                    if (lanes < kLanes) {
+                        for (size_t l = 0; l < kLanes; ++l) {
+                            tail[l] = indices[std::min(l, lanes - 1)];
+                        }
+                        indices = tail;
+                    }
+                    VectorLanes<kLanes> x;
+                    alignas(32) float radius[kLanes];
+                    alignas(32) float speed[kLanes];
+                    for (size_t l = 0; l < kLanes; ++l) {
+                        const int32_t i = indices[l];
+                        x.x[l] = positions[i].x;
+                        x.y[l] = positions[i].y;
+                        x.z[l] = positions[i].z;
+                        radius[l] = maxComponent(radii[i].xyz());
+                        if constexpr (Awake) {
+                            speed[l] = lengthSquared(velocities[i]) + lengthSquared(angularVelocities[i]);
+                        }
+                    }
+
+                    VectorLanes<kLanes> lower, upper;
+                    for (size_t l = 0; l < kLanes; ++l) {
+                        lower.x[l] = x.x[l] - radius[l];
+                        lower.y[l] = x.y[l] - radius[l];
+                        lower.z[l] = x.z[l] - radius[l];
+                        upper.x[l] = x.x[l] + radius[l];
+                        upper.y[l] = x.y[l] + radius[l];
+                        upper.z[l] = x.z[l] + radius[l];
+                        all.min.x[l] = std::min(all.min.x[l], lower.x[l]);
+                        all.min.y[l] = std::min(all.min.y[l], lower.y[l]);
+                        all.min.z[l] = std::min(all.min.z[l], lower.z[l]);
+                        all.max.x[l] = std::max(all.max.x[l], upper.x[l]);
+                        all.max.y[l] = std::max(all.max.y[l], upper.y[l]);
+                        all.max.z[l] = std::max(all.max.z[l], upper.z[l]);
+                    }
+                    if constexpr (Awake) {
+                        // sleeping particles are pushed out to infinity rather than branched over.
+                        for (size_t l = 0; l < kLanes; ++l) {
+                            const float hide = speed[l] > 0 ? 0.f : kInfinity;
+                            awake.min.x[l] = std::min(awake.min.x[l], lower.x[l] + hide);
+                            awake.min.y[l] = std::min(awake.min.y[l], lower.y[l] + hide);
+                            awake.min.z[l] = std::min(awake.min.z[l], lower.z[l] + hide);
+                            awake.max.x[l] = std::max(awake.max.x[l], upper.x[l] - hide);
+                            awake.max.y[l] = std::max(awake.max.y[l], upper.y[l] - hide);
+                            awake.max.z[l] = std::max(awake.max.z[l], upper.z[l] - hide);
+                        }
+                        for (size_t l = 0; l < lanes; ++l) {
+                            awakeCount += speed[l] > 0;
+                        }
+                    }
+                }
+                blockBounds[block] = all.reduce();
+                if constexpr (Awake) {
+                    blockAwakeBounds[block] = awake.reduce();
+                    blockAwakeCounts[block] = awakeCount;
+                }
+            });
+
+            // second level: blocks, in order.
+            SolverBounds result;
+            result.activeCount = count;
+            for (size_t block = 0; block < blockCount; ++block) {
+                result.bounds.encapsulateBounds(blockBounds[block]);
+                if constexpr (Awake) {
+                    result.awakeBounds.encapsulateBounds(blockAwakeBounds[block]);
+                    result.awakeCount += blockAwakeCounts[block];
+                }
+            }
+            return result;
+        }
+    } // namespace
+
+    SolverBounds BoundsReduction::reduceParticles(const ParticleData &particles, const int32_t *activeParticles,
+                                                  size_t count, bool awake) {
+        return awake ? vox::flex::reduceParticles<true>(particles, activeParticles, count)
+                     : vox::flex::reduceParticles<false>(particles, activeParticles, count);
+    }
+
+    void BoundsReduction::buildSimplexBounds(const ParticleData &particles, const int32_t *simplices,
+                                             const SimplexCounts &counts, float margin, float sweepTime,
+                                             Aabb *bounds) {
+        const size_t points = size_t(counts.pointCount);
+        const size_t edges = size_t(counts.edgeCount);
+        const size_t triangles = size_t(counts.triangleCount);
+        buildSimplexRun<1>(particles, simplices, points, margin, sweepTime, bounds);
+        buildSimplexRun<2>(particles, simplices + points, edges, margin, sweepTime, bounds + points);
+        buildSimplexRun<3>(particles, simplices + points + edges * 2, triangles, margin, sweepTime,
+                           bounds + points + edges);
+    }
+} // namespace vox::flex
@@ -0,0 +1,47 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "ParticleData.h"
+#include "SimplexCounts.h"
+#include "../common/Aabb.h"
+
+namespace vox::flex {
+    // Bounds of a solver's active particles, each grown by its largest principal radius, for culling on the
+    // engine side: `bounds` against the view frustum, `awakeBounds` / `awakeCount` to skip solvers at rest.
+    // A particle is awake while it has a velocity, sleeping ones are stopped by the solver.
+    struct SolverBounds {
+        Aabb bounds;
+        Aabb awakeBounds;
+        size_t activeCount = 0;
+        size_t awakeCount = 0;
+
+        bool empty() const { return activeCount == 0; }
+
+        bool asleep() const { return awakeCount == 0; }
+    };
+
+    // Bounds reductions of the solver, both laid out for SIMD: particles are gathered kLanes at a time into
+    // SoA lanes, and min / max run lane-wise. Lanes are padded by repeating a valid particle, so no lane needs
+    // masking.
+    //   particles: every block of kBlockSize active particles reduces to one box, blocks are merged in order,
+    //   simplices: points, edges and triangles are built as three runs of fixed size, so the loops over their
+    //              particles unroll, each box enclosing its particles at the start and at the end of the step.
+    struct BoundsReduction {
+        static constexpr size_t kLanes = 8;
+        static constexpr size_t kBlockSize = 4096;
+
+        // Leaves the awake bounds empty and the awake count at 0 unless `awake`.
+        static SolverBounds reduceParticles(const ParticleData &particles, const int32_t *activeParticles,
+                                            size_t count, bool awake = true);
+
+        // Bounds of every simplex, each particle grown by its radius plus `margin` and swept along its
+        // velocity over `sweepTime` (continuous collision detection). `bounds` holds simplexCount() boxes.
+        static void buildSimplexBounds(const ParticleData &particles, const int32_t *simplices,
+                                       const SimplexCounts &counts, float margin, float sweepTime, Aabb *bounds);
+    };
+} // namespace vox::flex
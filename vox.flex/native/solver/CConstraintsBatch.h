@@ -0,0 +1,25 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+/// A batch of constraints owned by a CSolverImpl. Concrete batch types create themselves in a solver
+/// and stay there until destroyed or released.
+@interface CConstraintsBatch : NSObject
+
+/// Oni.ConstraintType raw value.
+@property(nonatomic, readonly) uint32_t type;
+
+@property(nonatomic) bool enabled;
+
+- (uint32_t)constraintCount;
+
+/// Removes the batch from its solver, the object is inert afterwards.
+- (void)destroy;
+
+@end
@@ -0,0 +1,64 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CConstraintsBatchInternal.h"
+
+using namespace vox::flex;
+
+@implementation CConstraintsBatch {
+    CSolverImpl *_solver;
+    ConstraintType _type;
+    ConstraintsBatch *_batch;
+}
+
+- (instancetype)initWithSolver:(CSolverImpl *)solver type:(ConstraintType)type batch:(std::unique_ptr<ConstraintsBatch>)batch {
+    self = [super init];
+    if (self) {
+        _solver = solver;
+        _type = type;
+        _batch = [solver nativeSolver]->constraints(type).addBatch(std::move(batch));
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self destroy];
+}
+
+- (ConstraintsBatch *)nativeBatch {
+    return _batch;
+}
+
+- (CSolverImpl *)solver {
+    return _solver;
+}
+
+- (uint32_t)type {
+    return static_cast<uint32_t>(_type);
+}
+
+- (bool)enabled {
+    return _batch != nullptr && _batch->enabled;
+}
+
+- (void)setEnabled:(bool)enabled {
+    if (_batch != nullptr) {
+        _batch->enabled = enabled;
+    }
+}
+
+- (uint32_t)constraintCount {
+    return _batch != nullptr ? static_cast<uint32_t>(_batch->constraintCount()) : 0;
+}
+
+- (void)destroy {
+    if (_batch != nullptr) {
+        [_solver nativeSolver]->constraints(_type).removeBatch(_batch);
+        _batch = nullptr;
+    }
+}
+
+@end
@@ -0,0 +1,26 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "CConstraintsBatch.h"
+#import "CSolverImplInternal.h"
+#include <memory>
+
+/// Objective-C++ only, for the concrete batch types.
+@interface CConstraintsBatch ()
+
+/// Adds `batch` to the constraints of `type` in `solver`.
+- (instancetype _Nonnull)initWithSolver:(CSolverImpl *_Nonnull)solver
+                                   type:(vox::flex::ConstraintType)type
+                                  batch:(std::unique_ptr<vox::flex::ConstraintsBatch>)batch;
+
+/// Null once destroyed.
+- (vox::flex::ConstraintsBatch *_Nullable)nativeBatch;
+
+- (CSolverImpl *_Nonnull)solver;
+
+@end
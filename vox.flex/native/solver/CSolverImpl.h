@@ -0,0 +1,302 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+#import "../collisions/CColliderWorld.h"
+
+typedef NS_ENUM(uint32_t, CSolverMode) {
+    CSolverMode3D,
+    CSolverMode2D,
+};
+
+typedef NS_ENUM(uint32_t, CSolverInterpolation) {
+    CSolverInterpolationNone,
+    CSolverInterpolationInterpolate,
+    CSolverInterpolationExtrapolate,
+};
+
+typedef NS_ENUM(uint32_t, CConstraintEvaluationOrder) {
+    CConstraintEvaluationOrderSequential,
+    CConstraintEvaluationOrderParallel,
+};
+
+/// Contact between two simplices: barycentric coords of the contact point in each, the normal pointing
+/// from B towards A and the surface distance at detection time. For collider contacts B is the collider and
+/// pointB a solver space position on its surface.
+typedef struct {
+    simd_float4 pointA;
+    simd_float4 pointB;
+    simd_float4 normal;
+    float distance;
+    int32_t bodyA;
+    int32_t bodyB;
+} CParticleContact;
+
+typedef NS_ENUM(int32_t, CQueryType) {
+    CQueryTypeSphere,
+    CQueryTypeBox,
+    CQueryTypeRay,
+};
+
+/// Shape of a spatial query, see QueryShape: a sphere of radius size.x around center, a box of extents size
+/// around center, or a ray from center to size, grown by contactOffset. Simplices up to maxDistance away
+/// whose filter matches are reported.
+typedef struct {
+    simd_float4 center;
+    simd_float4 size;
+    CQueryType type;
+    float contactOffset;
+    float maxDistance;
+    int32_t filter;
+} CQueryShape;
+
+/// Simplex found by a spatial query, see QueryResult: barycentric coords of its point nearest to the shape,
+/// nearest point of the shape and the normal there in solver space, and their distance minus the simplex
+/// radius, negative when they overlap.
+typedef struct {
+    simd_float4 simplexBary;
+    simd_float4 queryPoint;
+    simd_float4 normal;
+    float distance;
+    int32_t simplexIndex;
+    int32_t queryIndex;
+} CQueryResult;
+
+/// World transform of solver space and its world space velocities and accelerations, see InertialFrame.
+typedef struct {
+    simd_float4 translation;
+    simd_float4 scale;
+    simd_quatf rotation;
+    simd_float4 velocity;
+    simd_float4 angularVelocity;
+    simd_float4 acceleration;
+    simd_float4 angularAcceleration;
+} CInertialFrame;
+
+/// Bounds of the active particles and of the awake ones, for frustum and sleep culling, see SolverBounds. A box
+/// with no particle in it has its lower corner above its upper one.
+typedef struct {
+    simd_float3 lower;
+    simd_float3 upper;
+    simd_float3 awakeLower;
+    simd_float3 awakeUpper;
+    uint32_t activeCount;
+    uint32_t awakeCount;
+} CSolverBounds;
+
+/// What a frame of the fixed step schedule simulated: whole steps taken, the time left for the renderables to
+/// cover and the time dropped because the frame hit `maxStepsPerFrame`.
+typedef struct {
+    int32_t steps;
+    float unsimulatedTime;
+    float droppedTime;
+} CFrameStatistics;
+
+/// Native PBD solver core behind BurstSolverImpl. Particle arrays are exposed as raw pointers so the
+/// Swift side can fill them in place; they stay valid until `particleCount` changes.
+@interface CSolverImpl : NSObject
+
+- (instancetype _Nonnull)init;
+
+/// Threads taking part in the solver's parallel loops, the calling one included.
++ (uint32_t)threadCount;
+
+/// Resizes every particle array, new particles are static until given an inverse mass.
+@property(nonatomic) uint32_t particleCount;
+
+- (simd_float4 *_Nonnull)positions;
+- (simd_float4 *_Nonnull)prevPositions;
+- (simd_float4 *_Nonnull)restPositions;
+- (simd_float4 *_Nonnull)renderablePositions;
+- (simd_float4 *_Nonnull)velocities;
+- (simd_float4 *_Nonnull)externalForces;
+/// air velocity around every particle, used by aerodynamic constraints and cleared by resetForces.
+- (simd_float4 *_Nonnull)wind;
+- (float *_Nonnull)invMasses;
+
+- (simd_quatf *_Nonnull)orientations;
+- (simd_quatf *_Nonnull)prevOrientations;
+- (simd_quatf *_Nonnull)restOrientations;
+- (simd_quatf *_Nonnull)renderableOrientations;
+- (simd_float4 *_Nonnull)angularVelocities;
+- (simd_float4 *_Nonnull)externalTorques;
+- (float *_Nonnull)invRotationalMasses;
+
+- (int32_t *_Nonnull)phases;
+/// category bit in the low 16 bits, mask of collided categories in the high 16 bits.
+- (int32_t *_Nonnull)filters;
+- (simd_float4 *_Nonnull)principalRadii;
+/// surface normal of one-sided particles.
+- (simd_float4 *_Nonnull)normals;
+- (float *_Nonnull)buoyancies;
+
+- (float *_Nonnull)smoothingRadii;
+- (float *_Nonnull)restDensities;
+- (float *_Nonnull)viscosities;
+- (float *_Nonnull)vortConfinement;
+- (float *_Nonnull)surfaceTension;
+- (float *_Nonnull)atmosphericDrag;
+- (float *_Nonnull)atmosphericPressure;
+- (float *_Nonnull)diffusion;
+/// density and density constraint multiplier per particle.
+- (simd_float4 *_Nonnull)fluidData;
+- (simd_float4 *_Nonnull)vorticities;
+/// values diffused between neighboring fluid particles at their `diffusion` rate.
+- (simd_float4 *_Nonnull)userData;
+/// three principal axes per particle: unit direction in xyz, radius along it in w.
+- (simd_float4 *_Nonnull)anisotropies;
+
+- (void)setActiveParticles:(const int32_t *_Nonnull)indices count:(uint32_t)count;
+
+- (uint32_t)activeParticleCount;
+
+/// Particle indices of every point, then every edge (2 each), then every triangle (3 each).
+- (void)setSimplices:(const int32_t *_Nonnull)indices
+          pointCount:(uint32_t)pointCount
+           edgeCount:(uint32_t)edgeCount
+       triangleCount:(uint32_t)triangleCount;
+
+- (uint32_t)simplexCount;
+
+/// Recomputes the simplex bounds for a step of `stepTime` seconds, as every collision detection does.
+- (void)calculateSimplexBounds:(float)stepTime;
+
+/// Copies the bounds of every simplex as of the last collision detection, lower and upper corner of each.
+- (void)getSimplexBounds:(simd_float4 *_Nonnull)bounds;
+
+/// Triangles of deformable surfaces, three particle indices each, colored into batches sharing no particle.
+- (void)setDeformableTriangles:(const int32_t *_Nullable)indices count:(uint32_t)count;
+
+- (uint32_t)deformableTriangleCount;
+
+/// Wind velocities on a resolution.x * resolution.y * resolution.z grid (x fastest) spanning [lower, upper] in solver
+/// space, sampled by aerodynamic constraints on top of the particles' wind. Copied.
+- (void)setWindField:(const simd_float4 *_Nonnull)samples
+          resolution:(simd_int3)resolution
+               lower:(simd_float3)lower
+               upper:(simd_float3)upper;
+
+- (void)clearWindField;
+
+// MARK: - Parameters
+@property(nonatomic) CSolverMode mode;
+@property(nonatomic) CSolverInterpolation interpolation;
+@property(nonatomic) simd_float3 gravity;
+@property(nonatomic) float damping;
+@property(nonatomic) float maxAnisotropy;
+@property(nonatomic) float sleepThreshold;
+@property(nonatomic) float collisionMargin;
+@property(nonatomic) float maxDepenetration;
+@property(nonatomic) float continuousCollisionDetection;
+@property(nonatomic) float shockPropagation;
+@property(nonatomic) int32_t surfaceCollisionIterations;
+@property(nonatomic) float surfaceCollisionTolerance;
+
+/// `type` is an Oni.ConstraintType raw value.
+- (void)setConstraintParameters:(uint32_t)type
+                        enabled:(bool)enabled
+                          order:(CConstraintEvaluationOrder)order
+                     iterations:(int32_t)iterations
+                      sorFactor:(float)sorFactor;
+
+- (uint32_t)constraintCount:(uint32_t)type;
+
+// MARK: - Simulation
+/// Finds the fluid interactions and simplex contacts of the coming step, call once per step before its substeps.
+- (void)collisionDetection:(float)stepTime;
+
+- (uint32_t)fluidInteractionCount;
+
+- (uint32_t)particleContactCount;
+
+/// Copies the contacts found by the last collision detection, `particleContactCount` of them.
+- (void)getParticleContacts:(CParticleContact *_Nonnull)contacts;
+
+/// Colliders the simplices collide with, kept alive by the solver. Update the world before collision detection.
+- (void)setColliderWorld:(CColliderWorld *_Nullable)world;
+
+- (uint32_t)colliderCandidateCount;
+
+/// Copies the (simplex, collider) pairs of intersecting bounds found by the last collision detection.
+- (void)getColliderCandidates:(simd_int2 *_Nonnull)candidates;
+
+- (uint32_t)colliderContactCount;
+
+/// Copies the simplex / collider contacts found by the last collision detection, `colliderContactCount` of them.
+- (void)getColliderContacts:(CParticleContact *_Nonnull)contacts;
+
+/// Collider contacts of the last collision detection per shape type, indexed by ColliderShape.ShapeType raw value.
+- (void)getColliderContactCountsByType:(uint32_t *_Nonnull)counts count:(uint32_t)count;
+
+// MARK: - Spatial queries
+/// Simplices near each of `count` shapes, against the grid of the last collision detection. `transforms` are
+/// the world transforms of the shapes, null for shapes in solver space. Writes up to `capacity` results,
+/// grouped by query chunk, and returns the number found, which may exceed `capacity`.
+- (uint32_t)spatialQuery:(const CQueryShape *_Nonnull)shapes
+              transforms:(const CAffineTransform *_Nullable)transforms
+                   count:(uint32_t)count
+                 results:(CQueryResult *_Nonnull)results
+                capacity:(uint32_t)capacity;
+
+- (void)substep:(float)stepTime substepTime:(float)substepTime substeps:(int32_t)substeps;
+
+/// Start arrays may be null, in which case renderables are a copy of the current state.
+- (void)applyInterpolationWithStartPositions:(const simd_float4 *_Nullable)startPositions
+                           startOrientations:(const simd_quatf *_Nullable)startOrientations
+                                    stepTime:(float)stepTime
+                             unsimulatedTime:(float)unsimulatedTime;
+
+- (void)resetForces;
+
+/// Returns false when no particle is active.
+- (bool)getBounds:(simd_float3 *_Nonnull)lower upper:(simd_float3 *_Nonnull)upper;
+
+- (CSolverBounds)bounds;
+
+- (uint64_t)substepCount;
+
+// MARK: - Inertial frame
+/// Places solver space in the world, at rest.
+- (void)initializeFrameWithTranslation:(simd_float4)translation scale:(simd_float4)scale rotation:(simd_quatf)rotation;
+
+/// Moves solver space to its new world transform, `deltaTime` seconds after the last one.
+- (void)updateFrameWithTranslation:(simd_float4)translation
+                             scale:(simd_float4)scale
+                          rotation:(simd_quatf)rotation
+                         deltaTime:(float)deltaTime;
+
+/// Makes the coming substeps apply the inertial forces of solver space's last motion, scaled: 1 simulates as if
+/// in world space, 0 drags the particles along. Call once per step after updating the frame.
+- (void)applyFrameWithLinearInertiaScale:(float)linearInertiaScale angularInertiaScale:(float)angularInertiaScale;
+
+- (CInertialFrame)inertialFrame;
+
+// MARK: - Fixed step schedule
+/// Step length, substeps per step and cap on steps per frame of `advance`, may change between frames.
+@property(nonatomic) float fixedStepTime;
+@property(nonatomic) int32_t fixedSubsteps;
+@property(nonatomic) int32_t maxStepsPerFrame;
+
+/// Accumulates `frameTime` seconds, takes as many fixed steps out of them as fit (collision detection and
+/// substeps each), then writes the renderables for the unsimulated remainder using the solver's interpolation.
+- (CFrameStatistics)advance:(float)frameTime;
+
+/// Forgets the accumulated time and the state at the start of the last step.
+- (void)resetSchedule;
+
+/// Time accumulated by `advance` but not simulated yet.
+- (float)accumulatedTime;
+
+- (CFrameStatistics)lastFrame;
+
+- (uint64_t)frameCount;
+
+- (uint64_t)stepCount;
+
+@end
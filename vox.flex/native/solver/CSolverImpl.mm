@@ -0,0 +1,581 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CSolverImplInternal.h"
+#import "../collisions/CColliderWorldInternal.h"
+#include "FixedStepScheduler.h"
+#include "../common/Parallel.h"
+#include <algorithm>
+#include <memory>
+
+using namespace vox::flex;
+
+static_assert(sizeof(CQueryShape) == sizeof(QueryShape), "CQueryShape must match QueryShape");
+static_assert(sizeof(CQueryResult) == sizeof(QueryResult), "CQueryResult must match QueryResult");
+
+namespace {
+    float3 toFloat3(simd_float3 v) { return {v.x, v.y, v.z}; }
+
+    simd_float3 toSimd(const float3 &v) { return simd_make_float3(v.x, v.y, v.z); }
+
+    simd_float4 toSimd(const float4 &v) { return simd_make_float4(v.x, v.y, v.z, v.w); }
+
+    simd_float4 *toSimd(AlignedVector<float4> &v) { return reinterpret_cast<simd_float4 *>(v.data()); }
+
+    simd_quatf *toSimd(AlignedVector<quaternion> &v) { return reinterpret_cast<simd_quatf *>(v.data()); }
+
+    void copyContacts(const std::vector<Contact> &source, CParticleContact *contacts) {
+        for (size_t i = 0; i < source.size(); ++i) {
+            const Contact &contact = source[i];
+            contacts[i].pointA = toSimd(contact.pointA);
+            contacts[i].pointB = toSimd(contact.pointB);
+            contacts[i].normal = toSimd(contact.normal);
+            contacts[i].distance = contact.distance;
+            contacts[i].bodyA = contact.bodyA;
+            contacts[i].bodyB = contact.bodyB;
+        }
+    }
+
+    float4 toFloat4(simd_float4 v) { return {v.x, v.y, v.z, v.w}; }
+
+    quaternion toQuaternion(simd_quatf q) { return {q.vector.x, q.vector.y, q.vector.z, q.vector.w}; }
+
+    simd_quatf toSimd(const quaternion &q) { return simd_quaternion(q.x, q.y, q.z, q.w); }
+
+    CFrameStatistics toFrameStatistics(const FrameStatistics &statistics) {
+        return {statistics.steps, statistics.unsimulatedTime, statistics.droppedTime};
+    }
+} // namespace
+
+@implementation CSolverImpl {
+    std::unique_ptr<SolverImpl> _solver;
+    FixedStepScheduler _scheduler;
+    CColliderWorld *_colliderWorld;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _solver = std::make_unique<SolverImpl>();
+    }
+    return self;
+}
+
++ (uint32_t)threadCount {
+    return static_cast<uint32_t>(ThreadPool::shared().concurrency());
+}
+
+- (SolverImpl *)nativeSolver {
+    return _solver.get();
+}
+
+// MARK: - Particles
+- (uint32_t)particleCount {
+    return static_cast<uint32_t>(_solver->particles().size());
+}
+
+- (void)setParticleCount:(uint32_t)particleCount {
+    _solver->setParticleCount(particleCount);
+}
+
+- (simd_float4 *)positions {
+    return toSimd(_solver->particles().positions);
+}
+
+- (simd_float4 *)prevPositions {
+    return toSimd(_solver->particles().prevPositions);
+}
+
+- (simd_float4 *)restPositions {
+    return toSimd(_solver->particles().restPositions);
+}
+
+- (simd_float4 *)renderablePositions {
+    return toSimd(_solver->particles().renderablePositions);
+}
+
+- (simd_float4 *)velocities {
+    return toSimd(_solver->particles().velocities);
+}
+
+- (simd_float4 *)externalForces {
+    return toSimd(_solver->particles().externalForces);
+}
+
+- (simd_float4 *)wind {
+    return toSimd(_solver->particles().wind);
+}
+
+- (float *)invMasses {
+    return _solver->particles().invMasses.data();
+}
+
+- (simd_quatf *)orientations {
+    return toSimd(_solver->particles().orientations);
+}
+
+- (simd_quatf *)prevOrientations {
+    return toSimd(_solver->particles().prevOrientations);
+}
+
+- (simd_quatf *)restOrientations {
+    return toSimd(_solver->particles().restOrientations);
+}
+
+- (simd_quatf *)renderableOrientations {
+    return toSimd(_solver->particles().renderableOrientations);
+}
+
+- (simd_float4 *)angularVelocities {
+    return toSimd(_solver->particles().angularVelocities);
+}
+
+- (simd_float4 *)externalTorques {
+    return toSimd(_solver->particles().externalTorques);
+}
+
+- (float *)invRotationalMasses {
+    return _solver->particles().invRotationalMasses.data();
+}
+
+- (int32_t *)phases {
+    return _solver->particles().phases.data();
+}
+
+- (int32_t *)filters {
+    return _solver->particles().filters.data();
+}
+
+- (simd_float4 *)principalRadii {
+    return toSimd(_solver->particles().principalRadii);
+}
+
+- (simd_float4 *)normals {
+    return toSimd(_solver->particles().normals);
+}
+
+- (float *)buoyancies {
+    return _solver->particles().buoyancies.data();
+}
+
+- (float *)smoothingRadii {
+    return _solver->particles().smoothingRadii.data();
+}
+
+- (float *)restDensities {
+    return _solver->particles().restDensities.data();
+}
+
+- (float *)viscosities {
+    return _solver->particles().viscosities.data();
+}
+
+- (float *)vortConfinement {
+    return _solver->particles().vortConfinement.data();
+}
+
+- (float *)surfaceTension {
+    return _solver->particles().surfaceTension.data();
+}
+
+- (float *)atmosphericDrag {
+    return _solver->particles().atmosphericDrag.data();
+}
+
+- (float *)atmosphericPressure {
+    return _solver->particles().atmosphericPressure.data();
+}
+
+- (float *)diffusion {
+    return _solver->particles().diffusion.data();
+}
+
+- (simd_float4 *)fluidData {
+    return toSimd(_solver->particles().fluidData);
+}
+
+- (simd_float4 *)vorticities {
+    return toSimd(_solver->particles().vorticities);
+}
+
+- (simd_float4 *)userData {
+    return toSimd(_solver->particles().userData);
+}
+
+- (simd_float4 *)anisotropies {
+    return toSimd(_solver->particles().anisotropies);
+}
+
+- (void)setActiveParticles:(const int32_t *)indices count:(uint32_t)count {
+    _solver->setActiveParticles(indices, count);
+}
+
+- (uint32_t)activeParticleCount {
+    return static_cast<uint32_t>(_solver->activeParticles().size());
+}
+
+- (void)setSimplices:(const int32_t *)indices
+          pointCount:(uint32_t)pointCount
+           edgeCount:(uint32_t)edgeCount
+       triangleCount:(uint32_t)triangleCount {
+    _solver->setSimplices(indices, {int32_t(pointCount), int32_t(edgeCount), int32_t(triangleCount)});
+}
+
+- (uint32_t)simplexCount {
+    return static_cast<uint32_t>(_solver->simplexCounts().simplexCount());
+}
+
+- (void)calculateSimplexBounds:(float)stepTime {
+    _solver->calculateSimplexBounds(stepTime);
+}
+
+- (void)getSimplexBounds:(simd_float4 *)bounds {
+    const std::vector<Aabb> &simplexBounds = _solver->simplexBounds();
+    std::copy(simplexBounds.begin(), simplexBounds.end(), reinterpret_cast<Aabb *>(bounds));
+}
+
+- (void)setDeformableTriangles:(const int32_t *)indices count:(uint32_t)count {
+    _solver->setDeformableTriangles(indices, indices != nullptr ? count : 0);
+}
+
+- (uint32_t)deformableTriangleCount {
+    return static_cast<uint32_t>(_solver->deformableTriangles().count());
+}
+
+- (void)setWindField:(const simd_float4 *)samples
+          resolution:(simd_int3)resolution
+               lower:(simd_float3)lower
+               upper:(simd_float3)upper {
+    _solver->windField().set(reinterpret_cast<const float4 *>(samples), resolution.x, resolution.y, resolution.z,
+                             toFloat3(lower), toFloat3(upper));
+}
+
+- (void)clearWindField {
+    _solver->windField().clear();
+}
+
+// MARK: - Parameters
+- (CSolverMode)mode {
+    return static_cast<CSolverMode>(_solver->parameters().mode);
+}
+
+- (void)setMode:(CSolverMode)mode {
+    SolverParameters parameters = _solver->parameters();
+    parameters.mode = static_cast<SolverParameters::Mode>(mode);
+    _solver->setParameters(parameters);
+}
+
+- (CSolverInterpolation)interpolation {
+    return static_cast<CSolverInterpolation>(_solver->parameters().interpolation);
+}
+
+- (void)setInterpolation:(CSolverInterpolation)interpolation {
+    SolverParameters parameters = _solver->parameters();
+    parameters.interpolation = static_cast<SolverParameters::Interpolation>(interpolation);
+    _solver->setParameters(parameters);
+}
+
+- (simd_float3)gravity {
+    return toSimd(_solver->parameters().gravity);
+}
+
+- (void)setGravity:(simd_float3)gravity {
+    SolverParameters parameters = _solver->parameters();
+    parameters.gravity = toFloat3(gravity);
+    _solver->setParameters(parameters);
+}
+
+- (float)damping {
+    return _solver->parameters().damping;
+}
+
+- (void)setDamping:(float)damping {
+    SolverParameters parameters = _solver->parameters();
+    parameters.damping = damping;
+    _solver->setParameters(parameters);
+}
+
+- (float)maxAnisotropy {
+    return _solver->parameters().maxAnisotropy;
+}
+
+- (void)setMaxAnisotropy:(float)maxAnisotropy {
+    SolverParameters parameters = _solver->parameters();
+    parameters.maxAnisotropy = maxAnisotropy;
+    _solver->setParameters(parameters);
+}
+
+- (float)sleepThreshold {
+    return _solver->parameters().sleepThreshold;
+}
+
+- (void)setSleepThreshold:(float)sleepThreshold {
+    SolverParameters parameters = _solver->parameters();
+    parameters.sleepThreshold = sleepThreshold;
+    _solver->setParameters(parameters);
+}
+
+- (float)collisionMargin {
+    return _solver->parameters().collisionMargin;
+}
+
+- (void)setCollisionMargin:(float)collisionMargin {
+    SolverParameters parameters = _solver->parameters();
+    parameters.collisionMargin = collisionMargin;
+    _solver->setParameters(parameters);
+}
+
+- (float)maxDepenetration {
+    return _solver->parameters().maxDepenetration;
+}
+
+- (void)setMaxDepenetration:(float)maxDepenetration {
+    SolverParameters parameters = _solver->parameters();
+    parameters.maxDepenetration = maxDepenetration;
+    _solver->setParameters(parameters);
+}
+
+- (float)continuousCollisionDetection {
+    return _solver->parameters().continuousCollisionDetection;
+}
+
+- (void)setContinuousCollisionDetection:(float)continuousCollisionDetection {
+    SolverParameters parameters = _solver->parameters();
+    parameters.continuousCollisionDetection = continuousCollisionDetection;
+    _solver->setParameters(parameters);
+}
+
+- (float)shockPropagation {
+    return _solver->parameters().shockPropagation;
+}
+
+- (void)setShockPropagation:(float)shockPropagation {
+    SolverParameters parameters = _solver->parameters();
+    parameters.shockPropagation = shockPropagation;
+    _solver->setParameters(parameters);
+}
+
+- (int32_t)surfaceCollisionIterations {
+    return _solver->parameters().surfaceCollisionIterations;
+}
+
+- (void)setSurfaceCollisionIterations:(int32_t)surfaceCollisionIterations {
+    SolverParameters parameters = _solver->parameters();
+    parameters.surfaceCollisionIterations = surfaceCollisionIterations;
+    _solver->setParameters(parameters);
+}
+
+- (float)surfaceCollisionTolerance {
+    return _solver->parameters().surfaceCollisionTolerance;
+}
+
+- (void)setSurfaceCollisionTolerance:(float)surfaceCollisionTolerance {
+    SolverParameters parameters = _solver->parameters();
+    parameters.surfaceCollisionTolerance = surfaceCollisionTolerance;
+    _solver->setParameters(parameters);
+}
+
+- (void)setConstraintParameters:(uint32_t)type
+                        enabled:(bool)enabled
+                          order:(CConstraintEvaluationOrder)order
+                     iterations:(int32_t)iterations
+                      sorFactor:(float)sorFactor {
+    if (type >= kConstraintTypeCount) {
+        return;
+    }
+    ConstraintParameters parameters;
+    parameters.enabled = enabled;
+    parameters.evaluationOrder = static_cast<ConstraintParameters::EvaluationOrder>(order);
+    parameters.iterations = std::max(iterations, 0);
+    parameters.SORFactor = sorFactor;
+    _solver->setConstraintParameters(static_cast<ConstraintType>(type), parameters);
+}
+
+- (uint32_t)constraintCount:(uint32_t)type {
+    if (type >= kConstraintTypeCount) {
+        return 0;
+    }
+    return static_cast<uint32_t>(_solver->constraintCount(static_cast<ConstraintType>(type)));
+}
+
+// MARK: - Simulation
+- (void)collisionDetection:(float)stepTime {
+    _solver->collisionDetection(stepTime);
+}
+
+- (uint32_t)fluidInteractionCount {
+    return static_cast<uint32_t>(_solver->densityConstraints().interactionCount());
+}
+
+- (uint32_t)particleContactCount {
+    return static_cast<uint32_t>(_solver->particleContacts().size());
+}
+
+- (void)getParticleContacts:(CParticleContact *)contacts {
+    copyContacts(_solver->particleContacts(), contacts);
+}
+
+- (void)setColliderWorld:(CColliderWorld *)world {
+    _colliderWorld = world;
+    _solver->setColliderWorld(world != nil ? [world nativeWorld] : nullptr);
+}
+
+- (uint32_t)colliderCandidateCount {
+    return static_cast<uint32_t>(_solver->colliderCandidates().size());
+}
+
+- (void)getColliderCandidates:(simd_int2 *)candidates {
+    const auto &colliderCandidates = _solver->colliderCandidates();
+    for (size_t i = 0; i < colliderCandidates.size(); ++i) {
+        candidates[i] = simd_make_int2(colliderCandidates[i].simplex, colliderCandidates[i].collider);
+    }
+}
+
+- (uint32_t)colliderContactCount {
+    return static_cast<uint32_t>(_solver->colliderContacts().size());
+}
+
+- (void)getColliderContacts:(CParticleContact *)contacts {
+    copyContacts(_solver->colliderContacts(), contacts);
+}
+
+- (void)getColliderContactCountsByType:(uint32_t *)counts count:(uint32_t)count {
+    const auto &countsByType = _solver->colliderContactGenerator().contactCountsByType();
+    for (uint32_t i = 0; i < count; ++i) {
+        counts[i] = i < countsByType.size() ? countsByType[i] : 0;
+    }
+}
+
+// MARK: - Spatial queries
+- (uint32_t)spatialQuery:(const CQueryShape *)shapes
+              transforms:(const CAffineTransform *)transforms
+                   count:(uint32_t)count
+                 results:(CQueryResult *)results
+                capacity:(uint32_t)capacity {
+    const size_t found = _solver->spatialQuery(
+        reinterpret_cast<const QueryShape *>(shapes), reinterpret_cast<const AffineTransform *>(transforms), count,
+        reinterpret_cast<QueryResult *>(results), capacity);
+    return static_cast<uint32_t>(found);
+}
+
+- (void)substep:(float)stepTime substepTime:(float)substepTime substeps:(int32_t)substeps {
+    _solver->substep(stepTime, substepTime, substeps);
+}
+
+- (void)applyInterpolationWithStartPositions:(const simd_float4 *)startPositions
+                           startOrientations:(const simd_quatf *)startOrientations
+                                    stepTime:(float)stepTime
+                             unsimulatedTime:(float)unsimulatedTime {
+    _solver->applyInterpolation(reinterpret_cast<const float4 *>(startPositions),
+                                reinterpret_cast<const quaternion *>(startOrientations), stepTime,
+                                unsimulatedTime);
+}
+
+- (void)resetForces {
+    _solver->resetForces();
+}
+
+- (bool)getBounds:(simd_float3 *)lower upper:(simd_float3 *)upper {
+    float3 l, u;
+    if (!_solver->getBounds(l, u)) {
+        return false;
+    }
+    *lower = toSimd(l);
+    *upper = toSimd(u);
+    return true;
+}
+
+- (CSolverBounds)bounds {
+    const SolverBounds bounds = _solver->bounds();
+    return {toSimd(bounds.bounds.min.xyz()),
+            toSimd(bounds.bounds.max.xyz()),
+            toSimd(bounds.awakeBounds.min.xyz()),
+            toSimd(bounds.awakeBounds.max.xyz()),
+            static_cast<uint32_t>(bounds.activeCount),
+            static_cast<uint32_t>(bounds.awakeCount)};
+}
+
+- (uint64_t)substepCount {
+    return _solver->substepCount();
+}
+
+// MARK: - Inertial frame
+- (void)initializeFrameWithTranslation:(simd_float4)translation scale:(simd_float4)scale rotation:(simd_quatf)rotation {
+    AffineTransform frame;
+    frame.translation = float4(toFloat4(translation).xyz(), 0);
+    frame.scale = float4(toFloat4(scale).xyz(), 1);
+    frame.rotation = toQuaternion(rotation);
+    _solver->setFrame(frame);
+}
+
+- (void)updateFrameWithTranslation:(simd_float4)translation
+                             scale:(simd_float4)scale
+                          rotation:(simd_quatf)rotation
+                         deltaTime:(float)deltaTime {
+    _solver->updateFrame(toFloat4(translation), toFloat4(scale), toQuaternion(rotation), deltaTime);
+}
+
+- (void)applyFrameWithLinearInertiaScale:(float)linearInertiaScale angularInertiaScale:(float)angularInertiaScale {
+    _solver->applyFrame(linearInertiaScale, angularInertiaScale);
+}
+
+- (CInertialFrame)inertialFrame {
+    const InertialFrame &frame = _solver->inertialFrame();
+    return {toSimd(frame.frame.translation), toSimd(frame.frame.scale), toSimd(frame.frame.rotation),
+            toSimd(frame.velocity), toSimd(frame.angularVelocity), toSimd(frame.acceleration),
+            toSimd(frame.angularAcceleration)};
+}
+
+// MARK: - Fixed step schedule
+- (float)fixedStepTime {
+    return _scheduler.stepTime;
+}
+
+- (void)setFixedStepTime:(float)fixedStepTime {
+    _scheduler.stepTime = fixedStepTime;
+}
+
+- (int32_t)fixedSubsteps {
+    return _scheduler.substeps;
+}
+
+- (void)setFixedSubsteps:(int32_t)fixedSubsteps {
+    _scheduler.substeps = fixedSubsteps;
+}
+
+- (int32_t)maxStepsPerFrame {
+    return _scheduler.maxStepsPerFrame;
+}
+
+- (void)setMaxStepsPerFrame:(int32_t)maxStepsPerFrame {
+    _scheduler.maxStepsPerFrame = maxStepsPerFrame;
+}
+
+- (CFrameStatistics)advance:(float)frameTime {
+    return toFrameStatistics(_scheduler.advance(*_solver, frameTime));
+}
+
+- (void)resetSchedule {
+    _scheduler.reset();
+}
+
+- (float)accumulatedTime {
+    return _scheduler.accumulatedTime();
+}
+
+- (CFrameStatistics)lastFrame {
+    return toFrameStatistics(_scheduler.lastFrame());
+}
+
+- (uint64_t)frameCount {
+    return _scheduler.frameCount();
+}
+
+- (uint64_t)stepCount {
+    return _scheduler.stepCount();
+}
+
+@end
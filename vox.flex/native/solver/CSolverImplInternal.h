@@ -0,0 +1,17 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import "CSolverImpl.h"
+#include "SolverImpl.h"
+
+/// Native access for the other facades of the solver, Objective-C++ only.
+@interface CSolverImpl ()
+
+- (vox::flex::SolverImpl *_Nonnull)nativeSolver;
+
+@end
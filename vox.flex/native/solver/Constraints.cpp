@@ -0,0 +1,102 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "Constraints.h"
+#include "../common/Parallel.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 512;
+    } // namespace
+
+    // MARK: - ConstraintsBatch
+    void ConstraintsBatch::applyPositionDeltas(ParticleData &particles, const int32_t *particleIndices,
+                                               size_t count, float sorFactor) {
+        parallelFor(0, count, kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t i = particleIndices[k];
+                if (particles.positionConstraintCounts[i] > 0) {
+                    particles.positions[i] +=
+                        particles.positionDeltas[i] * (sorFactor / float(particles.positionConstraintCounts[i]));
+                    particles.positionDeltas[i] = float4();
+                    particles.positionConstraintCounts[i] = 0;
+                }
+            }
+        });
+    }
+
+    void ConstraintsBatch::applyOrientationDeltas(ParticleData &particles, const int32_t *particleIndices,
+                                                  size_t count, float sorFactor) {
+        parallelFor(0, count, kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t i = particleIndices[k];
+                if (particles.orientationConstraintCounts[i] > 0) {
+                    quaternion delta = particles.orientationDeltas[i] *
+                                       (sorFactor / float(particles.orientationConstraintCounts[i]));
+                    particles.orientations[i] = normalize(particles.orientations[i] + delta);
+                    particles.orientationDeltas[i] = quaternion(0, 0, 0, 0);
+                    particles.orientationConstraintCounts[i] = 0;
+                }
+            }
+        });
+    }
+
+    // MARK: - Constraints
+    ConstraintsBatch *Constraints::addBatch(std::unique_ptr<ConstraintsBatch> batch) {
+        _batches.push_back(std::move(batch));
+        return _batches.back().get();
+    }
+
+    void Constraints::removeBatch(const ConstraintsBatch *batch) {
+        _batches.erase(std::remove_if(_batches.begin(), _batches.end(),
+                                      [&](const std::unique_ptr<ConstraintsBatch> &b) { return b.get() == batch; }),
+                       _batches.end());
+    }
+
+    size_t Constraints::constraintCount() const {
+        size_t count = 0;
+        for (const auto &batch : _batches) {
+            count += batch->constraintCount();
+        }
+        return count;
+    }
+
+    void Constraints::initialize(ParticleData &particles, float substepTime) {
+        for (auto &batch : _batches) {
+            if (batch->enabled) {
+                batch->initialize(particles, substepTime);
+            }
+        }
+    }
+
+    void Constraints::project(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                              float substepTime, int substeps) {
+        switch (parameters.evaluationOrder) {
+            case ConstraintParameters::EvaluationOrder::Sequential:
+                for (auto &batch : _batches) {
+                    if (batch->enabled) {
+                        batch->evaluate(particles, parameters, stepTime, substepTime, substeps);
+                        batch->apply(particles, parameters, substepTime);
+                    }
+                }
+                break;
+            case ConstraintParameters::EvaluationOrder::Parallel:
+                for (auto &batch : _batches) {
+                    if (batch->enabled) {
+                        batch->evaluate(particles, parameters, stepTime, substepTime, substeps);
+                    }
+                }
+                for (auto &batch : _batches) {
+                    if (batch->enabled) {
+                        batch->apply(particles, parameters, substepTime);
+                    }
+                }
+                break;
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,74 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "ParticleData.h"
+#include "SolverParameters.h"
+#include <memory>
+#include <vector>
+
+namespace vox::flex {
+    // A set of constraints of one type that share no particle, so all of them can be evaluated in
+    // parallel without synchronization. Batches accumulate their corrections into the particle deltas
+    // and constraint counts during `evaluate`, and write them to positions / orientations in `apply`.
+    class ConstraintsBatch {
+    public:
+        virtual ~ConstraintsBatch() = default;
+
+        bool enabled = true;
+
+        virtual size_t constraintCount() const = 0;
+
+        // Called once per substep before the first iteration, e.g. to reset XPBD multipliers.
+        virtual void initialize(ParticleData &, float) {}
+
+        virtual void evaluate(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                              float substepTime, int substeps) = 0;
+
+        virtual void apply(ParticleData &particles, const ConstraintParameters &parameters, float substepTime) = 0;
+
+    protected:
+        // Adds the averaged deltas of `particleIndices` (no duplicates) to the positions, scaled by
+        // `sorFactor`, and clears them for the next evaluation.
+        static void applyPositionDeltas(ParticleData &particles, const int32_t *particleIndices, size_t count,
+                                        float sorFactor);
+
+        static void applyOrientationDeltas(ParticleData &particles, const int32_t *particleIndices, size_t count,
+                                           float sorFactor);
+    };
+
+    // All batches of one constraint type.
+    class Constraints {
+    public:
+        explicit Constraints(ConstraintType type) : _type(type) {}
+
+        ConstraintType type() const { return _type; }
+
+        ConstraintsBatch *addBatch(std::unique_ptr<ConstraintsBatch> batch);
+
+        void removeBatch(const ConstraintsBatch *batch);
+
+        size_t batchCount() const { return _batches.size(); }
+
+        ConstraintsBatch &batch(size_t index) { return *_batches[index]; }
+
+        size_t constraintCount() const;
+
+        void initialize(ParticleData &particles, float substepTime);
+
+        // Sequential order applies each batch right after evaluating it, so later batches see its
+        // corrections (Gauss-Seidel across batches). Parallel order evaluates every batch against the
+        // same positions and averages all corrections at the end (Jacobi), which is more stable but
+        // converges slower.
+        void project(ParticleData &particles, const ConstraintParameters &parameters, float stepTime,
+                     float substepTime, int substeps);
+
+    private:
+        ConstraintType _type;
+        std::vector<std::unique_ptr<ConstraintsBatch>> _batches;
+    };
+} // namespace vox::flex
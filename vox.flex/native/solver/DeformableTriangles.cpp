@@ -0,0 +1,41 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "DeformableTriangles.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        struct TriangleProvider {
+            const int32_t *indices;
+            size_t count;
+
+            size_t constraintCount() const { return count; }
+
+            uint32_t particleCount(size_t) const { return 3; }
+
+            int32_t particle(size_t triangle, uint32_t index) const { return indices[triangle * 3 + index]; }
+        };
+
+        // cloth meshes color well within one round of batches, the second one only catches irregular fans.
+        constexpr uint32_t kColoringRounds = 2;
+    } // namespace
+
+    void DeformableTriangles::set(const int32_t *indices, size_t count, size_t particleCount) {
+        _indices.assign(indices, indices + count * 3);
+        _sortedIndices.clear();
+        _batches.clear();
+        if (count > 0) {
+            // triangles may be set before the particles they refer to.
+            particleCount = std::max(particleCount, size_t(*std::max_element(_indices.begin(), _indices.end())) + 1);
+            ConstraintBatcher batcher;
+            batcher.batchConstraints(TriangleProvider{_indices.data(), count}, particleCount, sizeof(int32_t) * 3,
+                                     _sortedIndices, _batches, kColoringRounds);
+        }
+        ++_version;
+    }
+} // namespace vox::flex
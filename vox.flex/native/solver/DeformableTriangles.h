@@ -0,0 +1,38 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../data-structures/constraint-batcher/ConstraintBatcher.h"
+#include <vector>
+
+namespace vox::flex {
+    // Triangles of the solver's deformable surfaces (cloth), three particle indices each. They are colored
+    // once when set into batches sharing no particle, so per-triangle stages scatter to their particles from
+    // many threads without atomics: batch by batch, every triangle of a batch in parallel.
+    class DeformableTriangles {
+    public:
+        void set(const int32_t *indices, size_t count, size_t particleCount);
+
+        size_t count() const { return _indices.size() / 3; }
+
+        const std::vector<int32_t> &indices() const { return _indices; }
+
+        // Triangle index of every batch slot, see BatchData.
+        const std::vector<uint32_t> &sortedIndices() const { return _sortedIndices; }
+
+        const std::vector<BatchData> &batches() const { return _batches; }
+
+        // Bumped by every set, for users caching data derived from the triangles.
+        uint64_t version() const { return _version; }
+
+    private:
+        std::vector<int32_t> _indices;
+        std::vector<uint32_t> _sortedIndices;
+        std::vector<BatchData> _batches;
+        uint64_t _version = 0;
+    };
+} // namespace vox::flex
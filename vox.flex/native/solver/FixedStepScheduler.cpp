@@ -0,0 +1,75 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "FixedStepScheduler.h"
+#include "../common/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 512;
+        // accumulated time this close to a whole step still takes it, so frames at exactly the step rate
+        // don't alternate between zero and two steps because of rounding.
+        constexpr float kStepTolerance = 1e-4f;
+    } // namespace
+
+    const FrameStatistics &FixedStepScheduler::advance(SolverImpl &solver, float frameTime) {
+        _lastFrame = FrameStatistics();
+        _accumulatedTime += std::max(frameTime, 0.f);
+        if (stepTime > 0) {
+            while (_accumulatedTime >= stepTime * (1 - kStepTolerance) && _lastFrame.steps < maxStepsPerFrame) {
+                step(solver);
+                _accumulatedTime = std::max(_accumulatedTime - stepTime, 0.f);
+                ++_lastFrame.steps;
+            }
+            // whatever whole steps are left over are dropped.
+            if (_accumulatedTime >= stepTime) {
+                _lastFrame.droppedTime = std::floor(_accumulatedTime / stepTime) * stepTime;
+                _accumulatedTime -= _lastFrame.droppedTime;
+            }
+        }
+        _lastFrame.unsimulatedTime = _accumulatedTime;
+        _stepCount += size_t(_lastFrame.steps);
+        ++_frameCount;
+
+        // before the first step there's nothing to interpolate from.
+        const bool started = _startPositions.size() == solver.particles().positions.size();
+        solver.applyInterpolation(started ? _startPositions.data() : nullptr,
+                                  started ? _startOrientations.data() : nullptr, _lastStepTime,
+                                  _lastFrame.unsimulatedTime);
+        return _lastFrame;
+    }
+
+    void FixedStepScheduler::reset() {
+        _accumulatedTime = 0;
+        _lastStepTime = 0;
+        _startPositions.clear();
+        _startOrientations.clear();
+    }
+
+    void FixedStepScheduler::step(SolverImpl &solver) {
+        const ParticleData &p = solver.particles();
+        const AlignedVector<int32_t> &active = solver.activeParticles();
+        _startPositions.resize(p.positions.size());
+        _startOrientations.resize(p.orientations.size());
+        parallelFor(0, active.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t i = active[k];
+                _startPositions[i] = p.positions[i];
+                _startOrientations[i] = p.orientations[i];
+            }
+        });
+
+        const int32_t count = std::max(substeps, 1);
+        solver.collisionDetection(stepTime);
+        for (int32_t i = 0; i < count; ++i) {
+            solver.substep(stepTime, stepTime / float(count), count);
+        }
+        _lastStepTime = stepTime;
+    }
+} // namespace vox::flex
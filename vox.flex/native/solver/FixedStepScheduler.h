@@ -0,0 +1,64 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "SolverImpl.h"
+
+namespace vox::flex {
+    // What a frame simulated, see FixedStepScheduler::advance.
+    struct FrameStatistics {
+        // whole steps taken.
+        int32_t steps = 0;
+        // time accumulated but not simulated yet, covered by interpolation or extrapolation.
+        float unsimulatedTime = 0;
+        // time thrown away because the frame hit maxStepsPerFrame.
+        float droppedTime = 0;
+    };
+
+    // Runs a solver on a fixed step schedule decoupled from the frame rate: every frame adds its duration to
+    // an accumulator, whole steps of `stepTime` seconds are taken out of it, each a collision detection and
+    // `substeps` substeps, and the renderables are written for the remainder. The step time and substeps may
+    // change between frames, e.g. to lower the solver frequency under load, the renderables hide the
+    // difference.
+    //
+    // The state at the start of the last step is kept for SolverParameters::Interpolation::Interpolate, which
+    // renders one step behind the simulation. Extrapolate renders ahead of it instead.
+    class FixedStepScheduler {
+    public:
+        float stepTime = 1.f / 60;
+        int32_t substeps = 4;
+        // once a frame takes this many steps the rest of its time is dropped, so a slow frame doesn't make
+        // the next ones slower still.
+        int32_t maxStepsPerFrame = 3;
+
+        // Simulates `frameTime` more seconds and writes the renderables.
+        const FrameStatistics &advance(SolverImpl &solver, float frameTime);
+
+        // Forgets the accumulated time and the start of the last step, e.g. after teleporting the particles.
+        void reset();
+
+        float accumulatedTime() const { return _accumulatedTime; }
+
+        const FrameStatistics &lastFrame() const { return _lastFrame; }
+
+        uint64_t frameCount() const { return _frameCount; }
+
+        uint64_t stepCount() const { return _stepCount; }
+
+    private:
+        void step(SolverImpl &solver);
+
+        float _accumulatedTime = 0;
+        // duration of the last step, the one interpolation blends over.
+        float _lastStepTime = 0;
+        AlignedVector<float4> _startPositions;
+        AlignedVector<quaternion> _startOrientations;
+        FrameStatistics _lastFrame;
+        uint64_t _frameCount = 0;
+        uint64_t _stepCount = 0;
+    };
+} // namespace vox::flex
@@ -0,0 +1,40 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "InertialFrame.h"
+#include "Integration.h"
+
+namespace vox::flex {
+    void InertialFrame::update(const float4 &position, const float4 &scale, const quaternion &rotation, float dt) {
+        prevFrame = frame;
+        const float4 prevVelocity = velocity;
+        const float4 prevAngularVelocity = angularVelocity;
+
+        frame.translation = float4(position.xyz(), 0);
+        frame.scale = float4(scale.xyz(), 1);
+        frame.rotation = rotation;
+        if (dt > 0) {
+            velocity = differentiateLinear(frame.translation, prevFrame.translation, dt);
+            angularVelocity = differentiateAngular(frame.rotation, prevFrame.rotation, dt);
+            acceleration = differentiateLinear(velocity, prevVelocity, dt);
+            angularAcceleration = differentiateLinear(angularVelocity, prevAngularVelocity, dt);
+        }
+    }
+
+    InertialForces InertialForces::of(const InertialFrame &frame, float linearInertiaScale,
+                                      float angularInertiaScale) {
+        // world space vectors into solver space: linear ones are scaled along with positions, angular ones
+        // (exact for uniform scales) only rotated.
+        const quaternion inverse = conjugate(frame.frame.rotation);
+        const float3 scale = frame.frame.scale.xyz();
+        InertialForces forces;
+        forces.linear = rotate(inverse, frame.acceleration.xyz()) / scale * linearInertiaScale;
+        forces.angularVelocity = rotate(inverse, frame.angularVelocity.xyz());
+        forces.euler = rotate(inverse, frame.angularAcceleration.xyz());
+        forces.angularScale = angularInertiaScale;
+        return forces;
+    }
+} // namespace vox::flex
@@ -0,0 +1,50 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../collisions/ColliderShape.h"
+
+namespace vox::flex {
+    // Motion of a solver's space in the world, the native counterpart of BurstInertialFrame. Particles are
+    // simulated in solver space, which follows the solver's owner: instead of moving every particle along with
+    // a fast character, the solver applies the fictitious forces of its space's motion, scaled down at will.
+    // Velocities and accelerations are in world space, differentiated from the frames passed to `update`.
+    struct InertialFrame {
+        AffineTransform frame;
+        AffineTransform prevFrame;
+
+        float4 velocity;
+        float4 angularVelocity;
+
+        float4 acceleration;
+        float4 angularAcceleration;
+
+        InertialFrame() = default;
+
+        explicit InertialFrame(const AffineTransform &transform) : frame(transform), prevFrame(transform) {}
+
+        // Moves the frame to its new world transform `dt` seconds after the last one.
+        void update(const float4 &position, const float4 &scale, const quaternion &rotation, float dt);
+    };
+
+    // Motion of solver space expressed in it. A particle at x moving at v feels the acceleration
+    //   -(linear + angularScale (euler x x + 2 angularVelocity x v + angularVelocity x (angularVelocity x x))),
+    // the linear acceleration being scaled already.
+    struct InertialForces {
+        float3 linear;
+        float3 angularVelocity;
+        float3 euler;
+        float angularScale = 0;
+
+        bool empty() const {
+            return lengthSquared(linear) == 0 &&
+                   (angularScale == 0 || (lengthSquared(angularVelocity) == 0 && lengthSquared(euler) == 0));
+        }
+
+        static InertialForces of(const InertialFrame &frame, float linearInertiaScale, float angularInertiaScale);
+    };
+} // namespace vox::flex
@@ -0,0 +1,36 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+
+namespace vox::flex {
+    // Explicit integration and finite difference helpers, the native counterparts of BurstIntegration.
+    inline float4 integrateLinear(const float4 &position, const float4 &velocity, float dt) {
+        return position + velocity * dt;
+    }
+
+    inline float4 differentiateLinear(const float4 &position, const float4 &prevPosition, float dt) {
+        return (position - prevPosition) / dt;
+    }
+
+    // Time derivative of `rotation` under `angularVelocity`, scaled by dt: 0.5 * (w, 0) * q * dt.
+    inline quaternion angularVelocityToSpinQuaternion(const quaternion &rotation, const float4 &angularVelocity,
+                                                      float dt) {
+        quaternion delta(angularVelocity.x, angularVelocity.y, angularVelocity.z, 0);
+        return delta * rotation * (0.5f * dt);
+    }
+
+    inline quaternion integrateAngular(const quaternion &rotation, const float4 &angularVelocity, float dt) {
+        return normalize(rotation + angularVelocityToSpinQuaternion(rotation, angularVelocity, dt));
+    }
+
+    inline float4 differentiateAngular(const quaternion &rotation, const quaternion &prevRotation, float dt) {
+        quaternion delta = rotation * inverse(prevRotation);
+        return {delta.xyz() * (2.f / dt), 0};
+    }
+} // namespace vox::flex
@@ -0,0 +1,105 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/AlignedVector.h"
+#include "../common/Math.h"
+
+namespace vox::flex {
+    // Bits of a particle phase, same values as ObiUtils.ParticleFlags.
+    enum ParticleFlags : int32_t {
+        kParticleGroupMask = 0x00ffffff,
+        kParticleSelfCollide = 1 << 24,
+        kParticleFluid = 1 << 25,
+        kParticleOneSided = 1 << 26,
+    };
+
+    // Solver particle state, one 16 byte aligned array per attribute (structure of arrays), so every
+    // job streams only the attributes it needs. Vector attributes are float4 with w unused, the same
+    // layout as the Swift / Metal side, so arrays can be copied in and out without conversion.
+    struct ParticleData {
+        // linear
+        AlignedVector<float4> positions;
+        AlignedVector<float4> prevPositions;
+        AlignedVector<float4> restPositions;
+        AlignedVector<float4> renderablePositions;
+        AlignedVector<float4> velocities;
+        AlignedVector<float4> externalForces;
+        // air velocity around every particle, for aerodynamics.
+        AlignedVector<float4> wind;
+        AlignedVector<float> invMasses;
+
+        // angular
+        AlignedVector<quaternion> orientations;
+        AlignedVector<quaternion> prevOrientations;
+        AlignedVector<quaternion> restOrientations;
+        AlignedVector<quaternion> renderableOrientations;
+        AlignedVector<float4> angularVelocities;
+        AlignedVector<float4> externalTorques;
+        AlignedVector<float> invRotationalMasses;
+
+        // constraint corrections, accumulated by constraint batches and averaged when applied.
+        AlignedVector<float4> positionDeltas;
+        AlignedVector<int32_t> positionConstraintCounts;
+        AlignedVector<quaternion> orientationDeltas;
+        AlignedVector<int32_t> orientationConstraintCounts;
+
+        // shape and material
+        AlignedVector<int32_t> phases;
+        // collision category in the low 16 bits, mask of categories collided with in the high 16 bits.
+        AlignedVector<int32_t> filters;
+        AlignedVector<float4> principalRadii;
+        // surface normal of one-sided particles, w unused.
+        AlignedVector<float4> normals;
+        AlignedVector<float> buoyancies;
+
+        // fluid
+        AlignedVector<float> smoothingRadii;
+        AlignedVector<float> restDensities;
+        AlignedVector<float> viscosities;
+        AlignedVector<float> vortConfinement;
+        AlignedVector<float> surfaceTension;
+        // air drag and pressure felt by fluid particles at the surface.
+        AlignedVector<float> atmosphericDrag;
+        AlignedVector<float> atmosphericPressure;
+        // rate user data spreads between neighboring fluid particles.
+        AlignedVector<float> diffusion;
+        // density, density constraint multiplier, w unused.
+        AlignedVector<float4> fluidData;
+        AlignedVector<float4> vorticities;
+        // arbitrary per particle values diffused across the fluid, e.g. color or temperature.
+        AlignedVector<float4> userData;
+        // three principal axes per particle for rendering: unit direction in xyz, radius along it in w.
+        AlignedVector<float4> anisotropies;
+
+        size_t size() const { return positions.size(); }
+
+        // Existing particles keep their values, new ones are static, at rest and unrotated.
+        void resize(size_t count) {
+            for (auto *array : {&positions, &prevPositions, &restPositions, &renderablePositions, &velocities,
+                                &externalForces, &wind, &angularVelocities, &externalTorques, &positionDeltas,
+                                &principalRadii, &normals, &fluidData, &vorticities, &userData}) {
+                array->resize(count);
+            }
+            anisotropies.resize(count * 3);
+            for (auto *array : {&orientations, &prevOrientations, &restOrientations, &renderableOrientations}) {
+                array->resize(count);
+            }
+            orientationDeltas.resize(count, quaternion(0, 0, 0, 0));
+            for (auto *array : {&invMasses, &invRotationalMasses, &buoyancies, &smoothingRadii, &restDensities,
+                                &viscosities, &vortConfinement, &surfaceTension, &atmosphericDrag,
+                                &atmosphericPressure, &diffusion}) {
+                array->resize(count);
+            }
+            for (auto *array : {&positionConstraintCounts, &orientationConstraintCounts, &phases}) {
+                array->resize(count);
+            }
+            // collide with every category by default.
+            filters.resize(count, int32_t(0xffff0001));
+        }
+    };
+} // namespace vox::flex
@@ -0,0 +1,41 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstdint>
+
+namespace vox::flex {
+    // Layout of the solver simplex array: every point (one particle) first, then every edge (two
+    // particles), then every triangle (three particles). Same as the Swift SimplexCounts.
+    struct SimplexCounts {
+        int32_t pointCount = 0;
+        int32_t edgeCount = 0;
+        int32_t triangleCount = 0;
+
+        int32_t simplexCount() const { return pointCount + edgeCount + triangleCount; }
+
+        // Offset of the simplex particles in the simplex array, `size` gets their count.
+        int32_t getSimplexStartAndSize(int32_t index, int32_t &size) const {
+            if (index < pointCount) {
+                size = 1;
+                return index;
+            }
+            if (index < pointCount + edgeCount) {
+                size = 2;
+                return pointCount + (index - pointCount) * 2;
+            }
+            if (index < simplexCount()) {
+                size = 3;
+                return pointCount + edgeCount * 2 + (index - pointCount - edgeCount) * 3;
+            }
+            size = 0;
+            return 0;
+        }
+
+        int32_t particleIndexCount() const { return pointCount + edgeCount * 2 + triangleCount * 3; }
+    };
+} // namespace vox::flex
@@ -0,0 +1,366 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "SolverImpl.h"
+#include "Integration.h"
+#include "../constraints/aerodynamics/AerodynamicConstraintsBatch.h"
+#include "../common/Parallel.h"
+
+#include <algorithm>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 1024;
+        constexpr size_t kQueryGrain = 256;
+        constexpr size_t kBoundsGrain = 1024;
+
+        // world space bounds of the solver space `bounds`, enclosing its eight corners.
+        Aabb boundsInWorld(const Aabb &bounds, const AffineTransform &solverToWorld) {
+            Aabb world;
+            for (int i = 0; i < 8; ++i) {
+                const float4 corner((i & 1) != 0 ? bounds.max.x : bounds.min.x,
+                                    (i & 2) != 0 ? bounds.max.y : bounds.min.y,
+                                    (i & 4) != 0 ? bounds.max.z : bounds.min.z, 0);
+                world.encapsulateParticle(solverToWorld.transformPoint(corner), 0);
+            }
+            return world;
+        }
+    } // namespace
+
+    SolverImpl::SolverImpl() {
+        _constraints.reserve(kConstraintTypeCount);
+        for (size_t i = 0; i < kConstraintTypeCount; ++i) {
+            _constraints.emplace_back(ConstraintType(i));
+        }
+        _densityConstraints = static_cast<DensityConstraintsBatch *>(
+            constraints(ConstraintType::Density).addBatch(std::make_unique<DensityConstraintsBatch>()));
+    }
+
+    void SolverImpl::setParticleCount(size_t count) {
+        _particles.resize(count);
+        _activeParticles.erase(std::remove_if(_activeParticles.begin(), _activeParticles.end(),
+                                              [&](int32_t i) { return size_t(i) >= count; }),
+                               _activeParticles.end());
+        // interactions may refer to removed particles until the next collision detection.
+        _fluidInteractions.clear();
+        _densityConstraints->setInteractions(_fluidInteractions, nullptr, 0, count);
+        _particleContacts.clear();
+        _colliderCandidates.clear();
+    }
+
+    void SolverImpl::setSimplices(const int32_t *indices, const SimplexCounts &counts) {
+        _simplices.assign(indices, indices + counts.particleIndexCount());
+        _simplexCounts = counts;
+        _particleContacts.clear();
+        _colliderCandidates.clear();
+        _simplexBounds.clear();
+        _particleGrid.invalidate();
+    }
+
+    void SolverImpl::setDeformableTriangles(const int32_t *indices, size_t count) {
+        _deformableTriangles.set(indices, count, _particles.size());
+    }
+
+    void SolverImpl::setActiveParticles(const int32_t *indices, size_t count) {
+        _activeParticles.assign(indices, indices + count);
+    }
+
+    // MARK: - Collision detection
+    void SolverImpl::collisionDetection(float stepTime) {
+        _fluidParticles.clear();
+        for (int32_t i : _activeParticles) {
+            if (_particles.phases[i] & kParticleFluid) {
+                _fluidParticles.push_back(i);
+            }
+        }
+
+        _densityConstraints->setMode2D(_parameters.mode == SolverParameters::Mode::Mode2D);
+        _particleGrid.generateFluidInteractions(_particles, _fluidParticles.data(), _fluidParticles.size(),
+                                                _parameters.collisionMargin, stepTime, _fluidInteractions);
+        _densityConstraints->setInteractions(_fluidInteractions, _fluidParticles.data(), _fluidParticles.size(),
+                                             _particles.size());
+
+        const bool is2D = _parameters.mode == SolverParameters::Mode::Mode2D;
+        calculateSimplexBounds(stepTime);
+        _particleGrid.update(_simplexBounds.data(), _simplexBounds.size(), is2D);
+
+        ParticleGrid::ContactParameters contactParameters;
+        contactParameters.stepTime = stepTime;
+        contactParameters.collisionMargin = _parameters.collisionMargin;
+        contactParameters.optimizationIterations = _parameters.surfaceCollisionIterations;
+        contactParameters.optimizationTolerance = _parameters.surfaceCollisionTolerance;
+        contactParameters.is2D = is2D;
+        _particleGrid.generateParticleParticleContacts(_particles, _simplices.data(), _simplexCounts,
+                                                       _simplexBounds.data(), contactParameters, _particleContacts);
+
+        if (_colliderWorld != nullptr) {
+            // colliders live in world space: the broadphase takes world space simplex bounds, the kernels
+            // bring the colliders to solver space.
+            const AffineTransform &frame = _inertialFrame.frame;
+            _worldSimplexBounds.resize(_simplexBounds.size());
+            parallelFor(size_t(0), _simplexBounds.size(), kBoundsGrain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    _worldSimplexBounds[i] = boundsInWorld(_simplexBounds[i], frame);
+                }
+            });
+            _colliderWorld->generateCandidates(_particles, _simplices.data(), _simplexCounts,
+                                               _worldSimplexBounds.data(), is2D, _colliderCandidates);
+
+            ColliderContactGenerator::ContactParameters colliderParameters;
+            colliderParameters.stepTime = stepTime;
+            colliderParameters.collisionMargin = _parameters.collisionMargin;
+            colliderParameters.optimizationIterations = _parameters.surfaceCollisionIterations;
+            colliderParameters.optimizationTolerance = _parameters.surfaceCollisionTolerance;
+            _colliderContactGenerator.generateContacts(*_colliderWorld, frame.inverse(), _particles,
+                                                       _simplices.data(), _simplexCounts, _simplexBounds.data(),
+                                                       _colliderCandidates.data(), _colliderCandidates.size(),
+                                                       colliderParameters, _colliderContacts);
+        } else {
+            _colliderCandidates.clear();
+            _colliderContacts.clear();
+        }
+    }
+
+    size_t SolverImpl::spatialQuery(const QueryShape *shapes, const AffineTransform *transforms, size_t count,
+                                    QueryResult *results, size_t capacity) {
+        // the grid only holds simplices once collision detection ran on them.
+        if (_simplexBounds.size() != size_t(_simplexCounts.simplexCount())) {
+            return 0;
+        }
+        const AffineTransform *shapeToSolver = nullptr;
+        if (transforms != nullptr) {
+            const AffineTransform worldToSolver = _inertialFrame.frame.inverse();
+            _queryTransforms.resize(count);
+            parallelFor(size_t(0), count, kQueryGrain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    _queryTransforms[i] = worldToSolver * transforms[i];
+                }
+            });
+            shapeToSolver = _queryTransforms.data();
+        }
+
+        ParticleGrid::QueryParameters parameters;
+        parameters.optimizationIterations = _parameters.surfaceCollisionIterations;
+        parameters.optimizationTolerance = _parameters.surfaceCollisionTolerance;
+        parameters.is2D = _parameters.mode == SolverParameters::Mode::Mode2D;
+        return _particleGrid.spatialQuery(_particles, _simplices.data(), _simplexBounds.data(), shapes, shapeToSolver,
+                                          count, parameters, results, capacity);
+    }
+
+    void SolverImpl::calculateSimplexBounds(float stepTime) {
+        _simplexBounds.resize(size_t(_simplexCounts.simplexCount()));
+        BoundsReduction::buildSimplexBounds(_particles, _simplices.data(), _simplexCounts,
+                                            _parameters.collisionMargin,
+                                            stepTime * _parameters.continuousCollisionDetection,
+                                            _simplexBounds.data());
+    }
+
+    // MARK: - Substep
+    void SolverImpl::substep(float stepTime, float substepTime, int substeps) {
+        if (constraintParameters(ConstraintType::Aerodynamics).enabled) {
+            applyAerodynamics(stepTime, substepTime, substeps);
+        }
+        predictPositions(substepTime);
+        solveConstraints(stepTime, substepTime, substeps);
+        updateVelocities(substepTime);
+        if (constraintParameters(ConstraintType::Density).enabled) {
+            _densityConstraints->applyVelocityCorrections(_particles, substepTime);
+        }
+        updatePositions(substepTime);
+        ++_substepCount;
+    }
+
+    void SolverImpl::applyAerodynamics(float stepTime, float substepTime, int substeps) {
+        Constraints &aerodynamics = constraints(ConstraintType::Aerodynamics);
+        for (size_t i = 0; i < aerodynamics.batchCount(); ++i) {
+            static_cast<AerodynamicConstraintsBatch &>(aerodynamics.batch(i)).bind(&_deformableTriangles, &_windField);
+        }
+        aerodynamics.project(_particles, constraintParameters(ConstraintType::Aerodynamics), stepTime, substepTime,
+                             substeps);
+    }
+
+    void SolverImpl::predictPositions(float substepTime) {
+        const bool is2D = _parameters.mode == SolverParameters::Mode::Mode2D;
+        const float4 gravity(_parameters.gravity, 0);
+        const InertialForces &inertia = _inertialForces;
+        const bool inertial = !inertia.empty();
+        ParticleData &p = _particles;
+        parallelFor(0, _activeParticles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t i = _activeParticles[k];
+
+                if (is2D) {
+                    p.velocities[i].z = 0;
+                    p.angularVelocities[i].x = 0;
+                    p.angularVelocities[i].y = 0;
+                }
+
+                // fluid particles scale gravity by their buoyancy.
+                if (p.invMasses[i] > 0) {
+                    float4 effectiveGravity = gravity;
+                    if (p.phases[i] & kParticleFluid) {
+                        effectiveGravity *= -p.buoyancies[i];
+                    }
+                    p.velocities[i] += (p.externalForces[i] * p.invMasses[i] + effectiveGravity) * substepTime;
+
+                    // fictitious forces of solver space's motion: linear, Euler, Coriolis and centrifugal.
+                    if (inertial) {
+                        const float3 x = p.positions[i].xyz();
+                        const float3 w = inertia.angularVelocity;
+                        const float3 angular =
+                            cross(inertia.euler, x) + cross(w, p.velocities[i].xyz()) * 2 + cross(w, cross(w, x));
+                        p.velocities[i] -= float4(inertia.linear + angular * inertia.angularScale, 0) * substepTime;
+                    }
+                }
+                if (p.invRotationalMasses[i] > 0) {
+                    p.angularVelocities[i] += p.externalTorques[i] * (p.invRotationalMasses[i] * substepTime);
+                }
+
+                p.prevPositions[i] = p.positions[i];
+                p.positions[i] = integrateLinear(p.positions[i], p.velocities[i], substepTime);
+
+                p.prevOrientations[i] = p.orientations[i];
+                p.orientations[i] = integrateAngular(p.orientations[i], p.angularVelocities[i], substepTime);
+            }
+        });
+    }
+
+    void SolverImpl::solveConstraints(float stepTime, float substepTime, int substeps) {
+        int maxIterations = 0;
+        for (size_t j = 0; j < kConstraintTypeCount; ++j) {
+            if (_constraintParameters[j].enabled && ConstraintType(j) != ConstraintType::Aerodynamics) {
+                maxIterations = std::max(maxIterations, _constraintParameters[j].iterations);
+                _constraints[j].initialize(_particles, substepTime);
+            }
+        }
+
+        // groups needing fewer iterations than the most demanding one are spread evenly among its iterations.
+        std::array<int, kConstraintTypeCount> padding{};
+        for (size_t j = 0; j < kConstraintTypeCount; ++j) {
+            const ConstraintParameters &parameters = _constraintParameters[j];
+            padding[j] = parameters.enabled && parameters.iterations > 0
+                             ? int(std::ceil(float(maxIterations) / float(parameters.iterations)))
+                             : std::max(maxIterations, 1);
+        }
+
+        for (int i = 1; i < maxIterations; ++i) {
+            for (size_t j = 0; j < kConstraintTypeCount; ++j) {
+                const ConstraintParameters &parameters = _constraintParameters[j];
+                if (ConstraintType(j) != ConstraintType::Aerodynamics && parameters.enabled && i % padding[j] == 0) {
+                    _constraints[j].project(_particles, parameters, stepTime, substepTime, substeps);
+                }
+            }
+        }
+
+        // the last iteration projects every group, so they all end the substep satisfied. Aerodynamics act on
+        // velocities before the prediction instead.
+        for (size_t j = 0; j < kConstraintTypeCount; ++j) {
+            const ConstraintParameters &parameters = _constraintParameters[j];
+            if (ConstraintType(j) != ConstraintType::Aerodynamics && parameters.enabled &&
+                parameters.iterations > 0) {
+                _constraints[j].project(_particles, parameters, stepTime, substepTime, substeps);
+            }
+        }
+    }
+
+    void SolverImpl::updateVelocities(float substepTime) {
+        const bool is2D = _parameters.mode == SolverParameters::Mode::Mode2D;
+        ParticleData &p = _particles;
+        parallelFor(0, _activeParticles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t i = _activeParticles[k];
+
+                p.velocities[i] = p.invMasses[i] > 0
+                                      ? differentiateLinear(p.positions[i], p.prevPositions[i], substepTime)
+                                      : float4();
+                p.angularVelocities[i] =
+                    p.invRotationalMasses[i] > 0
+                        ? differentiateAngular(p.orientations[i], p.prevOrientations[i], substepTime)
+                        : float4();
+
+                if (is2D) {
+                    p.velocities[i].z = 0;
+                    p.angularVelocities[i].x = 0;
+                    p.angularVelocities[i].y = 0;
+                }
+            }
+        });
+    }
+
+    void SolverImpl::updatePositions(float substepTime) {
+        const float velocityScale = std::pow(1 - std::clamp(_parameters.damping, 0.f, 1.f), substepTime);
+        const float sleepThreshold = _parameters.sleepThreshold;
+        ParticleData &p = _particles;
+        parallelFor(0, _activeParticles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t i = _activeParticles[k];
+
+                p.velocities[i] *= velocityScale;
+                p.angularVelocities[i] *= velocityScale;
+
+                // particles whose mass-normalized kinetic energy is below the threshold stay where they were.
+                float energy = 0.5f * (lengthSquared(p.velocities[i]) + lengthSquared(p.angularVelocities[i]));
+                if (energy <= sleepThreshold) {
+                    p.positions[i] = p.prevPositions[i];
+                    p.orientations[i] = p.prevOrientations[i];
+                    p.velocities[i] = float4();
+                    p.angularVelocities[i] = float4();
+                }
+            }
+        });
+    }
+
+    // MARK: - Frame
+    void SolverImpl::applyInterpolation(const float4 *startPositions, const quaternion *startOrientations,
+                                        float stepTime, float unsimulatedTime) {
+        ParticleData &p = _particles;
+        const bool interpolate = _parameters.interpolation == SolverParameters::Interpolation::Interpolate &&
+                                 startPositions != nullptr && startOrientations != nullptr;
+        const bool extrapolate = _parameters.interpolation == SolverParameters::Interpolation::Extrapolate;
+        const float alpha = stepTime > 0 ? unsimulatedTime / stepTime : 0;
+        parallelFor(0, _activeParticles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const int32_t i = _activeParticles[k];
+                if (interpolate) {
+                    p.renderablePositions[i] = lerp(startPositions[i], p.positions[i], alpha);
+                    p.renderableOrientations[i] = nlerp(startOrientations[i], p.orientations[i], alpha);
+                } else if (extrapolate) {
+                    p.renderablePositions[i] = integrateLinear(p.positions[i], p.velocities[i], unsimulatedTime);
+                    p.renderableOrientations[i] =
+                        integrateAngular(p.orientations[i], p.angularVelocities[i], unsimulatedTime);
+                } else {
+                    p.renderablePositions[i] = p.positions[i];
+                    p.renderableOrientations[i] = p.orientations[i];
+                }
+            }
+        });
+
+        if (_densityConstraints->constraintCount() > 0) {
+            _densityConstraints->calculateAnisotropyLaplacianSmoothing(_particles, _parameters.maxAnisotropy);
+        }
+    }
+
+    void SolverImpl::resetForces() {
+        std::fill(_particles.externalForces.begin(), _particles.externalForces.end(), float4());
+        std::fill(_particles.externalTorques.begin(), _particles.externalTorques.end(), float4());
+        std::fill(_particles.wind.begin(), _particles.wind.end(), float4());
+    }
+
+    SolverBounds SolverImpl::bounds() const {
+        return BoundsReduction::reduceParticles(_particles, _activeParticles.data(), _activeParticles.size());
+    }
+
+    bool SolverImpl::getBounds(float3 &lower, float3 &upper) const {
+        const SolverBounds solverBounds =
+            BoundsReduction::reduceParticles(_particles, _activeParticles.data(), _activeParticles.size(), false);
+        if (solverBounds.empty()) {
+            return false;
+        }
+        lower = solverBounds.bounds.min.xyz();
+        upper = solverBounds.bounds.max.xyz();
+        return true;
+    }
+} // namespace vox::flex
@@ -0,0 +1,188 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "BoundsReduction.h"
+#include "Constraints.h"
+#include "DeformableTriangles.h"
+#include "InertialFrame.h"
+#include "../constraints/density/DensityConstraintsBatch.h"
+#include "../collisions/ColliderContacts.h"
+#include "../data-structures/particle-grid/ParticleGrid.h"
+#include "../data-structures/wind-field/WindField.h"
+#include <array>
+
+namespace vox::flex {
+    // Native position based dynamics solver behind BurstSolverImpl. Each step starts with collision
+    // detection, which finds the fluid interactions and the contacts between simplices used by every
+    // substep of the step. Each substep runs
+    //   aero:      apply the drag and lift of aerodynamic constraints to velocities,
+    //   predict:   apply gravity, external and inertial forces, then integrate positions and orientations,
+    //   constrain: project every enabled constraint group, interleaving groups with fewer iterations,
+    //   update:    derive velocities from the corrected positions, apply fluid viscosity and vorticity,
+    //              damp velocities and put slow particles to sleep,
+    // every phase being a parallel loop over the active particles (or constraints) on the shared pool.
+    class SolverImpl {
+    public:
+        SolverImpl();
+
+        ParticleData &particles() { return _particles; }
+        const ParticleData &particles() const { return _particles; }
+
+        // Resizes every particle array, new particles are static until given an inverse mass.
+        void setParticleCount(size_t count);
+
+        // Only active particles are simulated, indices must be unique and smaller than the particle count.
+        void setActiveParticles(const int32_t *indices, size_t count);
+
+        const AlignedVector<int32_t> &activeParticles() const { return _activeParticles; }
+
+        const SolverParameters &parameters() const { return _parameters; }
+
+        void setParameters(const SolverParameters &parameters) { _parameters = parameters; }
+
+        const ConstraintParameters &constraintParameters(ConstraintType type) const {
+            return _constraintParameters[size_t(type)];
+        }
+
+        void setConstraintParameters(ConstraintType type, const ConstraintParameters &parameters) {
+            _constraintParameters[size_t(type)] = parameters;
+        }
+
+        Constraints &constraints(ConstraintType type) { return _constraints[size_t(type)]; }
+
+        size_t constraintCount(ConstraintType type) const { return _constraints[size_t(type)].constraintCount(); }
+
+        // The only density batch, owned by the density constraints group.
+        DensityConstraintsBatch &densityConstraints() { return *_densityConstraints; }
+
+        // World transform of solver space, identity by default. Resets its velocities and accelerations.
+        void setFrame(const AffineTransform &frame) { _inertialFrame = InertialFrame(frame); }
+
+        // Moves solver space to its new world transform, `dt` seconds after the last one.
+        void updateFrame(const float4 &position, const float4 &scale, const quaternion &rotation, float dt) {
+            _inertialFrame.update(position, scale, rotation, dt);
+        }
+
+        // Makes the coming substeps apply the inertial forces of solver space's motion as of the last
+        // `updateFrame`, scaled by `linearInertiaScale` and `angularInertiaScale`: 1 behaves as if simulated in
+        // world space, 0 drags the particles along with the solver. Call once per step after updating the
+        // frame, the forces stay until the next call.
+        void applyFrame(float linearInertiaScale, float angularInertiaScale) {
+            _inertialForces = InertialForces::of(_inertialFrame, linearInertiaScale, angularInertiaScale);
+        }
+
+        const InertialFrame &inertialFrame() const { return _inertialFrame; }
+
+        const InertialForces &inertialForces() const { return _inertialForces; }
+
+        // Replaces the simplices, as particle indices laid out by `counts`: points, then edges, then triangles.
+        void setSimplices(const int32_t *indices, const SimplexCounts &counts);
+
+        const std::vector<int32_t> &simplices() const { return _simplices; }
+
+        const SimplexCounts &simplexCounts() const { return _simplexCounts; }
+
+        // Bounds of every simplex as of the last collision detection, swept by its motion over the step.
+        const std::vector<Aabb> &simplexBounds() const { return _simplexBounds; }
+
+        // Recomputes the simplex bounds for a step of `stepTime` seconds, done by every collision detection.
+        void calculateSimplexBounds(float stepTime);
+
+        // Replaces the triangles of deformable surfaces, three particle indices each, which aerodynamic
+        // constraints compute their forces on.
+        void setDeformableTriangles(const int32_t *indices, size_t count);
+
+        const DeformableTriangles &deformableTriangles() const { return _deformableTriangles; }
+
+        // Wind field added to the particles' wind by aerodynamic constraints, empty by default.
+        WindField &windField() { return _windField; }
+
+        // Finds the interactions between active fluid particles, the contacts between simplices and the
+        // contacts between simplices and colliders for the coming step of `stepTime` seconds. Colliders are
+        // placed in solver space through the inertial frame.
+        void collisionDetection(float stepTime);
+
+        const std::vector<Contact> &particleContacts() const { return _particleContacts; }
+
+        // Simplices near the `count` shapes, against the grid and simplex bounds of the last collision
+        // detection. `transforms` are the world transforms of the shapes, mapped to solver space through the
+        // solver's frame, null for shapes given in solver space. Writes up to `capacity` results and returns
+        // the number found, see ParticleGrid::spatialQuery.
+        size_t spatialQuery(const QueryShape *shapes, const AffineTransform *transforms, size_t count,
+                            QueryResult *results, size_t capacity);
+
+        // Colliders the simplices collide with, none by default. The world must outlive the solver, and is
+        // updated by its owner before collision detection.
+        void setColliderWorld(ColliderWorld *world) { _colliderWorld = world; }
+
+        const std::vector<ColliderCandidate> &colliderCandidates() const { return _colliderCandidates; }
+
+        // Contacts between simplices and colliders found by the last collision detection, see
+        // ColliderContactGenerator.
+        const std::vector<Contact> &colliderContacts() const { return _colliderContacts; }
+
+        const ColliderContactGenerator &colliderContactGenerator() const { return _colliderContactGenerator; }
+
+        // Advances the simulation by one substep of `substepTime` seconds, `substeps` being the number of
+        // substeps in the current step of `stepTime` seconds.
+        void substep(float stepTime, float substepTime, int substeps);
+
+        // Writes renderable positions / orientations. Interpolation blends them from the state at the start
+        // of the last step towards the current one by unsimulatedTime / stepTime, extrapolation advances the
+        // current state by the velocities over unsimulatedTime, otherwise they are a copy of the current
+        // state. Fluid renderables are then smoothed and given anisotropic principal axes.
+        void applyInterpolation(const float4 *startPositions, const quaternion *startOrientations, float stepTime,
+                                float unsimulatedTime);
+
+        void resetForces();
+
+        // Bounds of the active particles grown by their largest principal radius, and of the awake ones.
+        SolverBounds bounds() const;
+
+        // Bounds of the active particles, false when none is active.
+        bool getBounds(float3 &lower, float3 &upper) const;
+
+        uint64_t substepCount() const { return _substepCount; }
+
+    private:
+        void applyAerodynamics(float stepTime, float substepTime, int substeps);
+
+        void predictPositions(float substepTime);
+
+        void solveConstraints(float stepTime, float substepTime, int substeps);
+
+        void updateVelocities(float substepTime);
+
+        void updatePositions(float substepTime);
+
+        ParticleData _particles;
+        AlignedVector<int32_t> _activeParticles;
+        SolverParameters _parameters;
+        std::array<ConstraintParameters, kConstraintTypeCount> _constraintParameters;
+        std::vector<Constraints> _constraints;
+        DensityConstraintsBatch *_densityConstraints = nullptr;
+        ParticleGrid _particleGrid;
+        AlignedVector<int32_t> _fluidParticles;
+        std::vector<FluidInteraction> _fluidInteractions;
+        std::vector<int32_t> _simplices;
+        SimplexCounts _simplexCounts;
+        std::vector<Aabb> _simplexBounds;
+        DeformableTriangles _deformableTriangles;
+        WindField _windField;
+        InertialFrame _inertialFrame;
+        InertialForces _inertialForces;
+        std::vector<Contact> _particleContacts;
+        ColliderWorld *_colliderWorld = nullptr;
+        std::vector<Aabb> _worldSimplexBounds;
+        std::vector<ColliderCandidate> _colliderCandidates;
+        ColliderContactGenerator _colliderContactGenerator;
+        std::vector<Contact> _colliderContacts;
+        std::vector<AffineTransform> _queryTransforms;
+        uint64_t _substepCount = 0;
+    };
+} // namespace vox::flex
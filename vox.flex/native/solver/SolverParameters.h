@@ -0,0 +1,70 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace vox::flex {
+    // Same values and order as Oni.ConstraintType, which is also the order groups are projected in.
+    enum class ConstraintType : uint32_t {
+        Tether = 0,
+        Volume,
+        Chain,
+        Bending,
+        Distance,
+        ShapeMatching,
+        BendTwist,
+        StretchShear,
+        Pin,
+        ParticleCollision,
+        Density,
+        Collision,
+        Skin,
+        Aerodynamics,
+        Stitch,
+        ParticleFriction,
+        Friction,
+    };
+
+    constexpr size_t kConstraintTypeCount = 17;
+
+    // Mirrors Oni.SolverParameters.
+    struct SolverParameters {
+        enum class Mode : uint32_t { Mode3D, Mode2D };
+
+        enum class Interpolation : uint32_t { None, Interpolate, Extrapolate };
+
+        // in 2D mode particles only move on the XY plane and only rotate around Z.
+        Mode mode = Mode::Mode3D;
+        Interpolation interpolation = Interpolation::None;
+        float3 gravity{0, -9.81f, 0};
+        // fraction of velocity lost per second, in [0, 1].
+        float damping = 0;
+        float maxAnisotropy = 3;
+        // mass-normalized kinetic energy below which particles are kept in place.
+        float sleepThreshold = 0.0005f;
+        float collisionMargin = 0.02f;
+        float maxDepenetration = 10;
+        float continuousCollisionDetection = 1;
+        float shockPropagation = 0;
+        int32_t surfaceCollisionIterations = 8;
+        float surfaceCollisionTolerance = 0.005f;
+    };
+
+    // Mirrors Oni.ConstraintParameters.
+    struct ConstraintParameters {
+        enum class EvaluationOrder : uint32_t { Sequential, Parallel };
+
+        EvaluationOrder evaluationOrder = EvaluationOrder::Sequential;
+        int32_t iterations = 1;
+        // over (> 1) or under (< 1) relaxation applied to averaged corrections.
+        float SORFactor = 1;
+        bool enabled = true;
+    };
+} // namespace vox::flex
@@ -0,0 +1,18 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+
+/// CPU radix sort of 32-bit keys with a 32-bit payload, scratch memory is kept between calls.
+@interface CRadixSort : NSObject
+
+/// Stable ascending sort of `keys`, permuting `values` alongside. Only the 8-bit digits covering the low `keyBits`
+/// bits are sorted, see RadixSort.h.
+- (void)sort:(uint32_t *_Nonnull)keys values:(uint32_t *_Nonnull)values count:(uint32_t)count keyBits:(uint32_t)keyBits;
+
+@end
@@ -0,0 +1,20 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CRadixSort.h"
+#include "RadixSort.h"
+
+using namespace vox::flex;
+
+@implementation CRadixSort {
+    RadixSort _sort;
+}
+
+- (void)sort:(uint32_t *)keys values:(uint32_t *)values count:(uint32_t)count keyBits:(uint32_t)keyBits {
+    _sort.sort(keys, values, count, keyBits);
+}
+
+@end
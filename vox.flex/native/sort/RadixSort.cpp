@@ -0,0 +1,86 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "RadixSort.h"
+#include "../common/Parallel.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kMinBlockSize = 16 * 1024;
+    } // namespace
+
+    uint32_t RadixSort::bitsForMaxKey(uint32_t maxKey) {
+        uint32_t bits = 0;
+        while (bits < 32 && (maxKey >> bits) != 0) {
+            ++bits;
+        }
+        return std::max(bits, 1u);
+    }
+
+    void RadixSort::sort(uint32_t *keys, uint32_t *values, size_t count, uint32_t keyBits) {
+        if (count < 2) {
+            return;
+        }
+        keyBits = std::clamp(keyBits, 1u, 32u);
+
+        _scratchKeys.resize(count);
+        _scratchValues.resize(count);
+        const size_t blockCount =
+            std::clamp<size_t>(count / kMinBlockSize, 1, ThreadPool::shared().concurrency() * 2);
+        const size_t blockSize = (count + blockCount - 1) / blockCount;
+        _histograms.resize(blockCount * kRadix);
+
+        uint32_t *srcKeys = keys, *srcValues = values;
+        uint32_t *dstKeys = _scratchKeys.data(), *dstValues = _scratchValues.data();
+        for (uint32_t shift = 0; shift < keyBits; shift += kRadixBits) {
+            // per-block digit histograms
+            parallelForEach(blockCount, 1, [&](size_t block) {
+                uint32_t *histogram = &_histograms[block * kRadix];
+                std::fill(histogram, histogram + kRadix, 0);
+                for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; ++i) {
+                    ++histogram[(srcKeys[i] >> shift) & (kRadix - 1)];
+                }
+            });
+
+            // digit-major exclusive scan: all blocks of digit d come before any block of digit d + 1.
+            uint32_t sum = 0;
+            bool trivialPass = false;
+            for (uint32_t digit = 0; digit < kRadix; ++digit) {
+                uint32_t digitTotal = 0;
+                for (size_t block = 0; block < blockCount; ++block) {
+                    uint32_t &slot = _histograms[block * kRadix + digit];
+                    uint32_t n = slot;
+                    slot = sum;
+                    sum += n;
+                    digitTotal += n;
+                }
+                trivialPass |= digitTotal == count;
+            }
+            if (trivialPass) {
+                continue;
+            }
+
+            parallelForEach(blockCount, 1, [&](size_t block) {
+                uint32_t *offsets = &_histograms[block * kRadix];
+                for (size_t i = block * blockSize, end = std::min(count, i + blockSize); i < end; ++i) {
+                    uint32_t slot = offsets[(srcKeys[i] >> shift) & (kRadix - 1)]++;
+                    dstKeys[slot] = srcKeys[i];
+                    dstValues[slot] = srcValues[i];
+                }
+            });
+            std::swap(srcKeys, dstKeys);
+            std::swap(srcValues, dstValues);
+        }
+
+        if (srcKeys != keys) {
+            std::memcpy(keys, srcKeys, count * sizeof(uint32_t));
+            std::memcpy(values, srcValues, count * sizeof(uint32_t));
+        }
+    }
+} // namespace vox::flex
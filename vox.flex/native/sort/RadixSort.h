@@ -0,0 +1,36 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vox::flex {
+    // Stable LSD radix sort of 32-bit unsigned keys carrying a 32-bit payload, 8 bits per pass.
+    // Each pass builds per-block digit histograms in parallel, scans them digit-major, and scatters
+    // every block in order, so equal keys keep their input order. Passes whose digit is the same for
+    // every key are skipped. Mirrors the radixSort* kernels in flex.shader/sort.
+    class RadixSort {
+    public:
+        static constexpr uint32_t kRadixBits = 8;
+        static constexpr uint32_t kRadix = 1u << kRadixBits;
+
+        // Sorts `keys` ascending and permutes `values` alongside. Only the digits covering the low `keyBits`
+        // bits are sorted, i.e. the low ceil(keyBits / 8) * 8 bits, so small key ranges (e.g. hash grid buckets)
+        // need fewer passes. Keys must not have bits set above that.
+        void sort(uint32_t *keys, uint32_t *values, size_t count, uint32_t keyBits = 32);
+
+        // Number of bits needed to represent `maxKey`.
+        static uint32_t bitsForMaxKey(uint32_t maxKey);
+
+    private:
+        std::vector<uint32_t> _scratchKeys;
+        std::vector<uint32_t> _scratchValues;
+        std::vector<uint32_t> _histograms;
+    };
+} // namespace vox::flex
@@ -0,0 +1,55 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+typedef NS_ENUM(uint32_t, CSphSolverType) {
+    CSphSolverTypeWCSPH,
+    CSphSolverTypePCISPH,
+};
+
+/// Multithreaded CPU SPH solver (WCSPH or PCISPH) with an axis aligned box domain.
+@interface CSphSolver : NSObject
+
+- (instancetype _Nonnull)initWithType:(CSphSolverType)type;
+
+@property(nonatomic) float targetDensity;
+@property(nonatomic) float targetSpacing;
+@property(nonatomic) float relativeKernelRadius;
+/// Extra neighbor search distance, relative to the kernel radius.
+@property(nonatomic) float neighborSkin;
+
+@property(nonatomic) simd_float3 gravity;
+@property(nonatomic) float viscosityCoefficient;
+@property(nonatomic) float pseudoViscosityCoefficient;
+@property(nonatomic) float speedOfSound;
+@property(nonatomic) float timeStepLimitScale;
+@property(nonatomic) float restitutionCoefficient;
+
+- (void)setDomainLower:(simd_float3)lower upper:(simd_float3)upper;
+
+/// Fills [lower, upper] with particles on a BCC lattice of the target spacing.
+- (void)addBlockLower:(simd_float3)lower upper:(simd_float3)upper;
+
+- (void)addParticles:(const simd_float3 *_Nonnull)positions count:(uint32_t)count;
+
+- (void)advance:(float)timeIntervalInSeconds;
+
+- (uint32_t)particleCount;
+
+/// Total number of sub-steps taken so far.
+- (uint64_t)stepCount;
+
+- (uint64_t)neighborListBuildCount;
+
+- (void)getPositions:(simd_float3 *_Nonnull)positions;
+
+- (void)getDensities:(float *_Nonnull)densities;
+
+@end
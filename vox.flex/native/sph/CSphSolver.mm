@@ -0,0 +1,160 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#import "CSphSolver.h"
+#include "PCISphSolver.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+using namespace vox::flex;
+
+namespace {
+    float3 toFloat3(simd_float3 v) { return {v.x, v.y, v.z}; }
+
+    simd_float3 toSimd(const float3 &v) { return simd_make_float3(v.x, v.y, v.z); }
+} // namespace
+
+@implementation CSphSolver {
+    std::unique_ptr<WCSphSolver> _solver;
+}
+
+- (instancetype)initWithType:(CSphSolverType)type {
+    self = [super init];
+    if (self) {
+        if (type == CSphSolverTypePCISPH) {
+            _solver = std::make_unique<PCISphSolver>();
+        } else {
+            _solver = std::make_unique<WCSphSolver>();
+        }
+    }
+    return self;
+}
+
+// MARK: - Parameters
+- (float)targetDensity {
+    return _solver->sphSystemData().targetDensity();
+}
+
+- (void)setTargetDensity:(float)targetDensity {
+    _solver->sphSystemData().setTargetDensity(targetDensity);
+}
+
+- (float)targetSpacing {
+    return _solver->sphSystemData().targetSpacing();
+}
+
+- (void)setTargetSpacing:(float)targetSpacing {
+    _solver->sphSystemData().setTargetSpacing(targetSpacing);
+}
+
+- (float)relativeKernelRadius {
+    return _solver->sphSystemData().relativeKernelRadius();
+}
+
+- (void)setRelativeKernelRadius:(float)relativeKernelRadius {
+    _solver->sphSystemData().setRelativeKernelRadius(relativeKernelRadius);
+}
+
+- (float)neighborSkin {
+    return _solver->sphSystemData().neighborSkin();
+}
+
+- (void)setNeighborSkin:(float)neighborSkin {
+    _solver->sphSystemData().setNeighborSkin(neighborSkin);
+}
+
+- (simd_float3)gravity {
+    return toSimd(_solver->gravity);
+}
+
+- (void)setGravity:(simd_float3)gravity {
+    _solver->gravity = toFloat3(gravity);
+}
+
+- (float)viscosityCoefficient {
+    return _solver->viscosityCoefficient;
+}
+
+- (void)setViscosityCoefficient:(float)viscosityCoefficient {
+    _solver->viscosityCoefficient = viscosityCoefficient;
+}
+
+- (float)pseudoViscosityCoefficient {
+    return _solver->pseudoViscosityCoefficient;
+}
+
+- (void)setPseudoViscosityCoefficient:(float)pseudoViscosityCoefficient {
+    _solver->pseudoViscosityCoefficient = pseudoViscosityCoefficient;
+}
+
+- (float)speedOfSound {
+    return _solver->speedOfSound;
+}
+
+- (void)setSpeedOfSound:(float)speedOfSound {
+    _solver->speedOfSound = std::max(speedOfSound, std::numeric_limits<float>::min());
+}
+
+- (float)timeStepLimitScale {
+    return _solver->timeStepLimitScale;
+}
+
+- (void)setTimeStepLimitScale:(float)timeStepLimitScale {
+    _solver->timeStepLimitScale = std::max(timeStepLimitScale, 0.f);
+}
+
+- (float)restitutionCoefficient {
+    return _solver->restitutionCoefficient;
+}
+
+- (void)setRestitutionCoefficient:(float)restitutionCoefficient {
+    _solver->restitutionCoefficient = std::clamp(restitutionCoefficient, 0.f, 1.f);
+}
+
+- (void)setDomainLower:(simd_float3)lower upper:(simd_float3)upper {
+    _solver->domainLower = toFloat3(lower);
+    _solver->domainUpper = toFloat3(upper);
+}
+
+// MARK: - Particles
+- (void)addBlockLower:(simd_float3)lower upper:(simd_float3)upper {
+    std::vector<float3> points;
+    SphSystemData::bccLattice(toFloat3(lower), toFloat3(upper), _solver->sphSystemData().targetSpacing(), points);
+    _solver->sphSystemData().addParticles(points.data(), nullptr, points.size());
+}
+
+- (void)addParticles:(const simd_float3 *)positions count:(uint32_t)count {
+    _solver->sphSystemData().addParticles(reinterpret_cast<const float3 *>(positions), nullptr, count);
+}
+
+- (void)advance:(float)timeIntervalInSeconds {
+    _solver->advance(timeIntervalInSeconds);
+}
+
+- (uint32_t)particleCount {
+    return static_cast<uint32_t>(_solver->sphSystemData().size());
+}
+
+- (uint64_t)stepCount {
+    return _solver->stepCount();
+}
+
+- (uint64_t)neighborListBuildCount {
+    return _solver->sphSystemData().neighborListBuildCount();
+}
+
+- (void)getPositions:(simd_float3 *)positions {
+    const auto &source = _solver->sphSystemData().positions();
+    std::copy(source.begin(), source.end(), reinterpret_cast<float3 *>(positions));
+}
+
+- (void)getDensities:(float *)densities {
+    const auto &source = _solver->sphSystemData().densities();
+    std::copy(source.begin(), source.end(), densities);
+}
+
+@end
@@ -0,0 +1,123 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "PCISphSolver.h"
+#include "SphKernels.h"
+#include "../common/Parallel.h"
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 256;
+    } // namespace
+
+    PCISphSolver::PCISphSolver() { timeStepLimitScale = kDefaultTimeStepLimitScale; }
+
+    float PCISphSolver::computeDelta(float timeStepInSeconds) const {
+        const float kernelRadius = _particles.kernelRadius();
+        std::vector<float3> points;
+        float3 extent(1.5f * kernelRadius);
+        SphSystemData::bccLattice(-extent, extent, _particles.targetSpacing(), points);
+
+        const SphSpikyKernel kernel(kernelRadius);
+        float3 denom1;
+        float denom2 = 0;
+        for (const float3 &point : points) {
+            float distanceSquared = lengthSquared(point);
+            if (distanceSquared < kernelRadius * kernelRadius) {
+                float distance = std::sqrt(distanceSquared);
+                float3 direction = distance > 0 ? point / distance : float3();
+                float3 gradWij = kernel.gradient(distance, direction);
+                denom1 += gradWij;
+                denom2 += lengthSquared(gradWij);
+            }
+        }
+
+        float denom = -lengthSquared(denom1) - denom2;
+        float massOverDensity = _particles.mass() * timeStepInSeconds / _particles.targetDensity();
+        float beta = 2 * massOverDensity * massOverDensity;
+        return std::fabs(denom) > 0 ? -1 / (beta * denom) : 0;
+    }
+
+    void PCISphSolver::accumulatePressureForce(float timeStepInSeconds) {
+        const size_t count = _particles.size();
+        const float mass = _particles.mass();
+        const float targetDensity = _particles.targetDensity();
+        const float delta = computeDelta(timeStepInSeconds);
+        const SphStdKernel kernel(_particles.kernelRadius());
+        const float selfWeight = kernel(0);
+
+        const auto &positions = _particles.positions();
+        const auto &velocities = _particles.velocities();
+        const auto &forces = _particles.forces();
+        const auto &densities = _particles.densities();
+        auto &pressures = _particles.pressures();
+
+        _tempPositions.resize(count);
+        _tempVelocities.resize(count);
+        _pressureForces.assign(count, float3());
+        _densityErrors.assign(count, 0);
+        std::fill(pressures.begin(), pressures.end(), 0.f);
+
+        const size_t chunkCount = (count + kParticleGrain - 1) / kParticleGrain;
+        std::vector<float> chunkErrors(chunkCount);
+        _lastNumberOfIterations = 0;
+        for (unsigned iteration = 0; iteration < maxNumberOfIterations; ++iteration) {
+            // predict velocity and position
+            parallelFor(0, count, kParticleGrain, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    _tempVelocities[i] = velocities[i] + (forces[i] + _pressureForces[i]) * (timeStepInSeconds / mass);
+                    _tempPositions[i] = positions[i] + _tempVelocities[i] * timeStepInSeconds;
+                }
+            });
+            resolveCollision(_tempPositions.data(), _tempVelocities.data());
+
+            // predicted density error drives the pressure correction. The neighbor lists were checked against
+            // the current positions only: a prediction moving a particle past half the skin may miss pairs that
+            // came within the kernel radius, so the predicted density is an approximation, exact for steps
+            // moving particles less than that.
+            parallelForEach(chunkCount, 1, [&](size_t chunk) {
+                float maxError = 0;
+                for (size_t i = chunk * kParticleGrain, end = std::min(count, i + kParticleGrain); i < end; ++i) {
+                    float weightSum = selfWeight;
+                    _particles.forEachNeighbor(i, _tempPositions.data(), [&](uint32_t, float distance, const float3 &) {
+                        weightSum += kernel(distance);
+                    });
+                    float densityError = mass * weightSum - targetDensity;
+                    float pressure = delta * densityError;
+                    if (pressure < 0) {
+                        pressure *= negativePressureScale;
+                        densityError *= negativePressureScale;
+                    }
+                    pressures[i] += pressure;
+                    _densityErrors[i] = densityError;
+                    maxError = std::max(maxError, std::fabs(densityError));
+                }
+                chunkErrors[chunk] = maxError;
+            });
+
+            std::fill(_pressureForces.begin(), _pressureForces.end(), float3());
+            WCSphSolver::accumulatePressureForce(positions.data(), densities.data(), pressures.data(),
+                                                 _pressureForces.data());
+
+            ++_lastNumberOfIterations;
+            float maxDensityError = 0;
+            for (float chunkError : chunkErrors) {
+                maxDensityError = std::max(maxDensityError, chunkError);
+            }
+            _lastMaxDensityErrorRatio = maxDensityError / targetDensity;
+            if (_lastMaxDensityErrorRatio < maxDensityErrorRatio) {
+                break;
+            }
+        }
+
+        auto &totalForces = _particles.forces();
+        parallelFor(0, count, 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                totalForces[i] += _pressureForces[i];
+            }
+        });
+    }
+} // namespace vox::flex
@@ -0,0 +1,41 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "WCSphSolver.h"
+
+namespace vox::flex {
+    // CPU PCISPH solver (Solenthaler and Pajarola, SIGGRAPH 2009): pressure is corrected iteratively
+    // from the predicted density error, which allows ~5x larger time steps than WCSPH.
+    class PCISphSolver : public WCSphSolver {
+    public:
+        static constexpr float kDefaultTimeStepLimitScale = 5;
+
+        PCISphSolver();
+
+        float maxDensityErrorRatio = 0.01f;
+        unsigned maxNumberOfIterations = 5;
+
+        // Prediction-correction iterations of the last sub-step.
+        unsigned lastNumberOfIterations() const { return _lastNumberOfIterations; }
+
+        float lastMaxDensityErrorRatio() const { return _lastMaxDensityErrorRatio; }
+
+    protected:
+        void accumulatePressureForce(float timeStepInSeconds) override;
+
+    private:
+        float computeDelta(float timeStepInSeconds) const;
+
+        std::vector<float3> _tempPositions;
+        std::vector<float3> _tempVelocities;
+        std::vector<float3> _pressureForces;
+        std::vector<float> _densityErrors;
+        unsigned _lastNumberOfIterations = 0;
+        float _lastMaxDensityErrorRatio = 0;
+    };
+} // namespace vox::flex
@@ -0,0 +1,90 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+
+namespace vox::flex {
+    constexpr float kPiF = 3.14159265358979323846f;
+
+    // Standard 3-D SPH kernel, same as SphStdKernel3 in SPHKernels.swift.
+    // Müller, Charypar and Gross, "Particle-based fluid simulation for interactive applications", SCA 2003.
+    struct SphStdKernel {
+        float h = 0, h2 = 0, h3 = 0, h5 = 0;
+
+        SphStdKernel() = default;
+
+        explicit SphStdKernel(float kernelRadius)
+            : h(kernelRadius), h2(h * h), h3(h2 * h), h5(h2 * h3) {}
+
+        float operator()(float distance) const {
+            if (distance * distance >= h2) {
+                return 0;
+            }
+            float x = 1 - distance * distance / h2;
+            return 315.f / (64.f * kPiF * h3) * x * x * x;
+        }
+
+        float firstDerivative(float distance) const {
+            if (distance >= h) {
+                return 0;
+            }
+            float x = 1 - distance * distance / h2;
+            return -945.f / (32.f * kPiF * h5) * distance * x * x;
+        }
+
+        float3 gradient(float distance, const float3 &directionToCenter) const {
+            return directionToCenter * -firstDerivative(distance);
+        }
+
+        float secondDerivative(float distance) const {
+            if (distance * distance >= h2) {
+                return 0;
+            }
+            float x = distance * distance / h2;
+            return 945.f / (32.f * kPiF * h5) * (1 - x) * (3 * x - 1);
+        }
+    };
+
+    // Spiky 3-D SPH kernel, same as SphSpikyKernel3 in SPHKernels.swift.
+    struct SphSpikyKernel {
+        float h = 0, h2 = 0, h3 = 0, h4 = 0, h5 = 0;
+
+        SphSpikyKernel() = default;
+
+        explicit SphSpikyKernel(float kernelRadius)
+            : h(kernelRadius), h2(h * h), h3(h2 * h), h4(h2 * h2), h5(h3 * h2) {}
+
+        float operator()(float distance) const {
+            if (distance >= h) {
+                return 0;
+            }
+            float x = 1 - distance / h;
+            return 15.f / (kPiF * h3) * x * x * x;
+        }
+
+        float firstDerivative(float distance) const {
+            if (distance >= h) {
+                return 0;
+            }
+            float x = 1 - distance / h;
+            return -45.f / (kPiF * h4) * x * x;
+        }
+
+        float3 gradient(float distance, const float3 &directionToCenter) const {
+            return directionToCenter * -firstDerivative(distance);
+        }
+
+        float secondDerivative(float distance) const {
+            if (distance >= h) {
+                return 0;
+            }
+            float x = 1 - distance / h;
+            return 90.f / (kPiF * h5) * x;
+        }
+    };
+} // namespace vox::flex
@@ -0,0 +1,128 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "SphSolverBase.h"
+#include "../common/Parallel.h"
+
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 512;
+    } // namespace
+
+    SphSolverBase::SphSolverBase() { _particles.setTargetDensity(1000.f); }
+
+    unsigned SphSolverBase::numberOfSubTimeSteps(float timeIntervalInSeconds) const {
+        const float kernelRadius = _particles.kernelRadius();
+        const float mass = _particles.mass();
+
+        // largest force of the last step, at least gravity.
+        const auto &forces = _particles.forces();
+        const size_t chunkCount = (forces.size() + 4095) / 4096;
+        std::vector<float> chunkMaxima(chunkCount, 0.f);
+        parallelForEach(chunkCount, 1, [&](size_t chunk) {
+            for (size_t i = chunk * 4096, end = std::min(forces.size(), i + 4096); i < end; ++i) {
+                chunkMaxima[chunk] = std::max(chunkMaxima[chunk], lengthSquared(forces[i]));
+            }
+        });
+        float maxForceSquared = 0;
+        for (float chunkMaximum : chunkMaxima) {
+            maxForceSquared = std::max(maxForceSquared, chunkMaximum);
+        }
+        float maxForceMagnitude = std::max(std::sqrt(maxForceSquared), mass * length(gravity));
+
+        float timeStepLimitBySpeed = kTimeStepLimitBySpeedFactor * kernelRadius / speedOfSound;
+        float timeStepLimitByForce = kTimeStepLimitByForceFactor * std::sqrt(kernelRadius * mass / maxForceMagnitude);
+        float desiredTimeStep = timeStepLimitScale * std::min(timeStepLimitBySpeed, timeStepLimitByForce);
+        return std::max(1u, static_cast<unsigned>(std::ceil(timeIntervalInSeconds / desiredTimeStep)));
+    }
+
+    void SphSolverBase::advance(float timeIntervalInSeconds) {
+        if (_particles.size() == 0) {
+            return;
+        }
+        unsigned subSteps = numberOfSubTimeSteps(timeIntervalInSeconds);
+        float timeStep = timeIntervalInSeconds / float(subSteps);
+        for (unsigned i = 0; i < subSteps; ++i) {
+            advanceTimeStep(timeStep);
+        }
+    }
+
+    void SphSolverBase::advanceTimeStep(float timeStepInSeconds) {
+        const size_t count = _particles.size();
+        _newPositions.resize(count);
+        _newVelocities.resize(count);
+        auto &forces = _particles.forces();
+        parallelFor(0, count, kParticleGrain, [&](size_t begin, size_t end) {
+            std::fill(forces.begin() + begin, forces.begin() + end, float3());
+        });
+
+        onBeginAdvanceTimeStep(timeStepInSeconds);
+        accumulateForces(timeStepInSeconds);
+        timeIntegration(timeStepInSeconds);
+        resolveCollision(_newPositions.data(), _newVelocities.data());
+
+        _particles.positions().swap(_newPositions);
+        _particles.velocities().swap(_newVelocities);
+        onEndAdvanceTimeStep(timeStepInSeconds);
+        ++_stepCount;
+    }
+
+    void SphSolverBase::onBeginAdvanceTimeStep(float) {
+        _particles.updateNeighborLists();
+        _particles.updateDensities();
+    }
+
+    void SphSolverBase::accumulateForces(float) { accumulateExternalForces(); }
+
+    void SphSolverBase::accumulateExternalForces() {
+        const float mass = _particles.mass();
+        const auto &velocities = _particles.velocities();
+        auto &forces = _particles.forces();
+        parallelFor(0, _particles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                forces[i] += gravity * mass - velocities[i] * dragCoefficient;
+            }
+        });
+    }
+
+    void SphSolverBase::timeIntegration(float timeStepInSeconds) {
+        const float mass = _particles.mass();
+        const auto &positions = _particles.positions();
+        const auto &velocities = _particles.velocities();
+        const auto &forces = _particles.forces();
+        parallelFor(0, _particles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                _newVelocities[i] = velocities[i] + forces[i] * (timeStepInSeconds / mass);
+                _newPositions[i] = positions[i] + _newVelocities[i] * timeStepInSeconds;
+            }
+        });
+    }
+
+    void SphSolverBase::resolveCollision(float3 *positions, float3 *velocities) const {
+        parallelFor(0, _particles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                float3 &x = positions[i];
+                float3 &v = velocities[i];
+                for (int axis = 0; axis < 3; ++axis) {
+                    float lower = domainLower[axis], upper = domainUpper[axis];
+                    float &p = x[axis];
+                    float &u = v[axis];
+                    if (p < lower || p > upper) {
+                        p = std::clamp(p, lower, upper);
+                        // reflect the normal velocity, damp the tangential ones by friction.
+                        if ((p == lower && u < 0) || (p == upper && u > 0)) {
+                            u *= -restitutionCoefficient;
+                            for (int tangent = 1; tangent < 3; ++tangent) {
+                                v[(axis + tangent) % 3] *= std::max(1 - frictionCoefficient, 0.f);
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+} // namespace vox::flex
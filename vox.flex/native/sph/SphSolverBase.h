@@ -0,0 +1,73 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "SphSystemData.h"
+
+namespace vox::flex {
+    // Multithreaded CPU counterpart of SphSolverBase/ParticleSystemSolver: adaptive sub-stepping,
+    // gravity and drag, symplectic Euler integration and an axis aligned box domain as collider.
+    class SphSolverBase {
+    public:
+        static constexpr float kTimeStepLimitBySpeedFactor = 0.4f;
+        static constexpr float kTimeStepLimitByForceFactor = 0.25f;
+
+        SphSolverBase();
+
+        virtual ~SphSolverBase() = default;
+
+        SphSystemData &sphSystemData() { return _particles; }
+        const SphSystemData &sphSystemData() const { return _particles; }
+
+        // Advances by `timeIntervalInSeconds`, split into `numberOfSubTimeSteps` sub-steps.
+        void advance(float timeIntervalInSeconds);
+
+        unsigned numberOfSubTimeSteps(float timeIntervalInSeconds) const;
+
+        // Total number of sub-steps taken so far.
+        size_t stepCount() const { return _stepCount; }
+
+        // MARK: - Parameters
+        float3 gravity = float3(0, -9.8f, 0);
+        float dragCoefficient = 1e-4f;
+        float negativePressureScale = 0;
+        float viscosityCoefficient = 0.01f;
+        float pseudoViscosityCoefficient = 10;
+        float speedOfSound = 100;
+        float timeStepLimitScale = 1;
+
+        // particles are kept inside [domainLower, domainUpper]
+        float3 domainLower = float3(-1e6f);
+        float3 domainUpper = float3(1e6f);
+        float restitutionCoefficient = 0;
+        float frictionCoefficient = 0;
+
+    protected:
+        virtual void onBeginAdvanceTimeStep(float timeStepInSeconds);
+
+        virtual void accumulateForces(float timeStepInSeconds);
+
+        virtual void onEndAdvanceTimeStep(float) {}
+
+        // gravity and drag
+        void accumulateExternalForces();
+
+        // Moves particles outside the domain back onto its boundary.
+        void resolveCollision(float3 *positions, float3 *velocities) const;
+
+        SphSystemData _particles;
+        std::vector<float3> _newPositions;
+        std::vector<float3> _newVelocities;
+
+    private:
+        void advanceTimeStep(float timeStepInSeconds);
+
+        void timeIntegration(float timeStepInSeconds);
+
+        size_t _stepCount = 0;
+    };
+} // namespace vox::flex
@@ -0,0 +1,141 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "SphSystemData.h"
+#include "SphKernels.h"
+#include "../common/Parallel.h"
+
+#include <atomic>
+
+namespace vox::flex {
+    namespace {
+        constexpr uint32_t kGridResolution = 64;
+        constexpr size_t kParticleGrain = 256;
+    } // namespace
+
+    SphSystemData::SphSystemData() { setTargetSpacing(_targetSpacing); }
+
+    void SphSystemData::resize(size_t count) {
+        _positions.resize(count);
+        _velocities.resize(count);
+        _forces.resize(count);
+        _densities.resize(count);
+        _pressures.resize(count);
+    }
+
+    void SphSystemData::addParticles(const float3 *positions, const float3 *velocities, size_t count) {
+        size_t offset = size();
+        resize(offset + count);
+        for (size_t i = 0; i < count; ++i) {
+            _positions[offset + i] = positions[i];
+            _velocities[offset + i] = velocities ? velocities[i] : float3();
+        }
+    }
+
+    void SphSystemData::setTargetDensity(float targetDensity) {
+        _targetDensity = targetDensity;
+        computeMass();
+    }
+
+    void SphSystemData::setTargetSpacing(float spacing) {
+        _targetSpacing = spacing;
+        _kernelRadius = _kernelRadiusOverTargetSpacing * _targetSpacing;
+        computeMass();
+        _searcher.reset();
+    }
+
+    void SphSystemData::setRelativeKernelRadius(float relativeRadius) {
+        _kernelRadiusOverTargetSpacing = relativeRadius;
+        setTargetSpacing(_targetSpacing);
+    }
+
+    void SphSystemData::setNeighborSkin(float relativeSkin) {
+        _skin = std::max(relativeSkin, 0.f);
+        _searcher.reset();
+    }
+
+    void SphSystemData::computeMass() {
+        std::vector<float3> points;
+        float3 extent(1.5f * _kernelRadius);
+        bccLattice(-extent, extent, _targetSpacing, points);
+
+        SphStdKernel kernel(_kernelRadius);
+        float maxNumberDensity = 0;
+        for (const float3 &point : points) {
+            float sum = 0;
+            for (const float3 &neighborPoint : points) {
+                sum += kernel(length(neighborPoint - point));
+            }
+            maxNumberDensity = std::max(maxNumberDensity, sum);
+        }
+        _mass = _targetDensity / maxNumberDensity;
+    }
+
+    bool SphSystemData::updateNeighborLists() {
+        const size_t count = size();
+        const float skinDistance = _skin * _kernelRadius;
+
+        bool rebuild = !_searcher || _cachedPositions.size() != count;
+        if (!rebuild) {
+            const float maxDisplacementSquared = 0.25f * skinDistance * skinDistance;
+            std::atomic<bool> moved{false};
+            parallelFor(0, count, 4096, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end && !moved.load(std::memory_order_relaxed); ++i) {
+                    if (lengthSquared(_positions[i] - _cachedPositions[i]) > maxDisplacementSquared) {
+                        moved.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+            rebuild = moved.load();
+        }
+        if (!rebuild) {
+            return false;
+        }
+
+        const float searchRadius = _kernelRadius + skinDistance;
+        if (!_searcher) {
+            _searcher = std::make_unique<PointHashGridSearcher>(kGridResolution, kGridResolution, kGridResolution,
+                                                                searchRadius);
+            _searcher->setNeighborhoodMode(PointHashGridSearcher::NeighborhoodMode::Cube27);
+        }
+        _searcher->update(_positions.data(), count);
+        _searcher->buildNeighborLists(searchRadius, _neighborOffsets, _neighbors);
+        _cachedPositions = _positions;
+        ++_neighborListBuildCount;
+        return true;
+    }
+
+    void SphSystemData::updateDensities() {
+        SphStdKernel kernel(_kernelRadius);
+        const float selfWeight = kernel(0);
+        parallelFor(0, size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                float sum = selfWeight;
+                forEachNeighbor(i, _positions.data(), [&](uint32_t, float distance, const float3 &) {
+                    sum += kernel(distance);
+                });
+                _densities[i] = _mass * sum;
+            }
+        });
+    }
+
+    void SphSystemData::bccLattice(const float3 &lower, const float3 &upper, float spacing,
+                                   std::vector<float3> &points) {
+        const float halfSpacing = spacing / 2;
+        const float3 size = upper - lower;
+        bool hasOffset = false;
+        for (int k = 0; float(k) * halfSpacing <= size.z; ++k) {
+            float offset = hasOffset ? halfSpacing : 0;
+            for (int j = 0; float(j) * spacing + offset <= size.y; ++j) {
+                for (int i = 0; float(i) * spacing + offset <= size.x; ++i) {
+                    points.emplace_back(float(i) * spacing + offset + lower.x, float(j) * spacing + offset + lower.y,
+                                        float(k) * halfSpacing + lower.z);
+                }
+            }
+            hasOffset = !hasOffset;
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,126 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "../common/Math.h"
+#include "../hash-grid/PointHashGridSearcher.h"
+#include <memory>
+#include <vector>
+
+namespace vox::flex {
+    // CPU SPH particle storage, one array per attribute, with cached neighbor lists.
+    //
+    // Neighbor lists are built with radius kernelRadius + skin and kept until some particle has moved
+    // more than half the skin since the last build (Verlet lists): no pair within the kernel radius can
+    // be missing before that. Users must therefore still test distance < kernelRadius in their loops,
+    // which `forEachNeighbor` does.
+    class SphSystemData {
+    public:
+        SphSystemData();
+
+        size_t size() const { return _positions.size(); }
+
+        void resize(size_t count);
+
+        // Appends particles, `velocities` may be null.
+        void addParticles(const float3 *positions, const float3 *velocities, size_t count);
+
+        std::vector<float3> &positions() { return _positions; }
+        const std::vector<float3> &positions() const { return _positions; }
+
+        std::vector<float3> &velocities() { return _velocities; }
+        const std::vector<float3> &velocities() const { return _velocities; }
+
+        std::vector<float3> &forces() { return _forces; }
+        const std::vector<float3> &forces() const { return _forces; }
+
+        std::vector<float> &densities() { return _densities; }
+        const std::vector<float> &densities() const { return _densities; }
+
+        std::vector<float> &pressures() { return _pressures; }
+        const std::vector<float> &pressures() const { return _pressures; }
+
+        // MARK: - Parameters
+        float mass() const { return _mass; }
+
+        float targetDensity() const { return _targetDensity; }
+
+        void setTargetDensity(float targetDensity);
+
+        float targetSpacing() const { return _targetSpacing; }
+
+        // Also resets the kernel radius and the particle mass.
+        void setTargetSpacing(float spacing);
+
+        float relativeKernelRadius() const { return _kernelRadiusOverTargetSpacing; }
+
+        void setRelativeKernelRadius(float relativeRadius);
+
+        float kernelRadius() const { return _kernelRadius; }
+
+        // MARK: - Neighbors
+        float neighborSkin() const { return _skin; }
+
+        // Extra search distance of the cached neighbor lists, relative to the kernel radius.
+        void setNeighborSkin(float relativeSkin);
+
+        // Rebuilds the neighbor lists when particles moved more than half the skin since the last
+        // build (or the particle count changed). Returns true when they were rebuilt.
+        bool updateNeighborLists();
+
+        size_t neighborListBuildCount() const { return _neighborListBuildCount; }
+
+        // Calls `callback(j, distance, direction)` for every neighbor j of particle i closer than the
+        // kernel radius, where direction = (positions[j] - positions[i]) / distance.
+        template <typename Callback>
+        void forEachNeighbor(size_t i, const float3 *positions, Callback &&callback) const;
+
+        // density_i = mass * sum_j W(|x_i - x_j|), self included.
+        void updateDensities();
+
+        // Generates body-centered cubic lattice points inside [lower, upper] with unit cell `spacing`,
+        // same pattern as BccLatticePointGenerator.
+        static void bccLattice(const float3 &lower, const float3 &upper, float spacing, std::vector<float3> &points);
+
+    private:
+        void computeMass();
+
+        std::vector<float3> _positions;
+        std::vector<float3> _velocities;
+        std::vector<float3> _forces;
+        std::vector<float> _densities;
+        std::vector<float> _pressures;
+
+        float _mass = 1e-3f;
+        float _targetDensity = 1000.f;
+        float _targetSpacing = 0.1f;
+        float _kernelRadiusOverTargetSpacing = 1.8f;
+        float _kernelRadius = 0.18f;
+
+        float _skin = 0.2f;
+        std::unique_ptr<PointHashGridSearcher> _searcher;
+        std::vector<float3> _cachedPositions;
+        std::vector<uint32_t> _neighborOffsets;
+        std::vector<uint32_t> _neighbors;
+        size_t _neighborListBuildCount = 0;
+    };
+
+    template <typename Callback>
+    void SphSystemData::forEachNeighbor(size_t i, const float3 *positions, Callback &&callback) const {
+        const float3 origin = positions[i];
+        const float radiusSquared = _kernelRadius * _kernelRadius;
+        for (uint32_t n = _neighborOffsets[i], end = _neighborOffsets[i + 1]; n < end; ++n) {
+            uint32_t j = _neighbors[n];
+            float3 delta = positions[j] - origin;
+            float distanceSquared = lengthSquared(delta);
+            if (distanceSquared < radiusSquared && distanceSquared > 0) {
+                float distance = std::sqrt(distanceSquared);
+                callback(j, distance, delta / distance);
+            }
+        }
+    }
+} // namespace vox::flex
@@ -0,0 +1,119 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#include "WCSphSolver.h"
+#include "SphKernels.h"
+#include "../common/Parallel.h"
+
+namespace vox::flex {
+    namespace {
+        constexpr size_t kParticleGrain = 256;
+
+        float computePressureFromEos(float density, float targetDensity, float eosScale, float eosExponent,
+                                     float negativePressureScale) {
+            // see Murnaghan-Tait equation of state from
+            // https://en.wikipedia.org/wiki/Tait_equation
+            float p = eosScale / eosExponent * (std::pow(density / targetDensity, eosExponent) - 1);
+            return p < 0 ? p * negativePressureScale : p;
+        }
+    } // namespace
+
+    WCSphSolver::WCSphSolver() {
+        _particles.setTargetSpacing(0.1f);
+        _particles.setRelativeKernelRadius(1.8f);
+    }
+
+    void WCSphSolver::accumulateForces(float timeStepInSeconds) {
+        SphSolverBase::accumulateForces(timeStepInSeconds);
+        accumulateViscosityForce();
+        accumulatePressureForce(timeStepInSeconds);
+    }
+
+    void WCSphSolver::accumulatePressureForce(float) {
+        computePressure();
+        accumulatePressureForce(_particles.positions().data(), _particles.densities().data(),
+                                _particles.pressures().data(), _particles.forces().data());
+    }
+
+    void WCSphSolver::computePressure() {
+        const float targetDensity = _particles.targetDensity();
+        const float eosScale = targetDensity * speedOfSound * speedOfSound;
+        const auto &densities = _particles.densities();
+        auto &pressures = _particles.pressures();
+        parallelFor(0, _particles.size(), 1024, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                pressures[i] = computePressureFromEos(densities[i], targetDensity, eosScale, eosExponent,
+                                                      negativePressureScale);
+            }
+        });
+    }
+
+    void WCSphSolver::accumulatePressureForce(const float3 *positions, const float *densities,
+                                              const float *pressures, float3 *pressureForces) const {
+        const float massSquared = _particles.mass() * _particles.mass();
+        const SphSpikyKernel kernel(_particles.kernelRadius());
+        parallelFor(0, _particles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const float pressureOverDensitySquared = pressures[i] / (densities[i] * densities[i]);
+                float3 force;
+                _particles.forEachNeighbor(i, positions, [&](uint32_t j, float distance, const float3 &direction) {
+                    float weight = pressureOverDensitySquared + pressures[j] / (densities[j] * densities[j]);
+                    force -= kernel.gradient(distance, direction) * (massSquared * weight);
+                });
+                pressureForces[i] += force;
+            }
+        });
+    }
+
+    void WCSphSolver::accumulateViscosityForce() {
+        const float massSquared = _particles.mass() * _particles.mass();
+        const SphSpikyKernel kernel(_particles.kernelRadius());
+        const auto &positions = _particles.positions();
+        const auto &velocities = _particles.velocities();
+        const auto &densities = _particles.densities();
+        auto &forces = _particles.forces();
+        parallelFor(0, _particles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                float3 force;
+                _particles.forEachNeighbor(i, positions.data(), [&](uint32_t j, float distance, const float3 &) {
+                    force += (velocities[j] - velocities[i]) *
+                             (viscosityCoefficient * massSquared / densities[j] * kernel.secondDerivative(distance));
+                });
+                forces[i] += force;
+            }
+        });
+    }
+
+    void WCSphSolver::onEndAdvanceTimeStep(float timeStepInSeconds) {
+        computePseudoViscosity(timeStepInSeconds);
+    }
+
+    void WCSphSolver::computePseudoViscosity(float timeStepInSeconds) {
+        const float mass = _particles.mass();
+        const SphSpikyKernel kernel(_particles.kernelRadius());
+        const float selfWeight = kernel(0);
+        const float factor = std::clamp(timeStepInSeconds * pseudoViscosityCoefficient, 0.f, 1.f);
+        const auto &positions = _particles.positions();
+        const auto &densities = _particles.densities();
+        auto &velocities = _particles.velocities();
+
+        _smoothedVelocities.resize(_particles.size());
+        parallelFor(0, _particles.size(), kParticleGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                float weightSum = mass / densities[i] * selfWeight;
+                float3 smoothedVelocity = velocities[i] * weightSum;
+                _particles.forEachNeighbor(i, positions.data(), [&](uint32_t j, float distance, const float3 &) {
+                    float weight = mass / densities[j] * kernel(distance);
+                    weightSum += weight;
+                    smoothedVelocity += velocities[j] * weight;
+                });
+                smoothedVelocity = weightSum > 0 ? smoothedVelocity / weightSum : velocities[i];
+                _smoothedVelocities[i] = velocities[i] + (smoothedVelocity - velocities[i]) * factor;
+            }
+        });
+        velocities.swap(_smoothedVelocities);
+    }
+} // namespace vox::flex
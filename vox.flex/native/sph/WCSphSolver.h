@@ -0,0 +1,40 @@
+//  Copyright (c) 2023 Feng Yang
+//
+//  I am making my contributions/submissions to this project solely in my
+//  personal capacity and am not conveying any rights to any intellectual
+//  property of any third parties.
+
+#pragma once
+
+#include "SphSolverBase.h"
+
+namespace vox::flex {
+    // CPU WCSPH solver, pressure from the equation of state (Becker and Teschner, SCA 2007).
+    // Same steps as WCSphSolver.swift: densities, EOS pressure, spiky-kernel pressure gradient,
+    // viscosity, and pseudo viscosity velocity smoothing at the end of every sub-step.
+    class WCSphSolver : public SphSolverBase {
+    public:
+        WCSphSolver();
+
+        float eosExponent = 7;
+
+    protected:
+        void accumulateForces(float timeStepInSeconds) override;
+
+        void onEndAdvanceTimeStep(float timeStepInSeconds) override;
+
+        virtual void accumulatePressureForce(float timeStepInSeconds);
+
+        void computePressure();
+
+        // pressureForces_i -= m^2 * sum_j (p_i / d_i^2 + p_j / d_j^2) * gradW(x_j - x_i)
+        void accumulatePressureForce(const float3 *positions, const float *densities, const float *pressures,
+                                     float3 *pressureForces) const;
+
+        void accumulateViscosityForce();
+
+        void computePseudoViscosity(float timeStepInSeconds);
+
+        std::vector<float3> _smoothedVelocities;
+    };
+} // namespace vox::flex
@@ -13,6 +13,50 @@ public final class ObiSolver: Script {
         case Burst
     }
 
+    /// Particle attributes mirrored by the backend. Those assigned or edited since the backend last synced
+    /// them are marked dirty, so each step only pushes what changed.
+    public struct ParticleAttributes: OptionSet {
+        public let rawValue: UInt32
+
+        public init(rawValue: UInt32) {
+            self.rawValue = rawValue
+        }
+
+        public static let positions = ParticleAttributes(rawValue: 1 << 0)
+        public static let restPositions = ParticleAttributes(rawValue: 1 << 1)
+        public static let prevPositions = ParticleAttributes(rawValue: 1 << 2)
+        public static let orientations = ParticleAttributes(rawValue: 1 << 3)
+        public static let restOrientations = ParticleAttributes(rawValue: 1 << 4)
+        public static let prevOrientations = ParticleAttributes(rawValue: 1 << 5)
+        public static let velocities = ParticleAttributes(rawValue: 1 << 6)
+        public static let angularVelocities = ParticleAttributes(rawValue: 1 << 7)
+        public static let invMasses = ParticleAttributes(rawValue: 1 << 8)
+        public static let invRotationalMasses = ParticleAttributes(rawValue: 1 << 9)
+        public static let externalForces = ParticleAttributes(rawValue: 1 << 10)
+        public static let externalTorques = ParticleAttributes(rawValue: 1 << 11)
+        public static let wind = ParticleAttributes(rawValue: 1 << 12)
+        public static let phases = ParticleAttributes(rawValue: 1 << 13)
+        public static let filters = ParticleAttributes(rawValue: 1 << 14)
+        public static let principalRadii = ParticleAttributes(rawValue: 1 << 15)
+        public static let normals = ParticleAttributes(rawValue: 1 << 16)
+        public static let vorticities = ParticleAttributes(rawValue: 1 << 17)
+        public static let fluidData = ParticleAttributes(rawValue: 1 << 18)
+        public static let userData = ParticleAttributes(rawValue: 1 << 19)
+        public static let smoothingRadii = ParticleAttributes(rawValue: 1 << 20)
+        public static let buoyancies = ParticleAttributes(rawValue: 1 << 21)
+        public static let restDensities = ParticleAttributes(rawValue: 1 << 22)
+        public static let viscosities = ParticleAttributes(rawValue: 1 << 23)
+        public static let surfaceTension = ParticleAttributes(rawValue: 1 << 24)
+        public static let vortConfinement = ParticleAttributes(rawValue: 1 << 25)
+        public static let atmosphericDrag = ParticleAttributes(rawValue: 1 << 26)
+        public static let atmosphericPressure = ParticleAttributes(rawValue: 1 << 27)
+        public static let diffusion = ParticleAttributes(rawValue: 1 << 28)
+
+        public static let all = ParticleAttributes(rawValue: (1 << 29) - 1)
+    }
+
+    var m_DirtyAttributes: ParticleAttributes = .all
+
     var m_RigidbodyLinearVelocities: [Vector4] = []
     var m_RigidbodyAngularVelocities: [Vector4] = []
 
@@ -27,32 +71,32 @@ public final class ObiSolver: Script {
     private lazy var m_Simplices: [Int] = []
 
     // positions
-    public private(set) lazy var positions: [Vector4] = []
-    private lazy var m_RestPositions: [Vector4] = []
-    private lazy var m_PrevPositions: [Vector4] = []
+    public internal(set) var positions: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.positions) } }
+    var m_RestPositions: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.restPositions) } }
+    var m_PrevPositions: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.prevPositions) } }
     private lazy var m_StartPositions: [Vector4] = []
-    private lazy var m_RenderablePositions: [Vector4] = []
+    lazy var m_RenderablePositions: [Vector4] = []
 
     // orientations
-    private lazy var m_Orientations: [Quaternion] = []
-    private lazy var m_RestOrientations: [Quaternion] = []
-    private lazy var m_PrevOrientations: [Quaternion] = []
+    var m_Orientations: [Quaternion] = [] { didSet { m_DirtyAttributes.insert(.orientations) } }
+    var m_RestOrientations: [Quaternion] = [] { didSet { m_DirtyAttributes.insert(.restOrientations) } }
+    var m_PrevOrientations: [Quaternion] = [] { didSet { m_DirtyAttributes.insert(.prevOrientations) } }
     private lazy var m_StartOrientations: [Quaternion] = []
-    private lazy var m_RenderableOrientations: [Quaternion] = [] /** < renderable particle orientations. */
+    lazy var m_RenderableOrientations: [Quaternion] = [] /** < renderable particle orientations. */
 
     // velocities
-    private lazy var m_Velocities: [Vector4] = []
-    private lazy var m_AngularVelocities: [Vector4] = []
+    var m_Velocities: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.velocities) } }
+    var m_AngularVelocities: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.angularVelocities) } }
 
     // masses/inertia tensors
-    private lazy var m_InvMasses: [Float] = []
-    private lazy var m_InvRotationalMasses: [Float] = []
+    var m_InvMasses: [Float] = [] { didSet { m_DirtyAttributes.insert(.invMasses) } }
+    var m_InvRotationalMasses: [Float] = [] { didSet { m_DirtyAttributes.insert(.invRotationalMasses) } }
     private lazy var m_InvInertiaTensors: [Vector4] = []
 
     // external forces
-    private lazy var m_ExternalForces: [Vector4] = []
-    private lazy var m_ExternalTorques: [Vector4] = []
-    private lazy var m_Wind: [Vector4] = []
+    var m_ExternalForces: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.externalForces) } }
+    var m_ExternalTorques: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.externalTorques) } }
+    var m_Wind: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.wind) } }
 
     // deltas
     private lazy var m_PositionDeltas: [Vector4] = []
@@ -62,25 +106,25 @@ public final class ObiSolver: Script {
 
     // particle collisions:
     private lazy var m_CollisionMaterials: [Int] = []
-    private lazy var m_Phases: [Int] = []
-    private lazy var m_Filters: [Int] = []
+    var m_Phases: [Int] = [] { didSet { m_DirtyAttributes.insert(.phases) } }
+    var m_Filters: [Int] = [] { didSet { m_DirtyAttributes.insert(.filters) } }
 
     // particle shape:
     private lazy var m_Anisotropies: [Vector4] = []
-    private lazy var m_PrincipalRadii: [Vector4] = []
-    private lazy var m_Normals: [Vector4] = []
+    var m_PrincipalRadii: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.principalRadii) } }
+    var m_Normals: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.normals) } }
 
     // fluids
-    private lazy var m_Vorticities: [Vector4] = []
-    private lazy var m_FluidData: [Vector4] = []
-    private lazy var m_UserData: [Vector4] = []
-    private lazy var m_SmoothingRadii: [Float] = []
-    private lazy var m_Buoyancies: [Float] = []
-    private lazy var m_RestDensities: [Float] = []
-    private lazy var m_Viscosities: [Float] = []
-    private lazy var m_SurfaceTension: [Float] = []
-    private lazy var m_VortConfinement: [Float] = []
-    private lazy var m_AtmosphericDrag: [Float] = []
-    private lazy var m_AtmosphericPressure: [Float] = []
-    private lazy var m_Diffusion: [Float] = []
+    var m_Vorticities: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.vorticities) } }
+    var m_FluidData: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.fluidData) } }
+    var m_UserData: [Vector4] = [] { didSet { m_DirtyAttributes.insert(.userData) } }
+    var m_SmoothingRadii: [Float] = [] { didSet { m_DirtyAttributes.insert(.smoothingRadii) } }
+    var m_Buoyancies: [Float] = [] { didSet { m_DirtyAttributes.insert(.buoyancies) } }
+    var m_RestDensities: [Float] = [] { didSet { m_DirtyAttributes.insert(.restDensities) } }
+    var m_Viscosities: [Float] = [] { didSet { m_DirtyAttributes.insert(.viscosities) } }
+    var m_SurfaceTension: [Float] = [] { didSet { m_DirtyAttributes.insert(.surfaceTension) } }
+    var m_VortConfinement: [Float] = [] { didSet { m_DirtyAttributes.insert(.vortConfinement) } }
+    var m_AtmosphericDrag: [Float] = [] { didSet { m_DirtyAttributes.insert(.atmosphericDrag) } }
+    var m_AtmosphericPressure: [Float] = [] { didSet { m_DirtyAttributes.insert(.atmosphericPressure) } }
+    var m_Diffusion: [Float] = [] { didSet { m_DirtyAttributes.insert(.diffusion) } }
 }
@@ -165,28 +165,29 @@ public enum ObiUtils {
         []
     }
 
-    public static func MakePhase(group _: Int, flags _: ParticleFlags) -> Int {
-        0
+    public static func MakePhase(group: Int, flags: ParticleFlags) -> Int {
+        (group & ParticleGroupBitmask) | Int(flags.rawValue)
     }
 
-    public static func GetGroupFromPhase(phase _: Int) -> Int {
-        0
+    public static func GetGroupFromPhase(phase: Int) -> Int {
+        phase & ParticleGroupBitmask
     }
 
-    public static func GetFlagsFromPhase(phase _: Int) -> ParticleFlags {
-        []
+    public static func GetFlagsFromPhase(phase: Int) -> ParticleFlags {
+        ParticleFlags(rawValue: UInt32(truncatingIfNeeded: phase & ~ParticleGroupBitmask))
     }
 
-    public static func MakeFilter(mask _: Int, category _: Int) -> Int {
-        0
+    /// `mask` holds one bit per category collided with, `category` is a bit index in [0, 16).
+    public static func MakeFilter(mask: Int, category: Int) -> Int {
+        (mask << 16) | (1 << category)
     }
 
-    public static func GetCategoryFromFilter(filter _: Int) -> Int {
-        0
+    public static func GetCategoryFromFilter(filter: Int) -> Int {
+        (filter & FilterCategoryBitmask).trailingZeroBitCount
     }
 
-    public static func GetMaskFromFilter(filter _: Int) -> Int {
-        0
+    public static func GetMaskFromFilter(filter: Int) -> Int {
+        (filter & FilterMaskBitmask) >> 16
     }
 
     public static func EigenSolve(D _: Matrix, S _: inout Vector3, V _: inout Matrix) {}